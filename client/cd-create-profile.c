@@ -21,6 +21,7 @@
 
 #include "config.h"
 
+#include <errno.h>
 #include <glib/gi18n.h>
 #include <gio/gio.h>
 #include <locale.h>
@@ -35,6 +36,7 @@ typedef struct {
 	GOptionContext		*context;
 	cmsHPROFILE		 lcms_profile;
 	CdIcc			*icc;
+	GThread			*icc_srgb_thread;
 } CdUtilPrivate;
 
 static gboolean
@@ -653,9 +655,33 @@ cd_util_create_temperature (CdUtilPrivate *priv,
 	return TRUE;
 }
 
+static gpointer
+cd_util_icc_srgb_thread_cb (gpointer user_data)
+{
+	/* warms the process-wide shared instance */
+	return cd_icc_get_standard_space (CD_STANDARD_SPACE_SRGB, NULL);
+}
+
+static CdIcc *
+cd_util_get_srgb_icc (CdUtilPrivate *priv, GError **error)
+{
+	CdIcc *icc_srgb;
+
+	/* built in the background while the profile itself was being
+	 * generated */
+	if (priv->icc_srgb_thread != NULL) {
+		icc_srgb = g_thread_join (priv->icc_srgb_thread);
+		priv->icc_srgb_thread = NULL;
+		if (icc_srgb != NULL)
+			return icc_srgb;
+	}
+	return cd_icc_get_standard_space (CD_STANDARD_SPACE_SRGB, error);
+}
+
 static gboolean
-cd_util_icc_set_metadata_coverage (CdIcc *icc, GError **error)
+cd_util_icc_set_metadata_coverage (CdUtilPrivate *priv, GError **error)
 {
+	CdIcc *icc = priv->icc;
 	const gchar *tmp;
 	gdouble coverage = 0.0f;
 	g_autofree gchar *coverage_tmp = NULL;
@@ -667,8 +693,8 @@ cd_util_icc_set_metadata_coverage (CdIcc *icc, GError **error)
 		return TRUE;
 
 	/* calculate coverage (quite expensive to calculate, hence metadata) */
-	icc_srgb = cd_icc_new ();
-	if (!cd_icc_create_default (icc_srgb, error))
+	icc_srgb = cd_util_get_srgb_icc (priv, error);
+	if (icc_srgb == NULL)
 		return FALSE;
 	if (!cd_icc_utils_get_coverage (icc_srgb, icc, &coverage, error))
 		return FALSE;
@@ -754,6 +780,16 @@ cd_util_create_from_xml (CdUtilPrivate *priv,
 		return FALSE;
 	}
 
+	/* the gamut coverage metadata needs a reference sRGB profile, so
+	 * build it in a worker thread while the profile is generated */
+	tmp = cd_dom_get_node (dom, profile, "standard_space");
+	if (tmp != NULL &&
+	    g_strcmp0 (cd_dom_get_node_data (tmp), "srgb") != 0) {
+		priv->icc_srgb_thread = g_thread_new ("srgb-ref",
+						      cd_util_icc_srgb_thread_cb,
+						      NULL);
+	}
+
 	/* get type */
 	if (cd_dom_get_node (dom, profile, "primaries") != NULL) {
 		if (!cd_util_create_standard_space (priv, dom, profile, error))
@@ -793,7 +829,7 @@ cd_util_create_from_xml (CdUtilPrivate *priv,
 		cd_icc_add_metadata (priv->icc,
 				     CD_PROFILE_METADATA_STANDARD_SPACE,
 				     cd_dom_get_node_data (tmp));
-		if (!cd_util_icc_set_metadata_coverage (priv->icc, error))
+		if (!cd_util_icc_set_metadata_coverage (priv, error))
 			return FALSE;
 	}
 	tmp = cd_dom_get_node (dom, profile, "data_source");
@@ -836,20 +872,87 @@ cd_util_create_from_xml (CdUtilPrivate *priv,
 	return TRUE;
 }
 
+static gboolean
+cd_util_create_file (const gchar *xml_fn,
+		     const gchar *icc_fn,
+		     GError **error)
+{
+	CdUtilPrivate priv;
+	gboolean ret;
+	g_autoptr(GFile) file = NULL;
+
+	/* each build gets its own CdIcc and so its own lcms context,
+	 * which keeps concurrent builds independent */
+	memset (&priv, 0, sizeof (priv));
+	priv.icc = cd_icc_new ();
+	ret = cd_util_create_from_xml (&priv, xml_fn, error);
+	if (ret) {
+		file = g_file_new_for_path (icc_fn);
+		ret = cd_icc_save_file (priv.icc,
+					file,
+					CD_ICC_SAVE_FLAGS_NONE,
+					NULL,
+					error);
+	}
+
+	/* the reference profile is unused if the build failed early */
+	if (priv.icc_srgb_thread != NULL) {
+		CdIcc *icc_srgb = g_thread_join (priv.icc_srgb_thread);
+		if (icc_srgb != NULL)
+			g_object_unref (icc_srgb);
+	}
+	g_object_unref (priv.icc);
+	return ret;
+}
+
+typedef struct {
+	const gchar		*xml_fn;
+	gchar			*icc_fn;
+	gdouble			 elapsed_ms;
+	GError			*error;
+} CdUtilBatchItem;
+
+static void
+cd_util_batch_thread_cb (gpointer data, gpointer user_data)
+{
+	CdUtilBatchItem *item = (CdUtilBatchItem *) data;
+	g_autoptr(GTimer) timer = g_timer_new ();
+	cd_util_create_file (item->xml_fn, item->icc_fn, &item->error);
+	item->elapsed_ms = g_timer_elapsed (timer, NULL) * 1000.f;
+}
+
+static gchar *
+cd_util_batch_get_output_fn (const gchar *output_dir, const gchar *xml_fn)
+{
+	g_autofree gchar *basename = g_path_get_basename (xml_fn);
+	gchar *tmp;
+
+	/* AdobeRGB1998.iccprofile.xml -> AdobeRGB1998.icc */
+	tmp = g_strstr_len (basename, -1, ".iccprofile.xml");
+	if (tmp == NULL)
+		tmp = g_strrstr (basename, ".xml");
+	if (tmp != NULL)
+		*tmp = '\0';
+	return g_strdup_printf ("%s/%s.icc", output_dir, basename);
+}
+
 int
 main (int argc, char **argv)
 {
 	CdUtilPrivate *priv;
+	gboolean batch = FALSE;
 	gboolean ret;
 	guint retval = EXIT_FAILURE;
 	g_autoptr(GError) error = NULL;
 	g_autofree gchar *cmd_descriptions = NULL;
 	g_autofree gchar *filename = NULL;
-	g_autoptr(GFile) file = NULL;
 	const GOptionEntry options[] = {
 		{ "output", 'o', 0, G_OPTION_ARG_STRING, &filename,
 		/* TRANSLATORS: command line option */
 		  _("Profile to create"), NULL },
+		{ "batch", 'b', 0, G_OPTION_ARG_NONE, &batch,
+		/* TRANSLATORS: command line option */
+		  _("Build all specified files in one process"), NULL },
 		{ NULL}
 	};
 
@@ -860,7 +963,6 @@ main (int argc, char **argv)
 	textdomain (GETTEXT_PACKAGE);
 
 	priv = g_new0 (CdUtilPrivate, 1);
-	priv->icc = cd_icc_new ();
 	priv->context = g_option_context_new (NULL);
 
 	/* TRANSLATORS: program name */
@@ -881,20 +983,84 @@ main (int argc, char **argv)
 		goto out;
 	}
 
-	/* run the specified command */
-	ret = cd_util_create_from_xml (priv, argv[1], &error);
-	if (!ret) {
-		g_print ("%s\n", error->message);
+	/* build many profiles in one process, -o names a directory */
+	if (batch) {
+		GThreadPool *pool;
+		gboolean failed = FALSE;
+		gint j;
+		guint i;
+		g_autofree CdUtilBatchItem *items = NULL;
+		g_autoptr(GPtrArray) xml_fns = NULL;
+
+		/* each argument is either an XML file or a directory of them */
+		xml_fns = g_ptr_array_new_with_free_func (g_free);
+		for (j = 1; j < argc; j++) {
+			if (g_file_test (argv[j], G_FILE_TEST_IS_DIR)) {
+				const gchar *fn_tmp;
+				g_autoptr(GDir) dir = g_dir_open (argv[j], 0, &error);
+				if (dir == NULL) {
+					g_print ("%s\n", error->message);
+					goto out;
+				}
+				while ((fn_tmp = g_dir_read_name (dir)) != NULL) {
+					if (!g_str_has_suffix (fn_tmp, ".xml"))
+						continue;
+					g_ptr_array_add (xml_fns,
+							 g_build_filename (argv[j],
+									   fn_tmp,
+									   NULL));
+				}
+			} else {
+				g_ptr_array_add (xml_fns, g_strdup (argv[j]));
+			}
+		}
+		if (xml_fns->len == 0) {
+			/* TRANSLATORS: no XML files were found in batch mode */
+			g_print ("%s\n", _("No input files specified"));
+			goto out;
+		}
+		if (g_mkdir_with_parents (filename, 0755) != 0) {
+			g_print ("%s: %s\n", filename, g_strerror (errno));
+			goto out;
+		}
+
+		/* schedule one build per processor at a time */
+		items = g_new0 (CdUtilBatchItem, xml_fns->len);
+		pool = g_thread_pool_new (cd_util_batch_thread_cb,
+					  NULL,
+					  (gint) g_get_num_processors (),
+					  FALSE,
+					  NULL);
+		for (i = 0; i < xml_fns->len; i++) {
+			items[i].xml_fn = g_ptr_array_index (xml_fns, i);
+			items[i].icc_fn = cd_util_batch_get_output_fn (filename,
+								       items[i].xml_fn);
+			g_thread_pool_push (pool, &items[i], NULL);
+		}
+		g_thread_pool_free (pool, FALSE, TRUE);
+
+		/* report per-profile timing and any failures */
+		for (i = 0; i < xml_fns->len; i++) {
+			if (items[i].error != NULL) {
+				g_print ("%s: %s\n",
+					 items[i].xml_fn,
+					 items[i].error->message);
+				g_error_free (items[i].error);
+				failed = TRUE;
+			} else {
+				g_print ("%s: %.1fms\n",
+					 items[i].icc_fn,
+					 items[i].elapsed_ms);
+			}
+			g_free (items[i].icc_fn);
+		}
+		if (!failed)
+			retval = EXIT_SUCCESS;
 		goto out;
 	}
 
-	/* write file */
-	file = g_file_new_for_path (filename);
-	ret = cd_icc_save_file (priv->icc,
-				file,
-				CD_ICC_SAVE_FLAGS_NONE,
-				NULL,
-				&error);
+	/* run the specified command */
+	ret = cd_util_create_file (argv[1], filename, &error);
 	if (!ret) {
 		g_print ("%s\n", error->message);
 		goto out;
@@ -905,7 +1071,6 @@ main (int argc, char **argv)
 out:
 	if (priv != NULL) {
 		g_option_context_free (priv->context);
-		g_object_unref (priv->icc);
 		g_free (priv);
 	}
 	return retval;
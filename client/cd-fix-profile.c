@@ -551,6 +551,103 @@ cd_util_extract_vcgt (CdUtilPrivate *priv, gchar **values, GError **error)
 	return TRUE;
 }
 
+typedef struct {
+	CdUtilPrivate	*priv;
+	const gchar	*command;
+	gchar		**values;
+	gint		 failures;
+} CdUtilBulkHelper;
+
+static void
+cd_util_bulk_process_cb (gpointer data, gpointer user_data)
+{
+	CdUtilBulkHelper *helper = (CdUtilBulkHelper *) user_data;
+	CdUtilPrivate priv_local;
+	g_autofree gchar *filename = data;
+	g_autoptr(CdIcc) icc = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GFile) file = NULL;
+
+	/* each worker gets its own CdIcc, and with it its own lcms
+	 * context, so no locking is required; the pool size bounds how
+	 * many profiles are held in memory at any one time */
+	priv_local = *helper->priv;
+	icc = cd_icc_new ();
+	priv_local.icc = icc;
+	priv_local.rewrite_file = TRUE;
+
+	/* load, fix, save */
+	file = g_file_new_for_path (filename);
+	if (!cd_icc_load_file (icc, file, CD_ICC_LOAD_FLAGS_ALL,
+			       NULL, &error)) {
+		g_print ("%s: %s\n", filename, error->message);
+		g_atomic_int_inc (&helper->failures);
+		return;
+	}
+	if (!cd_util_run (&priv_local, helper->command,
+			  helper->values, &error)) {
+		g_print ("%s: %s\n", filename, error->message);
+		g_atomic_int_inc (&helper->failures);
+		return;
+	}
+	if (priv_local.rewrite_file) {
+		if (!cd_icc_save_file (icc, file, CD_ICC_SAVE_FLAGS_NONE,
+				       NULL, &error)) {
+			g_print ("%s: %s\n", filename, error->message);
+			g_atomic_int_inc (&helper->failures);
+		}
+	}
+}
+
+static gboolean
+cd_util_bulk_run (CdUtilPrivate *priv,
+		  const gchar *path,
+		  const gchar *command,
+		  gchar **values,
+		  GError **error)
+{
+	CdUtilBulkHelper helper;
+	GThreadPool *pool;
+	const gchar *tmp;
+	guint cnt = 0;
+	g_autoptr(GDir) dir = NULL;
+
+	/* run the same command over every profile in the directory,
+	 * spread over one worker per CPU */
+	dir = g_dir_open (path, 0, error);
+	if (dir == NULL)
+		return FALSE;
+	helper.priv = priv;
+	helper.command = command;
+	helper.values = values;
+	helper.failures = 0;
+	pool = g_thread_pool_new (cd_util_bulk_process_cb, &helper,
+				  (gint) g_get_num_processors (),
+				  FALSE, error);
+	if (pool == NULL)
+		return FALSE;
+	while ((tmp = g_dir_read_name (dir)) != NULL) {
+		if (!g_str_has_suffix (tmp, ".icc") &&
+		    !g_str_has_suffix (tmp, ".icm"))
+			continue;
+		g_thread_pool_push (pool,
+				    g_build_filename (path, tmp, NULL),
+				    NULL);
+		cnt++;
+	}
+	g_thread_pool_free (pool, FALSE, TRUE);
+
+	/* TRANSLATORS: %u is the number of profiles processed */
+	g_print (_("Processed %u profiles\n"), cnt);
+	if (helper.failures > 0) {
+		g_set_error (error, 1, 0,
+			     "failed to process %i profiles",
+			     helper.failures);
+		return FALSE;
+	}
+	return TRUE;
+}
+
 static void
 cd_util_ignore_cb (const gchar *log_domain, GLogLevelFlags log_level,
 		   const gchar *message, gpointer user_data)
@@ -698,6 +795,18 @@ main (int argc, char *argv[])
 		goto out;
 	}
 
+	/* a directory means every profile inside it */
+	if (g_file_test (argv[1], G_FILE_TEST_IS_DIR)) {
+		ret = cd_util_bulk_run (priv, argv[1], argv[2],
+					(gchar **) &argv[2], &error);
+		if (!ret) {
+			g_print ("%s\n", error->message);
+			goto out;
+		}
+		retval = 0;
+		goto out;
+	}
+
 	/* open file */
 	file = g_file_new_for_path (argv[1]);
 	priv->icc = cd_icc_new ();
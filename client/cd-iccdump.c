@@ -42,33 +42,159 @@ cd_fix_profile_error_cb (cmsContext ContextID,
 	lcms_error_code = errorcode;
 }
 
-static gboolean
-cd_iccdump_print_file (const gchar *filename, GError **error)
+static gboolean ndjson = FALSE;
+
+typedef struct {
+	gchar		*filename;
+	gchar		*output;
+	gchar		*failure;
+} CdIccDumpItem;
+
+static void
+cd_iccdump_item_free (CdIccDumpItem *item)
+{
+	g_free (item->filename);
+	g_free (item->output);
+	g_free (item->failure);
+	g_free (item);
+}
+
+static void
+cd_iccdump_append_json_string (GString *str,
+			       const gchar *key,
+			       const gchar *value)
+{
+	guint i;
+
+	if (str->str[str->len - 1] != '{')
+		g_string_append_c (str, ',');
+	g_string_append_printf (str, "\"%s\":", key);
+	if (value == NULL) {
+		g_string_append (str, "null");
+		return;
+	}
+	g_string_append_c (str, '"');
+	for (i = 0; value[i] != '\0'; i++) {
+		if (value[i] == '"' || value[i] == '\\')
+			g_string_append_c (str, '\\');
+		if ((guchar) value[i] < 0x20) {
+			g_string_append_printf (str, "\\u%04x", value[i]);
+			continue;
+		}
+		g_string_append_c (str, value[i]);
+	}
+	g_string_append_c (str, '"');
+}
+
+static gchar *
+cd_iccdump_icc_to_ndjson (const gchar *filename, CdIcc *icc)
+{
+	GHashTableIter iter;
+	gpointer key, value;
+	g_autofree gchar *version = NULL;
+	g_autoptr(GHashTable) metadata = NULL;
+	g_autoptr(GString) str = NULL;
+
+	/* one self-contained object per line */
+	str = g_string_new ("{");
+	cd_iccdump_append_json_string (str, "filename", filename);
+	cd_iccdump_append_json_string (str, "checksum",
+				       cd_icc_get_checksum (icc));
+	cd_iccdump_append_json_string (str, "kind",
+				       cd_profile_kind_to_string (cd_icc_get_kind (icc)));
+	cd_iccdump_append_json_string (str, "colorspace",
+				       cd_colorspace_to_string (cd_icc_get_colorspace (icc)));
+	version = g_strdup_printf ("%.1f", cd_icc_get_version (icc));
+	cd_iccdump_append_json_string (str, "version", version);
+	cd_iccdump_append_json_string (str, "description",
+				       cd_icc_get_description (icc, NULL, NULL));
+	cd_iccdump_append_json_string (str, "copyright",
+				       cd_icc_get_copyright (icc, NULL, NULL));
+	cd_iccdump_append_json_string (str, "manufacturer",
+				       cd_icc_get_manufacturer (icc, NULL, NULL));
+	cd_iccdump_append_json_string (str, "model",
+				       cd_icc_get_model (icc, NULL, NULL));
+	g_string_append (str, ",\"metadata\":{");
+	metadata = cd_icc_get_metadata (icc);
+	g_hash_table_iter_init (&iter, metadata);
+	while (g_hash_table_iter_next (&iter, &key, &value))
+		cd_iccdump_append_json_string (str, key, value);
+	g_string_append (str, "}}");
+	return g_string_free (g_steal_pointer (&str), FALSE);
+}
+
+static void
+cd_iccdump_process_cb (gpointer data, gpointer user_data)
 {
-	g_autofree gchar *str = NULL;
+	CdIccDumpItem *item = (CdIccDumpItem *) data;
+	CdIccLoadFlags flags = CD_ICC_LOAD_FLAGS_NONE;
 	g_autoptr(CdIcc) icc = NULL;
+	g_autoptr(GError) error = NULL;
 	g_autoptr(GFile) file = NULL;
 
-	/* load the profile */
+	/* load the profile; each worker writes only to its own item so
+	 * no locking is needed */
+	if (ndjson) {
+		flags = CD_ICC_LOAD_FLAGS_METADATA |
+			CD_ICC_LOAD_FLAGS_FALLBACK_MD5;
+	}
 	icc = cd_icc_new ();
-	file = g_file_new_for_path (filename);
-	if (!cd_icc_load_file (icc, file, CD_ICC_LOAD_FLAGS_NONE, NULL, error))
-		return FALSE;
-
-	/* dump it to text on the console */
-	str = cd_icc_to_string (icc);
-	g_print ("%s\n", str);
-	return TRUE;
+	file = g_file_new_for_path (item->filename);
+	if (!cd_icc_load_file (icc, file, flags, NULL, &error)) {
+		item->failure = g_strdup (error->message);
+		return;
+	}
+	if (ndjson) {
+		item->output = cd_iccdump_icc_to_ndjson (item->filename, icc);
+	} else {
+		item->output = cd_icc_to_string (icc);
+	}
+}
+
+static void
+cd_iccdump_add_path (GPtrArray *items, const gchar *path)
+{
+	CdIccDumpItem *item;
+	const gchar *tmp;
+	g_autoptr(GDir) dir = NULL;
+
+	/* recurse into directories, picking up anything that looks like
+	 * a profile */
+	if (g_file_test (path, G_FILE_TEST_IS_DIR)) {
+		dir = g_dir_open (path, 0, NULL);
+		if (dir == NULL)
+			return;
+		while ((tmp = g_dir_read_name (dir)) != NULL) {
+			g_autofree gchar *fn = g_build_filename (path, tmp, NULL);
+			if (g_file_test (fn, G_FILE_TEST_IS_DIR) ||
+			    g_str_has_suffix (tmp, ".icc") ||
+			    g_str_has_suffix (tmp, ".icm"))
+				cd_iccdump_add_path (items, fn);
+		}
+		return;
+	}
+	item = g_new0 (CdIccDumpItem, 1);
+	item->filename = g_strdup (path);
+	g_ptr_array_add (items, item);
 }
 
 int
 main (int argc, char **argv)
 {
+	CdIccDumpItem *item;
 	gboolean ret;
 	GOptionContext *context;
+	GThreadPool *pool = NULL;
 	gint i;
 	guint retval = EXIT_FAILURE;
 	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) items = NULL;
+	const GOptionEntry options[] = {
+		{ "ndjson", '\0', 0, G_OPTION_ARG_NONE, &ndjson,
+			/* TRANSLATORS: command line option */
+			_("Emit one machine-readable JSON object per profile"), NULL },
+		{ NULL}
+	};
 
 	setlocale (LC_ALL, "");
 
@@ -79,6 +205,7 @@ main (int argc, char **argv)
 	/* setup LCMS */
 	cmsSetLogErrorHandler (cd_fix_profile_error_cb);
 	context = g_option_context_new (NULL);
+	g_option_context_add_main_entries (context, options, NULL);
 
 	/* TRANSLATORS: program name */
 	g_set_application_name (_("ICC profile dump program"));
@@ -90,15 +217,36 @@ main (int argc, char **argv)
 		goto out;
 	}
 
-	/* dump each option */
-	for (i = 1; i < argc; i++) {
-		ret = cd_iccdump_print_file (argv[i], &error);
-		if (!ret) {
+	/* each argument is a filename or a directory to recurse into */
+	items = g_ptr_array_new_with_free_func ((GDestroyNotify) cd_iccdump_item_free);
+	for (i = 1; i < argc; i++)
+		cd_iccdump_add_path (items, argv[i]);
+
+	/* parse everything in parallel, then print the results in
+	 * argument order so the output stays deterministic */
+	pool = g_thread_pool_new (cd_iccdump_process_cb, NULL,
+				  (gint) g_get_num_processors (),
+				  FALSE, &error);
+	if (pool == NULL) {
+		g_print ("%s\n", error->message);
+		goto out;
+	}
+	for (i = 0; i < (gint) items->len; i++)
+		g_thread_pool_push (pool, g_ptr_array_index (items, i), NULL);
+	g_thread_pool_free (pool, FALSE, TRUE);
+	ret = TRUE;
+	for (i = 0; i < (gint) items->len; i++) {
+		item = g_ptr_array_index (items, i);
+		if (item->failure != NULL) {
 			g_warning ("Failed to dump %s: %s",
-				   argv[i], error->message);
-			goto out;
+				   item->filename, item->failure);
+			ret = FALSE;
+			continue;
 		}
+		g_print ("%s\n", item->output);
 	}
+	if (!ret)
+		goto out;
 
 	/* success */
 	retval = EXIT_SUCCESS;
@@ -446,6 +446,109 @@ cd_util_create_sp (CdUtilPrivate *priv,
 	return cd_it8_save_to_file (cmf, file, error);
 }
 
+typedef struct {
+	gchar		**argv;		/* command name then arguments */
+	GError		 *error;
+} CdUtilBatchJob;
+
+static void
+cd_util_batch_job_free (CdUtilBatchJob *job)
+{
+	g_strfreev (job->argv);
+	if (job->error != NULL)
+		g_error_free (job->error);
+	g_free (job);
+}
+
+static void
+cd_util_batch_thread_cb (gpointer data, gpointer user_data)
+{
+	CdUtilBatchJob *job = (CdUtilBatchJob *) data;
+	CdUtilPrivate *priv = (CdUtilPrivate *) user_data;
+	cd_util_run (priv, job->argv[0], &job->argv[1], &job->error);
+}
+
+static gboolean
+cd_util_batch (CdUtilPrivate *priv,
+	       gchar **values,
+	       GError **error)
+{
+	CdUtilBatchJob *job;
+	GThreadPool *pool;
+	guint failed = 0;
+	guint i;
+	g_autoptr(GIOChannel) channel = NULL;
+	g_autoptr(GPtrArray) jobs = NULL;
+
+	/* each line of standard input is one command with shell quoting,
+	 * e.g. "create-sp out.sp in.csv 1.0"; jobs start on the pool as
+	 * soon as they are read so conversion overlaps the input stream */
+	jobs = g_ptr_array_new_with_free_func ((GDestroyNotify) cd_util_batch_job_free);
+	pool = g_thread_pool_new (cd_util_batch_thread_cb,
+				  priv,
+				  (gint) g_get_num_processors (),
+				  FALSE,
+				  NULL);
+	channel = g_io_channel_unix_new (fileno (stdin));
+	while (TRUE) {
+		GIOStatus status;
+		g_autofree gchar *line = NULL;
+		g_autoptr(GError) error_local = NULL;
+		g_auto(GStrv) job_argv = NULL;
+
+		status = g_io_channel_read_line (channel, &line,
+						 NULL, NULL, &error_local);
+		if (status == G_IO_STATUS_EOF)
+			break;
+		if (status != G_IO_STATUS_NORMAL) {
+			g_printerr ("Failed to read job: %s\n",
+				    error_local->message);
+			failed++;
+			break;
+		}
+		g_strchomp (line);
+		if (line[0] == '\0' || line[0] == '#')
+			continue;
+		if (!g_shell_parse_argv (line, NULL, &job_argv, &error_local)) {
+			g_printerr ("Invalid job '%s': %s\n",
+				    line, error_local->message);
+			failed++;
+			continue;
+		}
+		if (g_strcmp0 (job_argv[0], "batch") == 0) {
+			g_printerr ("Refusing recursive job '%s'\n", line);
+			failed++;
+			continue;
+		}
+		job = g_new0 (CdUtilBatchJob, 1);
+		job->argv = g_steal_pointer (&job_argv);
+		g_ptr_array_add (jobs, job);
+		g_thread_pool_push (pool, job, NULL);
+	}
+
+	/* waits for all the workers to finish */
+	g_thread_pool_free (pool, FALSE, TRUE);
+
+	/* report failures against the command that caused them */
+	for (i = 0; i < jobs->len; i++) {
+		g_autofree gchar *cmdline = NULL;
+		job = g_ptr_array_index (jobs, i);
+		if (job->error == NULL)
+			continue;
+		cmdline = g_strjoinv (" ", job->argv);
+		g_printerr ("Failed '%s': %s\n", cmdline, job->error->message);
+		failed++;
+	}
+	if (failed > 0) {
+		g_set_error (error,
+			     CD_ERROR,
+			     CD_ERROR_INVALID_ARGUMENTS,
+			     "%u jobs failed", failed);
+		return FALSE;
+	}
+	return TRUE;
+}
+
 static void
 cd_util_ignore_cb (const gchar *log_domain, GLogLevelFlags log_level,
 		   const gchar *message, gpointer user_data)
@@ -502,6 +605,12 @@ main (int argc, char *argv[])
 		     /* TRANSLATORS: command description */
 		     _("Create a CCMX from reference and measurement data"),
 		     cd_util_calculate_ccmx);
+	cd_util_add (priv->cmd_array,
+		     "batch",
+		     NULL,
+		     /* TRANSLATORS: command description */
+		     _("Run commands read from standard input in parallel"),
+		     cd_util_batch);
 
 	/* sort by command name */
 	g_ptr_array_sort (priv->cmd_array,
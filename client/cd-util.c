@@ -738,6 +738,16 @@ cd_util_get_descriptions (GPtrArray *array)
 	return g_string_free (string, FALSE);
 }
 
+static gboolean
+cd_util_connect (CdUtilPrivate *priv, GError **error)
+{
+	/* only pay for the bus round trip when a command needs the
+	 * daemon; --help and usage errors stay off the bus entirely */
+	if (cd_client_get_connected (priv->client))
+		return TRUE;
+	return cd_client_connect_sync (priv->client, NULL, error);
+}
+
 static gboolean
 cd_util_run (CdUtilPrivate *priv, const gchar *command, gchar **values, GError **error)
 {
@@ -748,8 +758,11 @@ cd_util_run (CdUtilPrivate *priv, const gchar *command, gchar **values, GError *
 	/* find command */
 	for (i = 0; i < priv->cmd_array->len; i++) {
 		item = g_ptr_array_index (priv->cmd_array, i);
-		if (g_strcmp0 (item->name, command) == 0)
+		if (g_strcmp0 (item->name, command) == 0) {
+			if (!cd_util_connect (priv, error))
+				return FALSE;
 			return item->callback (priv, values, error);
+		}
 	}
 
 	/* not found */
@@ -767,6 +780,161 @@ cd_util_run (CdUtilPrivate *priv, const gchar *command, gchar **values, GError *
 	return FALSE;
 }
 
+static gchar *
+cd_util_monitor_escape (const gchar *str)
+{
+	GString *tmp = g_string_new (NULL);
+	guint i;
+	for (i = 0; str[i] != '\0'; i++) {
+		if (str[i] == '"' || str[i] == '\\')
+			g_string_append_printf (tmp, "\\%c", str[i]);
+		else if ((guchar) str[i] < 0x20)
+			g_string_append_printf (tmp, "\\u%04x", str[i]);
+		else
+			g_string_append_c (tmp, str[i]);
+	}
+	return g_string_free (tmp, FALSE);
+}
+
+static void
+cd_util_monitor_emit (const gchar *object,
+		      const gchar *event,
+		      const gchar *object_path)
+{
+	g_autofree gchar *path_esc = NULL;
+
+	/* one JSON object per line, suitable for a script pipeline */
+	g_print ("{\"object\":\"%s\",\"event\":\"%s\"", object, event);
+	if (object_path != NULL) {
+		path_esc = cd_util_monitor_escape (object_path);
+		g_print (",\"object-path\":\"%s\"", path_esc);
+	}
+	g_print (",\"seconds\":%.3f}\n",
+		 (gdouble) g_get_real_time () / (gdouble) G_USEC_PER_SEC);
+	fflush (stdout);
+}
+
+static void
+cd_util_monitor_device_cb (CdClient *client,
+			   CdDevice *device,
+			   gpointer user_data)
+{
+	cd_util_monitor_emit ("device",
+			      (const gchar *) user_data,
+			      cd_device_get_object_path (device));
+}
+
+static void
+cd_util_monitor_profile_cb (CdClient *client,
+			    CdProfile *profile,
+			    gpointer user_data)
+{
+	cd_util_monitor_emit ("profile",
+			      (const gchar *) user_data,
+			      cd_profile_get_object_path (profile));
+}
+
+static void
+cd_util_monitor_sensor_cb (CdClient *client,
+			   CdSensor *sensor,
+			   gpointer user_data)
+{
+	cd_util_monitor_emit ("sensor",
+			      (const gchar *) user_data,
+			      cd_sensor_get_object_path (sensor));
+}
+
+static void
+cd_util_monitor_changed_cb (CdClient *client, gpointer user_data)
+{
+	cd_util_monitor_emit ("daemon", "changed", NULL);
+}
+
+static gboolean
+cd_util_monitor (CdUtilPrivate *priv, gchar **values, GError **error)
+{
+	g_autoptr(GMainLoop) loop = NULL;
+
+	/* print incremental updates from the one connection rather than
+	 * having scripts re-enumerate everything on a timer */
+	g_signal_connect (priv->client, "device-added",
+			  G_CALLBACK (cd_util_monitor_device_cb),
+			  (gpointer) "added");
+	g_signal_connect (priv->client, "device-removed",
+			  G_CALLBACK (cd_util_monitor_device_cb),
+			  (gpointer) "removed");
+	g_signal_connect (priv->client, "device-changed",
+			  G_CALLBACK (cd_util_monitor_device_cb),
+			  (gpointer) "changed");
+	g_signal_connect (priv->client, "profile-added",
+			  G_CALLBACK (cd_util_monitor_profile_cb),
+			  (gpointer) "added");
+	g_signal_connect (priv->client, "profile-removed",
+			  G_CALLBACK (cd_util_monitor_profile_cb),
+			  (gpointer) "removed");
+	g_signal_connect (priv->client, "profile-changed",
+			  G_CALLBACK (cd_util_monitor_profile_cb),
+			  (gpointer) "changed");
+	g_signal_connect (priv->client, "sensor-added",
+			  G_CALLBACK (cd_util_monitor_sensor_cb),
+			  (gpointer) "added");
+	g_signal_connect (priv->client, "sensor-removed",
+			  G_CALLBACK (cd_util_monitor_sensor_cb),
+			  (gpointer) "removed");
+	g_signal_connect (priv->client, "sensor-changed",
+			  G_CALLBACK (cd_util_monitor_sensor_cb),
+			  (gpointer) "changed");
+	g_signal_connect (priv->client, "changed",
+			  G_CALLBACK (cd_util_monitor_changed_cb),
+			  NULL);
+
+	/* run until killed */
+	loop = g_main_loop_new (NULL, FALSE);
+	g_main_loop_run (loop);
+	return TRUE;
+}
+
+static gboolean
+cd_util_batch (CdUtilPrivate *priv, gchar **values, GError **error)
+{
+	gboolean any_failed = FALSE;
+	gchar buffer[1024];
+
+	/* run each line from stdin as a command, sharing the one daemon
+	 * connection rather than paying a process and connect per call */
+	while (fgets (buffer, sizeof (buffer), stdin) != NULL) {
+		gint cmd_argc = 0;
+		g_auto(GStrv) cmd_argv = NULL;
+		g_autoptr(GError) error_local = NULL;
+
+		/* skip blank lines and comments */
+		g_strstrip (buffer);
+		if (buffer[0] == '\0' || buffer[0] == '#')
+			continue;
+
+		/* split into command and arguments */
+		if (!g_shell_parse_argv (buffer, &cmd_argc, &cmd_argv, &error_local)) {
+			g_print ("%s: %s\n", buffer, error_local->message);
+			any_failed = TRUE;
+			continue;
+		}
+
+		/* a failed command does not stop the batch */
+		if (!cd_util_run (priv, cmd_argv[0], &cmd_argv[1], &error_local)) {
+			g_print ("%s: %s\n", cmd_argv[0], error_local->message);
+			any_failed = TRUE;
+		}
+	}
+	if (any_failed) {
+		g_set_error_literal (error,
+				     CD_ERROR,
+				     CD_ERROR_INVALID_ARGUMENTS,
+				     "At least one batched command failed");
+		return FALSE;
+	}
+	return TRUE;
+}
+
 static gboolean
 cd_util_dump (CdUtilPrivate *priv, gchar **values, GError **error)
 {
@@ -2214,6 +2382,18 @@ main (int argc, char *argv[])
 		     /* TRANSLATORS: command description */
 		     _("Import a profile and install it for the user"),
 		     cd_util_import_profile);
+	cd_util_add (priv->cmd_array,
+		     "batch",
+		     NULL,
+		     /* TRANSLATORS: command description */
+		     _("Run commands from standard input, one per line"),
+		     cd_util_batch);
+	cd_util_add (priv->cmd_array,
+		     "monitor",
+		     NULL,
+		     /* TRANSLATORS: command description */
+		     _("Watch the daemon and print one JSON event per line"),
+		     cd_util_monitor);
 
 	/* sort by command name */
 	g_ptr_array_sort (priv->cmd_array,
@@ -2248,18 +2428,18 @@ main (int argc, char *argv[])
 				   cd_util_ignore_cb, NULL);
 	}
 
-	/* get connection to colord */
+	/* connection to colord is made when a command first needs it */
 	priv->client = cd_client_new ();
-	ret = cd_client_connect_sync (priv->client, NULL, &error);
-	if (!ret) {
-		/* TRANSLATORS: no colord available */
-		g_print ("%s %s\n", _("No connection to colord:"),
-			 error->message);
-		goto out;
-	}
 
 	/* get version */
 	if (version) {
+		ret = cd_util_connect (priv, &error);
+		if (!ret) {
+			/* TRANSLATORS: no colord available */
+			g_print ("%s %s\n", _("No connection to colord:"),
+				 error->message);
+			goto out;
+		}
 		g_print ("%s\t%s\n", _("Client version:"),
 			 PACKAGE_VERSION);
 		g_print ("%s\t%s\n", _("Daemon version:"),
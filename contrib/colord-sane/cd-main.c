@@ -24,21 +24,34 @@
 
 #include <gio/gio.h>
 #include <glib/gi18n.h>
+#include <glib/gstdio.h>
 #include <locale.h>
 #include <sane/sane.h>
 #include <gudev/gudev.h>
 #include <dbus/dbus.h>
 #include <colord/colord.h>
 
+/* how long a stuck SANE backend may block discovery before we give up */
+#define CD_MAIN_PROBE_TIMEOUT_SECS	30
+
+/* a change to the backend configuration invalidates the identity cache */
+#define CD_MAIN_SANE_CONFIG_DIR		"/etc/sane.d"
+
 typedef struct {
-	gchar		*argv0;
-	CdClient	*client;
-	GMainLoop	*loop;
-	GPtrArray	*array; /* of CdMainDev's */
+	gchar			*argv0;
+	CdClient		*client;
+	GMainLoop		*loop;
+	GPtrArray		*array; /* of CdMainDev's */
+	const SANE_Device	**device_list;
+	SANE_Status		 sane_status;
+	gboolean		 sane_done;
+	gboolean		 colord_done;
+	guint			 watchdog_id;
+	guint			 pending; /* in-flight create/delete calls */
 } CdMainPrivate;
 
 typedef struct {
-	CdDevice	*device;
+	CdDevice	*device; /* NULL while the create call is in flight */
 	gchar		*id; /* note: we can get this from CdDevice, but we don't wan't to connect() */
 	gboolean	 valid;
 } CdMainDev;
@@ -46,7 +59,8 @@ typedef struct {
 static void
 cd_main_dev_free (CdMainDev *tmp)
 {
-	g_object_unref (tmp->device);
+	if (tmp->device != NULL)
+		g_object_unref (tmp->device);
 	g_free (tmp->id);
 	g_free (tmp);
 }
@@ -80,53 +94,100 @@ typedef struct {
 	gchar		*id;
 } CdMainCreateDeviceHelper;
 
+static void
+cd_main_maybe_quit (CdMainPrivate *priv)
+{
+	/* everything reconciled and no calls still in flight */
+	if (priv->sane_done && priv->colord_done && priv->pending == 0)
+		g_main_loop_quit (priv->loop);
+}
+
+static void
+cd_main_colord_delete_device_cb (GObject *source_object,
+				 GAsyncResult *res,
+				 gpointer user_data)
+{
+	CdClient *client = CD_CLIENT (source_object);
+	CdMainPrivate *priv = (CdMainPrivate *) user_data;
+	g_autoptr(GError) error = NULL;
+
+	/* get result */
+	if (!cd_client_delete_device_finish (client, res, &error))
+		g_warning ("failed to delete device: %s", error->message);
+	priv->pending--;
+	cd_main_maybe_quit (priv);
+}
+
+static void
+cd_sane_client_remove (CdMainPrivate *priv, CdDevice *device)
+{
+	g_debug ("Deleting device: %s", cd_device_get_object_path (device));
+	priv->pending++;
+	cd_client_delete_device (priv->client,
+				 device,
+				 NULL,
+				 cd_main_colord_delete_device_cb,
+				 priv);
+}
+
 static void
 cd_main_colord_create_device_cb (GObject *source_object,
 				 GAsyncResult *res,
 				 gpointer user_data)
 {
 	CdClient *client = CD_CLIENT (source_object);
+	CdMainCreateDeviceHelper *helper = (CdMainCreateDeviceHelper *) user_data;
+	CdMainPrivate *priv = helper->priv;
+	CdMainDev *dev;
 	g_autoptr(GError) error = NULL;
 	g_autoptr(CdDevice) device = NULL;
 
 	/* get result */
+	priv->pending--;
 	device = cd_client_create_device_finish (client, res, &error);
-	if (device == NULL)
+	if (device == NULL) {
 		g_warning ("failed to create device: %s", error->message);
+	} else {
+		dev = cd_main_dev_find_by_id (priv, helper->id);
+		if (dev != NULL && dev->device == NULL) {
+			dev->device = g_object_ref (device);
+			/* registered from a stale cache entry: the probe has
+			 * since finished without finding it, so take it back */
+			if (priv->sane_done && priv->colord_done && !dev->valid)
+				cd_sane_client_remove (priv, dev->device);
+		}
+	}
+	g_free (helper->id);
+	g_free (helper);
+	cd_main_maybe_quit (priv);
 }
 
 static void
-cd_sane_client_add (CdMainPrivate *priv, const SANE_Device *sane_device)
+cd_sane_client_register (CdMainPrivate *priv,
+			 const gchar *id,
+			 const gchar *name,
+			 const gchar *vendor_raw,
+			 const gchar *model_raw,
+			 gboolean valid)
 {
+	CdMainCreateDeviceHelper *helper;
 	CdMainDev *dev;
-	g_autofree gchar *id = NULL;
 	g_autofree gchar *model = NULL;
 	g_autofree gchar *vendor = NULL;
 	g_autoptr(GHashTable) properties = NULL;
 
-	/* ignore noname, no support devices */
-	if (g_strcmp0 (sane_device->vendor, "Noname") == 0) {
-		g_debug ("CdSaneClient: Ignoring sane device %s",
-			 sane_device->name);
-		return;
-	}
-
-	/* convert device_id 'plustek:libusb:004:002' to suitable id */
-	id = cd_client_get_id_for_sane_device (sane_device);
-
-	/* see if this device already exists */
-	dev = cd_main_dev_find_by_id (priv, id);
-	if (dev != NULL) {
-		dev->valid = TRUE;
-		return;
-	}
-
 	/* Make human readable */
-	model = g_strdup (sane_device->model);
+	model = g_strdup (model_raw);
 	g_strdelimit (model, "_", ' ');
-	vendor = g_strdup (sane_device->vendor);
+	vendor = g_strdup (vendor_raw);
 	g_strdelimit (vendor, "_", ' ');
 
+	/* track it from the moment the call goes out */
+	dev = g_new0 (CdMainDev, 1);
+	dev->id = g_strdup (id);
+	dev->valid = valid;
+	g_ptr_array_add (priv->array, dev);
+
 	/* create initial device properties */
 	properties = g_hash_table_new_full (g_str_hash, g_str_equal,
 					      NULL, NULL);
@@ -147,86 +208,220 @@ cd_sane_client_add (CdMainPrivate *priv, const SANE_Device *sane_device)
 			     (gpointer) model);
 	g_hash_table_insert (properties,
 			     (gpointer) CD_DEVICE_PROPERTY_SERIAL,
-			     (gpointer) sane_device->name);
+			     (gpointer) name);
 #if 0
 	g_hash_table_insert (properties,
 			     (gpointer) CD_DEVICE_METADATA_OWNER_CMDLINE,
 			     (gpointer) priv->argv0);
 #endif
+	helper = g_new0 (CdMainCreateDeviceHelper, 1);
+	helper->priv = priv;
+	helper->id = g_strdup (id);
+	priv->pending++;
 	cd_client_create_device (priv->client,
 				 id,
 				 CD_OBJECT_SCOPE_NORMAL,
 				 properties,
 				 NULL,
 				 cd_main_colord_create_device_cb,
+				 helper);
+}
+
+static void
+cd_sane_client_add (CdMainPrivate *priv, const SANE_Device *sane_device)
+{
+	CdMainDev *dev;
+	g_autofree gchar *id = NULL;
+
+	/* ignore noname, no support devices */
+	if (g_strcmp0 (sane_device->vendor, "Noname") == 0) {
+		g_debug ("CdSaneClient: Ignoring sane device %s",
+			 sane_device->name);
+		return;
+	}
+
+	/* convert device_id 'plustek:libusb:004:002' to suitable id */
+	id = cd_client_get_id_for_sane_device (sane_device);
+
+	/* see if this device already exists */
+	dev = cd_main_dev_find_by_id (priv, id);
+	if (dev != NULL) {
+		dev->valid = TRUE;
+		return;
+	}
+	cd_sane_client_register (priv, id,
+				 sane_device->name,
+				 sane_device->vendor,
+				 sane_device->model,
+				 TRUE);
+}
+
+static gchar *
+cd_main_cache_get_path (void)
+{
+	return g_build_filename (g_get_user_cache_dir (),
+				 "colord-sane",
+				 "devices.ini",
 				 NULL);
 }
 
 static void
-cd_main_colord_delete_device_cb (GObject *source_object,
-				 GAsyncResult *res,
-				 gpointer user_data)
+cd_main_cache_register (CdMainPrivate *priv)
 {
-	CdClient *client = CD_CLIENT (source_object);
-	g_autoptr(GError) error = NULL;
+	GStatBuf st_cache;
+	GStatBuf st_config;
+	guint i;
+	g_autofree gchar *path = cd_main_cache_get_path ();
+	g_auto(GStrv) groups = NULL;
+	g_autoptr(GKeyFile) keyfile = NULL;
 
-	/* get result */
-	if (!cd_client_delete_device_finish (client, res, &error))
-		g_warning ("failed to delete device: %s", error->message);
+	/* no identities saved yet */
+	if (g_stat (path, &st_cache) != 0)
+		return;
+
+	/* the cache is older than the backend configuration */
+	if (g_stat (CD_MAIN_SANE_CONFIG_DIR, &st_config) == 0 &&
+	    st_config.st_mtime > st_cache.st_mtime) {
+		g_debug ("ignoring identity cache older than %s",
+			 CD_MAIN_SANE_CONFIG_DIR);
+		return;
+	}
+	keyfile = g_key_file_new ();
+	if (!g_key_file_load_from_file (keyfile, path, G_KEY_FILE_NONE, NULL))
+		return;
+
+	/* register each remembered scanner right away; the probe running
+	 * in the background reconciles any that have gone away */
+	groups = g_key_file_get_groups (keyfile, NULL);
+	for (i = 0; groups[i] != NULL; i++) {
+		g_autofree gchar *model = NULL;
+		g_autofree gchar *name = NULL;
+		g_autofree gchar *vendor = NULL;
+		if (cd_main_dev_find_by_id (priv, groups[i]) != NULL)
+			continue;
+		name = g_key_file_get_string (keyfile, groups[i], "Name", NULL);
+		vendor = g_key_file_get_string (keyfile, groups[i], "Vendor", NULL);
+		model = g_key_file_get_string (keyfile, groups[i], "Model", NULL);
+		if (name == NULL || vendor == NULL || model == NULL)
+			continue;
+		g_debug ("registering %s from identity cache", groups[i]);
+		cd_sane_client_register (priv, groups[i],
+					 name, vendor, model, FALSE);
+	}
 }
 
 static void
-cd_sane_client_remove (CdMainPrivate *priv, CdDevice *device)
+cd_main_cache_save (CdMainPrivate *priv)
 {
-	g_debug ("Deleting device: %s", cd_device_get_object_path (device));
-	cd_client_delete_device (priv->client,
-				 device,
-				 NULL,
-				 cd_main_colord_delete_device_cb,
-				 priv);
+	gint idx;
+	g_autofree gchar *dirname = NULL;
+	g_autofree gchar *path = cd_main_cache_get_path ();
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GKeyFile) keyfile = NULL;
+
+	keyfile = g_key_file_new ();
+	for (idx = 0; priv->device_list != NULL &&
+		      priv->device_list[idx] != NULL; idx++) {
+		const SANE_Device *sane_device = priv->device_list[idx];
+		g_autofree gchar *id = NULL;
+		if (g_strcmp0 (sane_device->vendor, "Noname") == 0)
+			continue;
+		id = cd_client_get_id_for_sane_device (sane_device);
+		g_key_file_set_string (keyfile, id, "Name", sane_device->name);
+		g_key_file_set_string (keyfile, id, "Vendor", sane_device->vendor);
+		g_key_file_set_string (keyfile, id, "Model", sane_device->model);
+	}
+
+	/* failing to save just means a cold start next time */
+	dirname = g_path_get_dirname (path);
+	g_mkdir_with_parents (dirname, 0755);
+	if (!g_key_file_save_to_file (keyfile, path, &error))
+		g_debug ("failed to save identity cache: %s", error->message);
 }
 
 static void
-cd_sane_client_refresh (CdMainPrivate *priv)
+cd_sane_client_refresh_maybe (CdMainPrivate *priv)
 {
 	CdMainDev *tmp;
-	const SANE_Device **device_list = NULL;
 	gint idx;
 	guint i;
-	SANE_Status status;
 
-	status = sane_init (NULL, NULL);
-	if (status != SANE_STATUS_GOOD) {
-		g_warning ("failed to init SANE: %s",
-			   sane_strstatus (status));
-		goto out;
+	/* the SANE probe and the daemon enumeration run concurrently;
+	 * reconcile only when both have completed */
+	if (!priv->sane_done || !priv->colord_done)
+		return;
+	if (priv->watchdog_id != 0) {
+		g_source_remove (priv->watchdog_id);
+		priv->watchdog_id = 0;
 	}
-
-	/* get scanners on the local server */
-	status = sane_get_devices (&device_list, TRUE);
-	if (status != SANE_STATUS_GOOD) {
+	if (priv->sane_status != SANE_STATUS_GOOD) {
 		g_warning ("failed to get devices from SANE: %s",
-			   sane_strstatus (status));
+			   sane_strstatus (priv->sane_status));
 		goto out;
 	}
 
-	/* nothing */
-	if (device_list == NULL || device_list[0] == NULL)
-		goto out;
-
 	/* add them */
-	for (idx = 0; device_list[idx] != NULL; idx++)
-		cd_sane_client_add (priv, device_list[idx]);
+	for (idx = 0; priv->device_list != NULL &&
+		      priv->device_list[idx] != NULL; idx++)
+		cd_sane_client_add (priv, priv->device_list[idx]);
 
-	/* remove any that are invalid */
+	/* remove any that are invalid; entries with no device yet are
+	 * still being created and get deleted when that call returns */
 	for (i = 0; i < priv->array->len; i++) {
 		tmp = g_ptr_array_index (priv->array, i);
-		if (tmp->valid)
+		if (tmp->valid || tmp->device == NULL)
 			continue;
 		cd_sane_client_remove (priv, tmp->device);
 	}
+
+	/* remember the identities for the next activation */
+	cd_main_cache_save (priv);
 out:
+	cd_main_maybe_quit (priv);
+}
+
+static void
+cd_sane_probe_thread_cb (GTask *task,
+			 gpointer source_object,
+			 gpointer task_data,
+			 GCancellable *cancellable)
+{
+	CdMainPrivate *priv = (CdMainPrivate *) task_data;
+
+	/* sane_get_devices() walks every configured backend serially and
+	 * blocks, so keep it off the main context */
+	priv->sane_status = sane_init (NULL, NULL);
+	if (priv->sane_status != SANE_STATUS_GOOD) {
+		g_task_return_boolean (task, TRUE);
+		return;
+	}
+
+	/* get scanners on the local server */
+	priv->sane_status = sane_get_devices (&priv->device_list, TRUE);
+	g_task_return_boolean (task, TRUE);
+}
+
+static void
+cd_sane_probe_cb (GObject *source_object,
+		  GAsyncResult *res,
+		  gpointer user_data)
+{
+	CdMainPrivate *priv = (CdMainPrivate *) user_data;
+	priv->sane_done = TRUE;
+	cd_sane_client_refresh_maybe (priv);
+}
+
+static gboolean
+cd_main_watchdog_cb (gpointer user_data)
+{
+	CdMainPrivate *priv = (CdMainPrivate *) user_data;
+
+	/* a hung network backend must not wedge the helper forever */
+	g_warning ("discovery did not complete in %i seconds, giving up",
+		   CD_MAIN_PROBE_TIMEOUT_SECS);
+	priv->watchdog_id = 0;
 	g_main_loop_quit (priv->loop);
+	return G_SOURCE_REMOVE;
 }
 
 static void
@@ -253,7 +448,7 @@ cd_sane_add_device_if_from_colord_sane (gpointer data,
 	if (g_strcmp0 (cmdline, priv->argv0) == 0) {
 		sane_device = g_new (CdMainDev, 1);
 		sane_device->device = g_object_ref (device);
-		sane_device->id = (gchar *)cd_device_get_id (device);
+		sane_device->id = g_strdup (cd_device_get_id (device));
 		sane_device->valid = FALSE;
 		g_ptr_array_add (priv->array, sane_device);
 	}
@@ -272,6 +467,7 @@ cd_sane_populate_existing_devices_cb (GObject *source_object,
 	if (error != NULL) {
 		g_warning ("failed to receive list of devices: %s",
 			   error->message);
+		g_main_loop_quit (priv->loop);
 		return;
 	}
 
@@ -279,7 +475,12 @@ cd_sane_populate_existing_devices_cb (GObject *source_object,
 			     cd_sane_add_device_if_from_colord_sane,
 			     priv);
 
-	cd_sane_client_refresh (priv);
+	/* register anything remembered from the last run without waiting
+	 * for the slow probe to finish */
+	cd_main_cache_register (priv);
+
+	priv->colord_done = TRUE;
+	cd_sane_client_refresh_maybe (priv);
 }
 
 static void
@@ -296,6 +497,7 @@ cd_main_colord_connect_cb (GObject *source_object,
 	if (!ret) {
 		g_warning ("failed to connect to colord: %s",
 			   error->message);
+		g_main_loop_quit (priv->loop);
 		return;
 	}
 
@@ -311,6 +513,7 @@ main (int argc, char *argv[])
 {
 	CdMainPrivate *priv = NULL;
 	guint retval = 1;
+	g_autoptr(GTask) task = NULL;
 
 	/* We need to init DBus' threading support as libSANE uses raw DBus */
 	dbus_threads_init_default ();
@@ -322,6 +525,15 @@ main (int argc, char *argv[])
 	priv->argv0 = g_strdup (argv[0]);
 	priv->array = g_ptr_array_new_with_free_func ((GDestroyNotify) cd_main_dev_free);
 
+	/* probe the SANE backends in a worker thread while the daemon
+	 * connection and device enumeration happen on the main context */
+	task = g_task_new (NULL, NULL, cd_sane_probe_cb, priv);
+	g_task_set_task_data (task, priv, NULL);
+	g_task_run_in_thread (task, cd_sane_probe_thread_cb);
+	priv->watchdog_id = g_timeout_add_seconds (CD_MAIN_PROBE_TIMEOUT_SECS,
+						   cd_main_watchdog_cb,
+						   priv);
+
 	/* connect to daemon */
 	cd_client_connect (priv->client,
 			   NULL,
@@ -335,6 +547,10 @@ main (int argc, char *argv[])
 	retval = 0;
 
 	if (priv != NULL) {
+		/* if the probe thread is still stuck inside a backend it can
+		 * still write into priv, so just leak and exit */
+		if (!priv->sane_done)
+			return retval;
 		g_free (priv->argv0);
 		if (priv->array != NULL)
 			g_ptr_array_unref (priv->array);
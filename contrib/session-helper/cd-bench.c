@@ -0,0 +1,317 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2012 Richard Hughes <richard@hughsie.com>
+ *
+ * Licensed under the GNU General Public License Version 2
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/* colord-bench-calibration: a headless stand-in for the calibration UI
+ * that drives the session helper end-to-end, normally against the dummy
+ * sensor backend with COLORD_SENSOR_DUMMY_INTEGRATION_MS set low. It
+ * plays the display client role (acknowledging gamma uploads and
+ * resuming any interaction immediately) and reports patches per second
+ * with a per-phase breakdown, so the display/measure overlap, adaptive
+ * settle and ramp-diff optimizations have a regression gate that needs
+ * no physical instrument. */
+
+#include "config.h"
+
+#include <colord-private.h>
+#include <gio/gio.h>
+#include <glib.h>
+#include <math.h>
+#include <stdlib.h>
+
+typedef enum {
+	CD_BENCH_PHASE_NONE,
+	CD_BENCH_PHASE_DISPLAY,		/* after UpdateGamma, before UpdateSample */
+	CD_BENCH_PHASE_MEASURE		/* after UpdateSample, before UpdateGamma */
+} CdBenchPhase;
+
+typedef struct {
+	GMainLoop		*loop;
+	GDBusProxy		*proxy;
+	CdBenchPhase		 phase;
+	gint64			 started;	/* monotonic, us */
+	gint64			 last_event;	/* monotonic, us */
+	gint64			 display_us;	/* gamma upload + settle */
+	gint64			 measure_us;	/* sensor integration */
+	guint			 gamma_cnt;
+	guint			 sample_cnt;
+	guint			 finished_code;
+} CdBenchPrivate;
+
+/* accounts the time since the last signal to the phase we were in */
+static void
+cd_bench_phase_transition (CdBenchPrivate *priv, CdBenchPhase phase)
+{
+	gint64 now = g_get_monotonic_time ();
+
+	switch (priv->phase) {
+	case CD_BENCH_PHASE_DISPLAY:
+		priv->display_us += now - priv->last_event;
+		break;
+	case CD_BENCH_PHASE_MEASURE:
+		priv->measure_us += now - priv->last_event;
+		break;
+	default:
+		break;
+	}
+	priv->phase = phase;
+	priv->last_event = now;
+}
+
+static void
+cd_bench_resume_cb (GObject *source_object,
+		    GAsyncResult *res,
+		    gpointer user_data)
+{
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GVariant) retval = NULL;
+
+	retval = g_dbus_proxy_call_finish (G_DBUS_PROXY (source_object),
+					   res, &error);
+	if (retval == NULL)
+		g_warning ("failed to send Resume: %s", error->message);
+}
+
+static void
+cd_bench_signal_cb (GDBusProxy *proxy,
+		    const gchar *sender_name,
+		    const gchar *signal_name,
+		    GVariant *parameters,
+		    CdBenchPrivate *priv)
+{
+	const gchar *message;
+	const gchar *image;
+	guint code;
+	g_autoptr(GVariant) dict = NULL;
+
+	if (g_strcmp0 (signal_name, "Finished") == 0) {
+		g_variant_get (parameters, "(u@a{sv})",
+			       &priv->finished_code, &dict);
+		if (priv->finished_code != 0) {
+			const gchar *str = NULL;
+			g_variant_lookup (dict, "ErrorDetails", "&s", &str);
+			g_warning ("calibration failed with code %u: %s",
+				   priv->finished_code, str);
+		}
+		cd_bench_phase_transition (priv, CD_BENCH_PHASE_NONE);
+		g_main_loop_quit (priv->loop);
+		return;
+	}
+	if (g_strcmp0 (signal_name, "UpdateGamma") == 0) {
+		/* a real client would upload the ramp to the CRTC here;
+		 * the measured phase still includes the helper-side
+		 * settle delay that dominates it */
+		cd_bench_phase_transition (priv, CD_BENCH_PHASE_DISPLAY);
+		priv->gamma_cnt++;
+		return;
+	}
+	if (g_strcmp0 (signal_name, "UpdateSample") == 0) {
+		cd_bench_phase_transition (priv, CD_BENCH_PHASE_MEASURE);
+		priv->sample_cnt++;
+		return;
+	}
+	if (g_strcmp0 (signal_name, "InteractionRequired") == 0) {
+		/* no user present; continue straight away */
+		g_variant_get (parameters, "(u&s&s)",
+			       &code, &message, &image);
+		g_debug ("auto-resuming interaction %u: %s", code, message);
+		g_dbus_proxy_call (priv->proxy,
+				   "Resume",
+				   NULL,
+				   G_DBUS_CALL_FLAGS_NONE,
+				   -1,
+				   NULL,
+				   cd_bench_resume_cb,
+				   priv);
+		return;
+	}
+}
+
+int
+main (int argc, char **argv)
+{
+	CdBenchPrivate *priv = NULL;
+	gboolean ret = TRUE;
+	gchar *device_id = NULL;
+	gchar *quality = NULL;
+	gchar *sensor_id = NULL;
+	gchar *title = NULL;
+	GDBusConnection *connection = NULL;
+	gdouble elapsed;
+	gdouble gamma = 2.2f;
+	g_autoptr(GError) error = NULL;
+	gint retval = EXIT_FAILURE;
+	GOptionContext *context;
+	guint quality_value = 0;
+	guint whitepoint = 0;
+	GVariantBuilder builder;
+	GVariant *retvax = NULL;
+
+	const GOptionEntry options[] = {
+		{ "device", '\0', 0, G_OPTION_ARG_STRING, &device_id,
+			/* TRANSLATORS: command line option */
+			"Use this device for profiling", NULL },
+		{ "sensor", '\0', 0, G_OPTION_ARG_STRING, &sensor_id,
+			/* TRANSLATORS: command line option */
+			"Use this sensor for profiling", NULL },
+		{ "quality", '\0', 0, G_OPTION_ARG_STRING, &quality,
+			/* TRANSLATORS: command line option */
+			"Use this quality setting: low,medium,high", NULL },
+		{ "whitepoint", '\0', 0, G_OPTION_ARG_INT, &whitepoint,
+			/* TRANSLATORS: command line option */
+			"Target this specific whitepoint, or 0 for native", NULL },
+		{ "gamma", '\0', 0, G_OPTION_ARG_DOUBLE, &gamma,
+			/* TRANSLATORS: command line option */
+			"Target this gamma (default 2.2)", NULL },
+		{ NULL}
+	};
+
+	context = g_option_context_new ("colord-session calibration benchmark");
+	g_option_context_add_main_entries (context, options, NULL);
+	ret = g_option_context_parse (context, &argc, &argv, &error);
+	if (!ret)
+		goto out;
+
+	priv = g_new0 (CdBenchPrivate, 1);
+	priv->loop = g_main_loop_new (NULL, FALSE);
+
+	/* check required arguments */
+	if (device_id == NULL) {
+		ret = FALSE;
+		g_set_error (&error, 1, 0, "--device is required");
+		goto out;
+	}
+	if (sensor_id == NULL) {
+		ret = FALSE;
+		g_set_error (&error, 1, 0, "--sensor is required");
+		goto out;
+	}
+
+	/* parse quality string */
+	if (quality == NULL || g_strcmp0 (quality, "low") == 0) {
+		quality_value = 0;
+	} else if (g_strcmp0 (quality, "medium") == 0) {
+		quality_value = 1;
+	} else if (g_strcmp0 (quality, "high") == 0) {
+		quality_value = 2;
+	} else {
+		ret = FALSE;
+		g_set_error (&error, 1, 0, "--quality value not known");
+		goto out;
+	}
+
+	/* start the calibration session daemon */
+	connection = g_bus_get_sync (G_BUS_TYPE_SESSION, NULL, &error);
+	if (connection == NULL) {
+		ret = FALSE;
+		goto out;
+	}
+	priv->proxy = g_dbus_proxy_new_sync (connection,
+					     G_DBUS_PROXY_FLAGS_NONE,
+					     NULL,
+					     "org.freedesktop.ColorHelper",
+					     "/",
+					     "org.freedesktop.ColorHelper.Display",
+					     NULL,
+					     &error);
+	if (priv->proxy == NULL) {
+		ret = FALSE;
+		goto out;
+	}
+	g_signal_connect (priv->proxy,
+			  "g-signal",
+			  G_CALLBACK (cd_bench_signal_cb),
+			  priv);
+	title = g_strdup_printf ("Benchmark %s", sensor_id);
+	g_variant_builder_init (&builder, G_VARIANT_TYPE_ARRAY);
+	g_variant_builder_add (&builder,
+			       "{sv}",
+			       "Quality",
+			       g_variant_new_uint32 (quality_value));
+	g_variant_builder_add (&builder,
+			       "{sv}",
+			       "Whitepoint",
+			       g_variant_new_uint32 (whitepoint));
+	g_variant_builder_add (&builder,
+			       "{sv}",
+			       "Title",
+			       g_variant_new_string (title));
+	g_variant_builder_add (&builder,
+			       "{sv}",
+			       "DeviceKind",
+			       g_variant_new_uint32 (CD_SENSOR_CAP_LCD));
+	g_variant_builder_add (&builder,
+			       "{sv}",
+			       "Gamma",
+			       g_variant_new_double (gamma));
+	priv->started = g_get_monotonic_time ();
+	priv->last_event = priv->started;
+	retvax = g_dbus_proxy_call_sync (priv->proxy,
+					 "Start",
+					 g_variant_new ("(ssa{sv})",
+							device_id,
+							sensor_id,
+							&builder),
+					 G_DBUS_CALL_FLAGS_NONE,
+					 -1,
+					 NULL,
+					 &error);
+	if (retvax == NULL) {
+		ret = FALSE;
+		goto out;
+	}
+	g_main_loop_run (priv->loop);
+
+	/* report patches/sec and the per-phase breakdown */
+	elapsed = (g_get_monotonic_time () - priv->started) / 1e6;
+	g_print ("patches measured:\t%u\n", priv->sample_cnt);
+	g_print ("gamma uploads:\t\t%u\n", priv->gamma_cnt);
+	g_print ("elapsed:\t\t%.2f sec (%.2f patches/sec)\n",
+		 elapsed,
+		 elapsed > 0 ? priv->sample_cnt / elapsed : 0.f);
+	g_print ("display + settle:\t%.2f sec (%.0f%%)\n",
+		 priv->display_us / 1e6,
+		 elapsed > 0 ? priv->display_us / 1e4 / elapsed : 0.f);
+	g_print ("measure:\t\t%.2f sec (%.0f%%)\n",
+		 priv->measure_us / 1e6,
+		 elapsed > 0 ? priv->measure_us / 1e4 / elapsed : 0.f);
+	if (priv->finished_code == 0)
+		retval = EXIT_SUCCESS;
+out:
+	if (!ret)
+		g_print ("Failed to benchmark: %s\n", error->message);
+	g_option_context_free (context);
+	if (priv != NULL) {
+		if (priv->loop != NULL)
+			g_main_loop_unref (priv->loop);
+		if (priv->proxy != NULL)
+			g_object_unref (priv->proxy);
+		g_free (priv);
+	}
+	if (connection != NULL)
+		g_object_unref (connection);
+	if (retvax != NULL)
+		g_variant_unref (retvax);
+	g_free (device_id);
+	g_free (sensor_id);
+	g_free (quality);
+	g_free (title);
+	return retval;
+}
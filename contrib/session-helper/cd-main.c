@@ -21,11 +21,20 @@
 
 #include "config.h"
 
+/* for memfd_create() */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <errno.h>
 #include <gio/gio.h>
+#include <gio/gunixfdlist.h>
 #include <glib/gi18n.h>
 #include <locale.h>
 #include <lcms2.h>
 #include <math.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 #include <colord/colord.h>
 
@@ -45,6 +54,14 @@ typedef struct {
 	guint			 sample_delay;
 	guint			 watcher_id;
 	CdState			*state;
+	gint			 gamma_fd;
+	CdSessionGammaRamp	*gamma_ramp;
+	CdColorRGB		*gamma_last;	/* last uploaded table, or NULL */
+	guint			 gamma_last_len;
+	gint64			 sample_emit_time;
+	guint			 sample_settle;
+	gboolean		 sample_options_pending;
+	GError			*sample_options_error;
 
 	/* for the task */
 	CdSessionInteraction	 interaction_code_last;
@@ -137,10 +154,22 @@ cd_main_calib_idle_delay (guint ms)
 	g_main_loop_unref (loop);
 }
 
-static gboolean
-cd_main_emit_update_sample (CdMainPrivate *priv,
-			    CdColorRGB *color,
-			    GError **error)
+static void
+cd_main_emit_update_sample_options_cb (GObject *source_object,
+				       GAsyncResult *res,
+				       gpointer user_data)
+{
+	CdMainPrivate *priv = (CdMainPrivate *) user_data;
+	cd_sensor_set_options_finish (CD_SENSOR (source_object),
+				      res,
+				      &priv->sample_options_error);
+	priv->sample_options_pending = FALSE;
+}
+
+static void
+cd_main_emit_update_sample_start (CdMainPrivate *priv,
+				  CdColorRGB *color,
+				  guint settle_ms)
 {
 	g_autoptr(GHashTable) hash = NULL;
 
@@ -157,8 +186,11 @@ cd_main_emit_update_sample (CdMainPrivate *priv,
 						      color->G,
 						      color->B),
 				       NULL);
+	priv->sample_emit_time = g_get_monotonic_time ();
+	priv->sample_settle = settle_ms;
 
-	/* if this is the dummy sensor then set the sample RGB value */
+	/* if this is the dummy sensor then set the sample RGB value;
+	 * the D-Bus round trip completes while the panel settles */
 	if (cd_sensor_get_kind (priv->sensor) == CD_SENSOR_KIND_DUMMY) {
 		hash = g_hash_table_new_full (g_str_hash,
 					      g_str_equal,
@@ -173,16 +205,46 @@ cd_main_emit_update_sample (CdMainPrivate *priv,
 		g_hash_table_insert (hash,
 				     g_strdup ("sample[blue]"),
 				     g_variant_take_ref (g_variant_new_double (color->B)));
-		if (!cd_sensor_set_options_sync (priv->sensor,
-						 hash,
-						 priv->cancellable,
-						 error))
-			return FALSE;
+		priv->sample_options_pending = TRUE;
+		cd_sensor_set_options (priv->sensor,
+				       hash,
+				       priv->cancellable,
+				       cd_main_emit_update_sample_options_cb,
+				       priv);
+	}
+}
+
+static gboolean
+cd_main_emit_update_sample_finish (CdMainPrivate *priv,
+				   GError **error)
+{
+	gint64 elapsed_ms;
+
+	/* wait out whatever is left of the settle delay */
+	elapsed_ms = (g_get_monotonic_time () - priv->sample_emit_time) / 1000;
+	if (elapsed_ms < priv->sample_settle)
+		cd_main_calib_idle_delay (priv->sample_settle - elapsed_ms);
+
+	/* the option round trip nearly always beats the settle delay */
+	while (priv->sample_options_pending)
+		g_main_context_iteration (NULL, TRUE);
+	if (priv->sample_options_error != NULL) {
+		g_propagate_error (error, priv->sample_options_error);
+		priv->sample_options_error = NULL;
+		return FALSE;
 	}
-	cd_main_calib_idle_delay (priv->sample_delay);
 	return TRUE;
 }
 
+static gboolean
+cd_main_emit_update_sample (CdMainPrivate *priv,
+			    CdColorRGB *color,
+			    GError **error)
+{
+	cd_main_emit_update_sample_start (priv, color, priv->sample_delay);
+	return cd_main_emit_update_sample_finish (priv, error);
+}
+
 static const gchar *
 cd_main_get_display_ti1 (CdProfileQuality quality)
 {
@@ -247,19 +309,131 @@ cd_main_emit_interaction_required (CdMainPrivate *priv,
 				       NULL);
 }
 
+static gboolean
+cd_main_gamma_fd_setup (CdMainPrivate *priv, GError **error)
+{
+	/* already set up by a previous call */
+	if (priv->gamma_ramp != NULL)
+		return TRUE;
+
+	/* create the backing memory and map it */
+	priv->gamma_fd = memfd_create ("colord-session-gamma", MFD_CLOEXEC);
+	if (priv->gamma_fd < 0) {
+		g_set_error (error,
+			     CD_SESSION_ERROR,
+			     CD_SESSION_ERROR_INTERNAL,
+			     "failed to create memfd: %s",
+			     g_strerror (errno));
+		return FALSE;
+	}
+	if (ftruncate (priv->gamma_fd, sizeof (CdSessionGammaRamp)) < 0) {
+		g_set_error (error,
+			     CD_SESSION_ERROR,
+			     CD_SESSION_ERROR_INTERNAL,
+			     "failed to size memfd: %s",
+			     g_strerror (errno));
+		return FALSE;
+	}
+	priv->gamma_ramp = mmap (NULL, sizeof (CdSessionGammaRamp),
+				 PROT_READ | PROT_WRITE, MAP_SHARED,
+				 priv->gamma_fd, 0);
+	if (priv->gamma_ramp == MAP_FAILED) {
+		priv->gamma_ramp = NULL;
+		g_set_error (error,
+			     CD_SESSION_ERROR,
+			     CD_SESSION_ERROR_INTERNAL,
+			     "failed to map memfd: %s",
+			     g_strerror (errno));
+		return FALSE;
+	}
+
+	/* the mapping starts out zeroed, so the next update must write the
+	 * whole table rather than just the entries that differ from the
+	 * last signal-based upload */
+	g_free (priv->gamma_last);
+	priv->gamma_last = NULL;
+	return TRUE;
+}
+
 static void
 cd_main_emit_update_gamma (CdMainPrivate *priv,
 			   GPtrArray *array)
 {
 	GVariantBuilder builder;
+	guint changed_first = 0;
+	guint changed_last;
 	guint i;
 	CdColorRGB *color;
 
+	/* diff against the last uploaded table; an interactive adjustment
+	 * step usually only moves a handful of entries, and an unchanged
+	 * table would otherwise still cost an upload and a settle delay */
+	if (priv->gamma_last != NULL && priv->gamma_last_len == array->len) {
+		changed_first = G_MAXUINT;
+		changed_last = 0;
+		for (i = 0; i < array->len; i++) {
+			color = g_ptr_array_index (array, i);
+			if (color->R == priv->gamma_last[i].R &&
+			    color->G == priv->gamma_last[i].G &&
+			    color->B == priv->gamma_last[i].B)
+				continue;
+			if (changed_first == G_MAXUINT)
+				changed_first = i;
+			changed_last = i;
+		}
+		if (changed_first == G_MAXUINT) {
+			g_debug ("CdMain: gamma table unchanged, "
+				 "skipping update");
+			return;
+		}
+	} else {
+		g_free (priv->gamma_last);
+		priv->gamma_last = g_new (CdColorRGB, array->len);
+		priv->gamma_last_len = array->len;
+		changed_last = array->len - 1;
+	}
+
+	/* a controller has mapped the shared ramp, so update it in place
+	 * and just emit the sequence number */
+	if (priv->gamma_ramp != NULL &&
+	    array->len <= CD_SESSION_GAMMA_RAMP_MAX_SIZE) {
+		CdSessionGammaRamp *ramp = priv->gamma_ramp;
+		guint32 sequence = ramp->sequence;
+
+		g_debug ("CdMain: Emitting UpdateGammaFd(%u elements, "
+			 "%u..%u dirty)",
+			 array->len, changed_first, changed_last);
+
+		/* odd marks the ramp as being rewritten; only the span that
+		 * actually changed has to be copied out */
+		g_atomic_int_set (&ramp->sequence, sequence + 1);
+		ramp->size = array->len;
+		for (i = changed_first; i <= changed_last; i++) {
+			color = g_ptr_array_index (array, i);
+			ramp->ramp[i * 3 + 0] = color->R;
+			ramp->ramp[i * 3 + 1] = color->G;
+			ramp->ramp[i * 3 + 2] = color->B;
+			cd_color_rgb_copy (color, &priv->gamma_last[i]);
+		}
+		g_atomic_int_set (&ramp->sequence, sequence + 2);
+		g_dbus_connection_emit_signal (priv->connection,
+					       NULL,
+					       CD_SESSION_DBUS_PATH,
+					       CD_SESSION_DBUS_INTERFACE_DISPLAY,
+					       "UpdateGammaFd",
+					       g_variant_new ("(u)",
+							      sequence + 2),
+					       NULL);
+		cd_main_calib_idle_delay (200);
+		return;
+	}
+
 	/* emit signal */
 	g_debug ("CdMain: Emitting UpdateGamma(%u elements)",
 		 array->len);
 
-	/* build the dict */
+	/* build the dict; the signal always carries the whole table as the
+	 * interface has no partial-update form */
 	g_variant_builder_init (&builder, G_VARIANT_TYPE_ARRAY);
 	for (i = 0; i < array->len; i++) {
 		color = g_ptr_array_index (array, i);
@@ -268,6 +442,7 @@ cd_main_emit_update_gamma (CdMainPrivate *priv,
 				       color->R,
 				       color->G,
 				       color->B);
+		cd_color_rgb_copy (color, &priv->gamma_last[i]);
 	}
 	g_dbus_connection_emit_signal (priv->connection,
 				       NULL,
@@ -337,6 +512,34 @@ cd_main_calib_get_sample (CdMainPrivate *priv,
 	return TRUE;
 }
 
+static gboolean
+cd_main_calib_get_sample_stable (CdMainPrivate *priv,
+				 CdColorXYZ *xyz,
+				 GError **error)
+{
+	CdColorXYZ xyz_last;
+	guint i;
+
+	/* take back-to-back readings until they agree; used when the
+	 * settle wait was shortened, so that a panel still in transition
+	 * cannot contaminate the ti3 data */
+	if (!cd_main_calib_get_sample (priv, &xyz_last, error))
+		return FALSE;
+	for (i = 0; i < 3; i++) {
+		if (!cd_main_calib_get_sample (priv, xyz, error))
+			return FALSE;
+		if (fabs (xyz->Y - xyz_last.Y) <= xyz->Y * 0.01 + 0.01)
+			return TRUE;
+		g_debug ("sample not yet stable, Y %f -> %f",
+			 xyz_last.Y, xyz->Y);
+		cd_color_xyz_copy (xyz, &xyz_last);
+		cd_main_calib_idle_delay (priv->sample_delay / 2);
+	}
+
+	/* not converging; take the last reading rather than stalling */
+	return TRUE;
+}
+
 static gboolean
 cd_main_calib_get_native_whitepoint (CdMainPrivate *priv,
 				     gdouble *temp,
@@ -800,25 +1003,6 @@ cd_main_finished_quit_cb (gpointer user_data)
 	return G_SOURCE_REMOVE;
 }
 
-static gboolean
-cd_main_load_samples (CdMainPrivate *priv, GError **error)
-{
-	const gchar *filename;
-	g_autofree gchar *path = NULL;
-	g_autoptr(GFile) file = NULL;
-
-	filename = cd_main_get_display_ti1 (priv->quality);
-	path = g_build_filename (DATADIR,
-				 "colord",
-				 "ti1",
-				 filename,
-				 NULL);
-	g_debug ("opening source file %s", path);
-	file = g_file_new_for_path (path);
-	priv->it8_ti1 = cd_it8_new ();
-	return cd_it8_load_from_file (priv->it8_ti1, file, error);
-}
-
 static gboolean
 cd_main_write_colprof_files (CdMainPrivate *priv, GError **error)
 {
@@ -1083,32 +1267,185 @@ cd_main_generate_profile (CdMainPrivate *priv, GError **error)
 	return TRUE;
 }
 
+typedef struct {
+	guint			 idx;
+	gdouble			 luminance;
+} CdMainPatchOrder;
+
+static gint
+cd_main_patch_order_sort_cb (gconstpointer a,
+			     gconstpointer b,
+			     gpointer user_data)
+{
+	const CdMainPatchOrder *item_a = (const CdMainPatchOrder *) a;
+	const CdMainPatchOrder *item_b = (const CdMainPatchOrder *) b;
+	if (item_a->luminance < item_b->luminance)
+		return -1;
+	if (item_a->luminance > item_b->luminance)
+		return 1;
+	return 0;
+}
+
+static gdouble
+cd_main_get_patch_luminance (const CdColorRGB *rgb)
+{
+	/* Rec. 709 weights; only used to rank transitions so the usual
+	 * gamma nonlinearity does not matter here */
+	return 0.2126 * rgb->R + 0.7152 * rgb->G + 0.0722 * rgb->B;
+}
+
+/* the patch sets are identical for every display calibrated at the
+ * same quality, so each .ti1 is parsed and its luminance ordering
+ * pre-generated only once per helper process */
+typedef struct {
+	CdIt8			*it8;
+	CdMainPatchOrder	*order;
+	guint			 size;
+} CdMainSamplesCacheItem;
+
+static GHashTable *cd_main_samples_cache = NULL;	/* of filename:CdMainSamplesCacheItem */
+
+static CdMainSamplesCacheItem *
+cd_main_samples_cache_get (CdProfileQuality quality, GError **error)
+{
+	CdColorRGB rgb;
+	CdMainSamplesCacheItem *item;
+	const gchar *filename;
+	guint i;
+	g_autofree gchar *path = NULL;
+	g_autoptr(CdIt8) it8 = NULL;
+	g_autoptr(GFile) file = NULL;
+
+	/* the keys are static strings */
+	if (cd_main_samples_cache == NULL) {
+		cd_main_samples_cache = g_hash_table_new (g_str_hash,
+							  g_str_equal);
+	}
+	filename = cd_main_get_display_ti1 (quality);
+	item = g_hash_table_lookup (cd_main_samples_cache, filename);
+	if (item != NULL)
+		return item;
+
+	/* parse the patch target */
+	path = g_build_filename (DATADIR,
+				 "colord",
+				 "ti1",
+				 filename,
+				 NULL);
+	g_debug ("opening source file %s", path);
+	file = g_file_new_for_path (path);
+	it8 = cd_it8_new ();
+	if (!cd_it8_load_from_file (it8, file, error))
+		return NULL;
+
+	/* pre-generate the luminance patch order */
+	item = g_new0 (CdMainSamplesCacheItem, 1);
+	item->it8 = g_object_ref (it8);
+	item->size = cd_it8_get_data_size (it8);
+	item->order = g_new0 (CdMainPatchOrder, item->size);
+	for (i = 0; i < item->size; i++) {
+		item->order[i].idx = i;
+		cd_it8_get_data_item (it8, i, &rgb, NULL);
+		item->order[i].luminance = cd_main_get_patch_luminance (&rgb);
+	}
+	g_qsort_with_data (item->order,
+			   item->size,
+			   sizeof (CdMainPatchOrder),
+			   cd_main_patch_order_sort_cb,
+			   NULL);
+	g_hash_table_insert (cd_main_samples_cache, (gpointer) filename, item);
+	return item;
+}
+
+static gboolean
+cd_main_load_samples (CdMainPrivate *priv, GError **error)
+{
+	CdMainSamplesCacheItem *item;
+
+	item = cd_main_samples_cache_get (priv->quality, error);
+	if (item == NULL)
+		return FALSE;
+	priv->it8_ti1 = g_object_ref (item->it8);
+	return TRUE;
+}
+
 static gboolean
 cd_main_display_get_samples (CdMainPrivate *priv,
 			     CdState *state,
 			     GError **error)
 {
 	CdColorRGB rgb;
+	CdColorRGB rgb_next;
 	CdColorXYZ xyz;
+	CdMainPatchOrder *order;
+	CdMainSamplesCacheItem *item;
+	gboolean settle_cut = FALSE;
+	gboolean settle_cut_next = FALSE;
+	gdouble delta;
 	guint i;
+	guint settle_ms;
 	guint size;
 
 	size = cd_it8_get_data_size (priv->it8_ti1);
 	cd_state_set_number_steps (state, size);
+	if (size == 0)
+		return TRUE;
+
+	/* walk the patches in luminance order: the panel then only ever
+	 * makes small brightness transitions, which settle much faster
+	 * than the full-scale jumps of the authored patch ordering */
+	item = cd_main_samples_cache_get (priv->quality, error);
+	if (item == NULL)
+		return FALSE;
+	order = item->order;
+
+	/* show the first patch and let the panel settle fully */
+	cd_it8_get_data_item (priv->it8_ti1, order[0].idx, &rgb, NULL);
+	if (!cd_main_emit_update_sample (priv, &rgb, error))
+		return FALSE;
 	for (i = 0; i < size; i++) {
-		cd_it8_get_data_item (priv->it8_ti1,
-				      i,
-				      &rgb,
-				      NULL);
-		if (!cd_main_emit_update_sample (priv, &rgb, error))
-			return FALSE;
-		if (!cd_main_calib_get_sample (priv, &xyz, error))
-			return FALSE;
+		if (settle_cut) {
+			if (!cd_main_calib_get_sample_stable (priv, &xyz, error))
+				return FALSE;
+		} else {
+			if (!cd_main_calib_get_sample (priv, &xyz, error))
+				return FALSE;
+		}
+
+		/* put the next patch on screen as soon as the reading for
+		 * this one is in hand; the ti3 bookkeeping and progress
+		 * signalling below then run inside the next patch's settle
+		 * window instead of adding to it.
+		 *
+		 * the settle wait is scaled by the size of the luminance
+		 * transition, and any shortened wait is backed up by a
+		 * stability check on the following read */
+		if (i + 1 < size) {
+			cd_it8_get_data_item (priv->it8_ti1,
+					      order[i + 1].idx,
+					      &rgb_next,
+					      NULL);
+			delta = fabs (order[i + 1].luminance -
+				      order[i].luminance);
+			settle_ms = priv->sample_delay * (0.25 + 0.75 * delta);
+			settle_cut_next = settle_ms < priv->sample_delay;
+			cd_main_emit_update_sample_start (priv,
+							  &rgb_next,
+							  settle_ms);
+		}
 		cd_it8_add_data (priv->it8_ti3, &rgb, &xyz);
 
 		/* done */
 		if (!cd_state_done (state, error))
 			return FALSE;
+
+		/* wait out the rest of the settle delay */
+		if (i + 1 < size) {
+			if (!cd_main_emit_update_sample_finish (priv, error))
+				return FALSE;
+			rgb = rgb_next;
+			settle_cut = settle_cut_next;
+		}
 	}
 	return TRUE;
 }
@@ -1669,6 +2006,31 @@ cd_main_daemon_method_call (GDBusConnection *connection,
 		return;
 	}
 
+	if (g_strcmp0 (method_name, "GetGammaFd") == 0) {
+		gint fd_idx;
+		g_autoptr(GUnixFDList) fd_list = NULL;
+
+		g_debug ("CdMain: %s:GetGammaFd()", sender);
+		if (!cd_main_gamma_fd_setup (priv, &error)) {
+			g_dbus_method_invocation_return_gerror (invocation,
+								error);
+			return;
+		}
+		fd_list = g_unix_fd_list_new ();
+		fd_idx = g_unix_fd_list_append (fd_list, priv->gamma_fd, &error);
+		if (fd_idx < 0) {
+			g_dbus_method_invocation_return_gerror (invocation,
+								error);
+			return;
+		}
+		g_dbus_method_invocation_return_value_with_unix_fd_list (invocation,
+									 g_variant_new ("(hu)",
+											fd_idx,
+											CD_SESSION_GAMMA_RAMP_MAX_SIZE),
+									 fd_list);
+		return;
+	}
+
 	if (g_strcmp0 (method_name, "Cancel") == 0) {
 		g_debug ("CdMain: %s:Cancel()", sender);
 		if (priv->status != CD_SESSION_STATUS_RUNNING &&
@@ -1861,6 +2223,7 @@ main (int argc, char *argv[])
 	setlocale (LC_ALL, "");
 
 	priv = g_new0 (CdMainPrivate, 1);
+	priv->gamma_fd = -1;
 	priv->gamma_scale_factor = 10.0f;
 	priv->status = CD_SESSION_STATUS_IDLE;
 	priv->interaction_code_last = CD_SESSION_INTERACTION_NONE;
@@ -1869,9 +2232,11 @@ main (int argc, char *argv[])
 	priv->settings = g_settings_new ("org.freedesktop.ColorHelper");
 	priv->sample_delay = g_settings_get_int (priv->settings, "sample-delay");
 
-	/* track progress of the calibration */
+	/* track progress of the calibration; fast patch runs generate
+	 * hundreds of updates per second, so coalesce to ~30Hz */
 	priv->state = cd_state_new ();
 	cd_state_set_enable_profile (priv->state, TRUE);
+	cd_state_set_emit_interval (priv->state, 33);
 	g_signal_connect (priv->state,
 			  "percentage-changed",
 			  G_CALLBACK (cd_main_percentage_changed_cb),
@@ -1958,6 +2323,13 @@ out:
 		g_object_unref (priv->it8_ti3);
 	if (priv->state != NULL)
 		g_object_unref (priv->state);
+	if (priv->gamma_ramp != NULL)
+		munmap (priv->gamma_ramp, sizeof (CdSessionGammaRamp));
+	if (priv->gamma_fd >= 0)
+		close (priv->gamma_fd);
+	g_free (priv->gamma_last);
+	if (priv->sample_options_error != NULL)
+		g_error_free (priv->sample_options_error);
 	g_free (priv->working_path);
 	g_free (priv->basename);
 	g_free (priv->title);
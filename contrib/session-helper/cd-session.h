@@ -31,6 +31,25 @@ G_BEGIN_DECLS
 #define CD_SESSION_DBUS_INTERFACE		"org.freedesktop.ColorHelper"
 #define CD_SESSION_DBUS_INTERFACE_DISPLAY	"org.freedesktop.ColorHelper.Display"
 
+#define CD_SESSION_GAMMA_RAMP_MAX_SIZE		256
+
+/**
+ * CdSessionGammaRamp:
+ *
+ * The layout of the shared memory returned by GetGammaFd, which clients
+ * should map read-only.
+ * The helper bumps @sequence to an odd value before rewriting the ramp
+ * and to an even value when the update is complete, so a reader that
+ * sees an odd value, or a different value after reading the data, has
+ * to read again.
+ * The ramp is stored as @size interleaved red,green,blue triples.
+ **/
+typedef struct {
+	guint32		 sequence;
+	guint32		 size;
+	gdouble		 ramp[CD_SESSION_GAMMA_RAMP_MAX_SIZE * 3];
+} CdSessionGammaRamp;
+
 /**
  * CdSessionStatus:
  *
@@ -47,6 +47,10 @@ struct _CdStatePrivate
 	gulong			 subpercentage_child_id;
 	CdState			*child;
 	CdState			*parent;
+	guint			 emit_interval_ms;
+	gint64			 emit_last_ts[2];	/* monotonic µs */
+	guint			 emit_pending_id[2];
+	guint			 emit_pending_value[2];
 };
 
 enum {
@@ -83,6 +87,81 @@ cd_state_set_enable_profile (CdState *state, gboolean enable_profile)
 	state->priv->enable_profile = enable_profile;
 }
 
+void
+cd_state_set_emit_interval (CdState *state, guint interval_ms)
+{
+	g_return_if_fail (CD_IS_STATE (state));
+	state->priv->emit_interval_ms = interval_ms;
+}
+
+static void
+cd_state_emit_now (CdState *state, guint signal_id, guint value)
+{
+	state->priv->emit_last_ts[signal_id] = g_get_monotonic_time ();
+	g_signal_emit (state, signals [signal_id], 0, value);
+}
+
+static gboolean
+cd_state_emit_percentage_pending_cb (gpointer user_data)
+{
+	CdState *state = CD_STATE (user_data);
+	state->priv->emit_pending_id[SIGNAL_PERCENTAGE_CHANGED] = 0;
+	cd_state_emit_now (state, SIGNAL_PERCENTAGE_CHANGED,
+			   state->priv->emit_pending_value[SIGNAL_PERCENTAGE_CHANGED]);
+	return G_SOURCE_REMOVE;
+}
+
+static gboolean
+cd_state_emit_subpercentage_pending_cb (gpointer user_data)
+{
+	CdState *state = CD_STATE (user_data);
+	state->priv->emit_pending_id[SIGNAL_SUBPERCENTAGE_CHANGED] = 0;
+	cd_state_emit_now (state, SIGNAL_SUBPERCENTAGE_CHANGED,
+			   state->priv->emit_pending_value[SIGNAL_SUBPERCENTAGE_CHANGED]);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+cd_state_emit_rate_limited (CdState *state, guint signal_id, guint value)
+{
+	gint64 interval_us;
+	gint64 now;
+
+	/* no cadence set, or an endpoint which always goes out now */
+	if (state->priv->emit_interval_ms == 0 ||
+	    value == 0 || value >= 100) {
+		if (state->priv->emit_pending_id[signal_id] != 0) {
+			g_source_remove (state->priv->emit_pending_id[signal_id]);
+			state->priv->emit_pending_id[signal_id] = 0;
+		}
+		cd_state_emit_now (state, signal_id, value);
+		return;
+	}
+
+	/* an emission is already scheduled; values only ever go up, so
+	 * just coalesce to the newest one */
+	state->priv->emit_pending_value[signal_id] = value;
+	if (state->priv->emit_pending_id[signal_id] != 0)
+		return;
+
+	/* inside the cadence window, defer to the boundary */
+	now = g_get_monotonic_time ();
+	interval_us = (gint64) state->priv->emit_interval_ms * 1000;
+	if (now - state->priv->emit_last_ts[signal_id] < interval_us) {
+		guint timeout_ms;
+		timeout_ms = (guint) ((interval_us -
+				       (now - state->priv->emit_last_ts[signal_id])) / 1000) + 1;
+		state->priv->emit_pending_id[signal_id] =
+			g_timeout_add (timeout_ms,
+				       signal_id == SIGNAL_PERCENTAGE_CHANGED ?
+						cd_state_emit_percentage_pending_cb :
+						cd_state_emit_subpercentage_pending_cb,
+				       state);
+		return;
+	}
+	cd_state_emit_now (state, signal_id, value);
+}
+
 static gfloat
 cd_state_discrete_to_percent (guint discrete, guint steps)
 {
@@ -138,7 +217,7 @@ cd_state_set_percentage (CdState *state, guint percentage)
 		return FALSE;
 
 	/* emit */
-	g_signal_emit (state, signals [SIGNAL_PERCENTAGE_CHANGED], 0, percentage);
+	cd_state_emit_rate_limited (state, SIGNAL_PERCENTAGE_CHANGED, percentage);
 	return TRUE;
 }
 
@@ -156,7 +235,7 @@ cd_state_set_subpercentage (CdState *state, guint percentage)
 		return TRUE;
 
 	/* just emit */
-	g_signal_emit (state, signals [SIGNAL_SUBPERCENTAGE_CHANGED], 0, percentage);
+	cd_state_emit_rate_limited (state, SIGNAL_SUBPERCENTAGE_CHANGED, percentage);
 	return TRUE;
 }
 
@@ -240,6 +319,16 @@ cd_state_reset (CdState *state)
 	state->priv->current = 0;
 	state->priv->last_percentage = 0;
 
+	/* a stale deferred emission must not fire after the reset */
+	if (state->priv->emit_pending_id[SIGNAL_PERCENTAGE_CHANGED] != 0) {
+		g_source_remove (state->priv->emit_pending_id[SIGNAL_PERCENTAGE_CHANGED]);
+		state->priv->emit_pending_id[SIGNAL_PERCENTAGE_CHANGED] = 0;
+	}
+	if (state->priv->emit_pending_id[SIGNAL_SUBPERCENTAGE_CHANGED] != 0) {
+		g_source_remove (state->priv->emit_pending_id[SIGNAL_SUBPERCENTAGE_CHANGED]);
+		state->priv->emit_pending_id[SIGNAL_SUBPERCENTAGE_CHANGED] = 0;
+	}
+
 	/* only use the timer if profiling; it's expensive */
 	if (state->priv->enable_profile)
 		g_timer_start (state->priv->timer);
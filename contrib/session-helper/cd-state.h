@@ -92,6 +92,8 @@ gboolean	 cd_state_finished_real			(CdState		*state,
 							 G_GNUC_WARN_UNUSED_RESULT;
 void		 cd_state_set_enable_profile		(CdState		*state,
 							 gboolean		 enable_profile);
+void		 cd_state_set_emit_interval		(CdState		*state,
+							 guint			 interval_ms);
 
 G_END_DECLS
 
@@ -1,4 +1,4 @@
-/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
  *
  * Copyright (C) 2013 Richard Hughes <richard@hughsie.com>
  *
@@ -19,49 +19,30 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
-//g++ -o cd-libcolord++ cd-libcolord++.cpp `pkg-config --cflags --libs colord` -Wall
+//g++ -std=c++17 -o cd-libcolord++ cd-libcolord++.cpp `pkg-config --cflags --libs colord` -Wall
 
-#include <colord.h>
+#include <colord.hpp>
 #include <iostream>
-using namespace std;
 
 int
 main (int argc, char *argv[])
 {
-	CdIcc *icc = NULL;
-	gboolean ret;
-	GError *error = NULL;
-	GFile *file = NULL;
-	gint retval = 1;
-
 	if (argc != 2) {
 		g_warning ("usage: cd-libcolord++ filename, e.g. /usr/share/color/icc/colord/sRGB.icc");
-		goto out;
+		return 1;
 	}
 
-	icc = cd_icc_new ();
-	file = g_file_new_for_path (argv[1]);
-	ret = cd_icc_load_file (icc,
-				file,
-				CD_ICC_LOAD_FLAGS_METADATA,
-				NULL, /* GCancellable */
-				&error);
-	if (!ret) {
-		cerr << "failed to parse " << argv[1] << error->message << endl;
-		g_error_free (error);
-		goto out;
+	colord::Error error;
+	colord::Icc icc;
+	if (!icc.load_file (argv[1], CD_ICC_LOAD_FLAGS_METADATA, error)) {
+		std::cerr << "failed to parse " << argv[1] << ": "
+			  << error.message () << std::endl;
+		return 1;
 	}
 
 	/* get details about the profile */
-	cout << "Filename:\t" << cd_icc_get_filename (icc) << endl;
-	cout << "License:\t" << cd_icc_get_metadata_item (icc, "License") << endl;
-	cout << "LCMS hProfile:\t" << cd_icc_get_handle (icc) << endl;
-
-	retval = 0;
-out:
-	if (file != NULL)
-		g_object_unref (file);
-	if (icc != NULL)
-		g_object_unref (icc);
-	return retval;
+	std::cout << "Filename:\t" << icc.filename () << std::endl;
+	std::cout << "License:\t" << icc.metadata_item ("License") << std::endl;
+	std::cout << "LCMS hProfile:\t" << icc.handle () << std::endl;
+	return 0;
 }
@@ -0,0 +1,251 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2026 Richard Hughes <richard@hughsie.com>
+ *
+ * Licensed under the GNU Lesser General Public License Version 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+/* benchmark for the daemon object paths; drives a running colord
+ * instance through scripted CreateDevice/CreateProfile/Find workloads
+ * and reports throughput and tail latency, so regressions in the
+ * arrays, databases and D-Bus dispatch are caught quantitatively.
+ * Everything is created with temporary scope, so a killed benchmark
+ * leaves no state behind in the daemon */
+
+#include "config.h"
+
+#include <stdlib.h>
+
+#include "cd-client.h"
+#include "cd-client-sync.h"
+#include "cd-device.h"
+#include "cd-device-sync.h"
+#include "cd-profile.h"
+#include "cd-profile-sync.h"
+
+static gint bench_devices = 200;
+static gint bench_profiles = 200;
+static gint bench_lookups = 1000;
+static gint bench_clients = 4;
+
+static gint
+cd_bench_compare_double (gconstpointer a, gconstpointer b)
+{
+	gdouble tmp = *((const gdouble *) a) - *((const gdouble *) b);
+	if (tmp < 0.f)
+		return -1;
+	if (tmp > 0.f)
+		return 1;
+	return 0;
+}
+
+static void
+cd_bench_report (const gchar *name, GArray *samples)
+{
+	gdouble total = 0.f;
+	guint i;
+
+	for (i = 0; i < samples->len; i++)
+		total += g_array_index (samples, gdouble, i);
+	g_array_sort (samples, cd_bench_compare_double);
+	g_print ("%-18s %6u ops %10.0f ops/sec  p99 %8.3f ms\n",
+		 name,
+		 samples->len,
+		 samples->len / total,
+		 g_array_index (samples, gdouble,
+				(samples->len * 99) / 100) * 1000.f);
+	g_array_set_size (samples, 0);
+}
+
+static gchar *
+cd_bench_device_id (guint i)
+{
+	return g_strdup_printf ("bench-device-%u", i);
+}
+
+static gchar *
+cd_bench_profile_id (guint i)
+{
+	return g_strdup_printf ("bench-profile-%u", i);
+}
+
+int
+main (int argc, char **argv)
+{
+	guint i;
+	g_autoptr(GArray) samples = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GHashTable) device_props = NULL;
+	g_autoptr(GOptionContext) context = NULL;
+	g_autoptr(GPtrArray) clients = NULL;
+	g_autoptr(GPtrArray) devices = NULL;
+	g_autoptr(GPtrArray) profiles = NULL;
+	g_autoptr(GTimer) timer = NULL;
+	const GOptionEntry options[] = {
+		{ "devices", 'd', 0, G_OPTION_ARG_INT, &bench_devices,
+		  "Number of temporary devices to create", NULL },
+		{ "profiles", 'p', 0, G_OPTION_ARG_INT, &bench_profiles,
+		  "Number of temporary profiles to create", NULL },
+		{ "lookups", 'l', 0, G_OPTION_ARG_INT, &bench_lookups,
+		  "Number of FindDeviceById and GetDevices calls", NULL },
+		{ "clients", 'c', 0, G_OPTION_ARG_INT, &bench_clients,
+		  "Number of client connections to spread lookups across", NULL },
+		{ NULL }
+	};
+
+	context = g_option_context_new ("- colord daemon benchmark");
+	g_option_context_add_main_entries (context, options, NULL);
+	if (!g_option_context_parse (context, &argc, &argv, &error)) {
+		g_printerr ("failed to parse arguments: %s\n", error->message);
+		return EXIT_FAILURE;
+	}
+
+	/* one connection per simulated client */
+	clients = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
+	for (i = 0; i < (guint) bench_clients; i++) {
+		CdClient *client = cd_client_new ();
+		if (!cd_client_get_has_server (client)) {
+			g_printerr ("no running colord instance to benchmark\n");
+			g_object_unref (client);
+			return EXIT_FAILURE;
+		}
+		if (!cd_client_connect_sync (client, NULL, &error)) {
+			g_printerr ("failed to connect: %s\n", error->message);
+			g_object_unref (client);
+			return EXIT_FAILURE;
+		}
+		g_ptr_array_add (clients, client);
+	}
+
+	samples = g_array_new (FALSE, FALSE, sizeof (gdouble));
+	timer = g_timer_new ();
+	devices = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
+	profiles = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
+	device_props = g_hash_table_new_full (g_str_hash, g_str_equal,
+					      g_free, g_free);
+	g_hash_table_insert (device_props,
+			     g_strdup (CD_DEVICE_PROPERTY_KIND),
+			     g_strdup ("display"));
+
+	/* device registration */
+	for (i = 0; i < (guint) bench_devices; i++) {
+		CdDevice *device;
+		gdouble elapsed;
+		g_autofree gchar *id = cd_bench_device_id (i);
+		g_timer_reset (timer);
+		device = cd_client_create_device_sync (g_ptr_array_index (clients, 0),
+						       id,
+						       CD_OBJECT_SCOPE_TEMP,
+						       device_props,
+						       NULL,
+						       &error);
+		elapsed = g_timer_elapsed (timer, NULL);
+		if (device == NULL) {
+			g_printerr ("failed to create device: %s\n", error->message);
+			return EXIT_FAILURE;
+		}
+		g_ptr_array_add (devices, device);
+		g_array_append_val (samples, elapsed);
+	}
+	cd_bench_report ("CreateDevice", samples);
+
+	/* profile registration */
+	for (i = 0; i < (guint) bench_profiles; i++) {
+		CdProfile *profile;
+		gdouble elapsed;
+		g_autofree gchar *id = cd_bench_profile_id (i);
+		g_timer_reset (timer);
+		profile = cd_client_create_profile_sync (g_ptr_array_index (clients, 0),
+							 id,
+							 CD_OBJECT_SCOPE_TEMP,
+							 NULL,
+							 NULL,
+							 &error);
+		elapsed = g_timer_elapsed (timer, NULL);
+		if (profile == NULL) {
+			g_printerr ("failed to create profile: %s\n", error->message);
+			return EXIT_FAILURE;
+		}
+		g_ptr_array_add (profiles, profile);
+		g_array_append_val (samples, elapsed);
+	}
+	cd_bench_report ("CreateProfile", samples);
+
+	/* lookup by ID, spread over all the client connections */
+	for (i = 0; i < (guint) bench_lookups; i++) {
+		CdClient *client = g_ptr_array_index (clients, i % clients->len);
+		gdouble elapsed;
+		g_autofree gchar *id = cd_bench_device_id (i % bench_devices);
+		g_autoptr(CdDevice) device = NULL;
+		g_timer_reset (timer);
+		device = cd_client_find_device_sync (client, id, NULL, &error);
+		elapsed = g_timer_elapsed (timer, NULL);
+		if (device == NULL) {
+			g_printerr ("failed to find device: %s\n", error->message);
+			return EXIT_FAILURE;
+		}
+		g_array_append_val (samples, elapsed);
+	}
+	cd_bench_report ("FindDeviceById", samples);
+
+	/* full enumeration */
+	for (i = 0; i < (guint) bench_lookups; i++) {
+		CdClient *client = g_ptr_array_index (clients, i % clients->len);
+		gdouble elapsed;
+		g_autoptr(GPtrArray) array = NULL;
+		g_timer_reset (timer);
+		array = cd_client_get_devices_sync (client, NULL, &error);
+		elapsed = g_timer_elapsed (timer, NULL);
+		if (array == NULL) {
+			g_printerr ("failed to get devices: %s\n", error->message);
+			return EXIT_FAILURE;
+		}
+		g_array_append_val (samples, elapsed);
+	}
+	cd_bench_report ("GetDevices", samples);
+
+	/* teardown, which also exercises the remove paths */
+	for (i = 0; i < profiles->len; i++) {
+		gdouble elapsed;
+		g_timer_reset (timer);
+		if (!cd_client_delete_profile_sync (g_ptr_array_index (clients, 0),
+						    g_ptr_array_index (profiles, i),
+						    NULL,
+						    &error)) {
+			g_printerr ("failed to delete profile: %s\n", error->message);
+			return EXIT_FAILURE;
+		}
+		elapsed = g_timer_elapsed (timer, NULL);
+		g_array_append_val (samples, elapsed);
+	}
+	cd_bench_report ("DeleteProfile", samples);
+	for (i = 0; i < devices->len; i++) {
+		gdouble elapsed;
+		g_timer_reset (timer);
+		if (!cd_client_delete_device_sync (g_ptr_array_index (clients, 0),
+						   g_ptr_array_index (devices, i),
+						   NULL,
+						   &error)) {
+			g_printerr ("failed to delete device: %s\n", error->message);
+			return EXIT_FAILURE;
+		}
+		elapsed = g_timer_elapsed (timer, NULL);
+		g_array_append_val (samples, elapsed);
+	}
+	cd_bench_report ("DeleteDevice", samples);
+	return EXIT_SUCCESS;
+}
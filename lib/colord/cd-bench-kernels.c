@@ -0,0 +1,412 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2026 Richard Hughes <richard@hughsie.com>
+ *
+ * Licensed under the GNU Lesser General Public License Version 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+/* microbenchmarks for the math, spectral, color and interpolation
+ * kernels; this is not run as part of the test suite as absolute
+ * numbers are only meaningful when compared on the same hardware.
+ *
+ * With --json each result is printed as one JSON object per line so
+ * runs can be diffed or graphed over time.
+ */
+
+#include "config.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "cd-color.h"
+#include "cd-interp-akima.h"
+#include "cd-interp-linear.h"
+#include "cd-interp.h"
+#include "cd-math.h"
+#include "cd-spectrum.h"
+
+static const guint bench_array_sizes[] = { 256, 4096, 65536, 0 };
+
+static gint bench_repeats = 5;
+static gboolean bench_json = FALSE;
+
+/* each timed pass runs the kernel this many times so that even the
+ * cheapest operations take long enough for the timer to resolve */
+#define CD_BENCH_INNER_LOOPS		64
+
+static void
+cd_bench_kernels_report (const gchar *name,
+			 guint size,
+			 gdouble mean,
+			 gdouble m2)
+{
+	gdouble stddev = bench_repeats > 1 ?
+				sqrt (m2 / (bench_repeats - 1)) : 0.f;
+	if (bench_json) {
+		g_print ("{\"name\":\"%s\",\"size\":%u,"
+			 "\"mean\":%.3f,\"stddev\":%.3f,"
+			 "\"units\":\"Mops/s\"}\n",
+			 name, size, mean, stddev);
+	} else {
+		g_print ("%-28s size=%-6u : %10.1f ± %.1f Mops/s\n",
+			 name, size, mean, stddev);
+	}
+}
+
+/* run @cb over @size items per inner loop and report the Welford
+ * running mean and variance over the repeats */
+static void
+cd_bench_kernels_run (const gchar *name,
+		      guint size,
+		      void (*cb) (guint size, gpointer user_data),
+		      gpointer user_data)
+{
+	gdouble mean = 0.f;
+	gdouble m2 = 0.f;
+	gdouble mops = (gdouble) size * CD_BENCH_INNER_LOOPS / 1e6;
+	gint i;
+	guint j;
+	g_autoptr(GTimer) timer = NULL;
+
+	/* warm up the caches and any lazy setup */
+	cb (size, user_data);
+
+	timer = g_timer_new ();
+	for (i = 0; i < bench_repeats; i++) {
+		gdouble elapsed;
+		gdouble delta;
+		g_timer_reset (timer);
+		for (j = 0; j < CD_BENCH_INNER_LOOPS; j++)
+			cb (size, user_data);
+		elapsed = g_timer_elapsed (timer, NULL);
+		delta = (mops / elapsed) - mean;
+		mean += delta / (i + 1);
+		m2 += delta * ((mops / elapsed) - mean);
+	}
+	cd_bench_kernels_report (name, size, mean, m2);
+}
+
+/**********************************************************************/
+
+typedef struct {
+	CdMat3x3	 mat;
+	CdVec3		*vec_in;
+	CdVec3		*vec_out;
+} CdBenchMat33Helper;
+
+static void
+cd_bench_kernels_mat33_matrix_multiply_cb (guint size, gpointer user_data)
+{
+	CdBenchMat33Helper *helper = (CdBenchMat33Helper *) user_data;
+	CdMat3x3 tmp;
+	guint i;
+	for (i = 0; i < size; i++)
+		cd_mat33_matrix_multiply (&helper->mat, &helper->mat, &tmp);
+}
+
+static void
+cd_bench_kernels_mat33_reciprocal_cb (guint size, gpointer user_data)
+{
+	CdBenchMat33Helper *helper = (CdBenchMat33Helper *) user_data;
+	CdMat3x3 tmp;
+	guint i;
+	for (i = 0; i < size; i++)
+		cd_mat33_reciprocal (&helper->mat, &tmp);
+}
+
+static void
+cd_bench_kernels_mat33_vector_batch_cb (guint size, gpointer user_data)
+{
+	CdBenchMat33Helper *helper = (CdBenchMat33Helper *) user_data;
+	cd_mat33_vector_multiply_batch (&helper->mat,
+					helper->vec_in,
+					helper->vec_out,
+					size);
+}
+
+static void
+cd_bench_kernels_mat33 (void)
+{
+	CdBenchMat33Helper helper;
+	guint i, s;
+
+	/* a well conditioned matrix so the reciprocal never fails */
+	cd_mat33_init (&helper.mat,
+		       0.4124, 0.3576, 0.1805,
+		       0.2126, 0.7152, 0.0722,
+		       0.0193, 0.1192, 0.9505);
+
+	cd_bench_kernels_run ("mat33-matrix-multiply", 4096,
+			      cd_bench_kernels_mat33_matrix_multiply_cb,
+			      &helper);
+	cd_bench_kernels_run ("mat33-reciprocal", 4096,
+			      cd_bench_kernels_mat33_reciprocal_cb,
+			      &helper);
+
+	for (s = 0; bench_array_sizes[s] != 0; s++) {
+		guint size = bench_array_sizes[s];
+		helper.vec_in = g_new0 (CdVec3, size);
+		helper.vec_out = g_new0 (CdVec3, size);
+		for (i = 0; i < size; i++) {
+			cd_vec3_init (&helper.vec_in[i],
+				      (gdouble) i / size,
+				      (gdouble) (size - i) / size,
+				      0.5f);
+		}
+		cd_bench_kernels_run ("mat33-vector-multiply-batch", size,
+				      cd_bench_kernels_mat33_vector_batch_cb,
+				      &helper);
+		g_free (helper.vec_in);
+		g_free (helper.vec_out);
+	}
+}
+
+/**********************************************************************/
+
+typedef struct {
+	CdSpectrum	*illuminant;
+	CdSpectrum	*observer;
+	gdouble		 resolution;
+	guint		 resample_size;
+} CdBenchSpectrumHelper;
+
+static void
+cd_bench_kernels_spectrum_multiply_cb (guint size, gpointer user_data)
+{
+	CdBenchSpectrumHelper *helper = (CdBenchSpectrumHelper *) user_data;
+	CdSpectrum *tmp;
+	tmp = cd_spectrum_multiply (helper->illuminant,
+				    helper->observer,
+				    helper->resolution);
+	cd_spectrum_free (tmp);
+}
+
+static void
+cd_bench_kernels_spectrum_resample_cb (guint size, gpointer user_data)
+{
+	CdBenchSpectrumHelper *helper = (CdBenchSpectrumHelper *) user_data;
+	CdSpectrum *tmp;
+	tmp = cd_spectrum_resample_to_size (helper->illuminant,
+					    helper->resample_size);
+	cd_spectrum_free (tmp);
+}
+
+static void
+cd_bench_kernels_spectrum (void)
+{
+	CdBenchSpectrumHelper helper;
+	struct {
+		const gchar	*name;
+		gdouble		 resolution;
+	} multiplies[] = {
+		{ "spectrum-multiply-5nm",	5.f },
+		{ "spectrum-multiply-1nm",	1.f },
+		{ NULL,				0.f }
+	};
+	struct {
+		const gchar	*name;
+		guint		 size;
+	} resamples[] = {
+		{ "spectrum-resample-to-31",	31 },
+		{ "spectrum-resample-to-1024",	1024 },
+		{ NULL,				0 }
+	};
+	guint i;
+
+	helper.illuminant = cd_spectrum_planckian_new (6500);
+	helper.observer = cd_spectrum_new_standard (CD_SPECTRUM_STANDARD_CIE1931_2DEG_Y);
+
+	for (i = 0; multiplies[i].name != NULL; i++) {
+		helper.resolution = multiplies[i].resolution;
+		cd_bench_kernels_run (multiplies[i].name,
+				      cd_spectrum_get_size (helper.illuminant),
+				      cd_bench_kernels_spectrum_multiply_cb,
+				      &helper);
+	}
+	for (i = 0; resamples[i].name != NULL; i++) {
+		helper.resample_size = resamples[i].size;
+		cd_bench_kernels_run (resamples[i].name,
+				      cd_spectrum_get_size (helper.illuminant),
+				      cd_bench_kernels_spectrum_resample_cb,
+				      &helper);
+	}
+	cd_spectrum_free (helper.illuminant);
+	cd_spectrum_free (helper.observer);
+}
+
+/**********************************************************************/
+
+typedef struct {
+	CdColorXYZ	*xyz;
+	CdColorYxy	*yxy;
+	CdColorRGB	*rgb;
+	CdColorRGB8	*rgb8;
+} CdBenchColorHelper;
+
+static void
+cd_bench_kernels_color_xyz_to_yxy_cb (guint size, gpointer user_data)
+{
+	CdBenchColorHelper *helper = (CdBenchColorHelper *) user_data;
+	cd_color_xyz_to_yxy_array (helper->xyz, helper->yxy, size);
+}
+
+static void
+cd_bench_kernels_color_yxy_to_xyz_cb (guint size, gpointer user_data)
+{
+	CdBenchColorHelper *helper = (CdBenchColorHelper *) user_data;
+	cd_color_yxy_to_xyz_array (helper->yxy, helper->xyz, size);
+}
+
+static void
+cd_bench_kernels_color_rgb_to_rgb8_cb (guint size, gpointer user_data)
+{
+	CdBenchColorHelper *helper = (CdBenchColorHelper *) user_data;
+	cd_color_rgb_to_rgb8_array (helper->rgb, helper->rgb8, size);
+}
+
+static void
+cd_bench_kernels_color (void)
+{
+	CdBenchColorHelper helper;
+	guint i, s;
+
+	for (s = 0; bench_array_sizes[s] != 0; s++) {
+		guint size = bench_array_sizes[s];
+		helper.xyz = g_new0 (CdColorXYZ, size);
+		helper.yxy = g_new0 (CdColorYxy, size);
+		helper.rgb = g_new0 (CdColorRGB, size);
+		helper.rgb8 = g_new0 (CdColorRGB8, size);
+		for (i = 0; i < size; i++) {
+			cd_color_xyz_set (&helper.xyz[i],
+					  (gdouble) (i + 1) / size,
+					  (gdouble) (size - i) / size,
+					  0.5f);
+			cd_color_rgb_set (&helper.rgb[i],
+					  (gdouble) i / size,
+					  (gdouble) (size - i) / size,
+					  0.5f);
+		}
+		cd_bench_kernels_run ("color-xyz-to-yxy", size,
+				      cd_bench_kernels_color_xyz_to_yxy_cb,
+				      &helper);
+		cd_bench_kernels_run ("color-yxy-to-xyz", size,
+				      cd_bench_kernels_color_yxy_to_xyz_cb,
+				      &helper);
+		cd_bench_kernels_run ("color-rgb-to-rgb8", size,
+				      cd_bench_kernels_color_rgb_to_rgb8_cb,
+				      &helper);
+		g_free (helper.xyz);
+		g_free (helper.yxy);
+		g_free (helper.rgb);
+		g_free (helper.rgb8);
+	}
+}
+
+/**********************************************************************/
+
+typedef struct {
+	CdInterp	*interp;
+	gdouble		*x;
+	gdouble		*y;
+} CdBenchInterpHelper;
+
+static void
+cd_bench_kernels_interp_eval_cb (guint size, gpointer user_data)
+{
+	CdBenchInterpHelper *helper = (CdBenchInterpHelper *) user_data;
+	if (!cd_interp_eval_array (helper->interp,
+				   helper->x, helper->y,
+				   size, NULL))
+		g_assert_not_reached ();
+}
+
+static gboolean
+cd_bench_kernels_interp (GError **error)
+{
+	struct {
+		const gchar	*name;
+		CdInterp	*(*new_func) (void);
+	} kinds[] = {
+		{ "interp-linear-eval",	cd_interp_linear_new },
+		{ "interp-akima-eval",	cd_interp_akima_new },
+		{ NULL,			NULL }
+	};
+	guint i, k, s;
+
+	for (k = 0; kinds[k].name != NULL; k++) {
+		CdBenchInterpHelper helper;
+
+		/* a typical VCGT-style curve with a handful of nodes */
+		helper.interp = kinds[k].new_func ();
+		for (i = 0; i < 17; i++) {
+			cd_interp_insert (helper.interp,
+					  (gdouble) i / 16,
+					  pow ((gdouble) i / 16, 2.2));
+		}
+		if (!cd_interp_prepare (helper.interp, error)) {
+			g_object_unref (helper.interp);
+			return FALSE;
+		}
+
+		for (s = 0; bench_array_sizes[s] != 0; s++) {
+			guint size = bench_array_sizes[s];
+			helper.x = g_new0 (gdouble, size);
+			helper.y = g_new0 (gdouble, size);
+			for (i = 0; i < size; i++)
+				helper.x[i] = (gdouble) i / (size - 1);
+			cd_bench_kernels_run (kinds[k].name, size,
+					      cd_bench_kernels_interp_eval_cb,
+					      &helper);
+			g_free (helper.x);
+			g_free (helper.y);
+		}
+		g_object_unref (helper.interp);
+	}
+	return TRUE;
+}
+
+/**********************************************************************/
+
+int
+main (int argc, char **argv)
+{
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GOptionContext) context = NULL;
+	const GOptionEntry options[] = {
+		{ "repeats", 'r', 0, G_OPTION_ARG_INT, &bench_repeats,
+		  "Number of timed repeats per configuration", NULL },
+		{ "json", 'j', 0, G_OPTION_ARG_NONE, &bench_json,
+		  "Print results as one JSON object per line", NULL },
+		{ NULL }
+	};
+
+	context = g_option_context_new ("- colord kernel microbenchmarks");
+	g_option_context_add_main_entries (context, options, NULL);
+	if (!g_option_context_parse (context, &argc, &argv, &error)) {
+		g_printerr ("failed to parse arguments: %s\n", error->message);
+		return EXIT_FAILURE;
+	}
+
+	cd_bench_kernels_mat33 ();
+	cd_bench_kernels_spectrum ();
+	cd_bench_kernels_color ();
+	if (!cd_bench_kernels_interp (&error)) {
+		g_printerr ("benchmark failed: %s\n", error->message);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
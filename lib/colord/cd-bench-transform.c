@@ -0,0 +1,164 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2026 Richard Hughes <richard@hughsie.com>
+ *
+ * Licensed under the GNU Lesser General Public License Version 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+/* benchmark for the cd_transform_process() hot path; this is not run as
+ * part of the test suite as absolute numbers are only meaningful when
+ * compared on the same hardware */
+
+#include "config.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "cd-transform.h"
+
+typedef struct {
+	const gchar	*name;
+	CdPixelFormat	 format;
+	guint		 bpp;
+} CdBenchFormat;
+
+static const CdBenchFormat bench_formats[] = {
+	{ "RGB24",	CD_PIXEL_FORMAT_RGB24,	3 },
+	{ "ARGB32",	CD_PIXEL_FORMAT_ARGB32,	4 },
+	{ NULL,		CD_PIXEL_FORMAT_UNKNOWN, 0 }
+};
+
+static const struct {
+	guint		 width;
+	guint		 height;
+} bench_sizes[] = {
+	{ 640,	480 },
+	{ 1920,	1080 },
+	{ 3840,	2160 },
+	{ 0,	0 }
+};
+
+static gint bench_repeats = 5;
+static gint bench_max_threads = 8;
+
+static gboolean
+cd_bench_transform_one (const CdBenchFormat *fmt,
+			guint width,
+			guint height,
+			guint max_threads,
+			gboolean bpc,
+			gboolean lut,
+			GError **error)
+{
+	gdouble mean = 0.f;
+	gdouble m2 = 0.f;
+	gdouble mpix = (gdouble) width * height / 1e6;
+	gint i;
+	g_autofree guint8 *data_in = NULL;
+	g_autofree guint8 *data_out = NULL;
+	g_autoptr(CdTransform) transform = NULL;
+	g_autoptr(GTimer) timer = NULL;
+
+	transform = cd_transform_new ();
+	cd_transform_set_rendering_intent (transform, CD_RENDERING_INTENT_PERCEPTUAL);
+	cd_transform_set_input_pixel_format (transform, fmt->format);
+	cd_transform_set_output_pixel_format (transform, fmt->format);
+	cd_transform_set_max_threads (transform, max_threads);
+	cd_transform_set_bpc (transform, bpc);
+	cd_transform_set_lut_enabled (transform, lut);
+
+	data_in = g_new0 (guint8, (gsize) width * height * fmt->bpp);
+	data_out = g_new0 (guint8, (gsize) width * height * fmt->bpp);
+	for (i = 0; i < (gint) ((gsize) width * height * fmt->bpp); i++)
+		data_in[i] = i % 0xff;
+
+	/* warm up the transform and the worker pool */
+	if (!cd_transform_process (transform,
+				   data_in, data_out,
+				   width, height, width,
+				   NULL, error))
+		return FALSE;
+
+	/* Welford running mean and variance over the repeats */
+	timer = g_timer_new ();
+	for (i = 0; i < bench_repeats; i++) {
+		gdouble elapsed;
+		gdouble delta;
+		g_timer_reset (timer);
+		if (!cd_transform_process (transform,
+					   data_in, data_out,
+					   width, height, width,
+					   NULL, error))
+			return FALSE;
+		elapsed = g_timer_elapsed (timer, NULL);
+		delta = (mpix / elapsed) - mean;
+		mean += delta / (i + 1);
+		m2 += delta * ((mpix / elapsed) - mean);
+	}
+	g_print ("%-7s %4ux%-4u threads=%u bpc=%u lut=%u : "
+		 "%8.1f ± %.1f MPix/s\n",
+		 fmt->name, width, height, max_threads, bpc, lut,
+		 mean,
+		 bench_repeats > 1 ? sqrt (m2 / (bench_repeats - 1)) : 0.f);
+	return TRUE;
+}
+
+int
+main (int argc, char **argv)
+{
+	guint f, s, t;
+	guint bpc, lut;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GOptionContext) context = NULL;
+	const GOptionEntry options[] = {
+		{ "repeats", 'r', 0, G_OPTION_ARG_INT, &bench_repeats,
+		  "Number of timed repeats per configuration", NULL },
+		{ "max-threads", 't', 0, G_OPTION_ARG_INT, &bench_max_threads,
+		  "Highest thread count to sweep", NULL },
+		{ NULL }
+	};
+
+	context = g_option_context_new ("- colord transform benchmark");
+	g_option_context_add_main_entries (context, options, NULL);
+	if (!g_option_context_parse (context, &argc, &argv, &error)) {
+		g_printerr ("failed to parse arguments: %s\n", error->message);
+		return EXIT_FAILURE;
+	}
+
+	for (f = 0; bench_formats[f].name != NULL; f++) {
+		for (s = 0; bench_sizes[s].width != 0; s++) {
+			for (t = 1; t <= (guint) bench_max_threads; t *= 2) {
+				for (bpc = 0; bpc < 2; bpc++) {
+					for (lut = 0; lut < 2; lut++) {
+						if (!cd_bench_transform_one (&bench_formats[f],
+									     bench_sizes[s].width,
+									     bench_sizes[s].height,
+									     t,
+									     bpc,
+									     lut,
+									     &error)) {
+							g_printerr ("benchmark failed: %s\n",
+								    error->message);
+							return EXIT_FAILURE;
+						}
+					}
+				}
+			}
+		}
+	}
+	return EXIT_SUCCESS;
+}
@@ -51,6 +51,20 @@ void		 cd_buffer_write_uint32_be	(guint8		*buffer,
 						 guint32	 value);
 void		 cd_buffer_write_uint32_le	(guint8		*buffer,
 						 guint32	 value);
+void		 cd_buffer_swap_uint16_array	(guint16	*values,
+						 gsize		 length);
+void		 cd_buffer_read_uint16_array_le	(const guint8	*buffer,
+						 guint16	*values,
+						 gsize		 length);
+void		 cd_buffer_write_uint16_array_le (guint8	*buffer,
+						 const guint16	*values,
+						 gsize		 length);
+void		 cd_buffer_read_double_array_le	(const guint8	*buffer,
+						 gdouble	*values,
+						 gsize		 length);
+guint64		 cd_buffer_hash			(const guint8	*data,
+						 gsize		 length,
+						 guint64	 seed);
 
 G_END_DECLS
 
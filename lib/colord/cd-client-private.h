@@ -0,0 +1,63 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2010-2015 Richard Hughes <richard@hughsie.com>
+ *
+ * Licensed under the GNU Lesser General Public License Version 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#ifndef CD_COMPILATION
+#error "This header is private to colord and is not installed."
+#endif
+
+#ifndef __CD_CLIENT_PRIVATE_H__
+#define __CD_CLIENT_PRIVATE_H__
+
+#include <glib.h>
+#include <gio/gio.h>
+
+#include "cd-client.h"
+#include "cd-device.h"
+#include "cd-profile.h"
+#include "cd-sensor.h"
+
+G_BEGIN_DECLS
+
+/* shared between cd-client.c and the synchronous fast paths in
+ * cd-client-sync.c; never exported from the library */
+G_GNUC_INTERNAL
+GDBusProxy	*_cd_client_get_proxy			(CdClient	*client);
+G_GNUC_INTERNAL
+void		 _cd_client_fixup_dbus_error		(GError		*error);
+G_GNUC_INTERNAL
+CdDevice	*_cd_client_get_cache_device		(CdClient	*client,
+							 const gchar	*object_path);
+G_GNUC_INTERNAL
+CdProfile	*_cd_client_get_cache_profile		(CdClient	*client,
+							 const gchar	*object_path);
+G_GNUC_INTERNAL
+GPtrArray	*_cd_client_get_device_array_from_variant (CdClient	*client,
+							 GVariant	*variant);
+G_GNUC_INTERNAL
+GPtrArray	*_cd_client_get_profile_array_from_variant (CdClient	*client,
+							 GVariant	*variant);
+G_GNUC_INTERNAL
+GPtrArray	*_cd_client_get_sensor_array_from_variant (CdClient	*client,
+							 GVariant	*variant);
+
+G_END_DECLS
+
+#endif /* __CD_CLIENT_PRIVATE_H__ */
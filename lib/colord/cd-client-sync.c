@@ -37,7 +37,9 @@
 
 #include "cd-profile.h"
 #include "cd-device.h"
+#include "cd-sensor.h"
 #include "cd-client.h"
+#include "cd-client-private.h"
 #include "cd-client-sync.h"
 
 /* tiny helper to help us do the async operation */
@@ -100,15 +102,6 @@ cd_client_connect_sync (CdClient *client,
 
 /**********************************************************************/
 
-static void
-cd_client_delete_profile_finish_sync (CdClient *client,
-				      GAsyncResult *res,
-				      CdClientHelper *helper)
-{
-	helper->ret = cd_client_delete_profile_finish (client, res, helper->error);
-	g_main_loop_quit (helper->loop);
-}
-
 /**
  * cd_client_delete_profile_sync:
  * @client: a #CdClient instance.
@@ -131,35 +124,31 @@ cd_client_delete_profile_sync (CdClient *client,
 			       GCancellable *cancellable,
 			       GError **error)
 {
-	CdClientHelper helper;
-
-	/* create temp object */
-	memset (&helper, 0, sizeof (CdClientHelper));
-	helper.loop = g_main_loop_new (NULL, FALSE);
-	helper.error = error;
-
-	/* run async method */
-	cd_client_delete_profile (client, profile, cancellable,
-				  (GAsyncReadyCallback) cd_client_delete_profile_finish_sync, &helper);
-	g_main_loop_run (helper.loop);
-
-	/* free temp object */
-	g_main_loop_unref (helper.loop);
-
-	return helper.ret;
+	g_autoptr(GVariant) result = NULL;
+
+	g_return_val_if_fail (CD_IS_CLIENT (client), FALSE);
+	g_return_val_if_fail (CD_IS_PROFILE (profile), FALSE);
+	g_return_val_if_fail (_cd_client_get_proxy (client) != NULL, FALSE);
+
+	/* call the daemon directly; no task setup or nested main loop */
+	result = g_dbus_proxy_call_sync (_cd_client_get_proxy (client),
+					 "DeleteProfile",
+					 g_variant_new ("(o)",
+							cd_profile_get_object_path (profile)),
+					 G_DBUS_CALL_FLAGS_NONE,
+					 -1,
+					 cancellable,
+					 error);
+	if (result == NULL) {
+		if (error != NULL && *error != NULL)
+			_cd_client_fixup_dbus_error (*error);
+		return FALSE;
+	}
+	return TRUE;
 }
 
 /**********************************************************************/
 
-static void
-cd_client_delete_device_finish_sync (CdClient *client,
-				      GAsyncResult *res,
-				      CdClientHelper *helper)
-{
-	helper->ret = cd_client_delete_device_finish (client, res, helper->error);
-	g_main_loop_quit (helper->loop);
-}
-
 /**
  * cd_client_delete_device_sync:
  * @client: a #CdClient instance.
@@ -182,37 +171,31 @@ cd_client_delete_device_sync (CdClient *client,
 			      GCancellable *cancellable,
 			      GError **error)
 {
-	CdClientHelper helper;
-
-	/* create temp object */
-	memset (&helper, 0, sizeof (CdClientHelper));
-	helper.loop = g_main_loop_new (NULL, FALSE);
-	helper.error = error;
-
-	/* run async method */
-	cd_client_delete_device (client, device, cancellable,
-				  (GAsyncReadyCallback) cd_client_delete_device_finish_sync, &helper);
-	g_main_loop_run (helper.loop);
-
-	/* free temp object */
-	g_main_loop_unref (helper.loop);
-
-	return helper.ret;
+	g_autoptr(GVariant) result = NULL;
+
+	g_return_val_if_fail (CD_IS_CLIENT (client), FALSE);
+	g_return_val_if_fail (CD_IS_DEVICE (device), FALSE);
+	g_return_val_if_fail (_cd_client_get_proxy (client) != NULL, FALSE);
+
+	/* call the daemon directly; no task setup or nested main loop */
+	result = g_dbus_proxy_call_sync (_cd_client_get_proxy (client),
+					 "DeleteDevice",
+					 g_variant_new ("(o)",
+							cd_device_get_object_path (device)),
+					 G_DBUS_CALL_FLAGS_NONE,
+					 -1,
+					 cancellable,
+					 error);
+	if (result == NULL) {
+		if (error != NULL && *error != NULL)
+			_cd_client_fixup_dbus_error (*error);
+		return FALSE;
+	}
+	return TRUE;
 }
 
 /**********************************************************************/
 
-static void
-cd_client_find_profile_finish_sync (CdClient *client,
-				    GAsyncResult *res,
-				    CdClientHelper *helper)
-{
-	helper->profile = cd_client_find_profile_finish (client,
-							 res,
-							 helper->error);
-	g_main_loop_quit (helper->loop);
-}
-
 /**
  * cd_client_find_profile_sync:
  * @client: a #CdClient instance.
@@ -235,39 +218,32 @@ cd_client_find_profile_sync (CdClient *client,
 			     GCancellable *cancellable,
 			     GError **error)
 {
-	CdClientHelper helper;
-
-	/* create temp object */
-	memset (&helper, 0, sizeof (CdClientHelper));
-	helper.loop = g_main_loop_new (NULL, FALSE);
-	helper.error = error;
-	helper.profile = NULL;
-
-	/* run async method */
-	cd_client_find_profile (client, id, cancellable,
-				(GAsyncReadyCallback) cd_client_find_profile_finish_sync,
-				&helper);
-	g_main_loop_run (helper.loop);
-
-	/* free temp object */
-	g_main_loop_unref (helper.loop);
-
-	return helper.profile;
+	g_autofree gchar *object_path = NULL;
+	g_autoptr(GVariant) result = NULL;
+
+	g_return_val_if_fail (CD_IS_CLIENT (client), NULL);
+	g_return_val_if_fail (id != NULL, NULL);
+	g_return_val_if_fail (_cd_client_get_proxy (client) != NULL, NULL);
+
+	/* call the daemon directly; no task setup or nested main loop */
+	result = g_dbus_proxy_call_sync (_cd_client_get_proxy (client),
+					 "FindProfileById",
+					 g_variant_new ("(s)", id),
+					 G_DBUS_CALL_FLAGS_NONE,
+					 -1,
+					 cancellable,
+					 error);
+	if (result == NULL) {
+		if (error != NULL && *error != NULL)
+			_cd_client_fixup_dbus_error (*error);
+		return NULL;
+	}
+	g_variant_get (result, "(o)", &object_path);
+	return _cd_client_get_cache_profile (client, object_path);
 }
 
 /**********************************************************************/
 
-static void
-cd_client_find_profile_by_filename_finish_sync (CdClient *client,
-						GAsyncResult *res,
-						CdClientHelper *helper)
-{
-	helper->profile = cd_client_find_profile_by_filename_finish (client,
-								     res,
-								     helper->error);
-	g_main_loop_quit (helper->loop);
-}
-
 /**
  * cd_client_find_profile_by_filename_sync:
  * @client: a #CdClient instance.
@@ -290,24 +266,28 @@ cd_client_find_profile_by_filename_sync (CdClient *client,
 					 GCancellable *cancellable,
 					 GError **error)
 {
-	CdClientHelper helper;
-
-	/* create temp object */
-	memset (&helper, 0, sizeof (CdClientHelper));
-	helper.loop = g_main_loop_new (NULL, FALSE);
-	helper.error = error;
-	helper.profile = NULL;
-
-	/* run async method */
-	cd_client_find_profile_by_filename (client, filename, cancellable,
-					    (GAsyncReadyCallback) cd_client_find_profile_by_filename_finish_sync,
-					    &helper);
-	g_main_loop_run (helper.loop);
-
-	/* free temp object */
-	g_main_loop_unref (helper.loop);
-
-	return helper.profile;
+	g_autofree gchar *object_path = NULL;
+	g_autoptr(GVariant) result = NULL;
+
+	g_return_val_if_fail (CD_IS_CLIENT (client), NULL);
+	g_return_val_if_fail (filename != NULL, NULL);
+	g_return_val_if_fail (_cd_client_get_proxy (client) != NULL, NULL);
+
+	/* call the daemon directly; no task setup or nested main loop */
+	result = g_dbus_proxy_call_sync (_cd_client_get_proxy (client),
+					 "FindProfileByFilename",
+					 g_variant_new ("(s)", filename),
+					 G_DBUS_CALL_FLAGS_NONE,
+					 -1,
+					 cancellable,
+					 error);
+	if (result == NULL) {
+		if (error != NULL && *error != NULL)
+			_cd_client_fixup_dbus_error (*error);
+		return NULL;
+	}
+	g_variant_get (result, "(o)", &object_path);
+	return _cd_client_get_cache_profile (client, object_path);
 }
 
 /**********************************************************************/
@@ -485,17 +465,6 @@ cd_client_import_profile_sync (CdClient *client,
 
 /**********************************************************************/
 
-static void
-cd_client_create_device_finish_sync (CdClient *client,
-				      GAsyncResult *res,
-				      CdClientHelper *helper)
-{
-	helper->device = cd_client_create_device_finish (client,
-							   res,
-							   helper->error);
-	g_main_loop_quit (helper->loop);
-}
-
 /**
  * cd_client_create_device_sync:
  * @client: a #CdClient instance.
@@ -523,47 +492,121 @@ cd_client_create_device_sync (CdClient *client,
 			       GCancellable *cancellable,
 			       GError **error)
 {
-	CdClientHelper helper;
+	const gchar *value;
+	GVariantBuilder builder;
+	GList *list, *l;
+	g_autofree gchar *object_path = NULL;
+	g_autoptr(GVariant) result = NULL;
+
+	g_return_val_if_fail (CD_IS_CLIENT (client), NULL);
+	g_return_val_if_fail (id != NULL, NULL);
+	g_return_val_if_fail (_cd_client_get_proxy (client) != NULL, NULL);
+
+	/* add properties */
+	g_variant_builder_init (&builder, G_VARIANT_TYPE_ARRAY);
+	if (properties != NULL) {
+		list = g_hash_table_get_keys (properties);
+		for (l = list; l != NULL; l = l->next) {
+			value = g_hash_table_lookup (properties, l->data);
+			g_variant_builder_add (&builder,
+					       "{ss}",
+					       l->data,
+					       value != NULL ? value : "");
+		}
+		g_list_free (list);
+	} else {
+		/* just fake something here */
+		g_variant_builder_add (&builder,
+				       "{ss}",
+				       CD_DEVICE_PROPERTY_KIND,
+				       "unknown");
+	}
+
+	/* call the daemon directly; no task setup or nested main loop */
+	result = g_dbus_proxy_call_sync (_cd_client_get_proxy (client),
+					 "CreateDevice",
+					 g_variant_new ("(ssa{ss})",
+							id,
+							cd_object_scope_to_string (scope),
+							&builder),
+					 G_DBUS_CALL_FLAGS_NONE,
+					 -1,
+					 cancellable,
+					 error);
+	if (result == NULL) {
+		if (error != NULL && *error != NULL)
+			_cd_client_fixup_dbus_error (*error);
+		return NULL;
+	}
+	g_variant_get (result, "(o)", &object_path);
+	return _cd_client_get_cache_device (client, object_path);
+}
 
-	/* create temp object */
-	memset (&helper, 0, sizeof (CdClientHelper));
-	helper.loop = g_main_loop_new (NULL, FALSE);
-	helper.error = error;
-	helper.device = NULL;
+/**********************************************************************/
 
-	/* run async method */
-	cd_client_create_device (client, id, scope,
-				  properties, cancellable,
-				  (GAsyncReadyCallback) cd_client_create_device_finish_sync,
-				  &helper);
-	g_main_loop_run (helper.loop);
+/**
+ * cd_client_get_devices_sync:
+ * @client: a #CdClient instance.
+ * @cancellable: a #GCancellable, or %NULL
+ * @error: a #GError, or %NULL
+ *
+ * Get an array of the device objects.
+ *
+ * WARNING: This function is synchronous, and may block.
+ * Do not use it in GUI applications.
+ *
+ * Return value: (transfer container) (element-type CdDevice): an array of
+ *		 #CdDevice objects.
+ *
+ * Since: 0.1.0
+ **/
+GPtrArray *
+cd_client_get_devices_sync (CdClient *client,
+			    GCancellable *cancellable,
+			    GError **error)
+{
+	g_autoptr(GVariant) result = NULL;
 
-	/* free temp object */
-	g_main_loop_unref (helper.loop);
+	g_return_val_if_fail (CD_IS_CLIENT (client), NULL);
+	g_return_val_if_fail (_cd_client_get_proxy (client) != NULL, NULL);
 
-	return helper.device;
+	/* call the daemon directly; no task setup or nested main loop */
+	result = g_dbus_proxy_call_sync (_cd_client_get_proxy (client),
+					 "GetDevices",
+					 NULL,
+					 G_DBUS_CALL_FLAGS_NONE,
+					 -1,
+					 cancellable,
+					 error);
+	if (result == NULL) {
+		if (error != NULL && *error != NULL)
+			_cd_client_fixup_dbus_error (*error);
+		return NULL;
+	}
+	return _cd_client_get_device_array_from_variant (client, result);
 }
 
 /**********************************************************************/
 
 static void
-cd_client_get_devices_finish_sync (CdClient *client,
-				   GAsyncResult *res,
-				   CdClientHelper *helper)
+cd_client_get_devices_full_finish_sync (CdClient *client,
+					GAsyncResult *res,
+					CdClientHelper *helper)
 {
-	helper->array = cd_client_get_devices_finish (client,
-						      res,
-						      helper->error);
+	helper->array = cd_client_get_devices_full_finish (client,
+							   res,
+							   helper->error);
 	g_main_loop_quit (helper->loop);
 }
 
 /**
- * cd_client_get_devices_sync:
+ * cd_client_get_devices_full_sync:
  * @client: a #CdClient instance.
  * @cancellable: a #GCancellable, or %NULL
  * @error: a #GError, or %NULL
  *
- * Get an array of the device objects.
+ * Get an array of the device objects, already connected, using a single
+ * bus round trip for all the device properties.
  *
  * WARNING: This function is synchronous, and may block.
  * Do not use it in GUI applications.
@@ -571,12 +614,12 @@ cd_client_get_devices_finish_sync (CdClient *client,
  * Return value: (transfer container) (element-type CdDevice): an array of
  *		 #CdDevice objects.
  *
- * Since: 0.1.0
+ * Since: 1.4.6
  **/
 GPtrArray *
-cd_client_get_devices_sync (CdClient *client,
-			    GCancellable *cancellable,
-			    GError **error)
+cd_client_get_devices_full_sync (CdClient *client,
+				 GCancellable *cancellable,
+				 GError **error)
 {
 	CdClientHelper helper;
 
@@ -587,9 +630,9 @@ cd_client_get_devices_sync (CdClient *client,
 	helper.array = NULL;
 
 	/* run async method */
-	cd_client_get_devices (client, cancellable,
-			       (GAsyncReadyCallback) cd_client_get_devices_finish_sync,
-			       &helper);
+	cd_client_get_devices_full (client, cancellable,
+				    (GAsyncReadyCallback) cd_client_get_devices_full_finish_sync,
+				    &helper);
 	g_main_loop_run (helper.loop);
 
 	/* free temp object */
@@ -600,17 +643,6 @@ cd_client_get_devices_sync (CdClient *client,
 
 /**********************************************************************/
 
-static void
-cd_client_get_profiles_finish_sync (CdClient *client,
-				   GAsyncResult *res,
-				   CdClientHelper *helper)
-{
-	helper->array = cd_client_get_profiles_finish (client,
-						       res,
-						       helper->error);
-	g_main_loop_quit (helper->loop);
-}
-
 /**
  * cd_client_get_profiles_sync:
  * @client: a #CdClient instance.
@@ -632,39 +664,29 @@ cd_client_get_profiles_sync (CdClient *client,
 			     GCancellable *cancellable,
 			     GError **error)
 {
-	CdClientHelper helper;
+	g_autoptr(GVariant) result = NULL;
 
-	/* create temp object */
-	memset (&helper, 0, sizeof (CdClientHelper));
-	helper.loop = g_main_loop_new (NULL, FALSE);
-	helper.error = error;
-	helper.array = NULL;
-
-	/* run async method */
-	cd_client_get_profiles (client, cancellable,
-			        (GAsyncReadyCallback) cd_client_get_profiles_finish_sync,
-			        &helper);
-	g_main_loop_run (helper.loop);
-
-	/* free temp object */
-	g_main_loop_unref (helper.loop);
+	g_return_val_if_fail (CD_IS_CLIENT (client), NULL);
+	g_return_val_if_fail (_cd_client_get_proxy (client) != NULL, NULL);
 
-	return helper.array;
+	/* call the daemon directly; no task setup or nested main loop */
+	result = g_dbus_proxy_call_sync (_cd_client_get_proxy (client),
+					 "GetProfiles",
+					 NULL,
+					 G_DBUS_CALL_FLAGS_NONE,
+					 -1,
+					 cancellable,
+					 error);
+	if (result == NULL) {
+		if (error != NULL && *error != NULL)
+			_cd_client_fixup_dbus_error (*error);
+		return NULL;
+	}
+	return _cd_client_get_profile_array_from_variant (client, result);
 }
 
 /**********************************************************************/
 
-static void
-cd_client_get_sensors_finish_sync (CdClient *client,
-				   GAsyncResult *res,
-				   CdClientHelper *helper)
-{
-	helper->array = cd_client_get_sensors_finish (client,
-						      res,
-						      helper->error);
-	g_main_loop_quit (helper->loop);
-}
-
 /**
  * cd_client_get_sensors_sync:
  * @client: a #CdClient instance.
@@ -686,39 +708,29 @@ cd_client_get_sensors_sync (CdClient *client,
 			    GCancellable *cancellable,
 			    GError **error)
 {
-	CdClientHelper helper;
+	g_autoptr(GVariant) result = NULL;
 
-	/* create temp object */
-	memset (&helper, 0, sizeof (CdClientHelper));
-	helper.loop = g_main_loop_new (NULL, FALSE);
-	helper.error = error;
-	helper.array = NULL;
-
-	/* run async method */
-	cd_client_get_sensors (client, cancellable,
-			       (GAsyncReadyCallback) cd_client_get_sensors_finish_sync,
-			       &helper);
-	g_main_loop_run (helper.loop);
-
-	/* free temp object */
-	g_main_loop_unref (helper.loop);
+	g_return_val_if_fail (CD_IS_CLIENT (client), NULL);
+	g_return_val_if_fail (_cd_client_get_proxy (client) != NULL, NULL);
 
-	return helper.array;
+	/* call the daemon directly; no task setup or nested main loop */
+	result = g_dbus_proxy_call_sync (_cd_client_get_proxy (client),
+					 "GetSensors",
+					 NULL,
+					 G_DBUS_CALL_FLAGS_NONE,
+					 -1,
+					 cancellable,
+					 error);
+	if (result == NULL) {
+		if (error != NULL && *error != NULL)
+			_cd_client_fixup_dbus_error (*error);
+		return NULL;
+	}
+	return _cd_client_get_sensor_array_from_variant (client, result);
 }
 
 /**********************************************************************/
 
-static void
-cd_client_find_device_finish_sync (CdClient *client,
-				   GAsyncResult *res,
-				   CdClientHelper *helper)
-{
-	helper->device = cd_client_find_device_finish (client,
-						       res,
-						       helper->error);
-	g_main_loop_quit (helper->loop);
-}
-
 /**
  * cd_client_find_device_sync:
  * @client: a #CdClient instance.
@@ -741,38 +753,32 @@ cd_client_find_device_sync (CdClient *client,
 			    GCancellable *cancellable,
 			    GError **error)
 {
-	CdClientHelper helper;
-
-	/* create temp object */
-	memset (&helper, 0, sizeof (CdClientHelper));
-	helper.loop = g_main_loop_new (NULL, FALSE);
-	helper.error = error;
-
-	/* run async method */
-	cd_client_find_device (client, id, cancellable,
-			       (GAsyncReadyCallback) cd_client_find_device_finish_sync,
-			       &helper);
-	g_main_loop_run (helper.loop);
-
-	/* free temp object */
-	g_main_loop_unref (helper.loop);
-
-	return helper.device;
+	g_autofree gchar *object_path = NULL;
+	g_autoptr(GVariant) result = NULL;
+
+	g_return_val_if_fail (CD_IS_CLIENT (client), NULL);
+	g_return_val_if_fail (id != NULL, NULL);
+	g_return_val_if_fail (_cd_client_get_proxy (client) != NULL, NULL);
+
+	/* call the daemon directly; no task setup or nested main loop */
+	result = g_dbus_proxy_call_sync (_cd_client_get_proxy (client),
+					 "FindDeviceById",
+					 g_variant_new ("(s)", id),
+					 G_DBUS_CALL_FLAGS_NONE,
+					 -1,
+					 cancellable,
+					 error);
+	if (result == NULL) {
+		if (error != NULL && *error != NULL)
+			_cd_client_fixup_dbus_error (*error);
+		return NULL;
+	}
+	g_variant_get (result, "(o)", &object_path);
+	return _cd_client_get_cache_device (client, object_path);
 }
 
 /**********************************************************************/
 
-static void
-cd_client_find_device_by_property_finish_sync (CdClient *client,
-					       GAsyncResult *res,
-					       CdClientHelper *helper)
-{
-	helper->device = cd_client_find_device_by_property_finish (client,
-								   res,
-								   helper->error);
-	g_main_loop_quit (helper->loop);
-}
-
 /**
  * cd_client_find_device_by_property_sync:
  * @client: a #CdClient instance.
@@ -797,38 +803,32 @@ cd_client_find_device_by_property_sync (CdClient *client,
 					GCancellable *cancellable,
 					GError **error)
 {
-	CdClientHelper helper;
-
-	/* create temp object */
-	memset (&helper, 0, sizeof (CdClientHelper));
-	helper.loop = g_main_loop_new (NULL, FALSE);
-	helper.error = error;
-
-	/* run async method */
-	cd_client_find_device_by_property (client, key, value, cancellable,
-					   (GAsyncReadyCallback) cd_client_find_device_by_property_finish_sync,
-					   &helper);
-	g_main_loop_run (helper.loop);
-
-	/* free temp object */
-	g_main_loop_unref (helper.loop);
-
-	return helper.device;
+	g_autofree gchar *object_path = NULL;
+	g_autoptr(GVariant) result = NULL;
+
+	g_return_val_if_fail (CD_IS_CLIENT (client), NULL);
+	g_return_val_if_fail (key != NULL, NULL);
+	g_return_val_if_fail (_cd_client_get_proxy (client) != NULL, NULL);
+
+	/* call the daemon directly; no task setup or nested main loop */
+	result = g_dbus_proxy_call_sync (_cd_client_get_proxy (client),
+					 "FindDeviceByProperty",
+					 g_variant_new ("(ss)", key, value),
+					 G_DBUS_CALL_FLAGS_NONE,
+					 -1,
+					 cancellable,
+					 error);
+	if (result == NULL) {
+		if (error != NULL && *error != NULL)
+			_cd_client_fixup_dbus_error (*error);
+		return NULL;
+	}
+	g_variant_get (result, "(o)", &object_path);
+	return _cd_client_get_cache_device (client, object_path);
 }
 
 /**********************************************************************/
 
-static void
-cd_client_get_standard_space_finish_sync (CdClient *client,
-					  GAsyncResult *res,
-					  CdClientHelper *helper)
-{
-	helper->profile = cd_client_get_standard_space_finish (client,
-							       res,
-							       helper->error);
-	g_main_loop_quit (helper->loop);
-}
-
 /**
  * cd_client_get_standard_space_sync:
  * @client: a #CdClient instance.
@@ -851,39 +851,32 @@ cd_client_get_standard_space_sync (CdClient *client,
 				   GCancellable *cancellable,
 				   GError **error)
 {
-	CdClientHelper helper;
-
-	/* create temp object */
-	memset (&helper, 0, sizeof (CdClientHelper));
-	helper.loop = g_main_loop_new (NULL, FALSE);
-	helper.error = error;
-	helper.profile = NULL;
-
-	/* run async method */
-	cd_client_get_standard_space (client, standard_space, cancellable,
-				      (GAsyncReadyCallback) cd_client_get_standard_space_finish_sync,
-				      &helper);
-	g_main_loop_run (helper.loop);
-
-	/* free temp object */
-	g_main_loop_unref (helper.loop);
-
-	return helper.profile;
+	g_autofree gchar *object_path = NULL;
+	g_autoptr(GVariant) result = NULL;
+
+	g_return_val_if_fail (CD_IS_CLIENT (client), NULL);
+	g_return_val_if_fail (_cd_client_get_proxy (client) != NULL, NULL);
+
+	/* call the daemon directly; no task setup or nested main loop */
+	result = g_dbus_proxy_call_sync (_cd_client_get_proxy (client),
+					 "GetStandardSpace",
+					 g_variant_new ("(s)",
+							cd_standard_space_to_string (standard_space)),
+					 G_DBUS_CALL_FLAGS_NONE,
+					 -1,
+					 cancellable,
+					 error);
+	if (result == NULL) {
+		if (error != NULL && *error != NULL)
+			_cd_client_fixup_dbus_error (*error);
+		return NULL;
+	}
+	g_variant_get (result, "(o)", &object_path);
+	return _cd_client_get_cache_profile (client, object_path);
 }
 
 /**********************************************************************/
 
-static void
-cd_client_get_devices_by_kind_finish_sync (CdClient *client,
-					   GAsyncResult *res,
-					   CdClientHelper *helper)
-{
-	helper->array = cd_client_get_devices_by_kind_finish (client,
-							      res,
-							      helper->error);
-	g_main_loop_quit (helper->loop);
-}
-
 /**
  * cd_client_get_devices_by_kind_sync:
  * @client: a #CdClient instance.
@@ -907,38 +900,30 @@ cd_client_get_devices_by_kind_sync (CdClient *client,
 				    GCancellable *cancellable,
 				    GError **error)
 {
-	CdClientHelper helper;
+	g_autoptr(GVariant) result = NULL;
 
-	/* create temp object */
-	memset (&helper, 0, sizeof (CdClientHelper));
-	helper.loop = g_main_loop_new (NULL, FALSE);
-	helper.error = error;
+	g_return_val_if_fail (CD_IS_CLIENT (client), NULL);
+	g_return_val_if_fail (_cd_client_get_proxy (client) != NULL, NULL);
 
-	/* run async method */
-	cd_client_get_devices_by_kind (client, kind, cancellable,
-				       (GAsyncReadyCallback) cd_client_get_devices_by_kind_finish_sync,
-				       &helper);
-	g_main_loop_run (helper.loop);
-
-	/* free temp object */
-	g_main_loop_unref (helper.loop);
-
-	return helper.array;
+	/* call the daemon directly; no task setup or nested main loop */
+	result = g_dbus_proxy_call_sync (_cd_client_get_proxy (client),
+					 "GetDevicesByKind",
+					 g_variant_new ("(s)",
+							cd_device_kind_to_string (kind)),
+					 G_DBUS_CALL_FLAGS_NONE,
+					 -1,
+					 cancellable,
+					 error);
+	if (result == NULL) {
+		if (error != NULL && *error != NULL)
+			_cd_client_fixup_dbus_error (*error);
+		return NULL;
+	}
+	return _cd_client_get_device_array_from_variant (client, result);
 }
 
 /**********************************************************************/
 
-static void
-cd_client_find_profile_by_property_finish_sync (CdClient *client,
-					       GAsyncResult *res,
-					       CdClientHelper *helper)
-{
-	helper->profile = cd_client_find_profile_by_property_finish (client,
-								     res,
-								     helper->error);
-	g_main_loop_quit (helper->loop);
-}
-
 /**
  * cd_client_find_profile_by_property_sync:
  * @client: a #CdClient instance.
@@ -963,38 +948,32 @@ cd_client_find_profile_by_property_sync (CdClient *client,
 					 GCancellable *cancellable,
 					 GError **error)
 {
-	CdClientHelper helper;
-
-	/* create temp object */
-	memset (&helper, 0, sizeof (CdClientHelper));
-	helper.loop = g_main_loop_new (NULL, FALSE);
-	helper.error = error;
-
-	/* run async method */
-	cd_client_find_profile_by_property (client, key, value, cancellable,
-					    (GAsyncReadyCallback) cd_client_find_profile_by_property_finish_sync,
-					    &helper);
-	g_main_loop_run (helper.loop);
-
-	/* free temp object */
-	g_main_loop_unref (helper.loop);
-
-	return helper.profile;
+	g_autofree gchar *object_path = NULL;
+	g_autoptr(GVariant) result = NULL;
+
+	g_return_val_if_fail (CD_IS_CLIENT (client), NULL);
+	g_return_val_if_fail (key != NULL, NULL);
+	g_return_val_if_fail (_cd_client_get_proxy (client) != NULL, NULL);
+
+	/* call the daemon directly; no task setup or nested main loop */
+	result = g_dbus_proxy_call_sync (_cd_client_get_proxy (client),
+					 "FindProfileByProperty",
+					 g_variant_new ("(ss)", key, value),
+					 G_DBUS_CALL_FLAGS_NONE,
+					 -1,
+					 cancellable,
+					 error);
+	if (result == NULL) {
+		if (error != NULL && *error != NULL)
+			_cd_client_fixup_dbus_error (*error);
+		return NULL;
+	}
+	g_variant_get (result, "(o)", &object_path);
+	return _cd_client_get_cache_profile (client, object_path);
 }
 
 /**********************************************************************/
 
-static void
-cd_client_find_sensor_finish_sync (CdClient *client,
-				   GAsyncResult *res,
-				   CdClientHelper *helper)
-{
-	helper->sensor = cd_client_find_sensor_finish (client,
-						       res,
-						       helper->error);
-	g_main_loop_quit (helper->loop);
-}
-
 /**
  * cd_client_find_sensor_sync:
  * @client: a #CdClient instance.
@@ -1017,23 +996,28 @@ cd_client_find_sensor_sync (CdClient *client,
 			    GCancellable *cancellable,
 			    GError **error)
 {
-	CdClientHelper helper;
-
-	/* create temp object */
-	memset (&helper, 0, sizeof (CdClientHelper));
-	helper.loop = g_main_loop_new (NULL, FALSE);
-	helper.error = error;
-
-	/* run async method */
-	cd_client_find_sensor (client, id, cancellable,
-			       (GAsyncReadyCallback) cd_client_find_sensor_finish_sync,
-			       &helper);
-	g_main_loop_run (helper.loop);
-
-	/* free temp object */
-	g_main_loop_unref (helper.loop);
-
-	return helper.sensor;
+	g_autofree gchar *object_path = NULL;
+	g_autoptr(GVariant) result = NULL;
+
+	g_return_val_if_fail (CD_IS_CLIENT (client), NULL);
+	g_return_val_if_fail (id != NULL, NULL);
+	g_return_val_if_fail (_cd_client_get_proxy (client) != NULL, NULL);
+
+	/* call the daemon directly; no task setup or nested main loop */
+	result = g_dbus_proxy_call_sync (_cd_client_get_proxy (client),
+					 "FindSensorById",
+					 g_variant_new ("(s)", id),
+					 G_DBUS_CALL_FLAGS_NONE,
+					 -1,
+					 cancellable,
+					 error);
+	if (result == NULL) {
+		if (error != NULL && *error != NULL)
+			_cd_client_fixup_dbus_error (*error);
+		return NULL;
+	}
+	g_variant_get (result, "(o)", &object_path);
+	return cd_sensor_new_with_object_path (object_path);
 }
 
 /**********************************************************************/
@@ -87,6 +87,10 @@ GPtrArray	*cd_client_get_devices_sync		(CdClient	*client,
 							 GCancellable	*cancellable,
 							 GError		**error)
 							 G_GNUC_WARN_UNUSED_RESULT;
+GPtrArray	*cd_client_get_devices_full_sync	(CdClient	*client,
+							 GCancellable	*cancellable,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
 GPtrArray	*cd_client_get_profiles_sync		(CdClient	*client,
 							 GCancellable	*cancellable,
 							 GError		**error)
@@ -29,6 +29,10 @@
  * See also: #CdDevice
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* for copy_file_range() */
+#endif
+
 #include "config.h"
 
 #include <fcntl.h>
@@ -36,6 +40,7 @@
 #include <stdlib.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <unistd.h>
 
 #include <gio/gio.h>
 #ifdef __unix__
@@ -46,6 +51,7 @@
 
 #include "cd-enum.h"
 #include "cd-client.h"
+#include "cd-client-private.h"
 #include "cd-client-sync.h"
 #include "cd-device.h"
 #include "cd-device-sync.h"
@@ -72,9 +78,14 @@ static void	cd_client_finalize	(GObject	*object);
 typedef struct
 {
 	GDBusProxy		*proxy;
+	GMainContext		*context;
 	gchar			*daemon_version;
 	gchar			*system_vendor;
 	gchar			*system_model;
+	GHashTable		*device_cache;		/* of object path:CdDevice */
+	GHashTable		*profile_cache;		/* of object path:CdProfile */
+	CdClientWatchFlags	 watch_flags;
+	GArray			*subscription_ids;	/* of guint */
 } CdClientPrivate;
 
 enum {
@@ -105,6 +116,25 @@ static gpointer cd_client_object = NULL;
 
 G_DEFINE_TYPE_WITH_PRIVATE (CdClient, cd_client, G_TYPE_OBJECT)
 
+/* make the client context (if any) the thread-default for the duration
+ * of an async call setup, so that all the GDBus sources and the user
+ * callback attach to it rather than to the calling thread's context */
+static void
+cd_client_context_push (CdClient *client)
+{
+	CdClientPrivate *priv = GET_PRIVATE (client);
+	if (priv->context != NULL)
+		g_main_context_push_thread_default (priv->context);
+}
+
+static void
+cd_client_context_pop (CdClient *client)
+{
+	CdClientPrivate *priv = GET_PRIVATE (client);
+	if (priv->context != NULL)
+		g_main_context_pop_thread_default (priv->context);
+}
+
 /**
  * cd_client_error_quark:
  *
@@ -185,6 +215,45 @@ cd_client_get_system_model (CdClient *client)
 	return priv->system_model;
 }
 
+/**
+ * cd_client_set_watch_flags:
+ * @client: a #CdClient instance.
+ * @flags: the #CdClientWatchFlags, e.g. %CD_CLIENT_WATCH_FLAGS_DEVICES
+ *
+ * Sets the kinds of objects to watch for daemon signals, which has to
+ * be done before cd_client_connect() is called. The default is to
+ * watch everything; restricting the watch means signals for the other
+ * kinds never cross the bus or wake the process.
+ *
+ * Since: 1.4.6
+ **/
+void
+cd_client_set_watch_flags (CdClient *client, CdClientWatchFlags flags)
+{
+	CdClientPrivate *priv = GET_PRIVATE (client);
+	g_return_if_fail (CD_IS_CLIENT (client));
+	g_return_if_fail (priv->proxy == NULL);
+	priv->watch_flags = flags;
+}
+
+/**
+ * cd_client_get_watch_flags:
+ * @client: a #CdClient instance.
+ *
+ * Gets the kinds of objects being watched for daemon signals.
+ *
+ * Return value: the #CdClientWatchFlags
+ *
+ * Since: 1.4.6
+ **/
+CdClientWatchFlags
+cd_client_get_watch_flags (CdClient *client)
+{
+	CdClientPrivate *priv = GET_PRIVATE (client);
+	g_return_val_if_fail (CD_IS_CLIENT (client), CD_CLIENT_WATCH_FLAGS_NONE);
+	return priv->watch_flags;
+}
+
 /**
  * cd_client_get_connected:
  * @client: a #CdClient instance.
@@ -245,11 +314,104 @@ cd_client_get_has_server (CdClient *client)
 /**********************************************************************/
 
 static void
-cd_client_dbus_signal_cb (GDBusProxy *proxy,
-			  gchar      *sender_name,
-			  gchar      *signal_name,
-			  GVariant   *parameters,
-			  CdClient   *client)
+cd_client_cache_object_gone_cb (gpointer user_data,
+				GObject *where_the_object_was)
+{
+	CdClient *client = CD_CLIENT (user_data);
+	CdClientPrivate *priv = GET_PRIVATE (client);
+	GHashTableIter iter;
+	gpointer value;
+
+	/* the caches hold no references, so drop the stale pointer */
+	g_hash_table_iter_init (&iter, priv->device_cache);
+	while (g_hash_table_iter_next (&iter, NULL, &value)) {
+		if (value == (gpointer) where_the_object_was) {
+			g_hash_table_iter_remove (&iter);
+			return;
+		}
+	}
+	g_hash_table_iter_init (&iter, priv->profile_cache);
+	while (g_hash_table_iter_next (&iter, NULL, &value)) {
+		if (value == (gpointer) where_the_object_was) {
+			g_hash_table_iter_remove (&iter);
+			return;
+		}
+	}
+}
+
+static void
+cd_client_cache_clear (CdClient *client)
+{
+	CdClientPrivate *priv = GET_PRIVATE (client);
+	GHashTableIter iter;
+	gpointer value;
+
+	g_hash_table_iter_init (&iter, priv->device_cache);
+	while (g_hash_table_iter_next (&iter, NULL, &value)) {
+		g_object_weak_unref (G_OBJECT (value),
+				     cd_client_cache_object_gone_cb,
+				     client);
+		g_hash_table_iter_remove (&iter);
+	}
+	g_hash_table_iter_init (&iter, priv->profile_cache);
+	while (g_hash_table_iter_next (&iter, NULL, &value)) {
+		g_object_weak_unref (G_OBJECT (value),
+				     cd_client_cache_object_gone_cb,
+				     client);
+		g_hash_table_iter_remove (&iter);
+	}
+}
+
+static CdDevice *
+cd_client_get_cache_device (CdClient *client,
+			    const gchar *object_path)
+{
+	CdClientPrivate *priv = GET_PRIVATE (client);
+	CdDevice *device;
+
+	/* hand back an existing proxy for the same object path so that
+	 * repeated lookups do not re-fetch an unchanged property set */
+	device = g_hash_table_lookup (priv->device_cache, object_path);
+	if (device != NULL)
+		return g_object_ref (device);
+	device = cd_device_new_with_object_path (object_path);
+	g_hash_table_insert (priv->device_cache,
+			     g_strdup (object_path),
+			     device);
+	g_object_weak_ref (G_OBJECT (device),
+			   cd_client_cache_object_gone_cb,
+			   client);
+	return device;
+}
+
+static CdProfile *
+cd_client_get_cache_profile (CdClient *client,
+			     const gchar *object_path)
+{
+	CdClientPrivate *priv = GET_PRIVATE (client);
+	CdProfile *profile;
+
+	/* hand back an existing proxy for the same object path so that
+	 * repeated lookups do not re-fetch an unchanged property set */
+	profile = g_hash_table_lookup (priv->profile_cache, object_path);
+	if (profile != NULL)
+		return g_object_ref (profile);
+	profile = cd_profile_new_with_object_path (object_path);
+	g_hash_table_insert (priv->profile_cache,
+			     g_strdup (object_path),
+			     profile);
+	g_object_weak_ref (G_OBJECT (profile),
+			   cd_client_cache_object_gone_cb,
+			   client);
+	return profile;
+}
+
+/**********************************************************************/
+
+static void
+cd_client_handle_dbus_signal (CdClient *client,
+			      const gchar *signal_name,
+			      GVariant *parameters)
 {
 	g_autofree gchar *object_path_tmp = NULL;
 	g_autoptr(CdDevice) device = NULL;
@@ -260,32 +422,32 @@ cd_client_dbus_signal_cb (GDBusProxy *proxy,
 		g_warning ("changed");
 	} else if (g_strcmp0 (signal_name, "DeviceAdded") == 0) {
 		g_variant_get (parameters, "(o)", &object_path_tmp);
-		device = cd_device_new_with_object_path (object_path_tmp);
+		device = cd_client_get_cache_device (client, object_path_tmp);
 		g_signal_emit (client, signals[SIGNAL_DEVICE_ADDED], 0,
 			       device);
 	} else if (g_strcmp0 (signal_name, "DeviceRemoved") == 0) {
 		g_variant_get (parameters, "(o)", &object_path_tmp);
-		device = cd_device_new_with_object_path (object_path_tmp);
+		device = cd_client_get_cache_device (client, object_path_tmp);
 		g_signal_emit (client, signals[SIGNAL_DEVICE_REMOVED], 0,
 			       device);
 	} else if (g_strcmp0 (signal_name, "DeviceChanged") == 0) {
 		g_variant_get (parameters, "(o)", &object_path_tmp);
-		device = cd_device_new_with_object_path (object_path_tmp);
+		device = cd_client_get_cache_device (client, object_path_tmp);
 		g_signal_emit (client, signals[SIGNAL_DEVICE_CHANGED], 0,
 			       device);
 	} else if (g_strcmp0 (signal_name, "ProfileAdded") == 0) {
 		g_variant_get (parameters, "(o)", &object_path_tmp);
-		profile = cd_profile_new_with_object_path (object_path_tmp);
+		profile = cd_client_get_cache_profile (client, object_path_tmp);
 		g_signal_emit (client, signals[SIGNAL_PROFILE_ADDED], 0,
 			       profile);
 	} else if (g_strcmp0 (signal_name, "ProfileRemoved") == 0) {
 		g_variant_get (parameters, "(o)", &object_path_tmp);
-		profile = cd_profile_new_with_object_path (object_path_tmp);
+		profile = cd_client_get_cache_profile (client, object_path_tmp);
 		g_signal_emit (client, signals[SIGNAL_PROFILE_REMOVED], 0,
 			       profile);
 	} else if (g_strcmp0 (signal_name, "ProfileChanged") == 0) {
 		g_variant_get (parameters, "(o)", &object_path_tmp);
-		profile = cd_profile_new_with_object_path (object_path_tmp);
+		profile = cd_client_get_cache_profile (client, object_path_tmp);
 		g_signal_emit (client, signals[SIGNAL_PROFILE_CHANGED], 0,
 			       profile);
 	} else if (g_strcmp0 (signal_name, "SensorAdded") == 0) {
@@ -308,12 +470,80 @@ cd_client_dbus_signal_cb (GDBusProxy *proxy,
 	}
 }
 
+static void
+cd_client_dbus_signal_cb (GDBusProxy *proxy,
+			  gchar      *sender_name,
+			  gchar      *signal_name,
+			  GVariant   *parameters,
+			  CdClient   *client)
+{
+	cd_client_handle_dbus_signal (client, signal_name, parameters);
+}
+
+static void
+cd_client_dbus_signal_subscription_cb (GDBusConnection *connection,
+				       const gchar *sender_name,
+				       const gchar *object_path,
+				       const gchar *interface_name,
+				       const gchar *signal_name,
+				       GVariant *parameters,
+				       gpointer user_data)
+{
+	CdClient *client = CD_CLIENT (user_data);
+	cd_client_handle_dbus_signal (client, signal_name, parameters);
+}
+
+static void
+cd_client_subscribe_watched_signals (CdClient *client)
+{
+	CdClientPrivate *priv = GET_PRIVATE (client);
+	GDBusConnection *connection;
+	guint i;
+	guint id;
+	struct {
+		const gchar		*member;
+		CdClientWatchFlags	 flag;
+	} members[] = {
+		{ "DeviceAdded",	CD_CLIENT_WATCH_FLAGS_DEVICES },
+		{ "DeviceRemoved",	CD_CLIENT_WATCH_FLAGS_DEVICES },
+		{ "DeviceChanged",	CD_CLIENT_WATCH_FLAGS_DEVICES },
+		{ "ProfileAdded",	CD_CLIENT_WATCH_FLAGS_PROFILES },
+		{ "ProfileRemoved",	CD_CLIENT_WATCH_FLAGS_PROFILES },
+		{ "ProfileChanged",	CD_CLIENT_WATCH_FLAGS_PROFILES },
+		{ "SensorAdded",	CD_CLIENT_WATCH_FLAGS_SENSORS },
+		{ "SensorRemoved",	CD_CLIENT_WATCH_FLAGS_SENSORS },
+		{ "SensorChanged",	CD_CLIENT_WATCH_FLAGS_SENSORS },
+		{ NULL,			CD_CLIENT_WATCH_FLAGS_NONE }
+	};
+
+	/* each subscription installs a match rule that names the exact
+	 * member, so the bus daemon never delivers the other signals */
+	connection = g_dbus_proxy_get_connection (priv->proxy);
+	priv->subscription_ids = g_array_new (FALSE, FALSE, sizeof (guint));
+	for (i = 0; members[i].member != NULL; i++) {
+		if ((priv->watch_flags & members[i].flag) == 0)
+			continue;
+		id = g_dbus_connection_signal_subscribe (connection,
+							 COLORD_DBUS_SERVICE,
+							 COLORD_DBUS_INTERFACE,
+							 members[i].member,
+							 COLORD_DBUS_PATH,
+							 NULL,
+							 G_DBUS_SIGNAL_FLAGS_NONE,
+							 cd_client_dbus_signal_subscription_cb,
+							 client,
+							 NULL);
+		g_array_append_val (priv->subscription_ids, id);
+	}
+}
+
 static void
 cd_client_owner_notify_cb (GObject *object,
 			   GParamSpec *pspec,
 			   CdClient *client)
 {
 	/* daemon has quit, clearing caches */
+	cd_client_cache_clear (client);
 }
 
 /**********************************************************************/
@@ -387,11 +617,16 @@ cd_client_connect_cb (GObject *source_object,
 		priv->system_model = g_variant_dup_string (system_model, NULL);
 	}
 
-	/* get signals from DBus */
-	g_signal_connect_object (priv->proxy,
-				 "g-signal",
-				 G_CALLBACK (cd_client_dbus_signal_cb),
-				 client, 0);
+	/* get signals from DBus; a restricted watch uses precise
+	 * per-member match rules instead of the catch-all proxy rule */
+	if (priv->watch_flags == CD_CLIENT_WATCH_FLAGS_ALL) {
+		g_signal_connect_object (priv->proxy,
+					 "g-signal",
+					 G_CALLBACK (cd_client_dbus_signal_cb),
+					 client, 0);
+	} else {
+		cd_client_subscribe_watched_signals (client);
+	}
 
 	/* watch to see if it's fallen off the bus */
 	g_signal_connect_object (priv->proxy,
@@ -426,18 +661,22 @@ cd_client_connect (CdClient *client,
 	g_return_if_fail (CD_IS_CLIENT (client));
 	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
 
+	cd_client_context_push (client);
 	task = g_task_new (G_OBJECT (client), cancellable, callback, user_data);
 
 	/* already connected */
 	if (priv->proxy != NULL) {
 		g_task_return_boolean (task, TRUE);
 		g_object_unref (task);
+		cd_client_context_pop (client);
 		return;
 	}
 
 	/* connect async */
 	g_dbus_proxy_new_for_bus (G_BUS_TYPE_SYSTEM,
-				  G_DBUS_PROXY_FLAGS_NONE,
+				  priv->watch_flags == CD_CLIENT_WATCH_FLAGS_ALL ?
+					G_DBUS_PROXY_FLAGS_NONE :
+					G_DBUS_PROXY_FLAGS_DO_NOT_CONNECT_SIGNALS,
 				  NULL,
 				  COLORD_DBUS_SERVICE,
 				  COLORD_DBUS_PATH,
@@ -445,6 +684,7 @@ cd_client_connect (CdClient *client,
 				  cancellable,
 				  cd_client_connect_cb,
 				  task);
+	cd_client_context_pop (client);
 }
 
 /**********************************************************************/
@@ -511,8 +751,8 @@ cd_client_create_device_cb (GObject *source_object,
 
 	/* create CdDevice object */
 	g_variant_get (result, "(o)", &object_path);
-	device = cd_device_new ();
-	cd_device_set_object_path (device, object_path);
+	device = cd_client_get_cache_device (CD_CLIENT (g_task_get_source_object (task)),
+					     object_path);
 
 	/* success */
 	g_task_return_pointer (task, device, (GDestroyNotify) g_object_unref);
@@ -552,6 +792,7 @@ cd_client_create_device (CdClient *client,
 	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
 	g_return_if_fail (priv->proxy != NULL);
 
+	cd_client_context_push (client);
 	task = g_task_new (G_OBJECT (client), cancellable, callback, user_data);
 
 	/* add properties */
@@ -585,6 +826,7 @@ cd_client_create_device (CdClient *client,
 			   cancellable,
 			   cd_client_create_device_cb,
 			   task);
+	cd_client_context_pop (client);
 }
 
 /**********************************************************************/
@@ -643,8 +885,8 @@ cd_client_create_profile_cb (GObject *source_object,
 	/* create thick CdDevice object */
 	g_variant_get (g_dbus_message_get_body (reply), "(o)",
 		       &object_path);
-	profile = cd_profile_new ();
-	cd_profile_set_object_path (profile, object_path);
+	profile = cd_client_get_cache_profile (CD_CLIENT (g_task_get_source_object (task)),
+					       object_path);
 
 	/* success */
 	g_task_return_pointer (task, profile, (GDestroyNotify) g_object_unref);
@@ -689,6 +931,7 @@ cd_client_create_profile (CdClient *client,
 	g_return_if_fail (priv->proxy != NULL);
 	g_return_if_fail (id != NULL);
 
+	cd_client_context_push (client);
 	task = g_task_new (G_OBJECT (client), cancellable, callback, user_data);
 
 	/* add properties */
@@ -733,6 +976,7 @@ cd_client_create_profile (CdClient *client,
 							 CD_CLIENT_ERROR_INTERNAL,
 							 "Failed to open %s",
 							 filename);
+				cd_client_context_pop (client);
 				return;
 			}
 
@@ -766,6 +1010,7 @@ cd_client_create_profile (CdClient *client,
 						   cancellable,
 						   cd_client_create_profile_cb,
 						   task);
+	cd_client_context_pop (client);
 }
 
 /**********************************************************************/
@@ -857,6 +1102,50 @@ cd_client_import_get_profile_destination (GFile *file)
 	return g_file_new_for_path (destination);
 }
 
+#ifdef __linux__
+static gboolean
+cd_client_import_try_copy_file_range (GFile *source, GFile *destination)
+{
+	gboolean ret = FALSE;
+	gint fd_src = -1;
+	gint fd_dest = -1;
+	goffset remaining;
+	gssize rc;
+	struct stat st;
+
+	/* only works on local files */
+	if (!g_file_is_native (source) || !g_file_is_native (destination))
+		return FALSE;
+
+	/* the kernel copies (or just reflinks, on btrfs and XFS) the
+	 * data without it ever crossing into userspace */
+	fd_src = open (g_file_peek_path (source), O_RDONLY | O_CLOEXEC);
+	if (fd_src < 0)
+		return FALSE;
+	if (fstat (fd_src, &st) < 0 || !S_ISREG (st.st_mode))
+		goto out;
+	fd_dest = open (g_file_peek_path (destination),
+			O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+	if (fd_dest < 0)
+		goto out;
+	remaining = st.st_size;
+	while (remaining > 0) {
+		rc = copy_file_range (fd_src, NULL, fd_dest, NULL,
+				      (gsize) remaining, 0);
+		if (rc <= 0)
+			goto out;
+		remaining -= rc;
+	}
+	ret = TRUE;
+out:
+	if (fd_src >= 0)
+		close (fd_src);
+	if (fd_dest >= 0)
+		close (fd_dest);
+	return ret;
+}
+#endif
+
 static gboolean
 cd_client_import_mkdir_and_copy (GFile *source,
 				 GFile *destination,
@@ -877,6 +1166,13 @@ cd_client_import_mkdir_and_copy (GFile *source,
 			return FALSE;
 	}
 
+#ifdef __linux__
+	/* try a kernel-side copy first; any failure falls through to
+	 * the portable GIO copy which reports proper errors */
+	if (cd_client_import_try_copy_file_range (source, destination))
+		return TRUE;
+#endif
+
 	/* do the copy */
 	return g_file_copy (source, destination,
 			    G_FILE_COPY_OVERWRITE,
@@ -1086,6 +1382,7 @@ cd_client_import_profile (CdClient *client,
 	g_return_if_fail (G_IS_FILE (file));
 	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
 
+	cd_client_context_push (client);
 	task = g_task_new (G_OBJECT (client), cancellable, callback, user_data);
 	tdata = g_new0 (CdClientImportTaskData, 1);
 	tdata->file = g_object_ref (file);
@@ -1100,6 +1397,7 @@ cd_client_import_profile (CdClient *client,
 				 cancellable,
 				 cd_client_import_profile_query_info_cb,
 				 task);
+	cd_client_context_pop (client);
 }
 
 /**********************************************************************/
@@ -1175,6 +1473,7 @@ cd_client_delete_device (CdClient *client,
 	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
 	g_return_if_fail (priv->proxy != NULL);
 
+	cd_client_context_push (client);
 	task = g_task_new (G_OBJECT (client), cancellable, callback, user_data);
 	g_dbus_proxy_call (priv->proxy,
 			   "DeleteDevice",
@@ -1185,6 +1484,7 @@ cd_client_delete_device (CdClient *client,
 			   cancellable,
 			   cd_client_delete_device_cb,
 			   task);
+	cd_client_context_pop (client);
 }
 
 /**********************************************************************/
@@ -1260,6 +1560,7 @@ cd_client_delete_profile (CdClient *client,
 	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
 	g_return_if_fail (priv->proxy != NULL);
 
+	cd_client_context_push (client);
 	task = g_task_new (G_OBJECT (client), cancellable, callback, user_data);
 	g_dbus_proxy_call (priv->proxy,
 			   "DeleteProfile",
@@ -1270,6 +1571,7 @@ cd_client_delete_profile (CdClient *client,
 			   cancellable,
 			   cd_client_delete_profile_cb,
 			   task);
+	cd_client_context_pop (client);
 }
 
 /**********************************************************************/
@@ -1318,8 +1620,8 @@ cd_client_find_device_cb (GObject *source_object,
 
 	/* create a device object */
 	g_variant_get (result, "(o)", &object_path);
-	device = cd_device_new ();
-	cd_device_set_object_path (device, object_path);
+	device = cd_client_get_cache_device (CD_CLIENT (g_task_get_source_object (task)),
+					     object_path);
 
 	/* success */
 	g_task_return_pointer (task, device, (GDestroyNotify) g_object_unref);
@@ -1352,6 +1654,7 @@ cd_client_find_device (CdClient *client,
 	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
 	g_return_if_fail (priv->proxy != NULL);
 
+	cd_client_context_push (client);
 	task = g_task_new (G_OBJECT (client), cancellable, callback, user_data);
 	g_dbus_proxy_call (priv->proxy,
 			   "FindDeviceById",
@@ -1361,6 +1664,7 @@ cd_client_find_device (CdClient *client,
 			   cancellable,
 			   cd_client_find_device_cb,
 			   task);
+	cd_client_context_pop (client);
 }
 
 /**********************************************************************/
@@ -1409,8 +1713,8 @@ cd_client_find_device_by_property_cb (GObject *source_object,
 
 	/* create a device object */
 	g_variant_get (result, "(o)", &object_path);
-	device = cd_device_new ();
-	cd_device_set_object_path (device, object_path);
+	device = cd_client_get_cache_device (CD_CLIENT (g_task_get_source_object (task)),
+					     object_path);
 
 	/* success */
 	g_task_return_pointer (task, device, (GDestroyNotify) g_object_unref);
@@ -1445,6 +1749,7 @@ cd_client_find_device_by_property (CdClient *client,
 	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
 	g_return_if_fail (priv->proxy != NULL);
 
+	cd_client_context_push (client);
 	task = g_task_new (G_OBJECT (client), cancellable, callback, user_data);
 	g_dbus_proxy_call (priv->proxy,
 			   "FindDeviceByProperty",
@@ -1454,6 +1759,7 @@ cd_client_find_device_by_property (CdClient *client,
 			   cancellable,
 			   cd_client_find_device_by_property_cb,
 			   task);
+	cd_client_context_pop (client);
 }
 
 /**********************************************************************/
@@ -1502,8 +1808,8 @@ cd_client_find_profile_cb (GObject *source_object,
 
 	/* create a profile object */
 	g_variant_get (result, "(o)", &object_path);
-	profile = cd_profile_new ();
-	cd_profile_set_object_path (profile, object_path);
+	profile = cd_client_get_cache_profile (CD_CLIENT (g_task_get_source_object (task)),
+					       object_path);
 
 	/* success */
 	g_task_return_pointer (task, profile, (GDestroyNotify) g_object_unref);
@@ -1536,6 +1842,7 @@ cd_client_find_profile (CdClient *client,
 	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
 	g_return_if_fail (priv->proxy != NULL);
 
+	cd_client_context_push (client);
 	task = g_task_new (G_OBJECT (client), cancellable, callback, user_data);
 	g_dbus_proxy_call (priv->proxy,
 			   "FindProfileById",
@@ -1545,6 +1852,7 @@ cd_client_find_profile (CdClient *client,
 			   cancellable,
 			   cd_client_find_profile_cb,
 			   task);
+	cd_client_context_pop (client);
 }
 
 /**********************************************************************/
@@ -1593,8 +1901,8 @@ cd_client_find_profile_by_filename_cb (GObject *source_object,
 
 	/* create a profile object */
 	g_variant_get (result, "(o)", &object_path);
-	profile = cd_profile_new ();
-	cd_profile_set_object_path (profile, object_path);
+	profile = cd_client_get_cache_profile (CD_CLIENT (g_task_get_source_object (task)),
+					       object_path);
 
 	/* success */
 	g_task_return_pointer (task, profile, (GDestroyNotify) g_object_unref);
@@ -1627,6 +1935,7 @@ cd_client_find_profile_by_filename (CdClient *client,
 	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
 	g_return_if_fail (priv->proxy != NULL);
 
+	cd_client_context_push (client);
 	task = g_task_new (G_OBJECT (client), cancellable, callback, user_data);
 	g_dbus_proxy_call (priv->proxy,
 			   "FindProfileByFilename",
@@ -1636,6 +1945,7 @@ cd_client_find_profile_by_filename (CdClient *client,
 			   cancellable,
 			   cd_client_find_profile_by_filename_cb,
 			   task);
+	cd_client_context_pop (client);
 }
 
 /**********************************************************************/
@@ -1684,8 +1994,8 @@ cd_client_get_standard_space_cb (GObject *source_object,
 
 	/* create a profile object */
 	g_variant_get (result, "(o)", &object_path);
-	profile = cd_profile_new ();
-	cd_profile_set_object_path (profile, object_path);
+	profile = cd_client_get_cache_profile (CD_CLIENT (g_task_get_source_object (task)),
+					       object_path);
 
 	/* success */
 	g_task_return_pointer (task, profile, (GDestroyNotify) g_object_unref);
@@ -1717,6 +2027,7 @@ cd_client_get_standard_space (CdClient *client,
 	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
 	g_return_if_fail (priv->proxy != NULL);
 
+	cd_client_context_push (client);
 	task = g_task_new (G_OBJECT (client), cancellable, callback, user_data);
 	g_dbus_proxy_call (priv->proxy,
 			   "GetStandardSpace",
@@ -1727,6 +2038,7 @@ cd_client_get_standard_space (CdClient *client,
 			   cancellable,
 			   cd_client_get_standard_space_cb,
 			   task);
+	cd_client_context_pop (client);
 }
 
 /**********************************************************************/
@@ -1750,7 +2062,7 @@ cd_client_get_device_array_from_variant (CdClient *client,
 		g_autofree gchar *object_path_tmp = NULL;
 		g_variant_get_child (child, i,
 				     "o", &object_path_tmp);
-		device = cd_device_new_with_object_path (object_path_tmp);
+		device = cd_client_get_cache_device (client, object_path_tmp);
 		g_ptr_array_add (array, device);
 	}
 	return array;
@@ -1831,6 +2143,7 @@ cd_client_get_devices (CdClient *client,
 	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
 	g_return_if_fail (priv->proxy != NULL);
 
+	cd_client_context_push (client);
 	task = g_task_new (G_OBJECT (client), cancellable, callback, user_data);
 	g_dbus_proxy_call (priv->proxy,
 			   "GetDevices",
@@ -1840,6 +2153,171 @@ cd_client_get_devices (CdClient *client,
 			   cancellable,
 			   cd_client_get_devices_cb,
 			   task);
+	cd_client_context_pop (client);
+}
+
+/**********************************************************************/
+
+typedef struct {
+	GPtrArray	*array;
+	GError		*error;
+	guint		 pending;
+} CdClientGetDevicesFullHelper;
+
+static void
+cd_client_get_devices_full_helper_free (CdClientGetDevicesFullHelper *helper)
+{
+	if (helper->error != NULL)
+		g_error_free (helper->error);
+	g_ptr_array_unref (helper->array);
+	g_free (helper);
+}
+
+/**
+ * cd_client_get_devices_full_finish:
+ * @client: a #CdClient instance.
+ * @res: the #GAsyncResult
+ * @error: A #GError or %NULL
+ *
+ * Gets the result from the asynchronous function.
+ *
+ * Return value: (element-type CdDevice) (transfer full): the connected devices
+ *
+ * Since: 1.4.6
+ **/
+GPtrArray *
+cd_client_get_devices_full_finish (CdClient *client,
+				   GAsyncResult *res,
+				   GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (res, client), NULL);
+	return g_task_propagate_pointer (G_TASK (res), error);
+}
+
+static void
+cd_client_get_devices_full_connect_cb (GObject *source_object,
+				       GAsyncResult *res,
+				       gpointer user_data)
+{
+	CdClientGetDevicesFullHelper *helper;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GTask) task = G_TASK (user_data);
+
+	helper = g_task_get_task_data (task);
+	if (!cd_device_connect_with_properties_finish (CD_DEVICE (source_object),
+						       res, &error)) {
+		if (helper->error == NULL)
+			helper->error = g_steal_pointer (&error);
+	}
+
+	/* still waiting for other devices */
+	if (--helper->pending > 0)
+		return;
+
+	/* return the first error, or every device already connected */
+	if (helper->error != NULL) {
+		g_task_return_error (task, g_steal_pointer (&helper->error));
+		return;
+	}
+	g_task_return_pointer (task,
+			       g_ptr_array_ref (helper->array),
+			       (GDestroyNotify) g_ptr_array_unref);
+}
+
+static void
+cd_client_get_devices_full_cb (GObject *source_object,
+			       GAsyncResult *res,
+			       gpointer user_data)
+{
+	CdClient *client;
+	CdClientGetDevicesFullHelper *helper;
+	CdDevice *device;
+	GVariantIter iter;
+	GVariant *properties;
+	const gchar *object_path_tmp;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GTask) task = G_TASK (user_data);
+	g_autoptr(GVariant) child = NULL;
+	g_autoptr(GVariant) result = NULL;
+
+	client = CD_CLIENT (g_task_get_source_object (task));
+	result = g_dbus_proxy_call_finish (G_DBUS_PROXY (source_object),
+					   res,
+					   &error);
+	if (result == NULL) {
+		cd_client_fixup_dbus_error (error);
+		g_task_return_error (task, error);
+		error = NULL;
+		return;
+	}
+
+	/* create a device object for each path, hydrating each one from
+	 * the property set we were given rather than calling GetAll() */
+	helper = g_new0 (CdClientGetDevicesFullHelper, 1);
+	helper->array = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
+	child = g_variant_get_child_value (result, 0);
+	helper->pending = g_variant_n_children (child);
+	g_task_set_task_data (task, helper,
+			      (GDestroyNotify) cd_client_get_devices_full_helper_free);
+
+	/* no devices */
+	if (helper->pending == 0) {
+		g_task_return_pointer (task,
+				       g_ptr_array_ref (helper->array),
+				       (GDestroyNotify) g_ptr_array_unref);
+		return;
+	}
+
+	g_variant_iter_init (&iter, child);
+	while (g_variant_iter_loop (&iter, "{&o@a{sv}}",
+				    &object_path_tmp, &properties)) {
+		device = cd_client_get_cache_device (client, object_path_tmp);
+		g_ptr_array_add (helper->array, device);
+		cd_device_connect_with_properties (device,
+						   properties,
+						   g_task_get_cancellable (task),
+						   cd_client_get_devices_full_connect_cb,
+						   g_object_ref (task));
+	}
+}
+
+/**
+ * cd_client_get_devices_full:
+ * @client: a #CdClient instance.
+ * @cancellable: a #GCancellable, or %NULL
+ * @callback: the function to run on completion
+ * @user_data: the data to pass to @callback
+ *
+ * Gets an array of color devices that are already connected, using a
+ * single bus round trip for all the device properties rather than one
+ * GetAll() call per device.
+ *
+ * Since: 1.4.6
+ **/
+void
+cd_client_get_devices_full (CdClient *client,
+			    GCancellable *cancellable,
+			    GAsyncReadyCallback callback,
+			    gpointer user_data)
+{
+	CdClientPrivate *priv = GET_PRIVATE (client);
+	GTask *task = NULL;
+
+	g_return_if_fail (CD_IS_CLIENT (client));
+	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+	g_return_if_fail (priv->proxy != NULL);
+
+	cd_client_context_push (client);
+	task = g_task_new (G_OBJECT (client), cancellable, callback, user_data);
+	g_dbus_proxy_call (priv->proxy,
+			   "GetDevicesWithProperties",
+			   NULL,
+			   G_DBUS_CALL_FLAGS_NONE,
+			   -1,
+			   cancellable,
+			   cd_client_get_devices_full_cb,
+			   task);
+	cd_client_context_pop (client);
 }
 
 /**********************************************************************/
@@ -1921,6 +2399,7 @@ cd_client_get_devices_by_kind (CdClient *client,
 	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
 	g_return_if_fail (priv->proxy != NULL);
 
+	cd_client_context_push (client);
 	task = g_task_new (G_OBJECT (client), cancellable, callback, user_data);
 	g_dbus_proxy_call (priv->proxy,
 			   "GetDevicesByKind",
@@ -1931,6 +2410,7 @@ cd_client_get_devices_by_kind (CdClient *client,
 			   cancellable,
 			   cd_client_get_devices_by_kind_cb,
 			   task);
+	cd_client_context_pop (client);
 }
 
 /**********************************************************************/
@@ -1954,7 +2434,7 @@ cd_client_get_profile_array_from_variant (CdClient *client,
 		g_autofree gchar *object_path_tmp = NULL;
 		g_variant_get_child (child, i,
 				     "o", &object_path_tmp);
-		profile = cd_profile_new_with_object_path (object_path_tmp);
+		profile = cd_client_get_cache_profile (client, object_path_tmp);
 		g_ptr_array_add (array, profile);
 	}
 	return array;
@@ -2035,6 +2515,7 @@ cd_client_get_profiles (CdClient *client,
 	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
 	g_return_if_fail (priv->proxy != NULL);
 
+	cd_client_context_push (client);
 	task = g_task_new (G_OBJECT (client), cancellable, callback, user_data);
 	g_dbus_proxy_call (priv->proxy,
 			   "GetProfiles",
@@ -2044,6 +2525,7 @@ cd_client_get_profiles (CdClient *client,
 			   cancellable,
 			   cd_client_get_profiles_cb,
 			   task);
+	cd_client_context_pop (client);
 }
 
 /**********************************************************************/
@@ -2148,6 +2630,7 @@ cd_client_get_sensors (CdClient *client,
 	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
 	g_return_if_fail (priv->proxy != NULL);
 
+	cd_client_context_push (client);
 	task = g_task_new (G_OBJECT (client), cancellable, callback, user_data);
 	g_dbus_proxy_call (priv->proxy,
 			   "GetSensors",
@@ -2157,6 +2640,7 @@ cd_client_get_sensors (CdClient *client,
 			   cancellable,
 			   cd_client_get_sensors_cb,
 			   task);
+	cd_client_context_pop (client);
 }
 
 /**********************************************************************/
@@ -2205,8 +2689,8 @@ cd_client_find_profile_by_property_cb (GObject *source_object,
 
 	/* create a profile object */
 	g_variant_get (result, "(o)", &object_path);
-	profile = cd_profile_new ();
-	cd_profile_set_object_path (profile, object_path);
+	profile = cd_client_get_cache_profile (CD_CLIENT (g_task_get_source_object (task)),
+					       object_path);
 
 	/* success */
 	g_task_return_pointer (task, profile, (GDestroyNotify) g_object_unref);
@@ -2241,6 +2725,7 @@ cd_client_find_profile_by_property (CdClient *client,
 	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
 	g_return_if_fail (priv->proxy != NULL);
 
+	cd_client_context_push (client);
 	task = g_task_new (G_OBJECT (client), cancellable, callback, user_data);
 	g_dbus_proxy_call (priv->proxy,
 			   "FindProfileByProperty",
@@ -2250,6 +2735,7 @@ cd_client_find_profile_by_property (CdClient *client,
 			   cancellable,
 			   cd_client_find_profile_by_property_cb,
 			   task);
+	cd_client_context_pop (client);
 }
 
 /**********************************************************************/
@@ -2332,6 +2818,7 @@ cd_client_find_sensor (CdClient *client,
 	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
 	g_return_if_fail (priv->proxy != NULL);
 
+	cd_client_context_push (client);
 	task = g_task_new (G_OBJECT (client), cancellable, callback, user_data);
 	g_dbus_proxy_call (priv->proxy,
 			   "FindSensorById",
@@ -2341,6 +2828,55 @@ cd_client_find_sensor (CdClient *client,
 			   cancellable,
 			   cd_client_find_sensor_cb,
 			   task);
+	cd_client_context_pop (client);
+}
+
+/**********************************************************************/
+
+/* accessors shared with the synchronous fast paths in cd-client-sync.c;
+ * the leading underscore keeps them out of the cd_* export glob */
+
+GDBusProxy *
+_cd_client_get_proxy (CdClient *client)
+{
+	CdClientPrivate *priv = GET_PRIVATE (client);
+	return priv->proxy;
+}
+
+void
+_cd_client_fixup_dbus_error (GError *error)
+{
+	cd_client_fixup_dbus_error (error);
+}
+
+CdDevice *
+_cd_client_get_cache_device (CdClient *client, const gchar *object_path)
+{
+	return cd_client_get_cache_device (client, object_path);
+}
+
+CdProfile *
+_cd_client_get_cache_profile (CdClient *client, const gchar *object_path)
+{
+	return cd_client_get_cache_profile (client, object_path);
+}
+
+GPtrArray *
+_cd_client_get_device_array_from_variant (CdClient *client, GVariant *variant)
+{
+	return cd_client_get_device_array_from_variant (client, variant);
+}
+
+GPtrArray *
+_cd_client_get_profile_array_from_variant (CdClient *client, GVariant *variant)
+{
+	return cd_client_get_profile_array_from_variant (client, variant);
+}
+
+GPtrArray *
+_cd_client_get_sensor_array_from_variant (CdClient *client, GVariant *variant)
+{
+	return cd_client_get_sensor_array_from_variant (client, variant);
 }
 
 /**********************************************************************/
@@ -2605,8 +3141,20 @@ cd_client_class_init (CdClientClass *klass)
 static void
 cd_client_init (CdClient *client)
 {
+	CdClientPrivate *priv = GET_PRIVATE (client);
+
 	/* ensure the remote errors are registered */
 	cd_client_error_quark ();
+
+	/* watch everything unless told otherwise */
+	priv->watch_flags = CD_CLIENT_WATCH_FLAGS_ALL;
+
+	/* the caches hold no references; entries are removed when the
+	 * proxy objects are finalized */
+	priv->device_cache = g_hash_table_new_full (g_str_hash, g_str_equal,
+						    g_free, NULL);
+	priv->profile_cache = g_hash_table_new_full (g_str_hash, g_str_equal,
+						     g_free, NULL);
 }
 
 /*
@@ -2620,11 +3168,27 @@ cd_client_finalize (GObject *object)
 
 	g_return_if_fail (CD_IS_CLIENT (object));
 
+	cd_client_cache_clear (client);
+	g_hash_table_unref (priv->device_cache);
+	g_hash_table_unref (priv->profile_cache);
 	g_free (priv->daemon_version);
 	g_free (priv->system_vendor);
 	g_free (priv->system_model);
+	if (priv->subscription_ids != NULL) {
+		GDBusConnection *connection;
+		guint i;
+		connection = g_dbus_proxy_get_connection (priv->proxy);
+		for (i = 0; i < priv->subscription_ids->len; i++) {
+			g_dbus_connection_signal_unsubscribe (connection,
+							      g_array_index (priv->subscription_ids,
+									     guint, i));
+		}
+		g_array_unref (priv->subscription_ids);
+	}
 	if (priv->proxy != NULL)
 		g_object_unref (priv->proxy);
+	if (priv->context != NULL)
+		g_main_context_unref (priv->context);
 
 	G_OBJECT_CLASS (cd_client_parent_class)->finalize (object);
 }
@@ -2650,3 +3214,31 @@ cd_client_new (void)
 	return CD_CLIENT (cd_client_object);
 }
 
+/**
+ * cd_client_new_with_context:
+ * @context: (nullable): a #GMainContext, or %NULL for the thread-default
+ *
+ * Creates a new #CdClient object bound to a specific main context.
+ * All async results and daemon signals are dispatched by whatever
+ * thread iterates @context, so the client can be driven from a worker
+ * thread without funnelling every call through the default main loop.
+ *
+ * Unlike cd_client_new() this never returns the shared singleton.
+ *
+ * Return value: a new CdClient object.
+ *
+ * Since: 1.4.6
+ **/
+CdClient *
+cd_client_new_with_context (GMainContext *context)
+{
+	CdClient *client;
+	CdClientPrivate *priv;
+
+	client = CD_CLIENT (g_object_new (CD_TYPE_CLIENT, NULL));
+	priv = GET_PRIVATE (client);
+	if (context != NULL)
+		priv->context = g_main_context_ref (context);
+	return client;
+}
+
@@ -38,6 +38,30 @@ G_BEGIN_DECLS
 #define CD_CLIENT_ERROR		(cd_client_error_quark ())
 #define CD_CLIENT_TYPE_ERROR	(cd_client_error_get_type ())
 
+/**
+ * CdClientWatchFlags:
+ * @CD_CLIENT_WATCH_FLAGS_NONE:		Watch no object kinds
+ * @CD_CLIENT_WATCH_FLAGS_DEVICES:	Watch device added/removed/changed
+ * @CD_CLIENT_WATCH_FLAGS_PROFILES:	Watch profile added/removed/changed
+ * @CD_CLIENT_WATCH_FLAGS_SENSORS:	Watch sensor added/removed/changed
+ * @CD_CLIENT_WATCH_FLAGS_ALL:		Watch all object kinds
+ *
+ * The kinds of objects to watch for signals from the daemon.
+ * Restricting the watch installs precise D-Bus match rules so that
+ * signals for the other kinds never wake the client process.
+ *
+ * Since: 1.4.6
+ **/
+typedef enum {
+	CD_CLIENT_WATCH_FLAGS_NONE	= 0,		/* Since: 1.4.6 */
+	CD_CLIENT_WATCH_FLAGS_DEVICES	= (1 << 0),	/* Since: 1.4.6 */
+	CD_CLIENT_WATCH_FLAGS_PROFILES	= (1 << 1),	/* Since: 1.4.6 */
+	CD_CLIENT_WATCH_FLAGS_SENSORS	= (1 << 2),	/* Since: 1.4.6 */
+	CD_CLIENT_WATCH_FLAGS_ALL	= 0xff,		/* Since: 1.4.6 */
+	/*< private >*/
+	CD_CLIENT_WATCH_FLAGS_LAST
+} CdClientWatchFlags;
+
 #define CD_TYPE_CLIENT (cd_client_get_type ())
 G_DECLARE_DERIVABLE_TYPE (CdClient, cd_client, CD, CLIENT, GObject)
 
@@ -77,6 +101,7 @@ struct _CdClientClass
 
 GQuark		 cd_client_error_quark			(void);
 CdClient	*cd_client_new				(void);
+CdClient	*cd_client_new_with_context		(GMainContext	*context);
 
 /* async */
 void		 cd_client_connect			(CdClient	*client,
@@ -201,6 +226,14 @@ GPtrArray	*cd_client_get_devices_finish		(CdClient	*client,
 							 GAsyncResult	*res,
 							 GError		**error)
 							 G_GNUC_WARN_UNUSED_RESULT;
+void		 cd_client_get_devices_full		(CdClient	*client,
+							 GCancellable	*cancellable,
+							 GAsyncReadyCallback callback,
+							 gpointer	 user_data);
+GPtrArray	*cd_client_get_devices_full_finish	(CdClient	*client,
+							 GAsyncResult	*res,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
 void		 cd_client_get_devices_by_kind		(CdClient	*client,
 							 CdDeviceKind	 kind,
 							 GCancellable	*cancellable,
@@ -252,6 +285,9 @@ gboolean	 cd_client_get_has_server		(CdClient	*client);
 const gchar	*cd_client_get_daemon_version		(CdClient	*client);
 const gchar	*cd_client_get_system_vendor		(CdClient	*client);
 const gchar	*cd_client_get_system_model		(CdClient	*client);
+void		 cd_client_set_watch_flags		(CdClient	*client,
+							 CdClientWatchFlags flags);
+CdClientWatchFlags cd_client_get_watch_flags		(CdClient	*client);
 
 G_END_DECLS
 
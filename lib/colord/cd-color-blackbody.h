@@ -0,0 +1,1813 @@
+/* Generated by cd-color-blackbody-generate.py, do not edit */
+
+#define CD_COLOR_BLACKBODY_TEMP_MIN	1000
+#define CD_COLOR_BLACKBODY_TEMP_MAX	10000
+#define CD_COLOR_BLACKBODY_TEMP_STEP	10
+
+static const CdColorRGB blackbody_data_d65plankian[] = {
+	{ 1.000000, 0.181700, 0.000000 }, /* 1000K */
+	{ 1.000000, 0.189030, 0.000000 },
+	{ 1.000000, 0.196360, 0.000000 },
+	{ 1.000000, 0.203690, 0.000000 },
+	{ 1.000000, 0.211020, 0.000000 },
+	{ 1.000000, 0.218350, 0.000000 },
+	{ 1.000000, 0.225680, 0.000000 },
+	{ 1.000000, 0.233010, 0.000000 },
+	{ 1.000000, 0.240340, 0.000000 },
+	{ 1.000000, 0.247670, 0.000000 },
+	{ 1.000000, 0.255000, 0.000000 },
+	{ 1.000000, 0.260440, 0.000000 },
+	{ 1.000000, 0.265880, 0.000000 },
+	{ 1.000000, 0.271320, 0.000000 },
+	{ 1.000000, 0.276760, 0.000000 },
+	{ 1.000000, 0.282200, 0.000000 },
+	{ 1.000000, 0.287640, 0.000000 },
+	{ 1.000000, 0.293080, 0.000000 },
+	{ 1.000000, 0.298520, 0.000000 },
+	{ 1.000000, 0.303960, 0.000000 },
+	{ 1.000000, 0.309400, 0.000000 },
+	{ 1.000000, 0.313820, 0.000000 },
+	{ 1.000000, 0.318240, 0.000000 },
+	{ 1.000000, 0.322660, 0.000000 },
+	{ 1.000000, 0.327080, 0.000000 },
+	{ 1.000000, 0.331500, 0.000000 },
+	{ 1.000000, 0.335920, 0.000000 },
+	{ 1.000000, 0.340340, 0.000000 },
+	{ 1.000000, 0.344760, 0.000000 },
+	{ 1.000000, 0.349180, 0.000000 },
+	{ 1.000000, 0.353600, 0.000000 },
+	{ 1.000000, 0.357330, 0.000000 },
+	{ 1.000000, 0.361060, 0.000000 },
+	{ 1.000000, 0.364790, 0.000000 },
+	{ 1.000000, 0.368520, 0.000000 },
+	{ 1.000000, 0.372250, 0.000000 },
+	{ 1.000000, 0.375980, 0.000000 },
+	{ 1.000000, 0.379710, 0.000000 },
+	{ 1.000000, 0.383440, 0.000000 },
+	{ 1.000000, 0.387170, 0.000000 },
+	{ 1.000000, 0.390900, 0.000000 },
+	{ 1.000000, 0.394130, 0.000000 },
+	{ 1.000000, 0.397360, 0.000000 },
+	{ 1.000000, 0.400590, 0.000000 },
+	{ 1.000000, 0.403820, 0.000000 },
+	{ 1.000000, 0.407050, 0.000000 },
+	{ 1.000000, 0.410280, 0.000000 },
+	{ 1.000000, 0.413510, 0.000000 },
+	{ 1.000000, 0.416740, 0.000000 },
+	{ 1.000000, 0.419970, 0.000000 },
+	{ 1.000000, 0.423200, 0.000000 },
+	{ 1.000000, 0.426040, 0.000000 },
+	{ 1.000000, 0.428880, 0.000000 },
+	{ 1.000000, 0.431720, 0.000000 },
+	{ 1.000000, 0.434560, 0.000000 },
+	{ 1.000000, 0.437400, 0.000000 },
+	{ 1.000000, 0.440240, 0.000000 },
+	{ 1.000000, 0.443080, 0.000000 },
+	{ 1.000000, 0.445920, 0.000000 },
+	{ 1.000000, 0.448760, 0.000000 },
+	{ 1.000000, 0.451600, 0.000000 },
+	{ 1.000000, 0.454120, 0.000000 },
+	{ 1.000000, 0.456640, 0.000000 },
+	{ 1.000000, 0.459160, 0.000000 },
+	{ 1.000000, 0.461680, 0.000000 },
+	{ 1.000000, 0.464200, 0.000000 },
+	{ 1.000000, 0.466720, 0.000000 },
+	{ 1.000000, 0.469240, 0.000000 },
+	{ 1.000000, 0.471760, 0.000000 },
+	{ 1.000000, 0.474280, 0.000000 },
+	{ 1.000000, 0.476800, 0.000000 },
+	{ 1.000000, 0.479040, 0.000000 },
+	{ 1.000000, 0.481280, 0.000000 },
+	{ 1.000000, 0.483520, 0.000000 },
+	{ 1.000000, 0.485760, 0.000000 },
+	{ 1.000000, 0.488000, 0.000000 },
+	{ 1.000000, 0.490240, 0.000000 },
+	{ 1.000000, 0.492480, 0.000000 },
+	{ 1.000000, 0.494720, 0.000000 },
+	{ 1.000000, 0.496960, 0.000000 },
+	{ 1.000000, 0.499200, 0.000000 },
+	{ 1.000000, 0.501220, 0.000000 },
+	{ 1.000000, 0.503240, 0.000000 },
+	{ 1.000000, 0.505260, 0.000000 },
+	{ 1.000000, 0.507280, 0.000000 },
+	{ 1.000000, 0.509300, 0.000000 },
+	{ 1.000000, 0.511320, 0.000000 },
+	{ 1.000000, 0.513340, 0.000000 },
+	{ 1.000000, 0.515360, 0.000000 },
+	{ 1.000000, 0.517380, 0.000000 },
+	{ 1.000000, 0.519400, 0.000000 },
+	{ 1.000000, 0.521820, 0.008680 },
+	{ 1.000000, 0.524240, 0.017360 },
+	{ 1.000000, 0.526660, 0.026040 },
+	{ 1.000000, 0.529080, 0.034720 },
+	{ 1.000000, 0.531500, 0.043400 },
+	{ 1.000000, 0.533920, 0.052080 },
+	{ 1.000000, 0.536340, 0.060760 },
+	{ 1.000000, 0.538760, 0.069440 },
+	{ 1.000000, 0.541180, 0.078120 },
+	{ 1.000000, 0.543600, 0.086800 }, /* 2000K */
+	{ 1.000000, 0.545860, 0.092190 },
+	{ 1.000000, 0.548120, 0.097580 },
+	{ 1.000000, 0.550380, 0.102970 },
+	{ 1.000000, 0.552640, 0.108360 },
+	{ 1.000000, 0.554900, 0.113750 },
+	{ 1.000000, 0.557160, 0.119140 },
+	{ 1.000000, 0.559420, 0.124530 },
+	{ 1.000000, 0.561680, 0.129920 },
+	{ 1.000000, 0.563940, 0.135310 },
+	{ 1.000000, 0.566200, 0.140700 },
+	{ 1.000000, 0.568310, 0.144990 },
+	{ 1.000000, 0.570420, 0.149280 },
+	{ 1.000000, 0.572530, 0.153570 },
+	{ 1.000000, 0.574640, 0.157860 },
+	{ 1.000000, 0.576750, 0.162150 },
+	{ 1.000000, 0.578860, 0.166440 },
+	{ 1.000000, 0.580970, 0.170730 },
+	{ 1.000000, 0.583080, 0.175020 },
+	{ 1.000000, 0.585190, 0.179310 },
+	{ 1.000000, 0.587300, 0.183600 },
+	{ 1.000000, 0.589290, 0.187380 },
+	{ 1.000000, 0.591280, 0.191160 },
+	{ 1.000000, 0.593270, 0.194940 },
+	{ 1.000000, 0.595260, 0.198720 },
+	{ 1.000000, 0.597250, 0.202500 },
+	{ 1.000000, 0.599240, 0.206280 },
+	{ 1.000000, 0.601230, 0.210060 },
+	{ 1.000000, 0.603220, 0.213840 },
+	{ 1.000000, 0.605210, 0.217620 },
+	{ 1.000000, 0.607200, 0.221400 },
+	{ 1.000000, 0.609080, 0.224850 },
+	{ 1.000000, 0.610960, 0.228300 },
+	{ 1.000000, 0.612840, 0.231750 },
+	{ 1.000000, 0.614720, 0.235200 },
+	{ 1.000000, 0.616600, 0.238650 },
+	{ 1.000000, 0.618480, 0.242100 },
+	{ 1.000000, 0.620360, 0.245550 },
+	{ 1.000000, 0.622240, 0.249000 },
+	{ 1.000000, 0.624120, 0.252450 },
+	{ 1.000000, 0.626000, 0.255900 },
+	{ 1.000000, 0.627770, 0.259130 },
+	{ 1.000000, 0.629540, 0.262360 },
+	{ 1.000000, 0.631310, 0.265590 },
+	{ 1.000000, 0.633080, 0.268820 },
+	{ 1.000000, 0.634850, 0.272050 },
+	{ 1.000000, 0.636620, 0.275280 },
+	{ 1.000000, 0.638390, 0.278510 },
+	{ 1.000000, 0.640160, 0.281740 },
+	{ 1.000000, 0.641930, 0.284970 },
+	{ 1.000000, 0.643700, 0.288200 },
+	{ 1.000000, 0.645380, 0.291250 },
+	{ 1.000000, 0.647060, 0.294300 },
+	{ 1.000000, 0.648740, 0.297350 },
+	{ 1.000000, 0.650420, 0.300400 },
+	{ 1.000000, 0.652100, 0.303450 },
+	{ 1.000000, 0.653780, 0.306500 },
+	{ 1.000000, 0.655460, 0.309550 },
+	{ 1.000000, 0.657140, 0.312600 },
+	{ 1.000000, 0.658820, 0.315650 },
+	{ 1.000000, 0.660500, 0.318700 },
+	{ 1.000000, 0.662100, 0.321620 },
+	{ 1.000000, 0.663700, 0.324540 },
+	{ 1.000000, 0.665300, 0.327460 },
+	{ 1.000000, 0.666900, 0.330380 },
+	{ 1.000000, 0.668500, 0.333300 },
+	{ 1.000000, 0.670100, 0.336220 },
+	{ 1.000000, 0.671700, 0.339140 },
+	{ 1.000000, 0.673300, 0.342060 },
+	{ 1.000000, 0.674900, 0.344980 },
+	{ 1.000000, 0.676500, 0.347900 },
+	{ 1.000000, 0.678010, 0.350690 },
+	{ 1.000000, 0.679520, 0.353480 },
+	{ 1.000000, 0.681030, 0.356270 },
+	{ 1.000000, 0.682540, 0.359060 },
+	{ 1.000000, 0.684050, 0.361850 },
+	{ 1.000000, 0.685560, 0.364640 },
+	{ 1.000000, 0.687070, 0.367430 },
+	{ 1.000000, 0.688580, 0.370220 },
+	{ 1.000000, 0.690090, 0.373010 },
+	{ 1.000000, 0.691600, 0.375800 },
+	{ 1.000000, 0.693040, 0.378490 },
+	{ 1.000000, 0.694480, 0.381180 },
+	{ 1.000000, 0.695920, 0.383870 },
+	{ 1.000000, 0.697360, 0.386560 },
+	{ 1.000000, 0.698800, 0.389250 },
+	{ 1.000000, 0.700240, 0.391940 },
+	{ 1.000000, 0.701680, 0.394630 },
+	{ 1.000000, 0.703120, 0.397320 },
+	{ 1.000000, 0.704560, 0.400010 },
+	{ 1.000000, 0.706000, 0.402700 },
+	{ 1.000000, 0.707380, 0.405290 },
+	{ 1.000000, 0.708760, 0.407880 },
+	{ 1.000000, 0.710140, 0.410470 },
+	{ 1.000000, 0.711520, 0.413060 },
+	{ 1.000000, 0.712900, 0.415650 },
+	{ 1.000000, 0.714280, 0.418240 },
+	{ 1.000000, 0.715660, 0.420830 },
+	{ 1.000000, 0.717040, 0.423420 },
+	{ 1.000000, 0.718420, 0.426010 },
+	{ 1.000000, 0.719800, 0.428600 }, /* 3000K */
+	{ 1.000000, 0.721110, 0.431110 },
+	{ 1.000000, 0.722420, 0.433620 },
+	{ 1.000000, 0.723730, 0.436130 },
+	{ 1.000000, 0.725040, 0.438640 },
+	{ 1.000000, 0.726350, 0.441150 },
+	{ 1.000000, 0.727660, 0.443660 },
+	{ 1.000000, 0.728970, 0.446170 },
+	{ 1.000000, 0.730280, 0.448680 },
+	{ 1.000000, 0.731590, 0.451190 },
+	{ 1.000000, 0.732900, 0.453700 },
+	{ 1.000000, 0.734150, 0.456120 },
+	{ 1.000000, 0.735400, 0.458540 },
+	{ 1.000000, 0.736650, 0.460960 },
+	{ 1.000000, 0.737900, 0.463380 },
+	{ 1.000000, 0.739150, 0.465800 },
+	{ 1.000000, 0.740400, 0.468220 },
+	{ 1.000000, 0.741650, 0.470640 },
+	{ 1.000000, 0.742900, 0.473060 },
+	{ 1.000000, 0.744150, 0.475480 },
+	{ 1.000000, 0.745400, 0.477900 },
+	{ 1.000000, 0.746600, 0.480260 },
+	{ 1.000000, 0.747800, 0.482620 },
+	{ 1.000000, 0.749000, 0.484980 },
+	{ 1.000000, 0.750200, 0.487340 },
+	{ 1.000000, 0.751400, 0.489700 },
+	{ 1.000000, 0.752600, 0.492060 },
+	{ 1.000000, 0.753800, 0.494420 },
+	{ 1.000000, 0.755000, 0.496780 },
+	{ 1.000000, 0.756200, 0.499140 },
+	{ 1.000000, 0.757400, 0.501500 },
+	{ 1.000000, 0.758550, 0.503780 },
+	{ 1.000000, 0.759700, 0.506060 },
+	{ 1.000000, 0.760850, 0.508340 },
+	{ 1.000000, 0.762000, 0.510620 },
+	{ 1.000000, 0.763150, 0.512900 },
+	{ 1.000000, 0.764300, 0.515180 },
+	{ 1.000000, 0.765450, 0.517460 },
+	{ 1.000000, 0.766600, 0.519740 },
+	{ 1.000000, 0.767750, 0.522020 },
+	{ 1.000000, 0.768900, 0.524300 },
+	{ 1.000000, 0.770000, 0.526510 },
+	{ 1.000000, 0.771100, 0.528720 },
+	{ 1.000000, 0.772200, 0.530930 },
+	{ 1.000000, 0.773300, 0.533140 },
+	{ 1.000000, 0.774400, 0.535350 },
+	{ 1.000000, 0.775500, 0.537560 },
+	{ 1.000000, 0.776600, 0.539770 },
+	{ 1.000000, 0.777700, 0.541980 },
+	{ 1.000000, 0.778800, 0.544190 },
+	{ 1.000000, 0.779900, 0.546400 },
+	{ 1.000000, 0.780950, 0.548550 },
+	{ 1.000000, 0.782000, 0.550700 },
+	{ 1.000000, 0.783050, 0.552850 },
+	{ 1.000000, 0.784100, 0.555000 },
+	{ 1.000000, 0.785150, 0.557150 },
+	{ 1.000000, 0.786200, 0.559300 },
+	{ 1.000000, 0.787250, 0.561450 },
+	{ 1.000000, 0.788300, 0.563600 },
+	{ 1.000000, 0.789350, 0.565750 },
+	{ 1.000000, 0.790400, 0.567900 },
+	{ 1.000000, 0.791410, 0.569990 },
+	{ 1.000000, 0.792420, 0.572080 },
+	{ 1.000000, 0.793430, 0.574170 },
+	{ 1.000000, 0.794440, 0.576260 },
+	{ 1.000000, 0.795450, 0.578350 },
+	{ 1.000000, 0.796460, 0.580440 },
+	{ 1.000000, 0.797470, 0.582530 },
+	{ 1.000000, 0.798480, 0.584620 },
+	{ 1.000000, 0.799490, 0.586710 },
+	{ 1.000000, 0.800500, 0.588800 },
+	{ 1.000000, 0.801470, 0.590840 },
+	{ 1.000000, 0.802440, 0.592880 },
+	{ 1.000000, 0.803410, 0.594920 },
+	{ 1.000000, 0.804380, 0.596960 },
+	{ 1.000000, 0.805350, 0.599000 },
+	{ 1.000000, 0.806320, 0.601040 },
+	{ 1.000000, 0.807290, 0.603080 },
+	{ 1.000000, 0.808260, 0.605120 },
+	{ 1.000000, 0.809230, 0.607160 },
+	{ 1.000000, 0.810200, 0.609200 },
+	{ 1.000000, 0.811140, 0.611170 },
+	{ 1.000000, 0.812080, 0.613140 },
+	{ 1.000000, 0.813020, 0.615110 },
+	{ 1.000000, 0.813960, 0.617080 },
+	{ 1.000000, 0.814900, 0.619050 },
+	{ 1.000000, 0.815840, 0.621020 },
+	{ 1.000000, 0.816780, 0.622990 },
+	{ 1.000000, 0.817720, 0.624960 },
+	{ 1.000000, 0.818660, 0.626930 },
+	{ 1.000000, 0.819600, 0.628900 },
+	{ 1.000000, 0.820490, 0.630830 },
+	{ 1.000000, 0.821380, 0.632760 },
+	{ 1.000000, 0.822270, 0.634690 },
+	{ 1.000000, 0.823160, 0.636620 },
+	{ 1.000000, 0.824050, 0.638550 },
+	{ 1.000000, 0.824940, 0.640480 },
+	{ 1.000000, 0.825830, 0.642410 },
+	{ 1.000000, 0.826720, 0.644340 },
+	{ 1.000000, 0.827610, 0.646270 },
+	{ 1.000000, 0.828500, 0.648200 }, /* 4000K */
+	{ 1.000000, 0.829370, 0.650070 },
+	{ 1.000000, 0.830240, 0.651940 },
+	{ 1.000000, 0.831110, 0.653810 },
+	{ 1.000000, 0.831980, 0.655680 },
+	{ 1.000000, 0.832850, 0.657550 },
+	{ 1.000000, 0.833720, 0.659420 },
+	{ 1.000000, 0.834590, 0.661290 },
+	{ 1.000000, 0.835460, 0.663160 },
+	{ 1.000000, 0.836330, 0.665030 },
+	{ 1.000000, 0.837200, 0.666900 },
+	{ 1.000000, 0.838030, 0.668720 },
+	{ 1.000000, 0.838860, 0.670540 },
+	{ 1.000000, 0.839690, 0.672360 },
+	{ 1.000000, 0.840520, 0.674180 },
+	{ 1.000000, 0.841350, 0.676000 },
+	{ 1.000000, 0.842180, 0.677820 },
+	{ 1.000000, 0.843010, 0.679640 },
+	{ 1.000000, 0.843840, 0.681460 },
+	{ 1.000000, 0.844670, 0.683280 },
+	{ 1.000000, 0.845500, 0.685100 },
+	{ 1.000000, 0.846300, 0.686870 },
+	{ 1.000000, 0.847100, 0.688640 },
+	{ 1.000000, 0.847900, 0.690410 },
+	{ 1.000000, 0.848700, 0.692180 },
+	{ 1.000000, 0.849500, 0.693950 },
+	{ 1.000000, 0.850300, 0.695720 },
+	{ 1.000000, 0.851100, 0.697490 },
+	{ 1.000000, 0.851900, 0.699260 },
+	{ 1.000000, 0.852700, 0.701030 },
+	{ 1.000000, 0.853500, 0.702800 },
+	{ 1.000000, 0.854270, 0.704530 },
+	{ 1.000000, 0.855040, 0.706260 },
+	{ 1.000000, 0.855810, 0.707990 },
+	{ 1.000000, 0.856580, 0.709720 },
+	{ 1.000000, 0.857350, 0.711450 },
+	{ 1.000000, 0.858120, 0.713180 },
+	{ 1.000000, 0.858890, 0.714910 },
+	{ 1.000000, 0.859660, 0.716640 },
+	{ 1.000000, 0.860430, 0.718370 },
+	{ 1.000000, 0.861200, 0.720100 },
+	{ 1.000000, 0.861940, 0.721780 },
+	{ 1.000000, 0.862680, 0.723460 },
+	{ 1.000000, 0.863420, 0.725140 },
+	{ 1.000000, 0.864160, 0.726820 },
+	{ 1.000000, 0.864900, 0.728500 },
+	{ 1.000000, 0.865640, 0.730180 },
+	{ 1.000000, 0.866380, 0.731860 },
+	{ 1.000000, 0.867120, 0.733540 },
+	{ 1.000000, 0.867860, 0.735220 },
+	{ 1.000000, 0.868600, 0.736900 },
+	{ 1.000000, 0.869320, 0.738540 },
+	{ 1.000000, 0.870040, 0.740180 },
+	{ 1.000000, 0.870760, 0.741820 },
+	{ 1.000000, 0.871480, 0.743460 },
+	{ 1.000000, 0.872200, 0.745100 },
+	{ 1.000000, 0.872920, 0.746740 },
+	{ 1.000000, 0.873640, 0.748380 },
+	{ 1.000000, 0.874360, 0.750020 },
+	{ 1.000000, 0.875080, 0.751660 },
+	{ 1.000000, 0.875800, 0.753300 },
+	{ 1.000000, 0.876490, 0.754890 },
+	{ 1.000000, 0.877180, 0.756480 },
+	{ 1.000000, 0.877870, 0.758070 },
+	{ 1.000000, 0.878560, 0.759660 },
+	{ 1.000000, 0.879250, 0.761250 },
+	{ 1.000000, 0.879940, 0.762840 },
+	{ 1.000000, 0.880630, 0.764430 },
+	{ 1.000000, 0.881320, 0.766020 },
+	{ 1.000000, 0.882010, 0.767610 },
+	{ 1.000000, 0.882700, 0.769200 },
+	{ 1.000000, 0.883360, 0.770760 },
+	{ 1.000000, 0.884020, 0.772320 },
+	{ 1.000000, 0.884680, 0.773880 },
+	{ 1.000000, 0.885340, 0.775440 },
+	{ 1.000000, 0.886000, 0.777000 },
+	{ 1.000000, 0.886660, 0.778560 },
+	{ 1.000000, 0.887320, 0.780120 },
+	{ 1.000000, 0.887980, 0.781680 },
+	{ 1.000000, 0.888640, 0.783240 },
+	{ 1.000000, 0.889300, 0.784800 },
+	{ 1.000000, 0.889950, 0.786310 },
+	{ 1.000000, 0.890600, 0.787820 },
+	{ 1.000000, 0.891250, 0.789330 },
+	{ 1.000000, 0.891900, 0.790840 },
+	{ 1.000000, 0.892550, 0.792350 },
+	{ 1.000000, 0.893200, 0.793860 },
+	{ 1.000000, 0.893850, 0.795370 },
+	{ 1.000000, 0.894500, 0.796880 },
+	{ 1.000000, 0.895150, 0.798390 },
+	{ 1.000000, 0.895800, 0.799900 },
+	{ 1.000000, 0.896420, 0.801380 },
+	{ 1.000000, 0.897040, 0.802860 },
+	{ 1.000000, 0.897660, 0.804340 },
+	{ 1.000000, 0.898280, 0.805820 },
+	{ 1.000000, 0.898900, 0.807300 },
+	{ 1.000000, 0.899520, 0.808780 },
+	{ 1.000000, 0.900140, 0.810260 },
+	{ 1.000000, 0.900760, 0.811740 },
+	{ 1.000000, 0.901380, 0.813220 },
+	{ 1.000000, 0.902000, 0.814700 }, /* 5000K */
+	{ 1.000000, 0.902760, 0.816070 },
+	{ 1.000000, 0.903520, 0.817440 },
+	{ 1.000000, 0.904280, 0.818810 },
+	{ 1.000000, 0.905040, 0.820180 },
+	{ 1.000000, 0.905800, 0.821550 },
+	{ 1.000000, 0.906560, 0.822920 },
+	{ 1.000000, 0.907320, 0.824290 },
+	{ 1.000000, 0.908080, 0.825660 },
+	{ 1.000000, 0.908840, 0.827030 },
+	{ 1.000000, 0.909600, 0.828400 },
+	{ 1.000000, 0.910350, 0.829750 },
+	{ 1.000000, 0.911100, 0.831100 },
+	{ 1.000000, 0.911850, 0.832450 },
+	{ 1.000000, 0.912600, 0.833800 },
+	{ 1.000000, 0.913350, 0.835150 },
+	{ 1.000000, 0.914100, 0.836500 },
+	{ 1.000000, 0.914850, 0.837850 },
+	{ 1.000000, 0.915600, 0.839200 },
+	{ 1.000000, 0.916350, 0.840550 },
+	{ 1.000000, 0.917100, 0.841900 },
+	{ 1.000000, 0.917830, 0.843230 },
+	{ 1.000000, 0.918560, 0.844560 },
+	{ 1.000000, 0.919290, 0.845890 },
+	{ 1.000000, 0.920020, 0.847220 },
+	{ 1.000000, 0.920750, 0.848550 },
+	{ 1.000000, 0.921480, 0.849880 },
+	{ 1.000000, 0.922210, 0.851210 },
+	{ 1.000000, 0.922940, 0.852540 },
+	{ 1.000000, 0.923670, 0.853870 },
+	{ 1.000000, 0.924400, 0.855200 },
+	{ 1.000000, 0.925120, 0.856520 },
+	{ 1.000000, 0.925840, 0.857840 },
+	{ 1.000000, 0.926560, 0.859160 },
+	{ 1.000000, 0.927280, 0.860480 },
+	{ 1.000000, 0.928000, 0.861800 },
+	{ 1.000000, 0.928720, 0.863120 },
+	{ 1.000000, 0.929440, 0.864440 },
+	{ 1.000000, 0.930160, 0.865760 },
+	{ 1.000000, 0.930880, 0.867080 },
+	{ 1.000000, 0.931600, 0.868400 },
+	{ 1.000000, 0.932290, 0.869690 },
+	{ 1.000000, 0.932980, 0.870980 },
+	{ 1.000000, 0.933670, 0.872270 },
+	{ 1.000000, 0.934360, 0.873560 },
+	{ 1.000000, 0.935050, 0.874850 },
+	{ 1.000000, 0.935740, 0.876140 },
+	{ 1.000000, 0.936430, 0.877430 },
+	{ 1.000000, 0.937120, 0.878720 },
+	{ 1.000000, 0.937810, 0.880010 },
+	{ 1.000000, 0.938500, 0.881300 },
+	{ 1.000000, 0.939190, 0.882570 },
+	{ 1.000000, 0.939880, 0.883840 },
+	{ 1.000000, 0.940570, 0.885110 },
+	{ 1.000000, 0.941260, 0.886380 },
+	{ 1.000000, 0.941950, 0.887650 },
+	{ 1.000000, 0.942640, 0.888920 },
+	{ 1.000000, 0.943330, 0.890190 },
+	{ 1.000000, 0.944020, 0.891460 },
+	{ 1.000000, 0.944710, 0.892730 },
+	{ 1.000000, 0.945400, 0.894000 },
+	{ 1.000000, 0.946060, 0.895260 },
+	{ 1.000000, 0.946720, 0.896520 },
+	{ 1.000000, 0.947380, 0.897780 },
+	{ 1.000000, 0.948040, 0.899040 },
+	{ 1.000000, 0.948700, 0.900300 },
+	{ 1.000000, 0.949360, 0.901560 },
+	{ 1.000000, 0.950020, 0.902820 },
+	{ 1.000000, 0.950680, 0.904080 },
+	{ 1.000000, 0.951340, 0.905340 },
+	{ 1.000000, 0.952000, 0.906600 },
+	{ 1.000000, 0.952650, 0.907830 },
+	{ 1.000000, 0.953300, 0.909060 },
+	{ 1.000000, 0.953950, 0.910290 },
+	{ 1.000000, 0.954600, 0.911520 },
+	{ 1.000000, 0.955250, 0.912750 },
+	{ 1.000000, 0.955900, 0.913980 },
+	{ 1.000000, 0.956550, 0.915210 },
+	{ 1.000000, 0.957200, 0.916440 },
+	{ 1.000000, 0.957850, 0.917670 },
+	{ 1.000000, 0.958500, 0.918900 },
+	{ 1.000000, 0.959140, 0.920120 },
+	{ 1.000000, 0.959780, 0.921340 },
+	{ 1.000000, 0.960420, 0.922560 },
+	{ 1.000000, 0.961060, 0.923780 },
+	{ 1.000000, 0.961700, 0.925000 },
+	{ 1.000000, 0.962340, 0.926220 },
+	{ 1.000000, 0.962980, 0.927440 },
+	{ 1.000000, 0.963620, 0.928660 },
+	{ 1.000000, 0.964260, 0.929880 },
+	{ 1.000000, 0.964900, 0.931100 },
+	{ 1.000000, 0.965520, 0.932300 },
+	{ 1.000000, 0.966140, 0.933500 },
+	{ 1.000000, 0.966760, 0.934700 },
+	{ 1.000000, 0.967380, 0.935900 },
+	{ 1.000000, 0.968000, 0.937100 },
+	{ 1.000000, 0.968620, 0.938300 },
+	{ 1.000000, 0.969240, 0.939500 },
+	{ 1.000000, 0.969860, 0.940700 },
+	{ 1.000000, 0.970480, 0.941900 },
+	{ 1.000000, 0.971100, 0.943100 }, /* 6000K */
+	{ 1.000000, 0.971700, 0.944270 },
+	{ 1.000000, 0.972300, 0.945440 },
+	{ 1.000000, 0.972900, 0.946610 },
+	{ 1.000000, 0.973500, 0.947780 },
+	{ 1.000000, 0.974100, 0.948950 },
+	{ 1.000000, 0.974700, 0.950120 },
+	{ 1.000000, 0.975300, 0.951290 },
+	{ 1.000000, 0.975900, 0.952460 },
+	{ 1.000000, 0.976500, 0.953630 },
+	{ 1.000000, 0.977100, 0.954800 },
+	{ 1.000000, 0.977700, 0.955960 },
+	{ 1.000000, 0.978300, 0.957120 },
+	{ 1.000000, 0.978900, 0.958280 },
+	{ 1.000000, 0.979500, 0.959440 },
+	{ 1.000000, 0.980100, 0.960600 },
+	{ 1.000000, 0.980700, 0.961760 },
+	{ 1.000000, 0.981300, 0.962920 },
+	{ 1.000000, 0.981900, 0.964080 },
+	{ 1.000000, 0.982500, 0.965240 },
+	{ 1.000000, 0.983100, 0.966400 },
+	{ 1.000000, 0.983670, 0.967540 },
+	{ 1.000000, 0.984240, 0.968680 },
+	{ 1.000000, 0.984810, 0.969820 },
+	{ 1.000000, 0.985380, 0.970960 },
+	{ 1.000000, 0.985950, 0.972100 },
+	{ 1.000000, 0.986520, 0.973240 },
+	{ 1.000000, 0.987090, 0.974380 },
+	{ 1.000000, 0.987660, 0.975520 },
+	{ 1.000000, 0.988230, 0.976660 },
+	{ 1.000000, 0.988800, 0.977800 },
+	{ 1.000000, 0.989370, 0.978920 },
+	{ 1.000000, 0.989940, 0.980040 },
+	{ 1.000000, 0.990510, 0.981160 },
+	{ 1.000000, 0.991080, 0.982280 },
+	{ 1.000000, 0.991650, 0.983400 },
+	{ 1.000000, 0.992220, 0.984520 },
+	{ 1.000000, 0.992790, 0.985640 },
+	{ 1.000000, 0.993360, 0.986760 },
+	{ 1.000000, 0.993930, 0.987880 },
+	{ 1.000000, 0.994500, 0.989000 },
+	{ 1.000000, 0.995050, 0.990100 },
+	{ 1.000000, 0.995600, 0.991200 },
+	{ 1.000000, 0.996150, 0.992300 },
+	{ 1.000000, 0.996700, 0.993400 },
+	{ 1.000000, 0.997250, 0.994500 },
+	{ 1.000000, 0.997800, 0.995600 },
+	{ 1.000000, 0.998350, 0.996700 },
+	{ 1.000000, 0.998900, 0.997800 },
+	{ 1.000000, 0.999450, 0.998900 },
+	{ 1.000000, 1.000000, 1.000000 },
+	{ 0.998950, 0.999350, 1.000000 },
+	{ 0.997900, 0.998700, 1.000000 },
+	{ 0.996850, 0.998050, 1.000000 },
+	{ 0.995800, 0.997400, 1.000000 },
+	{ 0.994750, 0.996750, 1.000000 },
+	{ 0.993700, 0.996100, 1.000000 },
+	{ 0.992650, 0.995450, 1.000000 },
+	{ 0.991600, 0.994800, 1.000000 },
+	{ 0.990550, 0.994150, 1.000000 },
+	{ 0.989500, 0.993500, 1.000000 },
+	{ 0.988490, 0.992870, 1.000000 },
+	{ 0.987480, 0.992240, 1.000000 },
+	{ 0.986470, 0.991610, 1.000000 },
+	{ 0.985460, 0.990980, 1.000000 },
+	{ 0.984450, 0.990350, 1.000000 },
+	{ 0.983440, 0.989720, 1.000000 },
+	{ 0.982430, 0.989090, 1.000000 },
+	{ 0.981420, 0.988460, 1.000000 },
+	{ 0.980410, 0.987830, 1.000000 },
+	{ 0.979400, 0.987200, 1.000000 },
+	{ 0.978440, 0.986600, 1.000000 },
+	{ 0.977480, 0.986000, 1.000000 },
+	{ 0.976520, 0.985400, 1.000000 },
+	{ 0.975560, 0.984800, 1.000000 },
+	{ 0.974600, 0.984200, 1.000000 },
+	{ 0.973640, 0.983600, 1.000000 },
+	{ 0.972680, 0.983000, 1.000000 },
+	{ 0.971720, 0.982400, 1.000000 },
+	{ 0.970760, 0.981800, 1.000000 },
+	{ 0.969800, 0.981200, 1.000000 },
+	{ 0.968870, 0.980620, 1.000000 },
+	{ 0.967940, 0.980040, 1.000000 },
+	{ 0.967010, 0.979460, 1.000000 },
+	{ 0.966080, 0.978880, 1.000000 },
+	{ 0.965150, 0.978300, 1.000000 },
+	{ 0.964220, 0.977720, 1.000000 },
+	{ 0.963290, 0.977140, 1.000000 },
+	{ 0.962360, 0.976560, 1.000000 },
+	{ 0.961430, 0.975980, 1.000000 },
+	{ 0.960500, 0.975400, 1.000000 },
+	{ 0.959610, 0.974840, 1.000000 },
+	{ 0.958720, 0.974280, 1.000000 },
+	{ 0.957830, 0.973720, 1.000000 },
+	{ 0.956940, 0.973160, 1.000000 },
+	{ 0.956050, 0.972600, 1.000000 },
+	{ 0.955160, 0.972040, 1.000000 },
+	{ 0.954270, 0.971480, 1.000000 },
+	{ 0.953380, 0.970920, 1.000000 },
+	{ 0.952490, 0.970360, 1.000000 },
+	{ 0.951600, 0.969800, 1.000000 }, /* 7000K */
+	{ 0.950740, 0.969260, 1.000000 },
+	{ 0.949880, 0.968720, 1.000000 },
+	{ 0.949020, 0.968180, 1.000000 },
+	{ 0.948160, 0.967640, 1.000000 },
+	{ 0.947300, 0.967100, 1.000000 },
+	{ 0.946440, 0.966560, 1.000000 },
+	{ 0.945580, 0.966020, 1.000000 },
+	{ 0.944720, 0.965480, 1.000000 },
+	{ 0.943860, 0.964940, 1.000000 },
+	{ 0.943000, 0.964400, 1.000000 },
+	{ 0.942180, 0.963880, 1.000000 },
+	{ 0.941360, 0.963360, 1.000000 },
+	{ 0.940540, 0.962840, 1.000000 },
+	{ 0.939720, 0.962320, 1.000000 },
+	{ 0.938900, 0.961800, 1.000000 },
+	{ 0.938080, 0.961280, 1.000000 },
+	{ 0.937260, 0.960760, 1.000000 },
+	{ 0.936440, 0.960240, 1.000000 },
+	{ 0.935620, 0.959720, 1.000000 },
+	{ 0.934800, 0.959200, 1.000000 },
+	{ 0.934010, 0.958700, 1.000000 },
+	{ 0.933220, 0.958200, 1.000000 },
+	{ 0.932430, 0.957700, 1.000000 },
+	{ 0.931640, 0.957200, 1.000000 },
+	{ 0.930850, 0.956700, 1.000000 },
+	{ 0.930060, 0.956200, 1.000000 },
+	{ 0.929270, 0.955700, 1.000000 },
+	{ 0.928480, 0.955200, 1.000000 },
+	{ 0.927690, 0.954700, 1.000000 },
+	{ 0.926900, 0.954200, 1.000000 },
+	{ 0.926140, 0.953720, 1.000000 },
+	{ 0.925380, 0.953240, 1.000000 },
+	{ 0.924620, 0.952760, 1.000000 },
+	{ 0.923860, 0.952280, 1.000000 },
+	{ 0.923100, 0.951800, 1.000000 },
+	{ 0.922340, 0.951320, 1.000000 },
+	{ 0.921580, 0.950840, 1.000000 },
+	{ 0.920820, 0.950360, 1.000000 },
+	{ 0.920060, 0.949880, 1.000000 },
+	{ 0.919300, 0.949400, 1.000000 },
+	{ 0.918560, 0.948930, 1.000000 },
+	{ 0.917820, 0.948460, 1.000000 },
+	{ 0.917080, 0.947990, 1.000000 },
+	{ 0.916340, 0.947520, 1.000000 },
+	{ 0.915600, 0.947050, 1.000000 },
+	{ 0.914860, 0.946580, 1.000000 },
+	{ 0.914120, 0.946110, 1.000000 },
+	{ 0.913380, 0.945640, 1.000000 },
+	{ 0.912640, 0.945170, 1.000000 },
+	{ 0.911900, 0.944700, 1.000000 },
+	{ 0.911200, 0.944250, 1.000000 },
+	{ 0.910500, 0.943800, 1.000000 },
+	{ 0.909800, 0.943350, 1.000000 },
+	{ 0.909100, 0.942900, 1.000000 },
+	{ 0.908400, 0.942450, 1.000000 },
+	{ 0.907700, 0.942000, 1.000000 },
+	{ 0.907000, 0.941550, 1.000000 },
+	{ 0.906300, 0.941100, 1.000000 },
+	{ 0.905600, 0.940650, 1.000000 },
+	{ 0.904900, 0.940200, 1.000000 },
+	{ 0.904220, 0.939760, 1.000000 },
+	{ 0.903540, 0.939320, 1.000000 },
+	{ 0.902860, 0.938880, 1.000000 },
+	{ 0.902180, 0.938440, 1.000000 },
+	{ 0.901500, 0.938000, 1.000000 },
+	{ 0.900820, 0.937560, 1.000000 },
+	{ 0.900140, 0.937120, 1.000000 },
+	{ 0.899460, 0.936680, 1.000000 },
+	{ 0.898780, 0.936240, 1.000000 },
+	{ 0.898100, 0.935800, 1.000000 },
+	{ 0.897440, 0.935380, 1.000000 },
+	{ 0.896780, 0.934960, 1.000000 },
+	{ 0.896120, 0.934540, 1.000000 },
+	{ 0.895460, 0.934120, 1.000000 },
+	{ 0.894800, 0.933700, 1.000000 },
+	{ 0.894140, 0.933280, 1.000000 },
+	{ 0.893480, 0.932860, 1.000000 },
+	{ 0.892820, 0.932440, 1.000000 },
+	{ 0.892160, 0.932020, 1.000000 },
+	{ 0.891500, 0.931600, 1.000000 },
+	{ 0.890870, 0.931190, 1.000000 },
+	{ 0.890240, 0.930780, 1.000000 },
+	{ 0.889610, 0.930370, 1.000000 },
+	{ 0.888980, 0.929960, 1.000000 },
+	{ 0.888350, 0.929550, 1.000000 },
+	{ 0.887720, 0.929140, 1.000000 },
+	{ 0.887090, 0.928730, 1.000000 },
+	{ 0.886460, 0.928320, 1.000000 },
+	{ 0.885830, 0.927910, 1.000000 },
+	{ 0.885200, 0.927500, 1.000000 },
+	{ 0.884590, 0.927110, 1.000000 },
+	{ 0.883980, 0.926720, 1.000000 },
+	{ 0.883370, 0.926330, 1.000000 },
+	{ 0.882760, 0.925940, 1.000000 },
+	{ 0.882150, 0.925550, 1.000000 },
+	{ 0.881540, 0.925160, 1.000000 },
+	{ 0.880930, 0.924770, 1.000000 },
+	{ 0.880320, 0.924380, 1.000000 },
+	{ 0.879710, 0.923990, 1.000000 },
+	{ 0.879100, 0.923600, 1.000000 }, /* 8000K */
+	{ 0.878510, 0.923210, 1.000000 },
+	{ 0.877920, 0.922820, 1.000000 },
+	{ 0.877330, 0.922430, 1.000000 },
+	{ 0.876740, 0.922040, 1.000000 },
+	{ 0.876150, 0.921650, 1.000000 },
+	{ 0.875560, 0.921260, 1.000000 },
+	{ 0.874970, 0.920870, 1.000000 },
+	{ 0.874380, 0.920480, 1.000000 },
+	{ 0.873790, 0.920090, 1.000000 },
+	{ 0.873200, 0.919700, 1.000000 },
+	{ 0.872620, 0.919330, 1.000000 },
+	{ 0.872040, 0.918960, 1.000000 },
+	{ 0.871460, 0.918590, 1.000000 },
+	{ 0.870880, 0.918220, 1.000000 },
+	{ 0.870300, 0.917850, 1.000000 },
+	{ 0.869720, 0.917480, 1.000000 },
+	{ 0.869140, 0.917110, 1.000000 },
+	{ 0.868560, 0.916740, 1.000000 },
+	{ 0.867980, 0.916370, 1.000000 },
+	{ 0.867400, 0.916000, 1.000000 },
+	{ 0.866850, 0.915650, 1.000000 },
+	{ 0.866300, 0.915300, 1.000000 },
+	{ 0.865750, 0.914950, 1.000000 },
+	{ 0.865200, 0.914600, 1.000000 },
+	{ 0.864650, 0.914250, 1.000000 },
+	{ 0.864100, 0.913900, 1.000000 },
+	{ 0.863550, 0.913550, 1.000000 },
+	{ 0.863000, 0.913200, 1.000000 },
+	{ 0.862450, 0.912850, 1.000000 },
+	{ 0.861900, 0.912500, 1.000000 },
+	{ 0.861370, 0.912150, 1.000000 },
+	{ 0.860840, 0.911800, 1.000000 },
+	{ 0.860310, 0.911450, 1.000000 },
+	{ 0.859780, 0.911100, 1.000000 },
+	{ 0.859250, 0.910750, 1.000000 },
+	{ 0.858720, 0.910400, 1.000000 },
+	{ 0.858190, 0.910050, 1.000000 },
+	{ 0.857660, 0.909700, 1.000000 },
+	{ 0.857130, 0.909350, 1.000000 },
+	{ 0.856600, 0.909000, 1.000000 },
+	{ 0.856080, 0.908660, 1.000000 },
+	{ 0.855560, 0.908320, 1.000000 },
+	{ 0.855040, 0.907980, 1.000000 },
+	{ 0.854520, 0.907640, 1.000000 },
+	{ 0.854000, 0.907300, 1.000000 },
+	{ 0.853480, 0.906960, 1.000000 },
+	{ 0.852960, 0.906620, 1.000000 },
+	{ 0.852440, 0.906280, 1.000000 },
+	{ 0.851920, 0.905940, 1.000000 },
+	{ 0.851400, 0.905600, 1.000000 },
+	{ 0.850900, 0.905270, 1.000000 },
+	{ 0.850400, 0.904940, 1.000000 },
+	{ 0.849900, 0.904610, 1.000000 },
+	{ 0.849400, 0.904280, 1.000000 },
+	{ 0.848900, 0.903950, 1.000000 },
+	{ 0.848400, 0.903620, 1.000000 },
+	{ 0.847900, 0.903290, 1.000000 },
+	{ 0.847400, 0.902960, 1.000000 },
+	{ 0.846900, 0.902630, 1.000000 },
+	{ 0.846400, 0.902300, 1.000000 },
+	{ 0.845910, 0.901980, 1.000000 },
+	{ 0.845420, 0.901660, 1.000000 },
+	{ 0.844930, 0.901340, 1.000000 },
+	{ 0.844440, 0.901020, 1.000000 },
+	{ 0.843950, 0.900700, 1.000000 },
+	{ 0.843460, 0.900380, 1.000000 },
+	{ 0.842970, 0.900060, 1.000000 },
+	{ 0.842480, 0.899740, 1.000000 },
+	{ 0.841990, 0.899420, 1.000000 },
+	{ 0.841500, 0.899100, 1.000000 },
+	{ 0.841030, 0.898790, 1.000000 },
+	{ 0.840560, 0.898480, 1.000000 },
+	{ 0.840090, 0.898170, 1.000000 },
+	{ 0.839620, 0.897860, 1.000000 },
+	{ 0.839150, 0.897550, 1.000000 },
+	{ 0.838680, 0.897240, 1.000000 },
+	{ 0.838210, 0.896930, 1.000000 },
+	{ 0.837740, 0.896620, 1.000000 },
+	{ 0.837270, 0.896310, 1.000000 },
+	{ 0.836800, 0.896000, 1.000000 },
+	{ 0.836350, 0.895700, 1.000000 },
+	{ 0.835900, 0.895400, 1.000000 },
+	{ 0.835450, 0.895100, 1.000000 },
+	{ 0.835000, 0.894800, 1.000000 },
+	{ 0.834550, 0.894500, 1.000000 },
+	{ 0.834100, 0.894200, 1.000000 },
+	{ 0.833650, 0.893900, 1.000000 },
+	{ 0.833200, 0.893600, 1.000000 },
+	{ 0.832750, 0.893300, 1.000000 },
+	{ 0.832300, 0.893000, 1.000000 },
+	{ 0.831850, 0.892710, 1.000000 },
+	{ 0.831400, 0.892420, 1.000000 },
+	{ 0.830950, 0.892130, 1.000000 },
+	{ 0.830500, 0.891840, 1.000000 },
+	{ 0.830050, 0.891550, 1.000000 },
+	{ 0.829600, 0.891260, 1.000000 },
+	{ 0.829150, 0.890970, 1.000000 },
+	{ 0.828700, 0.890680, 1.000000 },
+	{ 0.828250, 0.890390, 1.000000 },
+	{ 0.827800, 0.890100, 1.000000 }, /* 9000K */
+	{ 0.827370, 0.889820, 1.000000 },
+	{ 0.826940, 0.889540, 1.000000 },
+	{ 0.826510, 0.889260, 1.000000 },
+	{ 0.826080, 0.888980, 1.000000 },
+	{ 0.825650, 0.888700, 1.000000 },
+	{ 0.825220, 0.888420, 1.000000 },
+	{ 0.824790, 0.888140, 1.000000 },
+	{ 0.824360, 0.887860, 1.000000 },
+	{ 0.823930, 0.887580, 1.000000 },
+	{ 0.823500, 0.887300, 1.000000 },
+	{ 0.823090, 0.887020, 1.000000 },
+	{ 0.822680, 0.886740, 1.000000 },
+	{ 0.822270, 0.886460, 1.000000 },
+	{ 0.821860, 0.886180, 1.000000 },
+	{ 0.821450, 0.885900, 1.000000 },
+	{ 0.821040, 0.885620, 1.000000 },
+	{ 0.820630, 0.885340, 1.000000 },
+	{ 0.820220, 0.885060, 1.000000 },
+	{ 0.819810, 0.884780, 1.000000 },
+	{ 0.819400, 0.884500, 1.000000 },
+	{ 0.818990, 0.884230, 1.000000 },
+	{ 0.818580, 0.883960, 1.000000 },
+	{ 0.818170, 0.883690, 1.000000 },
+	{ 0.817760, 0.883420, 1.000000 },
+	{ 0.817350, 0.883150, 1.000000 },
+	{ 0.816940, 0.882880, 1.000000 },
+	{ 0.816530, 0.882610, 1.000000 },
+	{ 0.816120, 0.882340, 1.000000 },
+	{ 0.815710, 0.882070, 1.000000 },
+	{ 0.815300, 0.881800, 1.000000 },
+	{ 0.814910, 0.881540, 1.000000 },
+	{ 0.814520, 0.881280, 1.000000 },
+	{ 0.814130, 0.881020, 1.000000 },
+	{ 0.813740, 0.880760, 1.000000 },
+	{ 0.813350, 0.880500, 1.000000 },
+	{ 0.812960, 0.880240, 1.000000 },
+	{ 0.812570, 0.879980, 1.000000 },
+	{ 0.812180, 0.879720, 1.000000 },
+	{ 0.811790, 0.879460, 1.000000 },
+	{ 0.811400, 0.879200, 1.000000 },
+	{ 0.811010, 0.878950, 1.000000 },
+	{ 0.810620, 0.878700, 1.000000 },
+	{ 0.810230, 0.878450, 1.000000 },
+	{ 0.809840, 0.878200, 1.000000 },
+	{ 0.809450, 0.877950, 1.000000 },
+	{ 0.809060, 0.877700, 1.000000 },
+	{ 0.808670, 0.877450, 1.000000 },
+	{ 0.808280, 0.877200, 1.000000 },
+	{ 0.807890, 0.876950, 1.000000 },
+	{ 0.807500, 0.876700, 1.000000 },
+	{ 0.807130, 0.876450, 1.000000 },
+	{ 0.806760, 0.876200, 1.000000 },
+	{ 0.806390, 0.875950, 1.000000 },
+	{ 0.806020, 0.875700, 1.000000 },
+	{ 0.805650, 0.875450, 1.000000 },
+	{ 0.805280, 0.875200, 1.000000 },
+	{ 0.804910, 0.874950, 1.000000 },
+	{ 0.804540, 0.874700, 1.000000 },
+	{ 0.804170, 0.874450, 1.000000 },
+	{ 0.803800, 0.874200, 1.000000 },
+	{ 0.803440, 0.873960, 1.000000 },
+	{ 0.803080, 0.873720, 1.000000 },
+	{ 0.802720, 0.873480, 1.000000 },
+	{ 0.802360, 0.873240, 1.000000 },
+	{ 0.802000, 0.873000, 1.000000 },
+	{ 0.801640, 0.872760, 1.000000 },
+	{ 0.801280, 0.872520, 1.000000 },
+	{ 0.800920, 0.872280, 1.000000 },
+	{ 0.800560, 0.872040, 1.000000 },
+	{ 0.800200, 0.871800, 1.000000 },
+	{ 0.799850, 0.871560, 1.000000 },
+	{ 0.799500, 0.871320, 1.000000 },
+	{ 0.799150, 0.871080, 1.000000 },
+	{ 0.798800, 0.870840, 1.000000 },
+	{ 0.798450, 0.870600, 1.000000 },
+	{ 0.798100, 0.870360, 1.000000 },
+	{ 0.797750, 0.870120, 1.000000 },
+	{ 0.797400, 0.869880, 1.000000 },
+	{ 0.797050, 0.869640, 1.000000 },
+	{ 0.796700, 0.869400, 1.000000 },
+	{ 0.796350, 0.869170, 1.000000 },
+	{ 0.796000, 0.868940, 1.000000 },
+	{ 0.795650, 0.868710, 1.000000 },
+	{ 0.795300, 0.868480, 1.000000 },
+	{ 0.794950, 0.868250, 1.000000 },
+	{ 0.794600, 0.868020, 1.000000 },
+	{ 0.794250, 0.867790, 1.000000 },
+	{ 0.793900, 0.867560, 1.000000 },
+	{ 0.793550, 0.867330, 1.000000 },
+	{ 0.793200, 0.867100, 1.000000 },
+	{ 0.792860, 0.866880, 1.000000 },
+	{ 0.792520, 0.866660, 1.000000 },
+	{ 0.792180, 0.866440, 1.000000 },
+	{ 0.791840, 0.866220, 1.000000 },
+	{ 0.791500, 0.866000, 1.000000 },
+	{ 0.791160, 0.865780, 1.000000 },
+	{ 0.790820, 0.865560, 1.000000 },
+	{ 0.790480, 0.865340, 1.000000 },
+	{ 0.790140, 0.865120, 1.000000 },
+	{ 0.789800, 0.864900, 1.000000 }, /* 10000K */
+};
+
+static const CdColorRGB blackbody_data_d65modified[] = {
+	{ 1.000000, 0.042500, 0.000000 }, /* 1000K */
+	{ 1.000000, 0.044930, 0.000000 },
+	{ 1.000000, 0.047360, 0.000000 },
+	{ 1.000000, 0.049790, 0.000000 },
+	{ 1.000000, 0.052220, 0.000000 },
+	{ 1.000000, 0.054650, 0.000000 },
+	{ 1.000000, 0.057080, 0.000000 },
+	{ 1.000000, 0.059510, 0.000000 },
+	{ 1.000000, 0.061940, 0.000000 },
+	{ 1.000000, 0.064370, 0.000000 },
+	{ 1.000000, 0.066800, 0.000000 },
+	{ 1.000000, 0.069230, 0.000000 },
+	{ 1.000000, 0.071660, 0.000000 },
+	{ 1.000000, 0.074090, 0.000000 },
+	{ 1.000000, 0.076520, 0.000000 },
+	{ 1.000000, 0.078950, 0.000000 },
+	{ 1.000000, 0.081380, 0.000000 },
+	{ 1.000000, 0.083810, 0.000000 },
+	{ 1.000000, 0.086240, 0.000000 },
+	{ 1.000000, 0.088670, 0.000000 },
+	{ 1.000000, 0.091100, 0.000000 },
+	{ 1.000000, 0.093480, 0.000000 },
+	{ 1.000000, 0.095860, 0.000000 },
+	{ 1.000000, 0.098240, 0.000000 },
+	{ 1.000000, 0.100620, 0.000000 },
+	{ 1.000000, 0.103000, 0.000000 },
+	{ 1.000000, 0.105380, 0.000000 },
+	{ 1.000000, 0.107760, 0.000000 },
+	{ 1.000000, 0.110140, 0.000000 },
+	{ 1.000000, 0.112520, 0.000000 },
+	{ 1.000000, 0.114900, 0.000000 },
+	{ 1.000000, 0.117210, 0.000000 },
+	{ 1.000000, 0.119520, 0.000000 },
+	{ 1.000000, 0.121830, 0.000000 },
+	{ 1.000000, 0.124140, 0.000000 },
+	{ 1.000000, 0.126450, 0.000000 },
+	{ 1.000000, 0.128760, 0.000000 },
+	{ 1.000000, 0.131070, 0.000000 },
+	{ 1.000000, 0.133380, 0.000000 },
+	{ 1.000000, 0.135690, 0.000000 },
+	{ 1.000000, 0.138000, 0.000000 },
+	{ 1.000000, 0.140240, 0.000000 },
+	{ 1.000000, 0.142480, 0.000000 },
+	{ 1.000000, 0.144720, 0.000000 },
+	{ 1.000000, 0.146960, 0.000000 },
+	{ 1.000000, 0.149200, 0.000000 },
+	{ 1.000000, 0.151440, 0.000000 },
+	{ 1.000000, 0.153680, 0.000000 },
+	{ 1.000000, 0.155920, 0.000000 },
+	{ 1.000000, 0.158160, 0.000000 },
+	{ 1.000000, 0.160400, 0.000000 },
+	{ 1.000000, 0.162550, 0.000000 },
+	{ 1.000000, 0.164700, 0.000000 },
+	{ 1.000000, 0.166850, 0.000000 },
+	{ 1.000000, 0.169000, 0.000000 },
+	{ 1.000000, 0.171150, 0.000000 },
+	{ 1.000000, 0.173300, 0.000000 },
+	{ 1.000000, 0.175450, 0.000000 },
+	{ 1.000000, 0.177600, 0.000000 },
+	{ 1.000000, 0.179750, 0.000000 },
+	{ 1.000000, 0.181900, 0.000000 },
+	{ 1.000000, 0.183950, 0.000000 },
+	{ 1.000000, 0.186000, 0.000000 },
+	{ 1.000000, 0.188050, 0.000000 },
+	{ 1.000000, 0.190100, 0.000000 },
+	{ 1.000000, 0.192150, 0.000000 },
+	{ 1.000000, 0.194200, 0.000000 },
+	{ 1.000000, 0.196250, 0.000000 },
+	{ 1.000000, 0.198300, 0.000000 },
+	{ 1.000000, 0.200350, 0.000000 },
+	{ 1.000000, 0.202400, 0.000000 },
+	{ 1.000000, 0.204360, 0.000000 },
+	{ 1.000000, 0.206320, 0.000000 },
+	{ 1.000000, 0.208280, 0.000000 },
+	{ 1.000000, 0.210240, 0.000000 },
+	{ 1.000000, 0.212200, 0.000000 },
+	{ 1.000000, 0.214160, 0.000000 },
+	{ 1.000000, 0.216120, 0.000000 },
+	{ 1.000000, 0.218080, 0.000000 },
+	{ 1.000000, 0.220040, 0.000000 },
+	{ 1.000000, 0.222000, 0.000000 },
+	{ 1.000000, 0.223860, 0.000000 },
+	{ 1.000000, 0.225720, 0.000000 },
+	{ 1.000000, 0.227580, 0.000000 },
+	{ 1.000000, 0.229440, 0.000000 },
+	{ 1.000000, 0.231300, 0.000000 },
+	{ 1.000000, 0.233160, 0.000000 },
+	{ 1.000000, 0.235020, 0.000000 },
+	{ 1.000000, 0.236880, 0.000000 },
+	{ 1.000000, 0.238740, 0.000000 },
+	{ 1.000000, 0.240600, 0.000000 },
+	{ 1.000000, 0.242840, 0.000620 },
+	{ 1.000000, 0.245080, 0.001240 },
+	{ 1.000000, 0.247320, 0.001860 },
+	{ 1.000000, 0.249560, 0.002480 },
+	{ 1.000000, 0.251800, 0.003100 },
+	{ 1.000000, 0.254040, 0.003720 },
+	{ 1.000000, 0.256280, 0.004340 },
+	{ 1.000000, 0.258520, 0.004960 },
+	{ 1.000000, 0.260760, 0.005580 },
+	{ 1.000000, 0.263000, 0.006200 }, /* 2000K */
+	{ 1.000000, 0.265380, 0.007130 },
+	{ 1.000000, 0.267760, 0.008060 },
+	{ 1.000000, 0.270140, 0.008990 },
+	{ 1.000000, 0.272520, 0.009920 },
+	{ 1.000000, 0.274900, 0.010850 },
+	{ 1.000000, 0.277280, 0.011780 },
+	{ 1.000000, 0.279660, 0.012710 },
+	{ 1.000000, 0.282040, 0.013640 },
+	{ 1.000000, 0.284420, 0.014570 },
+	{ 1.000000, 0.286800, 0.015500 },
+	{ 1.000000, 0.289140, 0.016560 },
+	{ 1.000000, 0.291480, 0.017620 },
+	{ 1.000000, 0.293820, 0.018680 },
+	{ 1.000000, 0.296160, 0.019740 },
+	{ 1.000000, 0.298500, 0.020800 },
+	{ 1.000000, 0.300840, 0.021860 },
+	{ 1.000000, 0.303180, 0.022920 },
+	{ 1.000000, 0.305520, 0.023980 },
+	{ 1.000000, 0.307860, 0.025040 },
+	{ 1.000000, 0.310200, 0.026100 },
+	{ 1.000000, 0.312520, 0.027280 },
+	{ 1.000000, 0.314840, 0.028460 },
+	{ 1.000000, 0.317160, 0.029640 },
+	{ 1.000000, 0.319480, 0.030820 },
+	{ 1.000000, 0.321800, 0.032000 },
+	{ 1.000000, 0.324120, 0.033180 },
+	{ 1.000000, 0.326440, 0.034360 },
+	{ 1.000000, 0.328760, 0.035540 },
+	{ 1.000000, 0.331080, 0.036720 },
+	{ 1.000000, 0.333400, 0.037900 },
+	{ 1.000000, 0.335680, 0.039190 },
+	{ 1.000000, 0.337960, 0.040480 },
+	{ 1.000000, 0.340240, 0.041770 },
+	{ 1.000000, 0.342520, 0.043060 },
+	{ 1.000000, 0.344800, 0.044350 },
+	{ 1.000000, 0.347080, 0.045640 },
+	{ 1.000000, 0.349360, 0.046930 },
+	{ 1.000000, 0.351640, 0.048220 },
+	{ 1.000000, 0.353920, 0.049510 },
+	{ 1.000000, 0.356200, 0.050800 },
+	{ 1.000000, 0.358450, 0.052220 },
+	{ 1.000000, 0.360700, 0.053640 },
+	{ 1.000000, 0.362950, 0.055060 },
+	{ 1.000000, 0.365200, 0.056480 },
+	{ 1.000000, 0.367450, 0.057900 },
+	{ 1.000000, 0.369700, 0.059320 },
+	{ 1.000000, 0.371950, 0.060740 },
+	{ 1.000000, 0.374200, 0.062160 },
+	{ 1.000000, 0.376450, 0.063580 },
+	{ 1.000000, 0.378700, 0.065000 },
+	{ 1.000000, 0.380910, 0.066520 },
+	{ 1.000000, 0.383120, 0.068040 },
+	{ 1.000000, 0.385330, 0.069560 },
+	{ 1.000000, 0.387540, 0.071080 },
+	{ 1.000000, 0.389750, 0.072600 },
+	{ 1.000000, 0.391960, 0.074120 },
+	{ 1.000000, 0.394170, 0.075640 },
+	{ 1.000000, 0.396380, 0.077160 },
+	{ 1.000000, 0.398590, 0.078680 },
+	{ 1.000000, 0.400800, 0.080200 },
+	{ 1.000000, 0.402990, 0.081820 },
+	{ 1.000000, 0.405180, 0.083440 },
+	{ 1.000000, 0.407370, 0.085060 },
+	{ 1.000000, 0.409560, 0.086680 },
+	{ 1.000000, 0.411750, 0.088300 },
+	{ 1.000000, 0.413940, 0.089920 },
+	{ 1.000000, 0.416130, 0.091540 },
+	{ 1.000000, 0.418320, 0.093160 },
+	{ 1.000000, 0.420510, 0.094780 },
+	{ 1.000000, 0.422700, 0.096400 },
+	{ 1.000000, 0.424850, 0.098120 },
+	{ 1.000000, 0.427000, 0.099840 },
+	{ 1.000000, 0.429150, 0.101560 },
+	{ 1.000000, 0.431300, 0.103280 },
+	{ 1.000000, 0.433450, 0.105000 },
+	{ 1.000000, 0.435600, 0.106720 },
+	{ 1.000000, 0.437750, 0.108440 },
+	{ 1.000000, 0.439900, 0.110160 },
+	{ 1.000000, 0.442050, 0.111880 },
+	{ 1.000000, 0.444200, 0.113600 },
+	{ 1.000000, 0.446300, 0.115400 },
+	{ 1.000000, 0.448400, 0.117200 },
+	{ 1.000000, 0.450500, 0.119000 },
+	{ 1.000000, 0.452600, 0.120800 },
+	{ 1.000000, 0.454700, 0.122600 },
+	{ 1.000000, 0.456800, 0.124400 },
+	{ 1.000000, 0.458900, 0.126200 },
+	{ 1.000000, 0.461000, 0.128000 },
+	{ 1.000000, 0.463100, 0.129800 },
+	{ 1.000000, 0.465200, 0.131600 },
+	{ 1.000000, 0.467270, 0.133490 },
+	{ 1.000000, 0.469340, 0.135380 },
+	{ 1.000000, 0.471410, 0.137270 },
+	{ 1.000000, 0.473480, 0.139160 },
+	{ 1.000000, 0.475550, 0.141050 },
+	{ 1.000000, 0.477620, 0.142940 },
+	{ 1.000000, 0.479690, 0.144830 },
+	{ 1.000000, 0.481760, 0.146720 },
+	{ 1.000000, 0.483830, 0.148610 },
+	{ 1.000000, 0.485900, 0.150500 }, /* 3000K */
+	{ 1.000000, 0.487930, 0.152470 },
+	{ 1.000000, 0.489960, 0.154440 },
+	{ 1.000000, 0.491990, 0.156410 },
+	{ 1.000000, 0.494020, 0.158380 },
+	{ 1.000000, 0.496050, 0.160350 },
+	{ 1.000000, 0.498080, 0.162320 },
+	{ 1.000000, 0.500110, 0.164290 },
+	{ 1.000000, 0.502140, 0.166260 },
+	{ 1.000000, 0.504170, 0.168230 },
+	{ 1.000000, 0.506200, 0.170200 },
+	{ 1.000000, 0.508200, 0.172250 },
+	{ 1.000000, 0.510200, 0.174300 },
+	{ 1.000000, 0.512200, 0.176350 },
+	{ 1.000000, 0.514200, 0.178400 },
+	{ 1.000000, 0.516200, 0.180450 },
+	{ 1.000000, 0.518200, 0.182500 },
+	{ 1.000000, 0.520200, 0.184550 },
+	{ 1.000000, 0.522200, 0.186600 },
+	{ 1.000000, 0.524200, 0.188650 },
+	{ 1.000000, 0.526200, 0.190700 },
+	{ 1.000000, 0.528160, 0.192810 },
+	{ 1.000000, 0.530120, 0.194920 },
+	{ 1.000000, 0.532080, 0.197030 },
+	{ 1.000000, 0.534040, 0.199140 },
+	{ 1.000000, 0.536000, 0.201250 },
+	{ 1.000000, 0.537960, 0.203360 },
+	{ 1.000000, 0.539920, 0.205470 },
+	{ 1.000000, 0.541880, 0.207580 },
+	{ 1.000000, 0.543840, 0.209690 },
+	{ 1.000000, 0.545800, 0.211800 },
+	{ 1.000000, 0.547720, 0.213970 },
+	{ 1.000000, 0.549640, 0.216140 },
+	{ 1.000000, 0.551560, 0.218310 },
+	{ 1.000000, 0.553480, 0.220480 },
+	{ 1.000000, 0.555400, 0.222650 },
+	{ 1.000000, 0.557320, 0.224820 },
+	{ 1.000000, 0.559240, 0.226990 },
+	{ 1.000000, 0.561160, 0.229160 },
+	{ 1.000000, 0.563080, 0.231330 },
+	{ 1.000000, 0.565000, 0.233500 },
+	{ 1.000000, 0.566890, 0.235730 },
+	{ 1.000000, 0.568780, 0.237960 },
+	{ 1.000000, 0.570670, 0.240190 },
+	{ 1.000000, 0.572560, 0.242420 },
+	{ 1.000000, 0.574450, 0.244650 },
+	{ 1.000000, 0.576340, 0.246880 },
+	{ 1.000000, 0.578230, 0.249110 },
+	{ 1.000000, 0.580120, 0.251340 },
+	{ 1.000000, 0.582010, 0.253570 },
+	{ 1.000000, 0.583900, 0.255800 },
+	{ 1.000000, 0.585740, 0.258080 },
+	{ 1.000000, 0.587580, 0.260360 },
+	{ 1.000000, 0.589420, 0.262640 },
+	{ 1.000000, 0.591260, 0.264920 },
+	{ 1.000000, 0.593100, 0.267200 },
+	{ 1.000000, 0.594940, 0.269480 },
+	{ 1.000000, 0.596780, 0.271760 },
+	{ 1.000000, 0.598620, 0.274040 },
+	{ 1.000000, 0.600460, 0.276320 },
+	{ 1.000000, 0.602300, 0.278600 },
+	{ 1.000000, 0.604110, 0.280920 },
+	{ 1.000000, 0.605920, 0.283240 },
+	{ 1.000000, 0.607730, 0.285560 },
+	{ 1.000000, 0.609540, 0.287880 },
+	{ 1.000000, 0.611350, 0.290200 },
+	{ 1.000000, 0.613160, 0.292520 },
+	{ 1.000000, 0.614970, 0.294840 },
+	{ 1.000000, 0.616780, 0.297160 },
+	{ 1.000000, 0.618590, 0.299480 },
+	{ 1.000000, 0.620400, 0.301800 },
+	{ 1.000000, 0.622180, 0.304170 },
+	{ 1.000000, 0.623960, 0.306540 },
+	{ 1.000000, 0.625740, 0.308910 },
+	{ 1.000000, 0.627520, 0.311280 },
+	{ 1.000000, 0.629300, 0.313650 },
+	{ 1.000000, 0.631080, 0.316020 },
+	{ 1.000000, 0.632860, 0.318390 },
+	{ 1.000000, 0.634640, 0.320760 },
+	{ 1.000000, 0.636420, 0.323130 },
+	{ 1.000000, 0.638200, 0.325500 },
+	{ 1.000000, 0.639950, 0.327900 },
+	{ 1.000000, 0.641700, 0.330300 },
+	{ 1.000000, 0.643450, 0.332700 },
+	{ 1.000000, 0.645200, 0.335100 },
+	{ 1.000000, 0.646950, 0.337500 },
+	{ 1.000000, 0.648700, 0.339900 },
+	{ 1.000000, 0.650450, 0.342300 },
+	{ 1.000000, 0.652200, 0.344700 },
+	{ 1.000000, 0.653950, 0.347100 },
+	{ 1.000000, 0.655700, 0.349500 },
+	{ 1.000000, 0.657400, 0.351940 },
+	{ 1.000000, 0.659100, 0.354380 },
+	{ 1.000000, 0.660800, 0.356820 },
+	{ 1.000000, 0.662500, 0.359260 },
+	{ 1.000000, 0.664200, 0.361700 },
+	{ 1.000000, 0.665900, 0.364140 },
+	{ 1.000000, 0.667600, 0.366580 },
+	{ 1.000000, 0.669300, 0.369020 },
+	{ 1.000000, 0.671000, 0.371460 },
+	{ 1.000000, 0.672700, 0.373900 }, /* 4000K */
+	{ 1.000000, 0.674370, 0.376370 },
+	{ 1.000000, 0.676040, 0.378840 },
+	{ 1.000000, 0.677710, 0.381310 },
+	{ 1.000000, 0.679380, 0.383780 },
+	{ 1.000000, 0.681050, 0.386250 },
+	{ 1.000000, 0.682720, 0.388720 },
+	{ 1.000000, 0.684390, 0.391190 },
+	{ 1.000000, 0.686060, 0.393660 },
+	{ 1.000000, 0.687730, 0.396130 },
+	{ 1.000000, 0.689400, 0.398600 },
+	{ 1.000000, 0.691040, 0.401080 },
+	{ 1.000000, 0.692680, 0.403560 },
+	{ 1.000000, 0.694320, 0.406040 },
+	{ 1.000000, 0.695960, 0.408520 },
+	{ 1.000000, 0.697600, 0.411000 },
+	{ 1.000000, 0.699240, 0.413480 },
+	{ 1.000000, 0.700880, 0.415960 },
+	{ 1.000000, 0.702520, 0.418440 },
+	{ 1.000000, 0.704160, 0.420920 },
+	{ 1.000000, 0.705800, 0.423400 },
+	{ 1.000000, 0.707400, 0.425910 },
+	{ 1.000000, 0.709000, 0.428420 },
+	{ 1.000000, 0.710600, 0.430930 },
+	{ 1.000000, 0.712200, 0.433440 },
+	{ 1.000000, 0.713800, 0.435950 },
+	{ 1.000000, 0.715400, 0.438460 },
+	{ 1.000000, 0.717000, 0.440970 },
+	{ 1.000000, 0.718600, 0.443480 },
+	{ 1.000000, 0.720200, 0.445990 },
+	{ 1.000000, 0.721800, 0.448500 },
+	{ 1.000000, 0.723370, 0.451030 },
+	{ 1.000000, 0.724940, 0.453560 },
+	{ 1.000000, 0.726510, 0.456090 },
+	{ 1.000000, 0.728080, 0.458620 },
+	{ 1.000000, 0.729650, 0.461150 },
+	{ 1.000000, 0.731220, 0.463680 },
+	{ 1.000000, 0.732790, 0.466210 },
+	{ 1.000000, 0.734360, 0.468740 },
+	{ 1.000000, 0.735930, 0.471270 },
+	{ 1.000000, 0.737500, 0.473800 },
+	{ 1.000000, 0.739040, 0.476340 },
+	{ 1.000000, 0.740580, 0.478880 },
+	{ 1.000000, 0.742120, 0.481420 },
+	{ 1.000000, 0.743660, 0.483960 },
+	{ 1.000000, 0.745200, 0.486500 },
+	{ 1.000000, 0.746740, 0.489040 },
+	{ 1.000000, 0.748280, 0.491580 },
+	{ 1.000000, 0.749820, 0.494120 },
+	{ 1.000000, 0.751360, 0.496660 },
+	{ 1.000000, 0.752900, 0.499200 },
+	{ 1.000000, 0.754400, 0.501750 },
+	{ 1.000000, 0.755900, 0.504300 },
+	{ 1.000000, 0.757400, 0.506850 },
+	{ 1.000000, 0.758900, 0.509400 },
+	{ 1.000000, 0.760400, 0.511950 },
+	{ 1.000000, 0.761900, 0.514500 },
+	{ 1.000000, 0.763400, 0.517050 },
+	{ 1.000000, 0.764900, 0.519600 },
+	{ 1.000000, 0.766400, 0.522150 },
+	{ 1.000000, 0.767900, 0.524700 },
+	{ 1.000000, 0.769370, 0.527260 },
+	{ 1.000000, 0.770840, 0.529820 },
+	{ 1.000000, 0.772310, 0.532380 },
+	{ 1.000000, 0.773780, 0.534940 },
+	{ 1.000000, 0.775250, 0.537500 },
+	{ 1.000000, 0.776720, 0.540060 },
+	{ 1.000000, 0.778190, 0.542620 },
+	{ 1.000000, 0.779660, 0.545180 },
+	{ 1.000000, 0.781130, 0.547740 },
+	{ 1.000000, 0.782600, 0.550300 },
+	{ 1.000000, 0.784040, 0.552870 },
+	{ 1.000000, 0.785480, 0.555440 },
+	{ 1.000000, 0.786920, 0.558010 },
+	{ 1.000000, 0.788360, 0.560580 },
+	{ 1.000000, 0.789800, 0.563150 },
+	{ 1.000000, 0.791240, 0.565720 },
+	{ 1.000000, 0.792680, 0.568290 },
+	{ 1.000000, 0.794120, 0.570860 },
+	{ 1.000000, 0.795560, 0.573430 },
+	{ 1.000000, 0.797000, 0.576000 },
+	{ 1.000000, 0.798410, 0.578560 },
+	{ 1.000000, 0.799820, 0.581120 },
+	{ 1.000000, 0.801230, 0.583680 },
+	{ 1.000000, 0.802640, 0.586240 },
+	{ 1.000000, 0.804050, 0.588800 },
+	{ 1.000000, 0.805460, 0.591360 },
+	{ 1.000000, 0.806870, 0.593920 },
+	{ 1.000000, 0.808280, 0.596480 },
+	{ 1.000000, 0.809690, 0.599040 },
+	{ 1.000000, 0.811100, 0.601600 },
+	{ 1.000000, 0.812490, 0.604160 },
+	{ 1.000000, 0.813880, 0.606720 },
+	{ 1.000000, 0.815270, 0.609280 },
+	{ 1.000000, 0.816660, 0.611840 },
+	{ 1.000000, 0.818050, 0.614400 },
+	{ 1.000000, 0.819440, 0.616960 },
+	{ 1.000000, 0.820830, 0.619520 },
+	{ 1.000000, 0.822220, 0.622080 },
+	{ 1.000000, 0.823610, 0.624640 },
+	{ 1.000000, 0.825000, 0.627200 }, /* 5000K */
+	{ 1.000000, 0.826340, 0.629770 },
+	{ 1.000000, 0.827680, 0.632340 },
+	{ 1.000000, 0.829020, 0.634910 },
+	{ 1.000000, 0.830360, 0.637480 },
+	{ 1.000000, 0.831700, 0.640050 },
+	{ 1.000000, 0.833040, 0.642620 },
+	{ 1.000000, 0.834380, 0.645190 },
+	{ 1.000000, 0.835720, 0.647760 },
+	{ 1.000000, 0.837060, 0.650330 },
+	{ 1.000000, 0.838400, 0.652900 },
+	{ 1.000000, 0.839730, 0.655460 },
+	{ 1.000000, 0.841060, 0.658020 },
+	{ 1.000000, 0.842390, 0.660580 },
+	{ 1.000000, 0.843720, 0.663140 },
+	{ 1.000000, 0.845050, 0.665700 },
+	{ 1.000000, 0.846380, 0.668260 },
+	{ 1.000000, 0.847710, 0.670820 },
+	{ 1.000000, 0.849040, 0.673380 },
+	{ 1.000000, 0.850370, 0.675940 },
+	{ 1.000000, 0.851700, 0.678500 },
+	{ 1.000000, 0.853000, 0.681050 },
+	{ 1.000000, 0.854300, 0.683600 },
+	{ 1.000000, 0.855600, 0.686150 },
+	{ 1.000000, 0.856900, 0.688700 },
+	{ 1.000000, 0.858200, 0.691250 },
+	{ 1.000000, 0.859500, 0.693800 },
+	{ 1.000000, 0.860800, 0.696350 },
+	{ 1.000000, 0.862100, 0.698900 },
+	{ 1.000000, 0.863400, 0.701450 },
+	{ 1.000000, 0.864700, 0.704000 },
+	{ 1.000000, 0.865960, 0.706540 },
+	{ 1.000000, 0.867220, 0.709080 },
+	{ 1.000000, 0.868480, 0.711620 },
+	{ 1.000000, 0.869740, 0.714160 },
+	{ 1.000000, 0.871000, 0.716700 },
+	{ 1.000000, 0.872260, 0.719240 },
+	{ 1.000000, 0.873520, 0.721780 },
+	{ 1.000000, 0.874780, 0.724320 },
+	{ 1.000000, 0.876040, 0.726860 },
+	{ 1.000000, 0.877300, 0.729400 },
+	{ 1.000000, 0.878540, 0.731940 },
+	{ 1.000000, 0.879780, 0.734480 },
+	{ 1.000000, 0.881020, 0.737020 },
+	{ 1.000000, 0.882260, 0.739560 },
+	{ 1.000000, 0.883500, 0.742100 },
+	{ 1.000000, 0.884740, 0.744640 },
+	{ 1.000000, 0.885980, 0.747180 },
+	{ 1.000000, 0.887220, 0.749720 },
+	{ 1.000000, 0.888460, 0.752260 },
+	{ 1.000000, 0.889700, 0.754800 },
+	{ 1.000000, 0.890920, 0.757330 },
+	{ 1.000000, 0.892140, 0.759860 },
+	{ 1.000000, 0.893360, 0.762390 },
+	{ 1.000000, 0.894580, 0.764920 },
+	{ 1.000000, 0.895800, 0.767450 },
+	{ 1.000000, 0.897020, 0.769980 },
+	{ 1.000000, 0.898240, 0.772510 },
+	{ 1.000000, 0.899460, 0.775040 },
+	{ 1.000000, 0.900680, 0.777570 },
+	{ 1.000000, 0.901900, 0.780100 },
+	{ 1.000000, 0.903080, 0.782600 },
+	{ 1.000000, 0.904260, 0.785100 },
+	{ 1.000000, 0.905440, 0.787600 },
+	{ 1.000000, 0.906620, 0.790100 },
+	{ 1.000000, 0.907800, 0.792600 },
+	{ 1.000000, 0.908980, 0.795100 },
+	{ 1.000000, 0.910160, 0.797600 },
+	{ 1.000000, 0.911340, 0.800100 },
+	{ 1.000000, 0.912520, 0.802600 },
+	{ 1.000000, 0.913700, 0.805100 },
+	{ 1.000000, 0.914870, 0.807600 },
+	{ 1.000000, 0.916040, 0.810100 },
+	{ 1.000000, 0.917210, 0.812600 },
+	{ 1.000000, 0.918380, 0.815100 },
+	{ 1.000000, 0.919550, 0.817600 },
+	{ 1.000000, 0.920720, 0.820100 },
+	{ 1.000000, 0.921890, 0.822600 },
+	{ 1.000000, 0.923060, 0.825100 },
+	{ 1.000000, 0.924230, 0.827600 },
+	{ 1.000000, 0.925400, 0.830100 },
+	{ 1.000000, 0.926530, 0.832590 },
+	{ 1.000000, 0.927660, 0.835080 },
+	{ 1.000000, 0.928790, 0.837570 },
+	{ 1.000000, 0.929920, 0.840060 },
+	{ 1.000000, 0.931050, 0.842550 },
+	{ 1.000000, 0.932180, 0.845040 },
+	{ 1.000000, 0.933310, 0.847530 },
+	{ 1.000000, 0.934440, 0.850020 },
+	{ 1.000000, 0.935570, 0.852510 },
+	{ 1.000000, 0.936700, 0.855000 },
+	{ 1.000000, 0.937810, 0.857450 },
+	{ 1.000000, 0.938920, 0.859900 },
+	{ 1.000000, 0.940030, 0.862350 },
+	{ 1.000000, 0.941140, 0.864800 },
+	{ 1.000000, 0.942250, 0.867250 },
+	{ 1.000000, 0.943360, 0.869700 },
+	{ 1.000000, 0.944470, 0.872150 },
+	{ 1.000000, 0.945580, 0.874600 },
+	{ 1.000000, 0.946690, 0.877050 },
+	{ 1.000000, 0.947800, 0.879500 }, /* 6000K */
+	{ 1.000000, 0.948890, 0.881950 },
+	{ 1.000000, 0.949980, 0.884400 },
+	{ 1.000000, 0.951070, 0.886850 },
+	{ 1.000000, 0.952160, 0.889300 },
+	{ 1.000000, 0.953250, 0.891750 },
+	{ 1.000000, 0.954340, 0.894200 },
+	{ 1.000000, 0.955430, 0.896650 },
+	{ 1.000000, 0.956520, 0.899100 },
+	{ 1.000000, 0.957610, 0.901550 },
+	{ 1.000000, 0.958700, 0.904000 },
+	{ 1.000000, 0.959770, 0.906430 },
+	{ 1.000000, 0.960840, 0.908860 },
+	{ 1.000000, 0.961910, 0.911290 },
+	{ 1.000000, 0.962980, 0.913720 },
+	{ 1.000000, 0.964050, 0.916150 },
+	{ 1.000000, 0.965120, 0.918580 },
+	{ 1.000000, 0.966190, 0.921010 },
+	{ 1.000000, 0.967260, 0.923440 },
+	{ 1.000000, 0.968330, 0.925870 },
+	{ 1.000000, 0.969400, 0.928300 },
+	{ 1.000000, 0.970440, 0.930710 },
+	{ 1.000000, 0.971480, 0.933120 },
+	{ 1.000000, 0.972520, 0.935530 },
+	{ 1.000000, 0.973560, 0.937940 },
+	{ 1.000000, 0.974600, 0.940350 },
+	{ 1.000000, 0.975640, 0.942760 },
+	{ 1.000000, 0.976680, 0.945170 },
+	{ 1.000000, 0.977720, 0.947580 },
+	{ 1.000000, 0.978760, 0.949990 },
+	{ 1.000000, 0.979800, 0.952400 },
+	{ 1.000000, 0.980820, 0.954790 },
+	{ 1.000000, 0.981840, 0.957180 },
+	{ 1.000000, 0.982860, 0.959570 },
+	{ 1.000000, 0.983880, 0.961960 },
+	{ 1.000000, 0.984900, 0.964350 },
+	{ 1.000000, 0.985920, 0.966740 },
+	{ 1.000000, 0.986940, 0.969130 },
+	{ 1.000000, 0.987960, 0.971520 },
+	{ 1.000000, 0.988980, 0.973910 },
+	{ 1.000000, 0.990000, 0.976300 },
+	{ 1.000000, 0.991000, 0.978670 },
+	{ 1.000000, 0.992000, 0.981040 },
+	{ 1.000000, 0.993000, 0.983410 },
+	{ 1.000000, 0.994000, 0.985780 },
+	{ 1.000000, 0.995000, 0.988150 },
+	{ 1.000000, 0.996000, 0.990520 },
+	{ 1.000000, 0.997000, 0.992890 },
+	{ 1.000000, 0.998000, 0.995260 },
+	{ 1.000000, 0.999000, 0.997630 },
+	{ 1.000000, 1.000000, 1.000000 },
+	{ 0.997710, 0.998670, 1.000000 },
+	{ 0.995420, 0.997340, 1.000000 },
+	{ 0.993130, 0.996010, 1.000000 },
+	{ 0.990840, 0.994680, 1.000000 },
+	{ 0.988550, 0.993350, 1.000000 },
+	{ 0.986260, 0.992020, 1.000000 },
+	{ 0.983970, 0.990690, 1.000000 },
+	{ 0.981680, 0.989360, 1.000000 },
+	{ 0.979390, 0.988030, 1.000000 },
+	{ 0.977100, 0.986700, 1.000000 },
+	{ 0.974930, 0.985430, 1.000000 },
+	{ 0.972760, 0.984160, 1.000000 },
+	{ 0.970590, 0.982890, 1.000000 },
+	{ 0.968420, 0.981620, 1.000000 },
+	{ 0.966250, 0.980350, 1.000000 },
+	{ 0.964080, 0.979080, 1.000000 },
+	{ 0.961910, 0.977810, 1.000000 },
+	{ 0.959740, 0.976540, 1.000000 },
+	{ 0.957570, 0.975270, 1.000000 },
+	{ 0.955400, 0.974000, 1.000000 },
+	{ 0.953350, 0.972780, 1.000000 },
+	{ 0.951300, 0.971560, 1.000000 },
+	{ 0.949250, 0.970340, 1.000000 },
+	{ 0.947200, 0.969120, 1.000000 },
+	{ 0.945150, 0.967900, 1.000000 },
+	{ 0.943100, 0.966680, 1.000000 },
+	{ 0.941050, 0.965460, 1.000000 },
+	{ 0.939000, 0.964240, 1.000000 },
+	{ 0.936950, 0.963020, 1.000000 },
+	{ 0.934900, 0.961800, 1.000000 },
+	{ 0.932950, 0.960620, 1.000000 },
+	{ 0.931000, 0.959440, 1.000000 },
+	{ 0.929050, 0.958260, 1.000000 },
+	{ 0.927100, 0.957080, 1.000000 },
+	{ 0.925150, 0.955900, 1.000000 },
+	{ 0.923200, 0.954720, 1.000000 },
+	{ 0.921250, 0.953540, 1.000000 },
+	{ 0.919300, 0.952360, 1.000000 },
+	{ 0.917350, 0.951180, 1.000000 },
+	{ 0.915400, 0.950000, 1.000000 },
+	{ 0.913540, 0.948890, 1.000000 },
+	{ 0.911680, 0.947780, 1.000000 },
+	{ 0.909820, 0.946670, 1.000000 },
+	{ 0.907960, 0.945560, 1.000000 },
+	{ 0.906100, 0.944450, 1.000000 },
+	{ 0.904240, 0.943340, 1.000000 },
+	{ 0.902380, 0.942230, 1.000000 },
+	{ 0.900520, 0.941120, 1.000000 },
+	{ 0.898660, 0.940010, 1.000000 },
+	{ 0.896800, 0.938900, 1.000000 }, /* 7000K */
+	{ 0.895040, 0.937830, 1.000000 },
+	{ 0.893280, 0.936760, 1.000000 },
+	{ 0.891520, 0.935690, 1.000000 },
+	{ 0.889760, 0.934620, 1.000000 },
+	{ 0.888000, 0.933550, 1.000000 },
+	{ 0.886240, 0.932480, 1.000000 },
+	{ 0.884480, 0.931410, 1.000000 },
+	{ 0.882720, 0.930340, 1.000000 },
+	{ 0.880960, 0.929270, 1.000000 },
+	{ 0.879200, 0.928200, 1.000000 },
+	{ 0.877520, 0.927170, 1.000000 },
+	{ 0.875840, 0.926140, 1.000000 },
+	{ 0.874160, 0.925110, 1.000000 },
+	{ 0.872480, 0.924080, 1.000000 },
+	{ 0.870800, 0.923050, 1.000000 },
+	{ 0.869120, 0.922020, 1.000000 },
+	{ 0.867440, 0.920990, 1.000000 },
+	{ 0.865760, 0.919960, 1.000000 },
+	{ 0.864080, 0.918930, 1.000000 },
+	{ 0.862400, 0.917900, 1.000000 },
+	{ 0.860810, 0.916910, 1.000000 },
+	{ 0.859220, 0.915920, 1.000000 },
+	{ 0.857630, 0.914930, 1.000000 },
+	{ 0.856040, 0.913940, 1.000000 },
+	{ 0.854450, 0.912950, 1.000000 },
+	{ 0.852860, 0.911960, 1.000000 },
+	{ 0.851270, 0.910970, 1.000000 },
+	{ 0.849680, 0.909980, 1.000000 },
+	{ 0.848090, 0.908990, 1.000000 },
+	{ 0.846500, 0.908000, 1.000000 },
+	{ 0.844980, 0.907060, 1.000000 },
+	{ 0.843460, 0.906120, 1.000000 },
+	{ 0.841940, 0.905180, 1.000000 },
+	{ 0.840420, 0.904240, 1.000000 },
+	{ 0.838900, 0.903300, 1.000000 },
+	{ 0.837380, 0.902360, 1.000000 },
+	{ 0.835860, 0.901420, 1.000000 },
+	{ 0.834340, 0.900480, 1.000000 },
+	{ 0.832820, 0.899540, 1.000000 },
+	{ 0.831300, 0.898600, 1.000000 },
+	{ 0.829840, 0.897690, 1.000000 },
+	{ 0.828380, 0.896780, 1.000000 },
+	{ 0.826920, 0.895870, 1.000000 },
+	{ 0.825460, 0.894960, 1.000000 },
+	{ 0.824000, 0.894050, 1.000000 },
+	{ 0.822540, 0.893140, 1.000000 },
+	{ 0.821080, 0.892230, 1.000000 },
+	{ 0.819620, 0.891320, 1.000000 },
+	{ 0.818160, 0.890410, 1.000000 },
+	{ 0.816700, 0.889500, 1.000000 },
+	{ 0.815320, 0.888630, 1.000000 },
+	{ 0.813940, 0.887760, 1.000000 },
+	{ 0.812560, 0.886890, 1.000000 },
+	{ 0.811180, 0.886020, 1.000000 },
+	{ 0.809800, 0.885150, 1.000000 },
+	{ 0.808420, 0.884280, 1.000000 },
+	{ 0.807040, 0.883410, 1.000000 },
+	{ 0.805660, 0.882540, 1.000000 },
+	{ 0.804280, 0.881670, 1.000000 },
+	{ 0.802900, 0.880800, 1.000000 },
+	{ 0.801570, 0.879960, 1.000000 },
+	{ 0.800240, 0.879120, 1.000000 },
+	{ 0.798910, 0.878280, 1.000000 },
+	{ 0.797580, 0.877440, 1.000000 },
+	{ 0.796250, 0.876600, 1.000000 },
+	{ 0.794920, 0.875760, 1.000000 },
+	{ 0.793590, 0.874920, 1.000000 },
+	{ 0.792260, 0.874080, 1.000000 },
+	{ 0.790930, 0.873240, 1.000000 },
+	{ 0.789600, 0.872400, 1.000000 },
+	{ 0.788330, 0.871590, 1.000000 },
+	{ 0.787060, 0.870780, 1.000000 },
+	{ 0.785790, 0.869970, 1.000000 },
+	{ 0.784520, 0.869160, 1.000000 },
+	{ 0.783250, 0.868350, 1.000000 },
+	{ 0.781980, 0.867540, 1.000000 },
+	{ 0.780710, 0.866730, 1.000000 },
+	{ 0.779440, 0.865920, 1.000000 },
+	{ 0.778170, 0.865110, 1.000000 },
+	{ 0.776900, 0.864300, 1.000000 },
+	{ 0.775690, 0.863520, 1.000000 },
+	{ 0.774480, 0.862740, 1.000000 },
+	{ 0.773270, 0.861960, 1.000000 },
+	{ 0.772060, 0.861180, 1.000000 },
+	{ 0.770850, 0.860400, 1.000000 },
+	{ 0.769640, 0.859620, 1.000000 },
+	{ 0.768430, 0.858840, 1.000000 },
+	{ 0.767220, 0.858060, 1.000000 },
+	{ 0.766010, 0.857280, 1.000000 },
+	{ 0.764800, 0.856500, 1.000000 },
+	{ 0.763640, 0.855750, 1.000000 },
+	{ 0.762480, 0.855000, 1.000000 },
+	{ 0.761320, 0.854250, 1.000000 },
+	{ 0.760160, 0.853500, 1.000000 },
+	{ 0.759000, 0.852750, 1.000000 },
+	{ 0.757840, 0.852000, 1.000000 },
+	{ 0.756680, 0.851250, 1.000000 },
+	{ 0.755520, 0.850500, 1.000000 },
+	{ 0.754360, 0.849750, 1.000000 },
+	{ 0.753200, 0.849000, 1.000000 }, /* 8000K */
+	{ 0.752080, 0.848280, 1.000000 },
+	{ 0.750960, 0.847560, 1.000000 },
+	{ 0.749840, 0.846840, 1.000000 },
+	{ 0.748720, 0.846120, 1.000000 },
+	{ 0.747600, 0.845400, 1.000000 },
+	{ 0.746480, 0.844680, 1.000000 },
+	{ 0.745360, 0.843960, 1.000000 },
+	{ 0.744240, 0.843240, 1.000000 },
+	{ 0.743120, 0.842520, 1.000000 },
+	{ 0.742000, 0.841800, 1.000000 },
+	{ 0.740940, 0.841100, 1.000000 },
+	{ 0.739880, 0.840400, 1.000000 },
+	{ 0.738820, 0.839700, 1.000000 },
+	{ 0.737760, 0.839000, 1.000000 },
+	{ 0.736700, 0.838300, 1.000000 },
+	{ 0.735640, 0.837600, 1.000000 },
+	{ 0.734580, 0.836900, 1.000000 },
+	{ 0.733520, 0.836200, 1.000000 },
+	{ 0.732460, 0.835500, 1.000000 },
+	{ 0.731400, 0.834800, 1.000000 },
+	{ 0.730380, 0.834130, 1.000000 },
+	{ 0.729360, 0.833460, 1.000000 },
+	{ 0.728340, 0.832790, 1.000000 },
+	{ 0.727320, 0.832120, 1.000000 },
+	{ 0.726300, 0.831450, 1.000000 },
+	{ 0.725280, 0.830780, 1.000000 },
+	{ 0.724260, 0.830110, 1.000000 },
+	{ 0.723240, 0.829440, 1.000000 },
+	{ 0.722220, 0.828770, 1.000000 },
+	{ 0.721200, 0.828100, 1.000000 },
+	{ 0.720210, 0.827450, 1.000000 },
+	{ 0.719220, 0.826800, 1.000000 },
+	{ 0.718230, 0.826150, 1.000000 },
+	{ 0.717240, 0.825500, 1.000000 },
+	{ 0.716250, 0.824850, 1.000000 },
+	{ 0.715260, 0.824200, 1.000000 },
+	{ 0.714270, 0.823550, 1.000000 },
+	{ 0.713280, 0.822900, 1.000000 },
+	{ 0.712290, 0.822250, 1.000000 },
+	{ 0.711300, 0.821600, 1.000000 },
+	{ 0.710350, 0.820970, 1.000000 },
+	{ 0.709400, 0.820340, 1.000000 },
+	{ 0.708450, 0.819710, 1.000000 },
+	{ 0.707500, 0.819080, 1.000000 },
+	{ 0.706550, 0.818450, 1.000000 },
+	{ 0.705600, 0.817820, 1.000000 },
+	{ 0.704650, 0.817190, 1.000000 },
+	{ 0.703700, 0.816560, 1.000000 },
+	{ 0.702750, 0.815930, 1.000000 },
+	{ 0.701800, 0.815300, 1.000000 },
+	{ 0.700890, 0.814690, 1.000000 },
+	{ 0.699980, 0.814080, 1.000000 },
+	{ 0.699070, 0.813470, 1.000000 },
+	{ 0.698160, 0.812860, 1.000000 },
+	{ 0.697250, 0.812250, 1.000000 },
+	{ 0.696340, 0.811640, 1.000000 },
+	{ 0.695430, 0.811030, 1.000000 },
+	{ 0.694520, 0.810420, 1.000000 },
+	{ 0.693610, 0.809810, 1.000000 },
+	{ 0.692700, 0.809200, 1.000000 },
+	{ 0.691820, 0.808600, 1.000000 },
+	{ 0.690940, 0.808000, 1.000000 },
+	{ 0.690060, 0.807400, 1.000000 },
+	{ 0.689180, 0.806800, 1.000000 },
+	{ 0.688300, 0.806200, 1.000000 },
+	{ 0.687420, 0.805600, 1.000000 },
+	{ 0.686540, 0.805000, 1.000000 },
+	{ 0.685660, 0.804400, 1.000000 },
+	{ 0.684780, 0.803800, 1.000000 },
+	{ 0.683900, 0.803200, 1.000000 },
+	{ 0.683060, 0.802630, 1.000000 },
+	{ 0.682220, 0.802060, 1.000000 },
+	{ 0.681380, 0.801490, 1.000000 },
+	{ 0.680540, 0.800920, 1.000000 },
+	{ 0.679700, 0.800350, 1.000000 },
+	{ 0.678860, 0.799780, 1.000000 },
+	{ 0.678020, 0.799210, 1.000000 },
+	{ 0.677180, 0.798640, 1.000000 },
+	{ 0.676340, 0.798070, 1.000000 },
+	{ 0.675500, 0.797500, 1.000000 },
+	{ 0.674690, 0.796960, 1.000000 },
+	{ 0.673880, 0.796420, 1.000000 },
+	{ 0.673070, 0.795880, 1.000000 },
+	{ 0.672260, 0.795340, 1.000000 },
+	{ 0.671450, 0.794800, 1.000000 },
+	{ 0.670640, 0.794260, 1.000000 },
+	{ 0.669830, 0.793720, 1.000000 },
+	{ 0.669020, 0.793180, 1.000000 },
+	{ 0.668210, 0.792640, 1.000000 },
+	{ 0.667400, 0.792100, 1.000000 },
+	{ 0.666610, 0.791560, 1.000000 },
+	{ 0.665820, 0.791020, 1.000000 },
+	{ 0.665030, 0.790480, 1.000000 },
+	{ 0.664240, 0.789940, 1.000000 },
+	{ 0.663450, 0.789400, 1.000000 },
+	{ 0.662660, 0.788860, 1.000000 },
+	{ 0.661870, 0.788320, 1.000000 },
+	{ 0.661080, 0.787780, 1.000000 },
+	{ 0.660290, 0.787240, 1.000000 },
+	{ 0.659500, 0.786700, 1.000000 }, /* 9000K */
+	{ 0.658750, 0.786190, 1.000000 },
+	{ 0.658000, 0.785680, 1.000000 },
+	{ 0.657250, 0.785170, 1.000000 },
+	{ 0.656500, 0.784660, 1.000000 },
+	{ 0.655750, 0.784150, 1.000000 },
+	{ 0.655000, 0.783640, 1.000000 },
+	{ 0.654250, 0.783130, 1.000000 },
+	{ 0.653500, 0.782620, 1.000000 },
+	{ 0.652750, 0.782110, 1.000000 },
+	{ 0.652000, 0.781600, 1.000000 },
+	{ 0.651270, 0.781090, 1.000000 },
+	{ 0.650540, 0.780580, 1.000000 },
+	{ 0.649810, 0.780070, 1.000000 },
+	{ 0.649080, 0.779560, 1.000000 },
+	{ 0.648350, 0.779050, 1.000000 },
+	{ 0.647620, 0.778540, 1.000000 },
+	{ 0.646890, 0.778030, 1.000000 },
+	{ 0.646160, 0.777520, 1.000000 },
+	{ 0.645430, 0.777010, 1.000000 },
+	{ 0.644700, 0.776500, 1.000000 },
+	{ 0.643990, 0.776020, 1.000000 },
+	{ 0.643280, 0.775540, 1.000000 },
+	{ 0.642570, 0.775060, 1.000000 },
+	{ 0.641860, 0.774580, 1.000000 },
+	{ 0.641150, 0.774100, 1.000000 },
+	{ 0.640440, 0.773620, 1.000000 },
+	{ 0.639730, 0.773140, 1.000000 },
+	{ 0.639020, 0.772660, 1.000000 },
+	{ 0.638310, 0.772180, 1.000000 },
+	{ 0.637600, 0.771700, 1.000000 },
+	{ 0.636920, 0.771230, 1.000000 },
+	{ 0.636240, 0.770760, 1.000000 },
+	{ 0.635560, 0.770290, 1.000000 },
+	{ 0.634880, 0.769820, 1.000000 },
+	{ 0.634200, 0.769350, 1.000000 },
+	{ 0.633520, 0.768880, 1.000000 },
+	{ 0.632840, 0.768410, 1.000000 },
+	{ 0.632160, 0.767940, 1.000000 },
+	{ 0.631480, 0.767470, 1.000000 },
+	{ 0.630800, 0.767000, 1.000000 },
+	{ 0.630140, 0.766530, 1.000000 },
+	{ 0.629480, 0.766060, 1.000000 },
+	{ 0.628820, 0.765590, 1.000000 },
+	{ 0.628160, 0.765120, 1.000000 },
+	{ 0.627500, 0.764650, 1.000000 },
+	{ 0.626840, 0.764180, 1.000000 },
+	{ 0.626180, 0.763710, 1.000000 },
+	{ 0.625520, 0.763240, 1.000000 },
+	{ 0.624860, 0.762770, 1.000000 },
+	{ 0.624200, 0.762300, 1.000000 },
+	{ 0.623570, 0.761860, 1.000000 },
+	{ 0.622940, 0.761420, 1.000000 },
+	{ 0.622310, 0.760980, 1.000000 },
+	{ 0.621680, 0.760540, 1.000000 },
+	{ 0.621050, 0.760100, 1.000000 },
+	{ 0.620420, 0.759660, 1.000000 },
+	{ 0.619790, 0.759220, 1.000000 },
+	{ 0.619160, 0.758780, 1.000000 },
+	{ 0.618530, 0.758340, 1.000000 },
+	{ 0.617900, 0.757900, 1.000000 },
+	{ 0.617280, 0.757470, 1.000000 },
+	{ 0.616660, 0.757040, 1.000000 },
+	{ 0.616040, 0.756610, 1.000000 },
+	{ 0.615420, 0.756180, 1.000000 },
+	{ 0.614800, 0.755750, 1.000000 },
+	{ 0.614180, 0.755320, 1.000000 },
+	{ 0.613560, 0.754890, 1.000000 },
+	{ 0.612940, 0.754460, 1.000000 },
+	{ 0.612320, 0.754030, 1.000000 },
+	{ 0.611700, 0.753600, 1.000000 },
+	{ 0.611110, 0.753170, 1.000000 },
+	{ 0.610520, 0.752740, 1.000000 },
+	{ 0.609930, 0.752310, 1.000000 },
+	{ 0.609340, 0.751880, 1.000000 },
+	{ 0.608750, 0.751450, 1.000000 },
+	{ 0.608160, 0.751020, 1.000000 },
+	{ 0.607570, 0.750590, 1.000000 },
+	{ 0.606980, 0.750160, 1.000000 },
+	{ 0.606390, 0.749730, 1.000000 },
+	{ 0.605800, 0.749300, 1.000000 },
+	{ 0.605220, 0.748900, 1.000000 },
+	{ 0.604640, 0.748500, 1.000000 },
+	{ 0.604060, 0.748100, 1.000000 },
+	{ 0.603480, 0.747700, 1.000000 },
+	{ 0.602900, 0.747300, 1.000000 },
+	{ 0.602320, 0.746900, 1.000000 },
+	{ 0.601740, 0.746500, 1.000000 },
+	{ 0.601160, 0.746100, 1.000000 },
+	{ 0.600580, 0.745700, 1.000000 },
+	{ 0.600000, 0.745300, 1.000000 },
+	{ 0.599440, 0.744910, 1.000000 },
+	{ 0.598880, 0.744520, 1.000000 },
+	{ 0.598320, 0.744130, 1.000000 },
+	{ 0.597760, 0.743740, 1.000000 },
+	{ 0.597200, 0.743350, 1.000000 },
+	{ 0.596640, 0.742960, 1.000000 },
+	{ 0.596080, 0.742570, 1.000000 },
+	{ 0.595520, 0.742180, 1.000000 },
+	{ 0.594960, 0.741790, 1.000000 },
+	{ 0.594400, 0.741400, 1.000000 }, /* 10000K */
+};
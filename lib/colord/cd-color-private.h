@@ -0,0 +1,44 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2010-2013 Richard Hughes <richard@hughsie.com>
+ *
+ * Licensed under the GNU Lesser General Public License Version 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#ifndef CD_COMPILATION
+#error "This header is private to colord and is not installed."
+#endif
+
+#ifndef __CD_COLOR_PRIVATE_H__
+#define __CD_COLOR_PRIVATE_H__
+
+#include <glib.h>
+
+#include "cd-color.h"
+
+G_BEGIN_DECLS
+
+/* the layout stays private to the library; CdIcc needs it so that named
+ * colors can be stored in one contiguous arena-backed array */
+struct _CdColorSwatch {
+	gchar		*name;
+	CdColorLab	 value;
+};
+
+G_END_DECLS
+
+#endif /* __CD_COLOR_PRIVATE_H__ */
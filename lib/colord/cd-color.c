@@ -33,15 +33,11 @@
 #include <lcms2.h>
 
 #include "cd-color.h"
+#include "cd-color-private.h"
 #include "cd-interp.h"
 #include "cd-interp-akima.h"
 #include "cd-interp-linear.h"
-
-/* this is private */
-struct _CdColorSwatch {
-	gchar		*name;
-	CdColorLab	 value;
-};
+#include "cd-perf-stats.h"
 
 /**
  * cd_color_xyz_dup:
@@ -300,6 +296,7 @@ cd_color_swatch_get_type (void)
 CdColorXYZ *
 cd_color_xyz_new (void)
 {
+	cd_perf_stats_add (CD_PERF_STAT_COLOR_ALLOC, 1);
 	return g_slice_new0 (CdColorXYZ);
 }
 
@@ -315,6 +312,7 @@ cd_color_xyz_new (void)
 CdColorRGB *
 cd_color_rgb_new (void)
 {
+	cd_perf_stats_add (CD_PERF_STAT_COLOR_ALLOC, 1);
 	return g_slice_new0 (CdColorRGB);
 }
 
@@ -330,6 +328,7 @@ cd_color_rgb_new (void)
 CdColorLab *
 cd_color_lab_new (void)
 {
+	cd_perf_stats_add (CD_PERF_STAT_COLOR_ALLOC, 1);
 	return g_slice_new0 (CdColorLab);
 }
 
@@ -345,6 +344,7 @@ cd_color_lab_new (void)
 CdColorYxy *
 cd_color_yxy_new (void)
 {
+	cd_perf_stats_add (CD_PERF_STAT_COLOR_ALLOC, 1);
 	return g_slice_new0 (CdColorYxy);
 }
 
@@ -360,6 +360,7 @@ cd_color_yxy_new (void)
 CdColorUVW *
 cd_color_uvw_new (void)
 {
+	cd_perf_stats_add (CD_PERF_STAT_COLOR_ALLOC, 1);
 	return g_slice_new0 (CdColorUVW);
 }
 
@@ -375,6 +376,7 @@ cd_color_uvw_new (void)
 CdColorSwatch *
 cd_color_swatch_new (void)
 {
+	cd_perf_stats_add (CD_PERF_STAT_COLOR_ALLOC, 1);
 	return g_slice_new0 (CdColorSwatch);
 }
 
@@ -563,6 +565,226 @@ cd_color_lab_delta_e76 (const CdColorLab *p1, const CdColorLab *p2)
 		     pow (p2->b - p1->b, 2));
 }
 
+static inline gdouble
+cd_color_lab_delta_e94_inline (const CdColorLab *p1, const CdColorLab *p2)
+{
+	gdouble c1 = sqrt (p1->a * p1->a + p1->b * p1->b);
+	gdouble c2 = sqrt (p2->a * p2->a + p2->b * p2->b);
+	gdouble dl = p1->L - p2->L;
+	gdouble dc = c1 - c2;
+	gdouble da = p1->a - p2->a;
+	gdouble db = p1->b - p2->b;
+	gdouble dh2 = MAX (da * da + db * db - dc * dc, 0.0);
+	gdouble sc = 1.0 + 0.045 * c1;
+	gdouble sh = 1.0 + 0.015 * c1;
+	return sqrt (dl * dl +
+		     (dc / sc) * (dc / sc) +
+		     dh2 / (sh * sh));
+}
+
+/**
+ * cd_color_lab_delta_e94:
+ * @p1: Lab reference value
+ * @p2: Lab sample value
+ *
+ * Calculates the ΔE of two colors using the CIE94 formula with
+ * graphic arts weighting.
+ *
+ * Return value: distance metric, where JND ΔE ≈ 1.0
+ *
+ * Since: 1.4.6
+ **/
+gdouble
+cd_color_lab_delta_e94 (const CdColorLab *p1, const CdColorLab *p2)
+{
+	g_return_val_if_fail (p1 != NULL, -1.f);
+	g_return_val_if_fail (p2 != NULL, -1.f);
+	return cd_color_lab_delta_e94_inline (p1, p2);
+}
+
+static inline gdouble
+cd_color_lab_delta_e2000_inline (const CdColorLab *p1, const CdColorLab *p2)
+{
+	gdouble a1p, a2p;
+	gdouble c1, c2, c_bar, c1p, c2p, c_barp, c_barp7;
+	gdouble dhp, d_theta;
+	gdouble dlp, dcp, dhp_big;
+	gdouble g, h1p, h2p, h_barp;
+	gdouble l_bar;
+	gdouble rc, rt;
+	gdouble sl, sc, sh;
+	gdouble t;
+
+	/* weight the a* axis by the mean chroma */
+	c1 = sqrt (p1->a * p1->a + p1->b * p1->b);
+	c2 = sqrt (p2->a * p2->a + p2->b * p2->b);
+	c_bar = (c1 + c2) / 2;
+	g = 0.5 * (1 - sqrt (pow (c_bar, 7) / (pow (c_bar, 7) + pow (25, 7))));
+	a1p = (1 + g) * p1->a;
+	a2p = (1 + g) * p2->a;
+	c1p = sqrt (a1p * a1p + p1->b * p1->b);
+	c2p = sqrt (a2p * a2p + p2->b * p2->b);
+
+	/* hue angles in degrees, in [0,360) */
+	h1p = (a1p == 0 && p1->b == 0) ? 0 : atan2 (p1->b, a1p) * 180 / G_PI;
+	if (h1p < 0)
+		h1p += 360;
+	h2p = (a2p == 0 && p2->b == 0) ? 0 : atan2 (p2->b, a2p) * 180 / G_PI;
+	if (h2p < 0)
+		h2p += 360;
+
+	/* lightness, chroma and hue differences */
+	dlp = p2->L - p1->L;
+	dcp = c2p - c1p;
+	if (c1p * c2p == 0)
+		dhp = 0;
+	else if (fabs (h2p - h1p) <= 180)
+		dhp = h2p - h1p;
+	else if (h2p - h1p > 180)
+		dhp = h2p - h1p - 360;
+	else
+		dhp = h2p - h1p + 360;
+	dhp_big = 2 * sqrt (c1p * c2p) * sin (dhp * G_PI / 360);
+
+	/* mean lightness, chroma and hue */
+	l_bar = (p1->L + p2->L) / 2;
+	c_barp = (c1p + c2p) / 2;
+	if (c1p * c2p == 0)
+		h_barp = h1p + h2p;
+	else if (fabs (h1p - h2p) <= 180)
+		h_barp = (h1p + h2p) / 2;
+	else if (h1p + h2p < 360)
+		h_barp = (h1p + h2p + 360) / 2;
+	else
+		h_barp = (h1p + h2p - 360) / 2;
+
+	/* weighting functions */
+	t = 1 - 0.17 * cos ((h_barp - 30) * G_PI / 180) +
+		0.24 * cos ((2 * h_barp) * G_PI / 180) +
+		0.32 * cos ((3 * h_barp + 6) * G_PI / 180) -
+		0.20 * cos ((4 * h_barp - 63) * G_PI / 180);
+	d_theta = 30 * exp (-pow ((h_barp - 275) / 25, 2));
+	c_barp7 = pow (c_barp, 7);
+	rc = 2 * sqrt (c_barp7 / (c_barp7 + pow (25, 7)));
+	sl = 1 + 0.015 * pow (l_bar - 50, 2) / sqrt (20 + pow (l_bar - 50, 2));
+	sc = 1 + 0.045 * c_barp;
+	sh = 1 + 0.015 * c_barp * t;
+	rt = -sin ((2 * d_theta) * G_PI / 180) * rc;
+
+	return sqrt (pow (dlp / sl, 2) +
+		     pow (dcp / sc, 2) +
+		     pow (dhp_big / sh, 2) +
+		     rt * (dcp / sc) * (dhp_big / sh));
+}
+
+/**
+ * cd_color_lab_delta_e2000:
+ * @p1: Lab reference value
+ * @p2: Lab sample value
+ *
+ * Calculates the ΔE of two colors using the CIEDE2000 formula.
+ *
+ * Return value: distance metric, where JND ΔE ≈ 1.0
+ *
+ * Since: 1.4.6
+ **/
+gdouble
+cd_color_lab_delta_e2000 (const CdColorLab *p1, const CdColorLab *p2)
+{
+	g_return_val_if_fail (p1 != NULL, -1.f);
+	g_return_val_if_fail (p2 != NULL, -1.f);
+	return cd_color_lab_delta_e2000_inline (p1, p2);
+}
+
+/**
+ * cd_color_lab_delta_e76_array:
+ * @p1: (array length=len): packed Lab reference values
+ * @p2: (array length=len): packed Lab sample values
+ * @result: (array length=len): caller-allocated results
+ * @len: the number of color pairs
+ *
+ * Calculates the ΔE of pairs of packed Lab values using the 1976
+ * formula in one pass over the contiguous buffers.
+ *
+ * Since: 1.4.6
+ **/
+void
+cd_color_lab_delta_e76_array (const CdColorLab *p1,
+			      const CdColorLab *p2,
+			      gdouble *result,
+			      gsize len)
+{
+	gsize i;
+
+	g_return_if_fail (p1 != NULL);
+	g_return_if_fail (p2 != NULL);
+	g_return_if_fail (result != NULL);
+
+	for (i = 0; i < len; i++) {
+		gdouble dl = p2[i].L - p1[i].L;
+		gdouble da = p2[i].a - p1[i].a;
+		gdouble db = p2[i].b - p1[i].b;
+		result[i] = sqrt (dl * dl + da * da + db * db);
+	}
+}
+
+/**
+ * cd_color_lab_delta_e94_array:
+ * @p1: (array length=len): packed Lab reference values
+ * @p2: (array length=len): packed Lab sample values
+ * @result: (array length=len): caller-allocated results
+ * @len: the number of color pairs
+ *
+ * Calculates the ΔE of pairs of packed Lab values using the CIE94
+ * formula with graphic arts weighting.
+ *
+ * Since: 1.4.6
+ **/
+void
+cd_color_lab_delta_e94_array (const CdColorLab *p1,
+			      const CdColorLab *p2,
+			      gdouble *result,
+			      gsize len)
+{
+	gsize i;
+
+	g_return_if_fail (p1 != NULL);
+	g_return_if_fail (p2 != NULL);
+	g_return_if_fail (result != NULL);
+
+	for (i = 0; i < len; i++)
+		result[i] = cd_color_lab_delta_e94_inline (&p1[i], &p2[i]);
+}
+
+/**
+ * cd_color_lab_delta_e2000_array:
+ * @p1: (array length=len): packed Lab reference values
+ * @p2: (array length=len): packed Lab sample values
+ * @result: (array length=len): caller-allocated results
+ * @len: the number of color pairs
+ *
+ * Calculates the ΔE of pairs of packed Lab values using the CIEDE2000
+ * formula, for instance to compare a sheet of measured patches against
+ * the reference values.
+ *
+ * Since: 1.4.6
+ **/
+void
+cd_color_lab_delta_e2000_array (const CdColorLab *p1,
+				const CdColorLab *p2,
+				gdouble *result,
+				gsize len)
+{
+	gsize i;
+
+	g_return_if_fail (p1 != NULL);
+	g_return_if_fail (p2 != NULL);
+	g_return_if_fail (result != NULL);
+
+	for (i = 0; i < len; i++)
+		result[i] = cd_color_lab_delta_e2000_inline (&p1[i], &p2[i]);
+}
+
 /**
  * cd_color_yxy_set:
  * @dest: the destination color
@@ -760,6 +982,35 @@ cd_color_rgb8_to_rgb (const CdColorRGB8 *src, CdColorRGB *dest)
 	dest->B = (gdouble) src->B / 255.0f;
 }
 
+/**
+ * cd_color_rgb8_to_rgb_array:
+ * @src: (array length=len): the source color array
+ * @dest: (array length=len): the destination color array
+ * @len: the number of colors
+ *
+ * Converts an array of colors from one color format to another.
+ * This is cheaper than calling cd_color_rgb8_to_rgb() in a loop as the
+ * conversion is done over the contiguous buffers in one pass.
+ *
+ * Since: 1.4.6
+ **/
+void
+cd_color_rgb8_to_rgb_array (const CdColorRGB8 *src,
+			    CdColorRGB *dest,
+			    gsize len)
+{
+	gsize i;
+
+	g_return_if_fail (src != NULL);
+	g_return_if_fail (dest != NULL);
+
+	for (i = 0; i < len; i++) {
+		dest[i].R = (gdouble) src[i].R / 255.0f;
+		dest[i].G = (gdouble) src[i].G / 255.0f;
+		dest[i].B = (gdouble) src[i].B / 255.0f;
+	}
+}
+
 static guint8
 cd_color_value_double_to_uint8 (gdouble value)
 {
@@ -791,6 +1042,50 @@ cd_color_rgb_to_rgb8 (const CdColorRGB *src, CdColorRGB8 *dest)
 	dest->B = cd_color_value_double_to_uint8 (src->B);
 }
 
+/**
+ * cd_color_rgb_to_rgb8_array:
+ * @src: (array length=len): the source color array
+ * @dest: (array length=len): the destination color array
+ * @len: the number of colors
+ *
+ * Converts an array of colors from one color format to another,
+ * clamping overflow and underflow as cd_color_rgb_to_rgb8() does.
+ *
+ * Since: 1.4.6
+ **/
+void
+cd_color_rgb_to_rgb8_array (const CdColorRGB *src,
+			    CdColorRGB8 *dest,
+			    gsize len)
+{
+	gsize i;
+
+	g_return_if_fail (src != NULL);
+	g_return_if_fail (dest != NULL);
+
+	for (i = 0; i < len; i++) {
+		dest[i].R = cd_color_value_double_to_uint8 (src[i].R);
+		dest[i].G = cd_color_value_double_to_uint8 (src[i].G);
+		dest[i].B = cd_color_value_double_to_uint8 (src[i].B);
+	}
+}
+
+static inline void
+cd_color_yxy_to_xyz_inline (const CdColorYxy *src, CdColorXYZ *dest)
+{
+	/* very small luminance */
+	if (src->Y < 1e-6) {
+		dest->X = 0.0f;
+		dest->Y = 0.0f;
+		dest->Z = 0.0f;
+		return;
+	}
+
+	dest->X = (src->x * src->Y) / src->y;
+	dest->Y = src->Y;
+	dest->Z = (1.0f - src->x - src->y) * src->Y / src->y;
+}
+
 /**
  * cd_color_yxy_to_xyz:
  * @src: the source color
@@ -813,17 +1108,33 @@ cd_color_yxy_to_xyz (const CdColorYxy *src, CdColorXYZ *dest)
 	g_assert (src->x <= 1.0f);
 	g_assert (src->y <= 1.0f);
 
-	/* very small luminance */
-	if (src->Y < 1e-6) {
-		dest->X = 0.0f;
-		dest->Y = 0.0f;
-		dest->Z = 0.0f;
-		return;
-	}
+	cd_color_yxy_to_xyz_inline (src, dest);
+}
 
-	dest->X = (src->x * src->Y) / src->y;
-	dest->Y = src->Y;
-	dest->Z = (1.0f - src->x - src->y) * src->Y / src->y;
+/**
+ * cd_color_yxy_to_xyz_array:
+ * @src: (array length=len): the source color array
+ * @dest: (array length=len): the destination color array
+ * @len: the number of colors
+ *
+ * Converts an array of colors from one color format to another.
+ * Unlike cd_color_yxy_to_xyz() the source values are not checked for
+ * range, so the caller has to pass valid chromaticities.
+ *
+ * Since: 1.4.6
+ **/
+void
+cd_color_yxy_to_xyz_array (const CdColorYxy *src,
+			   CdColorXYZ *dest,
+			   gsize len)
+{
+	gsize i;
+
+	g_return_if_fail (src != NULL);
+	g_return_if_fail (dest != NULL);
+
+	for (i = 0; i < len; i++)
+		cd_color_yxy_to_xyz_inline (&src[i], &dest[i]);
 }
 
 /**
@@ -870,6 +1181,124 @@ cd_color_xyz_to_cct (const CdColorXYZ *src)
 	return value;
 }
 
+/* the Robertson isotherm table: reciprocal megakelvin, the CIE 1960
+ * chromaticity of the Planckian radiator and the isotherm slope;
+ * see Robertson (1968), with the corrected slope at 325 mired */
+typedef struct {
+	gdouble		 mired;
+	gdouble		 u;
+	gdouble		 v;
+	gdouble		 slope;
+} CdColorRobertsonEntry;
+
+static const CdColorRobertsonEntry cd_color_robertson_table[] = {
+	{ 0.f,		0.18006,	0.26352,	-0.24341 },
+	{ 10.f,		0.18066,	0.26589,	-0.25479 },
+	{ 20.f,		0.18133,	0.26846,	-0.26876 },
+	{ 30.f,		0.18208,	0.27119,	-0.28539 },
+	{ 40.f,		0.18293,	0.27407,	-0.30470 },
+	{ 50.f,		0.18388,	0.27709,	-0.32675 },
+	{ 60.f,		0.18494,	0.28021,	-0.35156 },
+	{ 70.f,		0.18611,	0.28342,	-0.37915 },
+	{ 80.f,		0.18740,	0.28668,	-0.40955 },
+	{ 90.f,		0.18880,	0.28997,	-0.44278 },
+	{ 100.f,	0.19032,	0.29326,	-0.47888 },
+	{ 125.f,	0.19462,	0.30141,	-0.58204 },
+	{ 150.f,	0.19962,	0.30921,	-0.70471 },
+	{ 175.f,	0.20525,	0.31647,	-0.84901 },
+	{ 200.f,	0.21142,	0.32312,	-1.0182 },
+	{ 225.f,	0.21807,	0.32909,	-1.2168 },
+	{ 250.f,	0.22511,	0.33439,	-1.4512 },
+	{ 275.f,	0.23247,	0.33904,	-1.7298 },
+	{ 300.f,	0.24010,	0.34308,	-2.0637 },
+	{ 325.f,	0.24792,	0.34655,	-2.4681 },
+	{ 350.f,	0.25591,	0.34951,	-2.9641 },
+	{ 375.f,	0.26400,	0.35200,	-3.5814 },
+	{ 400.f,	0.27218,	0.35407,	-4.3633 },
+	{ 425.f,	0.28039,	0.35577,	-5.3762 },
+	{ 450.f,	0.28863,	0.35714,	-6.7262 },
+	{ 475.f,	0.29685,	0.35823,	-8.5955 },
+	{ 500.f,	0.30505,	0.35907,	-11.324 },
+	{ 525.f,	0.31320,	0.35968,	-15.628 },
+	{ 550.f,	0.32129,	0.36011,	-23.325 },
+	{ 575.f,	0.32931,	0.36038,	-40.770 },
+	{ 600.f,	0.33724,	0.36051,	-116.45 },
+};
+
+/**
+ * cd_color_xyz_to_cct_full:
+ * @src: the source color
+ * @duv: (out) (allow-none): the distance from the Planckian locus in
+ *       the CIE 1960 UCS, positive above the locus
+ *
+ * Gets the correlated color temperature and Duv for the XYZ value
+ * using Robertson's isotherm method. Unlike cd_color_xyz_to_cct()
+ * this does not involve any iterative search and is cheap enough to
+ * call for every sensor sample.
+ *
+ * Return value: the temperature in Kelvin, or -1 for out of range
+ *
+ * Since: 1.4.6
+ **/
+gdouble
+cd_color_xyz_to_cct_full (const CdColorXYZ *src, gdouble *duv)
+{
+	const CdColorRobertsonEntry *e1;
+	const CdColorRobertsonEntry *e2;
+	gdouble denom;
+	gdouble di = 0.f;
+	gdouble dp = 0.f;
+	gdouble mired;
+	gdouble p;
+	gdouble u;
+	gdouble v;
+	guint i;
+
+	g_return_val_if_fail (src != NULL, -1.f);
+
+	/* convert to the CIE 1960 UCS */
+	denom = src->X + 15.0 * src->Y + 3.0 * src->Z;
+	if (denom <= 0.0)
+		return -1.f;
+	u = (4.0 * src->X) / denom;
+	v = (6.0 * src->Y) / denom;
+
+	/* find the pair of isotherms the sample lies between; di is the
+	 * signed distance from the sample to each isotherm */
+	e1 = &cd_color_robertson_table[0];
+	dp = ((v - e1->v) - e1->slope * (u - e1->u)) /
+		sqrt (1.0 + e1->slope * e1->slope);
+	for (i = 1; i < G_N_ELEMENTS (cd_color_robertson_table); i++) {
+		e2 = &cd_color_robertson_table[i];
+		di = ((v - e2->v) - e2->slope * (u - e2->u)) /
+			sqrt (1.0 + e2->slope * e2->slope);
+		if (di * dp <= 0.0)
+			break;
+		dp = di;
+	}
+	if (i == G_N_ELEMENTS (cd_color_robertson_table))
+		return -1.f;
+
+	/* interpolate between the isotherms in mired space */
+	e1 = &cd_color_robertson_table[i - 1];
+	e2 = &cd_color_robertson_table[i];
+	p = dp / (dp - di);
+	mired = e1->mired + p * (e2->mired - e1->mired);
+	if (mired <= 0.0)
+		return -1.f;
+
+	/* Duv is the distance from the interpolated locus point,
+	 * positive when the sample is above the locus */
+	if (duv != NULL) {
+		gdouble ul = e1->u + p * (e2->u - e1->u);
+		gdouble vl = e1->v + p * (e2->v - e1->v);
+		*duv = sqrt (pow (u - ul, 2) + pow (v - vl, 2));
+		if (v < vl)
+			*duv = -*duv;
+	}
+	return 1e6 / mired;
+}
+
 /**
  * cd_color_uvw_get_chroma_difference:
  * @p1: color
@@ -914,6 +1343,23 @@ cd_color_uvw_set_planckian_locus (CdColorUVW *dest, gdouble temp)
 		   (1.61456053 * pow (temp, 2) * 1e-7));
 }
 
+static inline void
+cd_color_xyz_to_yxy_inline (const CdColorXYZ *src, CdColorYxy *dest)
+{
+	gdouble sum;
+
+	/* prevent division by zero */
+	sum = src->X + src->Y + src->Z;
+	if (fabs (sum) < 1e-6) {
+		cd_color_yxy_set (dest, 0.f, 0.f, 0.f);
+		return;
+	}
+
+	dest->Y = src->Y;
+	dest->x = src->X / sum;
+	dest->y = src->Y / sum;
+}
+
 /**
  * cd_color_xyz_to_yxy:
  * @src: the source color
@@ -926,21 +1372,34 @@ cd_color_uvw_set_planckian_locus (CdColorUVW *dest, gdouble temp)
 void
 cd_color_xyz_to_yxy (const CdColorXYZ *src, CdColorYxy *dest)
 {
-	gdouble sum;
-
 	g_return_if_fail (src != NULL);
 	g_return_if_fail (dest != NULL);
 
-	/* prevent division by zero */
-	sum = src->X + src->Y + src->Z;
-	if (fabs (sum) < 1e-6) {
-		cd_color_yxy_set (dest, 0.f, 0.f, 0.f);
-		return;
-	}
+	cd_color_xyz_to_yxy_inline (src, dest);
+}
 
-	dest->Y = src->Y;
-	dest->x = src->X / sum;
-	dest->y = src->Y / sum;
+/**
+ * cd_color_xyz_to_yxy_array:
+ * @src: (array length=len): the source color array
+ * @dest: (array length=len): the destination color array
+ * @len: the number of colors
+ *
+ * Converts an array of colors from one color format to another.
+ *
+ * Since: 1.4.6
+ **/
+void
+cd_color_xyz_to_yxy_array (const CdColorXYZ *src,
+			   CdColorYxy *dest,
+			   gsize len)
+{
+	gsize i;
+
+	g_return_if_fail (src != NULL);
+	g_return_if_fail (dest != NULL);
+
+	for (i = 0; i < len; i++)
+		cd_color_xyz_to_yxy_inline (&src[i], &dest[i]);
 }
 
 typedef struct {
@@ -1002,198 +1461,8 @@ cd_color_yxy_to_uvw (const CdColorYxy *src, CdColorUVW *dest)
 	dest->W = src->Y;
 }
 
-/* source: https://github.com/jonls/redshift/blob/master/README-colorramp
- * use a Planckian curve below 5000K */
-static const CdColorRGB blackbody_data_d65plankian[] = {
-	{ 1.0000, 0.1817, 0.0000 }, /* 1000K */
-	{ 1.0000, 0.2550, 0.0000 }, /* 1100K */
-	{ 1.0000, 0.3094, 0.0000 }, /* 1200K */
-	{ 1.0000, 0.3536, 0.0000 }, /* ... */
-	{ 1.0000, 0.3909, 0.0000 },
-	{ 1.0000, 0.4232, 0.0000 },
-	{ 1.0000, 0.4516, 0.0000 },
-	{ 1.0000, 0.4768, 0.0000 },
-	{ 1.0000, 0.4992, 0.0000 },
-	{ 1.0000, 0.5194, 0.0000 },
-	{ 1.0000, 0.5436, 0.0868 },
-	{ 1.0000, 0.5662, 0.1407 },
-	{ 1.0000, 0.5873, 0.1836 },
-	{ 1.0000, 0.6072, 0.2214 },
-	{ 1.0000, 0.6260, 0.2559 },
-	{ 1.0000, 0.6437, 0.2882 },
-	{ 1.0000, 0.6605, 0.3187 },
-	{ 1.0000, 0.6765, 0.3479 },
-	{ 1.0000, 0.6916, 0.3758 },
-	{ 1.0000, 0.7060, 0.4027 },
-	{ 1.0000, 0.7198, 0.4286 },
-	{ 1.0000, 0.7329, 0.4537 },
-	{ 1.0000, 0.7454, 0.4779 },
-	{ 1.0000, 0.7574, 0.5015 },
-	{ 1.0000, 0.7689, 0.5243 },
-	{ 1.0000, 0.7799, 0.5464 },
-	{ 1.0000, 0.7904, 0.5679 },
-	{ 1.0000, 0.8005, 0.5888 },
-	{ 1.0000, 0.8102, 0.6092 },
-	{ 1.0000, 0.8196, 0.6289 },
-	{ 1.0000, 0.8285, 0.6482 },
-	{ 1.0000, 0.8372, 0.6669 },
-	{ 1.0000, 0.8455, 0.6851 },
-	{ 1.0000, 0.8535, 0.7028 },
-	{ 1.0000, 0.8612, 0.7201 },
-	{ 1.0000, 0.8686, 0.7369 },
-	{ 1.0000, 0.8758, 0.7533 },
-	{ 1.0000, 0.8827, 0.7692 },
-	{ 1.0000, 0.8893, 0.7848 },
-	{ 1.0000, 0.8958, 0.7999 },
-	{ 1.0000, 0.9020, 0.8147 },
-	{ 1.0000, 0.9096, 0.8284 },
-	{ 1.0000, 0.9171, 0.8419 },
-	{ 1.0000, 0.9244, 0.8552 },
-	{ 1.0000, 0.9316, 0.8684 },
-	{ 1.0000, 0.9385, 0.8813 },
-	{ 1.0000, 0.9454, 0.8940 },
-	{ 1.0000, 0.9520, 0.9066 },
-	{ 1.0000, 0.9585, 0.9189 },
-	{ 1.0000, 0.9649, 0.9311 },
-	{ 1.0000, 0.9711, 0.9431 },
-	{ 1.0000, 0.9771, 0.9548 },
-	{ 1.0000, 0.9831, 0.9664 },
-	{ 1.0000, 0.9888, 0.9778 },
-	{ 1.0000, 0.9945, 0.9890 },
-	{ 1.0000, 1.0000, 1.0000 }, /* 6500K */
-	{ 0.9895, 0.9935, 1.0000 },
-	{ 0.9794, 0.9872, 1.0000 },
-	{ 0.9698, 0.9812, 1.0000 },
-	{ 0.9605, 0.9754, 1.0000 },
-	{ 0.9516, 0.9698, 1.0000 },
-	{ 0.9430, 0.9644, 1.0000 },
-	{ 0.9348, 0.9592, 1.0000 },
-	{ 0.9269, 0.9542, 1.0000 },
-	{ 0.9193, 0.9494, 1.0000 },
-	{ 0.9119, 0.9447, 1.0000 },
-	{ 0.9049, 0.9402, 1.0000 },
-	{ 0.8981, 0.9358, 1.0000 },
-	{ 0.8915, 0.9316, 1.0000 },
-	{ 0.8852, 0.9275, 1.0000 },
-	{ 0.8791, 0.9236, 1.0000 },
-	{ 0.8732, 0.9197, 1.0000 },
-	{ 0.8674, 0.9160, 1.0000 },
-	{ 0.8619, 0.9125, 1.0000 },
-	{ 0.8566, 0.9090, 1.0000 },
-	{ 0.8514, 0.9056, 1.0000 },
-	{ 0.8464, 0.9023, 1.0000 },
-	{ 0.8415, 0.8991, 1.0000 },
-	{ 0.8368, 0.8960, 1.0000 },
-	{ 0.8323, 0.8930, 1.0000 },
-	{ 0.8278, 0.8901, 1.0000 },
-	{ 0.8235, 0.8873, 1.0000 },
-	{ 0.8194, 0.8845, 1.0000 },
-	{ 0.8153, 0.8818, 1.0000 },
-	{ 0.8114, 0.8792, 1.0000 },
-	{ 0.8075, 0.8767, 1.0000 },
-	{ 0.8038, 0.8742, 1.0000 },
-	{ 0.8002, 0.8718, 1.0000 },
-	{ 0.7967, 0.8694, 1.0000 },
-	{ 0.7932, 0.8671, 1.0000 },
-	{ 0.7898, 0.8649, 1.0000 } /* 10000K */
-};
-
-/* source: http://www.vendian.org/mncharity/dir3/blackbody/
- * rescaled to make exactly 6500K equal to full intensity in all
- * channels */
-static const CdColorRGB blackbody_data_d65modified[] = {
-	{ 1.0000, 0.0425, 0.0000 }, /* 1000K */
-	{ 1.0000, 0.0668, 0.0000 }, /* 1100K */
-	{ 1.0000, 0.0911, 0.0000 }, /* 1200K */
-	{ 1.0000, 0.1149, 0.0000 }, /* ... */
-	{ 1.0000, 0.1380, 0.0000 },
-	{ 1.0000, 0.1604, 0.0000 },
-	{ 1.0000, 0.1819, 0.0000 },
-	{ 1.0000, 0.2024, 0.0000 },
-	{ 1.0000, 0.2220, 0.0000 },
-	{ 1.0000, 0.2406, 0.0000 },
-	{ 1.0000, 0.2630, 0.0062 },
-	{ 1.0000, 0.2868, 0.0155 },
-	{ 1.0000, 0.3102, 0.0261 },
-	{ 1.0000, 0.3334, 0.0379 },
-	{ 1.0000, 0.3562, 0.0508 },
-	{ 1.0000, 0.3787, 0.0650 },
-	{ 1.0000, 0.4008, 0.0802 },
-	{ 1.0000, 0.4227, 0.0964 },
-	{ 1.0000, 0.4442, 0.1136 },
-	{ 1.0000, 0.4652, 0.1316 },
-	{ 1.0000, 0.4859, 0.1505 },
-	{ 1.0000, 0.5062, 0.1702 },
-	{ 1.0000, 0.5262, 0.1907 },
-	{ 1.0000, 0.5458, 0.2118 },
-	{ 1.0000, 0.5650, 0.2335 },
-	{ 1.0000, 0.5839, 0.2558 },
-	{ 1.0000, 0.6023, 0.2786 },
-	{ 1.0000, 0.6204, 0.3018 },
-	{ 1.0000, 0.6382, 0.3255 },
-	{ 1.0000, 0.6557, 0.3495 },
-	{ 1.0000, 0.6727, 0.3739 },
-	{ 1.0000, 0.6894, 0.3986 },
-	{ 1.0000, 0.7058, 0.4234 },
-	{ 1.0000, 0.7218, 0.4485 },
-	{ 1.0000, 0.7375, 0.4738 },
-	{ 1.0000, 0.7529, 0.4992 },
-	{ 1.0000, 0.7679, 0.5247 },
-	{ 1.0000, 0.7826, 0.5503 },
-	{ 1.0000, 0.7970, 0.5760 },
-	{ 1.0000, 0.8111, 0.6016 },
-	{ 1.0000, 0.8250, 0.6272 },
-	{ 1.0000, 0.8384, 0.6529 },
-	{ 1.0000, 0.8517, 0.6785 },
-	{ 1.0000, 0.8647, 0.7040 },
-	{ 1.0000, 0.8773, 0.7294 },
-	{ 1.0000, 0.8897, 0.7548 },
-	{ 1.0000, 0.9019, 0.7801 },
-	{ 1.0000, 0.9137, 0.8051 },
-	{ 1.0000, 0.9254, 0.8301 },
-	{ 1.0000, 0.9367, 0.8550 },
-	{ 1.0000, 0.9478, 0.8795 },
-	{ 1.0000, 0.9587, 0.9040 },
-	{ 1.0000, 0.9694, 0.9283 },
-	{ 1.0000, 0.9798, 0.9524 },
-	{ 1.0000, 0.9900, 0.9763 },
-	{ 1.0000, 1.0000, 1.0000 }, /* 6500K */
-	{ 0.9771, 0.9867, 1.0000 },
-	{ 0.9554, 0.9740, 1.0000 },
-	{ 0.9349, 0.9618, 1.0000 },
-	{ 0.9154, 0.9500, 1.0000 },
-	{ 0.8968, 0.9389, 1.0000 },
-	{ 0.8792, 0.9282, 1.0000 },
-	{ 0.8624, 0.9179, 1.0000 },
-	{ 0.8465, 0.9080, 1.0000 },
-	{ 0.8313, 0.8986, 1.0000 },
-	{ 0.8167, 0.8895, 1.0000 },
-	{ 0.8029, 0.8808, 1.0000 },
-	{ 0.7896, 0.8724, 1.0000 },
-	{ 0.7769, 0.8643, 1.0000 },
-	{ 0.7648, 0.8565, 1.0000 },
-	{ 0.7532, 0.8490, 1.0000 },
-	{ 0.7420, 0.8418, 1.0000 },
-	{ 0.7314, 0.8348, 1.0000 },
-	{ 0.7212, 0.8281, 1.0000 },
-	{ 0.7113, 0.8216, 1.0000 },
-	{ 0.7018, 0.8153, 1.0000 },
-	{ 0.6927, 0.8092, 1.0000 },
-	{ 0.6839, 0.8032, 1.0000 },
-	{ 0.6755, 0.7975, 1.0000 },
-	{ 0.6674, 0.7921, 1.0000 },
-	{ 0.6595, 0.7867, 1.0000 },
-	{ 0.6520, 0.7816, 1.0000 },
-	{ 0.6447, 0.7765, 1.0000 },
-	{ 0.6376, 0.7717, 1.0000 },
-	{ 0.6308, 0.7670, 1.0000 },
-	{ 0.6242, 0.7623, 1.0000 },
-	{ 0.6179, 0.7579, 1.0000 },
-	{ 0.6117, 0.7536, 1.0000 },
-	{ 0.6058, 0.7493, 1.0000 },
-	{ 0.6000, 0.7453, 1.0000 },
-	{ 0.5944, 0.7414, 1.0000 } /* 10000K */
-};
+/* tables expanded to 10K steps by cd-color-blackbody-generate.py */
+#include "cd-color-blackbody.h"
 
 /**
  * cd_color_rgb_interpolate:
@@ -1336,6 +1605,82 @@ cd_color_rgb_array_new (void)
 	return g_ptr_array_new_with_free_func ((GDestroyNotify) cd_color_rgb_free);
 }
 
+/**
+ * cd_color_rgb_array_new_packed: (skip)
+ * @reserved: the expected number of colors
+ *
+ * Creates a new packed RGB array where the #CdColorRGB values are
+ * stored contiguously rather than boxed one-by-one. This is the
+ * preferred container when building or processing a lot of colors;
+ * use cd_color_rgb_array_from_packed() to box the values only at the
+ * introspection boundary.
+ *
+ * Return value: (transfer full): New array of #CdColorRGB values
+ *
+ * Since: 1.4.6
+ **/
+GArray *
+cd_color_rgb_array_new_packed (guint reserved)
+{
+	return g_array_sized_new (FALSE, FALSE, sizeof (CdColorRGB), reserved);
+}
+
+/**
+ * cd_color_rgb_array_from_packed: (skip)
+ * @packed: (element-type CdColorRGB): the packed array
+ *
+ * Boxes each value of a packed RGB array into a new #GPtrArray.
+ *
+ * Return value: (element-type CdColorRGB) (transfer full): New array
+ *
+ * Since: 1.4.6
+ **/
+GPtrArray *
+cd_color_rgb_array_from_packed (GArray *packed)
+{
+	GPtrArray *array;
+	guint i;
+
+	g_return_val_if_fail (packed != NULL, NULL);
+
+	array = cd_color_rgb_array_new ();
+	for (i = 0; i < packed->len; i++) {
+		g_ptr_array_add (array,
+				 cd_color_rgb_dup (&g_array_index (packed,
+								   CdColorRGB,
+								   i)));
+	}
+	return array;
+}
+
+/**
+ * cd_color_rgb_array_to_packed: (skip)
+ * @array: (element-type CdColorRGB): Input array
+ *
+ * Copies a boxed RGB array into one contiguous allocation, for
+ * instance so that it can be converted with
+ * cd_color_rgb_to_rgb8_array() in a single pass.
+ *
+ * Return value: (transfer full): New array of #CdColorRGB values
+ *
+ * Since: 1.4.6
+ **/
+GArray *
+cd_color_rgb_array_to_packed (const GPtrArray *array)
+{
+	GArray *packed;
+	guint i;
+
+	g_return_val_if_fail (array != NULL, NULL);
+
+	packed = cd_color_rgb_array_new_packed (array->len);
+	for (i = 0; i < array->len; i++) {
+		const CdColorRGB *rgb = g_ptr_array_index (array, i);
+		g_array_append_vals (packed, rgb, 1);
+	}
+	return packed;
+}
+
 /**
  * cd_color_rgb_array_interpolate:
  * @array: (element-type CdColorRGB): Input array
@@ -1425,6 +1770,71 @@ out:
 	return result;
 }
 
+/**
+ * cd_color_rgb_array_interpolate_packed: (skip)
+ * @array: (element-type CdColorRGB): packed input array
+ * @new_length: the target length of the return array
+ *
+ * Resamples a packed RGB array to a different size using linear
+ * interpolation, checking the input for monotonicity in the same pass.
+ * Unlike cd_color_rgb_array_interpolate() no per-element boxing is
+ * done, so this is the variant to use when resizing gamma ramps per
+ * output on every update.
+ *
+ * Return value: (transfer full): a packed array of size @new_length,
+ * or %NULL if the input was not monotonic
+ *
+ * Since: 1.4.6
+ **/
+GArray *
+cd_color_rgb_array_interpolate_packed (const GArray *array, guint new_length)
+{
+	const CdColorRGB *src;
+	CdColorRGB *dst;
+	GArray *result;
+	gdouble scale = 0.f;
+	guint checked = 0;
+	guint i;
+
+	g_return_val_if_fail (array != NULL, NULL);
+	g_return_val_if_fail (new_length > 0, NULL);
+
+	if (array->len < 2)
+		return NULL;
+	src = &g_array_index ((GArray *) array, CdColorRGB, 0);
+	if (src[0].R < 0.f || src[0].G < 0.f || src[0].B < 0.f)
+		return NULL;
+
+	result = cd_color_rgb_array_new_packed (new_length);
+	g_array_set_size (result, new_length);
+	dst = &g_array_index (result, CdColorRGB, 0);
+	if (new_length > 1)
+		scale = (gdouble) (array->len - 1) / (gdouble) (new_length - 1);
+	for (i = 0; i < new_length; i++) {
+		gdouble pos = (gdouble) i * scale;
+		guint idx = (guint) pos;
+		gdouble frac;
+		if (idx > array->len - 2)
+			idx = array->len - 2;
+		frac = pos - (gdouble) idx;
+
+		/* verify each source pair as the read cursor first
+		 * crosses it, so no separate monotonicity pass is needed */
+		for (; checked <= idx; checked++) {
+			if (src[checked + 1].R < src[checked].R ||
+			    src[checked + 1].G < src[checked].G ||
+			    src[checked + 1].B < src[checked].B) {
+				g_array_unref (result);
+				return NULL;
+			}
+		}
+		dst[i].R = src[idx].R + (src[idx + 1].R - src[idx].R) * frac;
+		dst[i].G = src[idx].G + (src[idx + 1].G - src[idx].G) * frac;
+		dst[i].B = src[idx].B + (src[idx + 1].B - src[idx].B) * frac;
+	}
+	return result;
+}
+
 /**
  * cd_color_get_blackbody_rgb_full:
  * @temp: the temperature in Kelvin
@@ -1444,7 +1854,8 @@ cd_color_get_blackbody_rgb_full (gdouble temp,
 				 CdColorBlackbodyFlags flags)
 {
 	gboolean ret = TRUE;
-	guint temp_quot, temp_rem;
+	gdouble frac;
+	guint idx;
 	const CdColorRGB *blackbody_func = blackbody_data_d65modified;
 
 	g_return_val_if_fail (!isnan (temp), FALSE);
@@ -1455,35 +1866,33 @@ cd_color_get_blackbody_rgb_full (gdouble temp,
 		blackbody_func = blackbody_data_d65plankian;
 
 	/* check lower bound */
-	if (temp < 1000) {
+	if (temp < CD_COLOR_BLACKBODY_TEMP_MIN) {
 		ret = FALSE;
-		temp = 1000;
+		temp = CD_COLOR_BLACKBODY_TEMP_MIN;
 	}
 
 	/* check upper bound */
-	if (temp > 10000) {
+	if (temp > CD_COLOR_BLACKBODY_TEMP_MAX) {
 		ret = FALSE;
-		temp = 10000;
+		temp = CD_COLOR_BLACKBODY_TEMP_MAX;
 	}
 
-	/* blackbody data has a resolution of 100 K */
-	temp_quot = (guint) temp / 100;
-	temp_rem = (guint) temp % 100;
-
-	/* blackbody data starts at 1000 K */
-	temp_quot -= 10;
-
-	if (temp_rem == 0) {
-		/* exact match for data point */
-		*result = blackbody_func[temp_quot];
-		return ret;
+	/* direct index into the expanded table, then one fused lerp;
+	 * an exact table hit just interpolates with a fraction of zero */
+	frac = (temp - CD_COLOR_BLACKBODY_TEMP_MIN) /
+	       (gdouble) CD_COLOR_BLACKBODY_TEMP_STEP;
+	idx = (guint) frac;
+	frac -= idx;
+	if (idx >= G_N_ELEMENTS (blackbody_data_d65modified) - 1) {
+		idx = G_N_ELEMENTS (blackbody_data_d65modified) - 2;
+		frac = 1.0;
 	}
-
-	/* bilinear interpolate the blackbody data */
-	cd_color_rgb_interpolate (&blackbody_func[temp_quot],
-				  &blackbody_func[temp_quot + 1],
-				  temp_rem / 100.0,
-				  result);
+	result->R = blackbody_func[idx].R +
+		    frac * (blackbody_func[idx + 1].R - blackbody_func[idx].R);
+	result->G = blackbody_func[idx].G +
+		    frac * (blackbody_func[idx + 1].G - blackbody_func[idx].G);
+	result->B = blackbody_func[idx].B +
+		    frac * (blackbody_func[idx + 1].B - blackbody_func[idx].B);
 	return ret;
 }
 
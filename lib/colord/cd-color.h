@@ -165,17 +165,45 @@ void		 cd_color_lab_copy			(const CdColorLab	*src,
 							 CdColorLab		*dest);
 gdouble		 cd_color_lab_delta_e76			(const CdColorLab	*p1,
 							 const CdColorLab	*p2);
+gdouble		 cd_color_lab_delta_e94			(const CdColorLab	*p1,
+							 const CdColorLab	*p2);
+gdouble		 cd_color_lab_delta_e2000		(const CdColorLab	*p1,
+							 const CdColorLab	*p2);
+void		 cd_color_lab_delta_e76_array		(const CdColorLab	*p1,
+							 const CdColorLab	*p2,
+							 gdouble		*result,
+							 gsize			 len);
+void		 cd_color_lab_delta_e94_array		(const CdColorLab	*p1,
+							 const CdColorLab	*p2,
+							 gdouble		*result,
+							 gsize			 len);
+void		 cd_color_lab_delta_e2000_array		(const CdColorLab	*p1,
+							 const CdColorLab	*p2,
+							 gdouble		*result,
+							 gsize			 len);
 void		 cd_color_xyz_clear			(CdColorXYZ		*dest);
 void		 cd_color_rgb_copy			(const CdColorRGB	*src,
 							 CdColorRGB		*dest);
 void		 cd_color_rgb8_to_rgb			(const CdColorRGB8	*src,
 							 CdColorRGB		*dest);
+void		 cd_color_rgb8_to_rgb_array		(const CdColorRGB8	*src,
+							 CdColorRGB		*dest,
+							 gsize			 len);
 void		 cd_color_rgb_to_rgb8			(const CdColorRGB	*src,
 							 CdColorRGB8		*dest);
+void		 cd_color_rgb_to_rgb8_array		(const CdColorRGB	*src,
+							 CdColorRGB8		*dest,
+							 gsize			 len);
 void		 cd_color_yxy_to_xyz			(const CdColorYxy	*src,
 							 CdColorXYZ		*dest);
+void		 cd_color_yxy_to_xyz_array		(const CdColorYxy	*src,
+							 CdColorXYZ		*dest,
+							 gsize			 len);
 void		 cd_color_xyz_to_yxy			(const CdColorXYZ	*src,
 							 CdColorYxy		*dest);
+void		 cd_color_xyz_to_yxy_array		(const CdColorXYZ	*src,
+							 CdColorYxy		*dest,
+							 gsize			 len);
 void		 cd_color_xyz_to_uvw			(const CdColorXYZ	*src,
 							 const CdColorXYZ	*whitepoint,
 							 CdColorUVW		*dest);
@@ -197,15 +225,23 @@ void		 cd_color_rgb_interpolate		(const CdColorRGB	*p1,
 void		 cd_color_rgb_from_wavelength		(CdColorRGB		*dest,
 							 gdouble		 wavelength);
 gdouble		 cd_color_xyz_to_cct			(const CdColorXYZ	*src);
+gdouble		 cd_color_xyz_to_cct_full		(const CdColorXYZ	*src,
+							 gdouble		*duv);
 void		 cd_color_xyz_normalize			(const CdColorXYZ	*src,
 							 gdouble		 max,
 							 CdColorXYZ		*dest);
 
 GPtrArray	*cd_color_rgb_array_new			(void);
+GArray		*cd_color_rgb_array_new_packed		(guint			 reserved);
+GPtrArray	*cd_color_rgb_array_from_packed		(GArray			*packed);
+GArray		*cd_color_rgb_array_to_packed		(const GPtrArray	*array);
 gboolean	 cd_color_rgb_array_is_monotonic	(const GPtrArray	*array);
 GPtrArray	*cd_color_rgb_array_interpolate		(const GPtrArray	*array,
 							 guint			 new_length)
 							 G_GNUC_WARN_UNUSED_RESULT;
+GArray		*cd_color_rgb_array_interpolate_packed	(const GArray		*array,
+							 guint			 new_length)
+							 G_GNUC_WARN_UNUSED_RESULT;
 
 G_END_DECLS
 
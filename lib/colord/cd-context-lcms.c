@@ -134,13 +134,11 @@ cmsPluginParametricCurves cd_icc_lcms_plugins = {
 	cd_context_lcms_plugins_cb		/* evaluator */
 };
 
-/**
- * cd_context_lcms_new:
- *
- * Return value: (transfer full): A new LCMS context
- **/
-gpointer
-cd_context_lcms_new (void)
+/* creating a context registers the error handler and the curve plugin,
+ * which walks and locks lcms's global bookkeeping; recycling contexts
+ * through a pool keeps that off the parse path */
+static gpointer
+cd_context_lcms_create (void)
 {
 	cmsContext ctx;
 	GError **error_ctx;
@@ -151,11 +149,8 @@ cd_context_lcms_new (void)
 	return ctx;
 }
 
-/**
- * cd_context_lcms_free:
- **/
-void
-cd_context_lcms_free (gpointer ctx)
+static void
+cd_context_lcms_destroy (gpointer ctx)
 {
 	GError **error_ctx;
 
@@ -167,6 +162,68 @@ cd_context_lcms_free (gpointer ctx)
 	cmsDeleteContext (ctx);
 }
 
+/* each thread keeps a few idle contexts, so parallel loaders neither
+ * contend on a shared lock nor serialize inside lcms plugin setup;
+ * a context may be created on one thread and returned on another, and
+ * then just joins the pool of the thread that freed it */
+#define CD_CONTEXT_LCMS_POOL_MAX_ITEMS	4
+
+static void
+cd_context_lcms_pool_free (gpointer data)
+{
+	GPtrArray *pool = (GPtrArray *) data;
+	g_ptr_array_unref (pool);
+}
+
+static GPrivate cd_context_lcms_pool = G_PRIVATE_INIT (cd_context_lcms_pool_free);
+
+static GPtrArray *
+cd_context_lcms_pool_get (void)
+{
+	GPtrArray *pool = g_private_get (&cd_context_lcms_pool);
+	if (pool == NULL) {
+		pool = g_ptr_array_new_with_free_func ((GDestroyNotify) cd_context_lcms_destroy);
+		g_private_set (&cd_context_lcms_pool, pool);
+	}
+	return pool;
+}
+
+/**
+ * cd_context_lcms_new:
+ *
+ * Return value: (transfer full): A new LCMS context
+ **/
+gpointer
+cd_context_lcms_new (void)
+{
+	GPtrArray *pool = cd_context_lcms_pool_get ();
+
+	/* reuse a context this thread has seen before; the error handler
+	 * and plugins are already registered */
+	if (pool->len > 0)
+		return g_ptr_array_steal_index_fast (pool, pool->len - 1);
+	return cd_context_lcms_create ();
+}
+
+/**
+ * cd_context_lcms_free:
+ **/
+void
+cd_context_lcms_free (gpointer ctx)
+{
+	GPtrArray *pool = cd_context_lcms_pool_get ();
+
+	/* any pending error must not leak into the next user */
+	cd_context_lcms_error_clear (ctx);
+
+	/* pin the context to this thread for reuse */
+	if (pool->len < CD_CONTEXT_LCMS_POOL_MAX_ITEMS) {
+		g_ptr_array_add (pool, ctx);
+		return;
+	}
+	cd_context_lcms_destroy (ctx);
+}
+
 /**
  * cd_context_lcms_error_clear:
  **/
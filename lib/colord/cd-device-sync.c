@@ -156,6 +156,60 @@ cd_device_set_property_sync (CdDevice *device,
 
 /**********************************************************************/
 
+static void
+cd_device_set_properties_finish_sync (CdDevice *device,
+				      GAsyncResult *res,
+				      CdDeviceHelper *helper)
+{
+	helper->ret = cd_device_set_properties_finish (device,
+						       res,
+						       helper->error);
+	g_main_loop_quit (helper->loop);
+}
+
+/**
+ * cd_device_set_properties_sync:
+ * @device: a #CdDevice instance.
+ * @properties: (element-type utf8 utf8): the keys and values to set
+ * @cancellable: a #GCancellable or %NULL
+ * @error: a #GError, or %NULL.
+ *
+ * Sets several object properties in one D-Bus round trip.
+ *
+ * WARNING: This function is synchronous, and may block.
+ * Do not use it in GUI applications.
+ *
+ * Return value: %TRUE for success, else %FALSE.
+ *
+ * Since: 1.4.6
+ **/
+gboolean
+cd_device_set_properties_sync (CdDevice *device,
+			       GHashTable *properties,
+			       GCancellable *cancellable,
+			       GError **error)
+{
+	CdDeviceHelper helper;
+
+	/* create temp object */
+	memset (&helper, 0, sizeof (CdDeviceHelper));
+	helper.loop = g_main_loop_new (NULL, FALSE);
+	helper.error = error;
+
+	/* run async method */
+	cd_device_set_properties (device, properties, cancellable,
+				  (GAsyncReadyCallback) cd_device_set_properties_finish_sync,
+				  &helper);
+	g_main_loop_run (helper.loop);
+
+	/* free temp object */
+	g_main_loop_unref (helper.loop);
+
+	return helper.ret;
+}
+
+/**********************************************************************/
+
 static void
 cd_device_add_profile_finish_sync (CdDevice *device,
 				   GAsyncResult *res,
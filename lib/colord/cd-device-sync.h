@@ -43,6 +43,11 @@ gboolean	 cd_device_set_property_sync		(CdDevice	*device,
 							 GCancellable	*cancellable,
 							 GError		**error)
 							 G_GNUC_WARN_UNUSED_RESULT;
+gboolean	 cd_device_set_properties_sync		(CdDevice	*device,
+							 GHashTable	*properties,
+							 GCancellable	*cancellable,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
 gboolean	 cd_device_add_profile_sync		(CdDevice	*device,
 							 CdDeviceRelation relation,
 							 CdProfile	*profile,
@@ -57,6 +57,7 @@ static void	cd_device_finalize	(GObject		*object);
 typedef struct
 {
 	GDBusProxy		*proxy;
+	guint			 props_changed_id;
 	gchar			*object_path;
 	gchar			*id;
 	gchar			*model;
@@ -75,6 +76,9 @@ typedef struct
 	gboolean		 enabled;
 	gboolean		 embedded;
 	guint			 owner;
+	guint64			 generation;
+	guint64			 generation_last;
+	gint64			 properties_mtime;
 	GHashTable		*metadata;
 } CdDevicePrivate;
 
@@ -315,6 +319,31 @@ cd_device_get_modified (CdDevice *device)
 	return priv->modified;
 }
 
+/**
+ * cd_device_get_properties_age:
+ * @device: a #CdDevice instance.
+ *
+ * Gets the time since the local property snapshot was last updated,
+ * either by connecting or by the daemon pushing a change. The daemon
+ * notifies of every change, so a caller polling device state can
+ * trust any cached value with a small age rather than re-reading the
+ * properties over the bus.
+ *
+ * Return value: the age in microseconds, or %G_MAXINT64 if the
+ * properties have never been loaded
+ *
+ * Since: 1.4.6
+ **/
+gint64
+cd_device_get_properties_age (CdDevice *device)
+{
+	CdDevicePrivate *priv = GET_PRIVATE (device);
+	g_return_val_if_fail (CD_IS_DEVICE (device), G_MAXINT64);
+	if (priv->properties_mtime == 0)
+		return G_MAXINT64;
+	return g_get_monotonic_time () - priv->properties_mtime;
+}
+
 /**
  * cd_device_get_kind:
  * @device: a #CdDevice instance.
@@ -449,6 +478,26 @@ cd_device_get_owner (CdDevice *device)
 	return priv->owner;
 }
 
+/**
+ * cd_device_get_generation:
+ * @device: a #CdDevice instance.
+ *
+ * Gets the device state generation, which the daemon increments once
+ * for each batch of property changes.
+ *
+ * Return value: The generation counter, or 0 for unknown
+ *
+ * Since: 1.4.6
+ **/
+guint64
+cd_device_get_generation (CdDevice *device)
+{
+	CdDevicePrivate *priv = GET_PRIVATE (device);
+	g_return_val_if_fail (CD_IS_DEVICE (device), 0);
+	g_return_val_if_fail (priv->proxy != NULL, 0);
+	return priv->generation;
+}
+
 /**
  * cd_device_get_profiles:
  * @device: a #CdDevice instance.
@@ -600,10 +649,8 @@ cd_device_get_nullable_str (GVariant *value)
 }
 
 static void
-cd_device_dbus_properties_changed_cb (GDBusProxy  *proxy,
-				      GVariant    *changed_properties,
-				      const gchar * const *invalidated_properties,
-				      CdDevice    *device)
+cd_device_set_properties_from_variant (CdDevice *device,
+				       GVariant *properties)
 {
 	CdDevicePrivate *priv = GET_PRIVATE (device);
 	guint i;
@@ -614,9 +661,9 @@ cd_device_dbus_properties_changed_cb (GDBusProxy  *proxy,
 
 	g_return_if_fail (CD_IS_DEVICE (device));
 
-	len = g_variant_iter_init (&iter, changed_properties);
+	len = g_variant_iter_init (&iter, properties);
 	for (i = 0; i < len; i++) {
-		g_variant_get_child (changed_properties, i,
+		g_variant_get_child (properties, i,
 				     "{sv}",
 				     &property_name,
 				     &property_value);
@@ -662,16 +709,33 @@ cd_device_dbus_properties_changed_cb (GDBusProxy  *proxy,
 			cd_device_set_metadata_from_variant (device, property_value);
 		} else if (g_strcmp0 (property_name, CD_DEVICE_PROPERTY_OWNER) == 0) {
 			priv->owner = g_variant_get_uint32 (property_value);
+		} else if (g_strcmp0 (property_name, CD_DEVICE_PROPERTY_GENERATION) == 0) {
+			priv->generation = g_variant_get_uint64 (property_value);
 		} else if (g_strcmp0 (property_name, CD_DEVICE_PROPERTY_SCOPE) == 0) {
 			priv->scope = cd_object_scope_from_string (g_variant_get_string (property_value, NULL));
 		} else if (g_strcmp0 (property_name, CD_DEVICE_PROPERTY_ID) == 0) {
-			/* ignore this, we don't support it changing */;
+			/* the ID never changes once set, but it is present
+			 * when hydrating from GetDevicesWithProperties() */
+			if (priv->id == NULL)
+				priv->id = cd_device_get_nullable_str (property_value);
 		} else {
 			g_warning ("%s property unhandled", property_name);
 		}
 		g_free (property_name);
 		g_variant_unref (property_value);
 	}
+
+	/* the local snapshot is now current */
+	priv->properties_mtime = g_get_monotonic_time ();
+}
+
+static void
+cd_device_dbus_properties_changed_cb (GDBusProxy  *proxy,
+				      GVariant    *changed_properties,
+				      const gchar * const *invalidated_properties,
+				      CdDevice    *device)
+{
+	cd_device_set_properties_from_variant (device, changed_properties);
 }
 
 static void
@@ -681,11 +745,22 @@ cd_device_dbus_signal_cb (GDBusProxy *proxy,
 			  GVariant   *parameters,
 			  CdDevice   *device)
 {
+	CdDevicePrivate *priv = GET_PRIVATE (device);
 	gchar *object_path_tmp = NULL;
 
 	g_return_if_fail (CD_IS_DEVICE (device));
 
 	if (g_strcmp0 (signal_name, "Changed") == 0) {
+		/* the daemon bumps the generation with every batch of
+		 * property changes, so a replay with no new state does
+		 * not need a refresh */
+		if (priv->generation != 0 &&
+		    priv->generation == priv->generation_last) {
+			g_debug ("CdDevice: ignoring Changed for generation %"
+				 G_GUINT64_FORMAT, priv->generation);
+			return;
+		}
+		priv->generation_last = priv->generation;
 		g_signal_emit (device, signals[SIGNAL_CHANGED], 0);
 	} else {
 		g_warning ("unhandled signal '%s'", signal_name);
@@ -723,26 +798,13 @@ cd_device_connect_cb (GObject *source_object,
 {
 	CdDevice *device;
 	CdDevicePrivate *priv;
+	GVariantBuilder builder;
+	guint i;
+	g_auto(GStrv) property_names = NULL;
 	g_autoptr(GError) error = NULL;
 	g_autoptr(GTask) task = G_TASK (user_data);
-	g_autoptr(GVariant) colorspace = NULL;
-	g_autoptr(GVariant) created = NULL;
-	g_autoptr(GVariant) embedded = NULL;
-	g_autoptr(GVariant) enabled = NULL;
-	g_autoptr(GVariant) format = NULL;
 	g_autoptr(GVariant) id = NULL;
-	g_autoptr(GVariant) kind = NULL;
-	g_autoptr(GVariant) metadata = NULL;
-	g_autoptr(GVariant) model = NULL;
-	g_autoptr(GVariant) mode = NULL;
-	g_autoptr(GVariant) modified = NULL;
-	g_autoptr(GVariant) owner = NULL;
-	g_autoptr(GVariant) profiles = NULL;
-	g_autoptr(GVariant) profiling_inhibitors = NULL;
-	g_autoptr(GVariant) scope = NULL;
-	g_autoptr(GVariant) seat = NULL;
-	g_autoptr(GVariant) serial = NULL;
-	g_autoptr(GVariant) vendor = NULL;
+	g_autoptr(GVariant) snapshot = NULL;
 
 	device = CD_DEVICE (g_task_get_source_object (task));
 	priv = GET_PRIVATE (device);
@@ -773,110 +835,24 @@ cd_device_connect_cb (GObject *source_object,
 		return;
 	}
 
-	/* get kind */
-	kind = g_dbus_proxy_get_cached_property (priv->proxy,
-						 CD_DEVICE_PROPERTY_KIND);
-	if (kind != NULL)
-		priv->kind =
-			cd_device_kind_from_string (g_variant_get_string (kind, NULL));
-
-	/* get colorspace */
-	colorspace = g_dbus_proxy_get_cached_property (priv->proxy,
-						       CD_DEVICE_PROPERTY_COLORSPACE);
-	if (colorspace != NULL)
-		priv->colorspace =
-			cd_colorspace_from_string (g_variant_get_string (colorspace, NULL));
-
-	/* get scope */
-	scope = g_dbus_proxy_get_cached_property (priv->proxy,
-						  CD_DEVICE_PROPERTY_SCOPE);
-	if (scope != NULL)
-		priv->scope =
-			cd_object_scope_from_string (g_variant_get_string (scope, NULL));
-
-	/* get enabled */
-	enabled = g_dbus_proxy_get_cached_property (priv->proxy,
-						    CD_DEVICE_PROPERTY_ENABLED);
-	if (enabled != NULL)
-		priv->enabled = g_variant_get_boolean (enabled);
-
-	/* get owner */
-	owner = g_dbus_proxy_get_cached_property (priv->proxy,
-						  CD_DEVICE_PROPERTY_OWNER);
-	if (owner != NULL)
-		priv->owner = g_variant_get_uint32 (owner);
-
-	/* get mode */
-	mode = g_dbus_proxy_get_cached_property (priv->proxy,
-						 CD_DEVICE_PROPERTY_MODE);
-	if (mode != NULL)
-		priv->mode =
-			cd_device_mode_from_string (g_variant_get_string (mode, NULL));
-
-	/* get model */
-	model = g_dbus_proxy_get_cached_property (priv->proxy,
-						  CD_DEVICE_PROPERTY_MODEL);
-	if (model != NULL)
-		priv->model = cd_device_get_nullable_str (model);
-
-	/* get serial */
-	serial = g_dbus_proxy_get_cached_property (priv->proxy,
-						   CD_DEVICE_PROPERTY_SERIAL);
-	if (serial != NULL)
-		priv->serial = cd_device_get_nullable_str (serial);
-
-	/* get seat */
-	seat = g_dbus_proxy_get_cached_property (priv->proxy,
-						 CD_DEVICE_PROPERTY_SEAT);
-	if (seat != NULL)
-		priv->seat = cd_device_get_nullable_str (seat);
-
-	/* get format */
-	format = g_dbus_proxy_get_cached_property (priv->proxy,
-						   CD_DEVICE_PROPERTY_FORMAT);
-	if (format != NULL)
-		priv->format = cd_device_get_nullable_str (format);
-
-	/* get vendor */
-	vendor = g_dbus_proxy_get_cached_property (priv->proxy,
-						   CD_DEVICE_PROPERTY_VENDOR);
-	if (vendor != NULL)
-		priv->vendor = cd_device_get_nullable_str (vendor);
-
-	/* get profiling inhibitors */
-	profiling_inhibitors = g_dbus_proxy_get_cached_property (priv->proxy,
-								 CD_DEVICE_PROPERTY_PROFILING_INHIBITORS);
-	if (profiling_inhibitors != NULL)
-		priv->profiling_inhibitors = g_variant_dup_strv (profiling_inhibitors, NULL);
-
-	/* get created */
-	created = g_dbus_proxy_get_cached_property (priv->proxy,
-						    CD_DEVICE_PROPERTY_CREATED);
-	if (created != NULL)
-		priv->created = g_variant_get_uint64 (created);
-
-	/* get modified */
-	modified = g_dbus_proxy_get_cached_property (priv->proxy,
-						     CD_DEVICE_PROPERTY_MODIFIED);
-	if (modified != NULL)
-		priv->modified = g_variant_get_uint64 (modified);
-
-	/* get profiles */
-	profiles = g_dbus_proxy_get_cached_property (priv->proxy,
-						     CD_DEVICE_PROPERTY_PROFILES);
-	cd_device_set_profiles_array_from_variant (device, profiles);
-
-	/* get embedded */
-	embedded = g_dbus_proxy_get_cached_property (priv->proxy,
-						     CD_DEVICE_PROPERTY_EMBEDDED);
-	if (embedded != NULL)
-		priv->embedded = g_variant_get_boolean (embedded);
-
-	/* get metadata */
-	metadata = g_dbus_proxy_get_cached_property (priv->proxy,
-						     CD_DEVICE_PROPERTY_METADATA);
-	if (metadata != NULL)
-		cd_device_set_metadata_from_variant (device, metadata);
+	/* hydrate everything else from the proxy property cache in one
+	 * pass; the proxy already paid for the single GetAll round trip
+	 * when it was constructed, so nothing here touches the bus */
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+	property_names = g_dbus_proxy_get_cached_property_names (priv->proxy);
+	for (i = 0; property_names != NULL && property_names[i] != NULL; i++) {
+		g_autoptr(GVariant) value = NULL;
+		if (g_strcmp0 (property_names[i], CD_DEVICE_PROPERTY_ID) == 0)
+			continue;
+		value = g_dbus_proxy_get_cached_property (priv->proxy,
+							  property_names[i]);
+		if (value == NULL)
+			continue;
+		g_variant_builder_add (&builder, "{sv}",
+				       property_names[i], value);
+	}
+	snapshot = g_variant_ref_sink (g_variant_builder_end (&builder));
+	cd_device_set_properties_from_variant (device, snapshot);
 
 	/* get signals from DBus */
 	g_signal_connect_object (priv->proxy,
@@ -938,6 +914,157 @@ cd_device_connect (CdDevice *device,
 
 /**********************************************************************/
 
+/**
+ * cd_device_connect_with_properties_finish:
+ * @device: a #CdDevice instance.
+ * @res: the #GAsyncResult
+ * @error: A #GError or %NULL
+ *
+ * Gets the result from the asynchronous function.
+ *
+ * Return value: success
+ *
+ * Since: 1.4.6
+ **/
+gboolean
+cd_device_connect_with_properties_finish (CdDevice *device,
+					  GAsyncResult *res,
+					  GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (res, device), FALSE);
+	return g_task_propagate_boolean (G_TASK (res), error);
+}
+
+static void
+cd_device_properties_changed_signal_cb (GDBusConnection *connection,
+					const gchar *sender_name,
+					const gchar *object_path,
+					const gchar *interface_name,
+					const gchar *signal_name,
+					GVariant *parameters,
+					gpointer user_data)
+{
+	CdDevice *device = CD_DEVICE (user_data);
+	g_autoptr(GVariant) changed_properties = NULL;
+
+	/* (sa{sv}as) */
+	changed_properties = g_variant_get_child_value (parameters, 1);
+	cd_device_set_properties_from_variant (device, changed_properties);
+}
+
+static void
+cd_device_connect_with_properties_cb (GObject *source_object,
+				      GAsyncResult *res,
+				      gpointer user_data)
+{
+	CdDevice *device;
+	CdDevicePrivate *priv;
+	GVariant *properties;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GTask) task = G_TASK (user_data);
+
+	device = CD_DEVICE (g_task_get_source_object (task));
+	priv = GET_PRIVATE (device);
+	priv->proxy = g_dbus_proxy_new_for_bus_finish (res, &error);
+	if (priv->proxy == NULL) {
+		g_task_return_new_error (task,
+					 CD_DEVICE_ERROR,
+					 CD_DEVICE_ERROR_INTERNAL,
+					 "Failed to connect to device %s: %s",
+					 cd_device_get_object_path (device),
+					 error->message);
+		return;
+	}
+
+	/* set all the properties we were handed up front */
+	properties = g_task_get_task_data (task);
+	cd_device_set_properties_from_variant (device, properties);
+
+	/* if the device is missing, then fail */
+	if (priv->id == NULL) {
+		g_task_return_new_error (task,
+					 CD_DEVICE_ERROR,
+					 CD_DEVICE_ERROR_INTERNAL,
+					 "Failed to connect to missing device %s",
+					 cd_device_get_object_path (device));
+		return;
+	}
+
+	/* get signals from DBus */
+	g_signal_connect_object (priv->proxy,
+				 "g-signal",
+				 G_CALLBACK (cd_device_dbus_signal_cb),
+				 device, 0);
+
+	/* the proxy does not emit g-properties-changed when it was created
+	 * without loading properties, so watch the signal directly */
+	priv->props_changed_id =
+		g_dbus_connection_signal_subscribe (g_dbus_proxy_get_connection (priv->proxy),
+						    COLORD_DBUS_SERVICE,
+						    "org.freedesktop.DBus.Properties",
+						    "PropertiesChanged",
+						    priv->object_path,
+						    COLORD_DBUS_INTERFACE_DEVICE,
+						    G_DBUS_SIGNAL_FLAGS_NONE,
+						    cd_device_properties_changed_signal_cb,
+						    device, NULL);
+
+	/* success */
+	g_task_return_boolean (task, TRUE);
+}
+
+/**
+ * cd_device_connect_with_properties:
+ * @device: a #CdDevice instance.
+ * @properties: the full device property set of type <literal>a{sv}</literal>
+ * @cancellable: a #GCancellable, or %NULL
+ * @callback: the function to run on completion
+ * @user_data: the data to pass to @callback
+ *
+ * Connects to the object and fills up initial properties from a property
+ * set already obtained from the daemon, e.g. using GetDevicesWithProperties(),
+ * which avoids the implicit GetAll() call for each device.
+ *
+ * Since: 1.4.6
+ **/
+void
+cd_device_connect_with_properties (CdDevice *device,
+				   GVariant *properties,
+				   GCancellable *cancellable,
+				   GAsyncReadyCallback callback,
+				   gpointer user_data)
+{
+	CdDevicePrivate *priv = GET_PRIVATE (device);
+	GTask *task = NULL;
+
+	g_return_if_fail (CD_IS_DEVICE (device));
+	g_return_if_fail (properties != NULL);
+	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+	task = g_task_new (device, cancellable, callback, user_data);
+	g_task_set_task_data (task,
+			      g_variant_ref (properties),
+			      (GDestroyNotify) g_variant_unref);
+
+	/* already connected */
+	if (priv->proxy != NULL) {
+		g_task_return_boolean (task, TRUE);
+		return;
+	}
+
+	g_dbus_proxy_new_for_bus (G_BUS_TYPE_SYSTEM,
+				  G_DBUS_PROXY_FLAGS_DO_NOT_LOAD_PROPERTIES,
+				  NULL,
+				  COLORD_DBUS_SERVICE,
+				  priv->object_path,
+				  COLORD_DBUS_INTERFACE_DEVICE,
+				  cancellable,
+				  cd_device_connect_with_properties_cb,
+				  task);
+}
+
+/**********************************************************************/
+
 /**
  * cd_device_set_property_finish:
  * @device: a #CdDevice instance.
@@ -1044,6 +1171,81 @@ cd_device_set_property (CdDevice *device,
 
 /**********************************************************************/
 
+/**
+ * cd_device_set_properties_finish:
+ * @device: a #CdDevice instance.
+ * @res: the #GAsyncResult
+ * @error: A #GError or %NULL
+ *
+ * Gets the result from the asynchronous function.
+ *
+ * Return value: success
+ *
+ * Since: 1.4.6
+ **/
+gboolean
+cd_device_set_properties_finish (CdDevice *device,
+				 GAsyncResult *res,
+				 GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (res, device), FALSE);
+	return g_task_propagate_boolean (G_TASK (res), error);
+}
+
+/**
+ * cd_device_set_properties:
+ * @device: a #CdDevice instance.
+ * @properties: (element-type utf8 utf8): the keys and values to set
+ * @cancellable: a #GCancellable, or %NULL
+ * @callback: the function to run on completion
+ * @user_data: the data to pass to @callback
+ *
+ * Sets several properties on the device in a single D-Bus round trip,
+ * which is much cheaper than calling cd_device_set_property() once
+ * per key.
+ *
+ * Since: 1.4.6
+ **/
+void
+cd_device_set_properties (CdDevice *device,
+			  GHashTable *properties,
+			  GCancellable *cancellable,
+			  GAsyncReadyCallback callback,
+			  gpointer user_data)
+{
+	CdDevicePrivate *priv = GET_PRIVATE (device);
+	GTask *task = NULL;
+	GVariantBuilder builder;
+	GHashTableIter iter;
+	gpointer key;
+	gpointer value;
+
+	g_return_if_fail (CD_IS_DEVICE (device));
+	g_return_if_fail (properties != NULL);
+	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+	g_return_if_fail (priv->proxy != NULL);
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{ss}"));
+	g_hash_table_iter_init (&iter, properties);
+	while (g_hash_table_iter_next (&iter, &key, &value)) {
+		g_variant_builder_add (&builder, "{ss}",
+				       (const gchar *) key,
+				       (const gchar *) value);
+	}
+
+	task = g_task_new (device, cancellable, callback, user_data);
+	g_dbus_proxy_call (priv->proxy,
+			   "SetProperties",
+			   g_variant_new ("(a{ss})", &builder),
+			   G_DBUS_CALL_FLAGS_NONE,
+			   -1,
+			   cancellable,
+			   cd_device_set_property_cb,
+			   task);
+}
+
+/**********************************************************************/
+
 /**
  * cd_device_add_profile_finish:
  * @device: a #CdDevice instance.
@@ -2233,6 +2435,9 @@ cd_device_finalize (GObject *object)
 	g_free (priv->vendor);
 	g_strfreev (priv->profiling_inhibitors);
 	g_ptr_array_unref (priv->profiles);
+	if (priv->props_changed_id != 0)
+		g_dbus_connection_signal_unsubscribe (g_dbus_proxy_get_connection (priv->proxy),
+						      priv->props_changed_id);
 	if (priv->proxy != NULL)
 		g_object_unref (priv->proxy);
 
@@ -69,6 +69,15 @@ gboolean	 cd_device_connect_finish		(CdDevice	*device,
 							 GAsyncResult	*res,
 							 GError		**error)
 							 G_GNUC_WARN_UNUSED_RESULT;
+void		 cd_device_connect_with_properties	(CdDevice	*device,
+							 GVariant	*properties,
+							 GCancellable	*cancellable,
+							 GAsyncReadyCallback callback,
+							 gpointer	 user_data);
+gboolean	 cd_device_connect_with_properties_finish (CdDevice	*device,
+							 GAsyncResult	*res,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
 void		 cd_device_set_property			(CdDevice	*device,
 							 const gchar	*key,
 							 const gchar	*value,
@@ -79,6 +88,15 @@ gboolean	 cd_device_set_property_finish		(CdDevice	*device,
 							 GAsyncResult	*res,
 							 GError		**error)
 							 G_GNUC_WARN_UNUSED_RESULT;
+void		 cd_device_set_properties		(CdDevice	*device,
+							 GHashTable	*properties,
+							 GCancellable	*cancellable,
+							 GAsyncReadyCallback callback,
+							 gpointer	 user_data);
+gboolean	 cd_device_set_properties_finish	(CdDevice	*device,
+							 GAsyncResult	*res,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
 void		 cd_device_add_profile			(CdDevice	*device,
 							 CdDeviceRelation relation,
 							 CdProfile	*profile,
@@ -160,6 +178,7 @@ const gchar	*cd_device_get_format			(CdDevice	*device);
 const gchar	**cd_device_get_profiling_inhibitors	(CdDevice	*device);
 guint64		 cd_device_get_created			(CdDevice	*device);
 guint64		 cd_device_get_modified			(CdDevice	*device);
+gint64		 cd_device_get_properties_age		(CdDevice	*device);
 CdDeviceKind	 cd_device_get_kind			(CdDevice	*device);
 CdColorspace	 cd_device_get_colorspace		(CdDevice	*device);
 CdDeviceMode	 cd_device_get_mode			(CdDevice	*device);
@@ -167,6 +186,7 @@ gboolean	 cd_device_get_enabled			(CdDevice	*device);
 gboolean	 cd_device_get_embedded			(CdDevice	*device);
 CdObjectScope	 cd_device_get_scope			(CdDevice	*device);
 guint		 cd_device_get_owner			(CdDevice	*device);
+guint64		 cd_device_get_generation		(CdDevice	*device);
 GPtrArray	*cd_device_get_profiles			(CdDevice	*device);
 CdProfile	*cd_device_get_default_profile		(CdDevice	*device);
 const gchar	*cd_device_get_object_path		(CdDevice	*device);
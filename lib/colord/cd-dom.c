@@ -27,6 +27,7 @@
 #include "config.h"
 
 #include <glib.h>
+#include <string.h>
 
 #include "cd-dom.h"
 
@@ -49,7 +50,7 @@ typedef struct
 
 typedef struct
 {
-	gchar		*name;
+	const gchar	*name;		/* interned */
 	GString		*cdata;
 	GHashTable	*attributes;
 } CdDomNodeData;
@@ -134,9 +135,10 @@ cd_dom_start_element_cb (GMarkupParseContext *context,
 	GNode *new;
 	guint i;
 
-	/* create the new node data */
+	/* create the new node data; the name is interned as element names
+	 * repeat thousands of times in large data documents */
 	data = g_slice_new (CdDomNodeData);
-	data->name = g_strdup (element_name);
+	data->name = g_intern_string (element_name);
 	data->cdata = g_string_new (NULL);
 	data->attributes = g_hash_table_new_full (g_str_hash,
 						  g_str_equal,
@@ -236,6 +238,137 @@ cd_dom_parse_xml_data (CdDom *dom,
 	return TRUE;
 }
 
+typedef struct {
+	GString			*path;
+	GString			*cdata;
+	CdDomParseItemCb	 item_cb;
+	gpointer		 user_data;
+} CdDomStreamHelper;
+
+static void
+cd_dom_stream_start_element_cb (GMarkupParseContext *context,
+				const gchar         *element_name,
+				const gchar        **attribute_names,
+				const gchar        **attribute_values,
+				gpointer             user_data,
+				GError             **error)
+{
+	CdDomStreamHelper *helper = (CdDomStreamHelper *) user_data;
+
+	if (helper->path->len > 0)
+		g_string_append_c (helper->path, '/');
+	g_string_append (helper->path, element_name);
+	g_string_truncate (helper->cdata, 0);
+}
+
+static void
+cd_dom_stream_end_element_cb (GMarkupParseContext *context,
+			      const gchar         *element_name,
+			      gpointer             user_data,
+			      GError             **error)
+{
+	CdDomStreamHelper *helper = (CdDomStreamHelper *) user_data;
+	gchar *tmp;
+
+	/* emit the element, then pop it off the path */
+	helper->item_cb (helper->path->str,
+			 helper->cdata->str,
+			 helper->user_data,
+			 error);
+	g_string_truncate (helper->cdata, 0);
+	tmp = strrchr (helper->path->str, '/');
+	g_string_truncate (helper->path,
+			   tmp != NULL ? (gsize) (tmp - helper->path->str) : 0);
+}
+
+static void
+cd_dom_stream_text_cb (GMarkupParseContext *context,
+		       const gchar         *text,
+		       gsize                text_len,
+		       gpointer             user_data,
+		       GError             **error)
+{
+	CdDomStreamHelper *helper = (CdDomStreamHelper *) user_data;
+	guint i;
+
+	/* no data */
+	if (text_len == 0)
+		return;
+
+	/* all whitespace? */
+	for (i = 0; i < text_len; i++) {
+		if (text[i] != ' ' &&
+		    text[i] != '\n' &&
+		    text[i] != '\t')
+			break;
+	}
+	if (i >= text_len)
+		return;
+
+	/* save cdata */
+	g_string_append_len (helper->cdata, text, text_len);
+}
+
+/**
+ * cd_dom_parse_xml_stream:
+ * @data: (array length=data_len): XML data
+ * @data_len: Length of @data, or -1 if NULL terminated
+ * @item_cb: (scope call): a #CdDomParseItemCb called once per element
+ * @user_data: user data to pass to @item_cb
+ * @error: A #GError or %NULL
+ *
+ * Parses data in streaming mode, without building a DOM tree.
+ *
+ * The callback is run when each element is closed, with the path of the
+ * element (e.g. `spectra/spectrum/data`) and any character data it
+ * contained. Only two reused buffers are allocated however large the
+ * document, which makes this suitable for multi-megabyte data files
+ * where a full tree would cost more than the data itself.
+ *
+ * Elements should contain either child elements or character data;
+ * mixed content is not preserved in this mode.
+ *
+ * Return value: %TRUE for success
+ *
+ * Since: 1.4.6
+ **/
+gboolean
+cd_dom_parse_xml_stream (const gchar *data,
+			 gssize data_len,
+			 CdDomParseItemCb item_cb,
+			 gpointer user_data,
+			 GError **error)
+{
+	CdDomStreamHelper helper;
+	gboolean ret;
+	g_autoptr(GMarkupParseContext) ctx = NULL;
+	const GMarkupParser parser = {
+		cd_dom_stream_start_element_cb,
+		cd_dom_stream_end_element_cb,
+		cd_dom_stream_text_cb,
+		NULL,
+		NULL };
+
+	g_return_val_if_fail (data != NULL, FALSE);
+	g_return_val_if_fail (item_cb != NULL, FALSE);
+
+	helper.path = g_string_new (NULL);
+	helper.cdata = g_string_new (NULL);
+	helper.item_cb = item_cb;
+	helper.user_data = user_data;
+	ctx = g_markup_parse_context_new (&parser,
+					  G_MARKUP_PREFIX_ERROR_POSITION,
+					  &helper,
+					  NULL);
+	ret = g_markup_parse_context_parse (ctx,
+					    data,
+					    data_len,
+					    error);
+	g_string_free (helper.path, TRUE);
+	g_string_free (helper.cdata, TRUE);
+	return ret;
+}
+
 static GNode *
 cd_dom_get_child_node (const GNode *root, const gchar *name)
 {
@@ -324,6 +457,102 @@ cd_dom_get_node_data_as_double (const GNode *node)
 	return value_tmp;
 }
 
+static gboolean
+cd_dom_parse_double (const gchar **text, gdouble *value)
+{
+	const gchar *p = *text;
+	gboolean negative = FALSE;
+	gchar *endptr = NULL;
+	guint64 mantissa = 0;
+	guint digits = 0;
+	guint frac_digits = 0;
+	static const gdouble divisor[] = { 1e0, 1e1, 1e2, 1e3,
+					   1e4, 1e5, 1e6, 1e7,
+					   1e8, 1e9, 1e10, 1e11,
+					   1e12, 1e13, 1e14, 1e15 };
+
+	/* handle the common "-12.345" form without the strtod overhead */
+	if (*p == '-') {
+		negative = TRUE;
+		p++;
+	} else if (*p == '+') {
+		p++;
+	}
+	while (g_ascii_isdigit (*p)) {
+		mantissa = mantissa * 10 + (guint64) (*p - '0');
+		digits++;
+		p++;
+	}
+	if (*p == '.') {
+		p++;
+		while (g_ascii_isdigit (*p)) {
+			mantissa = mantissa * 10 + (guint64) (*p - '0');
+			digits++;
+			frac_digits++;
+			p++;
+		}
+	}
+
+	/* exponents and oversized mantissas are rare; let strtod do those */
+	if (digits == 0 || digits > 15 || *p == 'e' || *p == 'E') {
+		*value = g_ascii_strtod (*text, &endptr);
+		if (endptr == *text)
+			return FALSE;
+		*text = endptr;
+		return TRUE;
+	}
+
+	*value = (gdouble) mantissa / divisor[frac_digits];
+	if (negative)
+		*value = -*value;
+	*text = p;
+	return TRUE;
+}
+
+/**
+ * cd_dom_get_node_double_array:
+ * @node: a #GNode
+ * @values: (array length=values_len): destination buffer
+ * @values_len: the maximum number of values to parse
+ *
+ * Parses whitespace-separated numeric node content directly into a
+ * preallocated buffer, without creating any temporary strings. This is
+ * the preferred way of reading bulk data such as spectra, where one
+ * node may contain thousands of values.
+ *
+ * Return value: the number of values parsed, which may be less than
+ * @values_len if the content ends or fails to parse
+ *
+ * Since: 1.4.6
+ **/
+guint
+cd_dom_get_node_double_array (const GNode *node,
+			      gdouble *values,
+			      guint values_len)
+{
+	const gchar *tmp;
+	guint i;
+
+	g_return_val_if_fail (node != NULL, 0);
+	g_return_val_if_fail (values != NULL, 0);
+
+	/* get string */
+	tmp = cd_dom_get_node_data (node);
+	if (tmp == NULL)
+		return 0;
+
+	for (i = 0; i < values_len; i++) {
+		while (*tmp == ' ' || *tmp == '\n' ||
+		       *tmp == '\t' || *tmp == '\r')
+			tmp++;
+		if (*tmp == '\0')
+			break;
+		if (!cd_dom_parse_double (&tmp, &values[i]))
+			break;
+	}
+	return i;
+}
+
 /**
  * cd_dom_get_node_data_as_int:
  * @node: a #GNode
@@ -599,7 +828,6 @@ cd_dom_destroy_node_cb (GNode *node, gpointer user_data)
 	CdDomNodeData *data = node->data;
 	if (data == NULL)
 		return FALSE;
-	g_free (data->name);
 	g_string_free (data->cdata, TRUE);
 	g_hash_table_unref (data->attributes);
 	g_slice_free (CdDomNodeData, data);
@@ -53,6 +53,24 @@ struct _CdDomClass
 	void (*_cd_dom_reserved8) (void);
 };
 
+/**
+ * CdDomParseItemCb:
+ * @path: the path of the element, e.g. "html/body/p"
+ * @cdata: the character data contained in the element
+ * @user_data: user data passed to cd_dom_parse_xml_stream()
+ * @error: A #GError or %NULL
+ *
+ * The callback run for each element when parsing in streaming mode.
+ *
+ * Return value: %FALSE with @error set to abort parsing
+ *
+ * Since: 1.4.6
+ **/
+typedef gboolean (*CdDomParseItemCb)			(const gchar	*path,
+							 const gchar	*cdata,
+							 gpointer	 user_data,
+							 GError		**error);
+
 GQuark		 cd_dom_error_quark			(void);
 CdDom		*cd_dom_new				(void);
 gchar		*cd_dom_to_string			(CdDom		*dom);
@@ -61,6 +79,12 @@ gboolean	 cd_dom_parse_xml_data			(CdDom		*dom,
 							 gssize		 data_len,
 							 GError		**error)
 							 G_GNUC_WARN_UNUSED_RESULT;
+gboolean	 cd_dom_parse_xml_stream		(const gchar	*data,
+							 gssize		 data_len,
+							 CdDomParseItemCb item_cb,
+							 gpointer	 user_data,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
 const GNode	*cd_dom_get_node			(CdDom		*dom,
 							 const GNode	*root,
 							 const gchar	*path)
@@ -69,6 +93,9 @@ const gchar	*cd_dom_get_node_name			(const GNode	*node);
 const gchar	*cd_dom_get_node_data			(const GNode	*node);
 gint		 cd_dom_get_node_data_as_int		(const GNode	*node);
 gdouble		 cd_dom_get_node_data_as_double		(const GNode	*node);
+guint		 cd_dom_get_node_double_array		(const GNode	*node,
+							 gdouble	*values,
+							 guint		 values_len);
 const gchar	*cd_dom_get_node_attribute		(const GNode	*node,
 							 const gchar	*key);
 gboolean	 cd_dom_get_node_rgb			(const GNode	*node,
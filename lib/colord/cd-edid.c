@@ -34,17 +34,23 @@ static void	cd_edid_finalize	(GObject	*object);
 
 #define GET_PRIVATE(o) (cd_edid_get_instance_private (o))
 
+/* a descriptor string is at most 13 bytes plus a terminator, and an
+ * MD5 is 32 hex chars; keeping the buffers inline means a re-parse
+ * does no heap work at all */
+#define CD_EDID_STRING_SIZE		14
+#define CD_EDID_CHECKSUM_SIZE		33
+
 typedef struct
 {
-	CdColorYxy		*red;
-	CdColorYxy		*green;
-	CdColorYxy		*blue;
-	CdColorYxy		*white;
-	gchar			*checksum;
-	gchar			*eisa_id;
-	gchar			*monitor_name;
-	gchar			*pnp_id;
-	gchar			*serial_number;
+	CdColorYxy		 red;
+	CdColorYxy		 green;
+	CdColorYxy		 blue;
+	CdColorYxy		 white;
+	gchar			 checksum[CD_EDID_CHECKSUM_SIZE];
+	gchar			 eisa_id[CD_EDID_STRING_SIZE];
+	gchar			 monitor_name[CD_EDID_STRING_SIZE];
+	gchar			 pnp_id[4];
+	gchar			 serial_number[CD_EDID_STRING_SIZE];
 	gchar			*vendor_name;
 	gdouble			 gamma;
 	guint			 height;
@@ -61,6 +67,28 @@ G_DEFINE_TYPE_WITH_PRIVATE (CdEdid, cd_edid, G_TYPE_OBJECT)
 #define CD_EDID_OFFSET_LAST_BLOCK			0x6c
 #define CD_EDID_OFFSET_EXTENSION_BLOCK_COUNT		0x7e
 
+typedef struct
+{
+	CdColorYxy		 red;
+	CdColorYxy		 green;
+	CdColorYxy		 blue;
+	CdColorYxy		 white;
+	gchar			 eisa_id[CD_EDID_STRING_SIZE];
+	gchar			 monitor_name[CD_EDID_STRING_SIZE];
+	gchar			 serial_number[CD_EDID_STRING_SIZE];
+	gchar			 pnp_id[4];
+	gdouble			 gamma;
+	guint			 height;
+	guint			 width;
+} CdEdidCacheItem;
+
+/* of checksum:CdEdidCacheItem; the same monitor is re-plugged and
+ * DPMS-cycled with identical EDID bytes, so remember the decoded state */
+static GHashTable *cd_edid_cache = NULL;
+G_LOCK_DEFINE_STATIC (cd_edid_cache);
+
+#define CD_EDID_CACHE_MAX_ITEMS				32
+
 #define CD_DESCRIPTOR_DISPLAY_PRODUCT_NAME		0xfc
 #define CD_DESCRIPTOR_DISPLAY_PRODUCT_SERIAL_NUMBER	0xff
 #define CD_DESCRIPTOR_COLOR_MANAGEMENT_DATA		0xf9
@@ -100,7 +128,7 @@ cd_edid_get_monitor_name (CdEdid *edid)
 {
 	CdEdidPrivate *priv = GET_PRIVATE (edid);
 	g_return_val_if_fail (CD_IS_EDID (edid), NULL);
-	return priv->monitor_name;
+	return priv->monitor_name[0] != '\0' ? priv->monitor_name : NULL;
 }
 
 static gchar *
@@ -201,7 +229,7 @@ cd_edid_get_serial_number (CdEdid *edid)
 {
 	CdEdidPrivate *priv = GET_PRIVATE (edid);
 	g_return_val_if_fail (CD_IS_EDID (edid), NULL);
-	return priv->serial_number;
+	return priv->serial_number[0] != '\0' ? priv->serial_number : NULL;
 }
 
 /**
@@ -219,7 +247,7 @@ cd_edid_get_eisa_id (CdEdid *edid)
 {
 	CdEdidPrivate *priv = GET_PRIVATE (edid);
 	g_return_val_if_fail (CD_IS_EDID (edid), NULL);
-	return priv->eisa_id;
+	return priv->eisa_id[0] != '\0' ? priv->eisa_id : NULL;
 }
 
 /**
@@ -237,7 +265,7 @@ cd_edid_get_checksum (CdEdid *edid)
 {
 	CdEdidPrivate *priv = GET_PRIVATE (edid);
 	g_return_val_if_fail (CD_IS_EDID (edid), NULL);
-	return priv->checksum;
+	return priv->checksum[0] != '\0' ? priv->checksum : NULL;
 }
 
 /**
@@ -327,7 +355,7 @@ cd_edid_get_red (CdEdid *edid)
 {
 	CdEdidPrivate *priv = GET_PRIVATE (edid);
 	g_return_val_if_fail (CD_IS_EDID (edid), NULL);
-	return priv->red;
+	return &priv->red;
 }
 
 /**
@@ -345,7 +373,7 @@ cd_edid_get_green (CdEdid *edid)
 {
 	CdEdidPrivate *priv = GET_PRIVATE (edid);
 	g_return_val_if_fail (CD_IS_EDID (edid), NULL);
-	return priv->green;
+	return &priv->green;
 }
 
 /**
@@ -363,7 +391,7 @@ cd_edid_get_blue (CdEdid *edid)
 {
 	CdEdidPrivate *priv = GET_PRIVATE (edid);
 	g_return_val_if_fail (CD_IS_EDID (edid), NULL);
-	return priv->blue;
+	return &priv->blue;
 }
 
 /**
@@ -381,7 +409,7 @@ cd_edid_get_white (CdEdid *edid)
 {
 	CdEdidPrivate *priv = GET_PRIVATE (edid);
 	g_return_val_if_fail (CD_IS_EDID (edid), NULL);
-	return priv->white;
+	return &priv->white;
 }
 
 /**
@@ -399,27 +427,92 @@ cd_edid_reset (CdEdid *edid)
 
 	g_return_if_fail (CD_IS_EDID (edid));
 
-	/* free old data */
-	g_free (priv->monitor_name);
-	g_free (priv->vendor_name);
-	g_free (priv->serial_number);
-	g_free (priv->eisa_id);
-	g_free (priv->checksum);
+	/* the vendor name is looked up lazily from the hwdb */
+	g_clear_pointer (&priv->vendor_name, g_free);
 
 	/* do not deallocate, just blank */
+	priv->monitor_name[0] = '\0';
+	priv->serial_number[0] = '\0';
+	priv->eisa_id[0] = '\0';
+	priv->checksum[0] = '\0';
 	priv->pnp_id[0] = '\0';
 
 	/* set to default values */
-	priv->monitor_name = NULL;
-	priv->vendor_name = NULL;
-	priv->serial_number = NULL;
-	priv->eisa_id = NULL;
-	priv->checksum = NULL;
 	priv->width = 0;
 	priv->height = 0;
 	priv->gamma = 0.0f;
 }
 
+static void
+cd_edid_cache_item_free (CdEdidCacheItem *item)
+{
+	g_slice_free (CdEdidCacheItem, item);
+}
+
+/* cd_edid_cache lock held by caller */
+static gboolean
+cd_edid_cache_restore (CdEdid *edid, const gchar *checksum)
+{
+	CdEdidCacheItem *item;
+	CdEdidPrivate *priv = GET_PRIVATE (edid);
+
+	if (cd_edid_cache == NULL)
+		return FALSE;
+	item = g_hash_table_lookup (cd_edid_cache, checksum);
+	if (item == NULL)
+		return FALSE;
+	cd_edid_reset (edid);
+	cd_color_yxy_copy (&item->red, &priv->red);
+	cd_color_yxy_copy (&item->green, &priv->green);
+	cd_color_yxy_copy (&item->blue, &priv->blue);
+	cd_color_yxy_copy (&item->white, &priv->white);
+	memcpy (priv->eisa_id, item->eisa_id, sizeof (priv->eisa_id));
+	memcpy (priv->monitor_name, item->monitor_name, sizeof (priv->monitor_name));
+	memcpy (priv->serial_number, item->serial_number, sizeof (priv->serial_number));
+	memcpy (priv->pnp_id, item->pnp_id, 4);
+	priv->gamma = item->gamma;
+	priv->height = item->height;
+	priv->width = item->width;
+	g_strlcpy (priv->checksum, checksum, sizeof (priv->checksum));
+	return TRUE;
+}
+
+/* cd_edid_cache lock held by caller */
+static void
+cd_edid_cache_save (CdEdid *edid)
+{
+	CdEdidCacheItem *item;
+	CdEdidPrivate *priv = GET_PRIVATE (edid);
+
+	if (cd_edid_cache == NULL) {
+		cd_edid_cache = g_hash_table_new_full (g_str_hash,
+						       g_str_equal,
+						       g_free,
+						       (GDestroyNotify) cd_edid_cache_item_free);
+	}
+
+	/* keep the cache small; throwing everything away is cheaper than
+	 * tracking per-entry age */
+	if (g_hash_table_size (cd_edid_cache) >= CD_EDID_CACHE_MAX_ITEMS)
+		g_hash_table_remove_all (cd_edid_cache);
+
+	item = g_slice_new0 (CdEdidCacheItem);
+	cd_color_yxy_copy (&priv->red, &item->red);
+	cd_color_yxy_copy (&priv->green, &item->green);
+	cd_color_yxy_copy (&priv->blue, &item->blue);
+	cd_color_yxy_copy (&priv->white, &item->white);
+	memcpy (item->eisa_id, priv->eisa_id, sizeof (item->eisa_id));
+	memcpy (item->monitor_name, priv->monitor_name, sizeof (item->monitor_name));
+	memcpy (item->serial_number, priv->serial_number, sizeof (item->serial_number));
+	memcpy (item->pnp_id, priv->pnp_id, 4);
+	item->gamma = priv->gamma;
+	item->height = priv->height;
+	item->width = priv->width;
+	g_hash_table_insert (cd_edid_cache,
+			     g_strdup (priv->checksum),
+			     item);
+}
+
 static gint
 cd_edid_get_bit (gint in, gint bit)
 {
@@ -446,16 +539,16 @@ cd_edid_decode_fraction (gint high, gint low)
 	return result;
 }
 
-static gchar *
-cd_edid_parse_string (const guint8 *data)
+static gboolean
+cd_edid_parse_string (const guint8 *data, gchar text[CD_EDID_STRING_SIZE])
 {
-	gchar *text;
 	guint i;
 	guint replaced = 0;
 
 	/* this is always 13 bytes, but we can't guarantee it's null
 	 * terminated or not junk. */
-	text = g_strndup ((const gchar *) data, 13);
+	memcpy (text, data, CD_EDID_STRING_SIZE - 1);
+	text[CD_EDID_STRING_SIZE - 1] = '\0';
 
 	/* remove insane newline chars */
 	g_strdelimit (text, "\n\r", '\0');
@@ -464,10 +557,8 @@ cd_edid_parse_string (const guint8 *data)
 	g_strchomp (text);
 
 	/* nothing left? */
-	if (text[0] == '\0') {
-		g_free (text);
-		return NULL;
-	}
+	if (text[0] == '\0')
+		return FALSE;
 
 	/* ensure string is printable */
 	for (i = 0; text[i] != '\0'; i++) {
@@ -478,17 +569,13 @@ cd_edid_parse_string (const guint8 *data)
 	}
 
 	/* not valid UTF-8 */
-	if (!g_utf8_validate (text, -1, NULL)) {
-		g_free (text);
-		return NULL;
-	}
+	if (!g_utf8_validate (text, -1, NULL))
+		return FALSE;
 
 	/* if the string is junk, ignore the string */
-	if (replaced > 4) {
-		g_free (text);
-		return NULL;
-	}
-	return text;
+	if (replaced > 4)
+		return FALSE;
+	return TRUE;
 }
 
 /**
@@ -508,10 +595,13 @@ cd_edid_parse (CdEdid *edid, GBytes *edid_data, GError **error)
 {
 	CdEdidPrivate *priv = GET_PRIVATE (edid);
 	const guint8 *data;
-	gchar *tmp;
+	gboolean ret;
+	gchar checksum[CD_EDID_CHECKSUM_SIZE];
+	gchar text[CD_EDID_STRING_SIZE];
 	gsize length;
 	guint32 serial;
 	guint i;
+	static GChecksum *checksum_ctx = NULL;
 
 	/* check header */
 	data = g_bytes_get_data (edid_data, &length);
@@ -530,6 +620,22 @@ cd_edid_parse (CdEdid *edid, GBytes *edid_data, GError **error)
 		return FALSE;
 	}
 
+	/* seen these exact bytes before? re-plugging the same monitor is
+	 * then just a hash lookup rather than a full re-decode; the one
+	 * checksum context is reset per parse rather than allocated */
+	G_LOCK (cd_edid_cache);
+	if (checksum_ctx == NULL)
+		checksum_ctx = g_checksum_new (G_CHECKSUM_MD5);
+	else
+		g_checksum_reset (checksum_ctx);
+	g_checksum_update (checksum_ctx, data, length);
+	g_strlcpy (checksum, g_checksum_get_string (checksum_ctx),
+		   sizeof (checksum));
+	ret = cd_edid_cache_restore (edid, checksum);
+	G_UNLOCK (cd_edid_cache);
+	if (ret)
+		return TRUE;
+
 	/* free old data */
 	cd_edid_reset (edid);
 
@@ -547,8 +653,11 @@ cd_edid_parse (CdEdid *edid, GBytes *edid_data, GError **error)
 	serial += (guint32) data[CD_EDID_OFFSET_SERIAL+1] * 0x100;
 	serial += (guint32) data[CD_EDID_OFFSET_SERIAL+2] * 0x10000;
 	serial += (guint32) data[CD_EDID_OFFSET_SERIAL+3] * 0x1000000;
-	if (serial > 0)
-		priv->serial_number = g_strdup_printf ("%" G_GUINT32_FORMAT, serial);
+	if (serial > 0) {
+		g_snprintf (priv->serial_number,
+			    sizeof (priv->serial_number),
+			    "%" G_GUINT32_FORMAT, serial);
+	}
 
 	/* get the size */
 	priv->width = data[CD_EDID_OFFSET_SIZE+0];
@@ -568,20 +677,20 @@ cd_edid_parse (CdEdid *edid, GBytes *edid_data, GError **error)
 	}
 
 	/* get color red */
-	priv->red->x = cd_edid_decode_fraction (data[0x1b], cd_edid_get_bits (data[0x19], 6, 7));
-	priv->red->y = cd_edid_decode_fraction (data[0x1c], cd_edid_get_bits (data[0x19], 4, 5));
+	priv->red.x = cd_edid_decode_fraction (data[0x1b], cd_edid_get_bits (data[0x19], 6, 7));
+	priv->red.y = cd_edid_decode_fraction (data[0x1c], cd_edid_get_bits (data[0x19], 4, 5));
 
 	/* get color green */
-	priv->green->x = cd_edid_decode_fraction (data[0x1d], cd_edid_get_bits (data[0x19], 2, 3));
-	priv->green->y = cd_edid_decode_fraction (data[0x1e], cd_edid_get_bits (data[0x19], 0, 1));
+	priv->green.x = cd_edid_decode_fraction (data[0x1d], cd_edid_get_bits (data[0x19], 2, 3));
+	priv->green.y = cd_edid_decode_fraction (data[0x1e], cd_edid_get_bits (data[0x19], 0, 1));
 
 	/* get color blue */
-	priv->blue->x = cd_edid_decode_fraction (data[0x1f], cd_edid_get_bits (data[0x1a], 6, 7));
-	priv->blue->y = cd_edid_decode_fraction (data[0x20], cd_edid_get_bits (data[0x1a], 4, 5));
+	priv->blue.x = cd_edid_decode_fraction (data[0x1f], cd_edid_get_bits (data[0x1a], 6, 7));
+	priv->blue.y = cd_edid_decode_fraction (data[0x20], cd_edid_get_bits (data[0x1a], 4, 5));
 
 	/* get color white */
-	priv->white->x = cd_edid_decode_fraction (data[0x21], cd_edid_get_bits (data[0x1a], 2, 3));
-	priv->white->y = cd_edid_decode_fraction (data[0x22], cd_edid_get_bits (data[0x1a], 0, 1));
+	priv->white.x = cd_edid_decode_fraction (data[0x21], cd_edid_get_bits (data[0x1a], 2, 3));
+	priv->white.y = cd_edid_decode_fraction (data[0x22], cd_edid_get_bits (data[0x1a], 0, 1));
 
 	/* parse EDID data */
 	for (i = CD_EDID_OFFSET_DATA_BLOCKS;
@@ -595,25 +704,16 @@ cd_edid_parse (CdEdid *edid, GBytes *edid_data, GError **error)
 
 		/* any useful blocks? */
 		if (data[i+3] == CD_DESCRIPTOR_DISPLAY_PRODUCT_NAME) {
-			tmp = cd_edid_parse_string (&data[i+5]);
-			if (tmp != NULL) {
-				g_free (priv->monitor_name);
-				priv->monitor_name = tmp;
-			}
+			if (cd_edid_parse_string (&data[i+5], text))
+				memcpy (priv->monitor_name, text, sizeof (text));
 		} else if (data[i+3] == CD_DESCRIPTOR_DISPLAY_PRODUCT_SERIAL_NUMBER) {
-			tmp = cd_edid_parse_string (&data[i+5]);
-			if (tmp != NULL) {
-				g_free (priv->serial_number);
-				priv->serial_number = tmp;
-			}
+			if (cd_edid_parse_string (&data[i+5], text))
+				memcpy (priv->serial_number, text, sizeof (text));
 		} else if (data[i+3] == CD_DESCRIPTOR_COLOR_MANAGEMENT_DATA) {
 			g_warning ("failing to parse color management data");
 		} else if (data[i+3] == CD_DESCRIPTOR_ALPHANUMERIC_DATA_STRING) {
-			tmp = cd_edid_parse_string (&data[i+5]);
-			if (tmp != NULL) {
-				g_free (priv->eisa_id);
-				priv->eisa_id = tmp;
-			}
+			if (cd_edid_parse_string (&data[i+5], text))
+				memcpy (priv->eisa_id, text, sizeof (text));
 		} else if (data[i+3] == CD_DESCRIPTOR_COLOR_POINT) {
 			if (data[i+3+9] != 0xff) {
 				/* extended EDID block(1) which contains
@@ -628,8 +728,13 @@ cd_edid_parse (CdEdid *edid, GBytes *edid_data, GError **error)
 		}
 	}
 
-	/* calculate checksum */
-	priv->checksum = g_compute_checksum_for_data (G_CHECKSUM_MD5, data, length);
+	/* save checksum */
+	g_strlcpy (priv->checksum, checksum, sizeof (priv->checksum));
+
+	/* remember the decoded state for the next identical blob */
+	G_LOCK (cd_edid_cache);
+	cd_edid_cache_save (edid);
+	G_UNLOCK (cd_edid_cache);
 	return TRUE;
 }
 
@@ -643,12 +748,8 @@ cd_edid_class_init (CdEdidClass *klass)
 static void
 cd_edid_init (CdEdid *edid)
 {
-	CdEdidPrivate *priv = GET_PRIVATE (edid);
-	priv->pnp_id = g_new0 (gchar, 4);
-	priv->red = cd_color_yxy_new ();
-	priv->green = cd_color_yxy_new ();
-	priv->blue = cd_color_yxy_new ();
-	priv->white = cd_color_yxy_new ();
+	/* everything lives inline in the private struct, which GObject
+	 * has already zeroed */
 }
 
 static void
@@ -657,16 +758,7 @@ cd_edid_finalize (GObject *object)
 	CdEdid *edid = CD_EDID (object);
 	CdEdidPrivate *priv = GET_PRIVATE (edid);
 
-	g_free (priv->monitor_name);
 	g_free (priv->vendor_name);
-	g_free (priv->serial_number);
-	g_free (priv->eisa_id);
-	g_free (priv->checksum);
-	g_free (priv->pnp_id);
-	cd_color_yxy_free (priv->white);
-	cd_color_yxy_free (priv->red);
-	cd_color_yxy_free (priv->green);
-	cd_color_yxy_free (priv->blue);
 
 	G_OBJECT_CLASS (cd_edid_parent_class)->finalize (object);
 }
@@ -112,6 +112,8 @@ typedef guint32 CdPixelFormat;
 #define	CD_PIXEL_FORMAT_CMYK32		0x00060021	/* Since: 1.0.0 */
 #define	CD_PIXEL_FORMAT_BGRA32		0x00044499	/* Since: 1.0.0 */
 #define	CD_PIXEL_FORMAT_RGBA32		0x00040099	/* Since: 1.1.8 */
+#define	CD_PIXEL_FORMAT_RGBA64		0x0004009a	/* Since: 1.4.6 */
+#define	CD_PIXEL_FORMAT_RGBA_F16	0x0044009a	/* Since: 1.4.6 */
 
 /**
  * CdColorspace:
@@ -512,6 +514,7 @@ typedef enum {
 #define CD_DEVICE_PROPERTY_PROFILING_INHIBITORS	"ProfilingInhibitors"	/* Since: 0.1.18 */
 #define CD_DEVICE_PROPERTY_ENABLED		"Enabled"		/* Since: 0.1.26 */
 #define CD_DEVICE_PROPERTY_EMBEDDED		"Embedded"		/* Since: 0.1.27 */
+#define CD_DEVICE_PROPERTY_GENERATION		"Generation"		/* Since: 1.4.6 */
 
 /* defined in org.freedesktop.ColorManager.Sensor.xml */
 #define CD_SENSOR_PROPERTY_ID			"SensorId"		/* Since: 0.1.26 */
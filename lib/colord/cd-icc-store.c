@@ -28,7 +28,24 @@
 
 #include <glib-object.h>
 #include <gio/gio.h>
-
+#include <glib/gstdio.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef HAVE_FANOTIFY
+#include <errno.h>
+#include <limits.h>
+#include <glib-unix.h>
+#include <sys/fanotify.h>
+#include <sys/vfs.h>
+#ifndef FAN_REPORT_DFID_NAME
+/* the headers are too old to report directory entry names */
+#undef HAVE_FANOTIFY
+#endif
+#endif
+
+#include "cd-buffer.h"
 #include "cd-icc-store.h"
 
 static void	cd_icc_store_finalize	(GObject	*object);
@@ -40,7 +57,19 @@ typedef struct
 	CdIccLoadFlags		 load_flags;
 	GPtrArray		*directory_array;
 	GPtrArray		*icc_array;
+	GHashTable		*icc_by_checksum;	/* borrowed CdIcc */
+	GHashTable		*icc_by_filename;	/* borrowed CdIcc */
+	GHashTable		*icc_by_inode;		/* borrowed CdIcc */
 	GResource		*cache;
+	gchar			*index_location;
+	GHashTable		*monitor_changes;
+	guint			 monitor_changes_id;
+#ifdef HAVE_FANOTIFY
+	gint			 fanotify_fd;	/* -1 untried, -2 unavailable */
+	guint			 fanotify_id;
+	GPtrArray		*fanotify_marks;
+	GPtrArray		*fanotify_roots;	/* watched subtree roots */
+#endif
 } CdIccStorePrivate;
 
 enum {
@@ -54,6 +83,7 @@ static guint signals[SIGNAL_LAST] = { 0 };
 G_DEFINE_TYPE_WITH_PRIVATE (CdIccStore, cd_icc_store, G_TYPE_OBJECT)
 
 #define CD_ICC_STORE_MAX_RECURSION_LEVELS	  2
+#define CD_ICC_STORE_MONITOR_DEBOUNCE_MS	200
 
 static gboolean
 cd_icc_store_search_path (CdIccStore *store,
@@ -61,19 +91,25 @@ cd_icc_store_search_path (CdIccStore *store,
 			  guint depth,
 			  GCancellable *cancellable,
 			  GError **error);
-static gboolean
-cd_icc_store_search_path_child (CdIccStore *store,
-				const gchar *path,
-				GFileInfo *info,
-				guint depth,
-				GCancellable *cancellable,
-				GError **error);
 
 typedef struct {
 	gchar		*path;
 	GFileMonitor	*monitor;
 } CdIccStoreDirHelper;
 
+typedef struct {
+	gchar		*path;
+	gchar		*inode_key;
+} CdIccStoreCandidate;
+
+static void
+cd_icc_store_candidate_free (CdIccStoreCandidate *candidate)
+{
+	g_free (candidate->path);
+	g_free (candidate->inode_key);
+	g_free (candidate);
+}
+
 static void
 cd_icc_store_helper_free (CdIccStoreDirHelper *helper)
 {
@@ -99,18 +135,14 @@ cd_icc_store_find_by_filename (CdIccStore *store, const gchar *filename)
 {
 	CdIccStorePrivate *priv = GET_PRIVATE (store);
 	CdIcc *tmp;
-	guint i;
-	GPtrArray *array = priv->icc_array;
 
 	g_return_val_if_fail (CD_IS_ICC_STORE (store), NULL);
 	g_return_val_if_fail (filename != NULL, NULL);
 
-	for (i = 0; i < array->len; i++) {
-		tmp = g_ptr_array_index (array, i);
-		if (g_strcmp0 (filename, cd_icc_get_filename (tmp)) == 0)
-			return g_object_ref (tmp);
-	}
-	return NULL;
+	tmp = g_hash_table_lookup (priv->icc_by_filename, filename);
+	if (tmp == NULL)
+		return NULL;
+	return g_object_ref (tmp);
 }
 
 /**
@@ -129,18 +161,14 @@ cd_icc_store_find_by_checksum (CdIccStore *store, const gchar *checksum)
 {
 	CdIccStorePrivate *priv = GET_PRIVATE (store);
 	CdIcc *tmp;
-	guint i;
-	GPtrArray *array = priv->icc_array;
 
 	g_return_val_if_fail (CD_IS_ICC_STORE (store), NULL);
 	g_return_val_if_fail (checksum != NULL, NULL);
 
-	for (i = 0; i < array->len; i++) {
-		tmp = g_ptr_array_index (array, i);
-		if (g_strcmp0 (checksum, cd_icc_get_checksum (tmp)) == 0)
-			return g_object_ref (tmp);
-	}
-	return NULL;
+	tmp = g_hash_table_lookup (priv->icc_by_checksum, checksum);
+	if (tmp == NULL)
+		return NULL;
+	return g_object_ref (tmp);
 }
 
 static CdIccStoreDirHelper *
@@ -163,6 +191,8 @@ static gboolean
 cd_icc_store_remove_icc (CdIccStore *store, const gchar *filename)
 {
 	CdIccStorePrivate *priv = GET_PRIVATE (store);
+	GHashTableIter iter;
+	gpointer value;
 	g_autoptr(CdIcc) icc = NULL;
 
 	/* find exact pointer */
@@ -176,39 +206,215 @@ cd_icc_store_remove_icc (CdIccStore *store, const gchar *filename)
 		return FALSE;
 	}
 
+	/* drop from the indexes, including any alias filenames and inode
+	 * entries pointing at the same profile */
+	g_hash_table_remove (priv->icc_by_filename, filename);
+	g_hash_table_iter_init (&iter, priv->icc_by_filename);
+	while (g_hash_table_iter_next (&iter, NULL, &value)) {
+		if (value == (gpointer) icc)
+			g_hash_table_iter_remove (&iter);
+	}
+	g_hash_table_iter_init (&iter, priv->icc_by_inode);
+	while (g_hash_table_iter_next (&iter, NULL, &value)) {
+		if (value == (gpointer) icc)
+			g_hash_table_iter_remove (&iter);
+	}
+	if (cd_icc_get_checksum (icc) != NULL)
+		g_hash_table_remove (priv->icc_by_checksum,
+				     cd_icc_get_checksum (icc));
+
 	/* emit a signal */
 	g_signal_emit (store, signals[SIGNAL_REMOVED], 0, icc);
 	return TRUE;
 }
 
+/* adds the profile to the array and both indexes and emits ::added,
+ * or returns FALSE if it duplicates an existing checksum */
 static gboolean
-cd_icc_store_add_icc (CdIccStore *store, GFile *file, GError **error)
+cd_icc_store_register_icc (CdIccStore *store, CdIcc *icc)
+{
+	CdIccStorePrivate *priv = GET_PRIVATE (store);
+	const gchar *checksum = cd_icc_get_checksum (icc);
+	const gchar *filename = cd_icc_get_filename (icc);
+	CdIcc *icc_tmp = NULL;
+
+	/* check it's not a duplicate */
+	if (checksum != NULL)
+		icc_tmp = g_hash_table_lookup (priv->icc_by_checksum, checksum);
+	if (icc_tmp != NULL) {
+		g_debug ("CdIccStore: Failed to add %s as profile %s "
+			 "already exists with the same checksum of %s",
+			 filename,
+			 cd_icc_get_filename (icc_tmp),
+			 checksum);
+		return FALSE;
+	}
+
+	/* add to list and indexes */
+	g_ptr_array_add (priv->icc_array, g_object_ref (icc));
+	if (checksum != NULL) {
+		g_hash_table_insert (priv->icc_by_checksum,
+				     g_strdup (checksum), icc);
+	}
+	if (filename != NULL) {
+		g_hash_table_insert (priv->icc_by_filename,
+				     g_strdup (filename), icc);
+	}
+
+	/* emit a signal */
+	g_signal_emit (store, signals[SIGNAL_ADDED], 0, icc);
+	return TRUE;
+}
+
+/* the index blob is keyed on the hash of the profile path so entries
+ * from different search locations cannot collide */
+static GFile *
+cd_icc_store_get_index_file (CdIccStore *store, const gchar *filename)
 {
 	CdIccStorePrivate *priv = GET_PRIVATE (store);
+	g_autofree gchar *basename = NULL;
+	g_autofree gchar *path = NULL;
+
+	basename = g_strdup_printf ("%016" G_GINT64_MODIFIER "x.bin",
+				    cd_buffer_hash ((const guint8 *) filename,
+						    strlen (filename), 0));
+	path = g_build_filename (priv->index_location, basename, NULL);
+	return g_file_new_for_path (path);
+}
+
+/* best effort; a failure to write the index only costs a re-parse */
+static void
+cd_icc_store_index_save (CdIccStore *store, CdIcc *icc, GFile *index_file)
+{
+	CdIccStorePrivate *priv = GET_PRIVATE (store);
+	g_autoptr(GError) error = NULL;
+
+	if (g_mkdir_with_parents (priv->index_location, 0755) != 0)
+		return;
+	if (!cd_icc_save_cache (icc, index_file, &error)) {
+		g_debug ("failed to save index for %s: %s",
+			 cd_icc_get_filename (icc), error->message);
+	}
+}
+
+/* tries a pre-parsed summary record compiled into the GResource, and
+ * falls back to handing out the raw profile bytes when only those are
+ * present; returns %TRUE if @icc was hydrated from a record */
+static gboolean
+cd_icc_store_resource_lookup (CdIccStore *store,
+			      CdIcc *icc,
+			      const gchar *filename,
+			      GBytes **data)
+{
+	CdIccStorePrivate *priv = GET_PRIVATE (store);
+	g_autofree gchar *cache_key = NULL;
+	g_autofree gchar *record_key = NULL;
+	g_autoptr(GBytes) record = NULL;
+
+	if (priv->cache == NULL)
+		return FALSE;
+	if (!g_str_has_prefix (filename, "/usr/share/color/icc/colord/"))
+		return FALSE;
+	cache_key = g_build_filename ("/org/freedesktop/colord",
+				      "profiles",
+				      filename + 28,
+				      NULL);
+
+	/* a summary record avoids the lcms2 parse entirely */
+	record_key = g_strdup_printf ("%s.cache", cache_key);
+	record = g_resource_lookup_data (priv->cache,
+					 record_key,
+					 G_RESOURCE_LOOKUP_FLAGS_NONE,
+					 NULL);
+	if (record != NULL &&
+	    cd_icc_load_cache_bytes (icc, record, NULL))
+		return TRUE;
+
+	*data = g_resource_lookup_data (priv->cache,
+					cache_key,
+					G_RESOURCE_LOOKUP_FLAGS_NONE,
+					NULL);
+	return FALSE;
+}
+
+/* builds a "device:inode" key so files aliased by symlinks, hardlinks
+ * or bind mounts can be recognised without parsing them again */
+static gchar *
+cd_icc_store_get_inode_key (GFile *file)
+{
+	guint32 dev;
+	guint64 ino;
+	g_autoptr(GFileInfo) info = NULL;
+
+	info = g_file_query_info (file,
+				  G_FILE_ATTRIBUTE_UNIX_DEVICE ","
+				  G_FILE_ATTRIBUTE_UNIX_INODE,
+				  G_FILE_QUERY_INFO_NONE,
+				  NULL, NULL);
+	if (info == NULL)
+		return NULL;
+	if (!g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_UNIX_INODE))
+		return NULL;
+	dev = g_file_info_get_attribute_uint32 (info, G_FILE_ATTRIBUTE_UNIX_DEVICE);
+	ino = g_file_info_get_attribute_uint64 (info, G_FILE_ATTRIBUTE_UNIX_INODE);
+	return g_strdup_printf ("%" G_GUINT32_FORMAT ":%" G_GUINT64_FORMAT,
+				dev, ino);
+}
+
+static gboolean
+cd_icc_store_add_icc (CdIccStore *store,
+		      GFile *file,
+		      const gchar *inode_key,
+		      GError **error)
+{
+	CdIccStorePrivate *priv = GET_PRIVATE (store);
+	CdIcc *icc_alias;
+	gboolean hydrated = FALSE;
 	g_autoptr(GBytes) data = NULL;
 	g_autofree gchar *filename = NULL;
+	g_autofree gchar *inode_key_tmp = NULL;
 	g_autoptr(CdIcc) icc = NULL;
-	g_autoptr(CdIcc) icc_tmp = NULL;
+	g_autoptr(GFile) index_file = NULL;
 
-	/* use the GResource cache if available */
-	icc = cd_icc_new ();
+	/* the same file seen through another path is not parsed again,
+	 * just recorded as an alternate filename */
 	filename = g_file_get_path (file);
-	if (priv->cache != NULL) {
-		if (g_str_has_prefix (filename, "/usr/share/color/icc/colord/")) {
-			g_autofree gchar *cache_key = NULL;
-			cache_key = g_build_filename ("/org/freedesktop/colord",
-						      "profiles",
-						      filename + 28,
-						      NULL);
-			data = g_resource_lookup_data (priv->cache,
-						       cache_key,
-						       G_RESOURCE_LOOKUP_FLAGS_NONE,
-						       NULL);
+	if (inode_key == NULL) {
+		inode_key_tmp = cd_icc_store_get_inode_key (file);
+		inode_key = inode_key_tmp;
+	}
+	if (inode_key != NULL) {
+		icc_alias = g_hash_table_lookup (priv->icc_by_inode, inode_key);
+		if (icc_alias != NULL) {
+			g_debug ("CdIccStore: %s is the same file as %s",
+				 filename, cd_icc_get_filename (icc_alias));
+			g_hash_table_insert (priv->icc_by_filename,
+					     g_strdup (filename), icc_alias);
+			return TRUE;
 		}
 	}
 
+	/* serve unchanged profiles from the persistent index */
+	icc = cd_icc_new ();
+	if (priv->index_location != NULL) {
+		g_autoptr(GError) error_index = NULL;
+		index_file = cd_icc_store_get_index_file (store, filename);
+		hydrated = cd_icc_load_cache (icc, index_file, &error_index);
+		if (!hydrated) {
+			g_debug ("no index hit for %s: %s",
+				 filename, error_index->message);
+		}
+	}
+
+	/* use the GResource cache if available */
+	if (!hydrated)
+		hydrated = cd_icc_store_resource_lookup (store, icc,
+							 filename, &data);
+
 	/* parse new icc object */
-	if (data != NULL) {
+	if (hydrated) {
+		g_debug ("Using pre-parsed data for %s", filename);
+	} else if (data != NULL) {
 		g_autofree gchar *basename = NULL;
 		basename = g_path_get_basename (filename);
 		g_debug ("Using built-in %s", basename);
@@ -228,51 +434,20 @@ cd_icc_store_add_icc (CdIccStore *store, GFile *file, GError **error)
 					error)) {
 			return FALSE;
 		}
-	}
 
-	/* check it's not a duplicate */
-	icc_tmp = cd_icc_store_find_by_checksum (store, cd_icc_get_checksum (icc));
-	if (icc_tmp != NULL) {
-		g_debug ("CdIccStore: Failed to add %s as profile %s "
-			 "already exists with the same checksum of %s",
-			 filename,
-			 cd_icc_get_filename (icc_tmp),
-			 cd_icc_get_checksum (icc_tmp));
-		return TRUE;
+		/* save for the next start */
+		if (index_file != NULL)
+			cd_icc_store_index_save (store, icc, index_file);
 	}
 
-	/* add to list */
-	g_ptr_array_add (priv->icc_array, g_object_ref (icc));
-
-	/* emit a signal */
-	g_signal_emit (store, signals[SIGNAL_ADDED], 0, icc);
+	/* add unless it's a duplicate */
+	if (cd_icc_store_register_icc (store, icc) && inode_key != NULL) {
+		g_hash_table_insert (priv->icc_by_inode,
+				     g_strdup (inode_key), icc);
+	}
 	return TRUE;
 }
 
-static void
-cd_icc_store_created_query_info_cb (GObject *source_object,
-				    GAsyncResult *res,
-				    gpointer user_data)
-{
-	CdIccStore *store = CD_ICC_STORE (user_data);
-	GFile *file = G_FILE (source_object);
-	gboolean ret;
-	g_autoptr(GError) error = NULL;
-	g_autofree gchar *path = NULL;
-	g_autoptr(GFileInfo) info = NULL;
-	g_autoptr(GFile) parent = NULL;
-
-	info = g_file_query_info_finish (file, res, NULL);
-	if (info == NULL)
-		return;
-	parent = g_file_get_parent (file);
-	path = g_file_get_path (parent);
-	ret = cd_icc_store_search_path_child (store, path, info,
-					      0, NULL, &error);
-	if (!ret)
-		g_warning ("failed to search file: %s", error->message);
-}
-
 static void
 cd_icc_store_remove_from_prefix (CdIccStore *store, const gchar *prefix)
 {
@@ -291,6 +466,180 @@ cd_icc_store_remove_from_prefix (CdIccStore *store, const gchar *prefix)
 	}
 }
 
+typedef struct {
+	GPtrArray	*paths;		/* created paths to inspect */
+	GPtrArray	*dirs;		/* new directories to rescan */
+	GPtrArray	*iccs;		/* loaded profiles */
+} CdIccStoreChangedHelper;
+
+static void
+cd_icc_store_changed_helper_free (CdIccStoreChangedHelper *helper)
+{
+	g_ptr_array_unref (helper->paths);
+	g_ptr_array_unref (helper->dirs);
+	g_ptr_array_unref (helper->iccs);
+	g_free (helper);
+}
+
+/* loads the coalesced set of created files off the main loop */
+static void
+cd_icc_store_monitor_process_thread_cb (GTask *task,
+					gpointer source_object,
+					gpointer task_data,
+					GCancellable *cancellable)
+{
+	CdIccStore *store = CD_ICC_STORE (source_object);
+	CdIccStorePrivate *priv = GET_PRIVATE (store);
+	CdIccStoreChangedHelper *helper = (CdIccStoreChangedHelper *) task_data;
+	guint i;
+
+	for (i = 0; i < helper->paths->len; i++) {
+		const gchar *path = g_ptr_array_index (helper->paths, i);
+		const gchar *type;
+		g_autoptr(CdIcc) icc = NULL;
+		g_autoptr(GFile) file = NULL;
+		g_autoptr(GFileInfo) info = NULL;
+
+		file = g_file_new_for_path (path);
+		info = g_file_query_info (file,
+					  G_FILE_ATTRIBUTE_STANDARD_CONTENT_TYPE ","
+					  G_FILE_ATTRIBUTE_STANDARD_TYPE,
+					  G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
+					  cancellable,
+					  NULL);
+		if (info == NULL)
+			continue;
+
+		/* new directories are rescanned in the main context */
+		if (g_file_info_get_file_type (info) == G_FILE_TYPE_DIRECTORY) {
+			g_ptr_array_add (helper->dirs, g_strdup (path));
+			continue;
+		}
+
+		/* check type */
+		type = g_file_info_get_attribute_string (info, G_FILE_ATTRIBUTE_STANDARD_CONTENT_TYPE);
+		if (g_strcmp0 (type, "application/vnd.iccprofile") != 0) {
+			g_debug ("Incorrect content type for %s, got %s",
+				 path, type);
+			continue;
+		}
+		icc = cd_icc_new ();
+		if (!cd_icc_load_file (icc, file, priv->load_flags,
+				       cancellable, NULL))
+			continue;
+		g_ptr_array_add (helper->iccs, g_object_ref (icc));
+	}
+	g_task_return_boolean (task, TRUE);
+}
+
+/* back in the main context; add the whole group and emit the signals */
+static void
+cd_icc_store_monitor_process_cb (GObject *source_object,
+				 GAsyncResult *res,
+				 gpointer user_data)
+{
+	CdIccStore *store = CD_ICC_STORE (source_object);
+	CdIccStoreChangedHelper *helper = g_task_get_task_data (G_TASK (res));
+	guint i;
+
+	/* add unless they duplicate existing checksums */
+	for (i = 0; i < helper->iccs->len; i++) {
+		CdIcc *icc = g_ptr_array_index (helper->iccs, i);
+		cd_icc_store_register_icc (store, icc);
+	}
+
+	/* watch and scan any new directories */
+	for (i = 0; i < helper->dirs->len; i++) {
+		const gchar *path = g_ptr_array_index (helper->dirs, i);
+		g_autoptr(GError) error = NULL;
+		if (!cd_icc_store_search_path (store, path, 1, NULL, &error))
+			g_warning ("failed to search path: %s", error->message);
+	}
+}
+
+static gboolean
+cd_icc_store_monitor_changes_cb (gpointer user_data)
+{
+	CdIccStore *store = CD_ICC_STORE (user_data);
+	CdIccStorePrivate *priv = GET_PRIVATE (store);
+	CdIccStoreChangedHelper *helper;
+	GHashTableIter iter;
+	gpointer key;
+	gpointer value;
+	g_autoptr(GTask) task = NULL;
+
+	priv->monitor_changes_id = 0;
+
+	/* process the whole coalesced set in one go */
+	helper = g_new0 (CdIccStoreChangedHelper, 1);
+	helper->paths = g_ptr_array_new_with_free_func (g_free);
+	helper->dirs = g_ptr_array_new_with_free_func (g_free);
+	helper->iccs = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
+	g_hash_table_iter_init (&iter, priv->monitor_changes);
+	while (g_hash_table_iter_next (&iter, &key, &value)) {
+		const gchar *path = (const gchar *) key;
+		GFileMonitorEvent event_type = GPOINTER_TO_INT (value);
+
+		/* icc was deleted; we can either have two things here, a
+		 * directory or a file, and the inode does not exist
+		 * anymore so we cannot ask */
+		if (event_type == G_FILE_MONITOR_EVENT_DELETED) {
+			CdIccStoreDirHelper *helper_dir;
+			g_autoptr(CdIcc) icc = NULL;
+
+			icc = cd_icc_store_find_by_filename (store, path);
+			if (icc != NULL) {
+				/* is a file */
+				cd_icc_store_remove_icc (store, path);
+				continue;
+			}
+
+			/* is a directory, urgh. Remove all ICCs there. */
+			cd_icc_store_remove_from_prefix (store, path);
+			helper_dir = cd_icc_store_find_by_directory (store, path);
+			if (helper_dir != NULL) {
+				g_ptr_array_remove (priv->directory_array,
+						    helper_dir);
+			}
+			continue;
+		}
+		if (event_type == G_FILE_MONITOR_EVENT_CREATED)
+			g_ptr_array_add (helper->paths, g_strdup (path));
+	}
+	g_hash_table_remove_all (priv->monitor_changes);
+
+	/* load the created files on a worker thread */
+	if (helper->paths->len == 0) {
+		cd_icc_store_changed_helper_free (helper);
+		return G_SOURCE_REMOVE;
+	}
+	task = g_task_new (store, NULL,
+			   cd_icc_store_monitor_process_cb, NULL);
+	g_task_set_task_data (task, helper,
+			      (GDestroyNotify) cd_icc_store_changed_helper_free);
+	g_task_run_in_thread (task, cd_icc_store_monitor_process_thread_cb);
+	return G_SOURCE_REMOVE;
+}
+
+/* coalesce bursts of events; the last event for a path wins, so a file
+ * created and deleted inside the window costs nothing */
+static void
+cd_icc_store_queue_change (CdIccStore *store,
+			   gchar *path,	/* (transfer full) */
+			   GFileMonitorEvent event_type)
+{
+	CdIccStorePrivate *priv = GET_PRIVATE (store);
+	g_hash_table_insert (priv->monitor_changes,
+			     path,
+			     GINT_TO_POINTER (event_type));
+	if (priv->monitor_changes_id != 0)
+		g_source_remove (priv->monitor_changes_id);
+	priv->monitor_changes_id =
+		g_timeout_add (CD_ICC_STORE_MONITOR_DEBOUNCE_MS,
+			       cd_icc_store_monitor_changes_cb,
+			       store);
+}
+
 static void
 cd_icc_store_file_monitor_changed_cb (GFileMonitor *monitor,
 				      GFile *file,
@@ -298,34 +647,12 @@ cd_icc_store_file_monitor_changed_cb (GFileMonitor *monitor,
 				      GFileMonitorEvent event_type,
 				      CdIccStore *store)
 {
-	CdIccStorePrivate *priv = GET_PRIVATE (store);
-	CdIcc *tmp;
-	CdIccStoreDirHelper *helper;
 	g_autofree gchar *path = NULL;
 
-	/* icc was deleted */
-	if (event_type == G_FILE_MONITOR_EVENT_DELETED) {
-
-		/* we can either have two things here, a directory or a
-		 * file. We can't call g_file_query_info_async() as the
-		 * inode doesn't exist anymore */
-		path = g_file_get_path (file);
-		tmp = cd_icc_store_find_by_filename (store, path);
-		if (tmp != NULL) {
-			/* is a file */
-			cd_icc_store_remove_icc (store, path);
-			return;
-		}
-
-		/* is a directory, urgh. Remove all ICCs there. */
-		cd_icc_store_remove_from_prefix (store, path);
-		helper = cd_icc_store_find_by_directory (store, path);
-		if (helper != NULL) {
-			g_ptr_array_remove (priv->directory_array,
-					    helper);
-		}
+	/* only care about created and deleted objects */
+	if (event_type != G_FILE_MONITOR_EVENT_CREATED &&
+	    event_type != G_FILE_MONITOR_EVENT_DELETED)
 		return;
-	}
 
 	/* ignore temp files */
 	path = g_file_get_path (file);
@@ -334,61 +661,249 @@ cd_icc_store_file_monitor_changed_cb (GFileMonitor *monitor,
 		return;
 	}
 
-	/* only care about created objects */
-	if (event_type == G_FILE_MONITOR_EVENT_CREATED) {
-		g_file_query_info_async (file,
-					 G_FILE_ATTRIBUTE_STANDARD_NAME ","
-					 G_FILE_ATTRIBUTE_STANDARD_CONTENT_TYPE ","
-					 G_FILE_ATTRIBUTE_STANDARD_TYPE,
-					 G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
-					 G_PRIORITY_LOW,
-					 NULL,
-					 cd_icc_store_created_query_info_cb,
-					 store);
+	cd_icc_store_queue_change (store, g_steal_pointer (&path), event_type);
+}
+
+#ifdef HAVE_FANOTIFY
+
+/* one filesystem mark sees the whole mount, so the events need to be
+ * resolved back to paths with open_by_handle_at(); the mount fd anchors
+ * the handle to the right filesystem */
+typedef struct {
+	gint		 mount_fd;
+	__kernel_fsid_t	 fsid;
+} CdIccStoreFanotifyMark;
+
+static void
+cd_icc_store_fanotify_mark_free (CdIccStoreFanotifyMark *mark)
+{
+	close (mark->mount_fd);
+	g_free (mark);
+}
+
+static CdIccStoreFanotifyMark *
+cd_icc_store_fanotify_find_mark (CdIccStore *store, const __kernel_fsid_t *fsid)
+{
+	CdIccStorePrivate *priv = GET_PRIVATE (store);
+	guint i;
+
+	for (i = 0; i < priv->fanotify_marks->len; i++) {
+		CdIccStoreFanotifyMark *mark = g_ptr_array_index (priv->fanotify_marks, i);
+		if (memcmp (&mark->fsid, fsid, sizeof (mark->fsid)) == 0)
+			return mark;
+	}
+	return NULL;
+}
+
+/* the mark covers the whole mount; only events inside one of the trees
+ * we were asked to watch are interesting */
+static gboolean
+cd_icc_store_fanotify_path_wanted (CdIccStore *store, const gchar *path)
+{
+	CdIccStorePrivate *priv = GET_PRIVATE (store);
+	guint i;
+
+	for (i = 0; i < priv->fanotify_roots->len; i++) {
+		const gchar *root = g_ptr_array_index (priv->fanotify_roots, i);
+		gsize root_len = strlen (root);
+		if (strncmp (path, root, root_len) != 0)
+			continue;
+		if (path[root_len] == '\0' || path[root_len] == '/')
+			return TRUE;
+	}
+	return FALSE;
+}
+
+static void
+cd_icc_store_fanotify_process_event (CdIccStore *store,
+				     const struct fanotify_event_metadata *metadata)
+{
+	CdIccStoreFanotifyMark *mark;
+	GFileMonitorEvent event_type;
+	const struct fanotify_event_info_fid *fid;
+	const struct file_handle *handle;
+	const gchar *name;
+	gchar dirpath[PATH_MAX];
+	gint dirfd;
+	gssize dirpath_len;
+	g_autofree gchar *path = NULL;
+	g_autofree gchar *proc_path = NULL;
+
+	if (metadata->vers != FANOTIFY_METADATA_VERSION)
+		return;
+	if (metadata->event_len <= metadata->metadata_len)
 		return;
+	fid = (const struct fanotify_event_info_fid *) (metadata + 1);
+	if (fid->hdr.info_type != FAN_EVENT_INFO_TYPE_DFID_NAME)
+		return;
+	handle = (const struct file_handle *) fid->handle;
+	name = (const gchar *) handle->f_handle + handle->handle_bytes;
+
+	/* ignore temp files */
+	if (g_strrstr (name, ".goutputstream") != NULL) {
+		g_debug ("ignoring gvfs temporary file");
+		return;
+	}
+
+	/* resolve the parent directory of the entry; ESTALE just means
+	 * the directory itself has already gone away */
+	mark = cd_icc_store_fanotify_find_mark (store, &fid->fsid);
+	if (mark == NULL)
+		return;
+	dirfd = open_by_handle_at (mark->mount_fd,
+				   (struct file_handle *) handle,
+				   O_PATH | O_CLOEXEC);
+	if (dirfd < 0)
+		return;
+	proc_path = g_strdup_printf ("/proc/self/fd/%i", dirfd);
+	dirpath_len = readlink (proc_path, dirpath, sizeof (dirpath) - 1);
+	close (dirfd);
+	if (dirpath_len < 0)
+		return;
+	dirpath[dirpath_len] = '\0';
+	if (!cd_icc_store_fanotify_path_wanted (store, dirpath))
+		return;
+
+	/* feed the shared debounce machinery exactly like a GFileMonitor */
+	if ((metadata->mask & (FAN_CREATE | FAN_MOVED_TO)) != 0)
+		event_type = G_FILE_MONITOR_EVENT_CREATED;
+	else if ((metadata->mask & (FAN_DELETE | FAN_MOVED_FROM)) != 0)
+		event_type = G_FILE_MONITOR_EVENT_DELETED;
+	else
+		return;
+	path = g_build_filename (dirpath, name, NULL);
+	cd_icc_store_queue_change (store, g_steal_pointer (&path), event_type);
+}
+
+static gboolean
+cd_icc_store_fanotify_event_cb (gint fd, GIOCondition condition, gpointer user_data)
+{
+	CdIccStore *store = CD_ICC_STORE (user_data);
+	guint64 buf[512];	/* events require 64 bit alignment */
+	gssize len;
+
+	while ((len = read (fd, buf, sizeof (buf))) > 0) {
+		const struct fanotify_event_metadata *metadata;
+		metadata = (const struct fanotify_event_metadata *) buf;
+		while (FAN_EVENT_OK (metadata, len)) {
+			cd_icc_store_fanotify_process_event (store, metadata);
+			metadata = FAN_EVENT_NEXT (metadata, len);
+		}
 	}
+	return G_SOURCE_CONTINUE;
 }
 
+/* returns %TRUE if @path is now covered by a filesystem mark; on any
+ * failure the caller falls back to a per-directory GFileMonitor */
 static gboolean
+cd_icc_store_fanotify_add (CdIccStore *store, const gchar *path)
+{
+	CdIccStorePrivate *priv = GET_PRIVATE (store);
+	CdIccStoreFanotifyMark *mark;
+	__kernel_fsid_t fsid;
+	struct statfs stfs;
+
+	/* tried before and not available */
+	if (priv->fanotify_fd == -2)
+		return FALSE;
+
+	/* one notification group serves the whole store; FAN_CLASS_NOTIF
+	 * needs CAP_SYS_ADMIN so this quietly fails in session contexts
+	 * and only the system daemon takes this path */
+	if (priv->fanotify_fd == -1) {
+		priv->fanotify_fd = fanotify_init (FAN_CLASS_NOTIF |
+						   FAN_CLOEXEC |
+						   FAN_NONBLOCK |
+						   FAN_REPORT_DFID_NAME,
+						   O_RDONLY | O_CLOEXEC);
+		if (priv->fanotify_fd < 0) {
+			g_debug ("CdIccStore: no fanotify, using per-directory "
+				 "monitors: %s", g_strerror (errno));
+			priv->fanotify_fd = -2;
+			return FALSE;
+		}
+		priv->fanotify_id = g_unix_fd_add (priv->fanotify_fd,
+						   G_IO_IN,
+						   cd_icc_store_fanotify_event_cb,
+						   store);
+	}
+
+	/* one mark covers every watched tree on the same filesystem */
+	if (statfs (path, &stfs) < 0)
+		return FALSE;
+	memcpy (&fsid, &stfs.f_fsid, sizeof (fsid));
+	if (cd_icc_store_fanotify_find_mark (store, &fsid) == NULL) {
+		gint mount_fd;
+		if (fanotify_mark (priv->fanotify_fd,
+				   FAN_MARK_ADD | FAN_MARK_FILESYSTEM | FAN_MARK_ONLYDIR,
+				   FAN_CREATE | FAN_DELETE |
+				   FAN_MOVED_TO | FAN_MOVED_FROM | FAN_ONDIR,
+				   AT_FDCWD, path) < 0) {
+			g_debug ("CdIccStore: cannot mark %s, using "
+				 "per-directory monitors: %s",
+				 path, g_strerror (errno));
+			return FALSE;
+		}
+		mount_fd = g_open (path, O_RDONLY | O_DIRECTORY | O_CLOEXEC, 0);
+		if (mount_fd < 0)
+			return FALSE;
+		mark = g_new0 (CdIccStoreFanotifyMark, 1);
+		mark->mount_fd = mount_fd;
+		mark->fsid = fsid;
+		g_ptr_array_add (priv->fanotify_marks, mark);
+	}
+
+	/* subdirectories are already inside a recorded root */
+	if (!cd_icc_store_fanotify_path_wanted (store, path))
+		g_ptr_array_add (priv->fanotify_roots, g_strdup (path));
+	return TRUE;
+}
+#endif
+
+static void
 cd_icc_store_search_path_child (CdIccStore *store,
 				const gchar *path,
 				GFileInfo *info,
-				guint depth,
-				GCancellable *cancellable,
-				GError **error)
+				GPtrArray *candidates,
+				GPtrArray *dirs)
 {
+	CdIccStoreCandidate *candidate;
 	const gchar *name;
 	const gchar *type;
 	g_autofree gchar *full_path = NULL;
-	g_autoptr(GFile) file = NULL;
 
 	/* further down the worm-hole */
 	name = g_file_info_get_name (info);
 	full_path = g_build_filename (path, name, NULL);
 	if (g_file_info_get_file_type (info) == G_FILE_TYPE_DIRECTORY) {
-		return cd_icc_store_search_path (store,
-						full_path,
-						depth + 1,
-						cancellable,
-						error);
+		g_ptr_array_add (dirs, g_steal_pointer (&full_path));
+		return;
 	}
 
 	/* ignore temp files */
 	if (g_strrstr (full_path, ".goutputstream") != NULL) {
 		g_debug ("ignoring gvfs temporary file");
-		return TRUE;
+		return;
 	}
 
 	/* check type */
 	type = g_file_info_get_attribute_string (info, G_FILE_ATTRIBUTE_STANDARD_CONTENT_TYPE);
 	if (g_strcmp0 (type, "application/vnd.iccprofile") != 0) {
 		g_debug ("Incorrect content type for %s, got %s", full_path, type);
-		return TRUE;
+		return;
 	}
 
-	/* is a file */
-	file = g_file_new_for_path (full_path);
-	return cd_icc_store_add_icc (store, file, error);
+	/* the inode came back with the enumeration, saving a stat round
+	 * trip per file later on */
+	candidate = g_new0 (CdIccStoreCandidate, 1);
+	if (g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_UNIX_INODE)) {
+		candidate->inode_key = g_strdup_printf ("%" G_GUINT32_FORMAT
+							":%" G_GUINT64_FORMAT,
+			g_file_info_get_attribute_uint32 (info, G_FILE_ATTRIBUTE_UNIX_DEVICE),
+			g_file_info_get_attribute_uint64 (info, G_FILE_ATTRIBUTE_UNIX_INODE));
+	}
+	candidate->path = g_steal_pointer (&full_path);
+	g_ptr_array_add (candidates, candidate);
 }
 
 static gboolean
@@ -402,9 +917,12 @@ cd_icc_store_search_path (CdIccStore *store,
 	CdIccStoreDirHelper *helper;
 	GError *error_local = NULL;
 	gboolean ret = TRUE;
+	guint i;
 	g_autoptr(GFileEnumerator) enumerator = NULL;
 	g_autoptr(GFile) file = NULL;
 	g_autoptr(GFileInfo) info = NULL;
+	g_autoptr(GPtrArray) candidates = NULL;
+	g_autoptr(GPtrArray) dirs = NULL;
 
 	/* check sanity */
 	if (depth > CD_ICC_STORE_MAX_RECURSION_LEVELS) {
@@ -423,18 +941,24 @@ cd_icc_store_search_path (CdIccStore *store,
 	if (helper == NULL) {
 		helper = g_new0 (CdIccStoreDirHelper, 1);
 		helper->path = g_strdup (path);
-		helper->monitor = g_file_monitor_directory (file,
-							    G_FILE_MONITOR_NONE,
-							    NULL,
-							    error);
-		if (helper->monitor == NULL) {
-			ret = FALSE;
-			cd_icc_store_helper_free (helper);
-			goto out;
+#ifdef HAVE_FANOTIFY
+		/* one filesystem mark replaces the per-directory watches */
+		if (!cd_icc_store_fanotify_add (store, path))
+#endif
+		{
+			helper->monitor = g_file_monitor_directory (file,
+								    G_FILE_MONITOR_NONE,
+								    NULL,
+								    error);
+			if (helper->monitor == NULL) {
+				ret = FALSE;
+				cd_icc_store_helper_free (helper);
+				goto out;
+			}
+			g_signal_connect (helper->monitor, "changed",
+					  G_CALLBACK(cd_icc_store_file_monitor_changed_cb),
+					  store);
 		}
-		g_signal_connect (helper->monitor, "changed",
-				  G_CALLBACK(cd_icc_store_file_monitor_changed_cb),
-				  store);
 		g_ptr_array_add (priv->directory_array, helper);
 	}
 
@@ -442,7 +966,9 @@ cd_icc_store_search_path (CdIccStore *store,
 	enumerator = g_file_enumerate_children (file,
 						G_FILE_ATTRIBUTE_STANDARD_NAME ","
 						G_FILE_ATTRIBUTE_STANDARD_CONTENT_TYPE ","
-						G_FILE_ATTRIBUTE_STANDARD_TYPE,
+						G_FILE_ATTRIBUTE_STANDARD_TYPE ","
+						G_FILE_ATTRIBUTE_UNIX_DEVICE ","
+						G_FILE_ATTRIBUTE_UNIX_INODE,
 						G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
 						cancellable,
 						error);
@@ -455,6 +981,8 @@ cd_icc_store_search_path (CdIccStore *store,
 	}
 
 	/* get all the files */
+	candidates = g_ptr_array_new_with_free_func ((GDestroyNotify) cd_icc_store_candidate_free);
+	dirs = g_ptr_array_new_with_free_func (g_free);
 	while (TRUE) {
 		info = g_file_enumerator_next_file (enumerator,
 						    cancellable,
@@ -469,14 +997,44 @@ cd_icc_store_search_path (CdIccStore *store,
 		if (info == NULL)
 			break;
 
-		/* process this child */
-		ret = cd_icc_store_search_path_child (store,
-						      path,
-						      info,
-						      depth,
-						      cancellable,
-						      error);
+		/* sort this child into candidates and subdirectories */
+		cd_icc_store_search_path_child (store,
+						path,
+						info,
+						candidates,
+						dirs);
 		g_object_unref (info);
+	}
+
+	/* get the reads for the whole directory in flight together before
+	 * the first parse blocks on I/O; this matters most on high
+	 * latency network filesystems */
+#ifdef POSIX_FADV_WILLNEED
+	for (i = 0; i < candidates->len; i++) {
+		CdIccStoreCandidate *candidate = g_ptr_array_index (candidates, i);
+		gint fd = g_open (candidate->path, O_RDONLY | O_CLOEXEC, 0);
+		if (fd < 0)
+			continue;
+		posix_fadvise (fd, 0, 0, POSIX_FADV_WILLNEED);
+		close (fd);
+	}
+#endif
+
+	/* load the candidates, then recurse into the subdirectories */
+	for (i = 0; i < candidates->len; i++) {
+		CdIccStoreCandidate *candidate = g_ptr_array_index (candidates, i);
+		g_autoptr(GFile) file_tmp = g_file_new_for_path (candidate->path);
+		ret = cd_icc_store_add_icc (store, file_tmp,
+					    candidate->inode_key, error);
+		if (!ret)
+			goto out;
+	}
+	for (i = 0; i < dirs->len; i++) {
+		ret = cd_icc_store_search_path (store,
+						g_ptr_array_index (dirs, i),
+						depth + 1,
+						cancellable,
+						error);
 		if (!ret)
 			goto out;
 	}
@@ -538,6 +1096,29 @@ cd_icc_store_set_cache (CdIccStore *store, GResource *cache)
 	priv->cache = g_resource_ref (cache);
 }
 
+/**
+ * cd_icc_store_set_index_location:
+ * @store: a #CdIccStore instance.
+ * @location: a fully qualified directory path
+ *
+ * Sets a directory used to persist an index of parsed profiles across
+ * restarts. When set, profiles whose path, mtime and size match an index
+ * entry are hydrated with cd_icc_load_cache() without opening the
+ * profile itself; new or modified files are parsed as normal and the
+ * index entry is rewritten. This function can only be called once.
+ *
+ * Since: 1.4.6
+ **/
+void
+cd_icc_store_set_index_location (CdIccStore *store, const gchar *location)
+{
+	CdIccStorePrivate *priv = GET_PRIVATE (store);
+	g_return_if_fail (CD_IS_ICC_STORE (store));
+	g_return_if_fail (location != NULL);
+	g_return_if_fail (priv->index_location == NULL);
+	priv->index_location = g_strdup (location);
+}
+
 /**
  * cd_icc_store_get_all:
  * @store: a #CdIccStore instance.
@@ -665,6 +1246,425 @@ cd_icc_store_search_location (CdIccStore *store,
 	return cd_icc_store_search_path (store, location, 0, cancellable, error);
 }
 
+typedef struct {
+	guint		 pending;	/* directories and loads outstanding */
+	GError		*error;		/* first failure, or %NULL */
+	GThreadPool	*pool;
+} CdIccStoreSearchHelper;
+
+static void
+cd_icc_store_search_helper_free (CdIccStoreSearchHelper *helper)
+{
+	if (helper->error != NULL)
+		g_error_free (helper->error);
+	g_thread_pool_free (helper->pool, FALSE, TRUE);
+	g_free (helper);
+}
+
+typedef struct {
+	GTask		*task;
+	gchar		*path;
+	guint		 depth;
+	GFileEnumerator	*enumerator;
+	CdIcc		*icc;		/* worker pool result */
+	GError		*error;		/* worker pool failure */
+} CdIccStoreSearchItem;
+
+static void
+cd_icc_store_search_item_free (CdIccStoreSearchItem *item)
+{
+	if (item->enumerator != NULL)
+		g_object_unref (item->enumerator);
+	if (item->icc != NULL)
+		g_object_unref (item->icc);
+	if (item->error != NULL)
+		g_error_free (item->error);
+	g_object_unref (item->task);
+	g_free (item->path);
+	g_free (item);
+}
+
+/* takes ownership of @error; only the first failure is reported */
+static void
+cd_icc_store_search_record_error (GTask *task, GError *error)
+{
+	CdIccStoreSearchHelper *helper = g_task_get_task_data (task);
+	if (helper->error == NULL)
+		helper->error = error;
+	else
+		g_error_free (error);
+}
+
+/* one outstanding directory or profile load has finished; complete the
+ * task when the last one settles */
+static void
+cd_icc_store_search_task_done (GTask *task)
+{
+	CdIccStoreSearchHelper *helper = g_task_get_task_data (task);
+	if (--helper->pending > 0)
+		return;
+	if (helper->error != NULL)
+		g_task_return_error (task, g_steal_pointer (&helper->error));
+	else
+		g_task_return_boolean (task, TRUE);
+}
+
+static void
+cd_icc_store_search_dir_async (GTask *task,
+			       const gchar *path,
+			       guint depth);
+
+/* runs in the main context so the array and signal emission stay
+ * single threaded */
+static gboolean
+cd_icc_store_load_idle_cb (gpointer user_data)
+{
+	CdIccStoreSearchItem *item = (CdIccStoreSearchItem *) user_data;
+	CdIccStore *store = CD_ICC_STORE (g_task_get_source_object (item->task));
+
+	if (item->icc == NULL) {
+		cd_icc_store_search_record_error (item->task,
+						  g_steal_pointer (&item->error));
+	} else {
+		/* add unless it's a duplicate */
+		cd_icc_store_register_icc (store, item->icc);
+	}
+	cd_icc_store_search_task_done (item->task);
+	cd_icc_store_search_item_free (item);
+	return G_SOURCE_REMOVE;
+}
+
+/* worker pool thread; only parses the profile, the store itself is
+ * never touched from here */
+static void
+cd_icc_store_load_thread_cb (gpointer data, gpointer user_data)
+{
+	CdIccStoreSearchItem *item = (CdIccStoreSearchItem *) data;
+	CdIccStore *store = CD_ICC_STORE (g_task_get_source_object (item->task));
+	CdIccStorePrivate *priv = GET_PRIVATE (store);
+	g_autoptr(GBytes) bytes = NULL;
+	g_autoptr(GFile) file = NULL;
+	g_autoptr(GFile) index_file = NULL;
+
+	/* serve unchanged profiles from the persistent index */
+	if (priv->index_location != NULL) {
+		g_autoptr(CdIcc) icc = cd_icc_new ();
+		index_file = cd_icc_store_get_index_file (store, item->path);
+		if (cd_icc_load_cache (icc, index_file, NULL)) {
+			item->icc = g_steal_pointer (&icc);
+			g_main_context_invoke_full (g_task_get_context (item->task),
+						    G_PRIORITY_DEFAULT,
+						    cd_icc_store_load_idle_cb,
+						    item, NULL);
+			return;
+		}
+	}
+
+	/* use the GResource cache if available */
+	item->icc = cd_icc_new ();
+	if (cd_icc_store_resource_lookup (store, item->icc,
+					  item->path, &bytes)) {
+		g_main_context_invoke_full (g_task_get_context (item->task),
+					    G_PRIORITY_DEFAULT,
+					    cd_icc_store_load_idle_cb,
+					    item, NULL);
+		return;
+	}
+
+	/* parse new icc object */
+	if (bytes != NULL) {
+		cd_icc_set_filename (item->icc, item->path);
+		if (!cd_icc_load_data (item->icc,
+				       g_bytes_get_data (bytes, NULL),
+				       g_bytes_get_size (bytes),
+				       CD_ICC_LOAD_FLAGS_METADATA,
+				       &item->error))
+			g_clear_object (&item->icc);
+	} else {
+		file = g_file_new_for_path (item->path);
+		if (!cd_icc_load_file (item->icc,
+				       file,
+				       priv->load_flags,
+				       g_task_get_cancellable (item->task),
+				       &item->error))
+			g_clear_object (&item->icc);
+
+		/* save for the next start */
+		if (item->icc != NULL && index_file != NULL)
+			cd_icc_store_index_save (store, item->icc, index_file);
+	}
+
+	/* hand the result back to the main context */
+	g_main_context_invoke_full (g_task_get_context (item->task),
+				    G_PRIORITY_DEFAULT,
+				    cd_icc_store_load_idle_cb,
+				    item, NULL);
+}
+
+static void
+cd_icc_store_search_next_files_cb (GObject *source_object,
+				   GAsyncResult *res,
+				   gpointer user_data)
+{
+	CdIccStoreSearchItem *item = (CdIccStoreSearchItem *) user_data;
+	CdIccStoreSearchHelper *helper = g_task_get_task_data (item->task);
+	CdIccStoreSearchItem *load;
+	GError *error = NULL;
+	GList *infos;
+	GList *l;
+
+	infos = g_file_enumerator_next_files_finish (item->enumerator,
+						     res, &error);
+	if (error != NULL) {
+		cd_icc_store_search_record_error (item->task, error);
+		goto done;
+	}
+
+	/* special value, meaning "no more files to process" */
+	if (infos == NULL)
+		goto done;
+
+	for (l = infos; l != NULL; l = l->next) {
+		GFileInfo *info = G_FILE_INFO (l->data);
+		const gchar *type;
+		g_autofree gchar *full_path = NULL;
+
+		full_path = g_build_filename (item->path,
+					      g_file_info_get_name (info),
+					      NULL);
+
+		/* recurse breadth-first into subdirectories */
+		if (g_file_info_get_file_type (info) == G_FILE_TYPE_DIRECTORY) {
+			helper->pending++;
+			cd_icc_store_search_dir_async (item->task,
+						       full_path,
+						       item->depth + 1);
+			continue;
+		}
+
+		/* ignore temp files */
+		if (g_strrstr (full_path, ".goutputstream") != NULL) {
+			g_debug ("ignoring gvfs temporary file");
+			continue;
+		}
+
+		/* check type */
+		type = g_file_info_get_attribute_string (info, G_FILE_ATTRIBUTE_STANDARD_CONTENT_TYPE);
+		if (g_strcmp0 (type, "application/vnd.iccprofile") != 0) {
+			g_debug ("Incorrect content type for %s, got %s",
+				 full_path, type);
+			continue;
+		}
+
+		/* hand the load off to the worker pool */
+		load = g_new0 (CdIccStoreSearchItem, 1);
+		load->task = g_object_ref (item->task);
+		load->path = g_steal_pointer (&full_path);
+		helper->pending++;
+		g_thread_pool_push (helper->pool, load, NULL);
+	}
+	g_list_free_full (infos, (GDestroyNotify) g_object_unref);
+
+	/* get the next batch */
+	g_file_enumerator_next_files_async (item->enumerator,
+					    64, /* batch size */
+					    G_PRIORITY_DEFAULT,
+					    g_task_get_cancellable (item->task),
+					    cd_icc_store_search_next_files_cb,
+					    item);
+	return;
+done:
+	cd_icc_store_search_task_done (item->task);
+	cd_icc_store_search_item_free (item);
+}
+
+static void
+cd_icc_store_search_enumerate_cb (GObject *source_object,
+				  GAsyncResult *res,
+				  gpointer user_data)
+{
+	CdIccStoreSearchItem *item = (CdIccStoreSearchItem *) user_data;
+	GError *error = NULL;
+
+	item->enumerator = g_file_enumerate_children_finish (G_FILE (source_object),
+							     res, &error);
+	if (item->enumerator == NULL) {
+		CdIccStore *store = CD_ICC_STORE (g_task_get_source_object (item->task));
+		CdIccStorePrivate *priv = GET_PRIVATE (store);
+		CdIccStoreDirHelper *helper_dir;
+
+		helper_dir = cd_icc_store_find_by_directory (store, item->path);
+		if (helper_dir != NULL)
+			g_ptr_array_remove (priv->directory_array, helper_dir);
+		cd_icc_store_search_record_error (item->task, error);
+		cd_icc_store_search_task_done (item->task);
+		cd_icc_store_search_item_free (item);
+		return;
+	}
+	g_file_enumerator_next_files_async (item->enumerator,
+					    64, /* batch size */
+					    G_PRIORITY_DEFAULT,
+					    g_task_get_cancellable (item->task),
+					    cd_icc_store_search_next_files_cb,
+					    item);
+}
+
+static void
+cd_icc_store_search_dir_async (GTask *task,
+			       const gchar *path,
+			       guint depth)
+{
+	CdIccStore *store = CD_ICC_STORE (g_task_get_source_object (task));
+	CdIccStorePrivate *priv = GET_PRIVATE (store);
+	CdIccStoreDirHelper *helper_dir;
+	CdIccStoreSearchItem *item;
+	GError *error = NULL;
+	g_autoptr(GFile) file = NULL;
+
+	/* check sanity */
+	if (depth > CD_ICC_STORE_MAX_RECURSION_LEVELS) {
+		g_set_error (&error,
+			     CD_ICC_ERROR,
+			     CD_ICC_ERROR_FAILED_TO_OPEN,
+			     "cannot recurse more than %i levels deep",
+			     CD_ICC_STORE_MAX_RECURSION_LEVELS);
+		cd_icc_store_search_record_error (task, error);
+		cd_icc_store_search_task_done (task);
+		return;
+	}
+
+	/* add an inotify watch if not already added */
+	file = g_file_new_for_path (path);
+	helper_dir = cd_icc_store_find_by_directory (store, path);
+	if (helper_dir == NULL) {
+		helper_dir = g_new0 (CdIccStoreDirHelper, 1);
+		helper_dir->path = g_strdup (path);
+#ifdef HAVE_FANOTIFY
+		/* one filesystem mark replaces the per-directory watches */
+		if (!cd_icc_store_fanotify_add (store, path))
+#endif
+		{
+			helper_dir->monitor = g_file_monitor_directory (file,
+									G_FILE_MONITOR_NONE,
+									NULL,
+									&error);
+			if (helper_dir->monitor == NULL) {
+				cd_icc_store_helper_free (helper_dir);
+				cd_icc_store_search_record_error (task, error);
+				cd_icc_store_search_task_done (task);
+				return;
+			}
+			g_signal_connect (helper_dir->monitor, "changed",
+					  G_CALLBACK(cd_icc_store_file_monitor_changed_cb),
+					  store);
+		}
+		g_ptr_array_add (priv->directory_array, helper_dir);
+	}
+
+	/* get contents of directory */
+	item = g_new0 (CdIccStoreSearchItem, 1);
+	item->task = g_object_ref (task);
+	item->path = g_strdup (path);
+	item->depth = depth;
+	g_file_enumerate_children_async (file,
+					 G_FILE_ATTRIBUTE_STANDARD_NAME ","
+					 G_FILE_ATTRIBUTE_STANDARD_CONTENT_TYPE ","
+					 G_FILE_ATTRIBUTE_STANDARD_TYPE,
+					 G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
+					 G_PRIORITY_DEFAULT,
+					 g_task_get_cancellable (task),
+					 cd_icc_store_search_enumerate_cb,
+					 item);
+}
+
+/**
+ * cd_icc_store_search_location_async:
+ * @store: a #CdIccStore instance.
+ * @location: a fully qualified path
+ * @search_flags: #CdIccStoreSearchFlags, e.g. %CD_ICC_STORE_SEARCH_FLAGS_CREATE_LOCATION
+ * @cancellable: A #GCancellable or %NULL
+ * @callback: the function to run on completion
+ * @user_data: the data to pass to @callback
+ *
+ * Adds a location to be watched for ICC profiles without blocking the
+ * caller. Directories are enumerated breadth-first and the profiles are
+ * parsed in a worker pool, with ::added emitted from the main context as
+ * each one lands; @callback fires when the initial scan has settled.
+ *
+ * Since: 1.4.6
+ **/
+void
+cd_icc_store_search_location_async (CdIccStore *store,
+				    const gchar *location,
+				    CdIccStoreSearchFlags search_flags,
+				    GCancellable *cancellable,
+				    GAsyncReadyCallback callback,
+				    gpointer user_data)
+{
+	CdIccStoreSearchHelper *helper;
+	g_autoptr(GFile) file = NULL;
+	g_autoptr(GTask) task = NULL;
+
+	g_return_if_fail (CD_IS_ICC_STORE (store));
+	g_return_if_fail (location != NULL);
+
+	task = g_task_new (store, cancellable, callback, user_data);
+	g_task_set_source_tag (task, cd_icc_store_search_location_async);
+
+	/* does folder exist? */
+	file = g_file_new_for_path (location);
+	if (!g_file_query_exists (file, cancellable)) {
+		GError *error = NULL;
+		if ((search_flags & CD_ICC_STORE_SEARCH_FLAGS_CREATE_LOCATION) > 0) {
+			if (!g_file_make_directory_with_parents (file,
+								 cancellable,
+								 &error)) {
+				g_task_return_error (task, error);
+				return;
+			}
+		} else {
+			/* the directory does not exist */
+			g_task_return_boolean (task, TRUE);
+			return;
+		}
+	}
+
+	/* scan the root directory; anything found below it keeps the
+	 * pending count above zero until it has been processed */
+	helper = g_new0 (CdIccStoreSearchHelper, 1);
+	helper->pool = g_thread_pool_new (cd_icc_store_load_thread_cb,
+					  NULL,
+					  (gint) g_get_num_processors (),
+					  FALSE,
+					  NULL);
+	helper->pending = 1;
+	g_task_set_task_data (task, helper,
+			      (GDestroyNotify) cd_icc_store_search_helper_free);
+	cd_icc_store_search_dir_async (task, location, 0);
+}
+
+/**
+ * cd_icc_store_search_location_finish:
+ * @store: a #CdIccStore instance.
+ * @res: the #GAsyncResult
+ * @error: A #GError or %NULL
+ *
+ * Gets the result from cd_icc_store_search_location_async().
+ *
+ * Return value: %TRUE for success
+ *
+ * Since: 1.4.6
+ **/
+gboolean
+cd_icc_store_search_location_finish (CdIccStore *store,
+				     GAsyncResult *res,
+				     GError **error)
+{
+	g_return_val_if_fail (CD_IS_ICC_STORE (store), FALSE);
+	g_return_val_if_fail (g_task_is_valid (res, store), FALSE);
+	return g_task_propagate_boolean (G_TASK (res), error);
+}
+
 static void
 cd_icc_store_class_init (CdIccStoreClass *klass)
 {
@@ -709,7 +1709,20 @@ cd_icc_store_init (CdIccStore *store)
 	CdIccStorePrivate *priv = GET_PRIVATE (store);
 	priv->load_flags = CD_ICC_LOAD_FLAGS_FALLBACK_MD5;
 	priv->icc_array = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
+	priv->icc_by_checksum = g_hash_table_new_full (g_str_hash, g_str_equal,
+						       g_free, NULL);
+	priv->icc_by_filename = g_hash_table_new_full (g_str_hash, g_str_equal,
+						       g_free, NULL);
+	priv->icc_by_inode = g_hash_table_new_full (g_str_hash, g_str_equal,
+						    g_free, NULL);
 	priv->directory_array = g_ptr_array_new_with_free_func ((GDestroyNotify) cd_icc_store_helper_free);
+	priv->monitor_changes = g_hash_table_new_full (g_str_hash, g_str_equal,
+						       g_free, NULL);
+#ifdef HAVE_FANOTIFY
+	priv->fanotify_fd = -1;
+	priv->fanotify_marks = g_ptr_array_new_with_free_func ((GDestroyNotify) cd_icc_store_fanotify_mark_free);
+	priv->fanotify_roots = g_ptr_array_new_with_free_func (g_free);
+#endif
 }
 
 static void
@@ -718,6 +1731,21 @@ cd_icc_store_finalize (GObject *object)
 	CdIccStore *store = CD_ICC_STORE (object);
 	CdIccStorePrivate *priv = GET_PRIVATE (store);
 
+	if (priv->monitor_changes_id != 0)
+		g_source_remove (priv->monitor_changes_id);
+	g_hash_table_unref (priv->monitor_changes);
+#ifdef HAVE_FANOTIFY
+	if (priv->fanotify_id != 0)
+		g_source_remove (priv->fanotify_id);
+	if (priv->fanotify_fd >= 0)
+		close (priv->fanotify_fd);
+	g_ptr_array_unref (priv->fanotify_marks);
+	g_ptr_array_unref (priv->fanotify_roots);
+#endif
+	g_free (priv->index_location);
+	g_hash_table_unref (priv->icc_by_checksum);
+	g_hash_table_unref (priv->icc_by_filename);
+	g_hash_table_unref (priv->icc_by_inode);
 	g_ptr_array_unref (priv->icc_array);
 	g_ptr_array_unref (priv->directory_array);
 	if (priv->cache != NULL)
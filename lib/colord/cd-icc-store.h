@@ -82,6 +82,15 @@ gboolean	 cd_icc_store_search_location	(CdIccStore	*store,
 						 CdIccStoreSearchFlags search_flags,
 						 GCancellable	*cancellable,
 						 GError		**error);
+void		 cd_icc_store_search_location_async (CdIccStore	*store,
+							 const gchar	*location,
+							 CdIccStoreSearchFlags search_flags,
+							 GCancellable	*cancellable,
+							 GAsyncReadyCallback callback,
+							 gpointer	 user_data);
+gboolean	 cd_icc_store_search_location_finish (CdIccStore *store,
+							 GAsyncResult	*res,
+							 GError		**error);
 gboolean	 cd_icc_store_search_kind	(CdIccStore	*store,
 						 CdIccStoreSearchKind search_kind,
 						 CdIccStoreSearchFlags search_flags,
@@ -92,6 +101,8 @@ void		 cd_icc_store_set_load_flags	(CdIccStore	*store,
 CdIccLoadFlags	 cd_icc_store_get_load_flags	(CdIccStore	*store);
 void		 cd_icc_store_set_cache		(CdIccStore	*store,
 						 GResource	*cache);
+void		 cd_icc_store_set_index_location (CdIccStore	*store,
+						 const gchar	*location);
 GPtrArray	*cd_icc_store_get_all		(CdIccStore	*store);
 CdIcc		*cd_icc_store_find_by_filename	(CdIccStore	*store,
 						 const gchar	*filename);
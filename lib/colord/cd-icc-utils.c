@@ -39,6 +39,32 @@ typedef struct {
 	cmsFloat32Number	*data;
 } CdIccUtilsGamutCheckHelper;
 
+typedef struct {
+	cmsHTRANSFORM		 transform;
+	const cmsFloat32Number	*in;	/* RGB, 3 floats per sample */
+	cmsFloat32Number	*out;	/* gray, 1 float per sample */
+	guint			 len;	/* in samples */
+	guint			 cnt;	/* in-gamut samples found */
+} CdIccUtilsCoverageItem;
+
+static void
+cd_icc_utils_get_coverage_thread_cb (gpointer data, gpointer user_data)
+{
+	CdIccUtilsCoverageItem *item = (CdIccUtilsCoverageItem *) data;
+	guint i;
+
+	/* each worker transforms its own slice of the grid and counts
+	 * into its own accumulator, so no locking is required */
+	cmsDoTransform (item->transform,
+			item->in,
+			item->out,
+			item->len);
+	for (i = 0; i < item->len; i++) {
+		if (item->out[i] == 0.0)
+			item->cnt++;
+	}
+}
+
 static cmsInt32Number
 cd_icc_utils_get_coverage_sample_cb (const cmsFloat32Number in[],
 				     cmsFloat32Number out[],
@@ -62,14 +88,20 @@ cd_icc_utils_get_coverage_calc (CdIcc *icc,
 	cmsHTRANSFORM transform = NULL;
 	cmsUInt32Number dimensions[] = { cube_size, cube_size, cube_size };
 	CdIccUtilsGamutCheckHelper helper;
+	GThreadPool *pool;
 	gboolean ret = TRUE;
 	guint cnt = 0;
 	guint data_len = cube_size * cube_size * cube_size;
 	guint i;
+	guint n_chunks;
+	guint offset = 0;
+	g_autofree CdIccUtilsCoverageItem *items = NULL;
 	g_autofree cmsFloat32Number *data = NULL;
+	g_autofree cmsFloat32Number *gray = NULL;
 	g_autofree cmsUInt16Number *alarm_codes = NULL;
 
-	/* create a proofing transform with gamut check */
+	/* create a proofing transform with gamut check; the per-transform
+	 * pixel cache has to be off as the workers share the handle */
 	profile_null = cmsCreateNULLProfileTHR (cd_icc_get_context (icc));
 	transform = cmsCreateProofingTransformTHR (cd_icc_get_context (icc),
 						   cd_icc_get_handle (icc),
@@ -80,7 +112,8 @@ cd_icc_utils_get_coverage_calc (CdIcc *icc,
 						   INTENT_ABSOLUTE_COLORIMETRIC,
 						   INTENT_ABSOLUTE_COLORIMETRIC,
 						   cmsFLAGS_GAMUTCHECK |
-						   cmsFLAGS_SOFTPROOFING);
+						   cmsFLAGS_SOFTPROOFING |
+						   cmsFLAGS_NOCACHE);
 	if (transform == NULL) {
 		ret = FALSE;
 		g_set_error (error,
@@ -112,14 +145,33 @@ cd_icc_utils_get_coverage_calc (CdIcc *icc,
 		goto out;
 	}
 
-	/* transform each one of those nodes across the proofing transform */
-	cmsDoTransform (transform, helper.data, helper.data, data_len);
+	/* transform the nodes across the proofing transform in z-plane
+	 * chunks, one per processor */
+	gray = g_new0 (cmsFloat32Number, data_len);
+	n_chunks = MIN (g_get_num_processors (), cube_size);
+	items = g_new0 (CdIccUtilsCoverageItem, n_chunks);
+	pool = g_thread_pool_new (cd_icc_utils_get_coverage_thread_cb,
+				  NULL,
+				  (gint) n_chunks,
+				  FALSE,
+				  NULL);
+	for (i = 0; i < n_chunks; i++) {
+		guint planes = cube_size / n_chunks +
+			       (i < cube_size % n_chunks ? 1 : 0);
+		items[i].transform = transform;
+		items[i].in = data + (gsize) offset * 3;
+		items[i].out = gray + offset;
+		items[i].len = planes * cube_size * cube_size;
+		offset += items[i].len;
+		g_thread_pool_push (pool, &items[i], NULL);
+	}
+
+	/* waits for all the workers to finish */
+	g_thread_pool_free (pool, FALSE, TRUE);
 
 	/* count the nodes that gives you zero and divide by total number */
-	for (i = 0; i < data_len; i++) {
-		if (helper.data[i] == 0.0)
-			cnt++;
-	}
+	for (i = 0; i < n_chunks; i++)
+		cnt += items[i].cnt;
 
 	/* success */
 	if (coverage != NULL)
@@ -149,7 +201,35 @@ cd_icc_utils_get_coverage (CdIcc *icc,
 			   gdouble *coverage,
 			   GError **error)
 {
+	static GHashTable *cache = NULL;
+	static GMutex cache_mutex;
 	gdouble coverage_tmp;
+	gdouble *coverage_cached;
+	g_autofree gchar *cache_key = NULL;
+
+	/* coverage only depends on the profile contents, so hits for the
+	 * same pair of profiles can be served from a process-wide cache */
+	if (cd_icc_get_checksum_fast (icc) != NULL &&
+	    cd_icc_get_checksum_fast (icc_reference) != NULL) {
+		cache_key = g_strdup_printf ("%s:%s",
+					     cd_icc_get_checksum_fast (icc),
+					     cd_icc_get_checksum_fast (icc_reference));
+	}
+	if (cache_key != NULL) {
+		g_mutex_lock (&cache_mutex);
+		if (cache == NULL)
+			cache = g_hash_table_new_full (g_str_hash,
+						       g_str_equal,
+						       g_free,
+						       g_free);
+		coverage_cached = g_hash_table_lookup (cache, cache_key);
+		g_mutex_unlock (&cache_mutex);
+		if (coverage_cached != NULL) {
+			if (coverage != NULL)
+				*coverage = *coverage_cached;
+			return TRUE;
+		}
+	}
 
 	/* first see if icc has a smaller gamut volume to the reference */
 	if (!cd_icc_utils_get_coverage_calc (icc,
@@ -168,6 +248,15 @@ cd_icc_utils_get_coverage (CdIcc *icc,
 		coverage_tmp = 1 / coverage_tmp;
 	}
 
+	/* save for next time */
+	if (cache_key != NULL) {
+		g_mutex_lock (&cache_mutex);
+		g_hash_table_insert (cache,
+				     g_steal_pointer (&cache_key),
+				     g_memdup (&coverage_tmp, sizeof (gdouble)));
+		g_mutex_unlock (&cache_mutex);
+	}
+
 	/* success */
 	if (coverage != NULL)
 		*coverage = coverage_tmp;
@@ -37,16 +37,32 @@
 #include <errno.h>
 #include <math.h>
 
+#include "cd-buffer.h"
+#include "cd-color-private.h"
 #include "cd-context-lcms.h"
 #include "cd-icc.h"
+#include "cd-perf-stats.h"
 
 static void	cd_icc_class_init	(CdIccClass	*klass);
 static void	cd_icc_init		(CdIcc		*icc);
 static gboolean	cd_icc_load_named_colors (CdIcc		*icc, GError **error);
+static gboolean	cd_icc_load_metadata	(CdIcc		*icc, GError **error);
+static gboolean	cd_icc_load_primaries	(CdIcc		*icc, GError **error);
+static gboolean	cd_icc_load_characterization_data (CdIcc *icc, GError **error);
 static void	cd_icc_finalize		(GObject	*object);
 
 #define GET_PRIVATE(o) (cd_icc_get_instance_private (o))
 
+/* which tag groups have been modified since the profile was loaded, so
+ * cd_icc_save_data() only regenerates what actually changed */
+typedef enum {
+	CD_ICC_DIRTY_NONE		= 0,
+	CD_ICC_DIRTY_METADATA		= 1 << 0,
+	CD_ICC_DIRTY_CHARACTERIZATION	= 1 << 1,
+	CD_ICC_DIRTY_TRANSLATIONS	= 1 << 2,
+	CD_ICC_DIRTY_ALL		= 0xffffffff
+} CdIccDirty;
+
 typedef enum {
 	CD_MLUC_DESCRIPTION,
 	CD_MLUC_COPYRIGHT,
@@ -68,14 +84,27 @@ typedef struct
 	cmsHPROFILE		 lcms_profile;
 	gboolean		 can_delete;
 	gchar			*checksum;
+	gchar			*checksum_fast;
 	gchar			*filename;
 	gchar			*characterization_data;
+	GMappedFile		*mapped_file;
+	GBytes			*blob;
+	GPtrArray		*arena;
+	guint8			*arena_tip;
+	gsize			 arena_space;
+	GPtrArray		*vcgt_cache;
+	guint			 vcgt_cache_size;
+	GPtrArray		*vcgt_slabs;
+	GArray			*warnings_cache;
 	gdouble			 version;
 	GHashTable		*mluc_data[CD_MLUC_LAST]; /* key is 'en_GB' or '' for default */
 	GHashTable		*metadata;
 	gint64			 creation_time;
+	guint32			 dirty;
+	guint32			 parsed;
 	guint32			 size;
 	GPtrArray		*named_colors;
+	GPtrArray		*nc_pages;
 	guint			 temperature;
 	CdColorXYZ		 white;
 	CdColorXYZ		 red;
@@ -102,6 +131,57 @@ enum {
 	PROP_LAST
 };
 
+/* named colors, metadata and localized strings are allocated out of a
+ * per-profile arena that is freed wholesale in cd_icc_finalize(); this
+ * avoids one malloc per string for spot-color profiles with 10k+ colors.
+ * Replaced entries just leak into the arena until the profile goes away,
+ * which is fine as these tags are written a handful of times at most */
+#define CD_ICC_ARENA_BLOCK_SIZE		(32 * 1024)
+
+static gpointer
+cd_icc_arena_alloc (CdIcc *icc, gsize size)
+{
+	CdIccPrivate *priv = GET_PRIVATE (icc);
+	gpointer tmp;
+
+	/* keep everything aligned for the largest member we store */
+	size = (size + 7) & ~(gsize) 7;
+
+	/* huge requests get their own block so we don't waste the tip */
+	if (size > CD_ICC_ARENA_BLOCK_SIZE / 4) {
+		tmp = g_malloc (size);
+		g_ptr_array_add (priv->arena, tmp);
+		return tmp;
+	}
+
+	/* start a fresh block */
+	if (size > priv->arena_space) {
+		priv->arena_tip = g_malloc (CD_ICC_ARENA_BLOCK_SIZE);
+		priv->arena_space = CD_ICC_ARENA_BLOCK_SIZE;
+		g_ptr_array_add (priv->arena, priv->arena_tip);
+	}
+
+	/* bump the tip */
+	tmp = priv->arena_tip;
+	priv->arena_tip += size;
+	priv->arena_space -= size;
+	return tmp;
+}
+
+static gchar *
+cd_icc_arena_strdup (CdIcc *icc, const gchar *str)
+{
+	gsize len;
+	gchar *tmp;
+
+	if (str == NULL)
+		return NULL;
+	len = strlen (str) + 1;
+	tmp = cd_icc_arena_alloc (icc, len);
+	memcpy (tmp, str, len);
+	return tmp;
+}
+
 /**
  * cd_icc_error_quark:
  *
@@ -158,6 +238,20 @@ cd_icc_uint32_to_str (guint32 id, gchar *str)
 	str[4] = '\0';
 }
 
+/* profiles hydrated from the sidecar cache defer opening the profile
+ * with lcms2 until something actually needs the raw tag data */
+static void
+cd_icc_ensure_lcms_profile (CdIcc *icc)
+{
+	CdIccPrivate *priv = GET_PRIVATE (icc);
+	if (priv->lcms_profile != NULL || priv->filename == NULL)
+		return;
+	priv->lcms_profile = cmsOpenProfileFromFileTHR (priv->context_lcms,
+							priv->filename, "r");
+	if (priv->lcms_profile == NULL)
+		g_debug ("failed to open %s", priv->filename);
+}
+
 static gpointer
 cd_icc_read_tag (CdIcc *icc, cmsTagSignature sig, GError **error)
 {
@@ -166,6 +260,7 @@ cd_icc_read_tag (CdIcc *icc, cmsTagSignature sig, GError **error)
 	gpointer tmp;
 
 	/* ensure context error is not present to aid debugging */
+	cd_icc_ensure_lcms_profile (icc);
 	cd_context_lcms_error_clear (priv->context_lcms);
 
 	/* read raw value */
@@ -186,6 +281,39 @@ cd_icc_read_tag (CdIcc *icc, cmsTagSignature sig, GError **error)
 	return NULL;
 }
 
+/* named colors are decoded in fixed size pages so a 30k entry spot
+ * color library does not have to be materialized for the first paint */
+#define CD_ICC_NC_PAGE_SIZE		256
+#define CD_ICC_NC_PAGE_MAX		8
+
+typedef struct {
+	guint		 number;
+	GPtrArray	*swatches;	/* of CdColorSwatch, NULL when invalid */
+} CdIccNamedColorPage;
+
+static void
+cd_icc_named_color_page_free (CdIccNamedColorPage *page)
+{
+	guint i;
+	for (i = 0; i < page->swatches->len; i++) {
+		CdColorSwatch *swatch = g_ptr_array_index (page->swatches, i);
+		if (swatch != NULL)
+			cd_color_swatch_free (swatch);
+	}
+	g_ptr_array_unref (page->swatches);
+	g_free (page);
+}
+
+static void
+cd_icc_named_color_pages_clear (CdIcc *icc)
+{
+	CdIccPrivate *priv = GET_PRIVATE (icc);
+	guint i;
+	for (i = 0; i < priv->nc_pages->len; i++)
+		cd_icc_named_color_page_free (g_ptr_array_index (priv->nc_pages, i));
+	g_ptr_array_set_size (priv->nc_pages, 0);
+}
+
 static gboolean
 cd_icc_write_tag (CdIcc *icc, cmsTagSignature sig, gpointer data, GError **error)
 {
@@ -193,8 +321,14 @@ cd_icc_write_tag (CdIcc *icc, cmsTagSignature sig, gpointer data, GError **error
 	gchar sig_string[5];
 
 	/* ensure context error is not present to aid debugging */
+	cd_icc_ensure_lcms_profile (icc);
 	cd_context_lcms_error_clear (priv->context_lcms);
 
+	/* the loaded blob and cached results no longer match the profile */
+	g_clear_pointer (&priv->blob, g_bytes_unref);
+	g_clear_pointer (&priv->warnings_cache, g_array_unref);
+	cd_icc_named_color_pages_clear (icc);
+
 	/* write raw value */
 	if (cmsWriteTag (priv->lcms_profile, sig, data))
 		return TRUE;
@@ -275,6 +409,7 @@ cd_icc_to_string (CdIcc *icc)
 	g_return_val_if_fail (CD_IS_ICC (icc), NULL);
 
 	/* setup error handler */
+	cd_icc_ensure_lcms_profile (icc);
 
 	/* print header */
 	str = g_string_new ("icc:\nHeader:\n");
@@ -698,6 +833,7 @@ cd_icc_get_tags (CdIcc *icc, GError **error)
 	guint32 i;
 	guint32 number_tags;
 
+	cd_icc_ensure_lcms_profile (icc);
 	tags = g_ptr_array_new ();
 	number_tags = cmsGetTagCount (priv->lcms_profile);
 	for (i = 0; i < number_tags; i++) {
@@ -720,6 +856,115 @@ cd_icc_str_to_tag (const gchar *tag)
 	return GUINT32_TO_BE (id);
 }
 
+/* the on-disk tag table starts directly after the 128 byte header */
+#define CD_ICC_TAG_TABLE_OFFSET		128
+
+static guint32
+cd_icc_get_blob_tag_count (CdIcc *icc, const guint8 **data_out)
+{
+	CdIccPrivate *priv = GET_PRIVATE (icc);
+	const guint8 *data;
+	gsize len;
+	guint32 number_tags;
+
+	/* no blob was retained, or a mutator invalidated it */
+	if (priv->blob == NULL)
+		return 0;
+	data = g_bytes_get_data (priv->blob, &len);
+	if (len < CD_ICC_TAG_TABLE_OFFSET + 4)
+		return 0;
+	number_tags = cd_buffer_read_uint32_be (data + CD_ICC_TAG_TABLE_OFFSET);
+
+	/* the whole table has to fit inside the blob */
+	if (number_tags > (len - CD_ICC_TAG_TABLE_OFFSET - 4) / 12)
+		return 0;
+	if (data_out != NULL)
+		*data_out = data;
+	return number_tags;
+}
+
+static gboolean
+cd_icc_lookup_blob_tag (CdIcc *icc,
+			cmsTagSignature sig,
+			guint32 *tag_offset,
+			guint32 *tag_size)
+{
+	CdIccPrivate *priv = GET_PRIVATE (icc);
+	const guint8 *data = NULL;
+	const guint8 *entry;
+	guint32 i;
+	guint32 number_tags;
+	guint32 offset;
+	guint32 size;
+
+	number_tags = cd_icc_get_blob_tag_count (icc, &data);
+	for (i = 0; i < number_tags; i++) {
+		entry = data + CD_ICC_TAG_TABLE_OFFSET + 4 + (i * 12);
+		if (cd_buffer_read_uint32_be (entry) != sig)
+			continue;
+		offset = cd_buffer_read_uint32_be (entry + 4);
+		size = cd_buffer_read_uint32_be (entry + 8);
+
+		/* never slice past the end of the blob */
+		if (offset > g_bytes_get_size (priv->blob) ||
+		    size > g_bytes_get_size (priv->blob) - offset)
+			return FALSE;
+		*tag_offset = offset;
+		*tag_size = size;
+		return TRUE;
+	}
+	return FALSE;
+}
+
+/**
+ * cd_icc_get_tag_table:
+ * @icc: a #CdIcc instance.
+ * @error: A #GError or %NULL
+ *
+ * Returns the raw tag table of the profile as it exists on disk, one
+ * #CdIccTagEntry per tag, without copying or parsing any tag contents.
+ * This is only available when the profile was loaded with
+ * cd_icc_load_file() and no tag has been modified since.
+ *
+ * Return value: (transfer container) (element-type CdIccTagEntry): the
+ * tag table, or %NULL with @error set
+ *
+ * Since: 1.4.6
+ **/
+GArray *
+cd_icc_get_tag_table (CdIcc *icc, GError **error)
+{
+	GArray *table;
+	const guint8 *data = NULL;
+	const guint8 *entry;
+	guint32 i;
+	guint32 number_tags;
+
+	g_return_val_if_fail (CD_IS_ICC (icc), NULL);
+
+	number_tags = cd_icc_get_blob_tag_count (icc, &data);
+	if (number_tags == 0) {
+		g_set_error_literal (error,
+				     CD_ICC_ERROR,
+				     CD_ICC_ERROR_NO_DATA,
+				     "No raw tag table: profile was not "
+				     "loaded from a file or has been modified");
+		return NULL;
+	}
+	table = g_array_sized_new (FALSE, FALSE,
+				   sizeof (CdIccTagEntry), number_tags);
+	for (i = 0; i < number_tags; i++) {
+		CdIccTagEntry tmp;
+		entry = data + CD_ICC_TAG_TABLE_OFFSET + 4 + (i * 12);
+		cd_icc_uint32_to_str (GUINT32_FROM_BE (cd_buffer_read_uint32_be (entry)),
+				      tmp.signature);
+		tmp.offset = cd_buffer_read_uint32_be (entry + 4);
+		tmp.size = cd_buffer_read_uint32_be (entry + 8);
+		g_array_append_val (table, tmp);
+	}
+	return table;
+}
+
 /**
  * cd_icc_get_tag_data:
  * @icc: a #CdIcc instance.
@@ -740,6 +985,8 @@ cd_icc_get_tag_data (CdIcc *icc, const gchar *tag, GError **error)
 	cmsInt32Number tag_size;
 	cmsTagSignature sig;
 	gchar *tmp;
+	guint32 blob_offset;
+	guint32 blob_size;
 
 	/* read tag */
 	sig = cd_icc_str_to_tag (tag);
@@ -750,6 +997,16 @@ cd_icc_get_tag_data (CdIcc *icc, const gchar *tag, GError **error)
 			     "Tag '%s' was not valid", tag);
 		return NULL;
 	}
+
+	/* serve a zero-copy slice over the loaded blob when we still have
+	 * it; linked tags share the same offset so this also dedups them */
+	if (cd_icc_lookup_blob_tag (icc, sig, &blob_offset, &blob_size) &&
+	    blob_size > 0) {
+		return g_bytes_new_from_bytes (priv->blob,
+					       blob_offset, blob_size);
+	}
+
+	cd_icc_ensure_lcms_profile (icc);
 	tag_size = cmsReadRawTag (priv->lcms_profile, sig, NULL, 0);
 	if (tag_size == 0 || tag_size > 16 * 1024 * 1024) {
 		g_set_error (error,
@@ -784,6 +1041,8 @@ cd_icc_set_tag_data (CdIcc *icc, const gchar *tag, GBytes *data, GError **error)
 	cmsTagSignature sig;
 	gboolean ret;
 
+	cd_icc_ensure_lcms_profile (icc);
+
 	/* work around an LCMS API quirk in that you can't do cmsWriteRawTag()
 	 * if the tag already exists. Use the undocumented usage of
 	 * cmsWriteTag() to delete the tag first */
@@ -795,6 +1054,9 @@ cd_icc_set_tag_data (CdIcc *icc, const gchar *tag, GBytes *data, GError **error)
 			     "Tag '%s' was not valid", tag);
 		return FALSE;
 	}
+	g_clear_pointer (&priv->blob, g_bytes_unref);
+	g_clear_pointer (&priv->warnings_cache, g_array_unref);
+	cd_icc_named_color_pages_clear (icc);
 	cmsWriteTag (priv->lcms_profile, sig, NULL);
 	ret = cmsWriteRawTag (priv->lcms_profile,
 			      sig,
@@ -1046,8 +1308,8 @@ cd_icc_load_metadata_item (CdIcc *icc,
 
 	/* all okay */
 	g_hash_table_insert (priv->metadata,
-			     g_strdup (ascii_name),
-			     g_strdup (ascii_value));
+			     cd_icc_arena_strdup (icc, ascii_name),
+			     cd_icc_arena_strdup (icc, ascii_value));
 	return TRUE;
 }
 
@@ -1083,6 +1345,44 @@ cd_icc_load_metadata (CdIcc *icc, GError **error)
 	return TRUE;
 }
 
+/* parse one group of tags on first use; results are memoized so the
+ * accessors stay cheap and a checksum-only load touches almost nothing */
+static void
+cd_icc_ensure_parsed (CdIcc *icc, CdIccLoadFlags flag)
+{
+	CdIccPrivate *priv = GET_PRIVATE (icc);
+	g_autoptr(GError) error_local = NULL;
+
+	if (priv->lcms_profile == NULL)
+		return;
+	if ((priv->parsed & flag) > 0)
+		return;
+	priv->parsed |= flag;
+	switch (flag) {
+	case CD_ICC_LOAD_FLAGS_METADATA:
+		if (!cd_icc_load_metadata (icc, &error_local))
+			g_debug ("failed to parse metadata: %s", error_local->message);
+		break;
+	case CD_ICC_LOAD_FLAGS_NAMED_COLORS:
+		if (!cd_icc_load_named_colors (icc, &error_local))
+			g_debug ("failed to parse named colors: %s", error_local->message);
+		break;
+	case CD_ICC_LOAD_FLAGS_PRIMARIES:
+		if (priv->colorspace != CD_COLORSPACE_RGB)
+			break;
+		if (!cd_icc_load_primaries (icc, &error_local))
+			g_debug ("failed to parse primaries: %s", error_local->message);
+		break;
+	case CD_ICC_LOAD_FLAGS_CHARACTERIZATION:
+		if (!cd_icc_load_characterization_data (icc, &error_local))
+			g_debug ("failed to parse characterization data: %s",
+				 error_local->message);
+		break;
+	default:
+		break;
+	}
+}
+
 static gboolean
 cd_icc_load (CdIcc *icc, CdIccLoadFlags flags, GError **error)
 {
@@ -1091,6 +1391,8 @@ cd_icc_load (CdIcc *icc, CdIccLoadFlags flags, GError **error)
 	cmsProfileClassSignature profile_class;
 	guint i;
 
+	cd_perf_stats_add (CD_PERF_STAT_ICC_LOAD, 1);
+
 	/* get version */
 	priv->version = cmsGetProfileVersion (priv->lcms_profile);
 
@@ -1114,6 +1416,7 @@ cd_icc_load (CdIcc *icc, CdIccLoadFlags flags, GError **error)
 
 	/* read optional metadata? */
 	if ((flags & CD_ICC_LOAD_FLAGS_METADATA) > 0) {
+		priv->parsed |= CD_ICC_LOAD_FLAGS_METADATA;
 		if (!cd_icc_load_metadata (icc, error))
 			return FALSE;
 	}
@@ -1121,30 +1424,34 @@ cd_icc_load (CdIcc *icc, CdIccLoadFlags flags, GError **error)
 	/* get precooked profile ID if one exists */
 	priv->checksum = cd_icc_get_precooked_md5 (priv->lcms_profile);
 
-	/* read default translations */
-	cd_icc_get_description (icc, NULL, NULL);
-	cd_icc_get_copyright (icc, NULL, NULL);
-	cd_icc_get_manufacturer (icc, NULL, NULL);
-	cd_icc_get_model (icc, NULL, NULL);
+	/* the default translations are read on first access; only an
+	 * explicit request parses them all up-front */
 	if ((flags & CD_ICC_LOAD_FLAGS_TRANSLATIONS) > 0) {
+		cd_icc_get_description (icc, NULL, NULL);
+		cd_icc_get_copyright (icc, NULL, NULL);
+		cd_icc_get_manufacturer (icc, NULL, NULL);
+		cd_icc_get_model (icc, NULL, NULL);
 		/* FIXME: get the locale list from LCMS */
 	}
 
 	/* read named colors if the client cares */
 	if ((flags & CD_ICC_LOAD_FLAGS_NAMED_COLORS) > 0) {
+		priv->parsed |= CD_ICC_LOAD_FLAGS_NAMED_COLORS;
 		if (!cd_icc_load_named_colors (icc, error))
 			return FALSE;
 	}
 
 	/* read primaries if the client cares */
-	if ((flags & CD_ICC_LOAD_FLAGS_PRIMARIES) > 0 &&
-	    priv->colorspace == CD_COLORSPACE_RGB) {
-		if (!cd_icc_load_primaries (icc, error))
+	if ((flags & CD_ICC_LOAD_FLAGS_PRIMARIES) > 0) {
+		priv->parsed |= CD_ICC_LOAD_FLAGS_PRIMARIES;
+		if (priv->colorspace == CD_COLORSPACE_RGB &&
+		    !cd_icc_load_primaries (icc, error))
 			return FALSE;
 	}
 
 	/* read characterization data if the client cares */
 	if ((flags & CD_ICC_LOAD_FLAGS_CHARACTERIZATION) > 0) {
+		priv->parsed |= CD_ICC_LOAD_FLAGS_CHARACTERIZATION;
 		if (!cd_icc_load_characterization_data (icc, error))
 			return FALSE;
 	}
@@ -1203,16 +1510,773 @@ cd_icc_load_data (CdIcc *icc,
 	if (!cd_icc_load (icc, flags, error))
 		return FALSE;
 
+	/* the lcms profile already contains everything we would write back */
+	priv->dirty = CD_ICC_DIRTY_NONE;
+
 	/* calculate the data MD5 if there was no embedded profile */
 	if (priv->checksum == NULL &&
 	    (flags & CD_ICC_LOAD_FLAGS_FALLBACK_MD5) > 0) {
 		priv->checksum = g_compute_checksum_for_data (G_CHECKSUM_MD5,
 							      (const guchar *) data,
 							      data_len);
+		cd_perf_stats_add (CD_PERF_STAT_BYTES_HASHED, data_len);
+	}
+
+	/* the fast hash is cheap enough to always compute, and means callers
+	 * indexing many profiles do not have to pay for MD5 */
+	priv->checksum_fast = g_strdup_printf ("%016" G_GINT64_MODIFIER "x",
+					       cd_buffer_hash ((const guint8 *) data,
+							       data_len, 0));
+	return TRUE;
+}
+
+typedef struct {
+	CdIccLoadFlags	 flags;
+	GCancellable	*cancellable;
+	GPtrArray	*results;
+	GMutex		 mutex;
+	GCond		 cond;
+	guint		 pending;
+} CdIccLoadFilesHelper;
+
+static void
+cd_icc_load_files_func (gpointer data, gpointer user_data)
+{
+	CdIccLoadFilesHelper *helper = (CdIccLoadFilesHelper *) user_data;
+	GFile *file = G_FILE (data);
+	g_autoptr(CdIcc) icc = NULL;
+	g_autoptr(GError) error_local = NULL;
+
+	/* a failed parse just drops the file, like CdIccStore does */
+	if (!g_cancellable_is_cancelled (helper->cancellable)) {
+		icc = cd_icc_new ();
+		if (!cd_icc_load_file (icc, file, helper->flags,
+				       helper->cancellable, &error_local)) {
+			g_autofree gchar *path = g_file_get_path (file);
+			g_debug ("failed to load %s: %s",
+				 path, error_local->message);
+			g_clear_object (&icc);
+		}
+	}
+
+	g_mutex_lock (&helper->mutex);
+	if (icc != NULL)
+		g_ptr_array_add (helper->results, g_object_ref (icc));
+	if (--helper->pending == 0)
+		g_cond_signal (&helper->cond);
+	g_mutex_unlock (&helper->mutex);
+}
+
+/**
+ * cd_icc_load_files:
+ * @files: (element-type GFile): the files to load
+ * @flags: a set of #CdIccLoadFlags
+ * @cancellable: A #GCancellable or %NULL
+ * @error: A #GError or %NULL
+ *
+ * Loads several ICC profiles in parallel, using one lcms2 context per
+ * profile. Files that fail to parse are skipped with a debug message, in
+ * the same way CdIccStore skips invalid profiles during a scan, so the
+ * returned array may be smaller than @files.
+ *
+ * Return value: (transfer container) (element-type CdIcc): the loaded
+ * profiles in completion order, or %NULL if the operation was cancelled.
+ *
+ * Since: 1.4.6
+ **/
+GPtrArray *
+cd_icc_load_files (GPtrArray *files,
+		   CdIccLoadFlags flags,
+		   GCancellable *cancellable,
+		   GError **error)
+{
+	CdIccLoadFilesHelper helper;
+	GThreadPool *pool;
+	guint i;
+
+	g_return_val_if_fail (files != NULL, NULL);
+
+	helper.flags = flags;
+	helper.cancellable = cancellable;
+	helper.results = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
+	helper.pending = files->len;
+	g_mutex_init (&helper.mutex);
+	g_cond_init (&helper.cond);
+
+	pool = g_thread_pool_new (cd_icc_load_files_func,
+				  &helper,
+				  (gint) g_get_num_processors (),
+				  FALSE,
+				  error);
+	if (pool == NULL) {
+		g_ptr_array_unref (helper.results);
+		g_mutex_clear (&helper.mutex);
+		g_cond_clear (&helper.cond);
+		return NULL;
+	}
+	for (i = 0; i < files->len; i++)
+		g_thread_pool_push (pool, g_ptr_array_index (files, i), NULL);
+
+	/* wait for the last parse to finish */
+	g_mutex_lock (&helper.mutex);
+	while (helper.pending > 0)
+		g_cond_wait (&helper.cond, &helper.mutex);
+	g_mutex_unlock (&helper.mutex);
+	g_thread_pool_free (pool, FALSE, TRUE);
+	g_mutex_clear (&helper.mutex);
+	g_cond_clear (&helper.cond);
+
+	/* the work was thrown away */
+	if (g_cancellable_set_error_if_cancelled (cancellable, error)) {
+		g_ptr_array_unref (helper.results);
+		return NULL;
+	}
+	return helper.results;
+}
+
+/* bump when anything about the serialized layout changes; old caches are
+ * then treated as stale and silently regenerated */
+#define CD_ICC_CACHE_FORMAT_VERSION	1
+
+/* the keys for each CdIccMluc table, in enum order */
+static const gchar *cd_icc_cache_mluc_keys[CD_MLUC_LAST] = {
+	"mluc-description",
+	"mluc-copyright",
+	"mluc-manufacturer",
+	"mluc-model"
+};
+
+/* sentinel stored in the locale cache when a lookup found no data, so
+ * repeated misses do not re-run the MLUC machinery */
+static const gchar cd_icc_mluc_no_data[] = "";
+
+static GVariant *
+cd_icc_cache_build_dict (GHashTable *hash)
+{
+	GList *l;
+	GVariantBuilder builder;
+	g_autoptr(GList) keys = NULL;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{ss}"));
+	keys = g_hash_table_get_keys (hash);
+	for (l = keys; l != NULL; l = l->next) {
+		const gchar *value = g_hash_table_lookup (hash, l->data);
+		if (value == NULL || value == cd_icc_mluc_no_data)
+			continue;
+		g_variant_builder_add (&builder, "{ss}",
+				       (const gchar *) l->data, value);
+	}
+	return g_variant_builder_end (&builder);
+}
+
+static void
+cd_icc_cache_load_dict (CdIcc *icc, GHashTable *hash, GVariant *dict)
+{
+	GVariantIter iter;
+	const gchar *key;
+	const gchar *value;
+
+	g_variant_iter_init (&iter, dict);
+	while (g_variant_iter_next (&iter, "{&s&s}", &key, &value)) {
+		g_hash_table_insert (hash,
+				     cd_icc_arena_strdup (icc, key),
+				     cd_icc_arena_strdup (icc, value));
+	}
+}
+
+/**
+ * cd_icc_save_cache:
+ * @icc: a #CdIcc instance.
+ * @file: a #GFile to write the cache blob to
+ * @error: A #GError or %NULL
+ *
+ * Saves the parsed artifacts of the profile -- checksum, kind, colorspace,
+ * primaries, localized strings, metadata dictionary, named colors, VCGT
+ * table and warnings -- to a versioned binary sidecar file.
+ *
+ * The blob is keyed by the path, mtime and size of the source profile so
+ * cd_icc_load_cache() can later hydrate a #CdIcc with one read and skip
+ * parsing the profile with lcms2 entirely for unchanged files.
+ *
+ * Since: 1.4.6
+ **/
+gboolean
+cd_icc_save_cache (CdIcc *icc, GFile *file, GError **error)
+{
+	CdIccPrivate *priv = GET_PRIVATE (icc);
+	GStatBuf st;
+	GVariantBuilder builder;
+	guint i;
+	g_autoptr(GArray) warnings = NULL;
+	g_autoptr(GDateTime) created = NULL;
+	g_autoptr(GPtrArray) vcgt = NULL;
+	g_autoptr(GVariant) blob = NULL;
+
+	g_return_val_if_fail (CD_IS_ICC (icc), FALSE);
+	g_return_val_if_fail (G_IS_FILE (file), FALSE);
+	g_return_val_if_fail (priv->filename != NULL, FALSE);
+
+	/* the cache key is (path, mtime, size) of the source profile */
+	if (g_stat (priv->filename, &st) != 0) {
+		g_set_error (error,
+			     CD_ICC_ERROR,
+			     CD_ICC_ERROR_FAILED_TO_OPEN,
+			     "failed to stat %s", priv->filename);
+		return FALSE;
+	}
+
+	/* make sure everything we serialize has actually been parsed */
+	cd_icc_ensure_parsed (icc, CD_ICC_LOAD_FLAGS_METADATA);
+	cd_icc_ensure_parsed (icc, CD_ICC_LOAD_FLAGS_NAMED_COLORS);
+	cd_icc_ensure_parsed (icc, CD_ICC_LOAD_FLAGS_PRIMARIES);
+	cd_icc_ensure_parsed (icc, CD_ICC_LOAD_FLAGS_CHARACTERIZATION);
+	cd_icc_get_description (icc, NULL, NULL);
+	cd_icc_get_copyright (icc, NULL, NULL);
+	cd_icc_get_manufacturer (icc, NULL, NULL);
+	cd_icc_get_model (icc, NULL, NULL);
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+	g_variant_builder_add (&builder, "{sv}", "path",
+			       g_variant_new_string (priv->filename));
+	g_variant_builder_add (&builder, "{sv}", "mtime",
+			       g_variant_new_int64 (st.st_mtime));
+	g_variant_builder_add (&builder, "{sv}", "file-size",
+			       g_variant_new_uint64 (st.st_size));
+	g_variant_builder_add (&builder, "{sv}", "size",
+			       g_variant_new_uint32 (priv->size));
+	g_variant_builder_add (&builder, "{sv}", "version",
+			       g_variant_new_double (priv->version));
+	g_variant_builder_add (&builder, "{sv}", "kind",
+			       g_variant_new_uint32 (priv->kind));
+	g_variant_builder_add (&builder, "{sv}", "colorspace",
+			       g_variant_new_uint32 (priv->colorspace));
+	g_variant_builder_add (&builder, "{sv}", "temperature",
+			       g_variant_new_uint32 (priv->temperature));
+	g_variant_builder_add (&builder, "{sv}", "can-delete",
+			       g_variant_new_boolean (priv->can_delete));
+	if (priv->checksum != NULL) {
+		g_variant_builder_add (&builder, "{sv}", "checksum",
+				       g_variant_new_string (priv->checksum));
+	}
+	if (priv->checksum_fast != NULL) {
+		g_variant_builder_add (&builder, "{sv}", "checksum-fast",
+				       g_variant_new_string (priv->checksum_fast));
+	}
+	created = cd_icc_get_created (icc);
+	if (created != NULL) {
+		g_variant_builder_add (&builder, "{sv}", "creation-time",
+				       g_variant_new_int64 (g_date_time_to_unix (created)));
+	}
+	g_variant_builder_add (&builder, "{sv}", "red",
+			       g_variant_new ("(ddd)",
+					      priv->red.X, priv->red.Y, priv->red.Z));
+	g_variant_builder_add (&builder, "{sv}", "green",
+			       g_variant_new ("(ddd)",
+					      priv->green.X, priv->green.Y, priv->green.Z));
+	g_variant_builder_add (&builder, "{sv}", "blue",
+			       g_variant_new ("(ddd)",
+					      priv->blue.X, priv->blue.Y, priv->blue.Z));
+	g_variant_builder_add (&builder, "{sv}", "white",
+			       g_variant_new ("(ddd)",
+					      priv->white.X, priv->white.Y, priv->white.Z));
+	g_variant_builder_add (&builder, "{sv}", "metadata",
+			       cd_icc_cache_build_dict (priv->metadata));
+	for (i = 0; i < CD_MLUC_LAST; i++) {
+		g_variant_builder_add (&builder, "{sv}",
+				       cd_icc_cache_mluc_keys[i],
+				       cd_icc_cache_build_dict (priv->mluc_data[i]));
+	}
+	if (priv->characterization_data != NULL) {
+		g_variant_builder_add (&builder, "{sv}", "characterization-data",
+				       g_variant_new_string (priv->characterization_data));
+	}
+
+	/* named colors */
+	if (priv->named_colors->len > 0) {
+		GVariantBuilder nc_builder;
+		g_variant_builder_init (&nc_builder, G_VARIANT_TYPE ("a(sddd)"));
+		for (i = 0; i < priv->named_colors->len; i++) {
+			CdColorSwatch *swatch = g_ptr_array_index (priv->named_colors, i);
+			g_variant_builder_add (&nc_builder, "(sddd)",
+					       swatch->name,
+					       swatch->value.L,
+					       swatch->value.a,
+					       swatch->value.b);
+		}
+		g_variant_builder_add (&builder, "{sv}", "named-colors",
+				       g_variant_builder_end (&nc_builder));
+	}
+
+	/* the gamma table at the size the session helpers ask for */
+	vcgt = cd_icc_get_vcgt (icc, 256, NULL);
+	if (vcgt != NULL) {
+		GVariantBuilder vcgt_builder;
+		g_variant_builder_init (&vcgt_builder, G_VARIANT_TYPE ("a(ddd)"));
+		for (i = 0; i < vcgt->len; i++) {
+			CdColorRGB *rgb = g_ptr_array_index (vcgt, i);
+			g_variant_builder_add (&vcgt_builder, "(ddd)",
+					       rgb->R, rgb->G, rgb->B);
+		}
+		g_variant_builder_add (&builder, "{sv}", "vcgt",
+				       g_variant_builder_end (&vcgt_builder));
+	}
+
+	/* warnings are expensive to compute as they run transforms */
+	warnings = cd_icc_get_warnings (icc);
+	if (warnings != NULL) {
+		GVariantBuilder warn_builder;
+		g_variant_builder_init (&warn_builder, G_VARIANT_TYPE ("au"));
+		for (i = 0; i < warnings->len; i++) {
+			g_variant_builder_add (&warn_builder, "u",
+					       g_array_index (warnings, CdProfileWarning, i));
+		}
+		g_variant_builder_add (&builder, "{sv}", "warnings",
+				       g_variant_builder_end (&warn_builder));
+	}
+
+	/* write out the serialized form in one go */
+	blob = g_variant_ref_sink (g_variant_new ("(u@a{sv})",
+						  CD_ICC_CACHE_FORMAT_VERSION,
+						  g_variant_builder_end (&builder)));
+	return g_file_replace_contents (file,
+					g_variant_get_data (blob),
+					g_variant_get_size (blob),
+					NULL,
+					FALSE,
+					G_FILE_CREATE_REPLACE_DESTINATION,
+					NULL,
+					NULL,
+					error);
+}
+
+/* hydrate the parsed state from an already validated cache dictionary */
+static void
+cd_icc_load_cache_dict (CdIcc *icc, GVariant *dict)
+{
+	CdIccPrivate *priv = GET_PRIVATE (icc);
+	const gchar *tmp_str;
+	gdouble val[3];
+	gint64 tmp_int64;
+	guint i;
+	guint32 tmp_u32;
+	g_autoptr(GVariant) section = NULL;
+
+	/* scalar state */
+	if (g_variant_lookup (dict, "path", "&s", &tmp_str))
+		priv->filename = g_strdup (tmp_str);
+	g_variant_lookup (dict, "size", "u", &priv->size);
+	g_variant_lookup (dict, "version", "d", &priv->version);
+	if (g_variant_lookup (dict, "kind", "u", &tmp_u32))
+		priv->kind = tmp_u32;
+	if (g_variant_lookup (dict, "colorspace", "u", &tmp_u32))
+		priv->colorspace = tmp_u32;
+	if (g_variant_lookup (dict, "temperature", "u", &tmp_u32))
+		priv->temperature = tmp_u32;
+	g_variant_lookup (dict, "can-delete", "b", &priv->can_delete);
+	if (g_variant_lookup (dict, "checksum", "&s", &tmp_str))
+		priv->checksum = g_strdup (tmp_str);
+	if (g_variant_lookup (dict, "checksum-fast", "&s", &tmp_str))
+		priv->checksum_fast = g_strdup (tmp_str);
+	if (g_variant_lookup (dict, "creation-time", "x", &tmp_int64))
+		priv->creation_time = tmp_int64;
+	if (g_variant_lookup (dict, "red", "(ddd)", &val[0], &val[1], &val[2]))
+		cd_color_xyz_set (&priv->red, val[0], val[1], val[2]);
+	if (g_variant_lookup (dict, "green", "(ddd)", &val[0], &val[1], &val[2]))
+		cd_color_xyz_set (&priv->green, val[0], val[1], val[2]);
+	if (g_variant_lookup (dict, "blue", "(ddd)", &val[0], &val[1], &val[2]))
+		cd_color_xyz_set (&priv->blue, val[0], val[1], val[2]);
+	if (g_variant_lookup (dict, "white", "(ddd)", &val[0], &val[1], &val[2]))
+		cd_color_xyz_set (&priv->white, val[0], val[1], val[2]);
+	if (g_variant_lookup (dict, "characterization-data", "&s", &tmp_str))
+		priv->characterization_data = g_strdup (tmp_str);
+
+	/* string dictionaries */
+	section = g_variant_lookup_value (dict, "metadata",
+					  G_VARIANT_TYPE ("a{ss}"));
+	if (section != NULL) {
+		cd_icc_cache_load_dict (icc, priv->metadata, section);
+		g_clear_pointer (&section, g_variant_unref);
+	}
+	for (i = 0; i < CD_MLUC_LAST; i++) {
+		section = g_variant_lookup_value (dict,
+						  cd_icc_cache_mluc_keys[i],
+						  G_VARIANT_TYPE ("a{ss}"));
+		if (section != NULL) {
+			cd_icc_cache_load_dict (icc, priv->mluc_data[i], section);
+			g_clear_pointer (&section, g_variant_unref);
+		}
+	}
+
+	/* named colors go into one arena slab as in cd_icc_load_named_colors() */
+	section = g_variant_lookup_value (dict, "named-colors",
+					  G_VARIANT_TYPE ("a(sddd)"));
+	if (section != NULL) {
+		CdColorSwatch *swatches;
+		GVariantIter iter;
+		const gchar *name;
+		gsize n;
+
+		g_variant_iter_init (&iter, section);
+		n = g_variant_iter_n_children (&iter);
+		swatches = cd_icc_arena_alloc (icc, n * sizeof (CdColorSwatch));
+		while (g_variant_iter_next (&iter, "(&sddd)", &name,
+					    &val[0], &val[1], &val[2])) {
+			CdColorSwatch *swatch = &swatches[priv->named_colors->len];
+			swatch->name = cd_icc_arena_strdup (icc, name);
+			cd_color_lab_set (&swatch->value, val[0], val[1], val[2]);
+			g_ptr_array_add (priv->named_colors, swatch);
+		}
+		g_clear_pointer (&section, g_variant_unref);
+	}
+
+	/* pre-seed the VCGT cache */
+	section = g_variant_lookup_value (dict, "vcgt",
+					  G_VARIANT_TYPE ("a(ddd)"));
+	if (section != NULL) {
+		CdColorRGB *slab;
+		GVariantIter iter;
+		gsize n;
+
+		g_variant_iter_init (&iter, section);
+		n = g_variant_iter_n_children (&iter);
+		if (n > 0) {
+			slab = g_new (CdColorRGB, n);
+			g_ptr_array_add (priv->vcgt_slabs, slab);
+			priv->vcgt_cache = g_ptr_array_new ();
+			priv->vcgt_cache_size = n;
+			i = 0;
+			while (g_variant_iter_next (&iter, "(ddd)",
+						    &val[0], &val[1], &val[2])) {
+				cd_color_rgb_set (&slab[i], val[0], val[1], val[2]);
+				g_ptr_array_add (priv->vcgt_cache, &slab[i]);
+				i++;
+			}
+		}
+		g_clear_pointer (&section, g_variant_unref);
+	}
+
+	/* warnings */
+	section = g_variant_lookup_value (dict, "warnings",
+					  G_VARIANT_TYPE ("au"));
+	if (section != NULL) {
+		GVariantIter iter;
+		guint32 warning;
+
+		priv->warnings_cache = g_array_new (FALSE, FALSE,
+						    sizeof (CdProfileWarning));
+		g_variant_iter_init (&iter, section);
+		while (g_variant_iter_next (&iter, "u", &warning))
+			g_array_append_val (priv->warnings_cache, warning);
+		g_clear_pointer (&section, g_variant_unref);
+	}
+
+	/* everything the accessors serve is now populated */
+	priv->parsed |= CD_ICC_LOAD_FLAGS_METADATA |
+			CD_ICC_LOAD_FLAGS_NAMED_COLORS |
+			CD_ICC_LOAD_FLAGS_PRIMARIES |
+			CD_ICC_LOAD_FLAGS_CHARACTERIZATION;
+	priv->dirty = CD_ICC_DIRTY_NONE;
+}
+
+/**
+ * cd_icc_load_cache:
+ * @icc: a #CdIcc instance.
+ * @file: a #GFile written by cd_icc_save_cache()
+ * @error: A #GError or %NULL
+ *
+ * Hydrates the profile from a binary sidecar cache, skipping lcms2
+ * entirely. The cache is only used when the path, mtime and size recorded
+ * in the blob still match the source profile; a stale or incompatible
+ * cache fails with %CD_ICC_ERROR_FAILED_TO_PARSE and the caller should
+ * fall back to cd_icc_load_file().
+ *
+ * Accessors that need raw tag data, for instance cd_icc_save_data() or
+ * cd_icc_get_tag_data(), transparently open the source profile on first
+ * use.
+ *
+ * Since: 1.4.6
+ **/
+gboolean
+cd_icc_load_cache (CdIcc *icc, GFile *file, GError **error)
+{
+	CdIccPrivate *priv = GET_PRIVATE (icc);
+	GStatBuf st;
+	const gchar *path = NULL;
+	gint64 mtime = 0;
+	gsize length = 0;
+	guint32 fmt = 0;
+	guint64 file_size = 0;
+	g_autofree gchar *data = NULL;
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GVariant) blob = NULL;
+	g_autoptr(GVariant) dict = NULL;
+
+	g_return_val_if_fail (CD_IS_ICC (icc), FALSE);
+	g_return_val_if_fail (G_IS_FILE (file), FALSE);
+	g_return_val_if_fail (priv->lcms_profile == NULL, FALSE);
+
+	/* one read for the whole blob */
+	if (!g_file_load_contents (file, NULL, &data, &length,
+				   NULL, &error_local)) {
+		g_set_error (error,
+			     CD_ICC_ERROR,
+			     CD_ICC_ERROR_FAILED_TO_OPEN,
+			     "failed to load cache: %s",
+			     error_local->message);
+		return FALSE;
+	}
+	blob = g_variant_new_from_data (G_VARIANT_TYPE ("(ua{sv})"),
+					data, length, FALSE,
+					g_free, data);
+	data = NULL;
+	blob = g_variant_ref_sink (blob);
+	g_variant_get (blob, "(u@a{sv})", &fmt, &dict);
+	if (fmt != CD_ICC_CACHE_FORMAT_VERSION) {
+		g_set_error (error,
+			     CD_ICC_ERROR,
+			     CD_ICC_ERROR_FAILED_TO_PARSE,
+			     "cache format %u not supported", fmt);
+		return FALSE;
+	}
+
+	/* check the source profile has not changed underneath us */
+	if (!g_variant_lookup (dict, "path", "&s", &path) ||
+	    !g_variant_lookup (dict, "mtime", "x", &mtime) ||
+	    !g_variant_lookup (dict, "file-size", "t", &file_size)) {
+		g_set_error_literal (error,
+				     CD_ICC_ERROR,
+				     CD_ICC_ERROR_FAILED_TO_PARSE,
+				     "cache has no source key");
+		return FALSE;
+	}
+	if (g_stat (path, &st) != 0 ||
+	    st.st_mtime != (time_t) mtime ||
+	    (guint64) st.st_size != file_size) {
+		g_set_error (error,
+			     CD_ICC_ERROR,
+			     CD_ICC_ERROR_FAILED_TO_PARSE,
+			     "cache for %s is stale", path);
+		return FALSE;
+	}
+	cd_icc_load_cache_dict (icc, dict);
+	return TRUE;
+}
+
+/**
+ * cd_icc_load_cache_bytes:
+ * @icc: a #CdIcc instance.
+ * @data: a cache blob written by cd_icc_save_cache()
+ * @error: A #GError or %NULL
+ *
+ * Hydrates the profile from an in-memory cache blob, for instance one
+ * compiled into a #GResource next to the profile itself. Unlike
+ * cd_icc_load_cache() no staleness check is done against the source
+ * file; the caller guarantees the record matches the shipped profile.
+ *
+ * Since: 1.4.6
+ **/
+gboolean
+cd_icc_load_cache_bytes (CdIcc *icc, GBytes *data, GError **error)
+{
+	CdIccPrivate *priv = GET_PRIVATE (icc);
+	guint32 fmt = 0;
+	g_autoptr(GVariant) blob = NULL;
+	g_autoptr(GVariant) dict = NULL;
+
+	g_return_val_if_fail (CD_IS_ICC (icc), FALSE);
+	g_return_val_if_fail (data != NULL, FALSE);
+	g_return_val_if_fail (priv->lcms_profile == NULL, FALSE);
+
+	blob = g_variant_new_from_data (G_VARIANT_TYPE ("(ua{sv})"),
+					g_bytes_get_data (data, NULL),
+					g_bytes_get_size (data),
+					FALSE,
+					(GDestroyNotify) g_bytes_unref,
+					g_bytes_ref (data));
+	blob = g_variant_ref_sink (blob);
+	g_variant_get (blob, "(u@a{sv})", &fmt, &dict);
+	if (fmt != CD_ICC_CACHE_FORMAT_VERSION) {
+		g_set_error (error,
+			     CD_ICC_ERROR,
+			     CD_ICC_ERROR_FAILED_TO_PARSE,
+			     "cache format %u not supported", fmt);
+		return FALSE;
+	}
+	cd_icc_load_cache_dict (icc, dict);
+	return TRUE;
+}
+
+/* parse a textDescriptionType or multiLocalizedUnicodeType tag without
+ * going through lcms2 */
+static gchar *
+cd_icc_peek_parse_desc (const guint8 *data, gsize data_len)
+{
+	guint32 type;
+
+	if (data_len < 16)
+		return NULL;
+	type = cd_buffer_read_uint32_be (data);
+
+	/* ICCv2 'desc' */
+	if (type == 0x64657363) {
+		guint32 len = cd_buffer_read_uint32_be (data + 8);
+		if (len == 0 || len > data_len - 12)
+			return NULL;
+		return g_strndup ((const gchar *) data + 12, len);
+	}
+
+	/* ICCv4 'mluc' */
+	if (type == 0x6d6c7563) {
+		guint32 count = cd_buffer_read_uint32_be (data + 8);
+		guint32 rec_size = cd_buffer_read_uint32_be (data + 12);
+		guint32 str_len = 0;
+		guint32 str_offset = 0;
+		guint i;
+		if (count == 0 || rec_size < 12)
+			return NULL;
+		for (i = 0; i < count; i++) {
+			gsize rec = 16 + (gsize) i * rec_size;
+			guint16 language_code;
+			guint16 country_code;
+			if (rec + 12 > data_len)
+				return NULL;
+			language_code = cd_buffer_read_uint16_be (data + rec);
+			country_code = cd_buffer_read_uint16_be (data + rec + 2);
+			/* take the first record, but prefer en then en_US */
+			if (i == 0 || language_code == 0x656e) {
+				str_len = cd_buffer_read_uint32_be (data + rec + 4);
+				str_offset = cd_buffer_read_uint32_be (data + rec + 8);
+				if (language_code == 0x656e && country_code == 0x5553)
+					break;
+			}
+		}
+		if (str_len == 0 ||
+		    str_offset > data_len ||
+		    str_len > data_len - str_offset)
+			return NULL;
+		return g_convert ((const gchar *) data + str_offset, str_len,
+				  "UTF-8", "UTF-16BE", NULL, NULL, NULL);
+	}
+	return NULL;
+}
+
+/**
+ * cd_icc_peek_data:
+ * @data: (array length=data_len): binary data
+ * @data_len: Length of @data
+ * @peek: (out caller-allocates): a #CdIccPeek to fill in
+ * @error: A #GError or %NULL
+ *
+ * Reads the profile header and the description tag directly from the
+ * binary data without creating an lcms2 profile object. This is around
+ * two orders of magnitude cheaper than cd_icc_load_data() and is intended
+ * for indexing large numbers of profiles where only the checksum,
+ * description, kind and colorspace are needed.
+ *
+ * Use cd_icc_peek_clear() to free the strings when done.
+ *
+ * Return value: %TRUE if the header was parsed.
+ *
+ * Since: 1.4.6
+ **/
+gboolean
+cd_icc_peek_data (const guint8 *data,
+		  gsize data_len,
+		  CdIccPeek *peek,
+		  GError **error)
+{
+	cmsColorSpaceSignature colorspace;
+	cmsProfileClassSignature profile_class;
+	gboolean checksum_set = FALSE;
+	guint32 tag_count;
+	guint i;
+
+	g_return_val_if_fail (data != NULL, FALSE);
+	g_return_val_if_fail (peek != NULL, FALSE);
+
+	memset (peek, 0, sizeof (CdIccPeek));
+
+	/* ensure we have the header and the tag count */
+	if (data_len < 0x84) {
+		g_set_error_literal (error,
+				     CD_ICC_ERROR,
+				     CD_ICC_ERROR_FAILED_TO_PARSE,
+				     "icc was not valid (file size too small)");
+		return FALSE;
+	}
+
+	/* fixed offsets from the ICC specification */
+	peek->size = cd_buffer_read_uint32_be (data);
+	peek->version = data[8] +
+			((data[9] >> 4) & 0x0f) / 10.f +
+			(data[9] & 0x0f) / 100.f;
+	profile_class = cd_buffer_read_uint32_be (data + 12);
+	for (i = 0; map_profile_kind[i].colord != CD_PROFILE_KIND_LAST; i++) {
+		if (map_profile_kind[i].lcms == profile_class) {
+			peek->kind = map_profile_kind[i].colord;
+			break;
+		}
+	}
+	colorspace = cd_buffer_read_uint32_be (data + 16);
+	for (i = 0; map_colorspace[i].colord != CD_COLORSPACE_LAST; i++) {
+		if (map_colorspace[i].lcms == colorspace) {
+			peek->colorspace = map_colorspace[i].colord;
+			break;
+		}
+	}
+
+	/* the precooked profile ID, if the profile has one */
+	for (i = 0; i < 16; i++) {
+		if (data[0x54 + i] != 0) {
+			checksum_set = TRUE;
+			break;
+		}
+	}
+	if (checksum_set) {
+		GString *str = g_string_new ("");
+		for (i = 0; i < 16; i++)
+			g_string_append_printf (str, "%02x", data[0x54 + i]);
+		peek->checksum = g_string_free (str, FALSE);
+	}
+
+	/* walk the tag table looking for the description */
+	tag_count = cd_buffer_read_uint32_be (data + 0x80);
+	for (i = 0; i < tag_count; i++) {
+		gsize entry = 0x84 + (gsize) i * 12;
+		guint32 tag_offset;
+		guint32 tag_size;
+		if (entry + 12 > data_len)
+			break;
+		if (cd_buffer_read_uint32_be (data + entry) != cmsSigProfileDescriptionTag)
+			continue;
+		tag_offset = cd_buffer_read_uint32_be (data + entry + 4);
+		tag_size = cd_buffer_read_uint32_be (data + entry + 8);
+		if (tag_offset > data_len || tag_size > data_len - tag_offset)
+			break;
+		peek->description = cd_icc_peek_parse_desc (data + tag_offset,
+							    tag_size);
+		break;
 	}
 	return TRUE;
 }
 
+/**
+ * cd_icc_peek_clear:
+ * @peek: a #CdIccPeek
+ *
+ * Frees the strings inside a #CdIccPeek filled in by cd_icc_peek_data().
+ * The structure itself is owned by the caller and is not freed.
+ *
+ * Since: 1.4.6
+ **/
+void
+cd_icc_peek_clear (CdIccPeek *peek)
+{
+	g_return_if_fail (peek != NULL);
+	g_clear_pointer (&peek->checksum, g_free);
+	g_clear_pointer (&peek->description, g_free);
+}
+
 static gboolean
 cd_util_write_dict_entry (cmsHANDLE dict,
 			  const gchar *key,
@@ -1551,34 +2615,21 @@ cd_icc_serialize_profile (CdIcc *icc, GError **error)
 	return g_bytes_new (data_tmp, length);
 }
 
-/**
- * cd_icc_save_data:
- * @icc: a #CdIcc instance.
- * @flags: a set of #CdIccSaveFlags
- * @error: A #GError or %NULL
- *
- * Saves an ICC profile to an allocated memory location.
- *
- * Return vale: A #GBytes structure, or %NULL for error
- *
- * Since: 1.0.2
- **/
-GBytes *
-cd_icc_save_data (CdIcc *icc,
-		  CdIccSaveFlags flags,
-		  GError **error)
+/* write back any modified tag groups and recompute the profile ID, so
+ * the lcms object is ready to be serialized */
+static gboolean
+cd_icc_save_prepare (CdIcc *icc, CdIccSaveFlags flags, GError **error)
 {
 	CdIccPrivate *priv = GET_PRIVATE (icc);
 	cmsHANDLE dict = NULL;
 	const gchar *key;
 	const gchar *value;
 	gboolean ret = FALSE;
-	GBytes *data = NULL;
 	GList *l;
 	guint i;
 	g_autoptr(GList) md_keys = NULL;
 
-	g_return_val_if_fail (CD_IS_ICC (icc), NULL);
+	cd_icc_ensure_lcms_profile (icc);
 
 	/* convert profile kind */
 	for (i = 0; map_profile_kind[i].colord != CD_PROFILE_KIND_LAST; i++) {
@@ -1602,8 +2653,10 @@ cd_icc_save_data (CdIcc *icc,
 	if (priv->version > 0.0)
 		cmsSetProfileVersion (priv->lcms_profile, priv->version);
 
-	/* save metadata */
-	if (g_hash_table_size (priv->metadata) != 0) {
+	/* save metadata, if modified since load */
+	if ((priv->dirty & CD_ICC_DIRTY_METADATA) == 0) {
+		/* nothing to do */
+	} else if (g_hash_table_size (priv->metadata) != 0) {
 		dict = cmsDictAlloc (priv->context_lcms);
 		md_keys = g_hash_table_get_keys (priv->metadata);
 		if (md_keys != NULL) {
@@ -1625,8 +2678,10 @@ cd_icc_save_data (CdIcc *icc,
 			goto out;
 	}
 
-	/* save characterization data */
-	if (priv->characterization_data != NULL) {
+	/* save characterization data, if modified since load */
+	if ((priv->dirty & CD_ICC_DIRTY_CHARACTERIZATION) == 0) {
+		/* nothing to do */
+	} else if (priv->characterization_data != NULL) {
 		ret = cd_util_write_tag_ascii (icc,
 					       cmsSigCharTargetTag,
 					       priv->characterization_data,
@@ -1639,8 +2694,11 @@ cd_icc_save_data (CdIcc *icc,
 			goto out;
 	}
 
-	/* save translations */
-	if (priv->version < 4.0) {
+	/* save translations, if modified since load; regenerating the
+	 * MLUC tags is by far the most expensive part of a save */
+	if ((priv->dirty & CD_ICC_DIRTY_TRANSLATIONS) == 0) {
+		/* nothing to do */
+	} else if (priv->version < 4.0) {
 		/* v2 profiles cannot have a mluc type for cmsSigProfileDescriptionTag
 		 * so use the non-standard Apple extension cmsSigProfileDescriptionTagML
 		 * and only write a en_US version for the description */
@@ -1711,14 +2769,16 @@ cd_icc_save_data (CdIcc *icc,
 		 */
 		struct tm creation_time;
 		cmsICCHeader *header;
+		GBytes *data;
 		g_autoptr(GByteArray) mutable_data = NULL;
 
 		data = cd_icc_serialize_profile (icc, error);
-		if (data == NULL)
+		if (data == NULL) {
+			ret = FALSE;
 			goto out;
+		}
 
 		mutable_data = g_bytes_unref_to_array (data);
-		data = NULL;
 
 		if (!gmtime_r (&priv->creation_time, &creation_time)) {
 			g_set_error (error,
@@ -1727,6 +2787,7 @@ cd_icc_save_data (CdIcc *icc,
 				     "failed to translate creation time: %s (%i)",
 				     g_strerror (errno),
 				     errno);
+			ret = FALSE;
 			goto out;
 		}
 		header = (cmsICCHeader*)mutable_data->data;
@@ -1748,10 +2809,39 @@ cd_icc_save_data (CdIcc *icc,
 				     "failed to compute profile id");
 		goto out;
 	}
-	data = cd_icc_serialize_profile (icc, error);
 out:
 	if (dict != NULL)
 		cmsDictFree (dict);
+	return ret;
+}
+
+/**
+ * cd_icc_save_data:
+ * @icc: a #CdIcc instance.
+ * @flags: a set of #CdIccSaveFlags
+ * @error: A #GError or %NULL
+ *
+ * Saves an ICC profile to an allocated memory location.
+ *
+ * Return vale: A #GBytes structure, or %NULL for error
+ *
+ * Since: 1.0.2
+ **/
+GBytes *
+cd_icc_save_data (CdIcc *icc,
+		  CdIccSaveFlags flags,
+		  GError **error)
+{
+	CdIccPrivate *priv = GET_PRIVATE (icc);
+	GBytes *data;
+
+	g_return_val_if_fail (CD_IS_ICC (icc), NULL);
+
+	if (!cd_icc_save_prepare (icc, flags, error))
+		return NULL;
+	data = cd_icc_serialize_profile (icc, error);
+	if (data != NULL)
+		priv->dirty = CD_ICC_DIRTY_NONE;
 	return data;
 }
 
@@ -1760,8 +2850,8 @@ out:
  * @icc: a #CdIcc instance.
  *
  * Gets any characterization data used to build the profile.
- * This function will only return results if the profile was loaded with the
- * %CD_ICC_LOAD_FLAGS_CHARACTERIZATION flag.
+ * If the profile was not loaded with the %CD_ICC_LOAD_FLAGS_CHARACTERIZATION flag then
+ * the data is parsed on first access and cached.
  *
  * Return value: TI3 string data
  *
@@ -1772,6 +2862,7 @@ cd_icc_get_characterization_data (CdIcc *icc)
 {
 	CdIccPrivate *priv = GET_PRIVATE (icc);
 	g_return_val_if_fail (CD_IS_ICC (icc), NULL);
+	cd_icc_ensure_parsed (icc, CD_ICC_LOAD_FLAGS_CHARACTERIZATION);
 	return priv->characterization_data;
 }
 
@@ -1791,6 +2882,7 @@ cd_icc_set_characterization_data (CdIcc *icc, const gchar *data)
 	g_return_if_fail (CD_IS_ICC (icc));
 	g_free (priv->characterization_data);
 	priv->characterization_data = g_strdup (data);
+	priv->dirty |= CD_ICC_DIRTY_CHARACTERIZATION;
 }
 
 /**
@@ -1807,6 +2899,79 @@ cd_icc_set_characterization_data (CdIcc *icc, const gchar *data)
  *
  * Since: 0.1.32
  **/
+/* adapts a GOutputStream to the lcms2 IO handler interface so a profile
+ * can be serialized in one pass without materializing it in memory */
+typedef struct {
+	GOutputStream		*stream;
+	GCancellable		*cancellable;
+	GError			**error;
+} CdIccStreamHelper;
+
+static cmsUInt32Number
+cd_icc_save_file_read_cb (cmsIOHANDLER *io,
+			  void *buffer,
+			  cmsUInt32Number size,
+			  cmsUInt32Number count)
+{
+	/* never called when saving */
+	return 0;
+}
+
+static cmsBool
+cd_icc_save_file_seek_cb (cmsIOHANDLER *io, cmsUInt32Number offset)
+{
+	CdIccStreamHelper *helper = (CdIccStreamHelper *) io->stream;
+
+	if (*helper->error != NULL)
+		return FALSE;
+	if (!G_IS_SEEKABLE (helper->stream) ||
+	    !g_seekable_can_seek (G_SEEKABLE (helper->stream)))
+		return FALSE;
+	return g_seekable_seek (G_SEEKABLE (helper->stream),
+				offset,
+				G_SEEK_SET,
+				helper->cancellable,
+				helper->error);
+}
+
+static cmsUInt32Number
+cd_icc_save_file_tell_cb (cmsIOHANDLER *io)
+{
+	return io->UsedSpace;
+}
+
+static cmsBool
+cd_icc_save_file_write_cb (cmsIOHANDLER *io,
+			   cmsUInt32Number size,
+			   const void *buffer)
+{
+	CdIccStreamHelper *helper = (CdIccStreamHelper *) io->stream;
+	gsize bytes_written = 0;
+
+	if (size == 0)
+		return TRUE;
+
+	/* a previous write already failed */
+	if (*helper->error != NULL)
+		return FALSE;
+	if (!g_output_stream_write_all (helper->stream,
+					buffer,
+					size,
+					&bytes_written,
+					helper->cancellable,
+					helper->error))
+		return FALSE;
+	io->UsedSpace += size;
+	return TRUE;
+}
+
+static cmsBool
+cd_icc_save_file_close_cb (cmsIOHANDLER *io)
+{
+	/* the GOutputStream is closed by the caller */
+	return TRUE;
+}
+
 gboolean
 cd_icc_save_file (CdIcc *icc,
 		  GFile *file,
@@ -1814,33 +2979,63 @@ cd_icc_save_file (CdIcc *icc,
 		  GCancellable *cancellable,
 		  GError **error)
 {
-	gboolean ret;
-	g_autoptr(GBytes) data = NULL;
+	CdIccPrivate *priv = GET_PRIVATE (icc);
+	CdIccStreamHelper helper;
+	cmsIOHANDLER io;
 	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GFileOutputStream) stream = NULL;
 
 	g_return_val_if_fail (CD_IS_ICC (icc), FALSE);
 	g_return_val_if_fail (G_IS_FILE (file), FALSE);
 
-	/* get data */
-	data = cd_icc_save_data (icc, flags, error);
-	if (data == NULL)
+	/* write back any modified tags */
+	if (!cd_icc_save_prepare (icc, flags, error))
 		return FALSE;
 
 	/* ensure parent directories exist */
 	if (!cd_icc_save_file_mkdir_parents (file, error))
 		return FALSE;
 
-	/* actually write file */
-	ret = g_file_replace_contents (file,
-				       g_bytes_get_data (data, NULL),
-				       g_bytes_get_size (data),
-				       NULL,
-				       FALSE,
-				       G_FILE_CREATE_NONE,
-				       NULL,
-				       cancellable,
-				       &error_local);
-	if (!ret) {
+	/* stream the profile out in a single serialization pass; the
+	 * replace semantics write to a temporary file that is renamed over
+	 * the target on close, so readers never see a partial profile */
+	stream = g_file_replace (file,
+				 NULL,
+				 FALSE,
+				 G_FILE_CREATE_NONE,
+				 cancellable,
+				 &error_local);
+	if (stream == NULL) {
+		g_set_error (error,
+			     CD_ICC_ERROR,
+			     CD_ICC_ERROR_FAILED_TO_SAVE,
+			     "failed to save ICC file: %s",
+			     error_local->message);
+		return FALSE;
+	}
+	helper.stream = G_OUTPUT_STREAM (stream);
+	helper.cancellable = cancellable;
+	helper.error = &error_local;
+	memset (&io, 0, sizeof (io));
+	io.ContextID = priv->context_lcms;
+	io.stream = &helper;
+	io.Read = cd_icc_save_file_read_cb;
+	io.Seek = cd_icc_save_file_seek_cb;
+	io.Tell = cd_icc_save_file_tell_cb;
+	io.Write = cd_icc_save_file_write_cb;
+	io.Close = cd_icc_save_file_close_cb;
+	if (cmsSaveProfileToIOhandler (priv->lcms_profile, &io) == 0) {
+		g_set_error (error,
+			     CD_ICC_ERROR,
+			     CD_ICC_ERROR_FAILED_TO_SAVE,
+			     "failed to save ICC file: %s",
+			     error_local != NULL ?
+				error_local->message : "serialize failed");
+		return FALSE;
+	}
+	if (!g_output_stream_close (G_OUTPUT_STREAM (stream),
+				    cancellable,
+				    &error_local)) {
 		g_set_error (error,
 			     CD_ICC_ERROR,
 			     CD_ICC_ERROR_FAILED_TO_SAVE,
@@ -1848,6 +3043,7 @@ cd_icc_save_file (CdIcc *icc,
 			     error_local->message);
 		return FALSE;
 	}
+	priv->dirty = CD_ICC_DIRTY_NONE;
 	return TRUE;
 }
 
@@ -1932,26 +3128,60 @@ cd_icc_load_file (CdIcc *icc,
 	g_return_val_if_fail (CD_IS_ICC (icc), FALSE);
 	g_return_val_if_fail (G_IS_FILE (file), FALSE);
 
-	/* load files */
-	ret = g_file_load_contents (file, cancellable, &data, &length,
-				    NULL, &error_local);
-	if (!ret) {
-		g_set_error (error,
-			     CD_ICC_ERROR,
-			     CD_ICC_ERROR_FAILED_TO_OPEN,
-			     "failed to load file: %s",
-			     error_local->message);
-		return FALSE;
+	/* map the file read-only so the page cache is shared between all
+	 * processes with the profile open, falling back to a normal read
+	 * for non-native files */
+	if ((flags & CD_ICC_LOAD_FLAGS_MMAP) > 0) {
+		g_autofree gchar *path = g_file_get_path (file);
+		if (path != NULL) {
+			priv->mapped_file = g_mapped_file_new (path, FALSE,
+							       &error_local);
+			if (priv->mapped_file == NULL) {
+				g_set_error (error,
+					     CD_ICC_ERROR,
+					     CD_ICC_ERROR_FAILED_TO_OPEN,
+					     "failed to map file: %s",
+					     error_local->message);
+				return FALSE;
+			}
+		}
 	}
+	if (priv->mapped_file != NULL) {
+		ret = cd_icc_load_data (icc,
+					(const guint8 *) g_mapped_file_get_contents (priv->mapped_file),
+					g_mapped_file_get_length (priv->mapped_file),
+					flags,
+					error);
+		if (!ret)
+			return FALSE;
 
-	/* parse the data */
-	ret = cd_icc_load_data (icc,
-				(const guint8 *) data,
-				length,
-				flags,
-				error);
-	if (!ret)
-		return FALSE;
+		/* keep the raw blob so tags can be served as slices */
+		priv->blob = g_mapped_file_get_bytes (priv->mapped_file);
+	} else {
+		/* load files */
+		ret = g_file_load_contents (file, cancellable, &data, &length,
+					    NULL, &error_local);
+		if (!ret) {
+			g_set_error (error,
+				     CD_ICC_ERROR,
+				     CD_ICC_ERROR_FAILED_TO_OPEN,
+				     "failed to load file: %s",
+				     error_local->message);
+			return FALSE;
+		}
+
+		/* parse the data */
+		ret = cd_icc_load_data (icc,
+					(const guint8 *) data,
+					length,
+					flags,
+					error);
+		if (!ret)
+			return FALSE;
+
+		/* keep the raw blob so tags can be served as slices */
+		priv->blob = g_bytes_new_take (g_steal_pointer (&data), length);
+	}
 
 	/* find out if the user could delete this profile */
 	info = g_file_query_info (file,
@@ -2037,6 +3267,7 @@ cd_icc_get_handle (CdIcc *icc)
 {
 	CdIccPrivate *priv = GET_PRIVATE (icc);
 	g_return_val_if_fail (CD_IS_ICC (icc), NULL);
+	cd_icc_ensure_lcms_profile (icc);
 	return priv->lcms_profile;
 }
 
@@ -2270,6 +3501,7 @@ cd_icc_get_metadata (CdIcc *icc)
 {
 	CdIccPrivate *priv = GET_PRIVATE (icc);
 	g_return_val_if_fail (CD_IS_ICC (icc), NULL);
+	cd_icc_ensure_parsed (icc, CD_ICC_LOAD_FLAGS_METADATA);
 	return g_hash_table_ref (priv->metadata);
 }
 
@@ -2289,6 +3521,7 @@ cd_icc_get_metadata_item (CdIcc *icc, const gchar *key)
 {
 	CdIccPrivate *priv = GET_PRIVATE (icc);
 	g_return_val_if_fail (CD_IS_ICC (icc), NULL);
+	cd_icc_ensure_parsed (icc, CD_ICC_LOAD_FLAGS_METADATA);
 	g_return_val_if_fail (key != NULL, NULL);
 	return (const gchar *) g_hash_table_lookup (priv->metadata, key);
 }
@@ -2313,9 +3546,11 @@ cd_icc_add_metadata (CdIcc *icc, const gchar *key, const gchar *value)
 	g_return_if_fail (g_utf8_validate (key, -1, NULL));
 	g_return_if_fail (value != NULL);
 	g_return_if_fail (g_utf8_validate (value, -1, NULL));
+	cd_icc_ensure_parsed (icc, CD_ICC_LOAD_FLAGS_METADATA);
 	g_hash_table_insert (priv->metadata,
-			     g_strdup (key),
-			     g_strdup (value));
+			     cd_icc_arena_strdup (icc, key),
+			     cd_icc_arena_strdup (icc, value));
+	priv->dirty |= CD_ICC_DIRTY_METADATA;
 }
 
 /**
@@ -2333,15 +3568,17 @@ cd_icc_remove_metadata (CdIcc *icc, const gchar *key)
 	CdIccPrivate *priv = GET_PRIVATE (icc);
 	g_return_if_fail (CD_IS_ICC (icc));
 	g_return_if_fail (key != NULL);
+	cd_icc_ensure_parsed (icc, CD_ICC_LOAD_FLAGS_METADATA);
 	g_hash_table_remove (priv->metadata, key);
+	priv->dirty |= CD_ICC_DIRTY_METADATA;
 }
 
 static gboolean
 cd_icc_load_named_colors (CdIcc *icc, GError **error)
 {
 	CdIccPrivate *priv = GET_PRIVATE (icc);
-	CdColorLab lab;
 	CdColorSwatch *swatch;
+	CdColorSwatch *swatches;
 	cmsNAMEDCOLORLIST *nc2;
 	cmsUInt16Number pcs[3];
 	gboolean ret = TRUE;
@@ -2367,8 +3604,12 @@ cd_icc_load_named_colors (CdIcc *icc, GError **error)
 		return FALSE;
 	}
 
-	/* get each NC */
+	/* get each NC; the swatches all go into one contiguous arena block
+	 * so iterating them stays cache friendly */
 	size = cmsNamedColorCount (nc2);
+	if (size == 0)
+		return TRUE;
+	swatches = cd_icc_arena_alloc (icc, size * sizeof (CdColorSwatch));
 	for (j = 0; j < size; j++) {
 
 		/* parse title */
@@ -2394,10 +3635,9 @@ cd_icc_load_named_colors (CdIcc *icc, GError **error)
 
 		/* save color if valid */
 		if (ret) {
-			cmsLabEncoded2Float ((cmsCIELab *) &lab, pcs);
-			swatch = cd_color_swatch_new ();
-			cd_color_swatch_set_name (swatch, string->str);
-			cd_color_swatch_set_value (swatch, (const CdColorLab *) &lab);
+			swatch = &swatches[priv->named_colors->len];
+			swatch->name = cd_icc_arena_strdup (icc, string->str);
+			cmsLabEncoded2Float ((cmsCIELab *) &swatch->value, pcs);
 			g_ptr_array_add (priv->named_colors, swatch);
 		}
 		g_string_free (string, TRUE);
@@ -2410,8 +3650,8 @@ cd_icc_load_named_colors (CdIcc *icc, GError **error)
  * @icc: a #CdIcc instance.
  *
  * Gets any named colors in the profile.
- * This function will only return results if the profile was loaded with the
- * %CD_ICC_LOAD_FLAGS_NAMED_COLORS flag.
+ * If the profile was not loaded with the %CD_ICC_LOAD_FLAGS_NAMED_COLORS flag then
+ * the data is parsed on first access and cached.
  *
  * Return value: (transfer container) (element-type CdColorSwatch): An array of color swatches
  *
@@ -2422,9 +3662,160 @@ cd_icc_get_named_colors (CdIcc *icc)
 {
 	CdIccPrivate *priv = GET_PRIVATE (icc);
 	g_return_val_if_fail (CD_IS_ICC (icc), NULL);
+	cd_icc_ensure_parsed (icc, CD_ICC_LOAD_FLAGS_NAMED_COLORS);
 	return g_ptr_array_ref (priv->named_colors);
 }
 
+static CdColorSwatch *
+cd_icc_named_color_decode (cmsNAMEDCOLORLIST *nc2, guint idx)
+{
+	CdColorSwatch *swatch = NULL;
+	cmsUInt16Number pcs[3];
+	gboolean ret;
+	gchar name[cmsMAX_PATH];
+	gchar prefix[33];
+	gchar suffix[33];
+	GString *string;
+
+	/* parse title */
+	if (!cmsNamedColorInfo (nc2, idx,
+				name,
+				prefix,
+				suffix,
+				(cmsUInt16Number *) &pcs,
+				NULL))
+		return NULL;
+	string = g_string_new ("");
+	if (prefix[0] != '\0')
+		g_string_append_printf (string, "%s ", prefix);
+	g_string_append (string, name);
+	if (suffix[0] != '\0')
+		g_string_append_printf (string, " %s", suffix);
+
+	/* check is valid */
+	ret = g_utf8_validate (string->str, string->len, NULL);
+	if (!ret)
+		ret = cd_icc_fix_utf8_string (string);
+	if (ret) {
+		swatch = cd_color_swatch_new ();
+		swatch->name = g_strdup (string->str);
+		cmsLabEncoded2Float ((cmsCIELab *) &swatch->value, pcs);
+	}
+	g_string_free (string, TRUE);
+	return swatch;
+}
+
+static CdIccNamedColorPage *
+cd_icc_named_color_page_lookup (CdIcc *icc, cmsNAMEDCOLORLIST *nc2, guint number)
+{
+	CdIccPrivate *priv = GET_PRIVATE (icc);
+	CdIccNamedColorPage *page;
+	guint first = number * CD_ICC_NC_PAGE_SIZE;
+	guint i;
+	guint size;
+
+	/* hit: keep the most recently used page at the end */
+	for (i = 0; i < priv->nc_pages->len; i++) {
+		page = g_ptr_array_index (priv->nc_pages, i);
+		if (page->number == number) {
+			g_ptr_array_remove_index (priv->nc_pages, i);
+			g_ptr_array_add (priv->nc_pages, page);
+			return page;
+		}
+	}
+
+	/* decode just this page */
+	page = g_new0 (CdIccNamedColorPage, 1);
+	page->number = number;
+	page->swatches = g_ptr_array_new ();
+	size = cmsNamedColorCount (nc2);
+	for (i = first; i < first + CD_ICC_NC_PAGE_SIZE && i < size; i++) {
+		g_ptr_array_add (page->swatches,
+				 cd_icc_named_color_decode (nc2, i));
+	}
+	g_ptr_array_add (priv->nc_pages, page);
+
+	/* evict the page that has been untouched for longest */
+	if (priv->nc_pages->len > CD_ICC_NC_PAGE_MAX) {
+		cd_icc_named_color_page_free (g_ptr_array_index (priv->nc_pages, 0));
+		g_ptr_array_remove_index (priv->nc_pages, 0);
+	}
+	return page;
+}
+
+/**
+ * cd_icc_get_named_colors_size:
+ * @icc: a #CdIcc instance.
+ *
+ * Gets the number of named colors in the profile without decoding any
+ * of the swatches.
+ *
+ * Return value: the number of named colors, which may be zero
+ *
+ * Since: 1.4.6
+ **/
+guint
+cd_icc_get_named_colors_size (CdIcc *icc)
+{
+	CdIccPrivate *priv = GET_PRIVATE (icc);
+	cmsNAMEDCOLORLIST *nc2;
+
+	g_return_val_if_fail (CD_IS_ICC (icc), 0);
+
+	/* already materialized, e.g. from the sidecar cache */
+	if ((priv->parsed & CD_ICC_LOAD_FLAGS_NAMED_COLORS) > 0)
+		return priv->named_colors->len;
+	nc2 = cd_icc_read_tag (icc, cmsSigNamedColor2Type, NULL);
+	if (nc2 == NULL)
+		return 0;
+	return cmsNamedColorCount (nc2);
+}
+
+/**
+ * cd_icc_get_named_color:
+ * @icc: a #CdIcc instance.
+ * @idx: swatch index, from 0 to cd_icc_get_named_colors_size()
+ *
+ * Gets a single named color from the profile. Unlike
+ * cd_icc_get_named_colors() this decodes swatches in small pages on
+ * demand, keeping only the most recently used pages in memory, so
+ * scrolling views of very large spot color libraries do not pay for
+ * colors that are never shown.
+ *
+ * Return value: (transfer full): a #CdColorSwatch, or %NULL if @idx is
+ * out of range or the entry could not be decoded
+ *
+ * Since: 1.4.6
+ **/
+CdColorSwatch *
+cd_icc_get_named_color (CdIcc *icc, guint idx)
+{
+	CdIccPrivate *priv = GET_PRIVATE (icc);
+	CdColorSwatch *swatch;
+	CdIccNamedColorPage *page;
+	cmsNAMEDCOLORLIST *nc2;
+
+	g_return_val_if_fail (CD_IS_ICC (icc), NULL);
+
+	/* serve from the full array when it already exists */
+	if ((priv->parsed & CD_ICC_LOAD_FLAGS_NAMED_COLORS) > 0) {
+		if (idx >= priv->named_colors->len)
+			return NULL;
+		return cd_color_swatch_dup (g_ptr_array_index (priv->named_colors, idx));
+	}
+
+	nc2 = cd_icc_read_tag (icc, cmsSigNamedColor2Type, NULL);
+	if (nc2 == NULL || idx >= cmsNamedColorCount (nc2))
+		return NULL;
+	page = cd_icc_named_color_page_lookup (icc, nc2,
+					       idx / CD_ICC_NC_PAGE_SIZE);
+	swatch = g_ptr_array_index (page->swatches,
+				    idx % CD_ICC_NC_PAGE_SIZE);
+	if (swatch == NULL)
+		return NULL;
+	return cd_color_swatch_dup (swatch);
+}
+
 /**
  * cd_icc_get_can_delete:
  * @icc: a #CdIcc instance.
@@ -2469,6 +3860,9 @@ cd_icc_get_created (CdIcc *icc)
 		return g_date_time_new_from_unix_local (priv->creation_time);
 
 	/* get the profile creation time and date */
+	cd_icc_ensure_lcms_profile (icc);
+	if (priv->lcms_profile == NULL)
+		return NULL;
 	if (!cmsGetHeaderCreationDateTime (priv->lcms_profile, &created_tm))
 		return NULL;
 
@@ -2521,6 +3915,30 @@ cd_icc_get_checksum (CdIcc *icc)
 	return priv->checksum;
 }
 
+/**
+ * cd_icc_get_checksum_fast:
+ * @icc: A valid #CdIcc
+ *
+ * Gets a non-cryptographic hash of the profile data, computed with XXH64
+ * when the profile was loaded from a file or memory buffer.
+ * This is much cheaper to compute than the MD5 checksum and is well suited
+ * as a key for deduplicating or indexing profiles in-process, but should
+ * not be used where an MD5 is expected by external tools, for instance in
+ * the %CD_PROFILE_METADATA_FILE_CHECKSUM metadata.
+ *
+ * Return value: A 16 character lowercase hex string, or %NULL if the
+ * profile was not loaded from data
+ *
+ * Since: 1.4.6
+ **/
+const gchar *
+cd_icc_get_checksum_fast (CdIcc *icc)
+{
+	CdIccPrivate *priv = GET_PRIVATE (icc);
+	g_return_val_if_fail (CD_IS_ICC (icc), NULL);
+	return priv->checksum_fast;
+}
+
 static gchar *
 cd_icc_get_locale_key (const gchar *locale)
 {
@@ -2558,6 +3976,13 @@ cd_icc_get_mluc_data (CdIcc *icc,
 	/* does cache entry exist already? */
 	locale_key = cd_icc_get_locale_key (locale);
 	value = g_hash_table_lookup (priv->mluc_data[mluc], locale_key);
+	if (value == cd_icc_mluc_no_data) {
+		g_set_error_literal (error,
+				     CD_ICC_ERROR,
+				     CD_ICC_ERROR_NO_DATA,
+				     "cmsSigProfile*Tag missing");
+		return NULL;
+	}
 	if (value != NULL)
 		goto out;
 
@@ -2608,6 +4033,9 @@ cd_icc_get_mluc_data (CdIcc *icc,
 				     CD_ICC_ERROR,
 				     CD_ICC_ERROR_NO_DATA,
 				     "cmsSigProfile*Tag missing");
+		g_hash_table_insert (priv->mluc_data[mluc],
+				     cd_icc_arena_strdup (icc, locale_key),
+				     (gpointer) cd_icc_mluc_no_data);
 		goto out;
 	}
 
@@ -2617,8 +4045,12 @@ cd_icc_get_mluc_data (CdIcc *icc,
 				   country_code,
 				   NULL,
 				   0);
-	if (text_size == 0)
+	if (text_size == 0) {
+		g_hash_table_insert (priv->mluc_data[mluc],
+				     cd_icc_arena_strdup (icc, locale_key),
+				     (gpointer) cd_icc_mluc_no_data);
 		goto out;
+	}
 
 	/* load wide chars */
 	wtext = g_new (gunichar, text_size);
@@ -2634,9 +4066,9 @@ cd_icc_get_mluc_data (CdIcc *icc,
 	text_buffer = g_ucs4_to_utf8 (wtext, -1, NULL, NULL, error);
 	if (text_buffer == NULL)
 		goto out;
-	tmp = g_strdup (text_buffer);
+	tmp = cd_icc_arena_strdup (icc, text_buffer);
 	g_hash_table_insert (priv->mluc_data[mluc],
-			     g_strdup (locale_key),
+			     cd_icc_arena_strdup (icc, locale_key),
 			     tmp);
 	value = tmp;
 out:
@@ -2763,10 +4195,13 @@ void
 cd_icc_set_description (CdIcc *icc, const gchar *locale, const gchar *value)
 {
 	CdIccPrivate *priv = GET_PRIVATE (icc);
+	g_autofree gchar *locale_key = NULL;
 	g_return_if_fail (value == NULL || g_utf8_validate (value, -1, NULL));
+	locale_key = cd_icc_get_locale_key (locale);
 	g_hash_table_insert (priv->mluc_data[CD_MLUC_DESCRIPTION],
-			     cd_icc_get_locale_key (locale),
-			     g_strdup (value));
+			     cd_icc_arena_strdup (icc, locale_key),
+			     cd_icc_arena_strdup (icc, value));
+	priv->dirty |= CD_ICC_DIRTY_TRANSLATIONS;
 }
 
 /**
@@ -2811,10 +4246,13 @@ void
 cd_icc_set_copyright (CdIcc *icc, const gchar *locale, const gchar *value)
 {
 	CdIccPrivate *priv = GET_PRIVATE (icc);
+	g_autofree gchar *locale_key = NULL;
 	g_return_if_fail (value == NULL || g_utf8_validate (value, -1, NULL));
+	locale_key = cd_icc_get_locale_key (locale);
 	g_hash_table_insert (priv->mluc_data[CD_MLUC_COPYRIGHT],
-			     cd_icc_get_locale_key (locale),
-			     g_strdup (value));
+			     cd_icc_arena_strdup (icc, locale_key),
+			     cd_icc_arena_strdup (icc, value));
+	priv->dirty |= CD_ICC_DIRTY_TRANSLATIONS;
 }
 
 /**
@@ -2859,10 +4297,13 @@ void
 cd_icc_set_manufacturer (CdIcc *icc, const gchar *locale, const gchar *value)
 {
 	CdIccPrivate *priv = GET_PRIVATE (icc);
+	g_autofree gchar *locale_key = NULL;
 	g_return_if_fail (value == NULL || g_utf8_validate (value, -1, NULL));
+	locale_key = cd_icc_get_locale_key (locale);
 	g_hash_table_insert (priv->mluc_data[CD_MLUC_MANUFACTURER],
-			     cd_icc_get_locale_key (locale),
-			     g_strdup (value));
+			     cd_icc_arena_strdup (icc, locale_key),
+			     cd_icc_arena_strdup (icc, value));
+	priv->dirty |= CD_ICC_DIRTY_TRANSLATIONS;
 }
 
 /**
@@ -2907,10 +4348,13 @@ void
 cd_icc_set_model (CdIcc *icc, const gchar *locale, const gchar *value)
 {
 	CdIccPrivate *priv = GET_PRIVATE (icc);
+	g_autofree gchar *locale_key = NULL;
 	g_return_if_fail (value == NULL || g_utf8_validate (value, -1, NULL));
+	locale_key = cd_icc_get_locale_key (locale);
 	g_hash_table_insert (priv->mluc_data[CD_MLUC_MODEL],
-			     cd_icc_get_locale_key (locale),
-			     g_strdup (value));
+			     cd_icc_arena_strdup (icc, locale_key),
+			     cd_icc_arena_strdup (icc, value));
+	priv->dirty |= CD_ICC_DIRTY_TRANSLATIONS;
 }
 
 /**
@@ -2946,8 +4390,8 @@ cd_icc_set_model_items (CdIcc *icc, GHashTable *values)
  * @icc: A valid #CdIcc
  *
  * Gets the ICC color temperature, rounded to the nearest 100K.
- * This function will only return results if the profile was loaded with the
- * %CD_ICC_LOAD_FLAGS_PRIMARIES flag.
+ * If the profile was not loaded with the %CD_ICC_LOAD_FLAGS_PRIMARIES flag then
+ * the data is parsed on first access and cached.
  *
  * Return value: The color temperature in Kelvin, or 0 for error.
  *
@@ -2958,6 +4402,7 @@ cd_icc_get_temperature (CdIcc *icc)
 {
 	CdIccPrivate *priv = GET_PRIVATE (icc);
 	g_return_val_if_fail (CD_IS_ICC (icc), 0);
+	cd_icc_ensure_parsed (icc, CD_ICC_LOAD_FLAGS_PRIMARIES);
 	return priv->temperature;
 }
 
@@ -2966,8 +4411,8 @@ cd_icc_get_temperature (CdIcc *icc)
  * @icc: a valid #CdIcc instance
  *
  * Gets the profile red chromaticity value.
- * This function will only return results if the profile was loaded with the
- * %CD_ICC_LOAD_FLAGS_PRIMARIES flag.
+ * If the profile was not loaded with the %CD_ICC_LOAD_FLAGS_PRIMARIES flag then
+ * the data is parsed on first access and cached.
  *
  * Return value: the #CdColorXYZ value
  *
@@ -2978,6 +4423,7 @@ cd_icc_get_red (CdIcc *icc)
 {
 	CdIccPrivate *priv = GET_PRIVATE (icc);
 	g_return_val_if_fail (CD_IS_ICC (icc), NULL);
+	cd_icc_ensure_parsed (icc, CD_ICC_LOAD_FLAGS_PRIMARIES);
 	return &priv->red;
 }
 
@@ -2986,8 +4432,8 @@ cd_icc_get_red (CdIcc *icc)
  * @icc: a valid #CdIcc instance
  *
  * Gets the profile green chromaticity value.
- * This function will only return results if the profile was loaded with the
- * %CD_ICC_LOAD_FLAGS_PRIMARIES flag.
+ * If the profile was not loaded with the %CD_ICC_LOAD_FLAGS_PRIMARIES flag then
+ * the data is parsed on first access and cached.
  *
  * Return value: the #CdColorXYZ value
  *
@@ -2998,6 +4444,7 @@ cd_icc_get_green (CdIcc *icc)
 {
 	CdIccPrivate *priv = GET_PRIVATE (icc);
 	g_return_val_if_fail (CD_IS_ICC (icc), NULL);
+	cd_icc_ensure_parsed (icc, CD_ICC_LOAD_FLAGS_PRIMARIES);
 	return &priv->green;
 }
 
@@ -3006,8 +4453,8 @@ cd_icc_get_green (CdIcc *icc)
  * @icc: a valid #CdIcc instance
  *
  * Gets the profile red chromaticity value.
- * This function will only return results if the profile was loaded with the
- * %CD_ICC_LOAD_FLAGS_PRIMARIES flag.
+ * If the profile was not loaded with the %CD_ICC_LOAD_FLAGS_PRIMARIES flag then
+ * the data is parsed on first access and cached.
  *
  * Return value: the #CdColorXYZ value
  *
@@ -3018,6 +4465,7 @@ cd_icc_get_blue (CdIcc *icc)
 {
 	CdIccPrivate *priv = GET_PRIVATE (icc);
 	g_return_val_if_fail (CD_IS_ICC (icc), NULL);
+	cd_icc_ensure_parsed (icc, CD_ICC_LOAD_FLAGS_PRIMARIES);
 	return &priv->blue;
 }
 
@@ -3026,8 +4474,8 @@ cd_icc_get_blue (CdIcc *icc)
  * @icc: a valid #CdIcc instance
  *
  * Gets the profile white point.
- * This function will only return results if the profile was loaded with the
- * %CD_ICC_LOAD_FLAGS_PRIMARIES flag.
+ * If the profile was not loaded with the %CD_ICC_LOAD_FLAGS_PRIMARIES flag then
+ * the data is parsed on first access and cached.
  *
  * Return value: the #CdColorXYZ value
  *
@@ -3038,6 +4486,7 @@ cd_icc_get_white (CdIcc *icc)
 {
 	CdIccPrivate *priv = GET_PRIVATE (icc);
 	g_return_val_if_fail (CD_IS_ICC (icc), NULL);
+	cd_icc_ensure_parsed (icc, CD_ICC_LOAD_FLAGS_PRIMARIES);
 	return &priv->white;
 }
 
@@ -3115,6 +4564,91 @@ cd_icc_create_default (CdIcc *icc, GError **error)
 	return cd_icc_create_default_full (icc, CD_ICC_LOAD_FLAGS_NONE, error);
 }
 
+/* the shared standard space profiles; created once and kept for the
+ * lifetime of the process */
+static CdIcc *cd_icc_standard_space_cache[CD_STANDARD_SPACE_LAST] = { NULL };
+G_LOCK_DEFINE_STATIC (cd_icc_standard_space_cache);
+
+/**
+ * cd_icc_get_standard_space:
+ * @standard_space: a #CdStandardSpace, e.g. %CD_STANDARD_SPACE_SRGB
+ * @error: (out): A #GError, or %NULL
+ *
+ * Gets a shared, process-wide profile for a standard colorspace.
+ *
+ * The profile is generated and fully parsed on first use and the same
+ * instance is then handed out to every caller, so code that just needs
+ * e.g. sRGB as a fallback or reference does not pay for generating and
+ * parsing it again. The returned profile must be treated as immutable;
+ * callers wanting to modify a profile should generate a private one
+ * with cd_icc_create_default_full() instead.
+ *
+ * Return value: (transfer full): a reference to the shared #CdIcc,
+ *               or %NULL for error
+ *
+ * Since: 1.4.6
+ **/
+CdIcc *
+cd_icc_get_standard_space (CdStandardSpace standard_space,
+			   GError **error)
+{
+	CdIcc *icc_tmp = NULL;
+
+	g_return_val_if_fail (standard_space < CD_STANDARD_SPACE_LAST, NULL);
+
+	G_LOCK (cd_icc_standard_space_cache);
+	if (cd_icc_standard_space_cache[standard_space] == NULL) {
+		g_autoptr(CdIcc) icc = cd_icc_new ();
+
+		/* parse everything up front so sharing the instance between
+		 * threads never triggers a lazy parse */
+		switch (standard_space) {
+		case CD_STANDARD_SPACE_SRGB:
+			if (!cd_icc_create_default_full (icc,
+							 CD_ICC_LOAD_FLAGS_ALL,
+							 error))
+				goto out;
+			break;
+		default:
+			g_set_error (error,
+				     CD_ICC_ERROR,
+				     CD_ICC_ERROR_FAILED_TO_CREATE,
+				     "no generator for standard space %s",
+				     cd_standard_space_to_string (standard_space));
+			goto out;
+		}
+		cd_icc_standard_space_cache[standard_space] = g_steal_pointer (&icc);
+	}
+	icc_tmp = g_object_ref (cd_icc_standard_space_cache[standard_space]);
+out:
+	G_UNLOCK (cd_icc_standard_space_cache);
+	return icc_tmp;
+}
+
+/* bump when the generated profile contents change so stale cache
+ * entries are regenerated rather than served */
+#define CD_ICC_EDID_GENERATE_VERSION	1
+
+static gchar *
+cd_icc_get_edid_cache_fn (CdEdid *edid)
+{
+	const gchar *checksum;
+	g_autofree gchar *basename = NULL;
+
+	/* no EDID blob, no stable key */
+	checksum = cd_edid_get_checksum (edid);
+	if (checksum == NULL)
+		return NULL;
+	basename = g_strdup_printf ("%s-v%i.icc",
+				    checksum,
+				    CD_ICC_EDID_GENERATE_VERSION);
+	return g_build_filename (g_get_user_cache_dir (),
+				 "colord",
+				 "edid-profiles",
+				 basename,
+				 NULL);
+}
+
 /**
  * cd_icc_create_from_edid_data:
  * @icc: A valid #CdIcc
@@ -3123,6 +4657,10 @@ cd_icc_create_default (CdIcc *icc, GError **error)
  *
  * Creates an ICC profile from EDID data.
  *
+ * The generated profile bytes are cached on disk keyed by the EDID
+ * checksum, so replugging the same monitor skips the tone curve
+ * generation and serialization entirely.
+ *
  * Return value: %TRUE for success
  *
  * Since: 1.1.2
@@ -3132,6 +4670,9 @@ cd_icc_create_from_edid_data (CdIcc *icc, CdEdid *edid, GError **error)
 {
 	CdIccPrivate *priv = GET_PRIVATE (icc);
 	const gchar *data;
+	gsize cache_len = 0;
+	g_autofree gchar *cache_fn = NULL;
+	g_autofree gchar *cache_data = NULL;
 
 	/* not loaded */
 	if (priv->lcms_profile != NULL) {
@@ -3142,6 +4683,22 @@ cd_icc_create_from_edid_data (CdIcc *icc, CdEdid *edid, GError **error)
 		return FALSE;
 	}
 
+	/* the same monitor was seen before, so just load the bytes that
+	 * were generated last time; a corrupt file falls through to a
+	 * regenerate which overwrites it */
+	cache_fn = cd_icc_get_edid_cache_fn (edid);
+	if (cache_fn != NULL &&
+	    g_file_get_contents (cache_fn, &cache_data, &cache_len, NULL)) {
+		if (cd_icc_load_data (icc,
+				      (const guint8 *) cache_data,
+				      cache_len,
+				      CD_ICC_LOAD_FLAGS_METADATA,
+				      NULL)) {
+			g_debug ("loaded EDID profile from %s", cache_fn);
+			return TRUE;
+		}
+	}
+
 	/* create from parsed object */
 	if (!cd_icc_create_from_edid (icc,
 				      cd_edid_get_gamma (edid),
@@ -3174,6 +4731,23 @@ cd_icc_create_from_edid_data (CdIcc *icc, CdEdid *edid, GError **error)
 	data = cd_edid_get_vendor_name (edid);
 	if (data != NULL)
 		cd_icc_add_metadata (icc, CD_PROFILE_METADATA_EDID_VENDOR, data);
+
+	/* save the serialized bytes for the next hotplug, best effort */
+	if (cache_fn != NULL) {
+		g_autofree gchar *cache_dn = g_path_get_dirname (cache_fn);
+		g_autoptr(GBytes) bytes = NULL;
+		bytes = cd_icc_save_data (icc, CD_ICC_SAVE_FLAGS_NONE, NULL);
+		if (bytes != NULL &&
+		    g_mkdir_with_parents (cache_dn, 0755) == 0) {
+			if (!g_file_set_contents (cache_fn,
+						  g_bytes_get_data (bytes, NULL),
+						  (gssize) g_bytes_get_size (bytes),
+						  NULL)) {
+				g_debug ("failed to save EDID profile to %s",
+					 cache_fn);
+			}
+		}
+	}
 	return TRUE;
 }
 
@@ -3277,6 +4851,9 @@ out:
  * @error: A #GError or %NULL
  *
  * Gets the video card calibration data from the profile.
+ * The extracted table is cached on the #CdIcc and the entries are backed
+ * by one contiguous allocation owned by the profile object, so repeated
+ * calls for the same size are effectively free.
  *
  * Return value: (transfer container) (element-type CdColorRGB): VCGT data, or %NULL for error
  *
@@ -3286,13 +4863,20 @@ GPtrArray *
 cd_icc_get_vcgt (CdIcc *icc, guint size, GError **error)
 {
 	CdIccPrivate *priv = GET_PRIVATE (icc);
-	CdColorRGB *tmp;
+	CdColorRGB *slab;
 	cmsFloat32Number in;
 	const cmsToneCurve **vcgt;
 	GPtrArray *array = NULL;
 	guint i;
 
 	g_return_val_if_fail (CD_IS_ICC (icc), NULL);
+
+	/* the table is stable between loads, so hand out the same array
+	 * on display reconfiguration storms */
+	if (priv->vcgt_cache != NULL && priv->vcgt_cache_size == size)
+		return g_ptr_array_ref (priv->vcgt_cache);
+
+	cd_icc_ensure_lcms_profile (icc);
 	g_return_val_if_fail (priv->lcms_profile != NULL, NULL);
 
 	/* get tone curves from icc */
@@ -3305,17 +4889,26 @@ cd_icc_get_vcgt (CdIcc *icc, guint size, GError **error)
 		goto out;
 	}
 
-	/* create array */
-	array = g_ptr_array_new_with_free_func ((GDestroyNotify) cd_color_rgb_free);
+	/* one contiguous slab rather than a heap object per entry; the
+	 * slab stays alive for the lifetime of the CdIcc so outstanding
+	 * arrays never dangle */
+	slab = g_new (CdColorRGB, size);
+	g_ptr_array_add (priv->vcgt_slabs, slab);
+	array = g_ptr_array_new ();
 	for (i = 0; i < size; i++) {
 		in = (gdouble) i / (gdouble) (size - 1);
-		tmp = cd_color_rgb_new ();
-		cd_color_rgb_set (tmp,
+		cd_color_rgb_set (&slab[i],
 				  cmsEvalToneCurveFloat(vcgt[0], in),
 				  cmsEvalToneCurveFloat(vcgt[1], in),
 				  cmsEvalToneCurveFloat(vcgt[2], in));
-		g_ptr_array_add (array, tmp);
+		g_ptr_array_add (array, &slab[i]);
 	}
+
+	/* cache for next time */
+	if (priv->vcgt_cache != NULL)
+		g_ptr_array_unref (priv->vcgt_cache);
+	priv->vcgt_cache = g_ptr_array_ref (array);
+	priv->vcgt_cache_size = size;
 out:
 	return array;
 }
@@ -3350,6 +4943,7 @@ cd_icc_get_response (CdIcc *icc, guint size, GError **error)
 	g_autofree gdouble *values_out = NULL;
 
 	/* run through the icc */
+	cd_icc_ensure_lcms_profile (icc);
 	colorspace = cd_icc_get_colorspace (icc);
 	if (colorspace != CD_COLORSPACE_RGB) {
 		g_set_error_literal (error,
@@ -3438,17 +5032,14 @@ out:
 gboolean
 cd_icc_set_vcgt (CdIcc *icc, GPtrArray *vcgt, GError **error)
 {
-	CdIccPrivate *priv = GET_PRIVATE (icc);
 	CdColorRGB *tmp;
-	cmsToneCurve *curve[3];
-	gboolean ret;
 	guint i;
 	g_autofree guint16 *blue = NULL;
 	g_autofree guint16 *green = NULL;
 	g_autofree guint16 *red = NULL;
 
 	g_return_val_if_fail (CD_IS_ICC (icc), FALSE);
-	g_return_val_if_fail (priv->lcms_profile != NULL, FALSE);
+	g_return_val_if_fail (vcgt != NULL, FALSE);
 
 	/* unwrap data */
 	red = g_new0 (guint16, vcgt->len);
@@ -3460,17 +5051,60 @@ cd_icc_set_vcgt (CdIcc *icc, GPtrArray *vcgt, GError **error)
 		green[i] = tmp->G * (gdouble) 0xffff;
 		blue[i]  = tmp->B * (gdouble) 0xffff;
 	}
+	return cd_icc_set_vcgt_full (icc, red, green, blue, vcgt->len, error);
+}
+
+/**
+ * cd_icc_set_vcgt_full:
+ * @icc: a #CdIcc instance.
+ * @red: (array length=size): red channel table, 0x0000 to 0xffff
+ * @green: (array length=size): green channel table, 0x0000 to 0xffff
+ * @blue: (array length=size): blue channel table, 0x0000 to 0xffff
+ * @size: the number of entries per channel
+ * @error: A #GError or %NULL
+ *
+ * Sets the Video Card Gamma Table from packed per-channel arrays.
+ * This is the same as cd_icc_set_vcgt() but avoids boxing each ramp
+ * entry, which matters for callers that compute the ramp in flat
+ * arrays anyway, e.g. during calibration.
+ *
+ * Return value: %TRUE for success.
+ *
+ * Since: 1.4.6
+ **/
+gboolean
+cd_icc_set_vcgt_full (CdIcc *icc,
+		      const guint16 *red,
+		      const guint16 *green,
+		      const guint16 *blue,
+		      gsize size,
+		      GError **error)
+{
+	CdIccPrivate *priv = GET_PRIVATE (icc);
+	cmsToneCurve *curve[3];
+	gboolean ret;
+	guint i;
+
+	g_return_val_if_fail (CD_IS_ICC (icc), FALSE);
+	g_return_val_if_fail (red != NULL, FALSE);
+	g_return_val_if_fail (green != NULL, FALSE);
+	g_return_val_if_fail (blue != NULL, FALSE);
+	cd_icc_ensure_lcms_profile (icc);
+	g_return_val_if_fail (priv->lcms_profile != NULL, FALSE);
 
 	/* build tone curve */
-	curve[0] = cmsBuildTabulatedToneCurve16 (NULL, vcgt->len, red);
-	curve[1] = cmsBuildTabulatedToneCurve16 (NULL, vcgt->len, green);
-	curve[2] = cmsBuildTabulatedToneCurve16 (NULL, vcgt->len, blue);
+	curve[0] = cmsBuildTabulatedToneCurve16 (NULL, size, red);
+	curve[1] = cmsBuildTabulatedToneCurve16 (NULL, size, green);
+	curve[2] = cmsBuildTabulatedToneCurve16 (NULL, size, blue);
 
 	/* smooth it */
 	for (i = 0; i < 3; i++)
 		cmsSmoothToneCurve (curve[i], 5);
 
 	/* write the tag */
+	g_clear_pointer (&priv->vcgt_cache, g_ptr_array_unref);
+	g_clear_pointer (&priv->blob, g_bytes_unref);
+	g_clear_pointer (&priv->warnings_cache, g_array_unref);
 	ret = cmsWriteTag (priv->lcms_profile, cmsSigVcgtType, curve);
 	if (!ret) {
 		g_set_error_literal (error,
@@ -3539,17 +5173,15 @@ cd_icc_check_vcgt (CdIcc *icc)
 }
 
 static CdProfileWarning
-cd_profile_check_scum_dot (CdIcc *icc)
+cd_profile_check_scum_dot (CdIcc *icc, cmsHPROFILE profile_lab)
 {
 	CdIccPrivate *priv = GET_PRIVATE (icc);
 	CdProfileWarning warning = CD_PROFILE_WARNING_NONE;
 	cmsCIELab white;
-	cmsHPROFILE profile_lab;
 	cmsHTRANSFORM transform;
 	guint8 rgb[3] = { 0, 0, 0 };
 
 	/* do Lab to RGB transform of 100,0,0 */
-	profile_lab = cmsCreateLab2ProfileTHR (priv->context_lcms, cmsD50_xyY ());
 	transform = cmsCreateTransformTHR (priv->context_lcms,
 					   profile_lab, TYPE_Lab_DBL,
 					   priv->lcms_profile, TYPE_RGB_8,
@@ -3568,8 +5200,6 @@ cd_profile_check_scum_dot (CdIcc *icc)
 		goto out;
 	}
 out:
-	if (profile_lab != NULL)
-		cmsCloseProfile (profile_lab);
 	if (transform != NULL)
 		cmsDeleteTransform (transform);
 	return warning;
@@ -3620,12 +5250,11 @@ cd_icc_check_primaries (CdIcc *icc)
 }
 
 static CdProfileWarning
-cd_icc_check_gray_axis (CdIcc *icc)
+cd_icc_check_gray_axis (CdIcc *icc, cmsHPROFILE profile_lab)
 {
 	CdIccPrivate *priv = GET_PRIVATE (icc);
 	CdProfileWarning warning = CD_PROFILE_WARNING_NONE;
 	cmsCIELab gray[16];
-	cmsHPROFILE profile_lab = NULL;
 	cmsHTRANSFORM transform = NULL;
 	const gdouble gray_error = 5.0f;
 	gdouble last_l = -1;
@@ -3638,7 +5267,6 @@ cd_icc_check_gray_axis (CdIcc *icc)
 		goto out;
 
 	/* do Lab to RGB transform of 100,0,0 */
-	profile_lab = cmsCreateLab2ProfileTHR (priv->context_lcms, cmsD50_xyY ());
 	transform = cmsCreateTransformTHR (priv->context_lcms,
 					   priv->lcms_profile, TYPE_RGB_8,
 					   profile_lab, TYPE_Lab_DBL,
@@ -3676,8 +5304,6 @@ cd_icc_check_gray_axis (CdIcc *icc)
 		last_l = gray[i].L;
 	}
 out:
-	if (profile_lab != NULL)
-		cmsCloseProfile (profile_lab);
 	if (transform != NULL)
 		cmsDeleteTransform (transform);
 	return warning;
@@ -3784,26 +5410,17 @@ out:
 	return warning;
 }
 
-/**
- * cd_icc_get_warnings:
- * @icc: a #CdIcc instance.
- *
- * Returns any warnings with profiles
- *
- * Return value: (transfer container) (element-type CdProfileWarning): An array of warning values
- *
- * Since: 0.1.34
- **/
-GArray *
-cd_icc_get_warnings (CdIcc *icc)
+static GArray *
+cd_icc_build_warnings (CdIcc *icc)
 {
 	CdIccPrivate *priv = GET_PRIVATE (icc);
 	GArray *flags;
 	gboolean ret;
 	gchar ascii_name[1024];
+	cmsHPROFILE profile_lab = NULL;
 	CdProfileWarning warning;
 
-	g_return_val_if_fail (CD_IS_ICC (icc), NULL);
+	cd_icc_ensure_lcms_profile (icc);
 	g_return_val_if_fail (priv->lcms_profile != NULL, NULL);
 
 	flags = g_array_new (FALSE, FALSE, sizeof (CdProfileWarning));
@@ -3828,6 +5445,9 @@ cd_icc_get_warnings (CdIcc *icc)
 	if (cmsGetColorSpace (priv->lcms_profile) != cmsSigRgbData)
 		goto out;
 
+	/* the Lab profile is shared by all the Lab-based checks */
+	profile_lab = cmsCreateLab2ProfileTHR (priv->context_lcms, cmsD50_xyY ());
+
 	/* does profile have an unlikely whitepoint */
 	warning = cd_icc_check_whitepoint (icc);
 	if (warning != CD_PROFILE_WARNING_NONE)
@@ -3840,12 +5460,12 @@ cd_icc_get_warnings (CdIcc *icc)
 
 	/* if Lab 100,0,0 does not map to RGB 255,255,255 for relative
 	 * colorimetric then white it will not work on printers */
-	warning = cd_profile_check_scum_dot (icc);
+	warning = cd_profile_check_scum_dot (icc, profile_lab);
 	if (warning != CD_PROFILE_WARNING_NONE)
 		g_array_append_val (flags, warning);
 
 	/* gray should give low a/b and should be monotonic */
-	warning = cd_icc_check_gray_axis (icc);
+	warning = cd_icc_check_gray_axis (icc, profile_lab);
 	if (warning != CD_PROFILE_WARNING_NONE)
 		g_array_append_val (flags, warning);
 
@@ -3859,6 +5479,41 @@ cd_icc_get_warnings (CdIcc *icc)
 	if (warning != CD_PROFILE_WARNING_NONE)
 		g_array_append_val (flags, warning);
 out:
+	if (profile_lab != NULL)
+		cmsCloseProfile (profile_lab);
+	return flags;
+}
+
+/**
+ * cd_icc_get_warnings:
+ * @icc: a #CdIcc instance.
+ *
+ * Returns any warnings with profiles. The checks are only run once per
+ * load, or when hydrating from the sidecar cache not at all; setters
+ * that modify the profile invalidate the cached result.
+ *
+ * Return value: (transfer container) (element-type CdProfileWarning): An array of warning values
+ *
+ * Since: 0.1.34
+ **/
+GArray *
+cd_icc_get_warnings (CdIcc *icc)
+{
+	CdIccPrivate *priv = GET_PRIVATE (icc);
+	GArray *flags;
+
+	g_return_val_if_fail (CD_IS_ICC (icc), NULL);
+
+	/* run the battery of checks once and keep the result */
+	if (priv->warnings_cache == NULL) {
+		priv->warnings_cache = cd_icc_build_warnings (icc);
+		if (priv->warnings_cache == NULL)
+			return NULL;
+	}
+	flags = g_array_new (FALSE, FALSE, sizeof (CdProfileWarning));
+	g_array_append_vals (flags,
+			     priv->warnings_cache->data,
+			     priv->warnings_cache->len);
 	return flags;
 }
 
@@ -4047,18 +5702,17 @@ cd_icc_init (CdIcc *icc)
 	priv->context_lcms = cd_context_lcms_new ();
 	priv->kind = CD_PROFILE_KIND_UNKNOWN;
 	priv->colorspace = CD_COLORSPACE_UNKNOWN;
-	priv->named_colors = g_ptr_array_new_with_free_func ((GDestroyNotify) cd_color_swatch_free);
-	priv->metadata = g_hash_table_new_full (g_str_hash,
-						     g_str_equal,
-						     g_free,
-						     g_free);
+	priv->dirty = CD_ICC_DIRTY_ALL;
+	priv->vcgt_slabs = g_ptr_array_new_with_free_func (g_free);
+	priv->arena = g_ptr_array_new_with_free_func (g_free);
+	/* the swatches, metadata and localized strings are arena-backed and
+	 * freed wholesale in cd_icc_finalize() */
+	priv->named_colors = g_ptr_array_new ();
+	priv->nc_pages = g_ptr_array_new ();
+	priv->metadata = g_hash_table_new (g_str_hash, g_str_equal);
 	priv->creation_time = -1;
-	for (i = 0; i < CD_MLUC_LAST; i++) {
-		priv->mluc_data[i] = g_hash_table_new_full (g_str_hash,
-								 g_str_equal,
-								 g_free,
-								 g_free);
-	}
+	for (i = 0; i < CD_MLUC_LAST; i++)
+		priv->mluc_data[i] = g_hash_table_new (g_str_hash, g_str_equal);
 	cd_color_xyz_clear (&priv->white);
 	cd_color_xyz_clear (&priv->red);
 	cd_color_xyz_clear (&priv->green);
@@ -4074,13 +5728,26 @@ cd_icc_finalize (GObject *object)
 
 	g_free (priv->filename);
 	g_free (priv->checksum);
+	g_free (priv->checksum_fast);
 	g_free (priv->characterization_data);
 	g_ptr_array_unref (priv->named_colors);
+	cd_icc_named_color_pages_clear (icc);
+	g_ptr_array_unref (priv->nc_pages);
 	g_hash_table_destroy (priv->metadata);
 	for (i = 0; i < CD_MLUC_LAST; i++)
 		g_hash_table_destroy (priv->mluc_data[i]);
 	if (priv->lcms_profile != NULL)
 		cmsCloseProfile (priv->lcms_profile);
+	if (priv->mapped_file != NULL)
+		g_mapped_file_unref (priv->mapped_file);
+	if (priv->blob != NULL)
+		g_bytes_unref (priv->blob);
+	if (priv->vcgt_cache != NULL)
+		g_ptr_array_unref (priv->vcgt_cache);
+	if (priv->warnings_cache != NULL)
+		g_array_unref (priv->warnings_cache);
+	g_ptr_array_unref (priv->vcgt_slabs);
+	g_ptr_array_unref (priv->arena);
 	cd_context_lcms_free (priv->context_lcms);
 
 	G_OBJECT_CLASS (cd_icc_parent_class)->finalize (object);
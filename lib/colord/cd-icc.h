@@ -95,6 +95,9 @@ struct _CdIccClass
  * 					ID was not supplied in the profile.
  * @CD_ICC_LOAD_FLAGS_PRIMARIES:	Parse the primaries in the profile.
  * @CD_ICC_LOAD_FLAGS_CHARACTERIZATION:	Load the characterization data from the profile
+ * @CD_ICC_LOAD_FLAGS_MMAP:		Map the file read-only rather than
+ * 					copying it onto the heap; deliberately
+ * 					not part of %CD_ICC_LOAD_FLAGS_ALL
  *
  * Flags used when loading an ICC profile.
  *
@@ -110,10 +113,27 @@ typedef enum {
 	CD_ICC_LOAD_FLAGS_CHARACTERIZATION = (1 << 5),	/* Since: 1.1.1 */
 	/* new entries go here: */
 	CD_ICC_LOAD_FLAGS_ALL		= 0xff,		/* Since: 0.1.32 */
+	CD_ICC_LOAD_FLAGS_MMAP		= (1 << 8),	/* Since: 1.4.6 */
 	/*< private >*/
 	CD_ICC_LOAD_FLAGS_LAST
 } CdIccLoadFlags;
 
+/**
+ * CdIccTagEntry:
+ * @signature:			Tag signature, e.g. "desc"
+ * @offset:			Offset of the tag data from the file start
+ * @size:			Size of the tag data in bytes
+ *
+ * One entry of the raw on-disk tag table.
+ *
+ * Since: 1.4.6
+ **/
+typedef struct {
+	gchar		 signature[5];
+	guint32		 offset;
+	guint32		 size;
+} CdIccTagEntry;
+
 /**
  * CdIccSaveFlags:
  * @CD_ICC_SAVE_FLAGS_NONE:		No flags set.
@@ -128,9 +148,39 @@ typedef enum {
 	CD_ICC_SAVE_FLAGS_LAST
 } CdIccSaveFlags;
 
+/**
+ * CdIccPeek:
+ * @kind: the #CdProfileKind from the header
+ * @colorspace: the #CdColorspace from the header
+ * @version: the ICC specification version
+ * @size: the size of the profile in bytes
+ * @checksum: the embedded profile ID, or %NULL if not set
+ * @description: the default profile description, or %NULL if not found
+ *
+ * The result of a lightweight profile scan that does not go through
+ * lcms2; see cd_icc_peek_data().
+ *
+ * Since: 1.4.6
+ **/
+typedef struct {
+	CdProfileKind	 kind;
+	CdColorspace	 colorspace;
+	gdouble		 version;
+	guint32		 size;
+	gchar		*checksum;
+	gchar		*description;
+} CdIccPeek;
+
 GQuark		 cd_icc_error_quark			(void);
 CdIcc		*cd_icc_new				(void);
 
+gboolean	 cd_icc_peek_data			(const guint8	*data,
+							 gsize		 data_len,
+							 CdIccPeek	*peek,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
+void		 cd_icc_peek_clear			(CdIccPeek	*peek);
+
 gboolean	 cd_icc_load_data			(CdIcc		*icc,
 							 const guint8	*data,
 							 gsize		 data_len,
@@ -143,6 +193,23 @@ gboolean	 cd_icc_load_file			(CdIcc		*icc,
 							 GCancellable	*cancellable,
 							 GError		**error)
 							 G_GNUC_WARN_UNUSED_RESULT;
+GPtrArray	*cd_icc_load_files			(GPtrArray	*files,
+							 CdIccLoadFlags	 flags,
+							 GCancellable	*cancellable,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
+gboolean	 cd_icc_load_cache			(CdIcc		*icc,
+							 GFile		*file,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
+gboolean	 cd_icc_load_cache_bytes		(CdIcc		*icc,
+							 GBytes		*data,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
+gboolean	 cd_icc_save_cache			(CdIcc		*icc,
+							 GFile		*file,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
 gboolean	 cd_icc_load_fd				(CdIcc		*icc,
 							 gint		 fd,
 							 CdIccLoadFlags	 flags,
@@ -194,11 +261,15 @@ void		 cd_icc_add_metadata			(CdIcc		*icc,
 void		 cd_icc_remove_metadata			(CdIcc		*icc,
 							 const gchar	*key);
 GPtrArray	*cd_icc_get_named_colors		(CdIcc		*icc);
+guint		 cd_icc_get_named_colors_size		(CdIcc		*icc);
+CdColorSwatch	*cd_icc_get_named_color			(CdIcc		*icc,
+							 guint		 idx);
 gboolean	 cd_icc_get_can_delete			(CdIcc		*icc);
 GDateTime	*cd_icc_get_created			(CdIcc		*icc);
 void		 cd_icc_set_created			(CdIcc		*icc,
 							 GDateTime	*creation_time);
 const gchar	*cd_icc_get_checksum			(CdIcc		*icc);
+const gchar	*cd_icc_get_checksum_fast		(CdIcc		*icc);
 const gchar	*cd_icc_get_description			(CdIcc		*icc,
 							 const gchar	*locale,
 							 GError		**error);
@@ -260,6 +331,9 @@ gboolean	 cd_icc_create_default_full		(CdIcc		*icc,
 							 CdIccLoadFlags	 flags,
 							 GError		**error)
 							 G_GNUC_WARN_UNUSED_RESULT;
+CdIcc		*cd_icc_get_standard_space		(CdStandardSpace standard_space,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
 GPtrArray	*cd_icc_get_vcgt			(CdIcc		*icc,
 							 guint		 size,
 							 GError		**error)
@@ -268,12 +342,21 @@ gboolean	 cd_icc_set_vcgt			(CdIcc		*icc,
 							 GPtrArray	*vcgt,
 							 GError		**error)
 							 G_GNUC_WARN_UNUSED_RESULT;
+gboolean	 cd_icc_set_vcgt_full			(CdIcc		*icc,
+							 const guint16	*red,
+							 const guint16	*green,
+							 const guint16	*blue,
+							 gsize		 size,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
 GPtrArray	*cd_icc_get_response			(CdIcc		*icc,
 							 guint		 size,
 							 GError		**error)
 							 G_GNUC_WARN_UNUSED_RESULT;
 gchar		**cd_icc_get_tags			(CdIcc		*icc,
 							 GError		**error);
+GArray		*cd_icc_get_tag_table			(CdIcc		*icc,
+							 GError		**error);
 GBytes		*cd_icc_get_tag_data			(CdIcc		*icc,
 							 const gchar	*tag,
 							 GError		**error);
@@ -49,6 +49,8 @@ typedef struct
 	gdouble			*slope_t;	/* slope */
 	gdouble			*polynom_c;	/* coefficient C */
 	gdouble			*polynom_d;	/* coefficient D */
+	gboolean		 uniform;	/* evenly spaced x data */
+	gdouble			 step_inv;
 } CdInterpAkimaPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (CdInterpAkima, cd_interp_akima, CD_TYPE_INTERP)
@@ -148,6 +150,21 @@ cd_interp_akima_prepare (CdInterp *interp, GError **error)
 		priv->polynom_c[i] = (3 * slope_m[i] - 2 * priv->slope_t[i] - priv->slope_t[i+1]) / dx[i];
 		priv->polynom_d[i] = (priv->slope_t[i] + priv->slope_t[i+1] - 2 * slope_m[i]) / (dx[i] * dx[i]);
 	}
+
+	/* the extrapolated end points are constructed on the same grid, so
+	 * if the inserted data was evenly spaced the whole array is too and
+	 * eval can use index arithmetic rather than scanning */
+	if (dx[2] > 0.0) {
+		priv->uniform = TRUE;
+		for (i = 1; i < n; i++) {
+			if (fabs (x[i] - x[0] - dx[2] * i) > dx[2] * 1e-6) {
+				priv->uniform = FALSE;
+				break;
+			}
+		}
+		if (priv->uniform)
+			priv->step_inv = 1.0 / dx[2];
+	}
 	return TRUE;
 }
 
@@ -165,7 +182,13 @@ cd_interp_akima_eval (CdInterp *interp, gdouble value, GError **error)
 	/* find first point to interpolate from */
 	x = &g_array_index (cd_interp_get_x (interp), gdouble, 0);
 	y = &g_array_index (cd_interp_get_y (interp), gdouble, 0);
-	while (value >= x[p]) p++;
+	if (priv->uniform) {
+		gint n = cd_interp_get_x (interp)->len;
+		p = (gint) ((value - x[0]) * priv->step_inv) + 1;
+		p = CLAMP (p, 2, n - 2);
+	} else {
+		while (value >= x[p]) p++;
+	}
 
 	/* evaluate polynomials */
 	xd = value - x[p-1];
@@ -174,6 +197,50 @@ cd_interp_akima_eval (CdInterp *interp, gdouble value, GError **error)
 	return result;
 }
 
+static gboolean
+cd_interp_akima_eval_array (CdInterp *interp,
+			    const gdouble *values,
+			    gdouble *results,
+			    gsize len,
+			    GError **error)
+{
+	CdInterpAkima *interp_akima = CD_INTERP_AKIMA (interp);
+	CdInterpAkimaPrivate *priv = GET_PRIVATE (interp_akima);
+	const gdouble *slope_t = priv->slope_t;
+	const gdouble *polynom_c = priv->polynom_c;
+	const gdouble *polynom_d = priv->polynom_d;
+	const gdouble *x;
+	const gdouble *y;
+	gint n;
+	gsize i;
+
+	/* hoist the data lookup out of the loop; for the common case of a
+	 * uniform grid the per-point work is then branch-free */
+	x = &g_array_index (cd_interp_get_x (interp), gdouble, 0);
+	y = &g_array_index (cd_interp_get_y (interp), gdouble, 0);
+	n = cd_interp_get_x (interp)->len;
+	if (priv->uniform) {
+		const gdouble x0 = x[0];
+		const gdouble step_inv = priv->step_inv;
+		for (i = 0; i < len; i++) {
+			gdouble xd;
+			gint p = (gint) ((values[i] - x0) * step_inv) + 1;
+			p = CLAMP (p, 2, n - 2);
+			xd = values[i] - x[p-1];
+			results[i] = y[p-1] + (slope_t[p-1] + (polynom_c[p-1] + polynom_d[p-1] * xd) * xd) * xd;
+		}
+	} else {
+		for (i = 0; i < len; i++) {
+			gdouble xd;
+			gint p = 2;
+			while (values[i] >= x[p]) p++;
+			xd = values[i] - x[p-1];
+			results[i] = y[p-1] + (slope_t[p-1] + (polynom_c[p-1] + polynom_d[p-1] * xd) * xd) * xd;
+		}
+	}
+	return TRUE;
+}
+
 /*
  * cd_interp_akima_class_init:
  */
@@ -185,6 +252,7 @@ cd_interp_akima_class_init (CdInterpAkimaClass *klass)
 
 	interp_class->prepare = cd_interp_akima_prepare;
 	interp_class->eval = cd_interp_akima_eval;
+	interp_class->eval_array = cd_interp_akima_eval_array;
 	object_class->finalize = cd_interp_akima_finalize;
 }
 
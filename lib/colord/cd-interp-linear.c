@@ -36,11 +36,54 @@
 static void	cd_interp_linear_class_init	(CdInterpLinearClass	*klass);
 static void	cd_interp_linear_init		(CdInterpLinear		*interp_linear);
 
-G_DEFINE_TYPE (CdInterpLinear, cd_interp_linear, CD_TYPE_INTERP)
+#define GET_PRIVATE(o) (cd_interp_linear_get_instance_private (o))
+
+/**
+ * CdInterpLinearPrivate:
+ *
+ * Private #CdInterpLinear data
+ **/
+typedef struct
+{
+	gboolean		 uniform;	/* evenly spaced x data */
+	gdouble			 step_inv;
+} CdInterpLinearPrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE (CdInterpLinear, cd_interp_linear, CD_TYPE_INTERP)
+
+static gboolean
+cd_interp_linear_prepare (CdInterp *interp, GError **error)
+{
+	CdInterpLinear *interp_linear = CD_INTERP_LINEAR (interp);
+	CdInterpLinearPrivate *priv = GET_PRIVATE (interp_linear);
+	const gdouble *x;
+	gdouble step;
+	guint i;
+	guint size;
+
+	/* detect uniform spacing so eval can use index arithmetic rather
+	 * than scanning; VCGT ramps are always inserted like this */
+	size = cd_interp_get_x (interp)->len;
+	if (size < 3)
+		return TRUE;
+	x = &g_array_index (cd_interp_get_x (interp), gdouble, 0);
+	step = (x[size - 1] - x[0]) / (gdouble) (size - 1);
+	if (step <= 0.0)
+		return TRUE;
+	for (i = 1; i < size; i++) {
+		if (fabs (x[i] - x[0] - step * i) > step * 1e-6)
+			return TRUE;
+	}
+	priv->uniform = TRUE;
+	priv->step_inv = 1.0 / step;
+	return TRUE;
+}
 
 static gdouble
 cd_interp_linear_eval (CdInterp *interp, gdouble value, GError **error)
 {
+	CdInterpLinear *interp_linear = CD_INTERP_LINEAR (interp);
+	CdInterpLinearPrivate *priv = GET_PRIVATE (interp_linear);
 	const gdouble *x;
 	const gdouble *y;
 	gint p;
@@ -50,13 +93,58 @@ cd_interp_linear_eval (CdInterp *interp, gdouble value, GError **error)
 	x = &g_array_index (cd_interp_get_x (interp), gdouble, 0);
 	y = &g_array_index (cd_interp_get_y (interp), gdouble, 0);
 	size = cd_interp_get_y (interp)->len;
-	for (p = 0; p < size - 2; p++) {
-		if (x[p+1] >= value)
-			break;
+	if (priv->uniform) {
+		p = (gint) ((value - x[0]) * priv->step_inv);
+		p = CLAMP (p, 0, size - 2);
+	} else {
+		for (p = 0; p < size - 2; p++) {
+			if (x[p+1] >= value)
+				break;
+		}
 	}
 	return y[p] + ((value - x[p]) / (x[p+1] - x[p])) * (y[p+1] - y[p]);
 }
 
+static gboolean
+cd_interp_linear_eval_array (CdInterp *interp,
+			     const gdouble *values,
+			     gdouble *results,
+			     gsize len,
+			     GError **error)
+{
+	CdInterpLinear *interp_linear = CD_INTERP_LINEAR (interp);
+	CdInterpLinearPrivate *priv = GET_PRIVATE (interp_linear);
+	const gdouble *x;
+	const gdouble *y;
+	gsize i;
+	gint size;
+
+	/* hoist the data lookup out of the loop; for the common case of a
+	 * uniform grid the per-point work is then branch-free */
+	x = &g_array_index (cd_interp_get_x (interp), gdouble, 0);
+	y = &g_array_index (cd_interp_get_y (interp), gdouble, 0);
+	size = cd_interp_get_y (interp)->len;
+	if (priv->uniform) {
+		const gdouble x0 = x[0];
+		const gdouble step_inv = priv->step_inv;
+		for (i = 0; i < len; i++) {
+			gint p = (gint) ((values[i] - x0) * step_inv);
+			p = CLAMP (p, 0, size - 2);
+			results[i] = y[p] + ((values[i] - x[p]) / (x[p+1] - x[p])) * (y[p+1] - y[p]);
+		}
+	} else {
+		for (i = 0; i < len; i++) {
+			gint p;
+			for (p = 0; p < size - 2; p++) {
+				if (x[p+1] >= values[i])
+					break;
+			}
+			results[i] = y[p] + ((values[i] - x[p]) / (x[p+1] - x[p])) * (y[p+1] - y[p]);
+		}
+	}
+	return TRUE;
+}
+
 /*
  * cd_interp_linear_class_init:
  */
@@ -64,7 +152,9 @@ static void
 cd_interp_linear_class_init (CdInterpLinearClass *klass)
 {
 	CdInterpClass *interp_class = CD_INTERP_CLASS (klass);
+	interp_class->prepare = cd_interp_linear_prepare;
 	interp_class->eval = cd_interp_linear_eval;
+	interp_class->eval_array = cd_interp_linear_eval_array;
 }
 
 static void
@@ -265,6 +265,89 @@ cd_interp_eval (CdInterp *interp, gdouble value, GError **error)
 	return klass->eval (interp, value, error);
 }
 
+/**
+ * cd_interp_eval_array:
+ * @interp: a #CdInterp instance.
+ * @values: (array length=len): the X co-ordinates
+ * @results: (array length=len): the Y co-ordinates to write
+ * @len: the size of @values and @results
+ * @error: a #GError or %NULL
+ *
+ * Evaluate the interpolation function at an array of points, for instance
+ * when generating a gamma ramp.
+ * You must have called cd_interp_insert() and cd_interp_prepare() before
+ * calling this method.
+ *
+ * Return value: %TRUE for success
+ *
+ * Since: 1.4.6
+ **/
+gboolean
+cd_interp_eval_array (CdInterp *interp,
+		      const gdouble *values,
+		      gdouble *results,
+		      gsize len,
+		      GError **error)
+{
+	CdInterpClass *klass = CD_INTERP_GET_CLASS (interp);
+	CdInterpPrivate *priv = GET_PRIVATE (interp);
+	const gdouble *x;
+	const gdouble *y;
+	gsize i;
+
+	g_return_val_if_fail (CD_IS_INTERP (interp), FALSE);
+	g_return_val_if_fail (values != NULL, FALSE);
+	g_return_val_if_fail (results != NULL, FALSE);
+	g_return_val_if_fail (priv->prepared, FALSE);
+
+	/* no points */
+	if (priv->size == 0) {
+		g_set_error_literal (error,
+				     CD_INTERP_ERROR,
+				     CD_INTERP_ERROR_FAILED,
+				     "no data to evaluate");
+		return FALSE;
+	}
+
+	/* only one point */
+	x = &g_array_index (priv->x, gdouble, 0);
+	y = &g_array_index (priv->y, gdouble, 0);
+	if (priv->size == 1) {
+		for (i = 0; i < len; i++)
+			results[i] = y[0];
+		return TRUE;
+	}
+
+	/* only 2 points */
+	if (priv->size == 2) {
+		gdouble dx, dy, m;
+		dx = x[1] - x[0];
+		dy = y[1] - y[0];
+		m = dy / dx;
+		for (i = 0; i < len; i++)
+			results[i] = y[0] + m * values[i];
+		return TRUE;
+	}
+
+	/* fast path that hoists the setup out of the loop */
+	if (klass != NULL && klass->eval_array != NULL)
+		return klass->eval_array (interp, values, results, len, error);
+
+	/* no support */
+	if (klass == NULL || klass->eval == NULL) {
+		g_set_error_literal (error,
+				     CD_INTERP_ERROR,
+				     CD_INTERP_ERROR_FAILED,
+				     "no superclass");
+		return FALSE;
+	}
+
+	/* fall back to evaluating one point at a time */
+	for (i = 0; i < len; i++)
+		results[i] = klass->eval (interp, values[i], error);
+	return TRUE;
+}
+
 /**
  * cd_interp_get_kind:
  * @interp: a #CdInterp instance.
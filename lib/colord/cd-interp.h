@@ -47,8 +47,13 @@ struct _CdInterpClass
 							 gdouble	 value,
 							 GError		**error)
 							 G_GNUC_WARN_UNUSED_RESULT;
+	gboolean		 (*eval_array)		(CdInterp	*interp,
+							 const gdouble	*values,
+							 gdouble	*results,
+							 gsize		 len,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
 	/* Padding for future expansion */
-	void (*_cd_interp_reserved1) (void);
 	void (*_cd_interp_reserved2) (void);
 	void (*_cd_interp_reserved3) (void);
 	void (*_cd_interp_reserved4) (void);
@@ -99,6 +104,12 @@ gdouble		 cd_interp_eval			(CdInterp	*interp,
 						 gdouble	 value,
 						 GError		**error)
 						 G_GNUC_WARN_UNUSED_RESULT;
+gboolean	 cd_interp_eval_array		(CdInterp	*interp,
+						 const gdouble	*values,
+						 gdouble	*results,
+						 gsize		 len,
+						 GError		**error)
+						 G_GNUC_WARN_UNUSED_RESULT;
 
 const gchar	*cd_interp_kind_to_string	(CdInterpKind	 kind);
 
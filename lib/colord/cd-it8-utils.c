@@ -225,39 +225,182 @@ cd_it8_utils_calculate_ccmx (CdIt8 *it8_reference,
 	return TRUE;
 }
 
+typedef struct {
+	CdIt8		*it8_reference;
+	CdIt8		*it8_measured;
+	CdIt8		*it8_ccmx;
+	gboolean	 ret;
+	GError		*error;
+} CdIt8UtilsCcmxItem;
+
+static void
+cd_it8_utils_calculate_ccmx_thread_cb (gpointer data, gpointer user_data)
+{
+	CdIt8UtilsCcmxItem *item = (CdIt8UtilsCcmxItem *) data;
+	item->ret = cd_it8_utils_calculate_ccmx (item->it8_reference,
+						 item->it8_measured,
+						 item->it8_ccmx,
+						 &item->error);
+}
+
 /**
- * cd_it8_utils_calculate_xyz_from_cmf:
- * @cmf: The color match function
- * @illuminant: The illuminant (you can use cd_spectrum_new() for type E)
- * @spectrum: The #CdSpectrum input data
- * @value: The #CdColorXYZ result
- * @resolution: The resolution in nm, typically 1.0
+ * cd_it8_utils_calculate_ccmx_batch:
+ * @it8_reference: (element-type CdIt8): The reference data sets
+ * @it8_measured: (element-type CdIt8): The measured data sets
+ * @it8_ccmx: (element-type CdIt8): The calculated correction matrices
  * @error: A #GError, or %NULL
  *
- * This calculates the XYZ from a CMF, illuminant and input spectrum.
+ * This calculates a correction matrix for each reference and measured
+ * pair using worker threads, one pair per core. The arrays have to be
+ * the same size and each pair is independent, so generating the
+ * matrices for many sensor and display combinations scales with the
+ * number of processors.
  *
- * Return value: %TRUE if a XYZ value was set.
+ * If any pair fails the first failure is reported, although all pairs
+ * are still processed.
+ *
+ * Return value: %TRUE if all the correction matrices were found.
+ *
+ * Since: 1.4.6
  **/
 gboolean
-cd_it8_utils_calculate_xyz_from_cmf (CdIt8 *cmf,
-				     CdSpectrum *illuminant,
-				     CdSpectrum *spectrum,
-				     CdColorXYZ *value,
-				     gdouble resolution,
-				     GError **error)
+cd_it8_utils_calculate_ccmx_batch (GPtrArray *it8_reference,
+				   GPtrArray *it8_measured,
+				   GPtrArray *it8_ccmx,
+				   GError **error)
 {
-	CdSpectrum *observer[3];
-	gdouble end;
-	gdouble i_val;
-	gdouble o_val;
-	gdouble s_val;
-	gdouble scale = 0.f;
-	gdouble start;
-	gdouble wl;
+	GThreadPool *pool;
+	gboolean ret = TRUE;
+	guint i;
+	g_autofree CdIt8UtilsCcmxItem *items = NULL;
+
+	g_return_val_if_fail (it8_reference != NULL, FALSE);
+	g_return_val_if_fail (it8_measured != NULL, FALSE);
+	g_return_val_if_fail (it8_ccmx != NULL, FALSE);
+	g_return_val_if_fail (it8_reference->len == it8_measured->len, FALSE);
+	g_return_val_if_fail (it8_reference->len == it8_ccmx->len, FALSE);
+
+	/* nothing to do */
+	if (it8_reference->len == 0)
+		return TRUE;
+
+	/* each worker writes only to its own slot */
+	items = g_new0 (CdIt8UtilsCcmxItem, it8_reference->len);
+	pool = g_thread_pool_new (cd_it8_utils_calculate_ccmx_thread_cb,
+				  NULL,
+				  MIN (it8_reference->len,
+				       g_get_num_processors ()),
+				  FALSE,
+				  NULL);
+	for (i = 0; i < it8_reference->len; i++) {
+		items[i].it8_reference = g_ptr_array_index (it8_reference, i);
+		items[i].it8_measured = g_ptr_array_index (it8_measured, i);
+		items[i].it8_ccmx = g_ptr_array_index (it8_ccmx, i);
+		g_thread_pool_push (pool, &items[i], NULL);
+	}
 
-	g_return_val_if_fail (CD_IS_IT8 (cmf), FALSE);
-	g_return_val_if_fail (illuminant != NULL, FALSE);
-	g_return_val_if_fail (value != NULL, FALSE);
+	/* waits for all the workers to finish */
+	g_thread_pool_free (pool, FALSE, TRUE);
+
+	/* the first failure wins */
+	for (i = 0; i < it8_reference->len; i++) {
+		if (items[i].ret)
+			continue;
+		if (ret) {
+			ret = FALSE;
+			g_propagate_error (error, items[i].error);
+		} else {
+			g_error_free (items[i].error);
+		}
+	}
+	return ret;
+}
+
+/**
+ * cd_it8_utils_apply_ccmx_array:
+ * @it8_ccmx: The CCMX correction matrix
+ * @values: (array length=len): the XYZ values, corrected in place
+ * @len: the number of XYZ values
+ * @error: A #GError, or %NULL
+ *
+ * Applies a colorimeter correction matrix to a packed array of XYZ
+ * values in one pass. The matrix is loaded once and the values stream
+ * through cd_mat33_vector_multiply_batch(), so correcting a long sample
+ * sweep costs one call rather than a matrix fetch and multiply per patch.
+ *
+ * Return value: %TRUE if the correction was applied.
+ *
+ * Since: 1.4.6
+ **/
+gboolean
+cd_it8_utils_apply_ccmx_array (CdIt8 *it8_ccmx,
+			       CdColorXYZ *values,
+			       gsize len,
+			       GError **error)
+{
+	const CdMat3x3 *calibration;
+
+	g_return_val_if_fail (CD_IS_IT8 (it8_ccmx), FALSE);
+	g_return_val_if_fail (values != NULL || len == 0, FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	/* check the matrix is usable */
+	if (cd_it8_get_kind (it8_ccmx) != CD_IT8_KIND_CCMX) {
+		g_set_error_literal (error, 1, 0,
+				     "not a CCMX correction matrix");
+		return FALSE;
+	}
+	calibration = cd_it8_get_matrix (it8_ccmx);
+	if (!cd_mat33_is_finite (calibration, error))
+		return FALSE;
+
+	/* a CdColorXYZ is three packed doubles, just like a CdVec3, so
+	 * the whole array can go through the batch kernel in place */
+	G_STATIC_ASSERT (sizeof (CdColorXYZ) == sizeof (CdVec3));
+	cd_mat33_vector_multiply_batch (calibration,
+					(const CdVec3 *) values,
+					(CdVec3 *) values,
+					len);
+	return TRUE;
+}
+
+/* the observer channels and illuminant resampled onto the integration
+ * grid; building this is the expensive part of the integration so it is
+ * done once and then shared by every sample */
+typedef struct {
+	gdouble		 start;
+	gdouble		 end;
+	gdouble		 resolution;
+	gdouble		 scale;
+	guint		 len;
+	const gdouble	*x_data;
+	const gdouble	*y_data;
+	const gdouble	*z_data;
+	const gdouble	*i_data;
+	CdSpectrum	*observer_x_rs;
+	CdSpectrum	*observer_y_rs;
+	CdSpectrum	*observer_z_rs;
+	CdSpectrum	*illuminant_rs;
+} CdIt8UtilsCmfKernel;
+
+static void
+cd_it8_utils_cmf_kernel_clear (CdIt8UtilsCmfKernel *kernel)
+{
+	g_clear_pointer (&kernel->observer_x_rs, cd_spectrum_free);
+	g_clear_pointer (&kernel->observer_y_rs, cd_spectrum_free);
+	g_clear_pointer (&kernel->observer_z_rs, cd_spectrum_free);
+	g_clear_pointer (&kernel->illuminant_rs, cd_spectrum_free);
+}
+
+G_DEFINE_AUTO_CLEANUP_CLEAR_FUNC (CdIt8UtilsCmfKernel, cd_it8_utils_cmf_kernel_clear)
+
+static gboolean
+cd_it8_utils_cmf_kernel_init (CdIt8UtilsCmfKernel *kernel,
+			      CdIt8 *cmf,
+			      gdouble resolution,
+			      GError **error)
+{
+	CdSpectrum *observer[3];
 
 	/* check this is a CMF */
 	if (cd_it8_get_kind (cmf) != CD_IT8_KIND_CMF) {
@@ -278,29 +421,175 @@ cd_it8_utils_calculate_xyz_from_cmf (CdIt8 *cmf,
 		return FALSE;
 	}
 
-	/* calculate the integrals */
-	start = cd_spectrum_get_start (observer[0]);
-	end = cd_spectrum_get_end (observer[0]);
+	/* resample the observer channels onto the integration grid */
+	kernel->resolution = resolution;
+	kernel->start = cd_spectrum_get_start (observer[0]);
+	kernel->end = cd_spectrum_get_end (observer[0]);
+	kernel->observer_x_rs = cd_spectrum_resample (observer[0],
+						      kernel->start,
+						      kernel->end,
+						      resolution);
+	kernel->observer_y_rs = cd_spectrum_resample (observer[1],
+						      kernel->start,
+						      kernel->end,
+						      resolution);
+	kernel->observer_z_rs = cd_spectrum_resample (observer[2],
+						      kernel->start,
+						      kernel->end,
+						      resolution);
+	kernel->x_data = cd_spectrum_get_data_raw (kernel->observer_x_rs);
+	kernel->y_data = cd_spectrum_get_data_raw (kernel->observer_y_rs);
+	kernel->z_data = cd_spectrum_get_data_raw (kernel->observer_z_rs);
+	return TRUE;
+}
+
+/* the illuminant can be swapped without rebuilding the observer data */
+static void
+cd_it8_utils_cmf_kernel_set_illuminant (CdIt8UtilsCmfKernel *kernel,
+					CdSpectrum *illuminant)
+{
+	guint j;
+
+	g_clear_pointer (&kernel->illuminant_rs, cd_spectrum_free);
+	kernel->illuminant_rs = cd_spectrum_resample (illuminant,
+						      kernel->start,
+						      kernel->end,
+						      kernel->resolution);
+	kernel->i_data = cd_spectrum_get_data_raw (kernel->illuminant_rs);
+	kernel->len = MIN (cd_spectrum_get_size (kernel->observer_x_rs),
+			   cd_spectrum_get_size (kernel->illuminant_rs));
+
+	/* the Y scale factor is the same for every sample */
+	kernel->scale = 0.f;
+	for (j = 0; j < kernel->len; j++)
+		kernel->scale += kernel->i_data[j] * kernel->y_data[j];
+}
+
+static void
+cd_it8_utils_cmf_kernel_eval (CdIt8UtilsCmfKernel *kernel,
+			      CdSpectrum *spectrum,
+			      CdColorXYZ *value)
+{
+	gdouble c1 = -1.f;
+	guint j;
+
 	cd_color_xyz_clear (value);
-	for (wl = start; wl <= end; wl += resolution) {
-		i_val = cd_spectrum_get_value_for_nm (illuminant, wl);
-		s_val = cd_spectrum_get_value_for_nm (spectrum, wl);
-		o_val = cd_spectrum_get_value_for_nm (observer[0], wl);
-		value->X += i_val * o_val * s_val;
-		o_val = cd_spectrum_get_value_for_nm (observer[1], wl);
-		scale += i_val * o_val;
-		value->Y += i_val * o_val * s_val;
-		o_val = cd_spectrum_get_value_for_nm (observer[2], wl);
-		value->Z += i_val * o_val * s_val;
+
+	/* fast path: the sample is already on the integration grid, so the
+	 * raw values can be accumulated with no resampling or allocation */
+	cd_spectrum_get_wavelength_cal (spectrum, &c1, NULL, NULL);
+	if (c1 < 0 &&
+	    cd_spectrum_get_size (spectrum) > 1 &&
+	    fabs (cd_spectrum_get_start (spectrum) - kernel->start) < 0.01f &&
+	    fabs (cd_spectrum_get_end (spectrum) - kernel->end) < 0.01f &&
+	    fabs (cd_spectrum_get_resolution (spectrum) - kernel->resolution) < 0.01f) {
+		const gdouble *s_data = cd_spectrum_get_data_raw (spectrum);
+		gdouble norm = cd_spectrum_get_norm (spectrum);
+		guint len_sample = MIN (kernel->len, cd_spectrum_get_size (spectrum));
+		for (j = 0; j < len_sample; j++) {
+			gdouble is_val = kernel->i_data[j] * s_data[j] * norm;
+			value->X += is_val * kernel->x_data[j];
+			value->Y += is_val * kernel->y_data[j];
+			value->Z += is_val * kernel->z_data[j];
+		}
+	} else {
+		for (j = 0; j < kernel->len; j++) {
+			gdouble nm = kernel->start + ((gdouble) j * kernel->resolution);
+			gdouble is_val = kernel->i_data[j] *
+					 cd_spectrum_get_value_for_nm (spectrum, nm);
+			value->X += is_val * kernel->x_data[j];
+			value->Y += is_val * kernel->y_data[j];
+			value->Z += is_val * kernel->z_data[j];
+		}
 	}
 
 	/* scale by Y */
-	value->X /= scale;
-	value->Y /= scale;
-	value->Z /= scale;
+	value->X /= kernel->scale;
+	value->Y /= kernel->scale;
+	value->Z /= kernel->scale;
+}
+
+/**
+ * cd_it8_utils_calculate_xyz_from_cmf_batch:
+ * @cmf: The color match function
+ * @illuminant: The illuminant (you can use cd_spectrum_new() for type E)
+ * @spectra: (element-type CdSpectrum): The #CdSpectrum input data
+ * @values: (array): Caller-allocated array of results, one per spectrum
+ * @resolution: The resolution in nm, typically 1.0
+ * @error: A #GError, or %NULL
+ *
+ * This calculates the XYZ for a set of input spectra that share the same
+ * CMF and illuminant. The observer channels and the illuminant are
+ * resampled onto the integration grid just once, so this is much cheaper
+ * than calling cd_it8_utils_calculate_xyz_from_cmf() once per spectrum.
+ *
+ * Return value: %TRUE if the XYZ values were set.
+ *
+ * Since: 1.4.6
+ **/
+gboolean
+cd_it8_utils_calculate_xyz_from_cmf_batch (CdIt8 *cmf,
+					   CdSpectrum *illuminant,
+					   GPtrArray *spectra,
+					   CdColorXYZ *values,
+					   gdouble resolution,
+					   GError **error)
+{
+	guint i;
+	g_auto(CdIt8UtilsCmfKernel) kernel = { 0 };
+
+	g_return_val_if_fail (CD_IS_IT8 (cmf), FALSE);
+	g_return_val_if_fail (illuminant != NULL, FALSE);
+	g_return_val_if_fail (spectra != NULL, FALSE);
+	g_return_val_if_fail (values != NULL, FALSE);
+
+	if (!cd_it8_utils_cmf_kernel_init (&kernel, cmf, resolution, error))
+		return FALSE;
+	cd_it8_utils_cmf_kernel_set_illuminant (&kernel, illuminant);
+	for (i = 0; i < spectra->len; i++) {
+		cd_it8_utils_cmf_kernel_eval (&kernel,
+					      g_ptr_array_index (spectra, i),
+					      &values[i]);
+	}
 	return TRUE;
 }
 
+/**
+ * cd_it8_utils_calculate_xyz_from_cmf:
+ * @cmf: The color match function
+ * @illuminant: The illuminant (you can use cd_spectrum_new() for type E)
+ * @spectrum: The #CdSpectrum input data
+ * @value: The #CdColorXYZ result
+ * @resolution: The resolution in nm, typically 1.0
+ * @error: A #GError, or %NULL
+ *
+ * This calculates the XYZ from a CMF, illuminant and input spectrum.
+ *
+ * Return value: %TRUE if a XYZ value was set.
+ **/
+gboolean
+cd_it8_utils_calculate_xyz_from_cmf (CdIt8 *cmf,
+				     CdSpectrum *illuminant,
+				     CdSpectrum *spectrum,
+				     CdColorXYZ *value,
+				     gdouble resolution,
+				     GError **error)
+{
+	g_autoptr(GPtrArray) spectra = NULL;
+
+	g_return_val_if_fail (spectrum != NULL, FALSE);
+	g_return_val_if_fail (value != NULL, FALSE);
+
+	spectra = g_ptr_array_new ();
+	g_ptr_array_add (spectra, spectrum);
+	return cd_it8_utils_calculate_xyz_from_cmf_batch (cmf,
+							  illuminant,
+							  spectra,
+							  value,
+							  resolution,
+							  error);
+}
+
 /**
  * cd_it8_utils_calculate_cri_from_cmf:
  * @cmf: The color match function
@@ -328,28 +617,27 @@ cd_it8_utils_calculate_cri_from_cmf (CdIt8 *cmf,
 	CdColorUVW unknown_uvw[8];
 	CdColorXYZ illuminant_xyz;
 	CdColorXYZ reference_illuminant_xyz;
-	CdColorXYZ sample_xyz;
+	CdColorXYZ sample_xyz[8];
 	CdColorYxy yxy;
-	CdSpectrum *sample;
-	CdSpectrum *unity;
+	CdIt8UtilsCmfKernel *kernel_ref;
 	GPtrArray *samples;
-	gboolean ret;
 	gdouble cct;
 	gdouble ri_sum = 0.f;
 	gdouble val;
 	guint i;
+	g_auto(CdIt8UtilsCmfKernel) kernel = { 0 };
+	g_auto(CdIt8UtilsCmfKernel) kernel_1nm = { 0 };
 	g_autoptr(CdSpectrum) reference_illuminant = NULL;
+	g_autoptr(CdSpectrum) unity = NULL;
+
+	/* resample the CMF just once for the whole calculation */
+	if (!cd_it8_utils_cmf_kernel_init (&kernel, cmf, resolution, error))
+		return FALSE;
 
 	/* get the illuminant CCT */
 	unity = cd_spectrum_new ();
-	ret = cd_it8_utils_calculate_xyz_from_cmf (cmf,
-						   unity,
-						   illuminant,
-						   &illuminant_xyz,
-						   resolution,
-						   error);
-	if (!ret)
-		return FALSE;
+	cd_it8_utils_cmf_kernel_set_illuminant (&kernel, unity);
+	cd_it8_utils_cmf_kernel_eval (&kernel, illuminant, &illuminant_xyz);
 	cct = cd_color_xyz_to_cct (&illuminant_xyz);
 	cd_color_xyz_normalize (&illuminant_xyz, 1.0, &illuminant_xyz);
 
@@ -364,14 +652,9 @@ cd_it8_utils_calculate_cri_from_cmf (CdIt8 *cmf,
 		return FALSE;
 	}
 	cd_spectrum_normalize (reference_illuminant, 560, 1.0);
-	ret = cd_it8_utils_calculate_xyz_from_cmf (cmf,
-						   unity,
-						   reference_illuminant,
-						   &reference_illuminant_xyz,
-						   resolution,
-						   error);
-	if (!ret)
-		return FALSE;
+	cd_it8_utils_cmf_kernel_eval (&kernel,
+				      reference_illuminant,
+				      &reference_illuminant_xyz);
 
 	/* check the source is white enough */
 	cd_color_uvw_set_planckian_locus (&d1, cct);
@@ -386,36 +669,35 @@ cd_it8_utils_calculate_cri_from_cmf (CdIt8 *cmf,
 		return FALSE;
 	}
 
+	/* the reference pass always integrates at 1nm; only build a second
+	 * kernel when the caller asked for something else */
+	if (fabs (resolution - 1.f) < 0.01f) {
+		kernel_ref = &kernel;
+	} else {
+		if (!cd_it8_utils_cmf_kernel_init (&kernel_1nm, cmf, 1.f, error))
+			return FALSE;
+		kernel_ref = &kernel_1nm;
+	}
+
 	/* get the XYZ for each color sample under the reference illuminant */
 	samples = cd_it8_get_spectrum_array (tcs);
+	cd_it8_utils_cmf_kernel_set_illuminant (kernel_ref, reference_illuminant);
 	for (i = 0; i < 8; i++) {
-		sample = g_ptr_array_index (samples, i);
-		ret = cd_it8_utils_calculate_xyz_from_cmf (cmf,
-							   reference_illuminant,
-							   sample,
-							   &sample_xyz,
-							   1.f,
-							   error);
-		if (!ret)
-			return FALSE;
-		cd_color_xyz_to_uvw (&sample_xyz,
+		cd_it8_utils_cmf_kernel_eval (kernel_ref,
+					      g_ptr_array_index (samples, i),
+					      &sample_xyz[i]);
+		cd_color_xyz_to_uvw (&sample_xyz[i],
 				     &illuminant_xyz,
 				     &reference_uvw[i]);
 	}
 
 	/* get the XYZ for each color sample under the unknown illuminant */
-	samples = cd_it8_get_spectrum_array (tcs);
+	cd_it8_utils_cmf_kernel_set_illuminant (&kernel, illuminant);
 	for (i = 0; i < 8; i++) {
-		sample = g_ptr_array_index (samples, i);
-		ret = cd_it8_utils_calculate_xyz_from_cmf (cmf,
-							   illuminant,
-							   sample,
-							   &sample_xyz,
-							   resolution,
-							   error);
-		if (!ret)
-			return FALSE;
-		cd_color_xyz_to_uvw (&sample_xyz,
+		cd_it8_utils_cmf_kernel_eval (&kernel,
+					      g_ptr_array_index (samples, i),
+					      &sample_xyz[i]);
+		cd_color_xyz_to_uvw (&sample_xyz[i],
 				     &illuminant_xyz,
 				     &unknown_uvw[i]);
 	}
@@ -451,6 +733,89 @@ _cd_color_rgb_is_gray (CdColorRGB *rgb, gdouble delta)
 	return TRUE;
 }
 
+/* fits y = x^gamma to the normalized luminance ramp using damped
+ * least-squares; the residual and Jacobian passes are plain loops over
+ * contiguous arrays so the compiler can vectorize them */
+static gdouble
+cd_it8_utils_fit_gamma (const gdouble *data_y, guint cnt)
+{
+	gdouble cost = 0.f;
+	gdouble gamma = 0.f;
+	gdouble lambda = 1e-3;
+	gdouble num = 0.f;
+	gdouble den = 0.f;
+	guint i;
+	guint iter;
+	g_autofree gdouble *ln_x = NULL;
+	g_autofree gdouble *resid = NULL;
+
+	/* need at least two non-trivial samples */
+	if (cnt < 3)
+		return -1.f;
+
+	/* closed-form seed from the log-log regression through the
+	 * origin; x = 0 is skipped as it carries no gamma information */
+	ln_x = g_new0 (gdouble, cnt);
+	resid = g_new0 (gdouble, cnt);
+	for (i = 1; i < cnt; i++)
+		ln_x[i] = log ((gdouble) i / (gdouble) (cnt - 1));
+	for (i = 1; i < cnt; i++) {
+		if (data_y[i] <= 0.f)
+			continue;
+		num += ln_x[i] * log (data_y[i]);
+		den += ln_x[i] * ln_x[i];
+	}
+	if (den <= 0.f)
+		return -1.f;
+	gamma = num / den;
+	if (gamma <= 0.f)
+		return -1.f;
+
+	/* refine in the linear domain, damping the normal equations so a
+	 * poor seed or noisy readings cannot make the step diverge */
+	for (i = 1; i < cnt; i++)
+		resid[i] = exp (gamma * ln_x[i]) - data_y[i];
+	for (i = 1; i < cnt; i++)
+		cost += resid[i] * resid[i];
+	for (iter = 0; iter < 50; iter++) {
+		gdouble cost_new = 0.f;
+		gdouble gamma_new;
+		gdouble jtj = 0.f;
+		gdouble jtr = 0.f;
+		gdouble step;
+
+		/* the Jacobian of x^gamma w.r.t. gamma is x^gamma ln(x) */
+		for (i = 1; i < cnt; i++) {
+			gdouble jac = (resid[i] + data_y[i]) * ln_x[i];
+			jtj += jac * jac;
+			jtr += jac * resid[i];
+		}
+		step = -jtr / (jtj + lambda);
+		gamma_new = gamma + step;
+		if (gamma_new <= 0.f) {
+			lambda *= 8;
+			continue;
+		}
+		for (i = 1; i < cnt; i++)
+			resid[i] = exp (gamma_new * ln_x[i]) - data_y[i];
+		for (i = 1; i < cnt; i++)
+			cost_new += resid[i] * resid[i];
+		if (cost_new > cost) {
+			/* rejected: restore the residuals and damp harder */
+			for (i = 1; i < cnt; i++)
+				resid[i] = exp (gamma * ln_x[i]) - data_y[i];
+			lambda *= 8;
+			continue;
+		}
+		gamma = gamma_new;
+		cost = cost_new;
+		lambda /= 4;
+		if (fabs (step) < 1e-7)
+			break;
+	}
+	return gamma;
+}
+
 /**
  * cd_it8_utils_calculate_gamma:
  * @it8: The reference data
@@ -468,17 +833,16 @@ cd_it8_utils_calculate_gamma (CdIt8 *it8, gdouble *gamma_y, GError **error)
 {
 	CdColorRGB rgb;
 	CdColorXYZ xyz;
-	cmsToneCurve *curve;
 	gdouble len;
 	gdouble max = 0.f;
 	guint cnt = 0;
 	guint i;
 	gdouble gamma_tmp = 0.f;
-	g_autofree cmsFloat32Number *data_y = NULL;
+	g_autofree gdouble *data_y = NULL;
 
 	/* find the grey gamma ramp */
 	len = cd_it8_get_data_size (it8);
-	data_y = g_new0 (cmsFloat32Number, len);
+	data_y = g_new0 (gdouble, len);
 	for (i = 0; i < len; i++) {
 		cd_it8_get_data_item (it8, i, &rgb, &xyz);
 		/* ignore if not R == G == B */
@@ -513,9 +877,8 @@ cd_it8_utils_calculate_gamma (CdIt8 *it8, gdouble *gamma_y, GError **error)
 	for (i = 0; i < cnt; i++)
 		data_y[i] /= max;
 
-	/* use lcms2 to calculate the gamma */
-	curve = cmsBuildTabulatedToneCurveFloat (NULL, cnt, data_y);
-	gamma_tmp = cmsEstimateGamma (curve, 0.1);
+	/* fit y = x^gamma to the whole ramp at once */
+	gamma_tmp = cd_it8_utils_fit_gamma (data_y, cnt);
 	if (gamma_tmp < 0) {
 		g_autoptr(GString) str = NULL;
 		str = g_string_new ("Unable to calculate gamma from: ");
@@ -530,6 +893,5 @@ cd_it8_utils_calculate_gamma (CdIt8 *it8, gdouble *gamma_y, GError **error)
 	}
 	if (gamma_y != NULL)
 		*gamma_y = gamma_tmp;
-	cmsFreeToneCurve (curve);
 	return TRUE;
 }
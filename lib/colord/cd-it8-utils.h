@@ -38,6 +38,16 @@ gboolean	 cd_it8_utils_calculate_ccmx		(CdIt8		*it8_reference,
 							 CdIt8		*it8_ccmx,
 							 GError		**error)
 							 G_GNUC_WARN_UNUSED_RESULT;
+gboolean	 cd_it8_utils_calculate_ccmx_batch	(GPtrArray	*it8_reference,
+							 GPtrArray	*it8_measured,
+							 GPtrArray	*it8_ccmx,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
+gboolean	 cd_it8_utils_apply_ccmx_array	(CdIt8		*it8_ccmx,
+							 CdColorXYZ	*values,
+							 gsize		 len,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
 gboolean	 cd_it8_utils_calculate_xyz_from_cmf	(CdIt8		*cmf,
 							 CdSpectrum	*illuminant,
 							 CdSpectrum	*spectrum,
@@ -45,6 +55,13 @@ gboolean	 cd_it8_utils_calculate_xyz_from_cmf	(CdIt8		*cmf,
 							 gdouble	 resolution,
 							 GError		**error)
 							 G_GNUC_WARN_UNUSED_RESULT;
+gboolean	 cd_it8_utils_calculate_xyz_from_cmf_batch (CdIt8	*cmf,
+							 CdSpectrum	*illuminant,
+							 GPtrArray	*spectra,
+							 CdColorXYZ	*values,
+							 gdouble	 resolution,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
 gboolean	 cd_it8_utils_calculate_cri_from_cmf	(CdIt8		*cmf,
 							 CdIt8		*tcs,
 							 CdSpectrum	*illuminant,
@@ -30,6 +30,7 @@
 #include "config.h"
 
 #include <glib.h>
+#include <glib/gstdio.h>
 #include <lcms2.h>
 #include <stdlib.h>
 #include <string.h>
@@ -41,9 +42,13 @@
 static void	cd_it8_class_init	(CdIt8Class	*klass);
 static void	cd_it8_init		(CdIt8		*it8);
 static void	cd_it8_finalize		(GObject	*object);
+static void	cd_it8_invalidate_spectra_index (CdIt8 *it8);
 
 #define GET_PRIVATE(o) (cd_it8_get_instance_private (o))
 
+#define CD_IT8_BINARY_MAGIC		"CdIt8Bin"
+#define CD_IT8_BINARY_FORMAT_VERSION	1
+
 /**
  * CdIt8Private:
  *
@@ -62,9 +67,11 @@ typedef struct
 	gchar			*originator;
 	gchar			*title;
 	GPtrArray		*array_spectra;
-	GPtrArray		*array_rgb;
-	GPtrArray		*array_xyz;
+	GHashTable		*spectra_by_id;	/* lazy, borrowed values */
+	GArray			*array_rgb;	/* of CdColorRGB */
+	GArray			*array_xyz;	/* of CdColorXYZ */
 	GPtrArray		*options;
+	GHashTable		*options_set;	/* lazy, borrowed keys */
 } CdIt8Private;
 
 enum {
@@ -146,6 +153,232 @@ _cmsIT8GetDataRowColDbl (cmsHANDLE it8_lcms, gint row, gint col)
 	return g_ascii_strtod (value, NULL);
 }
 
+/* a whitespace delimited run of characters in the mapped file */
+typedef struct {
+	const gchar	*str;
+	guint		 len;
+} CdIt8CgatsToken;
+
+/* minimal CGATS reader for the well-formed sheet types we write
+ * ourselves; the data tokens are views into the mapped file so bulk
+ * loads do not pay for the allocating lcms tokenizer */
+typedef struct {
+	gchar		*sheet_type;
+	GHashTable	*properties;
+	guint		 cols;
+	GArray		*data;
+} CdIt8Cgats;
+
+static void
+cd_it8_cgats_free (CdIt8Cgats *cgats)
+{
+	g_free (cgats->sheet_type);
+	g_hash_table_unref (cgats->properties);
+	g_array_unref (cgats->data);
+	g_free (cgats);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(CdIt8Cgats, cd_it8_cgats_free)
+
+static gboolean
+cd_it8_cgats_token_is (const CdIt8CgatsToken *token, const gchar *str)
+{
+	return strlen (str) == token->len &&
+	       memcmp (token->str, str, token->len) == 0;
+}
+
+static gchar *
+cd_it8_cgats_token_strdup (const CdIt8CgatsToken *token)
+{
+	/* strip optional quotes */
+	if (token->len >= 2 &&
+	    token->str[0] == '"' &&
+	    token->str[token->len - 1] == '"')
+		return g_strndup (token->str + 1, token->len - 2);
+	return g_strndup (token->str, token->len);
+}
+
+static gboolean
+cd_it8_cgats_next_token (const gchar **p,
+			 const gchar *end,
+			 CdIt8CgatsToken *token)
+{
+	const gchar *start;
+
+	/* skip whitespace, stopping at any comment */
+	while (*p < end && (**p == ' ' || **p == '\t' || **p == '\r'))
+		(*p)++;
+	if (*p >= end || **p == '#')
+		return FALSE;
+	start = *p;
+	if (**p == '"') {
+		(*p)++;
+		while (*p < end && **p != '"')
+			(*p)++;
+		if (*p < end)
+			(*p)++;
+	} else {
+		while (*p < end && **p != ' ' && **p != '\t' &&
+		       **p != '\r' && **p != '#')
+			(*p)++;
+	}
+	token->str = start;
+	token->len = *p - start;
+	return TRUE;
+}
+
+static CdIt8Cgats *
+cd_it8_cgats_parse (const gchar *data, gsize size, GError **error)
+{
+	gboolean in_data = FALSE;
+	gboolean in_format = FALSE;
+	gsize i = 0;
+	g_autoptr(CdIt8Cgats) cgats = NULL;
+
+	cgats = g_new0 (CdIt8Cgats, 1);
+	cgats->properties = g_hash_table_new_full (g_str_hash, g_str_equal,
+						   g_free, g_free);
+	cgats->data = g_array_new (FALSE, FALSE, sizeof (CdIt8CgatsToken));
+
+	while (i < size) {
+		CdIt8CgatsToken token;
+		const gchar *line = data + i;
+		const gchar *line_end = memchr (line, '\n', size - i);
+		gsize line_len = line_end != NULL ? (gsize) (line_end - line) : size - i;
+		const gchar *end = line + line_len;
+		const gchar *p = line;
+		i += line_len + 1;
+
+		if (!cd_it8_cgats_next_token (&p, end, &token))
+			continue;
+
+		/* the sheet type is the whole first non-blank line */
+		if (cgats->sheet_type == NULL) {
+			while (line_len > 0 && (line[line_len - 1] == '\r' ||
+						line[line_len - 1] == ' ' ||
+						line[line_len - 1] == '\t'))
+				line_len--;
+			cgats->sheet_type = g_strndup (line, line_len);
+			continue;
+		}
+		if (cd_it8_cgats_token_is (&token, "BEGIN_DATA_FORMAT")) {
+			in_format = TRUE;
+			continue;
+		}
+		if (cd_it8_cgats_token_is (&token, "END_DATA_FORMAT")) {
+			in_format = FALSE;
+			continue;
+		}
+		if (cd_it8_cgats_token_is (&token, "BEGIN_DATA")) {
+			in_data = TRUE;
+			continue;
+		}
+		if (cd_it8_cgats_token_is (&token, "END_DATA")) {
+			in_data = FALSE;
+			continue;
+		}
+		if (in_format) {
+			cgats->cols++;
+			while (cd_it8_cgats_next_token (&p, end, &token))
+				cgats->cols++;
+			continue;
+		}
+		if (in_data) {
+			g_array_append_val (cgats->data, token);
+			while (cd_it8_cgats_next_token (&p, end, &token))
+				g_array_append_val (cgats->data, token);
+			continue;
+		}
+
+		/* a 'NAME value' property line */
+		{
+			CdIt8CgatsToken value;
+			gchar *name = cd_it8_cgats_token_strdup (&token);
+			if (cd_it8_cgats_next_token (&p, end, &value)) {
+				g_hash_table_replace (cgats->properties, name,
+						      cd_it8_cgats_token_strdup (&value));
+			} else {
+				g_hash_table_replace (cgats->properties, name,
+						      g_strdup (""));
+			}
+		}
+	}
+
+	/* sanity check the table shape */
+	if (cgats->sheet_type == NULL) {
+		g_set_error_literal (error,
+				     CD_IT8_ERROR,
+				     CD_IT8_ERROR_INVALID_FORMAT,
+				     "no CGATS sheet type");
+		return NULL;
+	}
+	if (cgats->cols > 0 && cgats->data->len % cgats->cols != 0) {
+		g_set_error (error,
+			     CD_IT8_ERROR,
+			     CD_IT8_ERROR_INVALID_FORMAT,
+			     "CGATS data not rectangular: %u tokens, %u fields",
+			     cgats->data->len, cgats->cols);
+		return NULL;
+	}
+	return g_steal_pointer (&cgats);
+}
+
+static const gchar *
+cd_it8_cgats_get_property (CdIt8Cgats *cgats, const gchar *key)
+{
+	return g_hash_table_lookup (cgats->properties, key);
+}
+
+static gdouble
+cd_it8_cgats_get_data_dbl (CdIt8Cgats *cgats, guint row, guint col)
+{
+	CdIt8CgatsToken *token;
+	guint idx = row * cgats->cols + col;
+	if (cgats->cols == 0 || idx >= cgats->data->len)
+		return -1;
+	token = &g_array_index (cgats->data, CdIt8CgatsToken, idx);
+	return g_ascii_strtod (token->str, NULL);
+}
+
+/* the loaders for the common sheet kinds work against either parser so
+ * the fast path does not have to duplicate them */
+typedef struct {
+	cmsHANDLE	 it8_lcms;
+	CdIt8Cgats	*cgats;
+} CdIt8Sheet;
+
+static const gchar *
+cd_it8_sheet_get_property (CdIt8Sheet *sheet, const gchar *key)
+{
+	if (sheet->cgats != NULL)
+		return cd_it8_cgats_get_property (sheet->cgats, key);
+	return cmsIT8GetProperty (sheet->it8_lcms, key);
+}
+
+static guint
+cd_it8_sheet_get_property_int (CdIt8Sheet *sheet, const gchar *key)
+{
+	const gchar *value;
+	guint64 tmp;
+
+	value = cd_it8_sheet_get_property (sheet, key);
+	if (value == NULL)
+		return 0;
+	tmp = g_ascii_strtoull (value, NULL, 10);
+	if (tmp > G_MAXUINT)
+		return 0;
+
+	return tmp;
+}
+
+static gdouble
+cd_it8_sheet_get_data_dbl (CdIt8Sheet *sheet, guint row, guint col)
+{
+	if (sheet->cgats != NULL)
+		return cd_it8_cgats_get_data_dbl (sheet->cgats, row, col);
+	return _cmsIT8GetDataRowColDbl (sheet->it8_lcms, row, col);
+}
+
 /**
  * _cmsIT8WriteFloat:
  *
@@ -426,16 +659,16 @@ cd_it8_get_spectral (CdIt8 *it8)
 }
 
 static gboolean
-cd_it8_load_ti1_cal (CdIt8 *it8, cmsHANDLE it8_lcms, GError **error)
+cd_it8_load_ti1_cal (CdIt8 *it8, CdIt8Sheet *sheet, GError **error)
 {
 	CdIt8Private *priv = GET_PRIVATE (it8);
-	CdColorRGB *rgb;
-	CdColorXYZ *xyz;
+	CdColorRGB rgb;
+	CdColorXYZ xyz;
 	const gchar *tmp;
 	guint i;
 	guint number_of_sets = 0;
 
-	tmp = cmsIT8GetProperty (it8_lcms, "COLOR_REP");
+	tmp = cd_it8_sheet_get_property (sheet, "COLOR_REP");
 	if (g_strcmp0 (tmp, "RGB") != 0) {
 		g_set_error (error,
 			     CD_IT8_ERROR,
@@ -445,7 +678,7 @@ cd_it8_load_ti1_cal (CdIt8 *it8, cmsHANDLE it8_lcms, GError **error)
 	}
 
 	/* copy out data entries */
-	number_of_sets = _cmsIT8GetPropertyInt (it8_lcms, "NUMBER_OF_SETS");
+	number_of_sets = cd_it8_sheet_get_property_int (sheet, "NUMBER_OF_SETS");
 	if (number_of_sets == 0) {
 		g_set_error_literal (error,
 				     CD_IT8_ERROR,
@@ -454,42 +687,41 @@ cd_it8_load_ti1_cal (CdIt8 *it8, cmsHANDLE it8_lcms, GError **error)
 		return FALSE;
 	}
 
+	cd_it8_set_size_hint (it8, number_of_sets);
 	for (i = 0; i < number_of_sets; i++) {
-		rgb = cd_color_rgb_new ();
-		rgb->R = _cmsIT8GetDataRowColDbl (it8_lcms, i, 1);
-		rgb->G = _cmsIT8GetDataRowColDbl (it8_lcms, i, 2);
-		rgb->B = _cmsIT8GetDataRowColDbl (it8_lcms, i, 3);
+		rgb.R = cd_it8_sheet_get_data_dbl (sheet, i, 1);
+		rgb.G = cd_it8_sheet_get_data_dbl (sheet, i, 2);
+		rgb.B = cd_it8_sheet_get_data_dbl (sheet, i, 3);
 
 		/* ti1 files don't have NORMALIZED_TO_Y_100 so guess on
 		 * the asumption the first patch isn't black */
-		if (rgb->R > 1.0 || rgb->G > 1.0 || rgb->B > 1.0)
+		if (rgb.R > 1.0 || rgb.G > 1.0 || rgb.B > 1.0)
 			priv->normalized = TRUE;
 		if (priv->normalized) {
-			rgb->R /= 100.0f;
-			rgb->G /= 100.0f;
-			rgb->B /= 100.0f;
+			rgb.R /= 100.0f;
+			rgb.G /= 100.0f;
+			rgb.B /= 100.0f;
 		}
-		g_ptr_array_add (priv->array_rgb, rgb);
-		xyz = cd_color_xyz_new ();
-		cd_color_xyz_set (xyz, 0.0, 0.0, 0.0);
-		g_ptr_array_add (priv->array_xyz, xyz);
+		g_array_append_val (priv->array_rgb, rgb);
+		cd_color_xyz_set (&xyz, 0.0, 0.0, 0.0);
+		g_array_append_val (priv->array_xyz, xyz);
 	}
 	return TRUE;
 }
 
 static gboolean
-cd_it8_load_ti3 (CdIt8 *it8, cmsHANDLE it8_lcms, GError **error)
+cd_it8_load_ti3 (CdIt8 *it8, CdIt8Sheet *sheet, GError **error)
 {
 	CdIt8Private *priv = GET_PRIVATE (it8);
-	CdColorRGB *rgb;
+	CdColorRGB rgb;
 	CdColorXYZ luminance;
-	CdColorXYZ *xyz;
+	CdColorXYZ xyz;
 	const gchar *tmp;
 	gboolean scaled_to_y100 = FALSE;
 	guint i;
 	guint number_of_sets = 0;
 
-	tmp = cmsIT8GetProperty (it8_lcms, "COLOR_REP");
+	tmp = cd_it8_sheet_get_property (sheet, "COLOR_REP");
 	if (g_strcmp0 (tmp, "RGB_XYZ") != 0) {
 		g_set_error (error,
 			     CD_IT8_ERROR,
@@ -499,10 +731,10 @@ cd_it8_load_ti3 (CdIt8 *it8, cmsHANDLE it8_lcms, GError **error)
 	}
 
 	/* if normalized, then scale back up */
-	tmp = cmsIT8GetProperty (it8_lcms, "NORMALIZED_TO_Y_100");
+	tmp = cd_it8_sheet_get_property (sheet, "NORMALIZED_TO_Y_100");
 	if (g_strcmp0 (tmp, "YES") == 0) {
 		scaled_to_y100 = TRUE;
-		tmp = cmsIT8GetProperty (it8_lcms, "LUMINANCE_XYZ_CDM2");
+		tmp = cd_it8_sheet_get_property (sheet, "LUMINANCE_XYZ_CDM2");
 		if (!cd_it8_parse_luminance (tmp, &luminance, error))
 			return FALSE;
 	} else {
@@ -510,14 +742,14 @@ cd_it8_load_ti3 (CdIt8 *it8, cmsHANDLE it8_lcms, GError **error)
 	}
 
 	/* set spectral flag */
-	tmp = cmsIT8GetProperty (it8_lcms, "INSTRUMENT_TYPE_SPECTRAL");
+	tmp = cd_it8_sheet_get_property (sheet, "INSTRUMENT_TYPE_SPECTRAL");
 	cd_it8_set_spectral (it8, g_strcmp0 (tmp, "YES") == 0);
 
 	/* set instrument */
-	cd_it8_set_instrument (it8, cmsIT8GetProperty (it8_lcms, "TARGET_INSTRUMENT"));
+	cd_it8_set_instrument (it8, cd_it8_sheet_get_property (sheet, "TARGET_INSTRUMENT"));
 
 	/* copy out data entries */
-	number_of_sets = _cmsIT8GetPropertyInt (it8_lcms, "NUMBER_OF_SETS");
+	number_of_sets = cd_it8_sheet_get_property_int (sheet, "NUMBER_OF_SETS");
 	if (number_of_sets == 0) {
 		g_set_error_literal (error,
 				     CD_IT8_ERROR,
@@ -525,42 +757,41 @@ cd_it8_load_ti3 (CdIt8 *it8, cmsHANDLE it8_lcms, GError **error)
 				     "Invalid format, NUMBER_OF_SETS required");
 		return FALSE;
 	}
+	cd_it8_set_size_hint (it8, number_of_sets);
 	for (i = 0; i < number_of_sets; i++) {
-		rgb = cd_color_rgb_new ();
-		rgb->R = _cmsIT8GetDataRowColDbl (it8_lcms, i, 1);
-		rgb->G = _cmsIT8GetDataRowColDbl (it8_lcms, i, 2);
-		rgb->B = _cmsIT8GetDataRowColDbl (it8_lcms, i, 3);
+		rgb.R = cd_it8_sheet_get_data_dbl (sheet, i, 1);
+		rgb.G = cd_it8_sheet_get_data_dbl (sheet, i, 2);
+		rgb.B = cd_it8_sheet_get_data_dbl (sheet, i, 3);
 		if (scaled_to_y100) {
-			rgb->R /= 100.0f;
-			rgb->G /= 100.0f;
-			rgb->B /= 100.0f;
+			rgb.R /= 100.0f;
+			rgb.G /= 100.0f;
+			rgb.B /= 100.0f;
 		}
-		g_ptr_array_add (priv->array_rgb, rgb);
-		xyz = cd_color_xyz_new ();
-		xyz->X = _cmsIT8GetDataRowColDbl (it8_lcms, i, 4);
-		xyz->Y = _cmsIT8GetDataRowColDbl (it8_lcms, i, 5);
-		xyz->Z = _cmsIT8GetDataRowColDbl (it8_lcms, i, 6);
+		g_array_append_val (priv->array_rgb, rgb);
+		xyz.X = cd_it8_sheet_get_data_dbl (sheet, i, 4);
+		xyz.Y = cd_it8_sheet_get_data_dbl (sheet, i, 5);
+		xyz.Z = cd_it8_sheet_get_data_dbl (sheet, i, 6);
 		if (scaled_to_y100) {
-			xyz->X /= 100.0f;
-			xyz->Y /= 100.0f;
-			xyz->Z /= 100.0f;
-			xyz->X *= luminance.X;
-			xyz->Y *= luminance.Y;
-			xyz->Z *= luminance.Z;
+			xyz.X /= 100.0f;
+			xyz.Y /= 100.0f;
+			xyz.Z /= 100.0f;
+			xyz.X *= luminance.X;
+			xyz.Y *= luminance.Y;
+			xyz.Z *= luminance.Z;
 		}
-		g_ptr_array_add (priv->array_xyz, xyz);
+		g_array_append_val (priv->array_xyz, xyz);
 	}
 	return TRUE;
 }
 
 static gboolean
-cd_it8_load_ccmx (CdIt8 *it8, cmsHANDLE it8_lcms, GError **error)
+cd_it8_load_ccmx (CdIt8 *it8, CdIt8Sheet *sheet, GError **error)
 {
 	CdIt8Private *priv = GET_PRIVATE (it8);
 	const gchar *tmp;
 
 	/* check color format */
-	tmp = cmsIT8GetProperty (it8_lcms, "COLOR_REP");
+	tmp = cd_it8_sheet_get_property (sheet, "COLOR_REP");
 	if (g_strcmp0 (tmp, "XYZ") != 0) {
 		g_set_error (error,
 			     CD_IT8_ERROR,
@@ -570,18 +801,18 @@ cd_it8_load_ccmx (CdIt8 *it8, cmsHANDLE it8_lcms, GError **error)
 	}
 
 	/* set instrument */
-	cd_it8_set_instrument (it8, cmsIT8GetProperty (it8_lcms, "INSTRUMENT"));
+	cd_it8_set_instrument (it8, cd_it8_sheet_get_property (sheet, "INSTRUMENT"));
 
 	/* just load the matrix */
-	priv->matrix.m00 = _cmsIT8GetDataRowColDbl (it8_lcms, 0, 0);
-	priv->matrix.m01 = _cmsIT8GetDataRowColDbl (it8_lcms, 0, 1);
-	priv->matrix.m02 = _cmsIT8GetDataRowColDbl (it8_lcms, 0, 2);
-	priv->matrix.m10 = _cmsIT8GetDataRowColDbl (it8_lcms, 1, 0);
-	priv->matrix.m11 = _cmsIT8GetDataRowColDbl (it8_lcms, 1, 1);
-	priv->matrix.m12 = _cmsIT8GetDataRowColDbl (it8_lcms, 1, 2);
-	priv->matrix.m20 = _cmsIT8GetDataRowColDbl (it8_lcms, 2, 0);
-	priv->matrix.m21 = _cmsIT8GetDataRowColDbl (it8_lcms, 2, 1);
-	priv->matrix.m22 = _cmsIT8GetDataRowColDbl (it8_lcms, 2, 2);
+	priv->matrix.m00 = cd_it8_sheet_get_data_dbl (sheet, 0, 0);
+	priv->matrix.m01 = cd_it8_sheet_get_data_dbl (sheet, 0, 1);
+	priv->matrix.m02 = cd_it8_sheet_get_data_dbl (sheet, 0, 2);
+	priv->matrix.m10 = cd_it8_sheet_get_data_dbl (sheet, 1, 0);
+	priv->matrix.m11 = cd_it8_sheet_get_data_dbl (sheet, 1, 1);
+	priv->matrix.m12 = cd_it8_sheet_get_data_dbl (sheet, 1, 2);
+	priv->matrix.m20 = cd_it8_sheet_get_data_dbl (sheet, 2, 0);
+	priv->matrix.m21 = cd_it8_sheet_get_data_dbl (sheet, 2, 1);
+	priv->matrix.m22 = cd_it8_sheet_get_data_dbl (sheet, 2, 2);
 	return TRUE;
 }
 
@@ -796,6 +1027,14 @@ cd_it8_load_cmf (CdIt8 *it8, cmsHANDLE it8_lcms, GError **error)
 	return TRUE;
 }
 
+/* any change to the options array makes the lookup set stale */
+static void
+cd_it8_invalidate_options_index (CdIt8 *it8)
+{
+	CdIt8Private *priv = GET_PRIVATE (it8);
+	g_clear_pointer (&priv->options_set, g_hash_table_unref);
+}
+
 /**
  * cd_it8_has_option:
  * @it8: a #CdIt8 instance.
@@ -811,18 +1050,145 @@ gboolean
 cd_it8_has_option (CdIt8 *it8, const gchar *option)
 {
 	CdIt8Private *priv = GET_PRIVATE (it8);
-	const gchar *tmp;
 	guint i;
 
 	g_return_val_if_fail (CD_IS_IT8 (it8), FALSE);
 	g_return_val_if_fail (option != NULL, FALSE);
 
-	for (i = 0; i < priv->options->len; i++) {
-		tmp = g_ptr_array_index (priv->options, i);
-		if (g_strcmp0 (tmp, option) == 0)
-			return TRUE;
+	/* index the options on first use; the keys are borrowed from the
+	 * ordered array which is still used for CGATS output */
+	if (priv->options_set == NULL) {
+		priv->options_set = g_hash_table_new (g_str_hash, g_str_equal);
+		for (i = 0; i < priv->options->len; i++) {
+			g_hash_table_add (priv->options_set,
+					  g_ptr_array_index (priv->options, i));
+		}
+	}
+	return g_hash_table_contains (priv->options_set, option);
+}
+
+/* hydrate from the versioned binary blob written by
+ * cd_it8_save_to_data_binary() */
+static gboolean
+cd_it8_load_from_data_binary (CdIt8 *it8,
+			      const gchar *data,
+			      gsize size,
+			      GError **error)
+{
+	CdIt8Private *priv = GET_PRIVATE (it8);
+	const gchar *tmp;
+	gboolean normalized;
+	gboolean spectral;
+	gsize len;
+	guint32 kind;
+	guint32 version;
+	guint i;
+	g_autofree const gchar **options = NULL;
+	g_autoptr(GVariant) dict = NULL;
+	g_autoptr(GVariant) value = NULL;
+	g_autoptr(GVariant) variant = NULL;
+
+	variant = g_variant_new_from_data (G_VARIANT_TYPE ("(ua{sv})"),
+					   data + 8, size - 8,
+					   FALSE, NULL, NULL);
+	if (variant == NULL) {
+		g_set_error_literal (error,
+				     CD_IT8_ERROR,
+				     CD_IT8_ERROR_INVALID_FORMAT,
+				     "Invalid binary it8 data");
+		return FALSE;
+	}
+	g_variant_get (variant, "(u@a{sv})", &version, &dict);
+	if (version != CD_IT8_BINARY_FORMAT_VERSION) {
+		g_set_error (error,
+			     CD_IT8_ERROR,
+			     CD_IT8_ERROR_INVALID_FORMAT,
+			     "Binary it8 version %u not supported", version);
+		return FALSE;
+	}
+
+	/* clear old data */
+	g_array_set_size (priv->array_rgb, 0);
+	g_array_set_size (priv->array_xyz, 0);
+	g_ptr_array_set_size (priv->array_spectra, 0);
+	cd_it8_invalidate_spectra_index (it8);
+	g_ptr_array_set_size (priv->options, 0);
+	cd_it8_invalidate_options_index (it8);
+	cd_mat33_clear (&priv->matrix);
+
+	/* scalar properties */
+	if (g_variant_lookup (dict, "kind", "u", &kind))
+		cd_it8_set_kind (it8, kind);
+	if (g_variant_lookup (dict, "title", "&s", &tmp))
+		cd_it8_set_title (it8, tmp);
+	if (g_variant_lookup (dict, "originator", "&s", &tmp))
+		cd_it8_set_originator (it8, tmp);
+	if (g_variant_lookup (dict, "reference", "&s", &tmp))
+		cd_it8_set_reference (it8, tmp);
+	if (g_variant_lookup (dict, "instrument", "&s", &tmp))
+		cd_it8_set_instrument (it8, tmp);
+	if (g_variant_lookup (dict, "normalized", "b", &normalized))
+		cd_it8_set_normalized (it8, normalized);
+	if (g_variant_lookup (dict, "spectral", "b", &spectral))
+		cd_it8_set_spectral (it8, spectral);
+	if (g_variant_lookup (dict, "options", "^a&s", &options)) {
+		for (i = 0; options[i] != NULL; i++)
+			cd_it8_add_option (it8, options[i]);
+	}
+
+	/* the matrix and patch values are stored as raw doubles */
+	value = g_variant_lookup_value (dict, "matrix", G_VARIANT_TYPE ("ad"));
+	if (value != NULL) {
+		const gdouble *d = g_variant_get_fixed_array (value, &len, sizeof (gdouble));
+		if (len == 9)
+			memcpy (cd_mat33_get_data (&priv->matrix), d, sizeof (gdouble) * 9);
+		g_clear_pointer (&value, g_variant_unref);
+	}
+	value = g_variant_lookup_value (dict, "rgb", G_VARIANT_TYPE ("ad"));
+	if (value != NULL) {
+		const gdouble *d = g_variant_get_fixed_array (value, &len, sizeof (gdouble));
+		for (i = 0; i + 2 < len; i += 3) {
+			CdColorRGB rgb;
+			cd_color_rgb_set (&rgb, d[i], d[i + 1], d[i + 2]);
+			g_array_append_val (priv->array_rgb, rgb);
+		}
+		g_clear_pointer (&value, g_variant_unref);
+	}
+	value = g_variant_lookup_value (dict, "xyz", G_VARIANT_TYPE ("ad"));
+	if (value != NULL) {
+		const gdouble *d = g_variant_get_fixed_array (value, &len, sizeof (gdouble));
+		for (i = 0; i + 2 < len; i += 3) {
+			CdColorXYZ xyz;
+			cd_color_xyz_set (&xyz, d[i], d[i + 1], d[i + 2]);
+			g_array_append_val (priv->array_xyz, xyz);
+		}
+		g_clear_pointer (&value, g_variant_unref);
+	}
+	value = g_variant_lookup_value (dict, "spectra", G_VARIANT_TYPE ("a(sdddad)"));
+	if (value != NULL) {
+		for (i = 0; i < g_variant_n_children (value); i++) {
+			const gchar *id;
+			const gdouble *d;
+			gdouble start, end, norm;
+			guint j;
+			g_autoptr(CdSpectrum) spectrum = NULL;
+			g_autoptr(GVariant) samples = NULL;
+			g_autoptr(GVariant) child = g_variant_get_child_value (value, i);
+			g_variant_get (child, "(&sddd@ad)",
+				       &id, &start, &end, &norm, &samples);
+			d = g_variant_get_fixed_array (samples, &len, sizeof (gdouble));
+			spectrum = cd_spectrum_sized_new (len);
+			if (id[0] != '\0')
+				cd_spectrum_set_id (spectrum, id);
+			for (j = 0; j < len; j++)
+				cd_spectrum_add_value (spectrum, d[j]);
+			cd_spectrum_set_start (spectrum, start);
+			cd_spectrum_set_end (spectrum, end);
+			cd_spectrum_set_norm (spectrum, norm);
+			cd_it8_add_spectrum (it8, spectrum);
+		}
 	}
-	return FALSE;
+	return TRUE;
 }
 
 /**
@@ -845,6 +1211,7 @@ cd_it8_load_from_data (CdIt8 *it8,
 		       GError **error)
 {
 	CdIt8Private *priv = GET_PRIVATE (it8);
+	CdIt8Sheet sheet = { NULL, NULL };
 	cmsHANDLE it8_lcms = NULL;
 	const gchar *tmp;
 	gboolean ret = TRUE;
@@ -856,10 +1223,15 @@ cd_it8_load_from_data (CdIt8 *it8,
 	g_return_val_if_fail (data != NULL, FALSE);
 	g_return_val_if_fail (size > 0, FALSE);
 
+	/* the compact binary format used between pipeline stages */
+	if (size >= 8 && memcmp (data, CD_IT8_BINARY_MAGIC, 8) == 0)
+		return cd_it8_load_from_data_binary (it8, data, size, error);
+
 	/* clear old data */
-	g_ptr_array_set_size (priv->array_rgb, 0);
-	g_ptr_array_set_size (priv->array_xyz, 0);
+	g_array_set_size (priv->array_rgb, 0);
+	g_array_set_size (priv->array_xyz, 0);
 	g_ptr_array_set_size (priv->options, 0);
+	cd_it8_invalidate_options_index (it8);
 	cd_mat33_clear (&priv->matrix);
 
 	/* load the it8 data */
@@ -914,20 +1286,21 @@ cd_it8_load_from_data (CdIt8 *it8,
 	}
 
 	/* get ti1 and ti3 specific data */
+	sheet.it8_lcms = it8_lcms;
 	switch (priv->kind) {
 	case CD_IT8_KIND_TI1:
 	case CD_IT8_KIND_CAL:
-		ret = cd_it8_load_ti1_cal (it8, it8_lcms, error);
+		ret = cd_it8_load_ti1_cal (it8, &sheet, error);
 		if (!ret)
 			goto out;
 		break;
 	case CD_IT8_KIND_TI3:
-		ret = cd_it8_load_ti3 (it8, it8_lcms, error);
+		ret = cd_it8_load_ti3 (it8, &sheet, error);
 		if (!ret)
 			goto out;
 		break;
 	case CD_IT8_KIND_CCMX:
-		ret = cd_it8_load_ccmx (it8, it8_lcms, error);
+		ret = cd_it8_load_ccmx (it8, &sheet, error);
 		if (!ret)
 			goto out;
 		break;
@@ -956,6 +1329,191 @@ out:
 	return ret;
 }
 
+/* parse the standard sheet kinds with the in-tree tokenizer; anything
+ * unusual gets handed back to the lcms parser by the caller */
+static gboolean
+cd_it8_load_from_cgats (CdIt8 *it8,
+			const gchar *data,
+			gsize size,
+			GError **error)
+{
+	CdIt8Private *priv = GET_PRIVATE (it8);
+	CdIt8Sheet sheet = { NULL, NULL };
+	GHashTableIter iter;
+	gpointer key;
+	g_autoptr(CdIt8Cgats) cgats = NULL;
+
+	cgats = cd_it8_cgats_parse (data, size, error);
+	if (cgats == NULL)
+		return FALSE;
+	sheet.cgats = cgats;
+
+	/* only the kinds we fully understand */
+	if (g_str_has_prefix (cgats->sheet_type, "CTI1")) {
+		cd_it8_set_kind (it8, CD_IT8_KIND_TI1);
+	} else if (g_str_has_prefix (cgats->sheet_type, "CTI3")) {
+		cd_it8_set_kind (it8, CD_IT8_KIND_TI3);
+	} else if (g_str_has_prefix (cgats->sheet_type, "CCMX")) {
+		cd_it8_set_kind (it8, CD_IT8_KIND_CCMX);
+	} else if (g_str_has_prefix (cgats->sheet_type, "CAL")) {
+		cd_it8_set_kind (it8, CD_IT8_KIND_CAL);
+	} else {
+		g_set_error (error,
+			     CD_IT8_ERROR,
+			     CD_IT8_ERROR_UNKNOWN_KIND,
+			     "Sheet type not handled here: %s",
+			     cgats->sheet_type);
+		return FALSE;
+	}
+
+	/* clear old data */
+	g_array_set_size (priv->array_rgb, 0);
+	g_array_set_size (priv->array_xyz, 0);
+	g_ptr_array_set_size (priv->options, 0);
+	cd_it8_invalidate_options_index (it8);
+	cd_mat33_clear (&priv->matrix);
+
+	/* add options */
+	g_hash_table_iter_init (&iter, cgats->properties);
+	while (g_hash_table_iter_next (&iter, &key, NULL)) {
+		if (g_str_has_prefix (key, "TYPE_"))
+			cd_it8_add_option (it8, key);
+	}
+
+	/* get kind specific data */
+	switch (priv->kind) {
+	case CD_IT8_KIND_TI1:
+	case CD_IT8_KIND_CAL:
+		if (!cd_it8_load_ti1_cal (it8, &sheet, error))
+			return FALSE;
+		break;
+	case CD_IT8_KIND_TI3:
+		if (!cd_it8_load_ti3 (it8, &sheet, error))
+			return FALSE;
+		break;
+	case CD_IT8_KIND_CCMX:
+		if (!cd_it8_load_ccmx (it8, &sheet, error))
+			return FALSE;
+		break;
+	default:
+		break;
+	}
+
+	/* set common bits */
+	cd_it8_set_title (it8, cd_it8_cgats_get_property (cgats, "DISPLAY"));
+	cd_it8_set_originator (it8, cd_it8_cgats_get_property (cgats, "ORIGINATOR"));
+	cd_it8_set_reference (it8, cd_it8_cgats_get_property (cgats, "REFERENCE"));
+	return TRUE;
+}
+
+/* replaces the entire decoded state of @it8 with a deep copy of @src;
+ * the two objects share no storage afterwards */
+static void
+cd_it8_copy_from (CdIt8 *it8, CdIt8 *src)
+{
+	CdIt8Private *priv = GET_PRIVATE (it8);
+	CdIt8Private *priv_src = GET_PRIVATE (src);
+	guint i;
+
+	cd_it8_set_kind (it8, priv_src->kind);
+	cd_mat33_copy (&priv_src->matrix, &priv->matrix);
+	priv->normalized = priv_src->normalized;
+	priv->spectral = priv_src->spectral;
+	priv->enable_created = priv_src->enable_created;
+	cd_it8_set_instrument (it8, priv_src->instrument);
+	cd_it8_set_reference (it8, priv_src->reference);
+	cd_it8_set_originator (it8, priv_src->originator);
+	cd_it8_set_title (it8, priv_src->title);
+	g_array_set_size (priv->array_rgb, 0);
+	g_array_append_vals (priv->array_rgb,
+			     priv_src->array_rgb->data,
+			     priv_src->array_rgb->len);
+	g_array_set_size (priv->array_xyz, 0);
+	g_array_append_vals (priv->array_xyz,
+			     priv_src->array_xyz->data,
+			     priv_src->array_xyz->len);
+	g_ptr_array_set_size (priv->array_spectra, 0);
+	for (i = 0; i < priv_src->array_spectra->len; i++) {
+		CdSpectrum *spectrum = g_ptr_array_index (priv_src->array_spectra, i);
+		g_ptr_array_add (priv->array_spectra, cd_spectrum_dup (spectrum));
+	}
+	cd_it8_invalidate_spectra_index (it8);
+	g_ptr_array_set_size (priv->options, 0);
+	for (i = 0; i < priv_src->options->len; i++) {
+		g_ptr_array_add (priv->options,
+				 g_strdup (g_ptr_array_index (priv_src->options, i)));
+	}
+	cd_it8_invalidate_options_index (it8);
+}
+
+typedef struct {
+	guint64			 mtime;
+	CdIt8			*master;	/* never handed out */
+} CdIt8FileCacheItem;
+
+/* of path:CdIt8FileCacheItem; the CMFs, targets and CCMX matrices
+ * under /usr/share/colord are loaded again and again by the daemon
+ * and session helper, so keep the decoded form and hand out deep
+ * copies instead of re-parsing the text */
+static GHashTable *cd_it8_file_cache = NULL;
+G_LOCK_DEFINE_STATIC (cd_it8_file_cache);
+
+#define CD_IT8_FILE_CACHE_MAX_ITEMS	16
+
+static void
+cd_it8_file_cache_item_free (CdIt8FileCacheItem *item)
+{
+	g_object_unref (item->master);
+	g_slice_free (CdIt8FileCacheItem, item);
+}
+
+/* cd_it8_file_cache lock held by caller */
+static gboolean
+cd_it8_file_cache_restore (CdIt8 *it8, const gchar *path, guint64 mtime)
+{
+	CdIt8FileCacheItem *item;
+
+	if (cd_it8_file_cache == NULL)
+		return FALSE;
+	item = g_hash_table_lookup (cd_it8_file_cache, path);
+	if (item == NULL)
+		return FALSE;
+	if (item->mtime != mtime) {
+		/* the file was rewritten, the decoded form is stale */
+		g_hash_table_remove (cd_it8_file_cache, path);
+		return FALSE;
+	}
+	cd_it8_copy_from (it8, item->master);
+	return TRUE;
+}
+
+/* cd_it8_file_cache lock held by caller */
+static void
+cd_it8_file_cache_save (CdIt8 *it8, const gchar *path, guint64 mtime)
+{
+	CdIt8FileCacheItem *item;
+
+	if (cd_it8_file_cache == NULL) {
+		cd_it8_file_cache = g_hash_table_new_full (g_str_hash,
+							   g_str_equal,
+							   g_free,
+							   (GDestroyNotify) cd_it8_file_cache_item_free);
+	}
+
+	/* keep the cache small; throwing everything away is cheaper than
+	 * tracking per-entry age */
+	if (g_hash_table_size (cd_it8_file_cache) >= CD_IT8_FILE_CACHE_MAX_ITEMS)
+		g_hash_table_remove_all (cd_it8_file_cache);
+
+	/* the master copy is private to the cache, so a caller mutating
+	 * its own instance afterwards cannot pollute later loads */
+	item = g_slice_new0 (CdIt8FileCacheItem);
+	item->mtime = mtime;
+	item->master = cd_it8_new ();
+	cd_it8_copy_from (item->master, it8);
+	g_hash_table_insert (cd_it8_file_cache, g_strdup (path), item);
+}
+
 /**
  * cd_it8_load_from_file:
  * @it8: a #CdIt8 instance.
@@ -973,11 +1531,64 @@ cd_it8_load_from_file (CdIt8 *it8, GFile *file, GError **error)
 {
 	gsize size = 0;
 	g_autofree gchar *data = NULL;
+	g_autofree gchar *path = NULL;
 
 	g_return_val_if_fail (CD_IS_IT8 (it8), FALSE);
 	g_return_val_if_fail (G_IS_FILE (file), FALSE);
 
-	/* load file */
+	/* map native files so the tokenizer can reference the data
+	 * in place without copying it around */
+	path = g_file_get_path (file);
+	if (path != NULL) {
+		g_autoptr(GMappedFile) mapped = NULL;
+		gboolean ret;
+		guint64 mtime = 0;
+		GStatBuf st;
+
+		/* the same bytes decoded before? */
+		if (g_stat (path, &st) == 0)
+			mtime = (guint64) st.st_mtime;
+		G_LOCK (cd_it8_file_cache);
+		ret = cd_it8_file_cache_restore (it8, path, mtime);
+		G_UNLOCK (cd_it8_file_cache);
+		if (ret)
+			return TRUE;
+
+		mapped = g_mapped_file_new (path, FALSE, NULL);
+		if (mapped != NULL && g_mapped_file_get_length (mapped) > 0) {
+			g_autoptr(GError) error_local = NULL;
+			if (g_mapped_file_get_length (mapped) >= 8 &&
+			    memcmp (g_mapped_file_get_contents (mapped),
+				    CD_IT8_BINARY_MAGIC, 8) == 0) {
+				ret = cd_it8_load_from_data (it8,
+							     g_mapped_file_get_contents (mapped),
+							     g_mapped_file_get_length (mapped),
+							     error);
+			} else if (cd_it8_load_from_cgats (it8,
+							   g_mapped_file_get_contents (mapped),
+							   g_mapped_file_get_length (mapped),
+							   &error_local)) {
+				ret = TRUE;
+			} else {
+				g_debug ("using lcms CGATS parser for %s: %s",
+					 path, error_local->message);
+				ret = cd_it8_load_from_data (it8,
+							     g_mapped_file_get_contents (mapped),
+							     g_mapped_file_get_length (mapped),
+							     error);
+			}
+
+			/* remember the decoded form for the next load */
+			if (ret) {
+				G_LOCK (cd_it8_file_cache);
+				cd_it8_file_cache_save (it8, path, mtime);
+				G_UNLOCK (cd_it8_file_cache);
+			}
+			return ret;
+		}
+	}
+
+	/* load non-native file */
 	if (!g_file_load_contents (file, NULL, &data, &size, NULL, error))
 		return FALSE;
 
@@ -999,18 +1610,30 @@ cd_it8_color_match (CdColorRGB *rgb, gdouble r, gdouble g, gdouble b)
 	return TRUE;
 }
 
-static gchar *
-cd_it8_convert_xyz_to_string (CdColorXYZ *src)
+/* appends a double in the C locale with enough digits to round-trip
+ * typical measurement data, writing into a stack buffer so no heap
+ * allocation happens per value */
+static void
+cd_it8_cgats_append_dbl (GString *str, gdouble value)
 {
-	gchar buffer[3][G_ASCII_DTOSTR_BUF_SIZE];
-	g_ascii_dtostr (buffer[0], G_ASCII_DTOSTR_BUF_SIZE, src->X);
-	g_ascii_dtostr (buffer[1], G_ASCII_DTOSTR_BUF_SIZE, src->Y);
-	g_ascii_dtostr (buffer[2], G_ASCII_DTOSTR_BUF_SIZE, src->Z);
-	return g_strdup_printf ("%s %s %s", buffer[0], buffer[1], buffer[2]);
+	gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+	g_ascii_formatd (buf, sizeof (buf), "%.10g", value);
+	g_string_append (str, buf);
 }
 
+static void
+cd_it8_cgats_append_property (GString *str, const gchar *key, const gchar *value)
+{
+	g_string_append (str, key);
+	g_string_append (str, "\t\"");
+	g_string_append (str, value);
+	g_string_append (str, "\"\n");
+}
+
+/* writes the fixed SAMPLE_ID/RGB/XYZ layout in a single pass over the
+ * patch arrays; cmsIT8 is not involved at all */
 static gboolean
-cd_it8_save_to_file_ti1_ti3 (CdIt8 *it8, cmsHANDLE it8_lcms, GError **error)
+cd_it8_save_to_data_ti1_ti3 (CdIt8 *it8, gchar **data, gsize *size, GError **error)
 {
 	CdIt8Private *priv = GET_PRIVATE (it8);
 	CdColorRGB *rgb_tmp;
@@ -1018,22 +1641,24 @@ cd_it8_save_to_file_ti1_ti3 (CdIt8 *it8, cmsHANDLE it8_lcms, GError **error)
 	CdColorXYZ *xyz_tmp;
 	gboolean is_white;
 	gdouble normalize = 0.0f;
+	gdouble scale_rgb = 1.0f;
+	gdouble scale_xyz = 1.0f;
 	guint i;
 	guint luminance_samples = 0;
-	g_autofree gchar *lumi_str = NULL;
+	g_autoptr(GString) str = NULL;
 
 	/* calculate the absolute XYZ in candelas per meter squared */
 	cd_color_xyz_clear (&lumi_xyz);
 	if (priv->normalized) {
 		for (i = 0; i < priv->array_rgb->len; i++) {
-			rgb_tmp = g_ptr_array_index (priv->array_rgb, i);
+			rgb_tmp = &g_array_index (priv->array_rgb, CdColorRGB, i);
 
 			/* is this 100% white? */
 			is_white = cd_it8_color_match (rgb_tmp, 1.0f, 1.0f, 1.0f);
 			if (!is_white)
 				continue;
 			luminance_samples++;
-			xyz_tmp = g_ptr_array_index (priv->array_xyz, i);
+			xyz_tmp = &g_array_index (priv->array_xyz, CdColorXYZ, i);
 			lumi_xyz.X += xyz_tmp->X;
 			lumi_xyz.Y += xyz_tmp->Y;
 			lumi_xyz.Z += xyz_tmp->Z;
@@ -1053,68 +1678,97 @@ cd_it8_save_to_file_ti1_ti3 (CdIt8 *it8, cmsHANDLE it8_lcms, GError **error)
 
 		/* scale all the readings to 100 */
 		normalize = 100.0f / normalize;
+		scale_rgb = 100.0f;
+		scale_xyz = normalize;
 	}
-	lumi_str = cd_it8_convert_xyz_to_string (&lumi_xyz);
 
-	/* write data */
+	/* size the buffer for the header plus roughly 12 chars per value */
+	str = g_string_sized_new (512 + (gsize) priv->array_rgb->len * 90);
 	if (priv->kind == CD_IT8_KIND_TI1) {
-		cmsIT8SetSheetType (it8_lcms, "CTI1   ");
-		cmsIT8SetPropertyStr (it8_lcms, "DESCRIPTOR",
-				      "Calibration Target chart information 1");
-	} else if (priv->kind == CD_IT8_KIND_TI3) {
-		cmsIT8SetSheetType (it8_lcms, "CTI3   ");
-		cmsIT8SetPropertyStr (it8_lcms, "DESCRIPTOR",
-				      "Calibration Target chart information 3");
+		g_string_append (str, "CTI1   \n\n");
+		cd_it8_cgats_append_property (str, "DESCRIPTOR",
+					      "Calibration Target chart information 1");
+	} else {
+		g_string_append (str, "CTI3   \n\n");
+		cd_it8_cgats_append_property (str, "DESCRIPTOR",
+					      "Calibration Target chart information 3");
 	}
-	if (priv->kind == CD_IT8_KIND_TI3) {
-		cmsIT8SetPropertyStr (it8_lcms, "DEVICE_CLASS",
-				      "DISPLAY");
+	if (priv->title != NULL)
+		cd_it8_cgats_append_property (str, "DISPLAY", priv->title);
+	if (priv->originator != NULL)
+		cd_it8_cgats_append_property (str, "ORIGINATOR", priv->originator);
+	if (priv->reference != NULL)
+		cd_it8_cgats_append_property (str, "REFERENCE", priv->reference);
+
+	/* set time and date in crazy ArgllCMS format, e.g.
+	 * 'Wed Dec 19 18:47:57 2012' */
+	if (priv->enable_created) {
+		g_autoptr(GDateTime) datetime = g_date_time_new_now_local ();
+		g_autofree gchar *date_str = NULL;
+		date_str = g_date_time_format (datetime, "%a %b %d %H:%M:%S %Y");
+		cd_it8_cgats_append_property (str, "CREATED", date_str);
 	}
-	cmsIT8SetPropertyStr (it8_lcms, "COLOR_REP", "RGB_XYZ");
+	if (priv->kind == CD_IT8_KIND_TI3)
+		cd_it8_cgats_append_property (str, "DEVICE_CLASS", "DISPLAY");
+	cd_it8_cgats_append_property (str, "COLOR_REP", "RGB_XYZ");
 	if (priv->instrument != NULL) {
-		cmsIT8SetPropertyStr (it8_lcms, "TARGET_INSTRUMENT",
-				      priv->instrument);
+		cd_it8_cgats_append_property (str, "TARGET_INSTRUMENT",
+					      priv->instrument);
 	}
-	cmsIT8SetPropertyStr (it8_lcms, "INSTRUMENT_TYPE_SPECTRAL",
-			      priv->spectral ? "YES" : "NO");
+	cd_it8_cgats_append_property (str, "INSTRUMENT_TYPE_SPECTRAL",
+				      priv->spectral ? "YES" : "NO");
 	if (priv->normalized) {
-		cmsIT8SetPropertyStr (it8_lcms, "NORMALIZED_TO_Y_100", "YES");
-		cmsIT8SetPropertyStr (it8_lcms, "LUMINANCE_XYZ_CDM2", lumi_str);
+		cd_it8_cgats_append_property (str, "NORMALIZED_TO_Y_100", "YES");
+		g_string_append (str, "LUMINANCE_XYZ_CDM2\t\"");
+		cd_it8_cgats_append_dbl (str, lumi_xyz.X);
+		g_string_append_c (str, ' ');
+		cd_it8_cgats_append_dbl (str, lumi_xyz.Y);
+		g_string_append_c (str, ' ');
+		cd_it8_cgats_append_dbl (str, lumi_xyz.Z);
+		g_string_append (str, "\"\n");
 	} else {
-		cmsIT8SetPropertyStr (it8_lcms, "NORMALIZED_TO_Y_100", "NO");
+		cd_it8_cgats_append_property (str, "NORMALIZED_TO_Y_100", "NO");
 	}
-	_cmsIT8SetPropertyInt (it8_lcms, "NUMBER_OF_FIELDS", 7);
-	_cmsIT8SetPropertyInt (it8_lcms, "NUMBER_OF_SETS", priv->array_rgb->len);
-	cmsIT8SetDataFormat (it8_lcms, 0, "SAMPLE_ID");
-	cmsIT8SetDataFormat (it8_lcms, 1, "RGB_R");
-	cmsIT8SetDataFormat (it8_lcms, 2, "RGB_G");
-	cmsIT8SetDataFormat (it8_lcms, 3, "RGB_B");
-	cmsIT8SetDataFormat (it8_lcms, 4, "XYZ_X");
-	cmsIT8SetDataFormat (it8_lcms, 5, "XYZ_Y");
-	cmsIT8SetDataFormat (it8_lcms, 6, "XYZ_Z");
 
-	/* write to the it8 file */
-	for (i = 0; i < priv->array_rgb->len; i++) {
-		rgb_tmp = g_ptr_array_index (priv->array_rgb, i);
-		xyz_tmp = g_ptr_array_index (priv->array_xyz, i);
+	/* declare the options so strict CGATS parsers accept them */
+	for (i = 0; i < priv->options->len; i++) {
+		const gchar *tmp = g_ptr_array_index (priv->options, i);
+		g_string_append (str, "KEYWORD\t\"");
+		g_string_append (str, tmp);
+		g_string_append (str, "\"\n");
+		cd_it8_cgats_append_property (str, tmp, "YES");
+	}
 
-		_cmsIT8SetDataRowColDbl(it8_lcms, i, 0, i + 1);
-		if (priv->normalized) {
-			_cmsIT8SetDataRowColDbl(it8_lcms, i, 1, rgb_tmp->R * 100.0f);
-			_cmsIT8SetDataRowColDbl(it8_lcms, i, 2, rgb_tmp->G * 100.0f);
-			_cmsIT8SetDataRowColDbl(it8_lcms, i, 3, rgb_tmp->B * 100.0f);
-			_cmsIT8SetDataRowColDbl(it8_lcms, i, 4, xyz_tmp->X * normalize);
-			_cmsIT8SetDataRowColDbl(it8_lcms, i, 5, xyz_tmp->Y * normalize);
-			_cmsIT8SetDataRowColDbl(it8_lcms, i, 6, xyz_tmp->Z * normalize);
-		} else {
-			_cmsIT8SetDataRowColDbl(it8_lcms, i, 1, rgb_tmp->R);
-			_cmsIT8SetDataRowColDbl(it8_lcms, i, 2, rgb_tmp->G);
-			_cmsIT8SetDataRowColDbl(it8_lcms, i, 3, rgb_tmp->B);
-			_cmsIT8SetDataRowColDbl(it8_lcms, i, 4, xyz_tmp->X);
-			_cmsIT8SetDataRowColDbl(it8_lcms, i, 5, xyz_tmp->Y);
-			_cmsIT8SetDataRowColDbl(it8_lcms, i, 6, xyz_tmp->Z);
-		}
+	g_string_append (str, "NUMBER_OF_FIELDS\t7\n");
+	g_string_append (str, "BEGIN_DATA_FORMAT\n");
+	g_string_append (str, "SAMPLE_ID\tRGB_R\tRGB_G\tRGB_B\tXYZ_X\tXYZ_Y\tXYZ_Z\n");
+	g_string_append (str, "END_DATA_FORMAT\n");
+	g_string_append_printf (str, "NUMBER_OF_SETS\t%u\n", priv->array_rgb->len);
+	g_string_append (str, "BEGIN_DATA\n");
+	for (i = 0; i < priv->array_rgb->len; i++) {
+		rgb_tmp = &g_array_index (priv->array_rgb, CdColorRGB, i);
+		xyz_tmp = &g_array_index (priv->array_xyz, CdColorXYZ, i);
+		g_string_append_printf (str, "%u\t", i + 1);
+		cd_it8_cgats_append_dbl (str, rgb_tmp->R * scale_rgb);
+		g_string_append_c (str, '\t');
+		cd_it8_cgats_append_dbl (str, rgb_tmp->G * scale_rgb);
+		g_string_append_c (str, '\t');
+		cd_it8_cgats_append_dbl (str, rgb_tmp->B * scale_rgb);
+		g_string_append_c (str, '\t');
+		cd_it8_cgats_append_dbl (str, xyz_tmp->X * scale_xyz);
+		g_string_append_c (str, '\t');
+		cd_it8_cgats_append_dbl (str, xyz_tmp->Y * scale_xyz);
+		g_string_append_c (str, '\t');
+		cd_it8_cgats_append_dbl (str, xyz_tmp->Z * scale_xyz);
+		g_string_append_c (str, '\n');
 	}
+	g_string_append (str, "END_DATA\n");
+
+	/* save for caller */
+	if (size != NULL)
+		*size = str->len;
+	if (data != NULL)
+		*data = g_string_free (g_steal_pointer (&str), FALSE);
 	return TRUE;
 }
 
@@ -1145,7 +1799,7 @@ cd_it8_save_to_file_cal (CdIt8 *it8, cmsHANDLE it8_lcms, GError **error)
 
 	/* write to the it8 file */
 	for (i = 0; i < priv->array_rgb->len; i++) {
-		rgb_tmp = g_ptr_array_index (priv->array_rgb, i);
+		rgb_tmp = &g_array_index (priv->array_rgb, CdColorRGB, i);
 		_cmsIT8SetDataRowColDbl(it8_lcms, i, 0, 1.0f / (gdouble) (priv->array_rgb->len - 1) * (gdouble) i);
 		_cmsIT8SetDataRowColDbl(it8_lcms, i, 1, rgb_tmp->R);
 		_cmsIT8SetDataRowColDbl(it8_lcms, i, 2, rgb_tmp->G);
@@ -1375,6 +2029,11 @@ cd_it8_save_to_data (CdIt8 *it8,
 
 	g_return_val_if_fail (CD_IS_IT8 (it8), FALSE);
 
+	/* TI1 and TI3 have a fixed layout and are written directly in
+	 * one pass; everything else still goes through cmsIT8 */
+	if (priv->kind == CD_IT8_KIND_TI1 || priv->kind == CD_IT8_KIND_TI3)
+		return cd_it8_save_to_data_ti1_ti3 (it8, data, size, error);
+
 	/* set common data */
 	it8_lcms = cmsIT8Alloc (priv->context_lcms);
 	if (priv->title != NULL) {
@@ -1398,14 +2057,8 @@ cd_it8_save_to_data (CdIt8 *it8,
 		cmsIT8SetPropertyStr (it8_lcms, "CREATED", date_str);
 	}
 
-	/* set ti1 and ti3 specific data */
+	/* set kind specific data */
 	switch (priv->kind) {
-	case CD_IT8_KIND_TI1:
-	case CD_IT8_KIND_TI3:
-		ret = cd_it8_save_to_file_ti1_ti3 (it8, it8_lcms, error);
-		if (!ret)
-			goto out;
-		break;
 	case CD_IT8_KIND_CAL:
 		ret = cd_it8_save_to_file_cal (it8, it8_lcms, error);
 		if (!ret)
@@ -1490,6 +2143,122 @@ cd_it8_save_to_file (CdIt8 *it8, GFile *file, GError **error)
 					NULL, NULL, error);
 }
 
+/**
+ * cd_it8_save_to_data_binary:
+ * @it8: a #CdIt8 instance.
+ * @error: a #GError, or %NULL
+ *
+ * Saves the dataset in a compact versioned binary format where the
+ * patch values are stored as raw doubles. This is much faster to load
+ * and save than CGATS text and is intended for intermediate pipeline
+ * stages; final outputs should remain CGATS.
+ *
+ * The result can be loaded with cd_it8_load_from_data() or
+ * cd_it8_load_from_file(), which both detect the format automatically.
+ *
+ * Return value: (transfer full): the binary data, or %NULL
+ *
+ * Since: 1.4.6
+ **/
+GBytes *
+cd_it8_save_to_data_binary (CdIt8 *it8, GError **error)
+{
+	CdIt8Private *priv = GET_PRIVATE (it8);
+	GByteArray *buf;
+	GVariant *variant;
+	GVariantBuilder builder;
+	guint i;
+	g_autofree gdouble *tmp = NULL;
+
+	g_return_val_if_fail (CD_IS_IT8 (it8), NULL);
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+	g_variant_builder_add (&builder, "{sv}", "kind",
+			       g_variant_new_uint32 (priv->kind));
+	if (priv->title != NULL) {
+		g_variant_builder_add (&builder, "{sv}", "title",
+				       g_variant_new_string (priv->title));
+	}
+	if (priv->originator != NULL) {
+		g_variant_builder_add (&builder, "{sv}", "originator",
+				       g_variant_new_string (priv->originator));
+	}
+	if (priv->reference != NULL) {
+		g_variant_builder_add (&builder, "{sv}", "reference",
+				       g_variant_new_string (priv->reference));
+	}
+	if (priv->instrument != NULL) {
+		g_variant_builder_add (&builder, "{sv}", "instrument",
+				       g_variant_new_string (priv->instrument));
+	}
+	g_variant_builder_add (&builder, "{sv}", "normalized",
+			       g_variant_new_boolean (priv->normalized));
+	g_variant_builder_add (&builder, "{sv}", "spectral",
+			       g_variant_new_boolean (priv->spectral));
+	g_variant_builder_add (&builder, "{sv}", "options",
+			       g_variant_new_strv ((const gchar * const *) priv->options->pdata,
+						   priv->options->len));
+	g_variant_builder_add (&builder, "{sv}", "matrix",
+			       g_variant_new_fixed_array (G_VARIANT_TYPE_DOUBLE,
+							  cd_mat33_get_data (&priv->matrix),
+							  9, sizeof (gdouble)));
+
+	/* pack the patch values as contiguous doubles */
+	tmp = g_new (gdouble, MAX (priv->array_rgb->len, priv->array_xyz->len) * 3 + 3);
+	for (i = 0; i < priv->array_rgb->len; i++) {
+		CdColorRGB *rgb = &g_array_index (priv->array_rgb, CdColorRGB, i);
+		tmp[i * 3 + 0] = rgb->R;
+		tmp[i * 3 + 1] = rgb->G;
+		tmp[i * 3 + 2] = rgb->B;
+	}
+	g_variant_builder_add (&builder, "{sv}", "rgb",
+			       g_variant_new_fixed_array (G_VARIANT_TYPE_DOUBLE,
+							  tmp,
+							  priv->array_rgb->len * 3,
+							  sizeof (gdouble)));
+	for (i = 0; i < priv->array_xyz->len; i++) {
+		CdColorXYZ *xyz = &g_array_index (priv->array_xyz, CdColorXYZ, i);
+		tmp[i * 3 + 0] = xyz->X;
+		tmp[i * 3 + 1] = xyz->Y;
+		tmp[i * 3 + 2] = xyz->Z;
+	}
+	g_variant_builder_add (&builder, "{sv}", "xyz",
+			       g_variant_new_fixed_array (G_VARIANT_TYPE_DOUBLE,
+							  tmp,
+							  priv->array_xyz->len * 3,
+							  sizeof (gdouble)));
+	if (priv->array_spectra->len > 0) {
+		GVariantBuilder spectra;
+		g_variant_builder_init (&spectra, G_VARIANT_TYPE ("a(sdddad)"));
+		for (i = 0; i < priv->array_spectra->len; i++) {
+			CdSpectrum *spectrum = g_ptr_array_index (priv->array_spectra, i);
+			const gchar *id = cd_spectrum_get_id (spectrum);
+			g_variant_builder_add (&spectra, "(sddd@ad)",
+					       id != NULL ? id : "",
+					       cd_spectrum_get_start (spectrum),
+					       cd_spectrum_get_end (spectrum),
+					       cd_spectrum_get_norm (spectrum),
+					       g_variant_new_fixed_array (G_VARIANT_TYPE_DOUBLE,
+									  cd_spectrum_get_data_raw (spectrum),
+									  cd_spectrum_get_size (spectrum),
+									  sizeof (gdouble)));
+		}
+		g_variant_builder_add (&builder, "{sv}", "spectra",
+				       g_variant_builder_end (&spectra));
+	}
+
+	/* prefix the serialized variant with the magic */
+	variant = g_variant_take_ref (g_variant_new ("(ua{sv})",
+						     CD_IT8_BINARY_FORMAT_VERSION,
+						     &builder));
+	buf = g_byte_array_new ();
+	g_byte_array_append (buf, (const guint8 *) CD_IT8_BINARY_MAGIC, 8);
+	g_byte_array_append (buf, g_variant_get_data (variant),
+			     g_variant_get_size (variant));
+	g_variant_unref (variant);
+	return g_byte_array_free_to_bytes (buf);
+}
+
 /**
  * cd_it8_add_option:
  * @it8: a #CdIt8 instance.
@@ -1503,8 +2272,12 @@ void
 cd_it8_add_option (CdIt8 *it8, const gchar *option)
 {
 	CdIt8Private *priv = GET_PRIVATE (it8);
+	gchar *tmp;
 	g_return_if_fail (CD_IS_IT8 (it8));
-	g_ptr_array_add (priv->options, g_strdup (option));
+	tmp = g_strdup (option);
+	g_ptr_array_add (priv->options, tmp);
+	if (priv->options_set != NULL)
+		g_hash_table_add (priv->options_set, tmp);
 }
 
 /**
@@ -1636,6 +2409,35 @@ cd_it8_set_enable_created (CdIt8 *it8, gboolean enable_created)
 	priv->enable_created = enable_created;
 }
 
+/**
+ * cd_it8_set_size_hint:
+ * @it8: a #CdIt8 instance.
+ * @size: the expected number of patches
+ *
+ * Preallocates space for the expected number of readings so repeated
+ * cd_it8_add_data() calls do not have to grow the patch arrays.
+ *
+ * Since: 1.4.6
+ **/
+void
+cd_it8_set_size_hint (CdIt8 *it8, guint size)
+{
+	CdIt8Private *priv = GET_PRIVATE (it8);
+
+	g_return_if_fail (CD_IS_IT8 (it8));
+
+	if (priv->array_rgb->len == 0) {
+		g_array_unref (priv->array_rgb);
+		priv->array_rgb = g_array_sized_new (FALSE, FALSE,
+						     sizeof (CdColorRGB), size);
+	}
+	if (priv->array_xyz->len == 0) {
+		g_array_unref (priv->array_xyz);
+		priv->array_xyz = g_array_sized_new (FALSE, FALSE,
+						     sizeof (CdColorXYZ), size);
+	}
+}
+
 /**
  * cd_it8_add_data:
  * @it8: a #CdIt8 instance.
@@ -1651,28 +2453,24 @@ void
 cd_it8_add_data (CdIt8 *it8, const CdColorRGB *rgb, const CdColorXYZ *xyz)
 {
 	CdIt8Private *priv = GET_PRIVATE (it8);
-	CdColorRGB *rgb_tmp;
-	CdColorXYZ *xyz_tmp;
+	CdColorRGB rgb_tmp;
+	CdColorXYZ xyz_tmp;
 
 	g_return_if_fail (CD_IS_IT8 (it8));
 
 	/* add RGB */
-	if (rgb != NULL) {
-		rgb_tmp = cd_color_rgb_dup (rgb);
-	} else {
-		rgb_tmp = cd_color_rgb_new ();
-		cd_color_rgb_set (rgb_tmp, 0.0f, 0.0f, 0.0f);
-	}
-	g_ptr_array_add (priv->array_rgb, rgb_tmp);
+	if (rgb != NULL)
+		cd_color_rgb_copy (rgb, &rgb_tmp);
+	else
+		cd_color_rgb_set (&rgb_tmp, 0.0f, 0.0f, 0.0f);
+	g_array_append_val (priv->array_rgb, rgb_tmp);
 
 	/* add XYZ */
-	if (xyz != NULL) {
-		xyz_tmp = cd_color_xyz_dup (xyz);
-	} else {
-		xyz_tmp = cd_color_xyz_new ();
-		cd_color_xyz_set (xyz_tmp, 0.0f, 0.0f, 0.0f);
-	}
-	g_ptr_array_add (priv->array_xyz, xyz_tmp);
+	if (xyz != NULL)
+		cd_color_xyz_copy (xyz, &xyz_tmp);
+	else
+		cd_color_xyz_set (&xyz_tmp, 0.0f, 0.0f, 0.0f);
+	g_array_append_val (priv->array_xyz, xyz_tmp);
 }
 
 /**
@@ -1719,11 +2517,11 @@ cd_it8_get_data_item (CdIt8 *it8, guint idx, CdColorRGB *rgb, CdColorXYZ *xyz)
 	if (idx > priv->array_xyz->len)
 		return FALSE;
 	if (rgb != NULL) {
-		rgb_tmp = g_ptr_array_index (priv->array_rgb, idx);
+		rgb_tmp = &g_array_index (priv->array_rgb, CdColorRGB, idx);
 		cd_color_rgb_copy (rgb_tmp, rgb);
 	}
 	if (xyz != NULL) {
-		xyz_tmp = g_ptr_array_index (priv->array_xyz, idx);
+		xyz_tmp = &g_array_index (priv->array_xyz, CdColorXYZ, idx);
 		cd_color_xyz_copy (xyz_tmp, xyz);
 	}
 	return TRUE;
@@ -1754,19 +2552,27 @@ cd_it8_get_xyz_for_rgb (CdIt8 *it8, gdouble R, gdouble G, gdouble B, gdouble del
 	g_return_val_if_fail (CD_IS_IT8 (it8), NULL);
 
 	for (i = 0; i < priv->array_xyz->len; i++) {
-		rgb_tmp = g_ptr_array_index (priv->array_rgb, i);
+		rgb_tmp = &g_array_index (priv->array_rgb, CdColorRGB, i);
 		if (ABS (rgb_tmp->R - R) > delta)
 			continue;
 		if (ABS (rgb_tmp->G - G) > delta)
 			continue;
 		if (ABS (rgb_tmp->B - B) > delta)
 			continue;
-		xyz_tmp = g_ptr_array_index (priv->array_xyz, i);
+		xyz_tmp = &g_array_index (priv->array_xyz, CdColorXYZ, i);
 		return xyz_tmp;
 	}
 	return NULL;
 }
 
+/* any change to the spectra array makes the ID index stale */
+static void
+cd_it8_invalidate_spectra_index (CdIt8 *it8)
+{
+	CdIt8Private *priv = GET_PRIVATE (it8);
+	g_clear_pointer (&priv->spectra_by_id, g_hash_table_unref);
+}
+
 /**
  * cd_it8_set_spectrum_array:
  * @it8: a #CdIt8 instance.
@@ -1783,6 +2589,7 @@ cd_it8_set_spectrum_array (CdIt8 *it8, GPtrArray *data)
 	g_return_if_fail (CD_IS_IT8 (it8));
 	g_ptr_array_unref (priv->array_spectra);
 	priv->array_spectra = g_ptr_array_ref (data);
+	cd_it8_invalidate_spectra_index (it8);
 }
 
 /**
@@ -1813,6 +2620,7 @@ cd_it8_add_spectrum (CdIt8 *it8, CdSpectrum *spectrum)
 
 	/* add this */
 	g_ptr_array_add (priv->array_spectra, cd_spectrum_dup (spectrum));
+	cd_it8_invalidate_spectra_index (it8);
 }
 
 /**
@@ -1854,12 +2662,25 @@ cd_it8_get_spectrum_by_id (CdIt8 *it8, const gchar *id)
 	g_return_val_if_fail (CD_IS_IT8 (it8), NULL);
 	g_return_val_if_fail (id != NULL, NULL);
 
-	for (i = 0; i < priv->array_spectra->len; i++) {
-		tmp = g_ptr_array_index (priv->array_spectra, i);
-		if (g_strcmp0 (cd_spectrum_get_id (tmp), id) == 0)
-			return tmp;
+	/* lazily index the spectra by ID for O(1) repeat lookups */
+	if (priv->spectra_by_id == NULL) {
+		priv->spectra_by_id = g_hash_table_new_full (g_str_hash,
+							     g_str_equal,
+							     g_free, NULL);
+		for (i = 0; i < priv->array_spectra->len; i++) {
+			const gchar *tmp_id;
+			tmp = g_ptr_array_index (priv->array_spectra, i);
+			tmp_id = cd_spectrum_get_id (tmp);
+			if (tmp_id == NULL)
+				continue;
+			/* keep the first spectrum with each ID */
+			if (g_hash_table_lookup (priv->spectra_by_id, tmp_id) != NULL)
+				continue;
+			g_hash_table_insert (priv->spectra_by_id,
+					     g_strdup (tmp_id), tmp);
+		}
 	}
-	return NULL;
+	return g_hash_table_lookup (priv->spectra_by_id, id);
 }
 
 /**********************************************************************/
@@ -2041,8 +2862,8 @@ cd_it8_init (CdIt8 *it8)
 	priv->context_lcms = cd_context_lcms_new ();
 
 	cd_mat33_clear (&priv->matrix);
-	priv->array_rgb = g_ptr_array_new_with_free_func ((GDestroyNotify) cd_color_rgb_free);
-	priv->array_xyz = g_ptr_array_new_with_free_func ((GDestroyNotify) cd_color_xyz_free);
+	priv->array_rgb = g_array_new (FALSE, FALSE, sizeof (CdColorRGB));
+	priv->array_xyz = g_array_new (FALSE, FALSE, sizeof (CdColorXYZ));
 	priv->array_spectra = g_ptr_array_new_with_free_func ((GDestroyNotify) cd_spectrum_free);
 	priv->options = g_ptr_array_new_with_free_func (g_free);
 	priv->enable_created = TRUE;
@@ -2064,8 +2885,12 @@ cd_it8_finalize (GObject *object)
 
 	cd_context_lcms_free (priv->context_lcms);
 	g_ptr_array_unref (priv->array_spectra);
-	g_ptr_array_unref (priv->array_rgb);
-	g_ptr_array_unref (priv->array_xyz);
+	if (priv->spectra_by_id != NULL)
+		g_hash_table_unref (priv->spectra_by_id);
+	g_array_unref (priv->array_rgb);
+	g_array_unref (priv->array_xyz);
+	if (priv->options_set != NULL)
+		g_hash_table_unref (priv->options_set);
 	g_ptr_array_unref (priv->options);
 	g_free (priv->originator);
 	g_free (priv->title);
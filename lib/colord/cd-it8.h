@@ -112,6 +112,9 @@ gboolean	 cd_it8_save_to_data		(CdIt8		*it8,
 						 gsize		*size,
 						 GError		**error)
 						 G_GNUC_WARN_UNUSED_RESULT;
+GBytes		*cd_it8_save_to_data_binary	(CdIt8		*it8,
+						 GError		**error)
+						 G_GNUC_WARN_UNUSED_RESULT;
 
 /* setters */
 void		 cd_it8_set_kind		(CdIt8		*it8,
@@ -130,6 +133,8 @@ void		 cd_it8_set_reference		(CdIt8		*it8,
 						 const gchar	*reference);
 void		 cd_it8_set_enable_created	(CdIt8		*it8,
 						 gboolean	 enable_created);
+void		 cd_it8_set_size_hint		(CdIt8		*it8,
+						 guint		 size);
 void		 cd_it8_add_data		(CdIt8		*it8,
 						 const CdColorRGB *rgb,
 						 const CdColorXYZ *xyz);
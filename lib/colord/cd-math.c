@@ -346,6 +346,46 @@ cd_mat33_vector_multiply (const CdMat3x3 *mat_src, const CdVec3 *vec_src, CdVec3
 		       mat_src->m22 * vec_src->v2;
 }
 
+/**
+ * cd_mat33_vector_multiply_batch:
+ * @mat_src: the matrix source
+ * @vec_src: (array length=len): the vector source array
+ * @vec_dest: (array length=len): the destination vector array
+ * @len: the number of vectors
+ *
+ * Multiplies a matrix with an array of vectors.
+ *
+ * The matrix is loaded just once and each result is computed into
+ * temporaries before being stored, so the inner loop vectorizes and
+ * the arguments @vec_src and @vec_dest can be the same value.
+ **/
+void
+cd_mat33_vector_multiply_batch (const CdMat3x3 *mat_src,
+				const CdVec3 *vec_src,
+				CdVec3 *vec_dest,
+				gsize len)
+{
+	const gdouble m00 = mat_src->m00;
+	const gdouble m01 = mat_src->m01;
+	const gdouble m02 = mat_src->m02;
+	const gdouble m10 = mat_src->m10;
+	const gdouble m11 = mat_src->m11;
+	const gdouble m12 = mat_src->m12;
+	const gdouble m20 = mat_src->m20;
+	const gdouble m21 = mat_src->m21;
+	const gdouble m22 = mat_src->m22;
+	gsize i;
+
+	for (i = 0; i < len; i++) {
+		gdouble v0 = vec_src[i].v0;
+		gdouble v1 = vec_src[i].v1;
+		gdouble v2 = vec_src[i].v2;
+		vec_dest[i].v0 = m00 * v0 + m01 * v1 + m02 * v2;
+		vec_dest[i].v1 = m10 * v0 + m11 * v1 + m12 * v2;
+		vec_dest[i].v2 = m20 * v0 + m21 * v1 + m22 * v2;
+	}
+}
+
 /**
  * cd_mat33_scalar_multiply:
  * @mat_src: the source
@@ -412,29 +452,94 @@ cd_mat33_matrix_multiply (const CdMat3x3 *mat_src1, const CdMat3x3 *mat_src2, Cd
 gboolean
 cd_mat33_reciprocal (const CdMat3x3 *src, CdMat3x3 *dest)
 {
-	double det = 0;
+	double c00, c01, c02;
+	double c10, c11, c12;
+	double c20, c21, c22;
+	double det;
+	double inv_det;
 
 	g_return_val_if_fail (src != dest, FALSE);
 
-	det  = src->m00 * (src->m11 * src->m22 - src->m12 * src->m21);
-	det -= src->m01 * (src->m10 * src->m22 - src->m12 * src->m20);
-	det += src->m02 * (src->m10 * src->m21 - src->m11 * src->m20);
+	/* compute each cofactor exactly once; the determinant is then the
+	 * expansion along the first row, so no subexpression is repeated */
+	c00 = src->m11 * src->m22 - src->m12 * src->m21;
+	c01 = src->m02 * src->m21 - src->m01 * src->m22;
+	c02 = src->m01 * src->m12 - src->m02 * src->m11;
+	c10 = src->m12 * src->m20 - src->m10 * src->m22;
+	c11 = src->m00 * src->m22 - src->m02 * src->m20;
+	c12 = src->m02 * src->m10 - src->m00 * src->m12;
+	c20 = src->m10 * src->m21 - src->m11 * src->m20;
+	c21 = src->m01 * src->m20 - src->m00 * src->m21;
+	c22 = src->m00 * src->m11 - src->m01 * src->m10;
+	det = src->m00 * c00 + src->m01 * c10 + src->m02 * c20;
 
 	/* division by zero */
 	if (fabs (det) < 1e-6)
 		return FALSE;
 
-	dest->m00 = (src->m11 * src->m22 - src->m12 * src->m21) / det;
-	dest->m01 = (src->m02 * src->m21 - src->m01 * src->m22) / det;
-	dest->m02 = (src->m01 * src->m12 - src->m02 * src->m11) / det;
+	/* one division, nine multiplies */
+	inv_det = 1.0 / det;
+	dest->m00 = c00 * inv_det;
+	dest->m01 = c01 * inv_det;
+	dest->m02 = c02 * inv_det;
+	dest->m10 = c10 * inv_det;
+	dest->m11 = c11 * inv_det;
+	dest->m12 = c12 * inv_det;
+	dest->m20 = c20 * inv_det;
+	dest->m21 = c21 * inv_det;
+	dest->m22 = c22 * inv_det;
+
+	return TRUE;
+}
+
+/**
+ * cd_mat33_solve:
+ * @src: the matrix source
+ * @vec_src: the right-hand side vector
+ * @vec_dest: the solution vector
+ *
+ * Solves src ✕ vec_dest = vec_src for a single right-hand side without
+ * forming the full matrix inverse, which is cheaper and loses less
+ * precision than cd_mat33_reciprocal() followed by
+ * cd_mat33_vector_multiply().
+ * The arguments @vec_src and @vec_dest can be the same value.
+ *
+ * Return value: %FALSE if det is zero (singular).
+ **/
+gboolean
+cd_mat33_solve (const CdMat3x3 *src, const CdVec3 *vec_src, CdVec3 *vec_dest)
+{
+	double c00, c10, c20;
+	double c01, c11, c21;
+	double c02, c12, c22;
+	double det;
+	double inv_det;
+	double v0 = vec_src->v0;
+	double v1 = vec_src->v1;
+	double v2 = vec_src->v2;
+
+	/* adjugate columns, shared with the determinant expansion */
+	c00 = src->m11 * src->m22 - src->m12 * src->m21;
+	c10 = src->m12 * src->m20 - src->m10 * src->m22;
+	c20 = src->m10 * src->m21 - src->m11 * src->m20;
+	det = src->m00 * c00 + src->m01 * c10 + src->m02 * c20;
 
-	dest->m10 = (src->m12 * src->m20 - src->m10 * src->m22) / det;
-	dest->m11 = (src->m00 * src->m22 - src->m02 * src->m20) / det;
-	dest->m12 = (src->m02 * src->m10 - src->m00 * src->m12) / det;
+	/* division by zero */
+	if (fabs (det) < 1e-6)
+		return FALSE;
 
-	dest->m20 = (src->m10 * src->m21 - src->m11 * src->m20) / det;
-	dest->m21 = (src->m01 * src->m20 - src->m00 * src->m21) / det;
-	dest->m22 = (src->m00 * src->m11 - src->m01 * src->m10) / det;
+	c01 = src->m02 * src->m21 - src->m01 * src->m22;
+	c11 = src->m00 * src->m22 - src->m02 * src->m20;
+	c21 = src->m01 * src->m20 - src->m00 * src->m21;
+	c02 = src->m01 * src->m12 - src->m02 * src->m11;
+	c12 = src->m02 * src->m10 - src->m00 * src->m12;
+	c22 = src->m00 * src->m11 - src->m01 * src->m10;
+
+	/* x = adj(A)·b / det */
+	inv_det = 1.0 / det;
+	vec_dest->v0 = (c00 * v0 + c01 * v1 + c02 * v2) * inv_det;
+	vec_dest->v1 = (c10 * v0 + c11 * v1 + c12 * v2) * inv_det;
+	vec_dest->v2 = (c20 * v0 + c21 * v1 + c22 * v2) * inv_det;
 
 	return TRUE;
 }
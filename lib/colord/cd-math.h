@@ -77,11 +77,18 @@ void		 cd_mat33_scalar_multiply	(const CdMat3x3		*mat_src,
 void		 cd_mat33_vector_multiply	(const CdMat3x3		*mat_src,
 						 const CdVec3		*vec_src,
 						 CdVec3			*vec_dest);
+void		 cd_mat33_vector_multiply_batch	(const CdMat3x3		*mat_src,
+						 const CdVec3		*vec_src,
+						 CdVec3			*vec_dest,
+						 gsize			 len);
 void		 cd_mat33_matrix_multiply	(const CdMat3x3		*mat_src1,
 						 const CdMat3x3		*mat_src2,
 						 CdMat3x3		*mat_dest);
 gboolean	 cd_mat33_reciprocal		(const CdMat3x3		*src,
 						 CdMat3x3		*dest);
+gboolean	 cd_mat33_solve			(const CdMat3x3		*src,
+						 const CdVec3		*vec_src,
+						 CdVec3			*vec_dest);
 gdouble		 cd_mat33_determinant		(const CdMat3x3		*src)
 						 G_GNUC_WARN_UNUSED_RESULT;
 void		 cd_mat33_normalize		(const CdMat3x3		*src,
@@ -0,0 +1,167 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2026 Richard Hughes <richard@hughsie.com>
+ *
+ * Licensed under the GNU Lesser General Public License Version 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+/**
+ * SECTION:cd-perf-stats
+ * @short_description: Opt-in allocation and hot-path counters
+ *
+ * Lightweight counters that show whether the pooling and caching layers
+ * inside libcolord are actually firing in a deployment, without needing
+ * an external profiler. The counters are disabled by default and cost a
+ * single predictable branch per call site; set the environment variable
+ * `COLORD_PERF_STATS=1` before the process starts to enable them.
+ */
+
+#include "config.h"
+
+#include "cd-perf-stats.h"
+
+static guint64 cd_perf_stats_values[CD_PERF_STAT_LAST] = { 0 };
+G_LOCK_DEFINE_STATIC (cd_perf_stats_values);
+
+static const gchar *
+cd_perf_stat_to_string (CdPerfStat stat)
+{
+	if (stat == CD_PERF_STAT_SPECTRUM_ALLOC)
+		return "spectrum-alloc";
+	if (stat == CD_PERF_STAT_SPECTRUM_POOL_HIT)
+		return "spectrum-pool-hit";
+	if (stat == CD_PERF_STAT_COLOR_ALLOC)
+		return "color-alloc";
+	if (stat == CD_PERF_STAT_ICC_LOAD)
+		return "icc-load";
+	if (stat == CD_PERF_STAT_TRANSFORM_CACHE_HIT)
+		return "transform-cache-hit";
+	if (stat == CD_PERF_STAT_TRANSFORM_CACHE_MISS)
+		return "transform-cache-miss";
+	if (stat == CD_PERF_STAT_BYTES_HASHED)
+		return "bytes-hashed";
+	return NULL;
+}
+
+/**
+ * cd_perf_stats_enabled:
+ *
+ * Finds out if performance statistics are being collected for this
+ * process. The `COLORD_PERF_STATS` environment variable is only read
+ * once; changing it after the first counter has been touched has no
+ * effect.
+ *
+ * Return value: %TRUE if counters are being collected
+ *
+ * Since: 1.4.6
+ **/
+gboolean
+cd_perf_stats_enabled (void)
+{
+	static gsize enabled = 0;
+	if (g_once_init_enter (&enabled)) {
+		const gchar *tmp = g_getenv ("COLORD_PERF_STATS");
+		g_once_init_leave (&enabled,
+				   tmp != NULL && g_strcmp0 (tmp, "0") != 0 ? 2 : 1);
+	}
+	return enabled == 2;
+}
+
+/**
+ * cd_perf_stats_add:
+ * @stat: a #CdPerfStat, e.g. %CD_PERF_STAT_ICC_LOAD
+ * @value: the amount to add, typically 1
+ *
+ * Adds to one performance counter. This does nothing unless statistics
+ * collection has been enabled, and is safe to call from any thread.
+ *
+ * Since: 1.4.6
+ **/
+void
+cd_perf_stats_add (CdPerfStat stat, guint64 value)
+{
+	g_return_if_fail (stat < CD_PERF_STAT_LAST);
+	if (!cd_perf_stats_enabled ())
+		return;
+	G_LOCK (cd_perf_stats_values);
+	cd_perf_stats_values[stat] += value;
+	G_UNLOCK (cd_perf_stats_values);
+}
+
+/**
+ * cd_perf_stats_get:
+ * @stat: a #CdPerfStat, e.g. %CD_PERF_STAT_ICC_LOAD
+ *
+ * Gets the current value of one performance counter. Counters are zero
+ * when statistics collection is disabled.
+ *
+ * Return value: the accumulated value
+ *
+ * Since: 1.4.6
+ **/
+guint64
+cd_perf_stats_get (CdPerfStat stat)
+{
+	guint64 value;
+	g_return_val_if_fail (stat < CD_PERF_STAT_LAST, 0);
+	G_LOCK (cd_perf_stats_values);
+	value = cd_perf_stats_values[stat];
+	G_UNLOCK (cd_perf_stats_values);
+	return value;
+}
+
+/**
+ * cd_perf_stats_reset:
+ *
+ * Sets all performance counters back to zero, e.g. after start-up noise
+ * when only the steady-state behaviour is of interest.
+ *
+ * Since: 1.4.6
+ **/
+void
+cd_perf_stats_reset (void)
+{
+	guint i;
+	G_LOCK (cd_perf_stats_values);
+	for (i = 0; i < CD_PERF_STAT_LAST; i++)
+		cd_perf_stats_values[i] = 0;
+	G_UNLOCK (cd_perf_stats_values);
+}
+
+/**
+ * cd_perf_stats_dump:
+ *
+ * Prints all performance counters to standard error, one `name: value`
+ * line per counter. If statistics collection is not enabled a single
+ * line saying so is printed instead.
+ *
+ * Since: 1.4.6
+ **/
+void
+cd_perf_stats_dump (void)
+{
+	guint i;
+	if (!cd_perf_stats_enabled ()) {
+		g_printerr ("perf-stats disabled, set COLORD_PERF_STATS=1\n");
+		return;
+	}
+	for (i = 0; i < CD_PERF_STAT_LAST; i++) {
+		g_printerr ("%s: %" G_GUINT64_FORMAT "\n",
+			    cd_perf_stat_to_string (i),
+			    cd_perf_stats_get (i));
+	}
+}
@@ -0,0 +1,66 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2026 Richard Hughes <richard@hughsie.com>
+ *
+ * Licensed under the GNU Lesser General Public License Version 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#if !defined (__COLORD_H_INSIDE__) && !defined (CD_COMPILATION)
+#error "Only <colord.h> can be included directly."
+#endif
+
+#ifndef __CD_PERF_STATS_H__
+#define __CD_PERF_STATS_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * CdPerfStat:
+ * @CD_PERF_STAT_SPECTRUM_ALLOC:	#CdSpectrum structures allocated
+ * @CD_PERF_STAT_SPECTRUM_POOL_HIT:	#CdSpectrum requests served from the pool
+ * @CD_PERF_STAT_COLOR_ALLOC:		boxed color structures allocated
+ * @CD_PERF_STAT_ICC_LOAD:		profiles parsed by #CdIcc
+ * @CD_PERF_STAT_TRANSFORM_CACHE_HIT:	transforms reused from the #CdTransform cache
+ * @CD_PERF_STAT_TRANSFORM_CACHE_MISS:	transforms built from scratch
+ * @CD_PERF_STAT_BYTES_HASHED:		bytes run through cd_buffer_hash()
+ *
+ * The counters maintained when performance statistics are enabled.
+ **/
+typedef enum {
+	CD_PERF_STAT_SPECTRUM_ALLOC,
+	CD_PERF_STAT_SPECTRUM_POOL_HIT,
+	CD_PERF_STAT_COLOR_ALLOC,
+	CD_PERF_STAT_ICC_LOAD,
+	CD_PERF_STAT_TRANSFORM_CACHE_HIT,
+	CD_PERF_STAT_TRANSFORM_CACHE_MISS,
+	CD_PERF_STAT_BYTES_HASHED,
+	/*< private >*/
+	CD_PERF_STAT_LAST
+} CdPerfStat;
+
+gboolean	 cd_perf_stats_enabled		(void);
+void		 cd_perf_stats_add		(CdPerfStat	 stat,
+						 guint64	 value);
+guint64		 cd_perf_stats_get		(CdPerfStat	 stat);
+void		 cd_perf_stats_reset		(void);
+void		 cd_perf_stats_dump		(void);
+
+G_END_DECLS
+
+#endif /* __CD_PERF_STATS_H__ */
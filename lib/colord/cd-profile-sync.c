@@ -43,6 +43,7 @@ typedef struct {
 	GError		**error;
 	GMainLoop	*loop;
 	gboolean	 ret;
+	gint		 fd;
 	CdProfile	*profile;
 } CdProfileHelper;
 
@@ -203,3 +204,58 @@ cd_profile_install_system_wide_sync (CdProfile *profile,
 
 	return helper.ret;
 }
+
+/**********************************************************************/
+
+static void
+cd_profile_get_data_fd_finish_sync (CdProfile *profile,
+				    GAsyncResult *res,
+				    CdProfileHelper *helper)
+{
+	helper->fd = cd_profile_get_data_fd_finish (profile,
+						    res,
+						    helper->error);
+	g_main_loop_quit (helper->loop);
+}
+
+/**
+ * cd_profile_get_data_fd_sync:
+ * @profile: a #CdProfile instance.
+ * @cancellable: a #GCancellable or %NULL
+ * @error: a #GError, or %NULL.
+ *
+ * Gets a file descriptor of the ICC data the daemon validated, which
+ * can be mapped directly without reading the profile file again.
+ *
+ * WARNING: This function is synchronous, and may block.
+ * Do not use it in GUI applications.
+ *
+ * Return value: a sealed read-only file descriptor which the caller
+ * must close(), or -1 for error.
+ *
+ * Since: 1.4.6
+ **/
+gint
+cd_profile_get_data_fd_sync (CdProfile *profile,
+			     GCancellable *cancellable,
+			     GError **error)
+{
+	CdProfileHelper helper;
+
+	/* create temp object */
+	memset (&helper, 0, sizeof (CdProfileHelper));
+	helper.loop = g_main_loop_new (NULL, FALSE);
+	helper.error = error;
+	helper.fd = -1;
+
+	/* run async method */
+	cd_profile_get_data_fd (profile, cancellable,
+				(GAsyncReadyCallback) cd_profile_get_data_fd_finish_sync,
+				&helper);
+	g_main_loop_run (helper.loop);
+
+	/* free temp object */
+	g_main_loop_unref (helper.loop);
+
+	return helper.fd;
+}
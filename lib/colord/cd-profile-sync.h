@@ -44,6 +44,10 @@ gboolean	 cd_profile_install_system_wide_sync	(CdProfile	*profile,
 							 GCancellable	*cancellable,
 							 GError		**error)
 							 G_GNUC_WARN_UNUSED_RESULT;
+gint		 cd_profile_get_data_fd_sync		(CdProfile	*profile,
+							 GCancellable	*cancellable,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
 
 G_END_DECLS
 
@@ -35,6 +35,7 @@
 #include <stdio.h>
 #include <glib.h>
 #include <glib/gstdio.h>
+#include <gio/gunixfdlist.h>
 #include <string.h>
 
 #include "cd-profile.h"
@@ -42,6 +43,7 @@
 static void	cd_profile_class_init	(CdProfileClass	*klass);
 static void	cd_profile_init		(CdProfile	*profile);
 static void	cd_profile_finalize	(GObject	*object);
+static void	cd_profile_ensure_metadata (CdProfile	*profile);
 
 #define GET_PRIVATE(o) (cd_profile_get_instance_private (o))
 
@@ -71,6 +73,7 @@ typedef struct
 	guint			 owner;
 	gchar			**warnings;
 	GHashTable		*metadata;
+	GVariant		*metadata_variant;	/* not yet unpacked */
 } CdProfilePrivate;
 
 enum {
@@ -450,6 +453,7 @@ cd_profile_get_metadata (CdProfile *profile)
 	CdProfilePrivate *priv = GET_PRIVATE (profile);
 	g_return_val_if_fail (CD_IS_PROFILE (profile), NULL);
 	g_return_val_if_fail (priv->proxy != NULL, NULL);
+	cd_profile_ensure_metadata (profile);
 	return g_hash_table_ref (priv->metadata);
 }
 
@@ -470,6 +474,7 @@ cd_profile_get_metadata_item (CdProfile *profile, const gchar *key)
 	CdProfilePrivate *priv = GET_PRIVATE (profile);
 	g_return_val_if_fail (CD_IS_PROFILE (profile), NULL);
 	g_return_val_if_fail (priv->proxy != NULL, NULL);
+	cd_profile_ensure_metadata (profile);
 	return g_hash_table_lookup (priv->metadata, key);
 }
 
@@ -495,6 +500,29 @@ cd_profile_set_metadata_from_variant (CdProfile *profile, GVariant *variant)
 	}
 }
 
+/* unpacking the a{ss} dict for thousands of profiles most callers
+ * never inspect is wasted work, so just keep a reference on the
+ * variant until somebody asks for the metadata */
+static void
+cd_profile_set_metadata_pending (CdProfile *profile, GVariant *variant)
+{
+	CdProfilePrivate *priv = GET_PRIVATE (profile);
+	if (priv->metadata_variant != NULL)
+		g_variant_unref (priv->metadata_variant);
+	priv->metadata_variant = g_variant_ref (variant);
+	g_hash_table_remove_all (priv->metadata);
+}
+
+static void
+cd_profile_ensure_metadata (CdProfile *profile)
+{
+	CdProfilePrivate *priv = GET_PRIVATE (profile);
+	if (priv->metadata_variant == NULL)
+		return;
+	cd_profile_set_metadata_from_variant (profile, priv->metadata_variant);
+	g_clear_pointer (&priv->metadata_variant, g_variant_unref);
+}
+
 /**
  * cd_profile_get_nullable_str:
  *
@@ -566,7 +594,7 @@ cd_profile_dbus_properties_changed_cb (GDBusProxy  *proxy,
 		} else if (g_strcmp0 (property_name, CD_PROFILE_PROPERTY_IS_SYSTEM_WIDE) == 0) {
 			priv->is_system_wide = g_variant_get_boolean (property_value);
 		} else if (g_strcmp0 (property_name, CD_PROFILE_PROPERTY_METADATA) == 0) {
-			cd_profile_set_metadata_from_variant (profile, property_value);
+			cd_profile_set_metadata_pending (profile, property_value);
 		} else {
 			g_warning ("%s property unhandled", property_name);
 		}
@@ -764,7 +792,7 @@ cd_profile_connect_cb (GObject *source_object,
 	metadata = g_dbus_proxy_get_cached_property (priv->proxy,
 						     CD_PROFILE_PROPERTY_METADATA);
 	if (metadata != NULL)
-		cd_profile_set_metadata_from_variant (profile, metadata);
+		cd_profile_set_metadata_pending (profile, metadata);
 
 	/* get signals from DBus */
 	g_signal_connect_object (priv->proxy,
@@ -998,6 +1026,104 @@ cd_profile_install_system_wide (CdProfile *profile,
 
 /**********************************************************************/
 
+/**
+ * cd_profile_get_data_fd_finish:
+ * @profile: a #CdProfile instance.
+ * @res: the #GAsyncResult
+ * @error: A #GError or %NULL
+ *
+ * Gets the result from the asynchronous function.
+ *
+ * Return value: a sealed read-only file descriptor of the raw ICC data
+ * which the caller must close(), or -1 for error
+ *
+ * Since: 1.4.6
+ **/
+gint
+cd_profile_get_data_fd_finish (CdProfile *profile,
+			       GAsyncResult *res,
+			       GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (res, profile), -1);
+	return g_task_propagate_int (G_TASK (res), error);
+}
+
+static void
+cd_profile_get_data_fd_cb (GObject *source_object,
+			   GAsyncResult *res,
+			   gpointer user_data)
+{
+	gint fd;
+	gint32 fd_handle = 0;
+	guint64 size = 0;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GTask) task = G_TASK (user_data);
+	g_autoptr(GUnixFDList) fd_list = NULL;
+	g_autoptr(GVariant) result = NULL;
+
+	result = g_dbus_proxy_call_with_unix_fd_list_finish (G_DBUS_PROXY (source_object),
+							     &fd_list,
+							     res,
+							     &error);
+	if (result == NULL) {
+		cd_profile_fixup_dbus_error (error);
+		g_task_return_error (task, error);
+		error = NULL;
+		return;
+	}
+
+	/* get the fd sent with the message */
+	g_variant_get (result, "(ht)", &fd_handle, &size);
+	fd = g_unix_fd_list_get (fd_list, fd_handle, &error);
+	if (fd < 0) {
+		g_task_return_error (task, error);
+		error = NULL;
+		return;
+	}
+
+	/* success */
+	g_task_return_int (task, fd);
+}
+
+/**
+ * cd_profile_get_data_fd:
+ * @profile: a #CdProfile instance.
+ * @cancellable: a #GCancellable, or %NULL
+ * @callback: the function to run on completion
+ * @user_data: the data to pass to @callback
+ *
+ * Gets a file descriptor of the ICC data the daemon validated, which
+ * can be mapped directly without reading the profile file again.
+ *
+ * Since: 1.4.6
+ **/
+void
+cd_profile_get_data_fd (CdProfile *profile,
+			GCancellable *cancellable,
+			GAsyncReadyCallback callback,
+			gpointer user_data)
+{
+	CdProfilePrivate *priv = GET_PRIVATE (profile);
+	GTask *task = NULL;
+
+	g_return_if_fail (CD_IS_PROFILE (profile));
+	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+	g_return_if_fail (priv->proxy != NULL);
+
+	task = g_task_new (profile, cancellable, callback, user_data);
+	g_dbus_proxy_call_with_unix_fd_list (priv->proxy,
+					     "GetDataFd",
+					     NULL,
+					     G_DBUS_CALL_FLAGS_NONE,
+					     -1,
+					     NULL, /* fd_list */
+					     cancellable,
+					     cd_profile_get_data_fd_cb,
+					     task);
+}
+
+/**********************************************************************/
+
 /**
  * cd_profile_get_object_path:
  * @profile: a #CdProfile instance.
@@ -1469,6 +1595,8 @@ cd_profile_finalize (GObject *object)
 
 	g_return_if_fail (CD_IS_PROFILE (object));
 
+	if (priv->metadata_variant != NULL)
+		g_variant_unref (priv->metadata_variant);
 	g_hash_table_unref (priv->metadata);
 	g_free (priv->object_path);
 	g_free (priv->id);
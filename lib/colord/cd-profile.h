@@ -87,6 +87,14 @@ gboolean	 cd_profile_install_system_wide_finish	(CdProfile	*profile,
 							 GAsyncResult	*res,
 							 GError		**error)
 							 G_GNUC_WARN_UNUSED_RESULT;
+void		 cd_profile_get_data_fd			(CdProfile	*profile,
+							 GCancellable	*cancellable,
+							 GAsyncReadyCallback callback,
+							 gpointer	 user_data);
+gint		 cd_profile_get_data_fd_finish		(CdProfile	*profile,
+							 GAsyncResult	*res,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
 
 /* getters */
 const gchar	*cd_profile_get_id			(CdProfile	*profile);
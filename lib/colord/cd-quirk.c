@@ -31,6 +31,84 @@
 
 #include "cd-quirk.h"
 
+static const struct {
+	const gchar *old;
+	const gchar *new;
+} vendor_names[] = {
+	{ "Acer, inc.", "Acer" },
+	{ "Acer Technologies", "Acer" },
+	{ "AOC Intl", "AOC" },
+	{ "Apple Computer Inc", "Apple" },
+	{ "Arnos Insturments & Computer Systems", "Arnos" },
+	{ "ASUSTeK Computer Inc.", "ASUSTeK" },
+	{ "ASUSTeK Computer INC", "ASUSTeK" },
+	{ "ASUSTeK COMPUTER INC.", "ASUSTeK" },
+	{ "BTC Korea Co., Ltd", "BTC" },
+	{ "CASIO COMPUTER CO.,LTD", "Casio" },
+	{ "CLEVO", "Clevo" },
+	{ "Delta Electronics", "Delta" },
+	{ "Eizo Nanao Corporation", "Eizo" },
+	{ "Envision Peripherals,", "Envision" },
+	{ "FUJITSU", "Fujitsu" },
+	{ "Fujitsu Siemens Computers GmbH", "Fujitsu Siemens" },
+	{ "Funai Electric Co., Ltd.", "Funai" },
+	{ "Gigabyte Technology Co., Ltd.", "Gigabyte" },
+	{ "Goldstar Company Ltd", "LG" },
+	{ "LG Electronics", "LG" },
+	{ "GOOGLE", "Google" },
+	{ "Hewlett-Packard", "Hewlett Packard" },
+	{ "Hitachi America Ltd", "Hitachi" },
+	{ "HP", "Hewlett Packard" },
+	{ "HWP", "Hewlett Packard" },
+	{ "IBM France", "IBM" },
+	{ "Lenovo Group Limited", "Lenovo" },
+	{ "LENOVO", "Lenovo" },
+	{ "Iiyama North America", "Iiyama" },
+	{ "MARANTZ JAPAN, INC.", "Marantz" },
+	{ "Mitsubishi Electric Corporation", "Mitsubishi" },
+	{ "Nexgen Mediatech Inc.,", "Nexgen Mediatech" },
+	{ "NIKON", "Nikon" },
+	{ "Panasonic Industry Company", "Panasonic" },
+	{ "Philips Consumer Electronics Company", "Philips" },
+	{ "RGB Systems, Inc. dba Extron Electronics", "Extron" },
+	{ "SAM", "Samsung" },
+	{ "Samsung Electric Company", "Samsung" },
+	{ "Samsung Electronics America", "Samsung" },
+	{ "samsung", "Samsung" },
+	{ "SAMSUNG", "Samsung" },
+	{ "Sanyo Electric Co.,Ltd.", "Sanyo" },
+	{ "Sonix Technology Co.", "Sonix" },
+	{ "System manufacturer", "Unknown" },
+	{ "To Be Filled By O.E.M.", "Unknown" },
+	{ "Toshiba America Info Systems Inc", "Toshiba" },
+	{ "Toshiba Matsushita Display Technology Co.,", "Toshiba" },
+	{ "TOSHIBA", "Toshiba" },
+	{ "Unknown vendor", "Unknown" },
+	{ "Westinghouse Digital Electronics", "Westinghouse Digital" },
+	{ "Zalman Tech Co., Ltd.", "Zalman" },
+	{ NULL, NULL }
+};
+
+/* the quirk names are static data, so build the lookup just once */
+static GHashTable *
+cd_quirk_get_vendor_hash (void)
+{
+	static gsize init = 0;
+	static GHashTable *hash = NULL;
+
+	if (g_once_init_enter (&init)) {
+		guint i;
+		hash = g_hash_table_new (g_str_hash, g_str_equal);
+		for (i = 0; vendor_names[i].old != NULL; i++) {
+			g_hash_table_insert (hash,
+					     (gpointer) vendor_names[i].old,
+					     (gpointer) vendor_names[i].new);
+		}
+		g_once_init_leave (&init, 1);
+	}
+	return hash;
+}
+
 /**
  * cd_quirk_vendor_name:
  * @vendor: The vendor name
@@ -43,71 +121,22 @@ gchar *
 cd_quirk_vendor_name (const gchar *vendor)
 {
 	GString *display_name;
+	const gchar *tmp;
 	guint i;
 	const gchar *suffixes[] =
 		{ "Co.", "Co", "Inc.", "Inc", "Ltd.", "Ltd",
 		  "Corporation", "Incorporated", "Limited",
 		  "GmbH", "corp.",
 		  NULL };
-	struct {
-		const gchar *old;
-		const gchar *new;
-	} vendor_names[] = {
-		{ "Acer, inc.", "Acer" },
-		{ "Acer Technologies", "Acer" },
-		{ "AOC Intl", "AOC" },
-		{ "Apple Computer Inc", "Apple" },
-		{ "Arnos Insturments & Computer Systems", "Arnos" },
-		{ "ASUSTeK Computer Inc.", "ASUSTeK" },
-		{ "ASUSTeK Computer INC", "ASUSTeK" },
-		{ "ASUSTeK COMPUTER INC.", "ASUSTeK" },
-		{ "BTC Korea Co., Ltd", "BTC" },
-		{ "CASIO COMPUTER CO.,LTD", "Casio" },
-		{ "CLEVO", "Clevo" },
-		{ "Delta Electronics", "Delta" },
-		{ "Eizo Nanao Corporation", "Eizo" },
-		{ "Envision Peripherals,", "Envision" },
-		{ "FUJITSU", "Fujitsu" },
-		{ "Fujitsu Siemens Computers GmbH", "Fujitsu Siemens" },
-		{ "Funai Electric Co., Ltd.", "Funai" },
-		{ "Gigabyte Technology Co., Ltd.", "Gigabyte" },
-		{ "Goldstar Company Ltd", "LG" },
-		{ "LG Electronics", "LG" },
-		{ "GOOGLE", "Google" },
-		{ "Hewlett-Packard", "Hewlett Packard" },
-		{ "Hitachi America Ltd", "Hitachi" },
-		{ "HP", "Hewlett Packard" },
-		{ "HWP", "Hewlett Packard" },
-		{ "IBM France", "IBM" },
-		{ "Lenovo Group Limited", "Lenovo" },
-		{ "LENOVO", "Lenovo" },
-		{ "Iiyama North America", "Iiyama" },
-		{ "MARANTZ JAPAN, INC.", "Marantz" },
-		{ "Mitsubishi Electric Corporation", "Mitsubishi" },
-		{ "Nexgen Mediatech Inc.,", "Nexgen Mediatech" },
-		{ "NIKON", "Nikon" },
-		{ "Panasonic Industry Company", "Panasonic" },
-		{ "Philips Consumer Electronics Company", "Philips" },
-		{ "RGB Systems, Inc. dba Extron Electronics", "Extron" },
-		{ "SAM", "Samsung" },
-		{ "Samsung Electric Company", "Samsung" },
-		{ "Samsung Electronics America", "Samsung" },
-		{ "samsung", "Samsung" },
-		{ "SAMSUNG", "Samsung" },
-		{ "Sanyo Electric Co.,Ltd.", "Sanyo" },
-		{ "Sonix Technology Co.", "Sonix" },
-		{ "System manufacturer", "Unknown" },
-		{ "To Be Filled By O.E.M.", "Unknown" },
-		{ "Toshiba America Info Systems Inc", "Toshiba" },
-		{ "Toshiba Matsushita Display Technology Co.,", "Toshiba" },
-		{ "TOSHIBA", "Toshiba" },
-		{ "Unknown vendor", "Unknown" },
-		{ "Westinghouse Digital Electronics", "Westinghouse Digital" },
-		{ "Zalman Tech Co., Ltd.", "Zalman" },
-		{ NULL, NULL }
-	};
 
-	/* correct some company names */
+	/* correct some company names; nearly all real-world values match
+	 * a quirk exactly, so try the constant time lookup first */
+	tmp = g_hash_table_lookup (cd_quirk_get_vendor_hash (), vendor);
+	if (tmp != NULL)
+		return g_strdup (tmp);
+
+	/* a few quirks are really prefixes, e.g. with a trailing suffix
+	 * the exact match above does not see */
 	for (i = 0; vendor_names[i].old != NULL; i++) {
 		if (g_str_has_prefix (vendor, vendor_names[i].old))
 			return g_strdup (vendor_names[i].new);
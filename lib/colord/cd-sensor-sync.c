@@ -44,6 +44,7 @@ typedef struct {
 	GMainLoop	*loop;
 	gboolean	 ret;
 	CdColorXYZ	*sample;
+	GPtrArray	*samples;
 	CdSpectrum	*spectrum;
 } CdSensorHelper;
 
@@ -311,6 +312,63 @@ cd_sensor_get_sample_sync (CdSensor *sensor,
 
 /**********************************************************************/
 
+static void
+cd_sensor_get_samples_finish_sync (CdSensor *sensor,
+				   GAsyncResult *res,
+				   CdSensorHelper *helper)
+{
+	helper->samples = cd_sensor_get_samples_finish (sensor,
+							res,
+							helper->error);
+	g_main_loop_quit (helper->loop);
+}
+
+/**
+ * cd_sensor_get_samples_sync:
+ * @sensor: a #CdSensor instance.
+ * @caps: (array length=n_caps): the device capabilities to measure
+ * @n_caps: the number of capabilities in @caps
+ * @cancellable: a #GCancellable or %NULL
+ * @error: a #GError, or %NULL.
+ *
+ * Gets one sample per capability from the sensor in a single request.
+ *
+ * WARNING: This function is synchronous, and may block.
+ * Do not use it in GUI applications.
+ *
+ * Return value: (transfer container) (element-type CdColorXYZ): the
+ *               XYZ readings in capability order, or %NULL for error.
+ *
+ * Since: 1.4.6
+ **/
+GPtrArray *
+cd_sensor_get_samples_sync (CdSensor *sensor,
+			    const CdSensorCap *caps,
+			    guint n_caps,
+			    GCancellable *cancellable,
+			    GError **error)
+{
+	CdSensorHelper helper;
+
+	/* create temp object */
+	memset (&helper, 0, sizeof (CdSensorHelper));
+	helper.loop = g_main_loop_new (NULL, FALSE);
+	helper.error = error;
+
+	/* run async method */
+	cd_sensor_get_samples (sensor, caps, n_caps, cancellable,
+			       (GAsyncReadyCallback) cd_sensor_get_samples_finish_sync,
+			       &helper);
+	g_main_loop_run (helper.loop);
+
+	/* free temp object */
+	g_main_loop_unref (helper.loop);
+
+	return helper.samples;
+}
+
+/**********************************************************************/
+
 static void
 cd_sensor_get_spectrum_finish_sync (CdSensor *sensor,
 				    GAsyncResult *res,
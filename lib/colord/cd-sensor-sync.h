@@ -54,6 +54,12 @@ CdColorXYZ	*cd_sensor_get_sample_sync		(CdSensor	*sensor,
 							 GCancellable	*cancellable,
 							 GError		**error)
 							 G_GNUC_WARN_UNUSED_RESULT;
+GPtrArray	*cd_sensor_get_samples_sync		(CdSensor	*sensor,
+							 const CdSensorCap *caps,
+							 guint		 n_caps,
+							 GCancellable	*cancellable,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
 CdSpectrum	*cd_sensor_get_spectrum_sync		(CdSensor	*sensor,
 							 CdSensorCap	 cap,
 							 GCancellable	*cancellable,
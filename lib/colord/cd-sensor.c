@@ -1050,6 +1050,118 @@ cd_sensor_get_sample (CdSensor *sensor,
 
 /**********************************************************************/
 
+/**
+ * cd_sensor_get_samples_finish:
+ * @sensor: a #CdSensor instance.
+ * @res: the #GAsyncResult
+ * @error: A #GError or %NULL
+ *
+ * Gets the result from the asynchronous function.
+ *
+ * Return value: (transfer container) (element-type CdColorXYZ): the
+ *               XYZ readings in the order the capabilities were given,
+ *               or %NULL
+ *
+ * Since: 1.4.6
+ **/
+GPtrArray *
+cd_sensor_get_samples_finish (CdSensor *sensor,
+			      GAsyncResult *res,
+			      GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (res, sensor), NULL);
+	return g_task_propagate_pointer (G_TASK (res), error);
+}
+
+static void
+cd_sensor_get_samples_cb (GObject *source_object,
+			  GAsyncResult *res,
+			  gpointer user_data)
+{
+	CdColorXYZ *xyz;
+	GPtrArray *samples;
+	GVariantIter iter;
+	gdouble x, y, z;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GTask) task = G_TASK (user_data);
+	g_autoptr(GVariant) result = NULL;
+	g_autoptr(GVariant) data = NULL;
+
+	result = g_dbus_proxy_call_finish (G_DBUS_PROXY (source_object),
+					   res,
+					   &error);
+	if (result == NULL) {
+		cd_sensor_fixup_dbus_error (error);
+		g_task_return_error (task, error);
+		error = NULL;
+		return;
+	}
+
+	/* success */
+	samples = g_ptr_array_new_with_free_func ((GDestroyNotify) cd_color_xyz_free);
+	data = g_variant_get_child_value (result, 0);
+	g_variant_iter_init (&iter, data);
+	while (g_variant_iter_loop (&iter, "(ddd)", &x, &y, &z)) {
+		xyz = cd_color_xyz_new ();
+		cd_color_xyz_set (xyz, x, y, z);
+		g_ptr_array_add (samples, xyz);
+	}
+	g_task_return_pointer (task, samples,
+			       (GDestroyNotify) g_ptr_array_unref);
+}
+
+/**
+ * cd_sensor_get_samples:
+ * @sensor: a #CdSensor instance.
+ * @caps: (array length=n_caps): the #CdSensorCap modes to measure
+ * @n_caps: the number of capabilities in @caps
+ * @cancellable: a #GCancellable, or %NULL
+ * @callback: the function to run on completion
+ * @user_data: the data to pass to @callback
+ *
+ * Gets one color sample per capability from a sensor in a single
+ * round trip; the daemon keeps the instrument set up across the whole
+ * batch rather than negotiating it per reading.
+ *
+ * Since: 1.4.6
+ **/
+void
+cd_sensor_get_samples (CdSensor *sensor,
+		       const CdSensorCap *caps,
+		       guint n_caps,
+		       GCancellable *cancellable,
+		       GAsyncReadyCallback callback,
+		       gpointer user_data)
+{
+	CdSensorPrivate *priv = GET_PRIVATE (sensor);
+	GTask *task = NULL;
+	GVariantBuilder builder;
+	guint i;
+
+	g_return_if_fail (CD_IS_SENSOR (sensor));
+	g_return_if_fail (caps != NULL);
+	g_return_if_fail (n_caps > 0);
+	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+	g_return_if_fail (priv->proxy != NULL);
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("as"));
+	for (i = 0; i < n_caps; i++) {
+		g_variant_builder_add (&builder, "s",
+				       cd_sensor_cap_to_string (caps[i]));
+	}
+	task = g_task_new (sensor, cancellable, callback, user_data);
+	g_dbus_proxy_call (priv->proxy,
+			   "GetSamples",
+			   g_variant_new ("(as)", &builder),
+			   G_DBUS_CALL_FLAGS_NONE,
+			   -1,
+			   cancellable,
+			   cd_sensor_get_samples_cb,
+			   task);
+}
+
+/**********************************************************************/
+
 /**
  * cd_sensor_get_spectrum_finish:
  * @sensor: a #CdSensor instance.
@@ -104,6 +104,16 @@ CdColorXYZ	*cd_sensor_get_sample_finish		(CdSensor	*sensor,
 							 GAsyncResult	*res,
 							 GError		**error)
 							 G_GNUC_WARN_UNUSED_RESULT;
+void		 cd_sensor_get_samples			(CdSensor	*sensor,
+							 const CdSensorCap *caps,
+							 guint		 n_caps,
+							 GCancellable	*cancellable,
+							 GAsyncReadyCallback callback,
+							 gpointer	 user_data);
+GPtrArray	*cd_sensor_get_samples_finish		(CdSensor	*sensor,
+							 GAsyncResult	*res,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
 void		 cd_sensor_get_spectrum			(CdSensor	*sensor,
 							 CdSensorCap	 cap,
 							 GCancellable	*cancellable,
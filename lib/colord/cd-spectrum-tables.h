@@ -0,0 +1,634 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2009-2017 Richard Hughes <richard@hughsie.com>
+ *
+ * Licensed under the GNU Lesser General Public License Version 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+/* reference spectra compiled in from data/cmf/*.csv and
+ * data/illuminant/*.csv so clients do not have to parse the installed
+ * CGATS files; indexed by CdSpectrumStandard */
+
+#ifndef CD_COMPILATION
+#error "This header is private to cd-spectrum.c and is not installed."
+#endif
+
+#ifndef __CD_SPECTRUM_TABLES_H__
+#define __CD_SPECTRUM_TABLES_H__
+
+#include <glib.h>
+
+typedef struct {
+	const gchar	*id;
+	gdouble		 start;
+	gdouble		 end;
+	guint		 size;
+	const gdouble	*data;
+} CdSpectrumTable;
+
+static const gdouble cd_spectrum_table_cie1931_2deg_x[] = {
+	0.0001299, 0.0002321, 0.0004149, 0.0007416, 0.001368, 0.002236,
+	0.004243, 0.00765, 0.01431, 0.02319, 0.04351, 0.07763,
+	0.13438, 0.21477, 0.2839, 0.3285, 0.34828, 0.34806,
+	0.3362, 0.3187, 0.2908, 0.2511, 0.19536, 0.1421,
+	0.09564, 0.05795001, 0.03201, 0.0147, 0.0049, 0.0024,
+	0.0093, 0.0291, 0.06327, 0.1096, 0.1655, 0.2257499,
+	0.2904, 0.3597, 0.4334499, 0.5120501, 0.5945, 0.6784,
+	0.7621, 0.8425, 0.9163, 0.9786, 1.0263, 1.0567,
+	1.0622, 1.0456, 1.0026, 0.9384, 0.8544499, 0.7514,
+	0.6424, 0.5419, 0.4479, 0.3608, 0.2835, 0.2187,
+	0.1649, 0.1212, 0.0874, 0.0636, 0.04677, 0.0329,
+	0.0227, 0.01584, 0.01135916, 0.008110916, 0.005790346, 0.004109457,
+	0.002899327, 0.00204919, 0.001439971, 0.0009999493, 0.0006900786, 0.0004760213,
+	0.0003323011, 0.0002348261, 0.0001661505, 0.000117413, 8.307527e-05, 5.870652e-05,
+	4.150994e-05, 2.935326e-05, 2.067383e-05, 1.455977e-05, 1.025398e-05, 7.221456e-06,
+	5.085868e-06, 3.581652e-06, 2.522525e-06, 1.776509e-06, 1.251141e-06,
+};
+
+static const gdouble cd_spectrum_table_cie1931_2deg_y[] = {
+	3.917e-06, 6.965e-06, 1.239e-05, 2.202e-05, 3.9e-05, 6.4e-05,
+	0.00012, 0.000217, 0.000396, 0.00064, 0.00121, 0.00218,
+	0.004, 0.0073, 0.0116, 0.01684, 0.023, 0.0298,
+	0.038, 0.048, 0.06, 0.0739, 0.09098, 0.1126,
+	0.13902, 0.1693, 0.20802, 0.2586, 0.323, 0.4073,
+	0.503, 0.6082, 0.71, 0.7932, 0.862, 0.9148501,
+	0.954, 0.9803, 0.9949501, 1, 0.995, 0.9786,
+	0.952, 0.9154, 0.87, 0.8163, 0.757, 0.6949,
+	0.631, 0.5668, 0.503, 0.4412, 0.381, 0.321,
+	0.265, 0.217, 0.175, 0.1382, 0.107, 0.0816,
+	0.061, 0.04458, 0.032, 0.0232, 0.017, 0.01192,
+	0.00821, 0.005723, 0.004102, 0.002929, 0.002091, 0.001484,
+	0.001047, 0.00074, 0.00052, 0.0003611, 0.0002492, 0.0001719,
+	0.00012, 8.48e-05, 6e-05, 4.24e-05, 3e-05, 2.12e-05,
+	1.499e-05, 1.06e-05, 7.4657e-06, 5.2578e-06, 3.7029e-06, 2.6078e-06,
+	1.8366e-06, 1.2934e-06, 9.1093e-07, 6.4153e-07, 4.5181e-07,
+};
+
+static const gdouble cd_spectrum_table_cie1931_2deg_z[] = {
+	0.0006061, 0.001086, 0.001946, 0.003486, 0.006450001, 0.01054999,
+	0.02005001, 0.03621, 0.06785001, 0.1102, 0.2074, 0.3713,
+	0.6456, 1.0390501, 1.3856, 1.62296, 1.74706, 1.7826,
+	1.77211, 1.7441, 1.6692, 1.5281, 1.28764, 1.0419,
+	0.8129501, 0.6162, 0.46518, 0.3533, 0.272, 0.2123,
+	0.1582, 0.1117, 0.07824999, 0.05725001, 0.04216, 0.02984,
+	0.0203, 0.0134, 0.008749999, 0.005749999, 0.0039, 0.002749999,
+	0.0021, 0.0018, 0.001650001, 0.0014, 0.0011, 0.001,
+	0.0008, 0.0006, 0.00034, 0.00024, 0.00019, 0.0001,
+	4.999999e-05, 3e-05, 2e-05, 1e-05, 0, 0,
+	0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0,
+};
+
+static const gdouble cd_spectrum_table_cie1964_10deg_x[] = {
+	1.222e-07, 9.1927e-07, 5.9586e-06, 3.3266e-05, 0.000159952, 0.00066244,
+	0.0023616, 0.0072423, 0.0191097, 0.0434, 0.084736, 0.140638,
+	0.204492, 0.264737, 0.314679, 0.357719, 0.383734, 0.386726,
+	0.370702, 0.342957, 0.302273, 0.254085, 0.195618, 0.132349,
+	0.080507, 0.041072, 0.016172, 0.005132, 0.003816, 0.015444,
+	0.037465, 0.071358, 0.117749, 0.172953, 0.236491, 0.304213,
+	0.376772, 0.451584, 0.529826, 0.616053, 0.705224, 0.793832,
+	0.878655, 0.951162, 1.01416, 1.0743, 1.11852, 1.1343,
+	1.12399, 1.0891, 1.03048, 0.95074, 0.856297, 0.75493,
+	0.647467, 0.53511, 0.431567, 0.34369, 0.268329, 0.2043,
+	0.152568, 0.11221, 0.0812606, 0.05793, 0.0408508, 0.028623,
+	0.0199413, 0.013842, 0.00957688, 0.0066052, 0.00455263, 0.0031447,
+	0.00217496, 0.0015057, 0.00104476, 0.00072745, 0.000508258, 0.00035638,
+	0.000250969, 0.00017773, 0.00012639, 9.0151e-05, 6.45258e-05, 4.6339e-05,
+	3.34117e-05, 2.4209e-05, 1.76115e-05, 1.2855e-05, 9.41363e-06, 6.913e-06,
+	5.09347e-06, 3.7671e-06, 2.79531e-06, 2.082e-06, 1.55314e-06,
+};
+
+static const gdouble cd_spectrum_table_cie1964_10deg_y[] = {
+	1.3398e-08, 1.0065e-07, 6.511e-07, 3.625e-06, 1.7364e-05, 7.156e-05,
+	0.0002534, 0.0007685, 0.0020044, 0.004509, 0.008756, 0.014456,
+	0.021391, 0.029497, 0.038676, 0.049602, 0.062077, 0.074704,
+	0.089456, 0.106256, 0.128201, 0.152761, 0.18519, 0.21994,
+	0.253589, 0.297665, 0.339133, 0.395379, 0.460777, 0.53136,
+	0.606741, 0.68566, 0.761757, 0.82333, 0.875211, 0.92381,
+	0.961988, 0.9822, 0.991761, 0.99911, 0.99734, 0.98238,
+	0.955552, 0.915175, 0.868934, 0.825623, 0.777405, 0.720353,
+	0.658341, 0.593878, 0.527963, 0.461834, 0.398057, 0.339554,
+	0.283493, 0.228254, 0.179828, 0.140211, 0.107633, 0.081187,
+	0.060281, 0.044096, 0.0318004, 0.0226017, 0.0159051, 0.0111303,
+	0.0077488, 0.0053751, 0.00371774, 0.00256456, 0.00176847, 0.00122239,
+	0.00084619, 0.00058644, 0.00040741, 0.000284041, 0.00019873, 0.00013955,
+	9.8428e-05, 6.9819e-05, 4.9737e-05, 3.55405e-05, 2.5486e-05, 1.83384e-05,
+	1.3249e-05, 9.6196e-06, 7.0128e-06, 5.1298e-06, 3.76473e-06, 2.77081e-06,
+	2.04613e-06, 1.51677e-06, 1.12809e-06, 8.4216e-07, 6.297e-07,
+};
+
+static const gdouble cd_spectrum_table_cie1964_10deg_z[] = {
+	5.35027e-07, 4.0283e-06, 2.61437e-05, 0.00014622, 0.000704776, 0.0029278,
+	0.0104822, 0.032344, 0.0860109, 0.19712, 0.389366, 0.65676,
+	0.972542, 1.2825, 1.55348, 1.7985, 1.96728, 2.0273,
+	1.9948, 1.9007, 1.74537, 1.5549, 1.31756, 1.0302,
+	0.772125, 0.57006, 0.415254, 0.302356, 0.218502, 0.159249,
+	0.112044, 0.082248, 0.060709, 0.04305, 0.030451, 0.020584,
+	0.013676, 0.007918, 0.003988, 0.001091, 0, 0,
+	0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0,
+};
+
+static const gdouble cd_spectrum_table_illuminant_a[] = {
+	0.930483, 0.967643, 1.00597, 1.04549, 1.08623, 1.12821,
+	1.17147, 1.21602, 1.26188, 1.3091, 1.35769, 1.40768,
+	1.4591, 1.51198, 1.56633, 1.62219, 1.67959, 1.73855,
+	1.7991, 1.86127, 1.92508, 1.99057, 2.05776, 2.12667,
+	2.19734, 2.2698, 2.34406, 2.42017, 2.49814, 2.57801,
+	2.65981, 2.74355, 2.82928, 2.91701, 3.00678, 3.09861,
+	3.19253, 3.28857, 3.38676, 3.48712, 3.58968, 3.69447,
+	3.80152, 3.91085, 4.0225, 4.13648, 4.25282, 4.37156,
+	4.49272, 4.61631, 4.74238, 4.87095, 5.00204, 5.13568,
+	5.27189, 5.4107, 5.55213, 5.69622, 5.84298, 5.99244,
+	6.14462, 6.29955, 6.45724, 6.61774, 6.78105, 6.9472,
+	7.11621, 7.28811, 7.46292, 7.64066, 7.82135, 8.00501,
+	8.19167, 8.38134, 8.57404, 8.7698, 8.96864, 9.17056,
+	9.37561, 9.58378, 9.7951, 10.0096, 10.2273, 10.4481,
+	10.6722, 10.8996, 11.1302, 11.364, 11.6012, 11.8416,
+	12.0853, 12.3324, 12.5828, 12.8366, 13.0938, 13.3543,
+	13.6182, 13.8855, 14.1563, 14.4304, 14.708, 14.9891,
+	15.2736, 15.5616, 15.853, 16.148, 16.4464, 16.7484,
+	17.0538, 17.3628, 17.6753, 17.9913, 18.3108, 18.6339,
+	18.9605, 19.2907, 19.6244, 19.9617, 20.3026, 20.647,
+	20.995, 21.3465, 21.7016, 22.0603, 22.4225, 22.7883,
+	23.1577, 23.5307, 23.9072, 24.2873, 24.6709, 25.0581,
+	25.4489, 25.8432, 26.2411, 26.6425, 27.0475, 27.456,
+	27.8681, 28.2836, 28.7027, 29.1253, 29.5515, 29.9811,
+	30.4142, 30.8508, 31.2909, 31.7345, 32.1815, 32.632,
+	33.0859, 33.5432, 34.004, 34.4682, 34.9358, 35.4068,
+	35.8811, 36.3588, 36.8399, 37.3243, 37.8121, 38.3031,
+	38.7975, 39.2951, 39.796, 40.3002, 40.8076, 41.3182,
+	41.832, 42.3491, 42.8693, 43.3926, 43.9192, 44.4488,
+	44.9816, 45.5174, 46.0563, 46.5983, 47.1433, 47.6913,
+	48.2423, 48.7963, 49.3533, 49.9132, 50.476, 51.0418,
+	51.6104, 52.1818, 52.7561, 53.3332, 53.9132, 54.4958,
+	55.0813, 55.6694, 56.2603, 56.8539, 57.4501, 58.0489,
+	58.6504, 59.2545, 59.8611, 60.4703, 61.082, 61.6962,
+	62.3128, 62.932, 63.5535, 64.1775, 64.8038, 65.4325,
+	66.0635, 66.6968, 67.3324, 67.9702, 68.6102, 69.2525,
+	69.8969, 70.5435, 71.1922, 71.843, 72.4959, 73.1508,
+	73.8077, 74.4666, 75.1275, 75.7903, 76.4551, 77.1217,
+	77.7902, 78.4605, 79.1326, 79.8065, 80.4821, 81.1595,
+	81.8386, 82.5193, 83.2017, 83.8856, 84.5712, 85.2584,
+	85.947, 86.6372, 87.3288, 88.0219, 88.7165, 89.4124,
+	90.1097, 90.8083, 91.5082, 92.2095, 92.912, 93.6157,
+	94.3206, 95.0267, 95.7339, 96.4423, 97.1518, 97.8623,
+	98.5739, 99.2864, 100, 100.715, 101.43, 102.146,
+	102.864, 103.582, 104.301, 105.02, 105.741, 106.462,
+	107.184, 107.906, 108.63, 109.354, 110.078, 110.803,
+	111.529, 112.255, 112.982, 113.709, 114.436, 115.164,
+	115.893, 116.622, 117.351, 118.08, 118.81, 119.54,
+	120.27, 121.001, 121.731, 122.462, 123.193, 123.924,
+	124.655, 125.386, 126.118, 126.849, 127.58, 128.312,
+	129.043, 129.774, 130.505, 131.236, 131.966, 132.697,
+	133.427, 134.157, 134.887, 135.617, 136.346, 137.075,
+	137.804, 138.532, 139.26, 139.988, 140.715, 141.441,
+	142.167, 142.893, 143.618, 144.343, 145.067, 145.79,
+	146.513, 147.235, 147.957, 148.678, 149.398, 150.117,
+	150.836, 151.554, 152.271, 152.988, 153.704, 154.418,
+	155.132, 155.845, 156.558, 157.269, 157.979, 158.689,
+	159.397, 160.104, 160.811, 161.516, 162.221, 162.924,
+	163.626, 164.327, 165.028, 165.726, 166.424, 167.121,
+	167.816, 168.51, 169.203, 169.895, 170.586, 171.275,
+	171.963, 172.65, 173.335, 174.019, 174.702, 175.383,
+	176.063, 176.741, 177.419, 178.094, 178.769, 179.441,
+	180.113, 180.783, 181.451, 182.118, 182.783, 183.447,
+	184.109, 184.77, 185.429, 186.087, 186.743, 187.397,
+	188.05, 188.701, 189.35, 189.998, 190.644, 191.288,
+	191.931, 192.572, 193.211, 193.849, 194.484, 195.118,
+	195.75, 196.381, 197.009, 197.636, 198.261, 198.884,
+	199.506, 200.125, 200.743, 201.359, 201.972, 202.584,
+	203.195, 203.803, 204.409, 205.013, 205.616, 206.216,
+	206.815, 207.411, 208.006, 208.599, 209.189, 209.778,
+	210.365, 210.949, 211.532, 212.112, 212.691, 213.268,
+	213.842, 214.415, 214.985, 215.553, 216.12, 216.684,
+	217.246, 217.806, 218.364, 218.92, 219.473, 220.025,
+	220.574, 221.122, 221.667, 222.21, 222.751, 223.29,
+	223.826, 224.361, 224.893, 225.423, 225.951, 226.477,
+	227, 227.522, 228.041, 228.558, 229.073, 229.585,
+	230.096, 230.604, 231.11, 231.614, 232.115, 232.615,
+	233.112, 233.606, 234.099, 234.589, 235.078, 235.564,
+	236.047, 236.529, 237.008, 237.485, 237.959, 238.432,
+	238.902, 239.37, 239.836, 240.299, 240.76, 241.219,
+	241.675, 242.13, 242.582, 243.031, 243.479, 243.924,
+	244.367, 244.808, 245.246, 245.682, 246.116, 246.548,
+	246.977, 247.404, 247.829, 248.251, 248.671, 249.089,
+	249.505, 249.918, 250.329, 250.738, 251.144, 251.548,
+	251.95, 252.35, 252.747, 253.142, 253.535, 253.925,
+	254.314, 254.7, 255.083, 255.465, 255.844, 256.221,
+	256.595, 256.968, 257.338, 257.706, 258.071, 258.434,
+	258.795, 259.154, 259.511, 259.865, 260.217, 260.567,
+	260.914, 261.259, 261.602,
+};
+
+static const gdouble cd_spectrum_table_illuminant_b[] = {
+	2.4, 4, 5.6, 7.6, 9.6, 12.4,
+	15.2, 18.8, 22.4, 26.85, 31.3, 36.18,
+	41.3, 46.62, 52.1, 57.7, 63.2, 68.37,
+	73.1, 77.31, 80.8, 83.44, 85.4, 86.88,
+	88.3, 90.08, 92, 93.75, 95.2, 96.23,
+	96.5, 95.71, 94.2, 92.37, 90.7, 89.65,
+	89.5, 90.43, 92.2, 94.46, 96.9, 99.16,
+	101, 102.2, 102.8, 102.92, 102.6, 101.9,
+	101, 100.07, 99.2, 98.44, 98, 98.08,
+	98.5, 99.06, 99.7, 100.36, 101, 101.56,
+	102.2, 103.05, 103.9, 104.59, 105, 105.08,
+	104.9, 104.55, 103.9, 102.84, 101.6, 100.38,
+	99.1, 97.7, 96.2, 94.6, 92.9, 91.1,
+	89.4, 88, 86.9, 85.9, 85.2, 84.8,
+	84.7, 84.9, 85.4,
+};
+
+static const gdouble cd_spectrum_table_illuminant_c[] = {
+	33, 39.92, 47.4, 55.17, 63.3, 71.81,
+	80.6, 89.53, 98.1, 105.8, 112.4, 117.75,
+	121.5, 123.45, 124, 123.6, 123.1, 123.3,
+	123.8, 124.09, 123.9, 122.92, 120.7, 116.9,
+	112.1, 106.98, 102.3, 98.81, 96.9, 96.78,
+	98, 99.94, 102.1, 103.95, 105.2, 105.67,
+	105.3, 104.11, 102.3, 100.15, 97.8, 95.43,
+	93.2, 91.22, 89.7, 88.83, 88.4, 88.19,
+	88.1, 88.06, 88, 87.86, 87.8, 87.99,
+	88.2, 88.2, 87.9, 87.22, 86.3, 85.3,
+	84, 82.21, 80.2, 78.24, 76.3, 74.36,
+	72.4, 70.4, 68.3, 66.3, 64.4, 62.8,
+	61.5, 60.2, 59.2, 58.5, 58.1, 58,
+	58.2, 58.5, 59.1,
+};
+
+static const gdouble cd_spectrum_table_illuminant_d50[] = {
+	24.5, 27.2, 29.8, 39.6, 49.3, 52.9,
+	56.5, 58.3, 60, 58.9, 57.8, 66.3,
+	74.8, 81, 87.2, 88.9, 90.6, 91,
+	91.4, 93.3, 95.2, 93.6, 92, 93.9,
+	95.7, 96.2, 96.6, 96.9, 97.1, 99.6,
+	102.1, 101.5, 100.8, 101.6, 102.3, 101.2,
+	100, 98.9, 97.7, 98.3, 98.9, 96.2,
+	93.5, 95.6, 97.7, 98.5, 99.3, 99.2,
+	99, 97.4, 95.7, 97.3, 98.8, 97.3,
+	95.7, 97, 98.2, 100.6, 103, 101.1,
+	99.1, 93.3, 87.4, 89.5, 91.6, 92.3,
+	92.9, 84.9, 76.8, 81.7, 86.6, 89.6,
+	92.6, 85.4, 78.2, 68, 57.7, 70.3,
+	82.9, 80.6, 78.3,
+};
+
+static const gdouble cd_spectrum_table_illuminant_d55[] = {
+	32.58, 35.34, 38.09, 49.52, 60.95, 64.75,
+	68.55, 70.07, 71.58, 69.75, 67.91, 76.76,
+	85.61, 91.8, 97.99, 99.23, 100.46, 100.19,
+	99.91, 101.33, 102.74, 100.41, 98.08, 99.38,
+	100.68, 100.69, 100.7, 100.34, 99.99, 102.1,
+	104.21, 103.16, 102.1, 102.53, 102.97, 101.48,
+	100, 98.61, 97.22, 97.48, 97.75, 94.59,
+	91.43, 92.93, 94.42, 94.78, 95.14, 94.68,
+	94.22, 92.33, 90.45, 91.39, 92.33, 90.59,
+	88.85, 89.59, 90.32, 92.13, 93.95, 91.95,
+	89.96, 84.82, 79.68, 81.26, 82.84, 83.84,
+	84.84, 77.54, 70.24, 74.77, 79.3, 82.15,
+	84.99, 78.44, 71.88, 62.34, 52.79, 64.36,
+	75.93, 73.87, 71.82,
+};
+
+static const gdouble cd_spectrum_table_illuminant_d65[] = {
+	0.0341, 1.6643, 3.2945, 11.7652, 20.236, 28.6447,
+	37.0535, 38.5011, 39.9488, 42.4302, 44.9117, 45.775,
+	46.6383, 49.3637, 52.0891, 51.0323, 49.9755, 52.3118,
+	54.6482, 68.7015, 82.7549, 87.1204, 91.486, 92.4589,
+	93.4318, 90.057, 86.6823, 95.7736, 104.865, 110.936,
+	117.008, 117.41, 117.812, 116.336, 114.861, 115.392,
+	115.923, 112.367, 108.811, 109.082, 109.354, 108.578,
+	107.802, 106.296, 104.79, 106.239, 107.689, 106.047,
+	104.405, 104.225, 104.046, 102.023, 100, 98.1671,
+	96.3342, 96.0611, 95.788, 92.2368, 88.6856, 89.3459,
+	90.0062, 89.8026, 89.5991, 88.6489, 87.6987, 85.4936,
+	83.2886, 83.4939, 83.6992, 81.863, 80.0268, 80.1207,
+	80.2146, 81.2462, 82.2778, 80.281, 78.2842, 74.0027,
+	69.7213, 70.6652, 71.6091, 72.979, 74.349, 67.9765,
+	61.604, 65.7448, 69.8856, 72.4863, 75.087, 69.3398,
+	63.5927, 55.0054, 46.4182, 56.6118, 66.8054, 65.0941,
+	63.3828, 63.8434, 64.304, 61.8779, 59.4519, 55.7054,
+	51.959, 54.6998, 57.4406, 58.8765, 60.3125,
+};
+
+static const gdouble cd_spectrum_table_illuminant_d93[] = {
+	92.42, 92.69, 92.96, 111.38, 129.8, 135.8,
+	141.8, 141.45, 141.1, 133.98, 126.85, 135.6,
+	144.35, 149.96, 155.57, 154.18, 152.8, 148.78,
+	144.77, 143.34, 141.91, 136.14, 130.37, 128.55,
+	126.72, 124.33, 121.94, 117.94, 113.94, 114.04,
+	114.15, 111.52, 108.89, 107.47, 106.06, 103.03,
+	100, 97.31, 94.63, 93.35, 92.07, 88.66,
+	85.25, 84.76, 84.27, 83.38, 82.5, 80.84,
+	79.18, 76.52, 73.86, 73.45, 73.03, 71.36,
+	69.69, 69.19, 68.69, 68.74, 68.79, 67.05,
+	65.31, 61.73, 58.14, 58.5, 58.85, 60.34,
+	61.83, 56.57, 51.32, 54.97, 58.62, 60.93,
+	63.24, 58.46, 53.69, 46.27, 38.86, 47.4,
+	55.94, 54.61, 53.28,
+};
+
+static const gdouble cd_spectrum_table_illuminant_e[] = {
+	100, 100, 100, 100, 100, 100,
+	100, 100, 100, 100, 100, 100,
+	100, 100, 100, 100, 100, 100,
+	100, 100, 100, 100, 100, 100,
+	100, 100, 100, 100, 100, 100,
+	100, 100, 100, 100, 100, 100,
+	100, 100, 100, 100, 100, 100,
+	100, 100, 100, 100, 100, 100,
+	100, 100, 100, 100, 100, 100,
+	100, 100, 100, 100, 100, 100,
+	100, 100, 100, 100, 100, 100,
+	100, 100, 100, 100, 100, 100,
+	100, 100, 100, 100, 100, 100,
+	100, 100, 100, 100, 100, 100,
+	100, 100, 100, 100, 100, 100,
+	100,
+};
+
+static const gdouble cd_spectrum_table_illuminant_f1[] = {
+	1.87, 2.36, 2.94, 3.47, 5.17, 19.49,
+	6.13, 6.24, 7.01, 7.79, 8.56, 43.67,
+	16.94, 10.72, 11.35, 11.89, 12.37, 12.75,
+	13, 13.15, 13.23, 13.17, 13.13, 12.85,
+	12.52, 12.2, 11.83, 11.5, 11.22, 11.05,
+	11.03, 11.18, 11.53, 27.74, 17.05, 13.55,
+	14.33, 15.01, 15.52, 18.29, 19.55, 15.48,
+	14.91, 14.15, 13.22, 12.19, 11.12, 10.03,
+	8.95, 7.96, 7.02, 6.2, 5.42, 4.73,
+	4.15, 3.64, 3.2, 2.81, 2.47, 2.18,
+	1.93, 1.72, 1.67, 1.43, 1.29, 1.19,
+	1.08, 0.96, 0.88, 0.81, 0.77, 0.75,
+	0.73, 0.68, 0.69, 0.64, 0.68, 0.69,
+	0.61, 0.52, 0.43,
+};
+
+static const gdouble cd_spectrum_table_illuminant_f2[] = {
+	1.18, 1.48, 1.84, 2.15, 3.44, 15.69,
+	3.85, 3.74, 4.19, 4.62, 5.06, 34.98,
+	11.81, 6.27, 6.63, 6.93, 7.19, 7.4,
+	7.54, 7.62, 7.65, 7.62, 7.62, 7.45,
+	7.28, 7.15, 7.05, 7.04, 7.16, 7.47,
+	8.04, 8.88, 10.01, 24.88, 16.64, 14.59,
+	16.16, 17.56, 18.62, 21.47, 22.79, 19.29,
+	18.66, 17.73, 16.54, 15.21, 13.8, 12.36,
+	10.95, 9.65, 8.4, 7.32, 6.31, 5.43,
+	4.68, 4.02, 3.45, 2.96, 2.55, 2.19,
+	1.89, 1.64, 1.53, 1.27, 1.1, 0.99,
+	0.88, 0.76, 0.68, 0.61, 0.56, 0.54,
+	0.51, 0.47, 0.47, 0.43, 0.46, 0.47,
+	0.4, 0.33, 0.27,
+};
+
+static const gdouble cd_spectrum_table_illuminant_f3[] = {
+	0.82, 1.02, 1.26, 1.44, 2.57, 14.36,
+	2.7, 2.45, 2.73, 3, 3.28, 31.85,
+	9.47, 4.02, 4.25, 4.44, 4.59, 4.72,
+	4.8, 4.86, 4.87, 4.85, 4.88, 4.77,
+	4.67, 4.62, 4.62, 4.73, 4.99, 5.48,
+	6.25, 7.34, 8.78, 23.82, 16.14, 14.59,
+	16.63, 18.49, 19.95, 23.11, 24.69, 21.41,
+	20.85, 19.93, 18.67, 17.22, 15.65, 14.04,
+	12.45, 10.95, 9.51, 8.27, 7.11, 6.09,
+	5.22, 4.45, 3.8, 3.23, 2.75, 2.33,
+	1.99, 1.7, 1.55, 1.27, 1.09, 0.96,
+	0.83, 0.71, 0.62, 0.54, 0.49, 0.46,
+	0.43, 0.39, 0.39, 0.35, 0.38, 0.39,
+	0.33, 0.28, 0.21,
+};
+
+static const gdouble cd_spectrum_table_illuminant_f4[] = {
+	0.57, 0.7, 0.87, 0.98, 2.01, 13.75,
+	1.95, 1.59, 1.76, 1.93, 2.1, 30.28,
+	8.03, 2.55, 2.7, 2.82, 2.91, 2.99,
+	3.04, 3.08, 3.09, 3.09, 3.14, 3.06,
+	3, 2.98, 3.01, 3.14, 3.41, 3.9,
+	4.69, 5.81, 7.32, 22.59, 15.11, 13.88,
+	16.33, 18.68, 20.64, 24.28, 26.26, 23.28,
+	22.94, 22.14, 20.91, 19.43, 17.74, 16,
+	14.42, 12.56, 10.93, 9.52, 8.18, 7.01,
+	6, 5.11, 4.36, 3.69, 3.13, 2.64,
+	2.24, 1.91, 1.7, 1.39, 1.18, 1.03,
+	0.88, 0.74, 0.64, 0.54, 0.49, 0.46,
+	0.42, 0.37, 0.37, 0.33, 0.35, 0.36,
+	0.31, 0.26, 0.19,
+};
+
+static const gdouble cd_spectrum_table_illuminant_f5[] = {
+	1.87, 2.35, 2.92, 3.45, 5.1, 18.91,
+	6, 6.11, 6.85, 7.58, 8.31, 40.76,
+	16.06, 10.32, 10.91, 11.4, 11.83, 12.17,
+	12.4, 12.54, 12.58, 12.52, 12.47, 12.2,
+	11.89, 11.61, 11.33, 11.1, 10.96, 10.97,
+	11.16, 11.54, 12.12, 27.78, 17.73, 14.47,
+	15.2, 15.77, 16.1, 18.54, 19.5, 15.39,
+	14.64, 13.72, 12.69, 11.57, 10.45, 9.35,
+	8.29, 7.32, 6.41, 5.63, 4.9, 4.26,
+	3.72, 3.25, 2.83, 2.49, 2.19, 1.93,
+	1.71, 1.52, 1.43, 1.26, 1.13, 1.05,
+	0.96, 0.85, 0.78, 0.72, 0.68, 0.67,
+	0.65, 0.61, 0.62, 0.59, 0.62, 0.64,
+	0.55, 0.47, 0.4,
+};
+
+static const gdouble cd_spectrum_table_illuminant_f6[] = {
+	1.05, 1.31, 1.63, 1.9, 3.11, 14.8,
+	3.43, 3.3, 3.68, 4.07, 4.45, 32.61,
+	10.74, 5.48, 5.78, 6.03, 6.25, 6.41,
+	6.52, 6.58, 6.59, 6.56, 6.56, 6.42,
+	6.28, 6.2, 6.19, 6.3, 6.6, 7.12,
+	7.94, 9.07, 10.49, 25.22, 17.46, 15.63,
+	17.22, 18.53, 19.43, 21.97, 23.01, 19.41,
+	18.56, 17.42, 16.09, 14.64, 13.15, 11.68,
+	10.25, 8.96, 7.74, 6.69, 5.71, 4.87,
+	4.16, 3.55, 3.02, 2.57, 2.2, 1.87,
+	1.6, 1.37, 1.29, 1.05, 0.91, 0.81,
+	0.71, 0.61, 0.54, 0.48, 0.44, 0.43,
+	0.4, 0.37, 0.38, 0.35, 0.39, 0.41,
+	0.33, 0.26, 0.21,
+};
+
+static const gdouble cd_spectrum_table_illuminant_f7[] = {
+	2.56, 3.18, 3.84, 4.53, 6.15, 19.37,
+	7.37, 7.05, 7.71, 8.41, 9.15, 44.14,
+	17.52, 11.35, 12, 12.58, 13.08, 13.45,
+	13.71, 13.88, 13.95, 13.93, 13.82, 13.64,
+	13.43, 13.25, 13.08, 12.93, 12.78, 12.6,
+	12.44, 12.33, 12.26, 29.52, 17.05, 12.44,
+	12.58, 12.72, 12.83, 15.46, 16.75, 12.83,
+	12.67, 12.45, 12.19, 11.89, 11.6, 11.35,
+	11.12, 10.95, 10.76, 10.42, 10.11, 10.04,
+	10.02, 10.11, 9.87, 8.65, 7.27, 6.44,
+	5.83, 5.41, 5.04, 4.57, 4.12, 3.77,
+	3.46, 3.08, 2.73, 2.47, 2.25, 2.06,
+	1.9, 1.75, 1.62, 1.54, 1.45, 1.32,
+	1.17, 0.99, 0.81,
+};
+
+static const gdouble cd_spectrum_table_illuminant_f8[] = {
+	1.21, 1.5, 1.81, 2.13, 3.17, 13.08,
+	3.83, 3.45, 3.86, 4.42, 5.09, 34.1,
+	12.42, 7.68, 8.6, 9.46, 10.24, 10.84,
+	11.33, 11.71, 11.98, 12.17, 12.28, 12.32,
+	12.35, 12.44, 12.55, 12.68, 12.77, 12.72,
+	12.6, 12.43, 12.22, 28.96, 16.51, 11.79,
+	11.76, 11.77, 11.84, 14.61, 16.11, 12.34,
+	12.53, 12.72, 12.92, 13.12, 13.34, 13.61,
+	13.87, 14.07, 14.2, 14.16, 14.13, 14.34,
+	14.5, 14.46, 14, 12.58, 10.99, 9.98,
+	9.22, 8.62, 8.07, 7.39, 6.71, 6.16,
+	5.63, 5.03, 4.46, 4.02, 3.66, 3.36,
+	3.09, 2.85, 2.65, 2.51, 2.37, 2.15,
+	1.89, 1.61, 1.32,
+};
+
+static const gdouble cd_spectrum_table_illuminant_f9[] = {
+	0.9, 1.12, 1.36, 1.6, 2.59, 12.8,
+	3.05, 2.56, 2.86, 3.3, 3.82, 32.62,
+	10.77, 5.84, 6.57, 7.25, 7.86, 8.35,
+	8.75, 9.06, 9.31, 9.48, 9.61, 9.68,
+	9.74, 9.88, 10.04, 10.26, 10.48, 10.63,
+	10.76, 10.96, 11.18, 27.71, 16.29, 12.28,
+	12.74, 13.21, 13.65, 16.57, 18.14, 14.55,
+	14.65, 14.66, 14.61, 14.5, 14.39, 14.4,
+	14.47, 14.62, 14.72, 14.55, 14.4, 14.58,
+	14.88, 15.51, 15.47, 13.2, 10.57, 9.18,
+	8.25, 7.57, 7.03, 6.35, 5.72, 5.25,
+	4.8, 4.29, 3.8, 3.43, 3.12, 2.86,
+	2.64, 2.43, 2.26, 2.14, 2.02, 1.83,
+	1.61, 1.38, 1.12,
+};
+
+static const gdouble cd_spectrum_table_illuminant_f10[] = {
+	1.11, 0.63, 0.62, 0.57, 1.48, 12.16,
+	2.12, 2.7, 3.74, 5.14, 6.75, 34.39,
+	14.86, 10.4, 10.76, 10.67, 10.11, 9.27,
+	8.29, 7.29, 7.91, 16.64, 16.73, 10.44,
+	5.94, 3.34, 2.35, 1.88, 1.59, 1.47,
+	1.8, 5.71, 40.98, 73.69, 33.61, 8.24,
+	3.38, 2.47, 2.14, 4.86, 11.45, 14.79,
+	12.16, 8.97, 6.52, 8.81, 44.12, 34.55,
+	12.09, 12.15, 10.52, 4.43, 1.95, 2.19,
+	3.19, 2.77, 2.29, 2, 1.52, 1.35,
+	1.47, 1.79, 1.74, 1.02, 1.14, 3.32,
+	4.49, 2.05, 0.49, 0.24, 0.21, 0.21,
+	0.24, 0.24, 0.21, 0.17, 0.21, 0.22,
+	0.17, 0.12, 0.09,
+};
+
+static const gdouble cd_spectrum_table_illuminant_f11[] = {
+	0.91, 0.63, 0.46, 0.37, 1.29, 12.68,
+	1.59, 1.79, 2.46, 3.33, 4.49, 33.94,
+	12.13, 6.95, 7.19, 7.12, 6.72, 6.13,
+	5.46, 4.79, 5.66, 14.29, 14.96, 8.97,
+	4.72, 2.33, 1.47, 1.1, 0.89, 0.83,
+	1.18, 4.9, 39.59, 72.84, 32.61, 7.52,
+	2.83, 1.96, 1.67, 4.43, 11.28, 14.76,
+	12.73, 9.74, 7.33, 9.72, 55.27, 42.58,
+	13.18, 13.16, 12.26, 5.11, 2.07, 2.34,
+	3.58, 3.01, 2.48, 2.14, 1.54, 1.33,
+	1.46, 1.94, 2, 1.2, 1.35, 4.1,
+	5.58, 2.51, 0.57, 0.27, 0.23, 0.21,
+	0.24, 0.24, 0.2, 0.24, 0.32, 0.26,
+	0.16, 0.12, 0.09,
+};
+
+static const gdouble cd_spectrum_table_illuminant_f12[] = {
+	0.96, 0.64, 0.45, 0.33, 1.19, 12.48,
+	1.12, 0.94, 1.08, 1.37, 1.78, 29.05,
+	7.9, 2.65, 2.71, 2.65, 2.49, 2.33,
+	2.1, 1.91, 3.01, 10.83, 11.88, 6.88,
+	3.43, 1.49, 0.92, 0.71, 0.6, 0.63,
+	1.1, 4.56, 34.4, 65.4, 29.48, 7.16,
+	3.08, 2.47, 2.27, 5.09, 11.96, 15.32,
+	14.27, 11.86, 9.28, 12.31, 68.53, 53.02,
+	14.67, 14.38, 14.71, 6.46, 2.57, 2.75,
+	4.18, 3.44, 2.81, 2.42, 1.64, 1.36,
+	1.49, 2.14, 2.34, 1.42, 1.61, 5.04,
+	6.98, 3.19, 0.71, 0.3, 0.26, 0.23,
+	0.28, 0.28, 0.21, 0.17, 0.21, 0.19,
+	0.15, 0.1, 0.05,
+};
+
+static const CdSpectrumTable cd_spectrum_tables[] = {
+	{ "CIE1931-2deg-XYZ[X]", 360, 830, 95,
+	  cd_spectrum_table_cie1931_2deg_x },
+	{ "CIE1931-2deg-XYZ[Y]", 360, 830, 95,
+	  cd_spectrum_table_cie1931_2deg_y },
+	{ "CIE1931-2deg-XYZ[Z]", 360, 830, 95,
+	  cd_spectrum_table_cie1931_2deg_z },
+	{ "CIE1964-10deg-XYZ[X]", 360, 830, 95,
+	  cd_spectrum_table_cie1964_10deg_x },
+	{ "CIE1964-10deg-XYZ[Y]", 360, 830, 95,
+	  cd_spectrum_table_cie1964_10deg_y },
+	{ "CIE1964-10deg-XYZ[Z]", 360, 830, 95,
+	  cd_spectrum_table_cie1964_10deg_z },
+	{ "CIE-A", 300, 830, 531,
+	  cd_spectrum_table_illuminant_a },
+	{ "CIE-B", 340, 770, 87,
+	  cd_spectrum_table_illuminant_b },
+	{ "CIE-C", 380, 780, 81,
+	  cd_spectrum_table_illuminant_c },
+	{ "CIE-D50", 380, 780, 81,
+	  cd_spectrum_table_illuminant_d50 },
+	{ "CIE-D55", 380, 780, 81,
+	  cd_spectrum_table_illuminant_d55 },
+	{ "CIE-D65", 300, 830, 107,
+	  cd_spectrum_table_illuminant_d65 },
+	{ "CIE-D93", 380, 780, 81,
+	  cd_spectrum_table_illuminant_d93 },
+	{ "CIE-E", 380, 830, 91,
+	  cd_spectrum_table_illuminant_e },
+	{ "CIE-F1", 380, 780, 81,
+	  cd_spectrum_table_illuminant_f1 },
+	{ "CIE-F2", 380, 780, 81,
+	  cd_spectrum_table_illuminant_f2 },
+	{ "CIE-F3", 380, 780, 81,
+	  cd_spectrum_table_illuminant_f3 },
+	{ "CIE-F4", 380, 780, 81,
+	  cd_spectrum_table_illuminant_f4 },
+	{ "CIE-F5", 380, 780, 81,
+	  cd_spectrum_table_illuminant_f5 },
+	{ "CIE-F6", 380, 780, 81,
+	  cd_spectrum_table_illuminant_f6 },
+	{ "CIE-F7", 380, 780, 81,
+	  cd_spectrum_table_illuminant_f7 },
+	{ "CIE-F8", 380, 780, 81,
+	  cd_spectrum_table_illuminant_f8 },
+	{ "CIE-F9", 380, 780, 81,
+	  cd_spectrum_table_illuminant_f9 },
+	{ "CIE-F10", 380, 780, 81,
+	  cd_spectrum_table_illuminant_f10 },
+	{ "CIE-F11", 380, 780, 81,
+	  cd_spectrum_table_illuminant_f11 },
+	{ "CIE-F12", 380, 780, 81,
+	  cd_spectrum_table_illuminant_f12 },
+};
+
+#endif /* __CD_SPECTRUM_TABLES_H__ */
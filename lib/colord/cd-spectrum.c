@@ -33,7 +33,9 @@
 
 #include "cd-color.h"
 #include "cd-interp-linear.h"
+#include "cd-perf-stats.h"
 #include "cd-spectrum.h"
+#include "cd-spectrum-tables.h"
 
 /* this is private */
 struct _CdSpectrum {
@@ -43,9 +45,90 @@ struct _CdSpectrum {
 	gdouble			 end;
 	gdouble			 norm;
 	gdouble			 wavelength_cal[3];
+	gdouble			*wavelength_lut;
+	guint			 wavelength_lut_size;
 	GArray			*data;
+	gboolean		 data_shared;
 };
 
+/* precompute the index to wavelength mapping so per-nm queries do not
+ * have to evaluate the calibration polynomial for every sample */
+static void
+cd_spectrum_ensure_wavelength_lut (CdSpectrum *spectrum)
+{
+	guint i;
+	if (spectrum->wavelength_cal[0] < 0)
+		return;
+	if (spectrum->wavelength_lut != NULL &&
+	    spectrum->wavelength_lut_size == spectrum->data->len)
+		return;
+	g_free (spectrum->wavelength_lut);
+	spectrum->wavelength_lut_size = spectrum->data->len;
+	spectrum->wavelength_lut = g_new (gdouble, spectrum->wavelength_lut_size);
+	for (i = 0; i < spectrum->wavelength_lut_size; i++) {
+		spectrum->wavelength_lut[i] = spectrum->start +
+			spectrum->wavelength_cal[0] * (gdouble) i +
+			spectrum->wavelength_cal[1] * pow (i, 2) +
+			spectrum->wavelength_cal[2] * pow (i, 3);
+	}
+}
+
+static void
+cd_spectrum_invalidate_wavelength_lut (CdSpectrum *spectrum)
+{
+	g_free (spectrum->wavelength_lut);
+	spectrum->wavelength_lut = NULL;
+	spectrum->wavelength_lut_size = 0;
+}
+
+/* never keep more than this many spectra around per thread */
+#define CD_SPECTRUM_POOL_MAX_SIZE	16
+
+static void
+cd_spectrum_pool_free (gpointer data)
+{
+	GQueue *pool = data;
+	CdSpectrum *spectrum;
+	while ((spectrum = g_queue_pop_head (pool)) != NULL) {
+		g_array_unref (spectrum->data);
+		g_slice_free (CdSpectrum, spectrum);
+	}
+	g_queue_free (pool);
+}
+
+static GPrivate cd_spectrum_pool = G_PRIVATE_INIT (cd_spectrum_pool_free);
+
+static GQueue *
+cd_spectrum_pool_get (void)
+{
+	GQueue *pool = g_private_get (&cd_spectrum_pool);
+	if (pool == NULL) {
+		pool = g_queue_new ();
+		g_private_set (&cd_spectrum_pool, pool);
+	}
+	return pool;
+}
+
+/* recycle a spectrum freed earlier on this thread, keeping the sample
+ * storage so intermediates do not round-trip the allocator */
+static CdSpectrum *
+cd_spectrum_pool_acquire (void)
+{
+	CdSpectrum *spectrum = g_queue_pop_head (cd_spectrum_pool_get ());
+	if (spectrum == NULL)
+		return NULL;
+	spectrum->reserved_size = 0;
+	spectrum->id = NULL;
+	spectrum->start = 0.f;
+	spectrum->end = 0.f;
+	spectrum->norm = 1.f;
+	spectrum->wavelength_cal[0] = -1.f;
+	spectrum->wavelength_cal[1] = 0.f;
+	spectrum->wavelength_cal[2] = 0.f;
+	g_array_set_size (spectrum->data, 0);
+	return spectrum;
+}
+
 /**
  * cd_spectrum_dup:
  * @spectrum: a #CdSpectrum instance.
@@ -122,10 +205,11 @@ cd_spectrum_get_value (const CdSpectrum *spectrum, guint idx)
 gdouble
 cd_spectrum_get_value_max (const CdSpectrum *spectrum)
 {
+	const gdouble *data = cd_spectrum_get_data_raw (spectrum);
 	gdouble max = 0.f;
 	guint i;
-	for (i = 0; i < cd_spectrum_get_size (spectrum); i++)
-		max = MAX (max, cd_spectrum_get_value (spectrum, i));
+	for (i = 0; i < spectrum->data->len; i++)
+		max = MAX (max, data[i] * spectrum->norm);
 	return max;
 }
 
@@ -140,10 +224,11 @@ cd_spectrum_get_value_max (const CdSpectrum *spectrum)
 gdouble
 cd_spectrum_get_value_min (const CdSpectrum *spectrum)
 {
+	const gdouble *data = cd_spectrum_get_data_raw (spectrum);
 	gdouble min = G_MAXDOUBLE;
 	guint i;
-	for (i = 0; i < cd_spectrum_get_size (spectrum); i++)
-		min = MIN (min, cd_spectrum_get_value (spectrum, i));
+	for (i = 0; i < spectrum->data->len; i++)
+		min = MIN (min, data[i] * spectrum->norm);
 	return min;
 }
 
@@ -215,6 +300,11 @@ cd_spectrum_get_wavelength (const CdSpectrum *spectrum, guint idx)
 		return spectrum->start + (step * (gdouble) idx);
 	}
 
+	/* use the precomputed wavelength table where possible */
+	cd_spectrum_ensure_wavelength_lut ((CdSpectrum *) spectrum);
+	if (idx < spectrum->wavelength_lut_size)
+		return spectrum->wavelength_lut[idx];
+
 	/* use wavelength_cal to work out wavelength */
 	return spectrum->start +
 		spectrum->wavelength_cal[0] * (gdouble) idx +
@@ -254,9 +344,60 @@ GArray *
 cd_spectrum_get_data (const CdSpectrum *spectrum)
 {
 	g_return_val_if_fail (spectrum != NULL, NULL);
+	/* the caller may now hold a ref on the array, so it can no longer
+	 * be recycled when the spectrum is freed */
+	((CdSpectrum *) spectrum)->data_shared = TRUE;
 	return spectrum->data;
 }
 
+/**
+ * cd_spectrum_get_data_raw:
+ * @spectrum: a #CdSpectrum instance.
+ *
+ * Gets direct access to the contiguous sample storage, valid for
+ * cd_spectrum_get_size() items or until the spectrum is modified.
+ * NOTE: This is not normalized
+ *
+ * This exists so batch consumers can run tight vectorizable loops over
+ * the samples instead of paying a call per value.
+ *
+ * Return value: (transfer none): the sample data, or %NULL if empty
+ *
+ * Since: 1.4.6
+ **/
+const gdouble *
+cd_spectrum_get_data_raw (const CdSpectrum *spectrum)
+{
+	g_return_val_if_fail (spectrum != NULL, NULL);
+	if (spectrum->data->len == 0)
+		return NULL;
+	return &g_array_index (spectrum->data, gdouble, 0);
+}
+
+/**
+ * cd_spectrum_steal_data:
+ * @spectrum: a #CdSpectrum instance.
+ *
+ * Moves the sample storage out of the spectrum without copying it,
+ * leaving the spectrum with no data. This is useful when transferring
+ * samples between owners in a hot path.
+ * NOTE: This is not normalized
+ *
+ * Return value: (transfer full) (element-type gdouble): spectral data
+ *
+ * Since: 1.4.6
+ **/
+GArray *
+cd_spectrum_steal_data (CdSpectrum *spectrum)
+{
+	GArray *data;
+	g_return_val_if_fail (spectrum != NULL, NULL);
+	data = spectrum->data;
+	spectrum->data = g_array_new (FALSE, FALSE, sizeof (gdouble));
+	spectrum->data_shared = FALSE;
+	return data;
+}
+
 /**
  * cd_spectrum_get_start:
  * @spectrum: a #CdSpectrum instance.
@@ -359,6 +500,12 @@ CdSpectrum *
 cd_spectrum_new (void)
 {
 	CdSpectrum *spectrum;
+	spectrum = cd_spectrum_pool_acquire ();
+	if (spectrum != NULL) {
+		cd_perf_stats_add (CD_PERF_STAT_SPECTRUM_POOL_HIT, 1);
+		return spectrum;
+	}
+	cd_perf_stats_add (CD_PERF_STAT_SPECTRUM_ALLOC, 1);
 	spectrum = g_slice_new0 (CdSpectrum);
 	spectrum->norm = 1.f;
 	spectrum->data = g_array_new (FALSE, FALSE, sizeof (gdouble));
@@ -380,6 +527,13 @@ CdSpectrum *
 cd_spectrum_sized_new (guint reserved_size)
 {
 	CdSpectrum *spectrum;
+	spectrum = cd_spectrum_pool_acquire ();
+	if (spectrum != NULL) {
+		cd_perf_stats_add (CD_PERF_STAT_SPECTRUM_POOL_HIT, 1);
+		spectrum->reserved_size = reserved_size;
+		return spectrum;
+	}
+	cd_perf_stats_add (CD_PERF_STAT_SPECTRUM_ALLOC, 1);
 	spectrum = g_slice_new0 (CdSpectrum);
 	spectrum->norm = 1.f;
 	spectrum->reserved_size = reserved_size;
@@ -388,6 +542,47 @@ cd_spectrum_sized_new (guint reserved_size)
 	return spectrum;
 }
 
+/**
+ * cd_spectrum_new_standard:
+ * @standard: a #CdSpectrumStandard, e.g. %CD_SPECTRUM_STANDARD_ILLUMINANT_D65
+ *
+ * Creates a spectrum from the reference data compiled into the library.
+ * No files are read or parsed; the sample data is shared between all
+ * spectra created for the same standard and must not be modified.
+ *
+ * Return value: A newly allocated #CdSpectrum object, or %NULL
+ *
+ * Since: 1.4.6
+ **/
+CdSpectrum *
+cd_spectrum_new_standard (CdSpectrumStandard standard)
+{
+	CdSpectrum *s;
+	const CdSpectrumTable *table;
+	static GArray *arrays[CD_SPECTRUM_STANDARD_LAST] = { NULL };
+	static GMutex mutex;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_val_if_fail (standard < CD_SPECTRUM_STANDARD_LAST, NULL);
+
+	/* copy the static table into a process-wide GArray once so that
+	 * every spectrum can just take a reference on it */
+	table = &cd_spectrum_tables[standard];
+	locker = g_mutex_locker_new (&mutex);
+	if (arrays[standard] == NULL) {
+		arrays[standard] = g_array_sized_new (FALSE, FALSE,
+						      sizeof (gdouble),
+						      table->size);
+		g_array_append_vals (arrays[standard], table->data, table->size);
+	}
+	s = cd_spectrum_new ();
+	s->id = g_strdup (table->id);
+	s->start = table->start;
+	s->end = table->end;
+	cd_spectrum_set_data (s, arrays[standard]);
+	return s;
+}
+
 /**
  * cd_spectrum_planckian_new_full:
  * @temperature: the temperature in Kelvin
@@ -401,6 +596,43 @@ cd_spectrum_sized_new (guint reserved_size)
  *
  * Since: 1.3.1
  **/
+/* writes the normalized Planck formula into the spectrum, reusing any
+ * existing allocation so iterative callers can update in place */
+static void
+cd_spectrum_planckian_fill (CdSpectrum *s, gdouble temperature)
+{
+	const gdouble c1 = 3.74183e-16;	/* 2pi * h * c^2 */
+	const gdouble c2 = 1.4388e-2;	/* h * c / k */
+	gdouble wl;
+	gdouble norm;
+	gdouble tmp;
+	guint i;
+
+	/* see http://www.create.uwe.ac.uk/ardtalks/Schanda_paper.pdf, page 42 */
+	wl = 560 * 1e-9;
+	norm = 0.01 * (c1 * pow (wl, -5.0)) / (exp (c2 / (wl * temperature)) - 1.0);
+	for (i = 0; i < s->reserved_size; i++) {
+		wl = cd_spectrum_get_wavelength (s, i) * 1e-9;
+		tmp = (c1 * pow (wl, -5.0)) / (exp (c2 / (wl * temperature)) - 1.0);
+		if (i < s->data->len)
+			g_array_index (s->data, gdouble, i) = tmp / norm;
+		else
+			cd_spectrum_add_value (s, tmp / norm);
+	}
+}
+
+/* a small process-wide LRU of generated spectra; CCT matching calls
+ * cd_spectrum_planckian_new_full() in tight loops over temperature */
+#define CD_SPECTRUM_PLANCKIAN_CACHE_SIZE	16
+
+typedef struct {
+	gchar		*key;
+	CdSpectrum	*spectrum;
+} CdSpectrumPlanckianCacheItem;
+
+static GMutex cd_spectrum_planckian_cache_mutex;
+static GPtrArray *cd_spectrum_planckian_cache = NULL;
+
 CdSpectrum *
 cd_spectrum_planckian_new_full (gdouble temperature,
 				gdouble start,
@@ -408,34 +640,82 @@ cd_spectrum_planckian_new_full (gdouble temperature,
 				gdouble resolution)
 {
 	CdSpectrum *s = NULL;
-	const gdouble c1 = 3.74183e-16;	/* 2pi * h * c^2 */
-	const gdouble c2 = 1.4388e-2;	/* h * c / k */
-	gdouble wl;
-	gdouble norm;
-	gdouble tmp;
+	CdSpectrumPlanckianCacheItem *item;
 	guint i;
+	g_autofree gchar *key = NULL;
+	g_autoptr(GMutexLocker) locker = NULL;
 
 	/* sanity check */
 	if (temperature < 1.0 || temperature > 1e6)
 		return NULL;
 
+	/* quantized to 0.1K, which is well below sensor accuracy */
+	key = g_strdup_printf ("%.1f:%g:%g:%g",
+			       temperature, start, end, resolution);
+	locker = g_mutex_locker_new (&cd_spectrum_planckian_cache_mutex);
+	if (cd_spectrum_planckian_cache == NULL)
+		cd_spectrum_planckian_cache = g_ptr_array_new ();
+	for (i = 0; i < cd_spectrum_planckian_cache->len; i++) {
+		item = g_ptr_array_index (cd_spectrum_planckian_cache, i);
+		if (g_strcmp0 (item->key, key) != 0)
+			continue;
+
+		/* hit: keep the most recently used entry at the end */
+		g_ptr_array_remove_index (cd_spectrum_planckian_cache, i);
+		g_ptr_array_add (cd_spectrum_planckian_cache, item);
+		return cd_spectrum_dup (item->spectrum);
+	}
+
 	/* create spectrum with 1nm resolution */
 	s = cd_spectrum_sized_new (531);
 	s->id = g_strdup_printf ("Planckian@%.0fK", temperature);
 	cd_spectrum_set_start (s, start);
 	cd_spectrum_set_end (s, end);
-
-	/* see http://www.create.uwe.ac.uk/ardtalks/Schanda_paper.pdf, page 42 */
-	wl = 560 * 1e-9;
-	norm = 0.01 * (c1 * pow (wl, -5.0)) / (exp (c2 / (wl * temperature)) - 1.0);
-	for (i = 0; i < s->reserved_size; i++) {
-		wl = cd_spectrum_get_wavelength (s, i) * 1e-9;
-		tmp = (c1 * pow (wl, -5.0)) / (exp (c2 / (wl * temperature)) - 1.0);
-		cd_spectrum_add_value (s, tmp / norm);
+	cd_spectrum_planckian_fill (s, temperature);
+
+	/* keep for next time, evicting the oldest entry */
+	item = g_new0 (CdSpectrumPlanckianCacheItem, 1);
+	item->key = g_steal_pointer (&key);
+	item->spectrum = cd_spectrum_dup (s);
+	g_ptr_array_add (cd_spectrum_planckian_cache, item);
+	if (cd_spectrum_planckian_cache->len > CD_SPECTRUM_PLANCKIAN_CACHE_SIZE) {
+		item = g_ptr_array_index (cd_spectrum_planckian_cache, 0);
+		g_free (item->key);
+		cd_spectrum_free (item->spectrum);
+		g_free (item);
+		g_ptr_array_remove_index (cd_spectrum_planckian_cache, 0);
 	}
 	return s;
 }
 
+/**
+ * cd_spectrum_planckian_update:
+ * @spectrum: a #CdSpectrum previously returned by
+ *            cd_spectrum_planckian_new_full()
+ * @temperature: the new temperature in Kelvin
+ *
+ * Rewrites the spectrum in place for a different temperature, reusing
+ * the existing allocation and wavelength range. This is intended for
+ * CCT searches that walk the temperature axis in small steps.
+ *
+ * Return value: %TRUE for success
+ *
+ * Since: 1.4.6
+ **/
+gboolean
+cd_spectrum_planckian_update (CdSpectrum *spectrum, gdouble temperature)
+{
+	g_return_val_if_fail (spectrum != NULL, FALSE);
+
+	/* sanity check */
+	if (temperature < 1.0 || temperature > 1e6)
+		return FALSE;
+	g_free (spectrum->id);
+	spectrum->id = g_strdup_printf ("Planckian@%.0fK", temperature);
+	cd_spectrum_planckian_fill (spectrum, temperature);
+	return TRUE;
+}
+
 /**
  * cd_spectrum_planckian_new:
  * @temperature: the temperature in Kelvin
@@ -478,9 +758,21 @@ cd_spectrum_add_value (CdSpectrum *spectrum, gdouble data)
 void
 cd_spectrum_free (CdSpectrum *spectrum)
 {
+	GQueue *pool;
 	if (spectrum == NULL)
 		return;
 	g_free (spectrum->id);
+	spectrum->id = NULL;
+	cd_spectrum_invalidate_wavelength_lut (spectrum);
+
+	/* recycle the allocation unless the sample storage has been handed
+	 * out with cd_spectrum_get_data() or shared with another spectrum */
+	pool = cd_spectrum_pool_get ();
+	if (!spectrum->data_shared &&
+	    g_queue_get_length (pool) < CD_SPECTRUM_POOL_MAX_SIZE) {
+		g_queue_push_head (pool, spectrum);
+		return;
+	}
 	g_array_unref (spectrum->data);
 	g_slice_free (CdSpectrum, spectrum);
 }
@@ -519,6 +811,7 @@ cd_spectrum_set_data (CdSpectrum *spectrum, GArray *value)
 	g_return_if_fail (value != NULL);
 	g_array_unref (spectrum->data);
 	spectrum->data = g_array_ref (value);
+	spectrum->data_shared = TRUE;
 }
 
 /**
@@ -535,6 +828,9 @@ cd_spectrum_set_start (CdSpectrum *spectrum, gdouble start)
 {
 	g_return_if_fail (spectrum != NULL);
 	spectrum->start = start;
+
+	/* the wavelength table includes the start offset */
+	cd_spectrum_invalidate_wavelength_lut (spectrum);
 }
 
 /**
@@ -597,9 +893,12 @@ cd_spectrum_set_norm (CdSpectrum *spectrum, gdouble norm)
 gdouble
 cd_spectrum_get_value_for_nm (const CdSpectrum *spectrum, gdouble wavelength)
 {
-	guint i;
+	const gdouble *lut;
+	gdouble frac;
+	gdouble span;
+	guint hi;
+	guint lo;
 	guint size;
-	g_autoptr(CdInterp) interp = NULL;
 
 	g_return_val_if_fail (spectrum != NULL, -1.f);
 
@@ -611,19 +910,43 @@ cd_spectrum_get_value_for_nm (const CdSpectrum *spectrum, gdouble wavelength)
 		return cd_spectrum_get_value (spectrum, 0);
 	if (wavelength > spectrum->end)
 		return cd_spectrum_get_value (spectrum, size - 1);
+	if (size == 1)
+		return cd_spectrum_get_value (spectrum, 0);
 
-	/* add all the data points */
-	interp = cd_interp_linear_new ();
-	for (i = 0; i < size; i++) {
-		cd_interp_insert (interp,
-				  cd_spectrum_get_wavelength (spectrum, i),
-				  cd_spectrum_get_value (spectrum, i));
+	/* regular grid: the bracketing indexes can be computed directly */
+	if (spectrum->wavelength_cal[0] < 0) {
+		gdouble pos;
+		guint number_points;
+		if (spectrum->reserved_size > 0)
+			number_points = spectrum->reserved_size;
+		else
+			number_points = size;
+		pos = (wavelength - spectrum->start) * (gdouble) (number_points - 1) /
+			(spectrum->end - spectrum->start);
+		lo = (guint) pos;
+		if (lo >= size - 1)
+			return cd_spectrum_get_value (spectrum, size - 1);
+		frac = pos - (gdouble) lo;
+		return cd_spectrum_get_value (spectrum, lo) * (1.0 - frac) +
+		       cd_spectrum_get_value (spectrum, lo + 1) * frac;
 	}
 
-	/* get the interpolated value */
-	if (!cd_interp_prepare (interp, NULL))
-		return -1.f;
-	return cd_interp_eval (interp, wavelength, NULL);
+	/* calibrated grid: binary search the precomputed wavelength table */
+	cd_spectrum_ensure_wavelength_lut ((CdSpectrum *) spectrum);
+	lut = spectrum->wavelength_lut;
+	lo = 0;
+	hi = size - 1;
+	while (hi - lo > 1) {
+		guint mid = (lo + hi) / 2;
+		if (lut[mid] > wavelength)
+			hi = mid;
+		else
+			lo = mid;
+	}
+	span = lut[hi] - lut[lo];
+	frac = span > 0.0 ? (wavelength - lut[lo]) / span : 0.0;
+	return cd_spectrum_get_value (spectrum, lo) * (1.0 - frac) +
+	       cd_spectrum_get_value (spectrum, hi) * frac;
 }
 
 /**
@@ -700,19 +1023,85 @@ cd_spectrum_normalize (CdSpectrum *spectrum, gdouble wavelength, gdouble value)
 void
 cd_spectrum_normalize_max (CdSpectrum *spectrum, gdouble value)
 {
+	const gdouble *data = cd_spectrum_get_data_raw (spectrum);
 	gdouble max = 0.f;
-	gdouble tmp;
 	guint i;
 
 	for (i = 0; i < spectrum->data->len; i++) {
-		tmp = cd_spectrum_get_value_raw (spectrum, i);
-		if (tmp > max)
-			max = tmp;
+		if (data[i] > max)
+			max = data[i];
 	}
 	if (max > 0.f)
 		spectrum->norm = value / max;
 }
 
+/* a spectrum has a plain linear grid when the index to wavelength
+ * mapping has no higher order terms */
+static gboolean
+cd_spectrum_has_linear_grid (const CdSpectrum *spectrum)
+{
+	return spectrum->wavelength_cal[0] < 0 ||
+	       (spectrum->wavelength_cal[1] == 0.f &&
+		spectrum->wavelength_cal[2] == 0.f);
+}
+
+/* both operands sample the same wavelengths at @resolution, so values
+ * can be combined index-by-index with no interpolation at all */
+static gboolean
+cd_spectrum_grid_equal (const CdSpectrum *s1,
+			const CdSpectrum *s2,
+			gdouble resolution)
+{
+	if (s1->data->len < 2 || s1->data->len != s2->data->len)
+		return FALSE;
+	if (!cd_spectrum_has_linear_grid (s1) ||
+	    !cd_spectrum_has_linear_grid (s2))
+		return FALSE;
+	if (fabs (s1->start - s2->start) > 0.01f)
+		return FALSE;
+	if (fabs (s1->end - s2->end) > 0.01f)
+		return FALSE;
+	if (fabs ((s1->end - s1->start) /
+		  (gdouble) (s1->data->len - 1) - resolution) > 0.01f)
+		return FALSE;
+	return TRUE;
+}
+
+/* builds the interpolator once, so per-nm lookups in a loop do not have
+ * to re-insert and re-prepare every data point each time */
+static CdInterp *
+cd_spectrum_create_interp (const CdSpectrum *spectrum)
+{
+	guint i;
+	g_autoptr(CdInterp) interp = cd_interp_linear_new ();
+
+	for (i = 0; i < spectrum->data->len; i++) {
+		cd_interp_insert (interp,
+				  cd_spectrum_get_wavelength (spectrum, i),
+				  cd_spectrum_get_value (spectrum, i));
+	}
+	if (!cd_interp_prepare (interp, NULL))
+		return NULL;
+	return g_steal_pointer (&interp);
+}
+
+/* mirrors the clamping done by cd_spectrum_get_value_for_nm() */
+static gdouble
+cd_spectrum_interp_eval (const CdSpectrum *spectrum,
+			 CdInterp *interp,
+			 gdouble wavelength)
+{
+	if (spectrum->data->len == 0)
+		return 1.f;
+	if (interp == NULL)
+		return -1.f;
+	if (wavelength < spectrum->start)
+		return cd_spectrum_get_value (spectrum, 0);
+	if (wavelength > spectrum->end)
+		return cd_spectrum_get_value (spectrum, spectrum->data->len - 1);
+	return cd_interp_eval (interp, wavelength, NULL);
+}
+
 /**
  * cd_spectrum_multiply:
  * @s1: a #CdSpectrum instance, possibly an illuminant.
@@ -730,14 +1119,36 @@ cd_spectrum_multiply (CdSpectrum *s1, CdSpectrum *s2, gdouble resolution)
 {
 	CdSpectrum *s;
 	gdouble i;
+	g_autoptr(CdInterp) interp1 = NULL;
+	g_autoptr(CdInterp) interp2 = NULL;
+
+	/* fast path: equal grids multiply as contiguous arrays */
+	if (cd_spectrum_grid_equal (s1, s2, resolution)) {
+		const gdouble *d1 = cd_spectrum_get_data_raw (s1);
+		const gdouble *d2 = cd_spectrum_get_data_raw (s2);
+		gdouble norm = s1->norm * s2->norm;
+		guint j;
+
+		s = cd_spectrum_sized_new (s1->data->len);
+		s->id = g_strdup_printf ("%s✕%s", s1->id, s2->id);
+		s->start = s1->start;
+		s->end = s1->end;
+		for (j = 0; j < s1->data->len; j++) {
+			gdouble tmp = d1[j] * d2[j] * norm;
+			g_array_append_val (s->data, tmp);
+		}
+		return s;
+	}
 
 	s = cd_spectrum_new ();
 	s->id = g_strdup_printf ("%s✕%s", s1->id, s2->id);
 	s->start = MAX (s1->start, s2->start);
 	s->end = MIN (s1->end, s2->end);
+	interp1 = cd_spectrum_create_interp (s1);
+	interp2 = cd_spectrum_create_interp (s2);
 	for (i = s->start; i <= s->end; i += resolution) {
-		cd_spectrum_add_value (s, cd_spectrum_get_value_for_nm (s1, i) *
-					  cd_spectrum_get_value_for_nm (s2, i));
+		cd_spectrum_add_value (s, cd_spectrum_interp_eval (s1, interp1, i) *
+					  cd_spectrum_interp_eval (s2, interp2, i));
 	}
 	return s;
 }
@@ -783,6 +1194,8 @@ cd_spectrum_subtract (CdSpectrum *s1, CdSpectrum *s2, gdouble resolution)
 	gdouble min;
 	gdouble nm;
 	guint i;
+	g_autoptr(CdInterp) interp1 = NULL;
+	g_autoptr(CdInterp) interp2 = NULL;
 
 	g_return_val_if_fail (s1 != NULL, NULL);
 	g_return_val_if_fail (s2 != NULL, NULL);
@@ -791,6 +1204,9 @@ cd_spectrum_subtract (CdSpectrum *s1, CdSpectrum *s2, gdouble resolution)
 	if (fabs (s1->start - s2->start) < 0.01f &&
 	    fabs (s1->end - s2->end) < 0.01f &&
 	    s1->data->len == s2->data->len) {
+		const gdouble *d1 = cd_spectrum_get_data_raw (s1);
+		const gdouble *d2 = cd_spectrum_get_data_raw (s2);
+
 		s = cd_spectrum_sized_new (s1->data->len);
 		s->id = g_strdup_printf ("%s-%s", s1->id, s2->id);
 		s->start = s1->start;
@@ -798,9 +1214,8 @@ cd_spectrum_subtract (CdSpectrum *s1, CdSpectrum *s2, gdouble resolution)
 		for (i = 0; i < 3; i++)
 			s->wavelength_cal[i] = s1->wavelength_cal[i];
 		for (i = 0; i < s1->data->len; i++) {
-			gdouble tmp;
-			tmp = cd_spectrum_get_value (s1, i) - cd_spectrum_get_value (s2, i);
-			cd_spectrum_add_value (s, tmp);
+			gdouble tmp = d1[i] * s1->norm - d2[i] * s2->norm;
+			g_array_append_val (s->data, tmp);
 		}
 		return s;
 	}
@@ -812,10 +1227,12 @@ cd_spectrum_subtract (CdSpectrum *s1, CdSpectrum *s2, gdouble resolution)
 	s->id = g_strdup_printf ("%s-%s", s1->id, s2->id);
 	s->start = min;
 	s->end = max;
+	interp1 = cd_spectrum_create_interp (s1);
+	interp2 = cd_spectrum_create_interp (s2);
 	for (nm = min; nm <= max; nm += resolution) {
 		gdouble tmp;
-		tmp = cd_spectrum_get_value_for_nm (s1, nm) -
-			cd_spectrum_get_value_for_nm (s2, nm);
+		tmp = cd_spectrum_interp_eval (s1, interp1, nm) -
+			cd_spectrum_interp_eval (s2, interp2, nm);
 		cd_spectrum_add_value (s, tmp);
 	}
 	return s;
@@ -910,6 +1327,10 @@ cd_spectrum_set_wavelength_cal (CdSpectrum *spectrum,
 	spectrum->wavelength_cal[1] = c2;
 	spectrum->wavelength_cal[2] = c3;
 
+	/* precompute the index to wavelength mapping */
+	cd_spectrum_invalidate_wavelength_lut (spectrum);
+	cd_spectrum_ensure_wavelength_lut (spectrum);
+
 	/* recalculate the end wavelength */
 	spectrum->end = cd_spectrum_get_wavelength (spectrum,
 						    cd_spectrum_get_size (spectrum) - 1);
@@ -960,12 +1381,31 @@ cd_spectrum_resample (CdSpectrum *spectrum,
 {
 	gdouble nm;
 	CdSpectrum *sp;
+	g_autoptr(CdInterp) interp = NULL;
+
+	/* fast path: the requested grid matches the existing one */
+	if (cd_spectrum_grid_equal (spectrum, spectrum, resolution) &&
+	    fabs (spectrum->start - start) < 0.01f &&
+	    fabs (spectrum->end - end) < 0.01f) {
+		const gdouble *data = cd_spectrum_get_data_raw (spectrum);
+		guint i;
+
+		sp = cd_spectrum_sized_new (spectrum->data->len);
+		cd_spectrum_set_start (sp, start);
+		for (i = 0; i < spectrum->data->len; i++) {
+			gdouble tmp = data[i] * spectrum->norm;
+			g_array_append_val (sp->data, tmp);
+		}
+		cd_spectrum_set_end (sp, end);
+		return sp;
+	}
 
 	sp = cd_spectrum_new ();
 	cd_spectrum_set_start (sp, start);
+	interp = cd_spectrum_create_interp (spectrum);
 	for (nm = start; nm <= end; nm += resolution) {
 		gdouble tmp;
-		tmp = cd_spectrum_get_value_for_nm (spectrum, nm);
+		tmp = cd_spectrum_interp_eval (spectrum, interp, nm);
 		cd_spectrum_add_value (sp, tmp);
 	}
 	cd_spectrum_set_end (sp, end);
@@ -989,15 +1429,17 @@ cd_spectrum_resample_to_size (CdSpectrum *spectrum, guint size)
 	gdouble inc;
 	guint i;
 	CdSpectrum *sp;
+	g_autoptr(CdInterp) interp = NULL;
 
 	sp = cd_spectrum_new ();
 	cd_spectrum_set_start (sp, spectrum->start);
 	cd_spectrum_set_end (sp, spectrum->end);
 
 	inc = (spectrum->end - spectrum->start) / (gdouble) (size - 1);
+	interp = cd_spectrum_create_interp (spectrum);
 	for (i = 0; i < size; i++) {
 		gdouble nm = spectrum->start + ((gdouble) i * inc);
-		gdouble tmp = cd_spectrum_get_value_for_nm (spectrum, nm);
+		gdouble tmp = cd_spectrum_interp_eval (spectrum, interp, nm);
 		cd_spectrum_add_value (sp, tmp);
 	}
 	return sp;
@@ -32,16 +32,83 @@ G_BEGIN_DECLS
 
 typedef struct _CdSpectrum	CdSpectrum;
 
+/**
+ * CdSpectrumStandard:
+ * @CD_SPECTRUM_STANDARD_CIE1931_2DEG_X:	CIE 1931 2° observer, X channel
+ * @CD_SPECTRUM_STANDARD_CIE1931_2DEG_Y:	CIE 1931 2° observer, Y channel
+ * @CD_SPECTRUM_STANDARD_CIE1931_2DEG_Z:	CIE 1931 2° observer, Z channel
+ * @CD_SPECTRUM_STANDARD_CIE1964_10DEG_X:	CIE 1964 10° observer, X channel
+ * @CD_SPECTRUM_STANDARD_CIE1964_10DEG_Y:	CIE 1964 10° observer, Y channel
+ * @CD_SPECTRUM_STANDARD_CIE1964_10DEG_Z:	CIE 1964 10° observer, Z channel
+ * @CD_SPECTRUM_STANDARD_ILLUMINANT_A:		CIE standard illuminant A
+ * @CD_SPECTRUM_STANDARD_ILLUMINANT_B:		CIE standard illuminant B
+ * @CD_SPECTRUM_STANDARD_ILLUMINANT_C:		CIE standard illuminant C
+ * @CD_SPECTRUM_STANDARD_ILLUMINANT_D50:	CIE standard illuminant D50
+ * @CD_SPECTRUM_STANDARD_ILLUMINANT_D55:	CIE standard illuminant D55
+ * @CD_SPECTRUM_STANDARD_ILLUMINANT_D65:	CIE standard illuminant D65
+ * @CD_SPECTRUM_STANDARD_ILLUMINANT_D93:	CIE standard illuminant D93
+ * @CD_SPECTRUM_STANDARD_ILLUMINANT_E:		CIE standard illuminant E
+ * @CD_SPECTRUM_STANDARD_ILLUMINANT_F1:		CIE standard illuminant F1
+ * @CD_SPECTRUM_STANDARD_ILLUMINANT_F2:		CIE standard illuminant F2
+ * @CD_SPECTRUM_STANDARD_ILLUMINANT_F3:		CIE standard illuminant F3
+ * @CD_SPECTRUM_STANDARD_ILLUMINANT_F4:		CIE standard illuminant F4
+ * @CD_SPECTRUM_STANDARD_ILLUMINANT_F5:		CIE standard illuminant F5
+ * @CD_SPECTRUM_STANDARD_ILLUMINANT_F6:		CIE standard illuminant F6
+ * @CD_SPECTRUM_STANDARD_ILLUMINANT_F7:		CIE standard illuminant F7
+ * @CD_SPECTRUM_STANDARD_ILLUMINANT_F8:		CIE standard illuminant F8
+ * @CD_SPECTRUM_STANDARD_ILLUMINANT_F9:		CIE standard illuminant F9
+ * @CD_SPECTRUM_STANDARD_ILLUMINANT_F10:	CIE standard illuminant F10
+ * @CD_SPECTRUM_STANDARD_ILLUMINANT_F11:	CIE standard illuminant F11
+ * @CD_SPECTRUM_STANDARD_ILLUMINANT_F12:	CIE standard illuminant F12
+ *
+ * A reference spectrum compiled into the library.
+ *
+ * Since: 1.4.6
+ **/
+typedef enum {
+	CD_SPECTRUM_STANDARD_CIE1931_2DEG_X,
+	CD_SPECTRUM_STANDARD_CIE1931_2DEG_Y,
+	CD_SPECTRUM_STANDARD_CIE1931_2DEG_Z,
+	CD_SPECTRUM_STANDARD_CIE1964_10DEG_X,
+	CD_SPECTRUM_STANDARD_CIE1964_10DEG_Y,
+	CD_SPECTRUM_STANDARD_CIE1964_10DEG_Z,
+	CD_SPECTRUM_STANDARD_ILLUMINANT_A,
+	CD_SPECTRUM_STANDARD_ILLUMINANT_B,
+	CD_SPECTRUM_STANDARD_ILLUMINANT_C,
+	CD_SPECTRUM_STANDARD_ILLUMINANT_D50,
+	CD_SPECTRUM_STANDARD_ILLUMINANT_D55,
+	CD_SPECTRUM_STANDARD_ILLUMINANT_D65,
+	CD_SPECTRUM_STANDARD_ILLUMINANT_D93,
+	CD_SPECTRUM_STANDARD_ILLUMINANT_E,
+	CD_SPECTRUM_STANDARD_ILLUMINANT_F1,
+	CD_SPECTRUM_STANDARD_ILLUMINANT_F2,
+	CD_SPECTRUM_STANDARD_ILLUMINANT_F3,
+	CD_SPECTRUM_STANDARD_ILLUMINANT_F4,
+	CD_SPECTRUM_STANDARD_ILLUMINANT_F5,
+	CD_SPECTRUM_STANDARD_ILLUMINANT_F6,
+	CD_SPECTRUM_STANDARD_ILLUMINANT_F7,
+	CD_SPECTRUM_STANDARD_ILLUMINANT_F8,
+	CD_SPECTRUM_STANDARD_ILLUMINANT_F9,
+	CD_SPECTRUM_STANDARD_ILLUMINANT_F10,
+	CD_SPECTRUM_STANDARD_ILLUMINANT_F11,
+	CD_SPECTRUM_STANDARD_ILLUMINANT_F12,
+	/*< private >*/
+	CD_SPECTRUM_STANDARD_LAST
+} CdSpectrumStandard;
+
 #define	CD_TYPE_SPECTRUM	(cd_spectrum_get_type ())
 
 GType		 cd_spectrum_get_type		(void);
 CdSpectrum	*cd_spectrum_new		(void);
 CdSpectrum	*cd_spectrum_sized_new		(guint			 reserved_size);
+CdSpectrum	*cd_spectrum_new_standard	(CdSpectrumStandard	 standard);
 CdSpectrum	*cd_spectrum_planckian_new	(gdouble		 temperature);
 CdSpectrum	*cd_spectrum_planckian_new_full	(gdouble		 temperature,
 						 gdouble		 start,
 						 gdouble		 end,
 						 gdouble		 resolution);
+gboolean	 cd_spectrum_planckian_update	(CdSpectrum		*spectrum,
+						 gdouble		 temperature);
 void		 cd_spectrum_free		(CdSpectrum		*spectrum);
 CdSpectrum	*cd_spectrum_dup		(const CdSpectrum	*spectrum);
 void		 cd_spectrum_limit_min		(CdSpectrum		*spectrum,
@@ -62,6 +129,8 @@ gchar		*cd_spectrum_to_string		(CdSpectrum		*spectrum,
 
 const gchar	*cd_spectrum_get_id		(const CdSpectrum	*spectrum);
 GArray		*cd_spectrum_get_data		(const CdSpectrum	*spectrum);
+const gdouble	*cd_spectrum_get_data_raw	(const CdSpectrum	*spectrum);
+GArray		*cd_spectrum_steal_data		(CdSpectrum		*spectrum);
 gdouble		 cd_spectrum_get_start		(const CdSpectrum	*spectrum);
 gdouble		 cd_spectrum_get_end		(const CdSpectrum	*spectrum);
 gdouble		 cd_spectrum_get_norm		(const CdSpectrum	*spectrum);
@@ -26,6 +26,7 @@
 #include <glib.h>
 #include <glib-object.h>
 #include <pwd.h>
+#include <unistd.h>
 
 #include "cd-client.h"
 #include "cd-client-sync.h"
@@ -1392,7 +1393,10 @@ colord_client_fd_pass_func (void)
 	GHashTable *profile_props;
 	gboolean ret;
 	g_autoptr(GError) error = NULL;
+	gchar *data = NULL;
 	gchar *filename;
+	gint fd;
+	gsize len = 0;
 
 	/* no running colord to use */
 	if (!has_colord_process) {
@@ -1425,6 +1429,24 @@ colord_client_fd_pass_func (void)
 	g_assert_no_error (error);
 	g_assert (profile != NULL);
 
+	/* connect */
+	ret = cd_profile_connect_sync (profile, NULL, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+
+	/* get the validated profile data back as a sealed fd */
+	fd = cd_profile_get_data_fd_sync (profile, NULL, &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (fd, >=, 0);
+
+	/* check the fd contains the same data as the file */
+	ret = g_file_get_contents (filename, &data, &len, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	g_assert_cmpint (lseek (fd, 0, SEEK_END), ==, (off_t) len);
+	close (fd);
+	g_free (data);
+
 	g_hash_table_unref (profile_props);
 	g_object_unref (profile);
 	g_object_unref (client);
@@ -1968,6 +1990,90 @@ colord_device_func (void)
 	g_object_unref (device);
 }
 
+static void
+colord_client_get_devices_full_func (void)
+{
+	CdClient *client;
+	CdDevice *device;
+	CdDevice *device_tmp = NULL;
+	gboolean ret;
+	gchar *device_id;
+	g_autoptr(GError) error = NULL;
+	GHashTable *device_props;
+	GPtrArray *array;
+	guint32 key;
+	guint i;
+
+	/* no running colord to use */
+	if (!has_colord_process) {
+		g_print ("[DISABLED] ");
+		return;
+	}
+
+	key = g_random_int_range (0x00, 0xffff);
+	device_id = g_strdup_printf ("device-self-test-%04x", key);
+
+	/* connect */
+	client = cd_client_new ();
+	ret = cd_client_connect_sync (client, NULL, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+
+	/* create device */
+	device_props = g_hash_table_new_full (g_str_hash, g_str_equal,
+					      g_free, g_free);
+	g_hash_table_insert (device_props,
+			     g_strdup (CD_DEVICE_PROPERTY_KIND),
+			     g_strdup (cd_device_kind_to_string (CD_DEVICE_KIND_DISPLAY)));
+	g_hash_table_insert (device_props,
+			     g_strdup (CD_DEVICE_PROPERTY_MODEL),
+			     g_strdup ("3000"));
+	device = cd_client_create_device_sync (client,
+					       device_id,
+					       CD_OBJECT_SCOPE_TEMP,
+					       device_props,
+					       NULL,
+					       &error);
+	g_assert_no_error (error);
+	g_assert (device != NULL);
+
+	/* get all the devices with properties in one call */
+	array = cd_client_get_devices_full_sync (client, NULL, &error);
+	g_assert_no_error (error);
+	g_assert (array != NULL);
+	g_assert_cmpint (array->len, >, 0);
+
+	/* find the device we just created, already connected */
+	for (i = 0; i < array->len; i++) {
+		device_tmp = g_ptr_array_index (array, i);
+		if (g_strcmp0 (cd_device_get_object_path (device_tmp),
+			       cd_device_get_object_path (device)) == 0)
+			break;
+		device_tmp = NULL;
+	}
+	g_assert (device_tmp != NULL);
+
+	/* the client dedupes proxies for the same object path */
+	g_assert (device_tmp == device);
+	g_assert_cmpstr (cd_device_get_id (device_tmp), ==, device_id);
+	g_assert_cmpstr (cd_device_get_model (device_tmp), ==, "3000");
+	g_assert_cmpint (cd_device_get_kind (device_tmp), ==, CD_DEVICE_KIND_DISPLAY);
+	g_ptr_array_unref (array);
+
+	/* delete device */
+	ret = cd_client_delete_device_sync (client,
+					    device,
+					    NULL,
+					    &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+
+	g_free (device_id);
+	g_hash_table_unref (device_props);
+	g_object_unref (client);
+	g_object_unref (device);
+}
+
 static void
 colord_device_embedded_func (void)
 {
@@ -2727,6 +2833,7 @@ main (int argc, char **argv)
 	g_test_add_func ("/colord/device{modified}", colord_device_modified_func);
 	g_test_add_func ("/colord/client{standard-space}", colord_client_standard_space_func);
 	g_test_add_func ("/colord/client{async}", colord_client_async_func);
+	g_test_add_func ("/colord/client{get-devices-full}", colord_client_get_devices_full_func);
 	g_test_add_func ("/colord/device{async}", colord_device_async_func);
 	if (g_test_thorough ())
 		g_test_add_func ("/colord/client{systemwide}", colord_client_systemwide_func);
@@ -122,15 +122,18 @@ static void
 colord_it8_spectra_util_func (void)
 {
 	CdColorXYZ value;
+	CdColorXYZ values[2];
 	CdSpectrum *data;
 	GFile *file;
 	gboolean ret;
 	gchar *filename;
+	guint i;
 	g_autoptr(CdIt8) cmf = NULL;
 	g_autoptr(CdIt8) spectra = NULL;
 	g_autoptr(CdSpectrum) unity = NULL;
 	g_autoptr(GError) error = NULL;
 	g_autoptr(GPtrArray) array = NULL;
+	g_autoptr(GPtrArray) batch = NULL;
 
 	/* load a CMF */
 	cmf = cd_it8_new ();
@@ -168,12 +171,29 @@ colord_it8_spectra_util_func (void)
 	g_assert_cmpfloat (value.Y, <, 1.f + 0.01);
 	g_assert_cmpfloat (value.Z, >, 0.813050f - 0.01);
 	g_assert_cmpfloat (value.Z, <, 0.813050f + 0.01);
+
+	/* the batched version has to agree with the one-shot version */
+	batch = g_ptr_array_new ();
+	g_ptr_array_add (batch, data);
+	g_ptr_array_add (batch, data);
+	ret = cd_it8_utils_calculate_xyz_from_cmf_batch (cmf, unity, batch,
+							 values, 1.f, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	for (i = 0; i < 2; i++) {
+		cd_color_xyz_normalize (&values[i], 1.0, &values[i]);
+		g_assert_cmpfloat (ABS (values[i].X - value.X), <, 0.001f);
+		g_assert_cmpfloat (ABS (values[i].Y - value.Y), <, 0.001f);
+		g_assert_cmpfloat (ABS (values[i].Z - value.Z), <, 0.001f);
+	}
 }
 
 static void
 colord_spectrum_planckian_func (void)
 {
+	gboolean ret;
 	g_autoptr(CdSpectrum) s = NULL;
+	g_autoptr(CdSpectrum) s2 = NULL;
 	guint i;
 
 	s = cd_spectrum_planckian_new (2940);
@@ -188,6 +208,53 @@ colord_spectrum_planckian_func (void)
 		g_assert_cmpfloat (cd_spectrum_get_value (s, i), >, 1.f);
 		g_assert_cmpfloat (cd_spectrum_get_value (s, i), <, 241.f);
 	}
+
+	/* the cached copy has to match a freshly generated spectrum */
+	s2 = cd_spectrum_planckian_new (2940);
+	g_assert_cmpint (cd_spectrum_get_size (s2), ==, 531);
+	for (i = 0; i < cd_spectrum_get_size (s2); i++) {
+		g_assert_cmpfloat (ABS (cd_spectrum_get_value (s2, i) -
+					cd_spectrum_get_value (s, i)), <, 0.0001f);
+	}
+
+	/* updating in place has to match generating from scratch */
+	ret = cd_spectrum_planckian_update (s2, 6500);
+	g_assert (ret);
+	g_assert_cmpstr (cd_spectrum_get_id (s2), ==, "Planckian@6500K");
+	cd_spectrum_free (s);
+	s = cd_spectrum_planckian_new (6500);
+	for (i = 0; i < cd_spectrum_get_size (s); i++) {
+		g_assert_cmpfloat (ABS (cd_spectrum_get_value (s2, i) -
+					cd_spectrum_get_value (s, i)), <, 0.0001f);
+	}
+}
+
+static void
+colord_spectrum_standard_func (void)
+{
+	g_autoptr(CdSpectrum) s = NULL;
+	g_autoptr(CdSpectrum) s2 = NULL;
+	g_autoptr(CdSpectrum) s3 = NULL;
+
+	/* D65 is normalized to 100 at 560nm */
+	s = cd_spectrum_new_standard (CD_SPECTRUM_STANDARD_ILLUMINANT_D65);
+	g_assert (s != NULL);
+	g_assert_cmpstr (cd_spectrum_get_id (s), ==, "CIE-D65");
+	g_assert_cmpfloat (ABS (cd_spectrum_get_start (s) - 300.f), <, 0.0001f);
+	g_assert_cmpfloat (ABS (cd_spectrum_get_end (s) - 830.f), <, 0.0001f);
+	g_assert_cmpint (cd_spectrum_get_size (s), ==, 107);
+	g_assert_cmpfloat (ABS (cd_spectrum_get_value_for_nm (s, 560) - 100.f), <, 0.0001f);
+
+	/* the sample data is shared between instances of the same standard */
+	s2 = cd_spectrum_new_standard (CD_SPECTRUM_STANDARD_ILLUMINANT_D65);
+	g_assert (cd_spectrum_get_data_raw (s2) == cd_spectrum_get_data_raw (s));
+
+	/* the 1931 y-bar curve peaks at exactly 1.0 at 555nm */
+	s3 = cd_spectrum_new_standard (CD_SPECTRUM_STANDARD_CIE1931_2DEG_Y);
+	g_assert (s3 != NULL);
+	g_assert_cmpint (cd_spectrum_get_size (s3), ==, 95);
+	g_assert_cmpfloat (ABS (cd_spectrum_get_value_for_nm (s3, 555) - 1.f), <, 0.0001f);
+	g_assert_cmpfloat (ABS (cd_spectrum_get_value_max (s3) - 1.f), <, 0.0001f);
 }
 
 static void
@@ -252,6 +319,7 @@ colord_spectrum_subtract_func (void)
 static void
 colord_spectrum_func (void)
 {
+	GArray *data;
 	g_autoptr(CdSpectrum) s = NULL;
 	g_autofree gchar *txt = NULL;
 	gdouble val;
@@ -321,9 +389,21 @@ colord_spectrum_func (void)
 	g_assert_cmpfloat (ABS (cd_spectrum_get_value_raw (s, 1) - 0.75f), <, 0.001f);
 	g_assert_cmpfloat (ABS (cd_spectrum_get_value_raw (s, 2) - 1.f), <, 0.001f);
 
+	/* test direct access to the sample storage */
+	g_assert (cd_spectrum_get_data_raw (s) != NULL);
+	g_assert_cmpfloat (ABS (cd_spectrum_get_data_raw (s)[0] - 0.5f), <, 0.001f);
+	g_assert_cmpfloat (ABS (cd_spectrum_get_data_raw (s)[2] - 1.f), <, 0.001f);
+
 	/* test setting of data */
 	cd_spectrum_set_value (s, 0, 10.f);
 	g_assert_cmpfloat (ABS (cd_spectrum_get_value (s, 0) - 10.0f), <, 0.001f);
+
+	/* test stealing the sample storage */
+	data = cd_spectrum_steal_data (s);
+	g_assert (data != NULL);
+	g_assert_cmpint (data->len, ==, 3);
+	g_assert_cmpint (cd_spectrum_get_size (s), ==, 0);
+	g_array_unref (data);
 }
 
 static void
@@ -565,6 +645,8 @@ colord_it8_raw_func (void)
 	gboolean ret;
 	gchar *data;
 	gchar *filename;
+	g_autoptr(CdIt8) it8_binary = NULL;
+	g_autoptr(GBytes) blob = NULL;
 	g_autoptr(GError) error = NULL;
 	GFile *file;
 	GFile *file_new;
@@ -616,6 +698,26 @@ colord_it8_raw_func (void)
 	g_assert_cmpfloat (ABS (xyz.Y - 99.88f), <, 0.01f);
 	g_assert_cmpfloat (ABS (xyz.Z - 116.59f), <, 0.01f);
 
+	/* round-trip through the binary format */
+	blob = cd_it8_save_to_data_binary (it8, &error);
+	g_assert_no_error (error);
+	g_assert (blob != NULL);
+	it8_binary = cd_it8_new ();
+	ret = cd_it8_load_from_data (it8_binary,
+				     g_bytes_get_data (blob, NULL),
+				     g_bytes_get_size (blob),
+				     &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	g_assert_cmpint (cd_it8_get_kind (it8_binary), ==, CD_IT8_KIND_TI3);
+	g_assert_cmpint (cd_it8_get_data_size (it8_binary), ==, 5);
+	g_assert_cmpstr (cd_it8_get_instrument (it8_binary), ==, "huey");
+	ret = cd_it8_get_data_item (it8_binary, 1, &rgb, &xyz);
+	g_assert (ret);
+	g_assert_cmpfloat (ABS (xyz.X - 145.46f), <, 0.01f);
+	g_assert_cmpfloat (ABS (xyz.Y - 99.88f), <, 0.01f);
+	g_assert_cmpfloat (ABS (xyz.Z - 116.59f), <, 0.01f);
+
 	/* remove temp file */
 	ret = g_file_delete (file_new, NULL, &error);
 	g_assert_no_error (error);
@@ -723,11 +825,17 @@ colord_it8_normalized_func (void)
 static void
 colord_it8_ccmx_util_func (void)
 {
+	CdColorXYZ xyz[4];
 	CdIt8 *ccmx;
 	CdIt8 *meas;
 	CdIt8 *ref;
+	CdVec3 expected;
+	GPtrArray *ccmxs;
+	GPtrArray *meass;
+	GPtrArray *refs;
 	gboolean ret;
 	gchar *filename;
+	guint i;
 	g_autoptr(GError) error = NULL;
 	GFile *file;
 
@@ -757,6 +865,46 @@ colord_it8_ccmx_util_func (void)
 	g_assert_no_error (error);
 	g_assert (ret);
 
+	/* applying the matrix across a packed array has to agree with a
+	 * per-patch multiply */
+	for (i = 0; i < 4; i++) {
+		xyz[i].X = 0.1f * (i + 1);
+		xyz[i].Y = 0.2f * (i + 1);
+		xyz[i].Z = 0.3f * (i + 1);
+	}
+	cd_mat33_vector_multiply (cd_it8_get_matrix (ccmx),
+				  (const CdVec3 *) &xyz[2],
+				  &expected);
+	ret = cd_it8_utils_apply_ccmx_array (ccmx, xyz, 4, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	g_assert_cmpfloat (ABS (xyz[2].X - expected.v0), <, 0.0001f);
+	g_assert_cmpfloat (ABS (xyz[2].Y - expected.v1), <, 0.0001f);
+	g_assert_cmpfloat (ABS (xyz[2].Z - expected.v2), <, 0.0001f);
+
+	/* the batch version has to agree with the one-shot version */
+	refs = g_ptr_array_new ();
+	meass = g_ptr_array_new ();
+	ccmxs = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
+	for (i = 0; i < 4; i++) {
+		g_ptr_array_add (refs, ref);
+		g_ptr_array_add (meass, meas);
+		g_ptr_array_add (ccmxs, cd_it8_new_with_kind (CD_IT8_KIND_CCMX));
+	}
+	ret = cd_it8_utils_calculate_ccmx_batch (refs, meass, ccmxs, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	for (i = 0; i < 4; i++) {
+		CdIt8 *tmp = g_ptr_array_index (ccmxs, i);
+		g_assert_cmpfloat (ABS (cd_it8_get_matrix (tmp)->m00 -
+					cd_it8_get_matrix (ccmx)->m00), <, 0.0001f);
+		g_assert_cmpfloat (ABS (cd_it8_get_matrix (tmp)->m22 -
+					cd_it8_get_matrix (ccmx)->m22), <, 0.0001f);
+	}
+	g_ptr_array_unref (refs);
+	g_ptr_array_unref (meass);
+	g_ptr_array_unref (ccmxs);
+
 	g_object_unref (ref);
 	g_object_unref (meas);
 	g_object_unref (ccmx);
@@ -1024,6 +1172,39 @@ colord_dom_func (void)
 	g_assert_cmpstr (cd_dom_get_node_attribute (tmp, "wrap"), ==, "false");
 }
 
+static gboolean
+colord_dom_stream_cb (const gchar *path,
+		      const gchar *cdata,
+		      gpointer user_data,
+		      GError **error)
+{
+	GString *str = (GString *) user_data;
+	g_string_append_printf (str, "<%s> [%s]\n", path, cdata);
+	return TRUE;
+}
+
+static void
+colord_dom_stream_func (void)
+{
+	const gchar *markup = "<?xml version=\"1.0\" encoding=\"UTF-8\" ?><html> <body> <p class='1'>moo1</p> <p wrap='false'>moo2</p>\n</body> </html>";
+	gboolean ret;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GString) str = NULL;
+
+	/* parse without building a tree */
+	str = g_string_new (NULL);
+	ret = cd_dom_parse_xml_stream (markup, -1,
+				       colord_dom_stream_cb,
+				       str, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	g_assert_cmpstr (str->str, ==,
+			 "<html/body/p> [moo1]\n"
+			 "<html/body/p> [moo2]\n"
+			 "<html/body> []\n"
+			 "<html> []\n");
+}
+
 static void
 colord_dom_color_func (void)
 {
@@ -1064,6 +1245,46 @@ colord_dom_color_func (void)
 	g_assert (!ret);
 }
 
+static void
+colord_dom_double_array_func (void)
+{
+	const gchar *markup = "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>"
+		"<spectrum>"
+		" <data>1.0 2.5 -0.25\n"
+		"  3e2 4</data>"
+		"</spectrum>";
+	const GNode *tmp;
+	gboolean ret;
+	gdouble values[8];
+	guint cnt;
+	g_autoptr(CdDom) dom = NULL;
+	g_autoptr(GError) error = NULL;
+
+	dom = cd_dom_new ();
+
+	/* parse */
+	ret = cd_dom_parse_xml_data (dom, markup, -1, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+
+	/* get node */
+	tmp = cd_dom_get_node (dom, NULL, "spectrum/data");
+	g_assert (tmp != NULL);
+
+	/* get all the values */
+	cnt = cd_dom_get_node_double_array (tmp, values, 8);
+	g_assert_cmpint (cnt, ==, 5);
+	g_assert_cmpfloat (values[0], ==, 1.0);
+	g_assert_cmpfloat (values[1], ==, 2.5);
+	g_assert_cmpfloat (values[2], ==, -0.25);
+	g_assert_cmpfloat (values[3], ==, 300.0);
+	g_assert_cmpfloat (values[4], ==, 4.0);
+
+	/* stop when the buffer is full */
+	cnt = cd_dom_get_node_double_array (tmp, values, 2);
+	g_assert_cmpint (cnt, ==, 2);
+}
+
 static void
 colord_dom_localized_func (void)
 {
@@ -1136,6 +1357,101 @@ colord_color_func (void)
 	g_assert_cmpfloat (ABS (xyz->Z - 0.5), <, 0.01);
 }
 
+static void
+colord_color_array_func (void)
+{
+	CdColorRGB rgb[3];
+	CdColorRGB8 rgb8[3];
+	CdColorXYZ xyz[3];
+	CdColorYxy yxy[3];
+	guint i;
+
+	/* array conversion agrees with the single-shot version */
+	cd_color_xyz_set (&xyz[0], 0.125, 0.25, 0.5);
+	cd_color_xyz_set (&xyz[1], 0.0, 0.0, 0.0);
+	cd_color_xyz_set (&xyz[2], 0.95, 1.0, 1.09);
+	cd_color_xyz_to_yxy_array (xyz, yxy, 3);
+	for (i = 0; i < 3; i++) {
+		CdColorYxy yxy_check;
+		cd_color_xyz_to_yxy (&xyz[i], &yxy_check);
+		g_assert_cmpfloat (ABS (yxy[i].x - yxy_check.x), <, 0.001f);
+		g_assert_cmpfloat (ABS (yxy[i].y - yxy_check.y), <, 0.001f);
+	}
+
+	/* and back again, skipping the all-zero sample */
+	cd_color_yxy_to_xyz_array (yxy, xyz, 3);
+	g_assert_cmpfloat (ABS (xyz[2].Y - 1.0f), <, 0.001f);
+
+	/* 8-bit roundtrip, including clamping */
+	cd_color_rgb_set (&rgb[0], 0.0, 0.5, 1.0);
+	cd_color_rgb_set (&rgb[1], -0.5, 0.25, 1.5);
+	cd_color_rgb_set (&rgb[2], 1.0, 0.0, 0.75);
+	cd_color_rgb_to_rgb8_array (rgb, rgb8, 3);
+	g_assert_cmpint (rgb8[0].R, ==, 0);
+	g_assert_cmpint (rgb8[0].B, ==, 255);
+	g_assert_cmpint (rgb8[1].R, ==, 0);
+	g_assert_cmpint (rgb8[1].B, ==, 255);
+	cd_color_rgb8_to_rgb_array (rgb8, rgb, 3);
+	g_assert_cmpfloat (ABS (rgb[0].G - 0.5f), <, 0.01f);
+	g_assert_cmpfloat (ABS (rgb[2].R - 1.0f), <, 0.01f);
+}
+
+static void
+colord_color_packed_func (void)
+{
+	CdColorRGB rgb;
+	CdColorRGB *tmp;
+	g_autoptr(GArray) packed = NULL;
+	g_autoptr(GArray) packed2 = NULL;
+	g_autoptr(GPtrArray) boxed = NULL;
+
+	/* build contiguously, then box at the boundary */
+	packed = cd_color_rgb_array_new_packed (2);
+	cd_color_rgb_set (&rgb, 0.1, 0.2, 0.3);
+	g_array_append_val (packed, rgb);
+	cd_color_rgb_set (&rgb, 0.4, 0.5, 0.6);
+	g_array_append_val (packed, rgb);
+	boxed = cd_color_rgb_array_from_packed (packed);
+	g_assert_cmpint (boxed->len, ==, 2);
+	tmp = g_ptr_array_index (boxed, 1);
+	g_assert_cmpfloat (ABS (tmp->G - 0.5f), <, 0.001f);
+
+	/* and back again */
+	packed2 = cd_color_rgb_array_to_packed (boxed);
+	g_assert_cmpint (packed2->len, ==, 2);
+	g_assert_cmpfloat (ABS (g_array_index (packed2, CdColorRGB, 0).R - 0.1f),
+			   <, 0.001f);
+}
+
+static void
+colord_color_delta_e_func (void)
+{
+	CdColorLab p1[2];
+	CdColorLab p2[2];
+	gdouble result[2];
+
+	/* values from the Sharma CIEDE2000 test data */
+	cd_color_lab_set (&p1[0], 50.0000, 2.6772, -79.7751);
+	cd_color_lab_set (&p2[0], 50.0000, 0.0000, -82.7485);
+	cd_color_lab_set (&p1[1], 50.0000, 2.5000, 0.0000);
+	cd_color_lab_set (&p2[1], 73.0000, 25.0000, -18.0000);
+	g_assert_cmpfloat (ABS (cd_color_lab_delta_e2000 (&p1[0], &p2[0]) -
+				2.0425), <, 0.0001);
+	g_assert_cmpfloat (ABS (cd_color_lab_delta_e2000 (&p1[1], &p2[1]) -
+				27.1492), <, 0.0001);
+	g_assert_cmpfloat (ABS (cd_color_lab_delta_e94 (&p1[0], &p2[0]) -
+				1.3950), <, 0.0001);
+
+	/* batch results agree with the single-shot versions */
+	cd_color_lab_delta_e2000_array (p1, p2, result, 2);
+	g_assert_cmpfloat (ABS (result[0] - 2.0425), <, 0.0001);
+	g_assert_cmpfloat (ABS (result[1] - 27.1492), <, 0.0001);
+	cd_color_lab_delta_e76_array (p1, p2, result, 2);
+	g_assert_cmpfloat (ABS (result[0] -
+				cd_color_lab_delta_e76 (&p1[0], &p2[0])),
+			   <, 0.0001);
+}
+
 
 static void
 cd_test_math_func (void)
@@ -1163,6 +1479,72 @@ cd_test_math_func (void)
 	g_assert_cmpfloat (mat.m22, >, -0.001f);
 }
 
+static void
+cd_test_math_solve_func (void)
+{
+	CdMat3x3 mat;
+	CdMat3x3 mat_inv;
+	CdVec3 rhs;
+	CdVec3 tmp;
+	CdVec3 vec_batch[4];
+	CdVec3 vec_check;
+	CdVec3 vec_solve;
+	GTimer *timer;
+	gboolean ret;
+	guint i;
+	guint repeats = 100000;
+
+	/* solving has to agree with invert-then-multiply */
+	cd_mat33_init (&mat,
+		       0.4124, 0.3576, 0.1805,
+		       0.2126, 0.7152, 0.0722,
+		       0.0193, 0.1192, 0.9505);
+	cd_vec3_init (&rhs, 0.9505, 1.0000, 1.0891);
+	ret = cd_mat33_reciprocal (&mat, &mat_inv);
+	g_assert (ret);
+	cd_mat33_vector_multiply (&mat_inv, &rhs, &vec_check);
+	ret = cd_mat33_solve (&mat, &rhs, &vec_solve);
+	g_assert (ret);
+	g_assert_cmpfloat (fabs (vec_solve.v0 - vec_check.v0), <, 1e-9);
+	g_assert_cmpfloat (fabs (vec_solve.v1 - vec_check.v1), <, 1e-9);
+	g_assert_cmpfloat (fabs (vec_solve.v2 - vec_check.v2), <, 1e-9);
+
+	/* a singular matrix has to fail cleanly */
+	cd_mat33_clear (&mat_inv);
+	ret = cd_mat33_solve (&mat_inv, &rhs, &vec_solve);
+	g_assert (!ret);
+
+	/* batch multiply agrees with the single-shot version */
+	for (i = 0; i < 4; i++)
+		cd_vec3_init (&vec_batch[i], 0.1 * i, 0.2 * i, 0.3 * i);
+	cd_mat33_vector_multiply_batch (&mat, vec_batch, vec_batch, 4);
+	for (i = 0; i < 4; i++) {
+		cd_vec3_init (&tmp, 0.1 * i, 0.2 * i, 0.3 * i);
+		cd_mat33_vector_multiply (&mat, &tmp, &vec_check);
+		g_assert_cmpfloat (fabs (vec_batch[i].v0 - vec_check.v0), <, 1e-9);
+		g_assert_cmpfloat (fabs (vec_batch[i].v1 - vec_check.v1), <, 1e-9);
+		g_assert_cmpfloat (fabs (vec_batch[i].v2 - vec_check.v2), <, 1e-9);
+	}
+
+	/* solve a lot of systems */
+	timer = g_timer_new ();
+	for (i = 0; i < repeats; i++) {
+		ret = cd_mat33_solve (&mat, &rhs, &vec_solve);
+		g_assert (ret);
+	}
+	g_print ("solve = %.0fns ",
+		 g_timer_elapsed (timer, NULL) * 1e9 / repeats);
+	g_timer_reset (timer);
+	for (i = 0; i < repeats; i++) {
+		ret = cd_mat33_reciprocal (&mat, &mat_inv);
+		g_assert (ret);
+		cd_mat33_vector_multiply (&mat_inv, &rhs, &vec_check);
+	}
+	g_print ("invert-multiply = %.0fns ",
+		 g_timer_elapsed (timer, NULL) * 1e9 / repeats);
+	g_timer_destroy (timer);
+}
+
 static void
 colord_color_interpolate_func (void)
 {
@@ -1187,6 +1569,39 @@ colord_color_interpolate_func (void)
 	g_assert_cmpint (result->len, ==, 10);
 }
 
+static void
+colord_color_interpolate_packed_func (void)
+{
+	CdColorRGB *rgb;
+	guint i;
+	g_autoptr(GArray) packed = NULL;
+	g_autoptr(GArray) result = NULL;
+
+	/* a simple monotonic ramp doubles in size exactly */
+	packed = cd_color_rgb_array_new_packed (3);
+	g_array_set_size (packed, 3);
+	for (i = 0; i < 3; i++) {
+		rgb = &g_array_index (packed, CdColorRGB, i);
+		cd_color_rgb_set (rgb, i * 0.5, i * 0.5, i * 0.5);
+	}
+	result = cd_color_rgb_array_interpolate_packed (packed, 5);
+	g_assert (result != NULL);
+	g_assert_cmpint (result->len, ==, 5);
+	for (i = 0; i < 5; i++) {
+		rgb = &g_array_index (result, CdColorRGB, i);
+		g_assert_cmpfloat (ABS (rgb->R - i * 0.25), <, 0.0001f);
+		g_assert_cmpfloat (ABS (rgb->G - i * 0.25), <, 0.0001f);
+		g_assert_cmpfloat (ABS (rgb->B - i * 0.25), <, 0.0001f);
+	}
+
+	/* a non-monotonic ramp is rejected in the same pass */
+	rgb = &g_array_index (packed, CdColorRGB, 2);
+	cd_color_rgb_set (rgb, 0.1, 0.1, 0.1);
+	g_clear_pointer (&result, g_array_unref);
+	result = cd_color_rgb_array_interpolate_packed (packed, 5);
+	g_assert (result == NULL);
+}
+
 static void
 colord_color_blackbody_func (void)
 {
@@ -1251,6 +1666,38 @@ colord_color_blackbody_func (void)
 	g_assert_cmpfloat (fabs (rgb.B - 1.0000f), <, 0.01);
 }
 
+static void
+colord_color_cct_func (void)
+{
+	CdColorXYZ xyz;
+	gdouble cct;
+	gdouble duv = -1.f;
+
+	/* D65 white point, slightly above the Planckian locus */
+	cd_color_xyz_set (&xyz, 0.95047, 1.0, 1.08883);
+	cct = cd_color_xyz_to_cct_full (&xyz, &duv);
+	g_assert_cmpfloat (cct, >, 6450);
+	g_assert_cmpfloat (cct, <, 6550);
+	g_assert_cmpfloat (duv, >, 0.f);
+	g_assert_cmpfloat (duv, <, 0.01f);
+
+	/* illuminant A is by definition a 2856K blackbody */
+	cd_color_xyz_set (&xyz, 1.09850, 1.0, 0.35585);
+	cct = cd_color_xyz_to_cct_full (&xyz, NULL);
+	g_assert_cmpfloat (cct, >, 2840);
+	g_assert_cmpfloat (cct, <, 2870);
+
+	/* has to agree with the iterative version */
+	g_assert_cmpfloat (fabs (cct - cd_color_xyz_to_cct (&xyz)), <, 30);
+
+	/* a pure green still maps to an isotherm, but the large Duv
+	 * shows it is nowhere near the locus */
+	cd_color_xyz_set (&xyz, 0.f, 1.0, 0.f);
+	cct = cd_color_xyz_to_cct_full (&xyz, &duv);
+	g_assert_cmpfloat (cct, >, 0);
+	g_assert_cmpfloat (duv, >, 0.05f);
+}
+
 static void
 colord_interp_linear_func (void)
 {
@@ -1266,6 +1713,7 @@ colord_interp_linear_func (void)
 	const gdouble data[] = { 0.100000, 0.211111, 0.322222, 0.366667,
 				 0.388889, 0.488889, 0.666667, 0.822222,
 				 0.911111, 1.000000 };
+	g_autoptr(CdInterp) interp_nu = NULL;
 
 	/* check name */
 	interp = cd_interp_linear_new ();
@@ -1306,6 +1754,76 @@ colord_interp_linear_func (void)
 		g_assert_no_error (error);
 		g_assert_cmpfloat (y, <, data[i] + 0.01);
 	}
+
+	/* unevenly spaced data has to take the scanning path and still
+	 * agree with the evenly spaced results at the shared knots */
+	interp_nu = cd_interp_linear_new ();
+	cd_interp_insert (interp_nu, 0.00, 0.10);
+	cd_interp_insert (interp_nu, 0.25, 0.35);
+	cd_interp_insert (interp_nu, 0.50, 0.40);
+	cd_interp_insert (interp_nu, 0.90, 0.96);
+	cd_interp_insert (interp_nu, 1.00, 1.00);
+	ret = cd_interp_prepare (interp_nu, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	y = cd_interp_eval (interp_nu, 0.25, &error);
+	g_assert_no_error (error);
+	g_assert_cmpfloat (ABS (y - 0.35), <, 0.001);
+	y = cd_interp_eval (interp_nu, 0.95, &error);
+	g_assert_no_error (error);
+	g_assert_cmpfloat (ABS (y - 0.98), <, 0.001);
+}
+
+static void
+colord_interp_eval_array_func (void)
+{
+	gboolean ret;
+	gdouble x[256];
+	gdouble y[256];
+	g_autoptr(CdInterp) interp_akima = NULL;
+	g_autoptr(CdInterp) interp_linear = NULL;
+	g_autoptr(GError) error = NULL;
+	guint i;
+
+	/* same data for both kinds */
+	interp_linear = cd_interp_linear_new ();
+	interp_akima = cd_interp_akima_new ();
+	cd_interp_insert (interp_linear, 0.00, 0.10);
+	cd_interp_insert (interp_linear, 0.25, 0.35);
+	cd_interp_insert (interp_linear, 0.50, 0.40);
+	cd_interp_insert (interp_linear, 0.75, 0.80);
+	cd_interp_insert (interp_linear, 1.00, 1.00);
+	cd_interp_insert (interp_akima, 0.00, 0.10);
+	cd_interp_insert (interp_akima, 0.25, 0.35);
+	cd_interp_insert (interp_akima, 0.50, 0.40);
+	cd_interp_insert (interp_akima, 0.75, 0.80);
+	cd_interp_insert (interp_akima, 1.00, 1.00);
+	ret = cd_interp_prepare (interp_linear, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	ret = cd_interp_prepare (interp_akima, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+
+	/* a ramp-sized batch has to agree with per-point evaluation */
+	for (i = 0; i < 256; i++)
+		x[i] = (gdouble) i / 255.f;
+	ret = cd_interp_eval_array (interp_linear, x, y, 256, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	for (i = 0; i < 256; i++) {
+		gdouble tmp = cd_interp_eval (interp_linear, x[i], &error);
+		g_assert_no_error (error);
+		g_assert_cmpfloat (ABS (y[i] - tmp), <, 0.000001);
+	}
+	ret = cd_interp_eval_array (interp_akima, x, y, 256, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	for (i = 0; i < 256; i++) {
+		gdouble tmp = cd_interp_eval (interp_akima, x[i], &error);
+		g_assert_no_error (error);
+		g_assert_cmpfloat (ABS (y[i] - tmp), <, 0.000001);
+	}
 }
 
 static void
@@ -1365,6 +1883,122 @@ colord_buffer_func (void)
 	g_assert_cmpint (cd_buffer_read_uint16_le (buffer), ==, 8192);
 }
 
+static void
+colord_buffer_array_func (void)
+{
+	guint16 values[4] = { 0x1234, 0x00ff, 0x8000, 0xabcd };
+	guint16 values_tmp[4] = { 0, 0, 0, 0 };
+	guint8 buffer[4 * sizeof (guint16) + 1];
+	gdouble doubles[2] = { 0.0, 0.0 };
+	guint8 doubles_le[2 * sizeof (gdouble) + 1];
+	gdouble one = 1.0;
+	guint i;
+
+	/* roundtrip through an unaligned buffer */
+	cd_buffer_write_uint16_array_le (buffer + 1, values, 4);
+	g_assert_cmpint (buffer[1], ==, 0x34);
+	g_assert_cmpint (buffer[2], ==, 0x12);
+	cd_buffer_read_uint16_array_le (buffer + 1, values_tmp, 4);
+	for (i = 0; i < 4; i++)
+		g_assert_cmpint (values_tmp[i], ==, values[i]);
+
+	/* swapping twice gets us back */
+	cd_buffer_swap_uint16_array (values_tmp, 4);
+	g_assert_cmpint (values_tmp[0], ==, 0x3412);
+	cd_buffer_swap_uint16_array (values_tmp, 4);
+	for (i = 0; i < 4; i++)
+		g_assert_cmpint (values_tmp[i], ==, values[i]);
+
+	/* IEEE doubles from an unaligned little endian buffer */
+	memset (doubles_le, 0, sizeof (doubles_le));
+	memcpy (doubles_le + 1, &one, sizeof (gdouble));
+#if G_BYTE_ORDER == G_BIG_ENDIAN
+	{
+		guint8 tmp;
+		for (i = 0; i < 4; i++) {
+			tmp = doubles_le[1 + i];
+			doubles_le[1 + i] = doubles_le[8 - i];
+			doubles_le[8 - i] = tmp;
+		}
+	}
+#endif
+	cd_buffer_read_double_array_le (doubles_le + 1, doubles, 2);
+	g_assert_cmpfloat (doubles[0], ==, 1.0);
+	g_assert_cmpfloat (doubles[1], ==, 0.0);
+}
+
+static void
+colord_buffer_hash_func (void)
+{
+	guint8 data[100];
+	guint i;
+
+	/* official xxHash test vectors */
+	g_assert_cmpuint (cd_buffer_hash (NULL, 0, 0), ==, 0xef46db3751d8e999ULL);
+	g_assert_cmpuint (cd_buffer_hash ((const guint8 *) "abc", 3, 0), ==,
+			  0x44bc2cf5ad770999ULL);
+
+	/* long input covering the 32 byte stripe loop and all tails */
+	for (i = 0; i < 100; i++)
+		data[i] = (guint8) i;
+	g_assert_cmpuint (cd_buffer_hash (data, 100, 0), ==,
+			  cd_buffer_hash (data, 100, 0));
+	g_assert_cmpuint (cd_buffer_hash (data, 100, 0), !=,
+			  cd_buffer_hash (data, 99, 0));
+	g_assert_cmpuint (cd_buffer_hash (data, 100, 0), !=,
+			  cd_buffer_hash (data, 100, 1));
+}
+
+static void
+colord_perf_stats_func (void)
+{
+	guint64 before;
+	CdColorRGB *rgb;
+
+	/* enabled in main() before any counter was touched */
+	g_assert_true (cd_perf_stats_enabled ());
+
+	/* the color allocators feed the counter */
+	before = cd_perf_stats_get (CD_PERF_STAT_COLOR_ALLOC);
+	rgb = cd_color_rgb_new ();
+	g_assert_cmpuint (cd_perf_stats_get (CD_PERF_STAT_COLOR_ALLOC), ==, before + 1);
+	cd_color_rgb_free (rgb);
+
+	/* manual adds accumulate */
+	before = cd_perf_stats_get (CD_PERF_STAT_BYTES_HASHED);
+	cd_perf_stats_add (CD_PERF_STAT_BYTES_HASHED, 123);
+	g_assert_cmpuint (cd_perf_stats_get (CD_PERF_STAT_BYTES_HASHED), ==, before + 123);
+
+	/* reset clears everything */
+	cd_perf_stats_reset ();
+	g_assert_cmpuint (cd_perf_stats_get (CD_PERF_STAT_COLOR_ALLOC), ==, 0);
+	g_assert_cmpuint (cd_perf_stats_get (CD_PERF_STAT_BYTES_HASHED), ==, 0);
+}
+
+static void
+colord_icc_standard_space_func (void)
+{
+	g_autoptr(CdIcc) icc1 = NULL;
+	g_autoptr(CdIcc) icc2 = NULL;
+	g_autoptr(CdIcc) icc3 = NULL;
+	g_autoptr(GError) error = NULL;
+
+	/* every caller gets the same shared instance */
+	icc1 = cd_icc_get_standard_space (CD_STANDARD_SPACE_SRGB, &error);
+	g_assert_no_error (error);
+	g_assert (icc1 != NULL);
+	icc2 = cd_icc_get_standard_space (CD_STANDARD_SPACE_SRGB, &error);
+	g_assert_no_error (error);
+	g_assert (icc2 == icc1);
+	g_assert_cmpstr (cd_icc_get_metadata_item (icc1, CD_PROFILE_METADATA_STANDARD_SPACE),
+			 ==, "srgb");
+
+	/* no generator for this one */
+	icc3 = cd_icc_get_standard_space (CD_STANDARD_SPACE_PROPHOTO_RGB, &error);
+	g_assert_error (error, CD_ICC_ERROR, CD_ICC_ERROR_FAILED_TO_CREATE);
+	g_assert (icc3 == NULL);
+}
+
 /* 1. create a valid profile with metadata and model and save it
  * 2. open profile, delete meta and dscm tags, and resave
  * 3. open profile and verify meta and dscm information is not present */
@@ -1668,6 +2302,48 @@ colord_icc_corrupt_dict_func (void)
 	g_object_unref (icc);
 }
 
+static void
+colord_icc_cache_func (void)
+{
+	gboolean ret;
+	g_autofree gchar *filename = NULL;
+	g_autoptr(CdIcc) icc = NULL;
+	g_autoptr(CdIcc) icc2 = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GFile) cache = NULL;
+	g_autoptr(GFile) file = NULL;
+
+	/* load a profile and save its sidecar cache */
+	icc = cd_icc_new ();
+	filename = cd_test_get_filename ("ibm-t61.icc");
+	file = g_file_new_for_path (filename);
+	ret = cd_icc_load_file (icc, file,
+				CD_ICC_LOAD_FLAGS_METADATA |
+				CD_ICC_LOAD_FLAGS_FALLBACK_MD5 |
+				CD_ICC_LOAD_FLAGS_PRIMARIES,
+				NULL, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	cache = g_file_new_for_path ("/tmp/colord-test.cache");
+	ret = cd_icc_save_cache (icc, cache, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+
+	/* hydrate a new object from the cache without going through lcms2 */
+	icc2 = cd_icc_new ();
+	ret = cd_icc_load_cache (icc2, cache, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	g_assert_cmpstr (cd_icc_get_filename (icc2), ==, filename);
+	g_assert_cmpint (cd_icc_get_kind (icc2), ==, cd_icc_get_kind (icc));
+	g_assert_cmpint (cd_icc_get_colorspace (icc2), ==, cd_icc_get_colorspace (icc));
+	g_assert_cmpstr (cd_icc_get_checksum (icc2), ==, cd_icc_get_checksum (icc));
+	g_assert_cmpstr (cd_icc_get_description (icc2, NULL, NULL), ==,
+			 cd_icc_get_description (icc, NULL, NULL));
+	g_assert_cmpstr (cd_icc_get_metadata_item (icc2, "EDID_md5"), ==,
+			 cd_icc_get_metadata_item (icc, "EDID_md5"));
+}
+
 static void
 colord_icc_save_func (void)
 {
@@ -1940,6 +2616,193 @@ colord_transform_func (void)
 	g_object_unref (transform);
 }
 
+static void
+colord_icc_peek_func (void)
+{
+	CdIccPeek peek;
+	gboolean ret;
+	gsize len = 0;
+	g_autofree gchar *data = NULL;
+	g_autofree gchar *filename = NULL;
+	g_autoptr(CdIcc) icc = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GFile) file = NULL;
+
+	filename = cd_test_get_filename ("ibm-t61.icc");
+	ret = g_file_get_contents (filename, &data, &len, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+
+	/* peek has to agree with a full lcms2 parse */
+	ret = cd_icc_peek_data ((const guint8 *) data, len, &peek, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	file = g_file_new_for_path (filename);
+	icc = cd_icc_new ();
+	ret = cd_icc_load_file (icc, file, CD_ICC_LOAD_FLAGS_NONE, NULL, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	g_assert_cmpint (peek.kind, ==, cd_icc_get_kind (icc));
+	g_assert_cmpint (peek.colorspace, ==, cd_icc_get_colorspace (icc));
+	g_assert_cmpfloat (ABS (peek.version - cd_icc_get_version (icc)), <, 0.01);
+	g_assert_cmpstr (peek.description, ==, cd_icc_get_description (icc, NULL, NULL));
+	cd_icc_peek_clear (&peek);
+
+	/* truncated data has to fail cleanly */
+	ret = cd_icc_peek_data ((const guint8 *) data, 0x50, &peek, &error);
+	g_assert_error (error, CD_ICC_ERROR, CD_ICC_ERROR_FAILED_TO_PARSE);
+	g_assert (!ret);
+}
+
+static void
+colord_transform_identity_func (void)
+{
+	gboolean ret;
+	guint8 data_in[6] = { 127, 32, 64, 3, 200, 255 };
+	guint8 data_out[6] = { 0, 0, 0, 0, 0, 0 };
+	g_autoptr(CdTransform) transform = NULL;
+	g_autoptr(GError) error = NULL;
+
+	/* no profile on either end means sRGB to sRGB, which has to
+	 * leave the pixels untouched */
+	transform = cd_transform_new ();
+	cd_transform_set_rendering_intent (transform, CD_RENDERING_INTENT_PERCEPTUAL);
+	cd_transform_set_input_pixel_format (transform, CD_PIXEL_FORMAT_RGB24);
+	cd_transform_set_output_pixel_format (transform, CD_PIXEL_FORMAT_RGB24);
+	ret = cd_transform_process (transform,
+				    data_in, data_out,
+				    2, 1, 2,
+				    NULL, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	g_assert_cmpint (memcmp (data_in, data_out, sizeof (data_in)), ==, 0);
+}
+
+static void
+colord_transform_stream_func (void)
+{
+	CdTransform *transform;
+	const guint height = 200;
+	const guint width = 64;
+	gboolean ret;
+	g_autofree guint8 *img_data_check = NULL;
+	g_autofree guint8 *img_data_in = NULL;
+	g_autofree guint8 *img_data_out = NULL;
+	g_autoptr(GError) error = NULL;
+	guint i;
+
+	/* setup sRGB -> sRGB transform with 8 bit RGB */
+	transform = cd_transform_new ();
+	cd_transform_set_rendering_intent (transform, CD_RENDERING_INTENT_PERCEPTUAL);
+	cd_transform_set_input_pixel_format (transform, CD_PIXEL_FORMAT_RGB24);
+	cd_transform_set_output_pixel_format (transform, CD_PIXEL_FORMAT_RGB24);
+	cd_transform_set_max_threads (transform, 1);
+
+	/* get a known-correct whole-image result */
+	img_data_in = g_new0 (guint8, height * width * 3);
+	img_data_out = g_new0 (guint8, height * width * 3);
+	img_data_check = g_new0 (guint8, height * width * 3);
+	for (i = 0; i < height * width * 3; i++)
+		img_data_in[i] = i % 0xff;
+	ret = cd_transform_process (transform,
+				    img_data_in,
+				    img_data_check,
+				    width,
+				    height,
+				    width,
+				    NULL,
+				    &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+
+	/* feeding a few scanlines at a time has to agree exactly */
+	ret = cd_transform_process_feed (transform, img_data_in, img_data_out, 1, &error);
+	g_assert_error (error, CD_TRANSFORM_ERROR, CD_TRANSFORM_ERROR_FAILED_TO_SETUP_TRANSFORM);
+	g_assert (!ret);
+	g_clear_error (&error);
+	ret = cd_transform_process_begin (transform, width, width, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	for (i = 0; i < height; i += 7) {
+		guint rows = MIN (7, height - i);
+		ret = cd_transform_process_feed (transform,
+						 img_data_in + i * width * 3,
+						 img_data_out + i * width * 3,
+						 rows,
+						 &error);
+		g_assert_no_error (error);
+		g_assert (ret);
+	}
+	ret = cd_transform_process_end (transform, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	g_assert_cmpint (memcmp (img_data_out,
+				 img_data_check,
+				 height * width * 3), ==, 0);
+
+	/* converting in-place has to give the same answer */
+	ret = cd_transform_process (transform,
+				    img_data_in,
+				    img_data_in,
+				    width,
+				    height,
+				    width,
+				    NULL,
+				    &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	g_assert_cmpint (memcmp (img_data_in,
+				 img_data_check,
+				 height * width * 3), ==, 0);
+
+	g_object_unref (transform);
+}
+
+static void
+colord_transform_lut_func (void)
+{
+	CdTransform *transform;
+	gboolean ret;
+	g_autoptr(GError) error = NULL;
+	guint8 data_in[3] = { 127, 32, 64 };
+	guint8 data_check[3];
+	guint8 data_out[3];
+	guint i;
+
+	/* setup sRGB -> sRGB transform with 8 bit RGB */
+	transform = cd_transform_new ();
+	cd_transform_set_rendering_intent (transform, CD_RENDERING_INTENT_PERCEPTUAL);
+	cd_transform_set_input_pixel_format (transform, CD_PIXEL_FORMAT_RGB24);
+	cd_transform_set_output_pixel_format (transform, CD_PIXEL_FORMAT_RGB24);
+
+	/* get the lcms2 result */
+	g_assert (!cd_transform_get_lut_enabled (transform));
+	ret = cd_transform_process (transform,
+				    data_in,
+				    data_check,
+				    1, 1, 1,
+				    NULL,
+				    &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+
+	/* the lookup table has to agree to within interpolation error */
+	cd_transform_set_lut_enabled (transform, TRUE);
+	g_assert (cd_transform_get_lut_enabled (transform));
+	ret = cd_transform_process (transform,
+				    data_in,
+				    data_out,
+				    1, 1, 1,
+				    NULL,
+				    &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	for (i = 0; i < 3; i++)
+		g_assert_cmpint (ABS ((gint) data_out[i] - (gint) data_check[i]), <=, 2);
+
+	g_object_unref (transform);
+}
+
 #include <glib/gstdio.h>
 
 static void
@@ -2109,6 +2972,95 @@ colord_icc_store_func (void)
 	g_object_unref (store);
 }
 
+static void
+colord_icc_store_async_added_cb (CdIccStore *store, CdIcc *icc, guint *cnt)
+{
+	g_debug ("Got ::added(%s)", cd_icc_get_checksum (icc));
+	(*cnt)++;
+}
+
+static void
+colord_icc_store_search_location_cb (GObject *source_object,
+				     GAsyncResult *res,
+				     gpointer user_data)
+{
+	gboolean *ret = (gboolean *) user_data;
+	g_autoptr(GError) error = NULL;
+	*ret = cd_icc_store_search_location_finish (CD_ICC_STORE (source_object),
+						    res, &error);
+	g_assert_no_error (error);
+	cd_test_loop_quit ();
+}
+
+static void
+colord_icc_store_async_func (void)
+{
+	gboolean ret = FALSE;
+	gchar *file1;
+	gchar *file2;
+	gchar *filename1;
+	gchar *filename2;
+	gchar *root;
+	gchar *subdir;
+	gint rc;
+	guint added = 0;
+	CdIccStore *store;
+	GPtrArray *array;
+
+	store = cd_icc_store_new ();
+	g_signal_connect (store, "added",
+			  G_CALLBACK (colord_icc_store_async_added_cb),
+			  &added);
+	cd_icc_store_set_load_flags (store, CD_ICC_LOAD_FLAGS_NONE);
+
+	filename1 = cd_test_get_filename ("ibm-t61.icc");
+	g_assert (filename1 != NULL);
+	filename2 = cd_test_get_filename ("crayons.icc");
+	g_assert (filename2 != NULL);
+
+	/* create test directory with a subdirectory */
+	root = g_strdup_printf ("/tmp/colord-%c%c%c%c",
+				g_random_int_range ('a', 'z'),
+				g_random_int_range ('a', 'z'),
+				g_random_int_range ('a', 'z'),
+				g_random_int_range ('a', 'z'));
+	subdir = g_build_filename (root, "sub", NULL);
+	rc = g_mkdir_with_parents (subdir, 0777);
+	g_assert (rc == 0);
+	file1 = g_build_filename (root, "ibm-t61.icc", NULL);
+	_copy_files (filename1, file1);
+	file2 = g_build_filename (subdir, "crayons.icc", NULL);
+	_copy_files (filename2, file2);
+
+	/* scan, and wait for the completion callback */
+	cd_icc_store_search_location_async (store, root,
+					    CD_ICC_STORE_SEARCH_FLAGS_NONE,
+					    NULL,
+					    colord_icc_store_search_location_cb,
+					    &ret);
+	cd_test_loop_run_with_timeout (5000);
+	g_assert (ret);
+	g_assert_cmpint (added, ==, 2);
+
+	/* check store size */
+	array = cd_icc_store_get_all (store);
+	g_assert_cmpint (array->len, ==, 2);
+	g_ptr_array_unref (array);
+
+	g_unlink (file1);
+	g_unlink (file2);
+	g_remove (subdir);
+	g_remove (root);
+
+	g_free (file1);
+	g_free (file2);
+	g_free (filename1);
+	g_free (filename2);
+	g_free (subdir);
+	g_free (root);
+	g_object_unref (store);
+}
+
 static void
 colord_icc_util_func (void)
 {
@@ -2230,6 +3182,26 @@ colord_edid_func (void)
 	g_assert_cmpfloat (cd_edid_get_gamma (edid), <, 2.2f + 0.01);
 	g_free (data);
 
+	/* re-parse the LG panel, which is now answered from the parse cache */
+	filename = cd_test_get_filename ("LG-L225W-External.bin");
+	g_assert (filename != NULL);
+	ret = g_file_get_contents (filename, &data, &length, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	data_edid = g_bytes_new (data, length);
+	ret = cd_edid_parse (edid, data_edid, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	g_free (filename);
+	g_bytes_unref (data_edid);
+	g_assert_cmpstr (cd_edid_get_monitor_name (edid), ==, "L225W");
+	g_assert_cmpstr (cd_edid_get_serial_number (edid), ==, "34398");
+	g_assert_cmpstr (cd_edid_get_checksum (edid), ==, "0bb44865bb29984a4bae620656c31368");
+	g_assert_cmpstr (cd_edid_get_pnp_id (edid), ==, "GSM");
+	g_assert_cmpint (cd_edid_get_height (edid), ==, 30);
+	g_assert_cmpint (cd_edid_get_width (edid), ==, 47);
+	g_free (data);
+
 	g_object_unref (edid);
 }
 
@@ -2237,7 +3209,9 @@ static void
 colord_icc_tags_func (void)
 {
 	CdIcc *icc;
+	CdIccTagEntry *entry;
 	g_autoptr(GError) error = NULL;
+	GArray *table;
 	GFile *file;
 	gboolean ret;
 	gchar **tags;
@@ -2267,6 +3241,16 @@ colord_icc_tags_func (void)
 	g_assert_cmpstr (tags[1], ==, "cprt");
 	g_strfreev (tags);
 
+	/* check the raw on-disk tag table */
+	table = cd_icc_get_tag_table (icc, &error);
+	g_assert_no_error (error);
+	g_assert (table != NULL);
+	g_assert_cmpint (table->len, ==, 11);
+	entry = &g_array_index (table, CdIccTagEntry, 0);
+	g_assert_cmpstr (entry->signature, ==, "desc");
+	g_assert_cmpint (entry->size, ==, 98);
+	g_array_unref (table);
+
 	/* get raw tag data */
 	data = cd_icc_get_tag_data (icc, "xxxx", &error);
 	g_assert_error (error, CD_ICC_ERROR, CD_ICC_ERROR_NO_DATA);
@@ -2287,6 +3271,12 @@ colord_icc_tags_func (void)
 	g_assert_no_error (error);
 	g_bytes_unref (data);
 
+	/* the raw table no longer matches the profile after a write */
+	table = cd_icc_get_tag_table (icc, &error);
+	g_assert_error (error, CD_ICC_ERROR, CD_ICC_ERROR_NO_DATA);
+	g_assert (table == NULL);
+	g_clear_error (&error);
+
 	/* re-get raw tag data */
 	data = cd_icc_get_tag_data (icc, "desc", &error);
 	g_assert (data != NULL);
@@ -2354,17 +3344,26 @@ main (int argc, char **argv)
 	g_test_init (&argc, &argv, NULL);
 	g_setenv ("G_MESSAGES_DEBUG", "all", TRUE);
 
+	/* latch the perf counters on before anything touches them */
+	g_setenv ("COLORD_PERF_STATS", "1", TRUE);
+
 	/* only critical and error are fatal */
 	g_log_set_fatal_mask (NULL, G_LOG_LEVEL_ERROR | G_LOG_LEVEL_CRITICAL);
 
 	/* tests go here */
 	g_test_add_func ("/colord/spectrum", colord_spectrum_func);
 	g_test_add_func ("/colord/spectrum{planckian}", colord_spectrum_planckian_func);
+	g_test_add_func ("/colord/spectrum{standard}", colord_spectrum_standard_func);
 	g_test_add_func ("/colord/spectrum{subtract}", colord_spectrum_subtract_func);
 	g_test_add_func ("/colord/spectrum{cx}", colord_spect_cx_func);
 	g_test_add_func ("/colord/edid", colord_edid_func);
 	g_test_add_func ("/colord/transform", colord_transform_func);
+	g_test_add_func ("/colord/transform{lut}", colord_transform_lut_func);
+	g_test_add_func ("/colord/transform{stream}", colord_transform_stream_func);
+	g_test_add_func ("/colord/transform{identity}", colord_transform_identity_func);
 	g_test_add_func ("/colord/icc", colord_icc_func);
+	g_test_add_func ("/colord/icc{peek}", colord_icc_peek_func);
+	g_test_add_func ("/colord/icc{cache}", colord_icc_cache_func);
 	g_test_add_func ("/colord/icc{util}", colord_icc_util_func);
 	g_test_add_func ("/colord/icc{localized}", colord_icc_localized_func);
 	g_test_add_func ("/colord/icc{edid}", colord_icc_edid_func);
@@ -2373,19 +3372,33 @@ main (int argc, char **argv)
 	g_test_add_func ("/colord/icc{empty}", colord_icc_empty_func);
 	g_test_add_func ("/colord/icc{corrupt-dict}", colord_icc_corrupt_dict_func);
 	g_test_add_func ("/colord/icc{clear}", colord_icc_clear_func);
+	g_test_add_func ("/colord/icc{standard-space}", colord_icc_standard_space_func);
 	g_test_add_func ("/colord/icc{tags}", colord_icc_tags_func);
 	g_test_add_func ("/colord/icc-store", colord_icc_store_func);
+	g_test_add_func ("/colord/icc-store{async}", colord_icc_store_async_func);
 	g_test_add_func ("/colord/buffer", colord_buffer_func);
+	g_test_add_func ("/colord/buffer{array}", colord_buffer_array_func);
+	g_test_add_func ("/colord/buffer{hash}", colord_buffer_hash_func);
+	g_test_add_func ("/colord/perf-stats", colord_perf_stats_func);
 	g_test_add_func ("/colord/enum", colord_enum_func);
 	g_test_add_func ("/colord/dom", colord_dom_func);
+	g_test_add_func ("/colord/dom{stream}", colord_dom_stream_func);
 	g_test_add_func ("/colord/dom{color}", colord_dom_color_func);
 	g_test_add_func ("/colord/dom{localized}", colord_dom_localized_func);
+	g_test_add_func ("/colord/dom{double-array}", colord_dom_double_array_func);
 	g_test_add_func ("/colord/interp{linear}", colord_interp_linear_func);
 	g_test_add_func ("/colord/interp{akima}", colord_interp_akima_func);
+	g_test_add_func ("/colord/interp{eval-array}", colord_interp_eval_array_func);
 	g_test_add_func ("/colord/color", colord_color_func);
+	g_test_add_func ("/colord/color{array}", colord_color_array_func);
+	g_test_add_func ("/colord/color{packed}", colord_color_packed_func);
+	g_test_add_func ("/colord/color{delta-e}", colord_color_delta_e_func);
 	g_test_add_func ("/colord/color{interpolate}", colord_color_interpolate_func);
+	g_test_add_func ("/colord/color{interpolate-packed}", colord_color_interpolate_packed_func);
 	g_test_add_func ("/colord/color{blackbody}", colord_color_blackbody_func);
+	g_test_add_func ("/colord/color{cct}", colord_color_cct_func);
 	g_test_add_func ("/colord/math", cd_test_math_func);
+	g_test_add_func ("/colord/math{solve}", cd_test_math_solve_func);
 	g_test_add_func ("/colord/it8{raw}", colord_it8_raw_func);
 	g_test_add_func ("/colord/it8{gamma}", colord_it8_gamma_func);
 	g_test_add_func ("/colord/it8{locale}", colord_it8_locale_func);
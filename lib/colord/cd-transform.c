@@ -34,8 +34,10 @@
 
 #include <glib.h>
 #include <lcms2.h>
+#include <string.h>
 
 #include "cd-context-lcms.h"
+#include "cd-perf-stats.h"
 #include "cd-transform.h"
 
 static void	cd_transform_class_init		(CdTransformClass	*klass);
@@ -58,9 +60,23 @@ typedef struct
 	CdPixelFormat		 output_pixel_format;
 	CdRenderingIntent	 rendering_intent;
 	cmsContext		 context_lcms;
-	cmsHPROFILE		 srgb;
+	CdIcc			*srgb_icc;
 	cmsHTRANSFORM		 lcms_transform;
 	gboolean		 bpc;
+	gboolean		 lut_enabled;
+	gboolean		 identity;
+	gfloat			*lut_data;
+	GPtrArray		*cache;
+	gpointer		 cache_key;
+	GThreadPool		*pool;
+	guint			 pool_size;
+	gboolean		 stream_active;
+	guint			 stream_width;
+	guint			 stream_rowstride;
+	GMutex			 async_mutex;
+	GQueue			 async_queue;
+	guint			 async_running;
+	guint			 queue_depth;
 	guint			 max_threads;
 	guint			 bpp_input;
 	guint			 bpp_output;
@@ -96,13 +112,79 @@ cd_transform_error_quark (void)
 	return quark;
 }
 
+/* old transforms are kept around so flipping between a handful of
+ * configurations does not rebuild the lcms2 transform every time */
+#define CD_TRANSFORM_CACHE_SIZE		8
+
+typedef struct {
+	CdIcc			*input_icc;
+	CdIcc			*output_icc;
+	CdIcc			*abstract_icc;
+	CdPixelFormat		 input_pixel_format;
+	CdPixelFormat		 output_pixel_format;
+	CdRenderingIntent	 rendering_intent;
+	gboolean		 bpc;
+	cmsHTRANSFORM		 lcms_transform;
+	gfloat			*lut_data;
+} CdTransformCacheItem;
+
+static void
+cd_transform_cache_item_free (CdTransformCacheItem *item)
+{
+	if (item->input_icc != NULL)
+		g_object_unref (item->input_icc);
+	if (item->output_icc != NULL)
+		g_object_unref (item->output_icc);
+	if (item->abstract_icc != NULL)
+		g_object_unref (item->abstract_icc);
+	if (item->lcms_transform != NULL)
+		cmsDeleteTransform (item->lcms_transform);
+	g_free (item->lut_data);
+	g_slice_free (CdTransformCacheItem, item);
+}
+
+static gboolean
+cd_transform_cache_item_matches (CdTransformCacheItem *item,
+				 CdTransformPrivate *priv)
+{
+	return item->input_icc == priv->input_icc &&
+	       item->output_icc == priv->output_icc &&
+	       item->abstract_icc == priv->abstract_icc &&
+	       item->input_pixel_format == priv->input_pixel_format &&
+	       item->output_pixel_format == priv->output_pixel_format &&
+	       item->rendering_intent == priv->rendering_intent &&
+	       item->bpc == priv->bpc;
+}
+
 static void
 cd_transform_invalidate (CdTransform *transform)
 {
 	CdTransformPrivate *priv = GET_PRIVATE (transform);
+	CdTransformCacheItem *item = priv->cache_key;
+
+	priv->identity = FALSE;
+
+	/* stash the built transform in the cache, oldest first */
+	if (priv->lcms_transform != NULL && item != NULL) {
+		item->lcms_transform = priv->lcms_transform;
+		item->lut_data = priv->lut_data;
+		priv->lcms_transform = NULL;
+		priv->lut_data = NULL;
+		priv->cache_key = NULL;
+		g_ptr_array_add (priv->cache, item);
+		while (priv->cache->len > CD_TRANSFORM_CACHE_SIZE)
+			g_ptr_array_remove_index (priv->cache, 0);
+		return;
+	}
+
+	if (item != NULL) {
+		cd_transform_cache_item_free (item);
+		priv->cache_key = NULL;
+	}
 	if (priv->lcms_transform != NULL)
 		cmsDeleteTransform (priv->lcms_transform);
 	priv->lcms_transform = NULL;
+	g_clear_pointer (&priv->lut_data, g_free);
 }
 
 /**
@@ -399,6 +481,50 @@ cd_transform_get_bpc (CdTransform *transform)
 	return priv->bpc;
 }
 
+/**
+ * cd_transform_set_lut_enabled:
+ * @transform: a #CdTransform instance.
+ * @lut_enabled: use a 3D lookup table for the conversion
+ *
+ * Sets if the transform should be baked into a 3D lookup table and evaluated
+ * with vectorized trilinear interpolation rather than calling into lcms2 for
+ * every pixel.
+ *
+ * This is much faster for large images at the cost of a small amount of
+ * accuracy, and is only used for the simple RGB pixel formats where the input
+ * and output formats match. Other formats silently fall back to lcms2.
+ *
+ * Since: 1.4.6
+ **/
+void
+cd_transform_set_lut_enabled (CdTransform *transform, gboolean lut_enabled)
+{
+	CdTransformPrivate *priv = GET_PRIVATE (transform);
+
+	g_return_if_fail (CD_IS_TRANSFORM (transform));
+
+	priv->lut_enabled = lut_enabled;
+	cd_transform_invalidate (transform);
+}
+
+/**
+ * cd_transform_get_lut_enabled:
+ * @transform: a #CdTransform instance.
+ *
+ * Gets if a 3D lookup table should be used for the conversion.
+ *
+ * Return value: %TRUE if a lookup table is used where possible.
+ *
+ * Since: 1.4.6
+ **/
+gboolean
+cd_transform_get_lut_enabled (CdTransform *transform)
+{
+	CdTransformPrivate *priv = GET_PRIVATE (transform);
+	g_return_val_if_fail (CD_IS_TRANSFORM (transform), FALSE);
+	return priv->lut_enabled;
+}
+
 /**
  * cd_transform_set_max_threads:
  * @transform: a #CdTransform instance.
@@ -457,12 +583,213 @@ cd_transform_get_bpp (CdPixelFormat format)
 	case CD_PIXEL_FORMAT_BGRA32:
 	case CD_PIXEL_FORMAT_RGBA32:
 		return 4;
+	case CD_PIXEL_FORMAT_RGBA64:
+	case CD_PIXEL_FORMAT_RGBA_F16:
+		return 8;
 	case CD_PIXEL_FORMAT_UNKNOWN:
 	default:
 		return 0;
 	}
 }
 
+/* tuned so the table fits into L2 with room to spare */
+#define CD_TRANSFORM_LUT_POINTS		33
+
+static gboolean
+cd_transform_lut_get_offsets (CdPixelFormat format,
+			      guint *offset_r,
+			      guint *offset_g,
+			      guint *offset_b)
+{
+	switch (format) {
+	case CD_PIXEL_FORMAT_RGB24:
+	case CD_PIXEL_FORMAT_RGBA32:
+		*offset_r = 0;
+		*offset_g = 1;
+		*offset_b = 2;
+		return TRUE;
+	case CD_PIXEL_FORMAT_ARGB32:
+		*offset_r = 1;
+		*offset_g = 2;
+		*offset_b = 3;
+		return TRUE;
+	case CD_PIXEL_FORMAT_BGRA32:
+		*offset_r = 2;
+		*offset_g = 1;
+		*offset_b = 0;
+		return TRUE;
+	default:
+		return FALSE;
+	}
+}
+
+static gboolean
+cd_transform_lut_is_supported (CdTransformPrivate *priv)
+{
+	guint tmp;
+
+	/* the lookup table maps RGB to RGB in the same layout */
+	if (priv->input_pixel_format != priv->output_pixel_format)
+		return FALSE;
+	return cd_transform_lut_get_offsets (priv->input_pixel_format,
+					     &tmp, &tmp, &tmp);
+}
+
+static void
+cd_transform_lut_build (CdTransform *transform)
+{
+	CdTransformPrivate *priv = GET_PRIVATE (transform);
+	const guint points = CD_TRANSFORM_LUT_POINTS;
+	guint offset_r = 0;
+	guint offset_g = 0;
+	guint offset_b = 0;
+	guint r, g, b;
+	guint i;
+	guint8 *p;
+	g_autofree guint8 *pixels_in = NULL;
+	g_autofree guint8 *pixels_out = NULL;
+
+	cd_transform_lut_get_offsets (priv->input_pixel_format,
+				      &offset_r, &offset_g, &offset_b);
+
+	/* sample the device grid through the real lcms2 transform */
+	pixels_in = g_new0 (guint8, points * points * points * priv->bpp_input);
+	p = pixels_in;
+	for (r = 0; r < points; r++) {
+		for (g = 0; g < points; g++) {
+			for (b = 0; b < points; b++) {
+				p[offset_r] = (r * 0xff) / (points - 1);
+				p[offset_g] = (g * 0xff) / (points - 1);
+				p[offset_b] = (b * 0xff) / (points - 1);
+				p += priv->bpp_input;
+			}
+		}
+	}
+	pixels_out = g_new0 (guint8, points * points * points * priv->bpp_output);
+	cmsDoTransform (priv->lcms_transform,
+			pixels_in,
+			pixels_out,
+			points * points * points);
+
+	/* keep as float so interpolation needs no widening in the hot loop */
+	priv->lut_data = g_new0 (gfloat, points * points * points * 3);
+	p = pixels_out;
+	for (i = 0; i < points * points * points; i++) {
+		priv->lut_data[i * 3 + 0] = p[offset_r];
+		priv->lut_data[i * 3 + 1] = p[offset_g];
+		priv->lut_data[i * 3 + 2] = p[offset_b];
+		p += priv->bpp_output;
+	}
+}
+
+/* let the compiler build SSE4/AVX2 versions and pick one at runtime;
+ * on aarch64 the default version already uses NEON */
+#ifdef HAVE_TARGET_CLONES
+__attribute__((target_clones("avx2","sse4.2","default")))
+#endif
+static void
+cd_transform_lut_process_rows (CdTransformPrivate *priv,
+			       guint8 *p_in,
+			       guint8 *p_out,
+			       guint width,
+			       guint height,
+			       guint rowstride)
+{
+	const gfloat *lut = priv->lut_data;
+	const gfloat scale = (gfloat) (CD_TRANSFORM_LUT_POINTS - 1) / 255.f;
+	const guint points = CD_TRANSFORM_LUT_POINTS;
+	guint offset_r = 0;
+	guint offset_g = 0;
+	guint offset_b = 0;
+	guint x, y, i;
+
+	cd_transform_lut_get_offsets (priv->input_pixel_format,
+				      &offset_r, &offset_g, &offset_b);
+	for (y = 0; y < height; y++) {
+		const guint8 *pi = p_in;
+		guint8 *po = p_out;
+		for (x = 0; x < width; x++) {
+			gfloat r = pi[offset_r] * scale;
+			gfloat g = pi[offset_g] * scale;
+			gfloat b = pi[offset_b] * scale;
+			guint ri = MIN ((guint) r, points - 2);
+			guint gi = MIN ((guint) g, points - 2);
+			guint bi = MIN ((guint) b, points - 2);
+			gfloat fr = r - ri;
+			gfloat fg = g - gi;
+			gfloat fb = b - bi;
+			const gfloat *c00 = lut + (((ri * points) + gi) * points + bi) * 3;
+			const gfloat *c01 = c00 + points * 3;
+			const gfloat *c10 = c00 + points * points * 3;
+			const gfloat *c11 = c10 + points * 3;
+			gfloat out[3];
+
+			/* trilinear interpolation of the 8 grid corners */
+			for (i = 0; i < 3; i++) {
+				gfloat v00 = c00[i] + (c00[i + 3] - c00[i]) * fb;
+				gfloat v01 = c01[i] + (c01[i + 3] - c01[i]) * fb;
+				gfloat v10 = c10[i] + (c10[i + 3] - c10[i]) * fb;
+				gfloat v11 = c11[i] + (c11[i + 3] - c11[i]) * fb;
+				gfloat v0 = v00 + (v01 - v00) * fg;
+				gfloat v1 = v10 + (v11 - v10) * fg;
+				out[i] = v0 + (v1 - v0) * fr;
+			}
+
+			/* preserve any alpha or padding bytes */
+			for (i = 0; i < priv->bpp_output; i++)
+				po[i] = pi[i];
+			po[offset_r] = (guint8) (MIN (out[0], 255.f) + 0.5f);
+			po[offset_g] = (guint8) (MIN (out[1], 255.f) + 0.5f);
+			po[offset_b] = (guint8) (MIN (out[2], 255.f) + 0.5f);
+			pi += priv->bpp_input;
+			po += priv->bpp_output;
+		}
+		p_in += rowstride * priv->bpp_input;
+		p_out += rowstride * priv->bpp_output;
+	}
+}
+
+static void
+cd_transform_process_rows (CdTransform *transform,
+			   guint8 *p_in,
+			   guint8 *p_out,
+			   guint width,
+			   guint height,
+			   guint rowstride)
+{
+	CdTransformPrivate *priv = GET_PRIVATE (transform);
+	guint i;
+
+	/* identity setup: the pixels do not change at all */
+	if (priv->identity) {
+		if (p_in != p_out) {
+			for (i = 0; i < height; i++) {
+				memcpy (p_out, p_in,
+					(gsize) width * priv->bpp_input);
+				p_in += rowstride * priv->bpp_input;
+				p_out += rowstride * priv->bpp_output;
+			}
+		}
+		return;
+	}
+
+	/* use the baked lookup table where we have one */
+	if (priv->lut_data != NULL) {
+		cd_transform_lut_process_rows (priv, p_in, p_out,
+					       width, height, rowstride);
+		return;
+	}
+	for (i = 0; i < height; i++) {
+		cmsDoTransformStride (priv->lcms_transform,
+				      p_in,
+				      p_out,
+				      width,
+				      rowstride);
+		p_in += rowstride * priv->bpp_input;
+		p_out += rowstride * priv->bpp_output;
+	}
+}
+
 static gboolean
 cd_transform_setup (CdTransform *transform, GError **error)
 {
@@ -484,6 +811,64 @@ cd_transform_setup (CdTransform *transform, GError **error)
 	}
 	g_assert (lcms_intent != -1);
 
+	/* the same profile on both ends with matching pixel formats and
+	 * no abstract profile would copy every pixel unchanged through
+	 * lcms; rendering intent and BPC make no difference in that
+	 * case, so short-circuit to a plain copy */
+	priv->identity = FALSE;
+	if (priv->abstract_icc == NULL &&
+	    priv->input_pixel_format == priv->output_pixel_format) {
+		if (priv->input_icc == priv->output_icc) {
+			priv->identity = TRUE;
+		} else if (priv->input_icc != NULL && priv->output_icc != NULL) {
+			const gchar *csum_in = cd_icc_get_checksum (priv->input_icc);
+			const gchar *csum_out = cd_icc_get_checksum (priv->output_icc);
+			priv->identity = csum_in != NULL && csum_out != NULL &&
+					 g_strcmp0 (csum_in, csum_out) == 0;
+		}
+	}
+	if (priv->identity) {
+		g_debug ("input and output profiles match, using no-op transform");
+		priv->bpp_input = cd_transform_get_bpp (priv->input_pixel_format);
+		priv->bpp_output = priv->bpp_input;
+		return TRUE;
+	}
+
+	/* already built this exact transform? */
+	for (i = 0; i < priv->cache->len; i++) {
+		CdTransformCacheItem *item = g_ptr_array_index (priv->cache, i);
+		if (!cd_transform_cache_item_matches (item, priv))
+			continue;
+		cd_perf_stats_add (CD_PERF_STAT_TRANSFORM_CACHE_HIT, 1);
+		priv->lcms_transform = item->lcms_transform;
+		priv->lut_data = item->lut_data;
+		item->lcms_transform = NULL;
+		item->lut_data = NULL;
+		priv->cache_key = item;
+		g_ptr_array_steal_index (priv->cache, i);
+		priv->bpp_input = cd_transform_get_bpp (priv->input_pixel_format);
+		priv->bpp_output = cd_transform_get_bpp (priv->output_pixel_format);
+		if (!priv->lut_enabled)
+			g_clear_pointer (&priv->lut_data, g_free);
+		else if (priv->lut_data == NULL &&
+			 cd_transform_lut_is_supported (priv))
+			cd_transform_lut_build (transform);
+		goto out;
+	}
+	cd_perf_stats_add (CD_PERF_STAT_TRANSFORM_CACHE_MISS, 1);
+
+	/* the fallback profile is the shared process-wide sRGB instance,
+	 * only resolved when a profile is actually missing */
+	if (priv->input_icc == NULL || priv->output_icc == NULL) {
+		if (priv->srgb_icc == NULL)
+			priv->srgb_icc = cd_icc_get_standard_space (CD_STANDARD_SPACE_SRGB,
+								    error);
+		if (priv->srgb_icc == NULL) {
+			ret = FALSE;
+			goto out;
+		}
+	}
+
 	/* get input profile */
 	if (priv->input_icc != NULL) {
 		g_debug ("using input profile of %s",
@@ -491,7 +876,7 @@ cd_transform_setup (CdTransform *transform, GError **error)
 		profile_in = cd_icc_get_handle (priv->input_icc);
 	} else {
 		g_debug ("no input profile, assume sRGB");
-		profile_in = priv->srgb;
+		profile_in = cd_icc_get_handle (priv->srgb_icc);
 	}
 
 	/* get output profile */
@@ -501,7 +886,7 @@ cd_transform_setup (CdTransform *transform, GError **error)
 		profile_out = cd_icc_get_handle (priv->output_icc);
 	} else {
 		g_debug ("no output profile, assume sRGB");
-		profile_out = priv->srgb;
+		profile_out = cd_icc_get_handle (priv->srgb_icc);
 	}
 
 	/* get flags */
@@ -533,6 +918,34 @@ cd_transform_setup (CdTransform *transform, GError **error)
 									  lcms_intent,
 									  lcms_flags);
 
+		/* pre-compose the three profile chain into a single
+		 * device-link so the per-pixel cost is the same as the
+		 * two profile path */
+		if (priv->lcms_transform != NULL) {
+			cmsHPROFILE devicelink;
+			devicelink = cmsTransform2DeviceLink (priv->lcms_transform,
+							      4.3,
+							      lcms_flags);
+			if (devicelink != NULL) {
+				cmsHTRANSFORM composed;
+				composed = cmsCreateTransformTHR (priv->context_lcms,
+								  devicelink,
+								  priv->input_pixel_format,
+								  NULL,
+								  priv->output_pixel_format,
+								  lcms_intent,
+								  lcms_flags);
+				if (composed != NULL) {
+					cmsDeleteTransform (priv->lcms_transform);
+					priv->lcms_transform = composed;
+				} else {
+					g_debug ("failed to use device-link, "
+						 "keeping multiprofile transform");
+				}
+				cmsCloseProfile (devicelink);
+			}
+		}
+
 	} else {
 		/* create basic transform */
 		priv->lcms_transform = cmsCreateTransformTHR (priv->context_lcms,
@@ -546,7 +959,7 @@ cd_transform_setup (CdTransform *transform, GError **error)
 
 	/* find the bpp value */
 	priv->bpp_input = cd_transform_get_bpp (priv->input_pixel_format);
-	priv->bpp_output = cd_transform_get_bpp (priv->input_pixel_format);
+	priv->bpp_output = cd_transform_get_bpp (priv->output_pixel_format);
 
 	/* failed? */
 	if (priv->lcms_transform == NULL) {
@@ -565,36 +978,167 @@ cd_transform_setup (CdTransform *transform, GError **error)
 				     "failed to setup transform, unspecified error");
 		goto out;
 	}
+
+	/* remember what this transform was built from so it can be cached */
+	{
+		CdTransformCacheItem *item = g_slice_new0 (CdTransformCacheItem);
+		if (priv->input_icc != NULL)
+			item->input_icc = g_object_ref (priv->input_icc);
+		if (priv->output_icc != NULL)
+			item->output_icc = g_object_ref (priv->output_icc);
+		if (priv->abstract_icc != NULL)
+			item->abstract_icc = g_object_ref (priv->abstract_icc);
+		item->input_pixel_format = priv->input_pixel_format;
+		item->output_pixel_format = priv->output_pixel_format;
+		item->rendering_intent = priv->rendering_intent;
+		item->bpc = priv->bpc;
+		priv->cache_key = item;
+	}
+
+	/* bake the transform into a 3D lookup table if requested */
+	if (priv->lut_enabled) {
+		if (cd_transform_lut_is_supported (priv)) {
+			cd_transform_lut_build (transform);
+		} else {
+			g_debug ("pixel format not supported by LUT engine, "
+				 "falling back to lcms2");
+		}
+	}
 out:
 	return ret;
 }
 
+/* small enough that a tile stays cache-resident even for 4K rowstrides,
+ * large enough that the atomic tile counter is not contended */
+#define CD_TRANSFORM_TILE_ROWS		64
+
 typedef struct {
-	guint8	*p_in;
-	guint8	*p_out;
-	guint	 width;
-	guint	 rowstride;
-	guint	 rows_to_process;
-} CdTransformJob;
+	CdTransform	*transform;
+	guint8		*p_in;
+	guint8		*p_out;
+	guint		 width;
+	guint		 height;
+	guint		 rowstride;
+	gint		 tile_counter;
+	guint		 n_tiles;
+	guint		 workers_running;
+	GMutex		 mutex;
+	GCond		 cond;
+} CdTransformTileContext;
 
 static void
 cd_transform_process_func (gpointer data, gpointer user_data)
 {
-	CdTransformJob *job = (CdTransformJob *) data;
-	CdTransform *transform = CD_TRANSFORM (user_data);
+	CdTransformTileContext *ctx = (CdTransformTileContext *) data;
+	CdTransform *transform = ctx->transform;
 	CdTransformPrivate *priv = GET_PRIVATE (transform);
+
+	/* claim tiles until none are left; a worker that hits a cheap tile
+	 * just comes back for another rather than idling at the tail */
+	while (TRUE) {
+		guint row_start;
+		guint rows;
+		gint tile = g_atomic_int_add (&ctx->tile_counter, 1);
+		if ((guint) tile >= ctx->n_tiles)
+			break;
+		row_start = (guint) tile * CD_TRANSFORM_TILE_ROWS;
+		rows = MIN (CD_TRANSFORM_TILE_ROWS, ctx->height - row_start);
+		cd_transform_process_rows (transform,
+					   ctx->p_in + (gsize) row_start *
+						ctx->rowstride * priv->bpp_input,
+					   ctx->p_out + (gsize) row_start *
+						ctx->rowstride * priv->bpp_output,
+					   ctx->width,
+					   rows,
+					   ctx->rowstride);
+	}
+
+	/* wake up the caller when the last worker is done */
+	g_mutex_lock (&ctx->mutex);
+	if (--ctx->workers_running == 0)
+		g_cond_signal (&ctx->cond);
+	g_mutex_unlock (&ctx->mutex);
+}
+
+static gboolean
+cd_transform_ensure_pool (CdTransform *transform, GError **error)
+{
+	CdTransformPrivate *priv = GET_PRIVATE (transform);
+
+	/* the pool lives as long as the transform so thread startup
+	 * is only paid once, not on every cd_transform_process() call */
+	if (priv->pool == NULL) {
+		priv->pool = g_thread_pool_new (cd_transform_process_func,
+						transform,
+						priv->max_threads,
+						TRUE,
+						error);
+		if (priv->pool == NULL)
+			return FALSE;
+		priv->pool_size = priv->max_threads;
+		return TRUE;
+	}
+	if (priv->pool_size != priv->max_threads) {
+		if (!g_thread_pool_set_max_threads (priv->pool,
+						    priv->max_threads,
+						    error))
+			return FALSE;
+		priv->pool_size = priv->max_threads;
+	}
+	return TRUE;
+}
+
+static gboolean
+cd_transform_process_tiled (CdTransform *transform,
+			    gpointer data_in,
+			    gpointer data_out,
+			    guint width,
+			    guint height,
+			    guint rowstride,
+			    GError **error)
+{
+	CdTransformPrivate *priv = GET_PRIVATE (transform);
+	CdTransformTileContext ctx;
+	gboolean ret = TRUE;
 	guint i;
+	guint workers;
 
-	for (i = 0; i < job->rows_to_process; i++) {
-		cmsDoTransformStride (priv->lcms_transform,
-				      job->p_in,
-				      job->p_out,
-				      job->width,
-				      job->rowstride);
-		job->p_in += job->rowstride;
-		job->p_out += job->rowstride;
+	/* get the persistent worker pool */
+	if (!cd_transform_ensure_pool (transform, error))
+		return FALSE;
+
+	/* all the workers share one tile counter and claim work from it */
+	ctx.transform = transform;
+	ctx.p_in = data_in;
+	ctx.p_out = data_out;
+	ctx.width = width;
+	ctx.height = height;
+	ctx.rowstride = rowstride;
+	ctx.tile_counter = 0;
+	ctx.n_tiles = (height + CD_TRANSFORM_TILE_ROWS - 1) / CD_TRANSFORM_TILE_ROWS;
+	workers = MIN (priv->max_threads, ctx.n_tiles);
+	ctx.workers_running = workers;
+	g_mutex_init (&ctx.mutex);
+	g_cond_init (&ctx.cond);
+	for (i = 0; i < workers; i++) {
+		ret = g_thread_pool_push (priv->pool, &ctx, error);
+		if (!ret) {
+			/* only wait for the workers already started */
+			g_mutex_lock (&ctx.mutex);
+			ctx.workers_running -= workers - i;
+			g_mutex_unlock (&ctx.mutex);
+			break;
+		}
 	}
-	g_slice_free (CdTransformJob, job);
+
+	/* wait for completion */
+	g_mutex_lock (&ctx.mutex);
+	while (ctx.workers_running > 0)
+		g_cond_wait (&ctx.cond, &ctx.mutex);
+	g_mutex_unlock (&ctx.mutex);
+	g_mutex_clear (&ctx.mutex);
+	g_cond_clear (&ctx.cond);
+	return ret;
 }
 
 static gboolean
@@ -630,6 +1174,8 @@ cd_transform_set_max_threads_default (CdTransform *transform, GError **error)
  * @transform: a #CdTransform instance.
  * @data_in: the data buffer to convert
  * @data_out: the data buffer to return, which can be the same as @data_in
+ *   as long as the input and output pixel formats have the same depth;
+ *   pixels are converted strictly in-order so no staging copy is needed
  * @width: the width of @data_in
  * @height: the height of @data_in
  * @rowstride: the rowstride of @data_in, typically the same as @width
@@ -654,14 +1200,8 @@ cd_transform_process (CdTransform *transform,
 		      GCancellable *cancellable,
 		      GError **error)
 {
-	CdTransformJob *job;
 	CdTransformPrivate *priv = GET_PRIVATE (transform);
 	gboolean ret = TRUE;
-	GThreadPool *pool = NULL;
-	guint8 *p_in;
-	guint8 *p_out;
-	guint i;
-	guint rows_to_process;
 
 	g_return_val_if_fail (CD_IS_TRANSFORM (transform), FALSE);
 	g_return_val_if_fail (data_in != NULL, FALSE);
@@ -697,63 +1237,407 @@ cd_transform_process (CdTransform *transform,
 	}
 
 	/* setup the transform if required */
-	if (priv->lcms_transform == NULL) {
+	if (priv->lcms_transform == NULL && !priv->identity) {
 		ret = cd_transform_setup (transform, error);
 		if (!ret)
 			goto out;
 	}
 
-	/* non-threaded conversion */
-	if (priv->max_threads == 1) {
-		p_in = data_in;
-		p_out = data_out;
-		for (i = 0; i < height; i++) {
-			cmsDoTransformStride (priv->lcms_transform,
-					      p_in,
-					      p_out,
-					      width,
-					      rowstride);
-			p_in += rowstride * priv->bpp_input;
-			p_out += rowstride * priv->bpp_output;
-		}
+	/* in-place conversion only makes sense when the pixel sizes match */
+	if (data_in == data_out && priv->bpp_input != priv->bpp_output) {
+		ret = FALSE;
+		g_set_error_literal (error,
+				     CD_TRANSFORM_ERROR,
+				     CD_TRANSFORM_ERROR_FAILED_TO_SETUP_TRANSFORM,
+				     "in-place conversion requires input and "
+				     "output formats of the same depth");
 		goto out;
 	}
 
-	/* create a threadpool for each line of the image */
-	pool = g_thread_pool_new (cd_transform_process_func,
-				  transform,
-				  priv->max_threads,
-				  TRUE,
-				  error);
-	if (pool == NULL)
+	/* non-threaded conversion */
+	if (priv->max_threads == 1) {
+		cd_transform_process_rows (transform,
+					   data_in,
+					   data_out,
+					   width,
+					   height,
+					   rowstride);
 		goto out;
-
-	/* do conversion */
-	p_in = data_in;
-	p_out = data_out;
-	rows_to_process = height / priv->max_threads;
-	for (i = 0; i < height; i += rows_to_process) {
-		job = g_slice_new (CdTransformJob);
-		job->p_in = p_in;
-		job->p_out = p_out;
-		job->width = width;
-		job->rowstride = rowstride;
-		if (i + rows_to_process > height)
-			job->rows_to_process = height - i;
-		else
-			job->rows_to_process = rows_to_process;
-		ret = g_thread_pool_push (pool, job, error);
-		if (!ret)
-			goto out;
-		p_in += rowstride * rows_to_process * priv->bpp_input;
-		p_out += rowstride * rows_to_process * priv->bpp_output;
 	}
+
+	/* hand the image over to the worker pool */
+	ret = cd_transform_process_tiled (transform,
+					  data_in,
+					  data_out,
+					  width,
+					  height,
+					  rowstride,
+					  error);
 out:
-	if (pool != NULL)
-		g_thread_pool_free (pool, FALSE, TRUE);
 	return ret;
 }
 
+typedef struct {
+	gpointer	 data_in;
+	gpointer	 data_out;
+	guint		 width;
+	guint		 height;
+	guint		 rowstride;
+} CdTransformProcessHelper;
+
+static void
+cd_transform_process_helper_free (CdTransformProcessHelper *helper)
+{
+	g_slice_free (CdTransformProcessHelper, helper);
+}
+
+static void	cd_transform_process_thread_cb	(GTask		*task,
+						 gpointer	 source_object,
+						 gpointer	 task_data,
+						 GCancellable	*cancellable);
+
+static void
+cd_transform_process_thread_cb (GTask *task,
+				gpointer source_object,
+				gpointer task_data,
+				GCancellable *cancellable)
+{
+	CdTransform *transform = CD_TRANSFORM (source_object);
+	CdTransformPrivate *priv = GET_PRIVATE (transform);
+	CdTransformProcessHelper *helper = (CdTransformProcessHelper *) task_data;
+	GTask *task_next = NULL;
+	gboolean returned = FALSE;
+	guint row;
+	GError *error = NULL;
+
+	/* process a band at a time so cancellation takes effect mid-image
+	 * rather than after the whole frame has been converted */
+	for (row = 0; row < helper->height; row += CD_TRANSFORM_TILE_ROWS) {
+		guint rows = MIN (CD_TRANSFORM_TILE_ROWS, helper->height - row);
+		guint8 *p_in = helper->data_in;
+		guint8 *p_out = helper->data_out;
+		if (g_task_return_error_if_cancelled (task)) {
+			returned = TRUE;
+			break;
+		}
+		if (row > 0) {
+			p_in += (gsize) row * helper->rowstride * priv->bpp_input;
+			p_out += (gsize) row * helper->rowstride * priv->bpp_output;
+		}
+		if (!cd_transform_process (transform,
+					   p_in,
+					   p_out,
+					   helper->width,
+					   rows,
+					   helper->rowstride,
+					   cancellable,
+					   &error)) {
+			g_task_return_error (task, error);
+			returned = TRUE;
+			break;
+		}
+	}
+	if (!returned)
+		g_task_return_boolean (task, TRUE);
+
+	/* kick off the next queued frame, if any */
+	g_mutex_lock (&priv->async_mutex);
+	priv->async_running--;
+	if (!g_queue_is_empty (&priv->async_queue)) {
+		task_next = g_queue_pop_head (&priv->async_queue);
+		priv->async_running++;
+	}
+	g_mutex_unlock (&priv->async_mutex);
+	if (task_next != NULL) {
+		g_task_run_in_thread (task_next, cd_transform_process_thread_cb);
+		g_object_unref (task_next);
+	}
+}
+
+/**
+ * cd_transform_set_queue_depth:
+ * @transform: a #CdTransform instance.
+ * @queue_depth: the number of frames converted concurrently, or 0 for no limit
+ *
+ * Sets how many cd_transform_process_async() frames may be in flight at the
+ * same time. Further frames are queued and started as earlier ones finish,
+ * which lets a caller submit frame N+1 while frame N is still converting
+ * without ever saturating the worker pool.
+ *
+ * Since: 1.4.6
+ **/
+void
+cd_transform_set_queue_depth (CdTransform *transform, guint queue_depth)
+{
+	CdTransformPrivate *priv = GET_PRIVATE (transform);
+	g_return_if_fail (CD_IS_TRANSFORM (transform));
+	priv->queue_depth = queue_depth;
+}
+
+/**
+ * cd_transform_get_queue_depth:
+ * @transform: a #CdTransform instance.
+ *
+ * Gets the maximum number of concurrent async frames.
+ *
+ * Return value: the queue depth, or 0 for no limit
+ *
+ * Since: 1.4.6
+ **/
+guint
+cd_transform_get_queue_depth (CdTransform *transform)
+{
+	CdTransformPrivate *priv = GET_PRIVATE (transform);
+	g_return_val_if_fail (CD_IS_TRANSFORM (transform), 0);
+	return priv->queue_depth;
+}
+
+/**
+ * cd_transform_process_async:
+ * @transform: a #CdTransform instance.
+ * @data_in: the data buffer to convert
+ * @data_out: the data buffer to return, which can be the same as @data_in
+ * @width: the width of @data_in
+ * @height: the height of @data_in
+ * @rowstride: the rowstride of @data_in, typically the same as @width
+ * @cancellable: a #GCancellable, or %NULL
+ * @callback: the function to run on completion
+ * @user_data: the data to pass to @callback
+ *
+ * Processes a block of data through the transform in a worker thread.
+ * Both buffers have to stay valid until @callback is run. Cancellation is
+ * checked between bands of the image, so a pending conversion stops
+ * promptly rather than after the whole frame.
+ *
+ * Since: 1.4.6
+ **/
+void
+cd_transform_process_async (CdTransform *transform,
+			    gpointer data_in,
+			    gpointer data_out,
+			    guint width,
+			    guint height,
+			    guint rowstride,
+			    GCancellable *cancellable,
+			    GAsyncReadyCallback callback,
+			    gpointer user_data)
+{
+	CdTransformPrivate *priv = GET_PRIVATE (transform);
+	CdTransformProcessHelper *helper;
+	GTask *task;
+
+	g_return_if_fail (CD_IS_TRANSFORM (transform));
+	g_return_if_fail (data_in != NULL);
+	g_return_if_fail (data_out != NULL);
+	g_return_if_fail (width != 0);
+	g_return_if_fail (height != 0);
+	g_return_if_fail (rowstride != 0);
+
+	task = g_task_new (transform, cancellable, callback, user_data);
+	helper = g_slice_new0 (CdTransformProcessHelper);
+	helper->data_in = data_in;
+	helper->data_out = data_out;
+	helper->width = width;
+	helper->height = height;
+	helper->rowstride = rowstride;
+	g_task_set_task_data (task, helper,
+			      (GDestroyNotify) cd_transform_process_helper_free);
+
+	/* either run now or queue until an in-flight frame completes */
+	g_mutex_lock (&priv->async_mutex);
+	if (priv->queue_depth > 0 && priv->async_running >= priv->queue_depth) {
+		g_queue_push_tail (&priv->async_queue, task);
+		g_mutex_unlock (&priv->async_mutex);
+		return;
+	}
+	priv->async_running++;
+	g_mutex_unlock (&priv->async_mutex);
+	g_task_run_in_thread (task, cd_transform_process_thread_cb);
+	g_object_unref (task);
+}
+
+/**
+ * cd_transform_process_finish:
+ * @transform: a #CdTransform instance.
+ * @res: the #GAsyncResult
+ * @error: A %GError, or %NULL
+ *
+ * Gets the result from the asynchronous function.
+ *
+ * Return value: %TRUE if the pixels were successfully transformed.
+ *
+ * Since: 1.4.6
+ **/
+gboolean
+cd_transform_process_finish (CdTransform *transform,
+			     GAsyncResult *res,
+			     GError **error)
+{
+	g_return_val_if_fail (CD_IS_TRANSFORM (transform), FALSE);
+	g_return_val_if_fail (g_task_is_valid (res, transform), FALSE);
+	return g_task_propagate_boolean (G_TASK (res), error);
+}
+
+/**
+ * cd_transform_process_begin:
+ * @transform: a #CdTransform instance.
+ * @width: the width of each scanline in pixels
+ * @rowstride: the rowstride of the scanlines, typically the same as @width
+ * @error: A %GError, or %NULL
+ *
+ * Starts a streaming conversion where scanlines are fed incrementally with
+ * cd_transform_process_feed() rather than buffering the whole image.
+ * This keeps peak memory usage bounded regardless of the image size.
+ *
+ * Return value: %TRUE if the transform was set up successfully.
+ *
+ * Since: 1.4.6
+ **/
+gboolean
+cd_transform_process_begin (CdTransform *transform,
+			    guint width,
+			    guint rowstride,
+			    GError **error)
+{
+	CdTransformPrivate *priv = GET_PRIVATE (transform);
+
+	g_return_val_if_fail (CD_IS_TRANSFORM (transform), FALSE);
+	g_return_val_if_fail (width != 0, FALSE);
+	g_return_val_if_fail (rowstride != 0, FALSE);
+
+	/* check stuff that should have been set */
+	if (priv->rendering_intent == CD_RENDERING_INTENT_UNKNOWN) {
+		g_set_error_literal (error,
+				     CD_TRANSFORM_ERROR,
+				     CD_TRANSFORM_ERROR_FAILED_TO_SETUP_TRANSFORM,
+				     "rendering intent not set");
+		return FALSE;
+	}
+	if (priv->input_pixel_format == CD_PIXEL_FORMAT_UNKNOWN ||
+	    priv->output_pixel_format == CD_PIXEL_FORMAT_UNKNOWN) {
+		g_set_error_literal (error,
+				     CD_TRANSFORM_ERROR,
+				     CD_TRANSFORM_ERROR_FAILED_TO_SETUP_TRANSFORM,
+				     "pixel format not set");
+		return FALSE;
+	}
+
+	/* get the best number of threads */
+	if (priv->max_threads == 0) {
+		if (!cd_transform_set_max_threads_default (transform, error))
+			return FALSE;
+	}
+
+	/* setup the transform if required */
+	if (priv->lcms_transform == NULL && !priv->identity) {
+		if (!cd_transform_setup (transform, error))
+			return FALSE;
+	}
+
+	priv->stream_active = TRUE;
+	priv->stream_width = width;
+	priv->stream_rowstride = rowstride;
+	return TRUE;
+}
+
+/**
+ * cd_transform_process_feed:
+ * @transform: a #CdTransform instance.
+ * @data_in: the scanline data to convert
+ * @data_out: the output buffer, which can be the same as @data_in
+ * @rows: the number of scanlines in @data_in
+ * @error: A %GError, or %NULL
+ *
+ * Converts a batch of scanlines as part of a streaming conversion started
+ * with cd_transform_process_begin().
+ * The batch is fully processed before this function returns, so both
+ * buffers can be reused immediately, and large batches are spread over the
+ * worker pool.
+ *
+ * Return value: %TRUE if the scanlines were successfully transformed.
+ *
+ * Since: 1.4.6
+ **/
+gboolean
+cd_transform_process_feed (CdTransform *transform,
+			   gpointer data_in,
+			   gpointer data_out,
+			   guint rows,
+			   GError **error)
+{
+	CdTransformPrivate *priv = GET_PRIVATE (transform);
+
+	g_return_val_if_fail (CD_IS_TRANSFORM (transform), FALSE);
+	g_return_val_if_fail (data_in != NULL, FALSE);
+	g_return_val_if_fail (data_out != NULL, FALSE);
+	g_return_val_if_fail (rows != 0, FALSE);
+
+	if (!priv->stream_active) {
+		g_set_error_literal (error,
+				     CD_TRANSFORM_ERROR,
+				     CD_TRANSFORM_ERROR_FAILED_TO_SETUP_TRANSFORM,
+				     "cd_transform_process_begin has not been called");
+		return FALSE;
+	}
+
+	/* in-place conversion only makes sense when the pixel sizes match */
+	if (data_in == data_out && priv->bpp_input != priv->bpp_output) {
+		g_set_error_literal (error,
+				     CD_TRANSFORM_ERROR,
+				     CD_TRANSFORM_ERROR_FAILED_TO_SETUP_TRANSFORM,
+				     "in-place conversion requires input and "
+				     "output formats of the same depth");
+		return FALSE;
+	}
+
+	/* only spread over the pool when there is enough work per thread */
+	if (priv->max_threads > 1 && rows >= CD_TRANSFORM_TILE_ROWS * 2) {
+		return cd_transform_process_tiled (transform,
+						   data_in,
+						   data_out,
+						   priv->stream_width,
+						   rows,
+						   priv->stream_rowstride,
+						   error);
+	}
+	cd_transform_process_rows (transform,
+				   data_in,
+				   data_out,
+				   priv->stream_width,
+				   rows,
+				   priv->stream_rowstride);
+	return TRUE;
+}
+
+/**
+ * cd_transform_process_end:
+ * @transform: a #CdTransform instance.
+ * @error: A %GError, or %NULL
+ *
+ * Finishes a streaming conversion started with cd_transform_process_begin().
+ *
+ * Return value: %TRUE if the conversion was finished successfully.
+ *
+ * Since: 1.4.6
+ **/
+gboolean
+cd_transform_process_end (CdTransform *transform, GError **error)
+{
+	CdTransformPrivate *priv = GET_PRIVATE (transform);
+
+	g_return_val_if_fail (CD_IS_TRANSFORM (transform), FALSE);
+
+	if (!priv->stream_active) {
+		g_set_error_literal (error,
+				     CD_TRANSFORM_ERROR,
+				     CD_TRANSFORM_ERROR_FAILED_TO_SETUP_TRANSFORM,
+				     "cd_transform_process_begin has not been called");
+		return FALSE;
+	}
+	priv->stream_active = FALSE;
+	return TRUE;
+}
+
 static void
 cd_transform_get_property (GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
 {
@@ -895,8 +1779,10 @@ cd_transform_init (CdTransform *transform)
 	priv->rendering_intent = CD_RENDERING_INTENT_UNKNOWN;
 	priv->input_pixel_format = CD_PIXEL_FORMAT_UNKNOWN;
 	priv->output_pixel_format = CD_PIXEL_FORMAT_UNKNOWN;
-	priv->srgb = cmsCreate_sRGBProfileTHR (priv->context_lcms);
 	priv->max_threads = 1;
+	priv->cache = g_ptr_array_new_with_free_func ((GDestroyNotify) cd_transform_cache_item_free);
+	g_mutex_init (&priv->async_mutex);
+	g_queue_init (&priv->async_queue);
 }
 
 static void
@@ -905,7 +1791,8 @@ cd_transform_finalize (GObject *object)
 	CdTransform *transform = CD_TRANSFORM (object);
 	CdTransformPrivate *priv = GET_PRIVATE (transform);
 
-	cmsCloseProfile (priv->srgb);
+	if (priv->srgb_icc != NULL)
+		g_object_unref (priv->srgb_icc);
 	if (priv->input_icc != NULL)
 		g_object_unref (priv->input_icc);
 	if (priv->output_icc != NULL)
@@ -914,6 +1801,14 @@ cd_transform_finalize (GObject *object)
 		g_object_unref (priv->abstract_icc);
 	if (priv->lcms_transform != NULL)
 		cmsDeleteTransform (priv->lcms_transform);
+	if (priv->pool != NULL)
+		g_thread_pool_free (priv->pool, FALSE, TRUE);
+	if (priv->cache_key != NULL)
+		cd_transform_cache_item_free (priv->cache_key);
+	g_ptr_array_unref (priv->cache);
+	g_queue_clear_full (&priv->async_queue, g_object_unref);
+	g_mutex_clear (&priv->async_mutex);
+	g_free (priv->lut_data);
 	cd_context_lcms_free (priv->context_lcms);
 
 	G_OBJECT_CLASS (cd_transform_parent_class)->finalize (object);
@@ -96,6 +96,9 @@ CdRenderingIntent cd_transform_get_rendering_intent	(CdTransform	*transform);
 void		 cd_transform_set_bpc			(CdTransform	*transform,
 							 gboolean	 bpc);
 gboolean	 cd_transform_get_bpc			(CdTransform	*transform);
+void		 cd_transform_set_lut_enabled		(CdTransform	*transform,
+							 gboolean	 lut_enabled);
+gboolean	 cd_transform_get_lut_enabled		(CdTransform	*transform);
 void		 cd_transform_set_max_threads		(CdTransform	*transform,
 							 guint		 max_threads);
 guint		 cd_transform_get_max_threads		(CdTransform	*transform);
@@ -108,6 +111,36 @@ gboolean	 cd_transform_process			(CdTransform	*transform,
 							 GCancellable	*cancellable,
 							 GError		**error)
 							 G_GNUC_WARN_UNUSED_RESULT;
+void		 cd_transform_process_async		(CdTransform	*transform,
+							 gpointer	 data_in,
+							 gpointer	 data_out,
+							 guint		 width,
+							 guint		 height,
+							 guint		 rowstride,
+							 GCancellable	*cancellable,
+							 GAsyncReadyCallback callback,
+							 gpointer	 user_data);
+gboolean	 cd_transform_process_finish		(CdTransform	*transform,
+							 GAsyncResult	*res,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
+void		 cd_transform_set_queue_depth		(CdTransform	*transform,
+							 guint		 queue_depth);
+guint		 cd_transform_get_queue_depth		(CdTransform	*transform);
+gboolean	 cd_transform_process_begin		(CdTransform	*transform,
+							 guint		 width,
+							 guint		 rowstride,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
+gboolean	 cd_transform_process_feed		(CdTransform	*transform,
+							 gpointer	 data_in,
+							 gpointer	 data_out,
+							 guint		 rows,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
+gboolean	 cd_transform_process_end		(CdTransform	*transform,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
 
 G_END_DECLS
 
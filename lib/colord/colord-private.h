@@ -48,6 +48,7 @@
 #include <colord/cd-it8.h>
 #include <colord/cd-it8-utils.h>
 #include <colord/cd-math.h>
+#include <colord/cd-perf-stats.h>
 #include <colord/cd-quirk.h>
 #include <colord/cd-spectrum.h>
 #include <colord/cd-transform.h>
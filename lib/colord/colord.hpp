@@ -0,0 +1,263 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2026 Richard Hughes <richard@hughsie.com>
+ *
+ * Licensed under the GNU Lesser General Public License Version 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+/*
+ * Header-only C++17 convenience layer over the C API.
+ *
+ * The wrappers are thin, move-only handles around the GObject types;
+ * nothing is copied at the boundary, no exceptions are thrown, and the
+ * per-pixel paths compile down to the plain C calls. Errors are
+ * captured into a colord::Error out-parameter instead of GError
+ * boilerplate at every call site.
+ */
+
+#ifndef __COLORD_HPP
+#define __COLORD_HPP
+
+#if !defined(__cplusplus) || __cplusplus < 201703L
+#error "colord.hpp requires C++17"
+#endif
+
+#include <colord.h>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace colord {
+
+/* owns at most one GError; pass the same instance to many calls and
+ * check it once, like a GError** chain in C */
+class Error {
+public:
+	Error () = default;
+	Error (const Error &) = delete;
+	Error &operator= (const Error &) = delete;
+	Error (Error &&other) noexcept
+		: error_ (std::exchange (other.error_, nullptr)) {}
+	Error &operator= (Error &&other) noexcept
+	{
+		std::swap (error_, other.error_);
+		return *this;
+	}
+	~Error () { clear (); }
+
+	/* pass where a GError** is expected; any previous error is dropped */
+	GError **out () noexcept
+	{
+		clear ();
+		return &error_;
+	}
+	explicit operator bool () const noexcept { return error_ != nullptr; }
+	std::string_view message () const noexcept
+	{
+		return error_ != nullptr ? error_->message : "";
+	}
+	void clear () noexcept
+	{
+		if (error_ != nullptr) {
+			g_error_free (error_);
+			error_ = nullptr;
+		}
+	}
+
+private:
+	GError *error_ = nullptr;
+};
+
+/* move-only owner of one GObject reference */
+template <typename T>
+class Object {
+public:
+	Object (const Object &) = delete;
+	Object &operator= (const Object &) = delete;
+	Object (Object &&other) noexcept
+		: obj_ (std::exchange (other.obj_, nullptr)) {}
+	Object &operator= (Object &&other) noexcept
+	{
+		std::swap (obj_, other.obj_);
+		return *this;
+	}
+	~Object ()
+	{
+		if (obj_ != nullptr)
+			g_object_unref (obj_);
+	}
+
+	T *get () const noexcept { return obj_; }
+	explicit operator bool () const noexcept { return obj_ != nullptr; }
+
+	/* give up ownership, e.g. to a C API that takes the reference */
+	T *release () noexcept { return std::exchange (obj_, nullptr); }
+
+protected:
+	explicit Object (T *take) noexcept : obj_ (take) {}
+	T *obj_;
+};
+
+class Icc : public Object<CdIcc> {
+public:
+	Icc () : Object (cd_icc_new ()) {}
+
+	/* takes ownership of the reference */
+	explicit Icc (CdIcc *take) noexcept : Object (take) {}
+
+	bool load_file (std::string_view filename,
+			CdIccLoadFlags flags,
+			Error &error)
+	{
+		const std::string fn (filename);
+		GFile *file = g_file_new_for_path (fn.c_str ());
+		const bool ret = cd_icc_load_file (obj_, file, flags,
+						   nullptr, error.out ());
+		g_object_unref (file);
+		return ret;
+	}
+
+	bool load_data (const void *data,
+			std::size_t len,
+			CdIccLoadFlags flags,
+			Error &error)
+	{
+		return cd_icc_load_data (obj_,
+					 static_cast<const guint8 *> (data),
+					 len, flags, error.out ());
+	}
+
+	bool create_default (Error &error)
+	{
+		return cd_icc_create_default (obj_, error.out ());
+	}
+
+	std::string_view filename () const noexcept
+	{
+		const gchar *tmp = cd_icc_get_filename (obj_);
+		return tmp != nullptr ? tmp : "";
+	}
+
+	std::string_view description () const noexcept
+	{
+		const gchar *tmp = cd_icc_get_description (obj_, nullptr, nullptr);
+		return tmp != nullptr ? tmp : "";
+	}
+
+	std::string_view metadata_item (std::string_view key) const
+	{
+		const std::string key_str (key);
+		const gchar *tmp = cd_icc_get_metadata_item (obj_,
+							     key_str.c_str ());
+		return tmp != nullptr ? tmp : "";
+	}
+
+	cmsHPROFILE handle () const noexcept
+	{
+		return cd_icc_get_handle (obj_);
+	}
+};
+
+class Transform : public Object<CdTransform> {
+public:
+	Transform () : Object (cd_transform_new ()) {}
+
+	/* takes ownership of the reference */
+	explicit Transform (CdTransform *take) noexcept : Object (take) {}
+
+	/* the CdTransform keeps its own reference to the profile */
+	void set_input (const Icc &icc, CdPixelFormat format) noexcept
+	{
+		cd_transform_set_input_icc (obj_, icc.get ());
+		cd_transform_set_input_pixel_format (obj_, format);
+	}
+	void set_output (const Icc &icc, CdPixelFormat format) noexcept
+	{
+		cd_transform_set_output_icc (obj_, icc.get ());
+		cd_transform_set_output_pixel_format (obj_, format);
+	}
+	void set_abstract (const Icc &icc) noexcept
+	{
+		cd_transform_set_abstract_icc (obj_, icc.get ());
+	}
+	void set_rendering_intent (CdRenderingIntent intent) noexcept
+	{
+		cd_transform_set_rendering_intent (obj_, intent);
+	}
+	void set_bpc (bool bpc) noexcept
+	{
+		cd_transform_set_bpc (obj_, bpc ? TRUE : FALSE);
+	}
+	void set_max_threads (unsigned int max_threads) noexcept
+	{
+		cd_transform_set_max_threads (obj_, max_threads);
+	}
+
+	/* hot path: one C call, no allocation and no exceptions */
+	bool process (const void *data_in,
+		      void *data_out,
+		      unsigned int width,
+		      unsigned int height,
+		      unsigned int rowstride,
+		      Error &error) noexcept
+	{
+		return cd_transform_process (obj_,
+					     const_cast<void *> (data_in),
+					     data_out,
+					     width, height, rowstride,
+					     nullptr, error.out ());
+	}
+};
+
+class Interp : public Object<CdInterp> {
+public:
+	static Interp akima () { return Interp (cd_interp_akima_new ()); }
+	static Interp linear () { return Interp (cd_interp_linear_new ()); }
+
+	/* takes ownership of the reference */
+	explicit Interp (CdInterp *take) noexcept : Object (take) {}
+
+	void insert (double x, double y) noexcept
+	{
+		cd_interp_insert (obj_, x, y);
+	}
+	bool prepare (Error &error)
+	{
+		return cd_interp_prepare (obj_, error.out ());
+	}
+
+	/* batch evaluation over contiguous arrays */
+	bool eval (const double *x,
+		   double *y,
+		   std::size_t len,
+		   Error &error) noexcept
+	{
+		return cd_interp_eval_array (obj_, x, y, len, error.out ());
+	}
+	template <typename In, typename Out>
+	bool eval (const In &x, Out &y, Error &error) noexcept
+	{
+		return y.size () >= x.size () &&
+		       eval (x.data (), y.data (), x.size (), error);
+	}
+};
+
+} /* namespace colord */
+
+#endif /* __COLORD_HPP */
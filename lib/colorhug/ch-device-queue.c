@@ -45,6 +45,8 @@ typedef struct
 {
 	GPtrArray		*data_array;
 	GHashTable		*devices_in_use;
+	GHashTable		*device_pending;	/* of device_id:ChDeviceQueuePendingLanes */
+	guint			 done_cnt;		/* commands complete or cancelled */
 } ChDeviceQueuePrivate;
 
 enum {
@@ -72,6 +74,8 @@ typedef struct {
 	ChDeviceQueueDataState	 state;
 	GUsbDevice		*device;
 	guint8			 cmd;
+	gboolean		 bulk_flash;	/* stream buffer_in to flash */
+	guint16			 address;	/* only valid when bulk_flash */
 	guint8			*buffer_in;
 	gsize			 buffer_in_len;
 	guint8			*buffer_out;
@@ -90,9 +94,59 @@ typedef struct {
 	GPtrArray		*failures;
 } ChDeviceQueueTaskData;
 
+/* two submission lanes per device: commands driving the sensor
+ * front-end stay strictly ordered with each other, while quick
+ * management traffic (EEPROM, flash, LEDs, strings) is dispatched
+ * ahead of queued integrations; neither queue holds references, the
+ * data array does that for us */
+typedef struct {
+	GQueue		*optical;
+	GQueue		*management;
+} ChDeviceQueuePendingLanes;
+
+static void
+ch_device_queue_pending_lanes_free (ChDeviceQueuePendingLanes *lanes)
+{
+	g_queue_free (lanes->optical);
+	g_queue_free (lanes->management);
+	g_free (lanes);
+}
+
+/* anything that configures, triggers or reads back the sensor
+ * front-end; the integration period only ever delays this lane */
+static gboolean
+ch_device_queue_cmd_is_optical (guint8 cmd)
+{
+	switch (cmd) {
+	case CH_CMD_GET_COLOR_SELECT:
+	case CH_CMD_SET_COLOR_SELECT:
+	case CH_CMD_GET_MULTIPLIER:
+	case CH_CMD_SET_MULTIPLIER:
+	case CH_CMD_GET_INTEGRAL_TIME:
+	case CH_CMD_SET_INTEGRAL_TIME:
+	case CH_CMD_GET_MEASURE_MODE:
+	case CH_CMD_SET_MEASURE_MODE:
+	case CH_CMD_GET_PRE_SCALE:
+	case CH_CMD_SET_PRE_SCALE:
+	case CH_CMD_GET_POST_SCALE:
+	case CH_CMD_SET_POST_SCALE:
+	case CH_CMD_GET_DARK_OFFSETS:
+	case CH_CMD_SET_DARK_OFFSETS:
+	case CH_CMD_TAKE_READING_RAW:
+	case CH_CMD_TAKE_READINGS:
+	case CH_CMD_TAKE_READING_XYZ:
+	case CH_CMD_TAKE_READING_SPECTRAL:
+	case CH_CMD_TAKE_READING_ARRAY:
+	case CH_CMD_READ_SRAM:	/* spectral results land in SRAM */
+		return TRUE;
+	default:
+		return FALSE;
+	}
+}
+
 static guint signals[SIGNAL_LAST] = { 0 };
 
-static gboolean ch_device_queue_process_data (GTask *task, ChDeviceQueueData *data);
+static gboolean ch_device_queue_process_next (GTask *task, GUsbDevice *device);
 
 static void
 ch_device_queue_data_free (ChDeviceQueueData *data)
@@ -119,6 +173,7 @@ ch_device_queue_device_force_complete (ChDeviceQueue *device_queue, GUsbDevice *
 {
 	ChDeviceQueuePrivate *priv = GET_PRIVATE (device_queue);
 	ChDeviceQueueData *data;
+	ChDeviceQueuePendingLanes *lanes;
 	const gchar *device_id;
 	const gchar *device_id_tmp;
 	guint i;
@@ -128,8 +183,20 @@ ch_device_queue_device_force_complete (ChDeviceQueue *device_queue, GUsbDevice *
 	for (i = 0; i < priv->data_array->len; i++) {
 		data = g_ptr_array_index (priv->data_array, i);
 		device_id_tmp = g_usb_device_get_platform_id (data->device);
-		if (g_strcmp0 (device_id_tmp, device_id) == 0)
+		if (g_strcmp0 (device_id_tmp, device_id) != 0)
+			continue;
+		if (data->state == CH_DEVICE_QUEUE_DATA_STATE_PENDING ||
+		    data->state == CH_DEVICE_QUEUE_DATA_STATE_WAITING_FOR_HW) {
 			data->state = CH_DEVICE_QUEUE_DATA_STATE_CANCELLED;
+			priv->done_cnt++;
+		}
+	}
+
+	/* nothing left to submit for this device */
+	lanes = g_hash_table_lookup (priv->device_pending, device_id);
+	if (lanes != NULL) {
+		g_queue_clear (lanes->optical);
+		g_queue_clear (lanes->management);
 	}
 }
 
@@ -137,48 +204,21 @@ static void
 ch_device_queue_update_progress (ChDeviceQueue *device_queue)
 {
 	ChDeviceQueuePrivate *priv = GET_PRIVATE (device_queue);
-	guint complete = 0;
-	guint i;
 	guint percentage;
-	ChDeviceQueueData *data;
 
 	/* no devices */
 	if (priv->data_array->len == 0)
 		return;
 
-	/* find out how many commands are complete */
-	for (i = 0; i < priv->data_array->len; i++) {
-		data = g_ptr_array_index (priv->data_array, i);
-		if (data->state == CH_DEVICE_QUEUE_DATA_STATE_COMPLETE ||
-		    data->state == CH_DEVICE_QUEUE_DATA_STATE_CANCELLED)
-			complete++;
-	}
-
-	/* emit a signal with our progress */
-	percentage = (complete * 100) / priv->data_array->len;
+	/* emit a signal with our aggregate progress over all devices,
+	 * maintained as a counter so sixteen devices completing commands
+	 * concurrently do not each rescan the whole queue */
+	percentage = (priv->done_cnt * 100) / priv->data_array->len;
 	g_signal_emit (device_queue,
 		       signals[SIGNAL_PROGRESS_CHANGED], 0,
 		       percentage);
 }
 
-static guint
-ch_device_queue_count_in_state (ChDeviceQueue *device_queue,
-				ChDeviceQueueDataState state)
-{
-	ChDeviceQueuePrivate *priv = GET_PRIVATE (device_queue);
-	guint i;
-	guint cnt = 0;
-	ChDeviceQueueData *data;
-
-	/* find any data objects in a specific state */
-	for (i = 0; i < priv->data_array->len; i++) {
-		data = g_ptr_array_index (priv->data_array, i);
-		if (data->state == state)
-			cnt++;
-	}
-	return cnt;
-}
-
 static void
 ch_device_queue_process_write_command_cb (GObject *source,
 					  GAsyncResult *res,
@@ -193,7 +233,6 @@ ch_device_queue_process_write_command_cb (GObject *source,
 	const gchar *tmp;
 	gboolean ret;
 	g_autoptr(GError) error = NULL;
-	guint i;
 	guint pending_commands;
 	ChError last_error_code = 0;
 	GUsbDevice *device = G_USB_DEVICE (source);
@@ -205,7 +244,10 @@ ch_device_queue_process_write_command_cb (GObject *source,
 	g_hash_table_remove (priv->devices_in_use, device_id);
 
 	/* get data */
-	ret = ch_device_write_command_finish (device, res, &error);
+	if (data->bulk_flash)
+		ret = ch_device_write_flash_finish (device, res, &error);
+	else
+		ret = ch_device_write_command_finish (device, res, &error);
 	if (ret && data->parse_func != NULL) {
 		/* do any conversion function */
 		ret = data->parse_func (data->buffer_out,
@@ -238,21 +280,16 @@ ch_device_queue_process_write_command_cb (GObject *source,
 
 	/* update progress */
 	data->state = CH_DEVICE_QUEUE_DATA_STATE_COMPLETE;
+	priv->done_cnt++;
 	ch_device_queue_update_progress (device_queue);
 
-	/* is there another pending command for this device */
-	for (i = 0; i < priv->data_array->len; i++) {
-		data = g_ptr_array_index (priv->data_array, i);
-		ret = ch_device_queue_process_data (task, data);
-		if (ret)
-			break;
-	}
+	/* submit the next command for this device straight away, found
+	 * in constant time from the per-device queue rather than by
+	 * rescanning every command */
+	ch_device_queue_process_next (task, device);
 out:
 	/* any more pending commands? */
-	pending_commands = ch_device_queue_count_in_state (device_queue,
-							   CH_DEVICE_QUEUE_DATA_STATE_PENDING);
-	pending_commands += ch_device_queue_count_in_state (device_queue,
-							    CH_DEVICE_QUEUE_DATA_STATE_WAITING_FOR_HW);
+	pending_commands = priv->data_array->len - priv->done_cnt;
 	g_debug ("Pending commands: %u", pending_commands);
 	if (pending_commands == 0) {
 
@@ -290,43 +327,75 @@ out:
 	}
 }
 
+/* pops the next command that is still runnable, or NULL */
+static ChDeviceQueueData *
+ch_device_queue_pending_pop (GQueue *queue)
+{
+	ChDeviceQueueData *data;
+	do {
+		data = g_queue_pop_head (queue);
+	} while (data != NULL &&
+		 data->state != CH_DEVICE_QUEUE_DATA_STATE_PENDING);
+	return data;
+}
+
 /**
- * ch_device_queue_process_data:
+ * ch_device_queue_process_next:
+ *
+ * Submits the next command waiting for the device, found in constant
+ * time from the per-device queues. Management commands are dispatched
+ * first so they do not serialize behind a pending integration; the
+ * sensor front-end commands keep their relative order in their own lane.
  *
- * Returns TRUE if the command was submitted
+ * Returns TRUE if a command was submitted
  **/
 static gboolean
-ch_device_queue_process_data (GTask *task, ChDeviceQueueData *data)
+ch_device_queue_process_next (GTask *task, GUsbDevice *device)
 {
 	ChDeviceQueue *device_queue = CH_DEVICE_QUEUE (g_task_get_source_object (task));
 	ChDeviceQueuePrivate *priv = GET_PRIVATE (device_queue);
-	ChDeviceQueueData *data_tmp;
+	ChDeviceQueueData *data;
+	ChDeviceQueuePendingLanes *lanes;
 	const gchar *device_id;
 
-	/* is this command already complete? */
-	if (data->state == CH_DEVICE_QUEUE_DATA_STATE_COMPLETE)
+	/* is this device already busy? */
+	device_id = g_usb_device_get_platform_id (device);
+	if (g_hash_table_lookup (priv->devices_in_use, device_id) != NULL)
 		return FALSE;
 
-	/* is this device already busy? */
-	device_id = g_usb_device_get_platform_id (data->device);
-	data_tmp = g_hash_table_lookup (priv->devices_in_use, device_id);
-	if (data_tmp != NULL)
+	/* management traffic never waits for the optical lane */
+	lanes = g_hash_table_lookup (priv->device_pending, device_id);
+	if (lanes == NULL)
+		return FALSE;
+	data = ch_device_queue_pending_pop (lanes->management);
+	if (data == NULL)
+		data = ch_device_queue_pending_pop (lanes->optical);
+	if (data == NULL)
 		return FALSE;
 
-	/* write this command and wait for a response */
-	ch_device_write_command_async (data->device,
-				       data->cmd,
-				       data->buffer_in,
-				       data->buffer_in_len,
-				       data->buffer_out,
-				       data->buffer_out_len,
-				       g_task_get_cancellable (task),
-				       ch_device_queue_process_write_command_cb,
-				       task);
+	/* write this command and wait for a response; bulk entries
+	 * stream the whole payload with a single completion */
+	if (data->bulk_flash) {
+		ch_device_write_flash_async (data->device,
+					     data->address,
+					     data->buffer_in,
+					     data->buffer_in_len,
+					     g_task_get_cancellable (task),
+					     ch_device_queue_process_write_command_cb,
+					     task);
+	} else {
+		ch_device_write_command_async (data->device,
+					       data->cmd,
+					       data->buffer_in,
+					       data->buffer_in_len,
+					       data->buffer_out,
+					       data->buffer_out_len,
+					       g_task_get_cancellable (task),
+					       ch_device_queue_process_write_command_cb,
+					       task);
+	}
 	/* mark this as in use */
 	g_hash_table_insert (priv->devices_in_use, g_strdup (device_id), data);
-
-	/* remove this from the command queue -- TODO: retries? */
 	data->state = CH_DEVICE_QUEUE_DATA_STATE_WAITING_FOR_HW;
 	return TRUE;
 }
@@ -338,7 +407,10 @@ ch_device_queue_process_data (GTask *task, ChDeviceQueueData *data)
  * @callback:		A #GAsyncReadyCallback that will be called when finished.
  * @user_data:		User data passed to @callback
  *
- * Processes all commands in the command queue.
+ * Processes all commands in the command queue. Commands for different
+ * devices are submitted concurrently, with one command in flight per
+ * device, so the wall time scales with the slowest device rather than
+ * the sum of all of them.
  *
  * Since: 0.1.29
  **/
@@ -352,8 +424,9 @@ ch_device_queue_process_async (ChDeviceQueue		*device_queue,
 	ChDeviceQueuePrivate *priv = GET_PRIVATE (device_queue);
 	ChDeviceQueueTaskData *tdata;
 	ChDeviceQueueData *data;
+	ChDeviceQueuePendingLanes *lanes;
+	GHashTableIter iter;
 	GTask *task = NULL;
-	guint i;
 
 	g_return_if_fail (CH_IS_DEVICE_QUEUE (device_queue));
 	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
@@ -365,11 +438,16 @@ ch_device_queue_process_async (ChDeviceQueue		*device_queue,
 	tdata->failures = g_ptr_array_new_with_free_func (g_free);
 	g_task_set_task_data (task, tdata, (GDestroyNotify) ch_device_queue_task_data_free);
 
-	/* go through the list of commands and try to submit them all */
+	/* fan out the first command to every device with work queued;
+	 * each completion then submits the next command for its device */
 	ch_device_queue_update_progress (device_queue);
-	for (i = 0; i < priv->data_array->len; i++) {
-		data = g_ptr_array_index (priv->data_array, i);
-		ch_device_queue_process_data (task, data);
+	g_hash_table_iter_init (&iter, priv->device_pending);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &lanes)) {
+		data = g_queue_peek_head (lanes->management);
+		if (data == NULL)
+			data = g_queue_peek_head (lanes->optical);
+		if (data != NULL)
+			ch_device_queue_process_next (task, data->device);
 	}
 
 	/* is anything pending? */
@@ -466,7 +544,7 @@ ch_device_queue_process (ChDeviceQueue	*device_queue,
 
 /**********************************************************************/
 
-static void
+static ChDeviceQueueData *
 ch_device_queue_add_internal (ChDeviceQueue		*device_queue,
 			      GUsbDevice		*device,
 			      guint8			 cmd,
@@ -481,9 +559,11 @@ ch_device_queue_add_internal (ChDeviceQueue		*device_queue,
 {
 	ChDeviceQueueData *data;
 	ChDeviceQueuePrivate *priv = GET_PRIVATE (device_queue);
+	ChDeviceQueuePendingLanes *lanes;
+	const gchar *device_id;
 
-	g_return_if_fail (CH_IS_DEVICE_QUEUE (device_queue));
-	g_return_if_fail (G_USB_IS_DEVICE (device));
+	g_return_val_if_fail (CH_IS_DEVICE_QUEUE (device_queue), NULL);
+	g_return_val_if_fail (G_USB_IS_DEVICE (device), NULL);
 
 	data = g_new0 (ChDeviceQueueData, 1);
 	data->state = CH_DEVICE_QUEUE_DATA_STATE_PENDING;
@@ -499,6 +579,25 @@ ch_device_queue_add_internal (ChDeviceQueue		*device_queue,
 	data->buffer_out_len = buffer_out_len;
 	data->buffer_out_destroy_func = buffer_out_destroy_func;
 	g_ptr_array_add (priv->data_array, data);
+
+	/* also index by device, so finding the next command at dispatch
+	 * time does not scan the whole array; commands are sorted into
+	 * the optical or management lane by what they touch */
+	device_id = g_usb_device_get_platform_id (device);
+	lanes = g_hash_table_lookup (priv->device_pending, device_id);
+	if (lanes == NULL) {
+		lanes = g_new0 (ChDeviceQueuePendingLanes, 1);
+		lanes->optical = g_queue_new ();
+		lanes->management = g_queue_new ();
+		g_hash_table_insert (priv->device_pending,
+				     g_strdup (device_id),
+				     lanes);
+	}
+	if (!data->bulk_flash && ch_device_queue_cmd_is_optical (cmd))
+		g_queue_push_tail (lanes->optical, data);
+	else
+		g_queue_push_tail (lanes->management, data);
+	return data;
 }
 
 /**
@@ -924,9 +1023,8 @@ ch_device_queue_buffer_to_get_calibration_cb (guint8 *output_buffer,
 					      GError **error)
 {
 	ChDeviceQueueGetCalibrationHelper *helper = (void *) user_data;
-	ChPackedFloat pf_tmp;
+	ChPackedFloat pf_tmp[9];
 	gdouble *calibration_tmp;
-	guint i;
 
 	/* check buffer size */
 	if (output_buffer_size != 60) {
@@ -939,10 +1037,8 @@ ch_device_queue_buffer_to_get_calibration_cb (guint8 *output_buffer,
 	/* convert back into floating point */
 	if (helper->calibration != NULL) {
 		calibration_tmp = cd_mat33_get_data (helper->calibration);
-		for (i = 0; i < 9; i++) {
-			memcpy (&pf_tmp, &output_buffer[i*4], sizeof (pf_tmp));
-			ch_packed_float_to_double (&pf_tmp, &calibration_tmp[i]);
-		}
+		memcpy (pf_tmp, output_buffer, sizeof (pf_tmp));
+		ch_packed_float_to_double_array (pf_tmp, calibration_tmp, 9);
 	}
 
 	/* get the supported types */
@@ -1031,10 +1127,8 @@ ch_device_queue_set_calibration (ChDeviceQueue *device_queue,
 				 guint8 types,
 				 const gchar *description)
 {
-	ChPackedFloat pf_tmp;
-	gdouble *calibration_tmp;
+	ChPackedFloat pf_tmp[9];
 	guint8 buffer[9*4 + 2 + 1 + CH_CALIBRATION_DESCRIPTION_LEN];
-	guint i;
 
 	g_return_if_fail (CH_IS_DEVICE_QUEUE (device_queue));
 	g_return_if_fail (G_USB_IS_DEVICE (device));
@@ -1046,11 +1140,9 @@ ch_device_queue_set_calibration (ChDeviceQueue *device_queue,
 	memcpy (buffer, &calibration_index, sizeof(guint16));
 
 	/* convert from float to signed value */
-	for (i = 0; i < 9; i++) {
-		calibration_tmp = cd_mat33_get_data (calibration);
-		ch_double_to_packed_float (calibration_tmp[i], &pf_tmp);
-		memcpy (&buffer[i*4 + 2], &pf_tmp, sizeof (pf_tmp));
-	}
+	ch_double_to_packed_float_array (cd_mat33_get_data (calibration),
+					 pf_tmp, 9);
+	memcpy (&buffer[2], pf_tmp, sizeof (pf_tmp));
 
 	/* write types */
 	buffer[9*4 + 2] = types;
@@ -1148,6 +1240,165 @@ ch_device_queue_set_calibration_ccmx (ChDeviceQueue *device_queue,
 	return TRUE;
 }
 
+/**
+ * ch_device_queue_get_calibrations:
+ * @device_queue:	A #ChDeviceQueue
+ * @device:		A #GUsbDevice
+ * @calibration_index:	The first slot position
+ * @calibrations:	An array of @len 3x3 calibration matrices, or %NULL
+ * @types:		An array of @len type bitfields, or %NULL
+ * @descriptions:	A buffer of @len packed descriptions each of
+ *			%CH_CALIBRATION_DESCRIPTION_LEN + 1 bytes, or %NULL
+ * @len:		The number of slots to read
+ *
+ * Gets the calibration data for a contiguous range of slots, queueing
+ * all the reads back-to-back so they are processed in one run.
+ *
+ * NOTE: This command is available on hardware version: 1 & 2
+ *
+ * Since: 1.4.6
+ **/
+void
+ch_device_queue_get_calibrations (ChDeviceQueue *device_queue,
+				  GUsbDevice *device,
+				  guint16 calibration_index,
+				  CdMat3x3 *calibrations,
+				  guint8 *types,
+				  gchar *descriptions,
+				  guint len)
+{
+	guint i;
+
+	g_return_if_fail (CH_IS_DEVICE_QUEUE (device_queue));
+	g_return_if_fail (G_USB_IS_DEVICE (device));
+	g_return_if_fail (calibration_index + len <= CH_CALIBRATION_MAX);
+
+	for (i = 0; i < len; i++) {
+		ch_device_queue_get_calibration (device_queue,
+						 device,
+						 calibration_index + i,
+						 calibrations != NULL ? &calibrations[i] : NULL,
+						 types != NULL ? &types[i] : NULL,
+						 descriptions != NULL ?
+							descriptions + i * (CH_CALIBRATION_DESCRIPTION_LEN + 1) :
+							NULL);
+	}
+}
+
+/* tiny helper */
+typedef struct {
+	guint16		 calibration_index;
+	guint8		 buffer_expected[9*4 + 1 + CH_CALIBRATION_DESCRIPTION_LEN];
+} ChDeviceQueueVerifyCalibrationHelper;
+
+static gboolean
+ch_device_queue_buffer_to_verify_calibration_cb (guint8 *output_buffer,
+						 gsize output_buffer_size,
+						 gpointer user_data,
+						 GError **error)
+{
+	ChDeviceQueueVerifyCalibrationHelper *helper = (void *) user_data;
+
+	/* check buffer size */
+	if (output_buffer_size != sizeof (helper->buffer_expected)) {
+		g_set_error (error, 1, 0,
+			     "Wrong output buffer size, expected %" G_GSIZE_FORMAT ", got %" G_GSIZE_FORMAT,
+			     sizeof (helper->buffer_expected), output_buffer_size);
+		return FALSE;
+	}
+
+	/* the packed float conversion is exact, so the readback has to
+	 * match what was written byte for byte */
+	if (memcmp (output_buffer, helper->buffer_expected,
+		    sizeof (helper->buffer_expected)) != 0) {
+		g_set_error (error, 1, 0,
+			     "Calibration readback mismatch in slot %u",
+			     helper->calibration_index);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/**
+ * ch_device_queue_set_calibrations:
+ * @device_queue:	A #ChDeviceQueue
+ * @device:		A #GUsbDevice
+ * @calibration_index:	The first slot position
+ * @calibrations:	An array of @len 3x3 calibration matrices
+ * @types:		An array of @len type bitfields
+ * @descriptions:	An array of @len description strings
+ * @len:		The number of slots to write
+ *
+ * Sets the calibration data for a contiguous range of slots. All the
+ * writes are queued back-to-back and then the verification reads are
+ * pipelined after them rather than interleaved, so importing a large
+ * matrix library costs one queue run rather than one round trip per
+ * slot.
+ *
+ * NOTE: This command is available on hardware version: 1 & 2
+ *
+ * Since: 1.4.6
+ **/
+void
+ch_device_queue_set_calibrations (ChDeviceQueue *device_queue,
+				  GUsbDevice *device,
+				  guint16 calibration_index,
+				  const CdMat3x3 *calibrations,
+				  const guint8 *types,
+				  const gchar * const *descriptions,
+				  guint len)
+{
+	guint i;
+
+	g_return_if_fail (CH_IS_DEVICE_QUEUE (device_queue));
+	g_return_if_fail (G_USB_IS_DEVICE (device));
+	g_return_if_fail (calibration_index + len <= CH_CALIBRATION_MAX);
+	g_return_if_fail (calibrations != NULL);
+	g_return_if_fail (types != NULL);
+	g_return_if_fail (descriptions != NULL);
+
+	/* queue all the writes back-to-back */
+	for (i = 0; i < len; i++) {
+		ch_device_queue_set_calibration (device_queue,
+						 device,
+						 calibration_index + i,
+						 &calibrations[i],
+						 types[i],
+						 descriptions[i]);
+	}
+
+	/* then pipeline the verification reads */
+	for (i = 0; i < len; i++) {
+		ChDeviceQueueVerifyCalibrationHelper *helper;
+		ChPackedFloat pf_tmp[9];
+		guint8 *buffer;
+
+		/* build the data block we expect to read back */
+		helper = g_new0 (ChDeviceQueueVerifyCalibrationHelper, 1);
+		helper->calibration_index = calibration_index + i;
+		ch_double_to_packed_float_array (cd_mat33_get_data (&calibrations[i]),
+						 pf_tmp, 9);
+		memcpy (helper->buffer_expected, pf_tmp, sizeof (pf_tmp));
+		helper->buffer_expected[9*4] = types[i];
+		strncpy ((gchar *) helper->buffer_expected + 9*4 + 1,
+			 descriptions[i],
+			 CH_CALIBRATION_DESCRIPTION_LEN);
+
+		buffer = g_new0 (guint8, 9*4 + 1 + CH_CALIBRATION_DESCRIPTION_LEN);
+		ch_device_queue_add_internal (device_queue,
+					      device,
+					      CH_CMD_GET_CALIBRATION,
+					      (guint8 *) &helper->calibration_index,
+					      sizeof(guint16),
+					      buffer,
+					      9*4 + 1 + CH_CALIBRATION_DESCRIPTION_LEN,
+					      g_free,
+					      ch_device_queue_buffer_to_verify_calibration_cb,
+					      helper,
+					      g_free);
+	}
+}
+
 /**
  * ch_device_queue_write_firmware:
  * @device_queue:		A #ChDeviceQueue
@@ -1167,8 +1418,7 @@ ch_device_queue_write_firmware (ChDeviceQueue	*device_queue,
 				const guint8	*data,
 				gsize		 len)
 {
-	gsize chunk_len;
-	guint idx;
+	ChDeviceQueueData *qdata;
 	guint16 runcode_addr;
 
 	g_return_if_fail (CH_IS_DEVICE_QUEUE (device_queue));
@@ -1184,24 +1434,25 @@ ch_device_queue_write_firmware (ChDeviceQueue	*device_queue,
 				     runcode_addr,
 				     len);
 
-	/* just write in 32 byte chunks, as we're sure that the firmware
-	 * image has been prepared to end on a 64 byte chunk with
-	 * colorhug-inhx32-to-bin >= 0.1.5 */
-	idx = 0;
-	chunk_len = CH_FLASH_TRANSFER_BLOCK_SIZE;
-	do {
-		if (idx + chunk_len > len)
-			chunk_len = len - idx;
-		g_debug ("Writing at %04x size %" G_GSIZE_FORMAT,
-			 runcode_addr + idx,
-			 chunk_len);
-		ch_device_queue_write_flash (device_queue,
-					     device,
-					     runcode_addr + idx,
-					     (guint8 *) data + idx,
-					     chunk_len);
-		idx += chunk_len;
-	} while (idx < len);
+	/* stream the whole image as one queue entry; the hardware still
+	 * takes 32 byte packets but the chunking is chained inside
+	 * ch_device_write_flash_async() with a single completion, so the
+	 * queue does not have to schedule two thousand commands */
+	g_debug ("Writing at %04x size %" G_GSIZE_FORMAT,
+		 runcode_addr, len);
+	qdata = ch_device_queue_add_internal (device_queue,
+					      device,
+					      CH_CMD_WRITE_FLASH,
+					      data,
+					      len,
+					      NULL,
+					      0,
+					      NULL,
+					      NULL,
+					      NULL,
+					      NULL);
+	qdata->bulk_flash = TRUE;
+	qdata->address = runcode_addr;
 }
 
 /**
@@ -3178,6 +3429,10 @@ ch_device_queue_init (ChDeviceQueue *device_queue)
 								    g_str_equal,
 								    g_free,
 								    NULL);
+	priv->device_pending = g_hash_table_new_full (g_str_hash,
+								    g_str_equal,
+								    g_free,
+								    (GDestroyNotify) ch_device_queue_pending_lanes_free);
 }
 
 static void
@@ -3188,6 +3443,7 @@ ch_device_queue_finalize (GObject *object)
 
 	g_ptr_array_unref (priv->data_array);
 	g_hash_table_unref (priv->devices_in_use);
+	g_hash_table_unref (priv->device_pending);
 
 	G_OBJECT_CLASS (ch_device_queue_parent_class)->finalize (object);
 }
@@ -154,6 +154,20 @@ void		 ch_device_queue_set_calibration	(ChDeviceQueue	*device_queue,
 							 const CdMat3x3	*calibration,
 							 guint8		 types,
 							 const gchar	*description);
+void		 ch_device_queue_get_calibrations	(ChDeviceQueue	*device_queue,
+							 GUsbDevice	*device,
+							 guint16	 calibration_index,
+							 CdMat3x3	*calibrations,
+							 guint8		*types,
+							 gchar		*descriptions,
+							 guint		 len);
+void		 ch_device_queue_set_calibrations	(ChDeviceQueue	*device_queue,
+							 GUsbDevice	*device,
+							 guint16	 calibration_index,
+							 const CdMat3x3	*calibrations,
+							 const guint8	*types,
+							 const gchar * const *descriptions,
+							 guint		 len);
 void		 ch_device_queue_clear_calibration	(ChDeviceQueue	*device_queue,
 							 GUsbDevice	*device,
 							 guint16	 calibration_index);
@@ -46,6 +46,51 @@ ch_device_error_quark (void)
 	return quark;
 }
 
+/* static device facts do not change between connections, so they are
+ * cached per platform-id for the lifetime of the process and only
+ * refreshed after a command that could change them */
+typedef struct {
+	guint32		 serial_number;
+	gboolean	 serial_number_valid;
+} ChDeviceCacheItem;
+
+static GHashTable *ch_device_cache = NULL;	/* of platform_id:ChDeviceCacheItem */
+G_LOCK_DEFINE_STATIC (ch_device_cache);
+
+/* the lock must be held */
+static ChDeviceCacheItem *
+ch_device_cache_get_item (GUsbDevice *device)
+{
+	ChDeviceCacheItem *item;
+	const gchar *platform_id = g_usb_device_get_platform_id (device);
+
+	if (ch_device_cache == NULL) {
+		ch_device_cache = g_hash_table_new_full (g_str_hash,
+							 g_str_equal,
+							 g_free,
+							 g_free);
+	}
+	item = g_hash_table_lookup (ch_device_cache, platform_id);
+	if (item == NULL) {
+		item = g_new0 (ChDeviceCacheItem, 1);
+		g_hash_table_insert (ch_device_cache,
+				     g_strdup (platform_id),
+				     item);
+	}
+	return item;
+}
+
+static void
+ch_device_cache_invalidate (GUsbDevice *device)
+{
+	G_LOCK (ch_device_cache);
+	if (ch_device_cache != NULL) {
+		g_hash_table_remove (ch_device_cache,
+				     g_usb_device_get_platform_id (device));
+	}
+	G_UNLOCK (ch_device_cache);
+}
+
 /**
  * ch_device_open:
  *
@@ -579,6 +624,19 @@ ch_device_write_command_async (GUsbDevice *device,
 	g_return_if_fail (cmd != 0);
 	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
 
+	/* these commands change the static device facts */
+	switch (cmd) {
+	case CH_CMD_RESET:
+	case CH_CMD_SET_SERIAL_NUMBER:
+	case CH_CMD_ERASE_FLASH:
+	case CH_CMD_WRITE_FLASH:
+	case CH_CMD_SET_FLASH_SUCCESS:
+		ch_device_cache_invalidate (device);
+		break;
+	default:
+		break;
+	}
+
 	task = g_task_new (device, cancellable, callback, user_data);
 
 	tdata = g_new0 (ChDeviceTaskData, 1);
@@ -606,7 +664,14 @@ ch_device_write_command_async (GUsbDevice *device,
 
 	/* dummy hardware */
 	if (g_getenv ("COLORHUG_EMULATE") != NULL) {
-		g_timeout_add (20, ch_device_emulate_cb, tdata);
+		guint delay_ms = 20;
+		const gchar *delay_str = g_getenv ("COLORHUG_EMULATE_DELAY");
+
+		/* benchmarks set a zero delay to measure queue overhead
+		 * rather than the emulated reply latency */
+		if (delay_str != NULL)
+			delay_ms = (guint) g_ascii_strtoull (delay_str, NULL, 10);
+		g_timeout_add (delay_ms, ch_device_emulate_cb, tdata);
 		return;
 	}
 
@@ -762,6 +827,162 @@ ch_device_write_command (GUsbDevice *device,
 	return helper.ret;
 }
 
+/* tiny helper to stream a payload larger than one HID packet */
+typedef struct {
+	guint8		*data;
+	gsize		 len;
+	gsize		 idx;
+	guint16		 address;
+} ChDeviceFlashHelper;
+
+static void
+ch_device_flash_helper_free (ChDeviceFlashHelper *helper)
+{
+	g_free (helper->data);
+	g_free (helper);
+}
+
+static guint8
+ch_device_flash_checksum (const guint8 *data, gsize len)
+{
+	guint8 checksum = 0xff;
+	guint i;
+	for (i = 0; i < len; i++)
+		checksum ^= data[i];
+	return checksum;
+}
+
+/**
+ * ch_device_write_flash_finish:
+ * @device: a #GUsbDevice instance.
+ * @res: the #GAsyncResult
+ * @error: A #GError or %NULL
+ *
+ * Gets the result from the asynchronous function.
+ *
+ * Return value: %TRUE if the request was fulfilled.
+ *
+ * Since: 1.4.6
+ **/
+gboolean
+ch_device_write_flash_finish (GUsbDevice *device,
+			      GAsyncResult *res,
+			      GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (res, device), FALSE);
+	return g_task_propagate_boolean (G_TASK (res), error);
+}
+
+static void ch_device_write_flash_next (GTask *task);
+
+static void
+ch_device_write_flash_chunk_cb (GObject *source,
+				GAsyncResult *res,
+				gpointer user_data)
+{
+	GUsbDevice *device = G_USB_DEVICE (source);
+	GTask *task = G_TASK (user_data);
+	ChDeviceFlashHelper *helper = g_task_get_task_data (task);
+	GError *error = NULL;
+
+	/* the chunk failed, so abandon the rest of the payload */
+	if (!ch_device_write_command_finish (device, res, &error)) {
+		g_task_return_error (task, error);
+		g_object_unref (task);
+		return;
+	}
+
+	/* all done */
+	if (helper->idx >= helper->len) {
+		g_task_return_boolean (task, TRUE);
+		g_object_unref (task);
+		return;
+	}
+
+	/* send the next chunk */
+	ch_device_write_flash_next (task);
+}
+
+static void
+ch_device_write_flash_next (GTask *task)
+{
+	ChDeviceFlashHelper *helper = g_task_get_task_data (task);
+	GUsbDevice *device = G_USB_DEVICE (g_task_get_source_object (task));
+	gsize chunk_len;
+	guint16 addr_le;
+	guint8 buffer_tx[CH_FLASH_TRANSFER_BLOCK_SIZE + 4];
+
+	/* set address, length, checksum, data */
+	chunk_len = MIN (helper->len - helper->idx,
+			 CH_FLASH_TRANSFER_BLOCK_SIZE);
+	addr_le = GUINT16_TO_LE (helper->address + helper->idx);
+	memcpy (buffer_tx + 0, &addr_le, 2);
+	buffer_tx[2] = chunk_len;
+	buffer_tx[3] = ch_device_flash_checksum (helper->data + helper->idx,
+						 chunk_len);
+	memcpy (buffer_tx + 4, helper->data + helper->idx, chunk_len);
+	helper->idx += chunk_len;
+
+	ch_device_write_command_async (device,
+				       CH_CMD_WRITE_FLASH,
+				       buffer_tx,
+				       chunk_len + 4,
+				       NULL,
+				       0,
+				       g_task_get_cancellable (task),
+				       ch_device_write_flash_chunk_cb,
+				       task);
+}
+
+/**
+ * ch_device_write_flash_async:
+ * @device:		A #GUsbDevice
+ * @address:		The device EEPROM address
+ * @data: (array length=len): Binary data
+ * @len:		The length of @data
+ * @cancellable:	A #GCancellable, or %NULL
+ * @callback:		A #GAsyncReadyCallback that will be called when finished.
+ * @user_data:		User data passed to @callback
+ *
+ * Streams a payload of any size to the device flash with a single
+ * completion. The hardware still takes the data in
+ * %CH_FLASH_TRANSFER_BLOCK_SIZE packets, but each reply chains the
+ * next packet directly so a 64kB firmware image costs one task and
+ * one callback rather than two thousand.
+ *
+ * NOTE: This command is available on hardware version: 1 & 2
+ *
+ * Since: 1.4.6
+ **/
+void
+ch_device_write_flash_async (GUsbDevice *device,
+			     guint16 address,
+			     const guint8 *data,
+			     gsize len,
+			     GCancellable *cancellable,
+			     GAsyncReadyCallback callback,
+			     gpointer user_data)
+{
+	ChDeviceFlashHelper *helper;
+	GTask *task = NULL;
+
+	g_return_if_fail (G_USB_IS_DEVICE (device));
+	g_return_if_fail (data != NULL);
+	g_return_if_fail (len > 0);
+	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+	task = g_task_new (device, cancellable, callback, user_data);
+	helper = g_new0 (ChDeviceFlashHelper, 1);
+	helper->data = g_memdup (data, len);
+	helper->len = len;
+	helper->address = address;
+	g_task_set_task_data (task, helper,
+			      (GDestroyNotify) ch_device_flash_helper_free);
+
+	/* send the first chunk, each reply triggers the next */
+	ch_device_write_flash_next (task);
+}
+
 /**
  * ch_device_check_firmware:
  * @data: (array length=data_len): firmware binary data
@@ -1030,6 +1251,9 @@ ch_device_set_serial_number (GUsbDevice *device, guint32 value,
 	guint32 value_le;
 	guint8 protocol_ver = ch_device_get_protocol_ver (device);
 
+	/* no longer current */
+	ch_device_cache_invalidate (device);
+
 	value_le = GUINT32_TO_LE (value);
 	if (protocol_ver == 1) {
 		return ch_device_write_command (device,
@@ -1080,20 +1304,42 @@ gboolean
 ch_device_get_serial_number (GUsbDevice *device, guint32 *value,
 			     GCancellable *cancellable, GError **error)
 {
+	ChDeviceCacheItem *item;
 	guint8 protocol_ver = ch_device_get_protocol_ver (device);
 
 	g_return_val_if_fail (G_USB_DEVICE (device), FALSE);
 	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
+	/* served from the cache without any USB traffic */
+	G_LOCK (ch_device_cache);
+	item = ch_device_cache_get_item (device);
+	if (item->serial_number_valid) {
+		if (value != NULL)
+			*value = item->serial_number;
+		G_UNLOCK (ch_device_cache);
+		return TRUE;
+	}
+	G_UNLOCK (ch_device_cache);
+
 	if (protocol_ver == 1) {
-		return ch_device_write_command (device,
-						CH_CMD_GET_SERIAL_NUMBER,
-						NULL,
-						0,
-						(guint8 *) value,
-						sizeof(guint32),
-						cancellable,
-						error);
+		guint32 value_tmp = 0;
+		if (!ch_device_write_command (device,
+					      CH_CMD_GET_SERIAL_NUMBER,
+					      NULL,
+					      0,
+					      (guint8 *) &value_tmp,
+					      sizeof(guint32),
+					      cancellable,
+					      error))
+			return FALSE;
+		G_LOCK (ch_device_cache);
+		item = ch_device_cache_get_item (device);
+		item->serial_number = value_tmp;
+		item->serial_number_valid = TRUE;
+		G_UNLOCK (ch_device_cache);
+		if (value != NULL)
+			*value = value_tmp;
+		return TRUE;
 	}
 	if (protocol_ver == 2) {
 		guint8 buf[2];
@@ -1124,8 +1370,14 @@ ch_device_get_serial_number (GUsbDevice *device, guint32 *value,
 				     actual_length);
 			return FALSE;
 		}
+		G_LOCK (ch_device_cache);
+		item = ch_device_cache_get_item (device);
+		item->serial_number = 0;
+		memcpy (&item->serial_number, buf, sizeof(buf));
+		item->serial_number_valid = TRUE;
 		if (value != NULL)
-			memcpy (value, buf, sizeof(buf));
+			*value = item->serial_number;
+		G_UNLOCK (ch_device_cache);
 		return TRUE;
 	}
 	g_set_error_literal (error,
@@ -2339,7 +2591,8 @@ ch_device_set_spectrum_full (GUsbDevice *device,
 			     GError **error)
 {
 	gboolean ret;
-	guint16 buf[CH_PIXELS_PER_TRANSFER];
+	guint16 vals[CH_PIXELS_PER_TRANSFER];
+	guint8 buf[CH_PIXELS_PER_TRANSFER * sizeof (guint16)];
 	gsize actual_length;
 	guint16 i;
 	guint16 j;
@@ -2372,7 +2625,6 @@ ch_device_set_spectrum_full (GUsbDevice *device,
 
 		/* create normalised data blob */
 		for (j = 0; j < CH_PIXELS_PER_TRANSFER; j++) {
-			guint16 tmp;
 			gdouble val = cd_spectrum_get_value (sp_resampled, cnt + j);
 			if (val < 0.f || val > 1.f) {
 				g_set_error (error,
@@ -2382,11 +2634,13 @@ ch_device_set_spectrum_full (GUsbDevice *device,
 					     j, val);
 				return FALSE;
 			}
-			tmp = val * (gdouble) 0xffff;
-			memcpy (&buf[j], &tmp, sizeof (guint16));
+			vals[j] = val * (gdouble) 0xffff;
 		}
 		cnt += j;
 
+		/* the device is little endian */
+		cd_buffer_write_uint16_array_le (buf, vals, CH_PIXELS_PER_TRANSFER);
+
 		/* send to device */
 		ret = g_usb_device_control_transfer (device,
 						     G_USB_DEVICE_DIRECTION_HOST_TO_DEVICE,
@@ -2446,7 +2700,8 @@ ch_device_get_spectrum_full (GUsbDevice *device,
 			     GError **error)
 {
 	gboolean ret;
-	guint16 buf[CH_PIXELS_PER_TRANSFER];
+	guint16 vals[CH_PIXELS_PER_TRANSFER];
+	guint8 buf[CH_PIXELS_PER_TRANSFER * sizeof (guint16)];
 	gsize actual_length;
 	guint16 i;
 	guint16 j;
@@ -2493,9 +2748,12 @@ ch_device_get_spectrum_full (GUsbDevice *device,
 			return NULL;
 		}
 
+		/* the device is little endian */
+		cd_buffer_read_uint16_array_le (buf, vals, CH_PIXELS_PER_TRANSFER);
+
 		/* add data */
 		for (j = 0; j < CH_PIXELS_PER_TRANSFER; j++) {
-			gdouble tmp = (gdouble) buf[j] / (gdouble) 0xffff;
+			gdouble tmp = (gdouble) vals[j] / (gdouble) 0xffff;
 			cd_spectrum_add_value (sp, tmp);
 		}
 	}
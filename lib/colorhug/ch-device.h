@@ -67,6 +67,17 @@ gboolean	 ch_device_write_command	(GUsbDevice	*device,
 						 GCancellable	*cancellable,
 						 GError		**error)
 						 G_GNUC_WARN_UNUSED_RESULT;
+void		 ch_device_write_flash_async	(GUsbDevice	*device,
+						 guint16	 address,
+						 const guint8	*data,
+						 gsize		 len,
+						 GCancellable	*cancellable,
+						 GAsyncReadyCallback callback,
+						 gpointer	 user_data);
+gboolean	 ch_device_write_flash_finish	(GUsbDevice	*device,
+						 GAsyncResult	*res,
+						 GError		**error)
+						 G_GNUC_WARN_UNUSED_RESULT;
 gboolean	 ch_device_check_firmware	(GUsbDevice	*device,
 						 const guint8	*data,
 						 gsize		 data_len,
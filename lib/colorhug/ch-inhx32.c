@@ -31,14 +31,183 @@
 #define	CH_RECORD_TYPE_EOF		1
 #define	CH_RECORD_TYPE_EXTENDED		4
 
-static guint8
-ch_inhx32_parse_uint8 (const gchar *data, guint pos)
+/* parser state carried between records, so the same record parser can
+ * be driven from a complete buffer or from a streaming window */
+typedef struct {
+	GString		*data;
+	guint		 addr_high;
+	guint		 addr32;
+	guint		 addr32_last;
+	guint16		 runcode_addr;
+	gboolean	 verbose;
+} ChInhx32Context;
+
+static gint
+ch_inhx32_parse_nibble (gchar c)
 {
-	gchar buffer[3];
-	buffer[0] = data[pos+0];
-	buffer[1] = data[pos+1];
-	buffer[2] = '\0';
-	return g_ascii_strtoull (buffer, NULL, 16);
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	if (c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	return -1;
+}
+
+static gint
+ch_inhx32_parse_uint8 (const gchar *data, gsize pos)
+{
+	gint nibble_hi;
+	gint nibble_lo;
+
+	/* check the high nibble before touching the next byte so a
+	 * terminating NUL is never read past */
+	nibble_hi = ch_inhx32_parse_nibble (data[pos]);
+	if (nibble_hi < 0)
+		return -1;
+	nibble_lo = ch_inhx32_parse_nibble (data[pos + 1]);
+	if (nibble_lo < 0)
+		return -1;
+	return (nibble_hi << 4) | nibble_lo;
+}
+
+/**
+ * ch_inhx32_parse_record:
+ *
+ * Parses at most one record from @in_buffer, updating @ctx.
+ *
+ * Return value: the number of bytes consumed, 0 if the buffer does not
+ * yet hold a complete record, or -1 on error
+ **/
+static gssize
+ch_inhx32_parse_record (ChInhx32Context *ctx,
+			const gchar *in_buffer,
+			gsize in_len,
+			GError **error)
+{
+	gint tmp;
+	gsize i;
+	gsize record_len;
+	gsize start = 0;
+	guint addr_low;
+	guint checksum = 0;
+	guint j;
+	guint len_tmp;
+	guint type;
+
+	/* find the start of the next record */
+	while (start < in_len && in_buffer[start] != ':')
+		start++;
+
+	/* the smallest possible record is 11 bytes */
+	if (in_len - start < 11)
+		return 0;
+
+	/* length, so we know where the record ends */
+	tmp = ch_inhx32_parse_uint8 (in_buffer, start + 1);
+	if (tmp < 0) {
+		g_set_error_literal (error, 1, 0,
+				     "invalid inhx32 syntax");
+		return -1;
+	}
+	len_tmp = tmp;
+	record_len = 11 + len_tmp * 2;
+	if (in_len - start < record_len)
+		return 0;
+
+	/* verify the whole record in one pass; the sum of every byte
+	 * including the checksum has to be zero modulo 256 */
+	for (i = start + 1; i < start + record_len; i += 2) {
+		tmp = ch_inhx32_parse_uint8 (in_buffer, i);
+		if (tmp < 0) {
+			g_set_error_literal (error, 1, 0,
+					     "invalid inhx32 syntax");
+			return -1;
+		}
+		checksum += tmp;
+	}
+	if ((checksum & 0xff) != 0) {
+		g_set_error_literal (error, 1, 0,
+				     "invalid checksum");
+		return -1;
+	}
+
+	/* 16-bit address, type; already known to be valid hex */
+	addr_low = (ch_inhx32_parse_uint8 (in_buffer, start + 3) << 8) |
+		    ch_inhx32_parse_uint8 (in_buffer, start + 5);
+	type = ch_inhx32_parse_uint8 (in_buffer, start + 7);
+
+	/* process different record types */
+	switch (type) {
+	case CH_RECORD_TYPE_DATA:
+		/* if not contiguous with previous record,
+		 * issue accumulated hex data (if any) and start anew. */
+		if ((ctx->addr_high + addr_low) != ctx->addr32)
+			ctx->addr32 = ctx->addr_high + addr_low;
+
+		/* parse bytes from the record into the output */
+		for (i = start + 9; i < start + record_len - 2; i += 2) {
+			if (ctx->addr32 >= ctx->runcode_addr &&
+			    ctx->addr32 < 0xfff0) {
+
+				/* find out if there are any
+				 * holes in the hex record */
+				len_tmp = ctx->addr32 - ctx->addr32_last;
+				if (ctx->addr32_last > 0x0 && len_tmp > 1) {
+					for (j = 1; j < len_tmp; j++) {
+						if (ctx->verbose) {
+							g_debug ("Filling address 0x%04x",
+								 ctx->addr32_last + j);
+						}
+						/* although 0xff might be clearer,
+						 * we can't write 0xffff to pic14 */
+						g_string_append_c (ctx->data, 0x00);
+					}
+				}
+				g_string_append_c (ctx->data,
+						   ch_inhx32_parse_uint8 (in_buffer, i));
+				if (ctx->verbose)
+					g_debug ("Writing address 0x%04x", ctx->addr32);
+				ctx->addr32_last = ctx->addr32;
+			} else {
+				if (ctx->verbose)
+					g_debug ("Ignoring address 0x%04x", ctx->addr32);
+			}
+			ctx->addr32++;
+		}
+		break;
+	case CH_RECORD_TYPE_EOF:
+		break;
+	case CH_RECORD_TYPE_EXTENDED:
+		ctx->addr_high = ((ch_inhx32_parse_uint8 (in_buffer, start + 9) << 8) |
+				   ch_inhx32_parse_uint8 (in_buffer, start + 11)) << 16;
+		ctx->addr32 = ctx->addr_high + addr_low;
+		break;
+	default:
+		g_set_error_literal (error, 1, 0,
+				     "invalid record type");
+		return -1;
+	}
+	return start + record_len;
+}
+
+static gboolean
+ch_inhx32_context_save (ChInhx32Context *ctx,
+			guint8 **out_buffer,
+			gsize *out_size)
+{
+	gsize i;
+
+	/* pad out to device size so we can read back a verifiable blob */
+	for (i = ctx->data->len; i < ctx->runcode_addr; i++)
+		g_string_append_len (ctx->data, "\0", 1);
+
+	/* save data */
+	if (out_size != NULL)
+		*out_size = ctx->data->len;
+	if (out_buffer != NULL)
+		*out_buffer = g_memdup (ctx->data->str, ctx->data->len);
+	return TRUE;
 }
 
 /**
@@ -63,126 +232,135 @@ ch_inhx32_to_bin_full (const gchar *in_buffer,
 		       guint16 runcode_addr,
 		       GError **error)
 {
-	gboolean verbose;
-	gchar *ptr;
-	gint checksum;
-	gint end;
-	gint i;
-	gint offset = 0;
-	guint8 data_tmp;
-	guint addr32 = 0;
-	guint addr32_last = 0;
-	guint addr_high = 0;
-	guint addr_low = 0;
-	guint j;
-	guint len_tmp;
-	guint type;
+	ChInhx32Context ctx;
+	gsize in_len;
+	gsize offset = 0;
+	gssize consumed;
 	g_autoptr(GString) string = NULL;
 
 	g_return_val_if_fail (in_buffer != NULL, FALSE);
 	g_return_val_if_fail (runcode_addr > 0, FALSE);
 
 	/* only if set */
-	verbose = g_getenv ("VERBOSE") != NULL;
+	memset (&ctx, 0, sizeof (ctx));
+	ctx.verbose = g_getenv ("VERBOSE") != NULL;
+	ctx.runcode_addr = runcode_addr;
 	string = g_string_new ("");
-	while (TRUE) {
+	ctx.data = string;
 
-		/* length, 16-bit address, type */
-		if (sscanf (&in_buffer[offset], ":%02x%04x%02x",
-			    &len_tmp, &addr_low, &type) != 3) {
-			g_set_error_literal (error, 1, 0,
-					     "invalid inhx32 syntax");
+	/* parse each record in place; nothing is allocated per byte */
+	in_len = strlen (in_buffer);
+	while (offset < in_len) {
+		consumed = ch_inhx32_parse_record (&ctx,
+						   in_buffer + offset,
+						   in_len - offset,
+						   error);
+		if (consumed < 0)
 			return FALSE;
+		if (consumed == 0) {
+			/* a trailing partial record is invalid, trailing
+			 * whitespace is fine */
+			if (memchr (in_buffer + offset, ':', in_len - offset) != NULL) {
+				g_set_error_literal (error, 1, 0,
+						     "invalid inhx32 syntax");
+				return FALSE;
+			}
+			break;
 		}
+		offset += consumed;
+	}
+	return ch_inhx32_context_save (&ctx, out_buffer, out_size);
+}
+
+/**
+ * ch_inhx32_to_bin_stream:
+ * @stream: A #GInputStream of Intel hex data
+ * @out_buffer: The output byte buffer
+ * @out_size: The size of @out_buffer
+ * @runcode_addr: The runcode address of the firmware
+ * @cancellable: A #GCancellable, or %NULL
+ * @error: A #GError or %NULL
+ *
+ * Converts a stream of Intel hex data into a binary packed
+ * representation suitable for direct flashing the ColorHug.
+ *
+ * Unlike ch_inhx32_to_bin_full() the hex data is never held in memory
+ * in full; records are parsed out of a fixed window as they arrive, so
+ * images can be verified at I/O speed.
+ *
+ * Return value: %TRUE if the stream was parsed successfully
+ *
+ * Since: 1.4.6
+ **/
+gboolean
+ch_inhx32_to_bin_stream (GInputStream *stream,
+			 guint8 **out_buffer,
+			 gsize *out_size,
+			 guint16 runcode_addr,
+			 GCancellable *cancellable,
+			 GError **error)
+{
+	ChInhx32Context ctx;
+	gchar window[0x1000];
+	gsize i;
+	gsize offset;
+	gsize window_len = 0;
+	gssize consumed = 0;
+	gssize read_len;
+	g_autoptr(GString) string = NULL;
 
-		/* position of checksum */
-		end = offset + 9 + len_tmp * 2;
+	g_return_val_if_fail (G_IS_INPUT_STREAM (stream), FALSE);
+	g_return_val_if_fail (runcode_addr > 0, FALSE);
 
-		/* verify checksum */
-		checksum = 0;
-		for (i = offset + 1; i < end; i += 2) {
-			data_tmp = ch_inhx32_parse_uint8 (in_buffer, i);
-			checksum = (checksum + (0x100 - data_tmp)) & 0xff;
-		}
-		if (ch_inhx32_parse_uint8 (in_buffer, end) != checksum)  {
+	/* only if set */
+	memset (&ctx, 0, sizeof (ctx));
+	ctx.verbose = g_getenv ("VERBOSE") != NULL;
+	ctx.runcode_addr = runcode_addr;
+	string = g_string_new ("");
+	ctx.data = string;
+
+	while (TRUE) {
+		/* top up the window */
+		read_len = g_input_stream_read (stream,
+						window + window_len,
+						sizeof (window) - window_len,
+						cancellable,
+						error);
+		if (read_len < 0)
+			return FALSE;
+		if (read_len == 0)
+			break;
+		window_len += read_len;
+
+		/* parse every complete record, then slide the window */
+		offset = 0;
+		while ((consumed = ch_inhx32_parse_record (&ctx,
+							   window + offset,
+							   window_len - offset,
+							   error)) > 0)
+			offset += consumed;
+		if (consumed < 0)
+			return FALSE;
+		memmove (window, window + offset, window_len - offset);
+		window_len -= offset;
+
+		/* a record can never legally be this long */
+		if (window_len == sizeof (window)) {
 			g_set_error_literal (error, 1, 0,
-					     "invalid checksum");
+					     "invalid inhx32 syntax");
 			return FALSE;
 		}
+	}
 
-		/* process different record types */
-		switch (type) {
-		case CH_RECORD_TYPE_DATA:
-			/* if not contiguous with previous record,
-			 * issue accumulated hex data (if any) and start anew. */
-			if ((addr_high + addr_low) != addr32)
-				addr32 = addr_high + addr_low;
-
-			/* Parse bytes from line into hexBuf */
-			for (i = offset + 9; i < end; i += 2) {
-				if (addr32 >= runcode_addr &&
-				    addr32 < 0xfff0) {
-
-					/* find out if there are any
-					 * holes in the hex record */
-					len_tmp = addr32 - addr32_last;
-					if (addr32_last > 0x0 && len_tmp > 1) {
-						for (j = 1; j < len_tmp; j++) {
-							if (verbose) {
-								g_debug ("Filling address 0x%04x",
-									 addr32_last + j);
-							}
-							/* although 0xff might be clearer,
-							 * we can't write 0xffff to pic14 */
-							g_string_append_c (string, 0x00);
-						}
-					}
-					data_tmp = ch_inhx32_parse_uint8 (in_buffer, i);
-					g_string_append_c (string, data_tmp);
-					if (verbose)
-						g_debug ("Writing address 0x%04x", addr32);
-					addr32_last = addr32;
-				} else {
-					if (verbose)
-						g_debug ("Ignoring address 0x%04x", addr32);
-				}
-				addr32++;
-			}
-			break;
-		case CH_RECORD_TYPE_EOF:
-			break;
-		case CH_RECORD_TYPE_EXTENDED:
-			if (sscanf (&in_buffer[offset+9], "%04x", &addr_high) != 1) {
-				g_set_error_literal (error, 1, 0,
-						     "invalid hex syntax");
-				return FALSE;
-			}
-			addr_high <<= 16;
-			addr32 = addr_high + addr_low;
-			break;
-		default:
+	/* a trailing partial record is invalid */
+	for (i = 0; i < window_len; i++) {
+		if (window[i] == ':') {
 			g_set_error_literal (error, 1, 0,
-					     "invalid record type");
+					     "invalid inhx32 syntax");
 			return FALSE;
 		}
-
-		/* advance to start of next line */
-		ptr = strchr (&in_buffer[end+2], ':');
-		if (ptr == NULL)
-			break;
-		offset = ptr - in_buffer;
 	}
-
-	/* pad out to device size so we can read back a verifiable blob */
-	for (i = string->len; i < runcode_addr; i++)
-		g_string_append_len (string, "\0", 1);
-
-	/* save data */
-	if (out_size != NULL)
-		*out_size = string->len;
-	if (out_buffer != NULL)
-		*out_buffer = g_memdup (string->str, string->len);
-	return TRUE;
+	return ch_inhx32_context_save (&ctx, out_buffer, out_size);
 }
 
 /**
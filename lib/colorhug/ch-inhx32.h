@@ -27,6 +27,7 @@
 #define __CH_INHX32_H
 
 #include <glib.h>
+#include <gio/gio.h>
 
 #include "ch-common.h"
 
@@ -43,6 +44,13 @@ gboolean	 ch_inhx32_to_bin_full		(const gchar	*in_buffer,
 						 guint16	 runcode_addr,
 						 GError		**error)
 						 G_GNUC_WARN_UNUSED_RESULT;
+gboolean	 ch_inhx32_to_bin_stream	(GInputStream	*stream,
+						 guint8		**out_buffer,
+						 gsize		*out_size,
+						 guint16	 runcode_addr,
+						 GCancellable	*cancellable,
+						 GError		**error)
+						 G_GNUC_WARN_UNUSED_RESULT;
 
 G_END_DECLS
 
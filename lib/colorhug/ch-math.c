@@ -101,6 +101,64 @@ ch_double_to_packed_float (gdouble value, ChPackedFloat *pf)
 	ch_packed_float_set_value (pf, value * (gdouble) 0x10000);
 }
 
+/**
+ * ch_packed_float_to_double_array:
+ *
+ * @pf: (array length=len): packed values to host byte order
+ * @value: (array length=len): values in IEEE floating point format
+ * @len: the number of values to convert
+ *
+ * Converts a contiguous buffer of packed floats to doubles.
+ *
+ * This is the bulk version of ch_packed_float_to_double() for use when
+ * streaming samples; the per-value argument checks are hoisted out of
+ * the loop so the compiler is free to vectorize the shift and scale.
+ *
+ * Since: 1.4.6
+ **/
+void
+ch_packed_float_to_double_array (const ChPackedFloat *pf,
+				 gdouble *value,
+				 gsize len)
+{
+	gsize i;
+
+	g_return_if_fail (value != NULL);
+	g_return_if_fail (pf != NULL);
+
+	for (i = 0; i < len; i++)
+		value[i] = ch_packed_float_get_value (&pf[i]) / (gdouble) 0x10000;
+}
+
+/**
+ * ch_double_to_packed_float_array:
+ *
+ * @value: (array length=len): values in IEEE floating point format
+ * @pf: (array length=len): packed values in device byte order
+ * @len: the number of values to convert
+ *
+ * Converts a contiguous buffer of doubles to packed floats, clamping
+ * each value to the representable range of -32768 to +32768.
+ *
+ * Since: 1.4.6
+ **/
+void
+ch_double_to_packed_float_array (const gdouble *value,
+				 ChPackedFloat *pf,
+				 gsize len)
+{
+	gdouble tmp;
+	gsize i;
+
+	g_return_if_fail (value != NULL);
+	g_return_if_fail (pf != NULL);
+
+	for (i = 0; i < len; i++) {
+		tmp = CLAMP (value[i], -32768.f, 32768.f);
+		ch_packed_float_set_value (&pf[i], tmp * (gdouble) 0x10000);
+	}
+}
+
 /**
  * ch_packed_float_add:
  *
@@ -190,3 +248,62 @@ ch_packed_float_multiply (const ChPackedFloat *pf1,
 	ch_packed_float_set_value (result, tmp);
 	return CH_ERROR_NONE;
 }
+
+/**
+ * ch_packed_float_apply_matrix:
+ *
+ * @mat: (array fixed-size=9): a 3x3 calibration matrix in row order
+ * @data: (array length=len): samples, each of three packed floats
+ * @result: (array length=len): destination, may be the same as @data
+ * @len: the number of samples, not the number of values
+ *
+ * Multiplies each three channel sample by a 3x3 calibration matrix
+ * using only integer maths.
+ *
+ * This is the bulk version of ch_packed_float_multiply() for applying
+ * device calibration to a stream of readings; the accumulation is done
+ * in 64 bits so the per-term overflow checks and 16 bit long
+ * multiplication are not needed in the inner loop.
+ *
+ * Return value: an error code
+ *
+ * Since: 1.4.6
+ **/
+ChError
+ch_packed_float_apply_matrix (const ChPackedFloat *mat,
+			      const ChPackedFloat *data,
+			      ChPackedFloat *result,
+			      gsize len)
+{
+	gint64 acc[3];
+	gint64 m[9];
+	gsize i;
+	guint j;
+	guint k;
+
+	g_return_val_if_fail (mat != NULL, CH_ERROR_INVALID_VALUE);
+	g_return_val_if_fail (data != NULL, CH_ERROR_INVALID_VALUE);
+	g_return_val_if_fail (result != NULL, CH_ERROR_INVALID_VALUE);
+
+	/* unpack the matrix just once */
+	for (j = 0; j < 9; j++)
+		m[j] = ch_packed_float_get_value (&mat[j]);
+
+	for (i = 0; i < len; i++) {
+		/* accumulate the whole sample before writing anything so
+		 * @result can alias @data */
+		for (j = 0; j < 3; j++) {
+			acc[j] = 0;
+			for (k = 0; k < 3; k++) {
+				acc[j] += m[j * 3 + k] *
+					  (gint64) ch_packed_float_get_value (&data[i * 3 + k]);
+			}
+			acc[j] /= 0x10000;
+			if (acc[j] > G_MAXINT32 || acc[j] < G_MININT32)
+				return CH_ERROR_OVERFLOW_MULTIPLY;
+		}
+		for (j = 0; j < 3; j++)
+			ch_packed_float_set_value (&result[i * 3 + j], acc[j]);
+	}
+	return CH_ERROR_NONE;
+}
@@ -55,6 +55,12 @@ void		 ch_packed_float_to_double	(const ChPackedFloat	*pf,
 						 gdouble		*value);
 void		 ch_double_to_packed_float	(gdouble		 value,
 						 ChPackedFloat		*pf);
+void		 ch_packed_float_to_double_array (const ChPackedFloat	*pf,
+						 gdouble		*value,
+						 gsize			 len);
+void		 ch_double_to_packed_float_array (const gdouble		*value,
+						 ChPackedFloat		*pf,
+						 gsize			 len);
 
 ChError		 ch_packed_float_add		(const ChPackedFloat	*pf1,
 						 const ChPackedFloat	*pf2,
@@ -62,6 +68,10 @@ ChError		 ch_packed_float_add		(const ChPackedFloat	*pf1,
 ChError		 ch_packed_float_multiply	(const ChPackedFloat	*pf1,
 						 const ChPackedFloat	*pf2,
 						 ChPackedFloat		*result);
+ChError		 ch_packed_float_apply_matrix	(const ChPackedFloat	*mat,
+						 const ChPackedFloat	*data,
+						 ChPackedFloat		*result,
+						 gsize			 len);
 
 G_END_DECLS
 
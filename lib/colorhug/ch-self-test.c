@@ -32,6 +32,7 @@
 #include "ch-hash.h"
 #include "ch-device.h"
 #include "ch-device-queue.h"
+#include "ch-inhx32.h"
 
 static void
 ch_test_hash_func (void)
@@ -437,6 +438,44 @@ ch_test_math_multiply_func (void)
 	g_assert_cmpint (rc, ==, CH_ERROR_OVERFLOW_MULTIPLY);
 }
 
+static void
+ch_test_math_batch_func (void)
+{
+	ChPackedFloat mat[9];
+	ChPackedFloat pf[64 * 3];
+	const gdouble mat_values[9] = { 0.5f, 0.0f, 0.0f,
+					0.0f, 1.0f, 0.0f,
+					0.0f, 0.0f, 2.0f };
+	gdouble values[64 * 3];
+	gdouble tmp[64 * 3];
+	guint i;
+	guint8 rc;
+
+	/* round-trip a buffer of values through the batch converters */
+	for (i = 0; i < 64 * 3; i++)
+		values[i] = ((gdouble) i / 7.5f) - 12.0f;
+	ch_double_to_packed_float_array (values, pf, 64 * 3);
+	ch_packed_float_to_double_array (pf, tmp, 64 * 3);
+	for (i = 0; i < 64 * 3; i++) {
+		g_assert_cmpfloat (tmp[i], >, values[i] - 0.001);
+		g_assert_cmpfloat (tmp[i], <, values[i] + 0.001);
+	}
+
+	/* apply a trivial calibration matrix to each sample in place */
+	ch_double_to_packed_float_array (mat_values, mat, 9);
+	rc = ch_packed_float_apply_matrix (mat, pf, pf, 64);
+	g_assert_cmpint (rc, ==, CH_ERROR_NONE);
+	ch_packed_float_to_double_array (pf, tmp, 64 * 3);
+	for (i = 0; i < 64; i++) {
+		g_assert_cmpfloat (tmp[i * 3 + 0], >, values[i * 3 + 0] * 0.5f - 0.001);
+		g_assert_cmpfloat (tmp[i * 3 + 0], <, values[i * 3 + 0] * 0.5f + 0.001);
+		g_assert_cmpfloat (tmp[i * 3 + 1], >, values[i * 3 + 1] - 0.001);
+		g_assert_cmpfloat (tmp[i * 3 + 1], <, values[i * 3 + 1] + 0.001);
+		g_assert_cmpfloat (tmp[i * 3 + 2], >, values[i * 3 + 2] * 2.0f - 0.001);
+		g_assert_cmpfloat (tmp[i * 3 + 2], <, values[i * 3 + 2] * 2.0f + 0.001);
+	}
+}
+
 static GUsbDevice *
 ch_client_get_default (GError **error)
 {
@@ -1228,6 +1267,48 @@ out:
 	}
 }
 
+static void
+ch_test_inhx32_func (void)
+{
+	const gchar *hex_data =
+		":10C0000000112233445566778899AABBCCDDEEFF38\n"
+		":00000001FF\n";
+	gboolean ret;
+	gsize len = 0;
+	gsize len_stream = 0;
+	g_autofree guint8 *data = NULL;
+	g_autofree guint8 *data_stream = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GInputStream) stream = NULL;
+
+	/* parse a tiny image in one go */
+	ret = ch_inhx32_to_bin_full (hex_data, &data, &len, 0xc000, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	g_assert_cmpint (len, ==, 0xc000);
+	g_assert_cmpint (data[0], ==, 0x00);
+	g_assert_cmpint (data[3], ==, 0x33);
+	g_assert_cmpint (data[15], ==, 0xff);
+	g_assert_cmpint (data[16], ==, 0x00);
+
+	/* the streaming variant has to produce the same blob */
+	stream = g_memory_input_stream_new_from_data (hex_data,
+						      strlen (hex_data),
+						      NULL);
+	ret = ch_inhx32_to_bin_stream (stream, &data_stream, &len_stream,
+				       0xc000, NULL, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	g_assert_cmpint (len_stream, ==, len);
+	g_assert (memcmp (data_stream, data, len) == 0);
+
+	/* a corrupt record has to be rejected */
+	ret = ch_inhx32_to_bin_full (":10C0000000112233445566778899AABBCCDDEEFF39\n",
+				     NULL, NULL, 0xc000, &error);
+	g_assert_error (error, 1, 0);
+	g_assert (!ret);
+}
+
 static void
 ch_test_firmware_func (void)
 {
@@ -1254,6 +1335,140 @@ ch_test_firmware_func (void)
 	g_assert_cmpint (device_mode, ==, CH_DEVICE_MODE_FIRMWARE2);
 }
 
+static void
+ch_test_benchmark_device_queue_func (void)
+{
+	const guint queue_depths[] = { 1, 16, 256 };
+	gboolean ret;
+	guint i;
+	guint j;
+	static guint8 buf[8];
+	GPtrArray *devices;
+	GUsbContext *usb_ctx;
+	GUsbDevice *device;
+	ChDeviceQueue *device_queue;
+	g_autoptr(GError) error = NULL;
+
+	/* all the replies are emulated without any latency, so any USB
+	 * device works as a loopback handle */
+	g_setenv ("COLORHUG_EMULATE", "1", TRUE);
+	g_setenv ("COLORHUG_EMULATE_DELAY", "0", TRUE);
+	usb_ctx = g_usb_context_new (NULL);
+	g_assert (usb_ctx != NULL);
+	devices = g_usb_context_get_devices (usb_ctx);
+	if (devices->len == 0) {
+		g_test_skip ("no USB devices to use as a loopback handle");
+		goto out;
+	}
+	device = g_ptr_array_index (devices, 0);
+
+	device_queue = ch_device_queue_new ();
+	for (i = 0; i < G_N_ELEMENTS (queue_depths); i++) {
+		guint depth = queue_depths[i];
+		guint runs = 2048 / depth;
+		guint total = runs * depth;
+		guint run;
+		gdouble elapsed;
+
+		g_test_timer_start ();
+		for (run = 0; run < runs; run++) {
+			for (j = 0; j < depth; j++) {
+				ch_device_queue_add (device_queue,
+						     device,
+						     CH_CMD_GET_HARDWARE_VERSION,
+						     NULL,
+						     0,
+						     buf,
+						     sizeof (buf));
+			}
+			ret = ch_device_queue_process (device_queue,
+						       CH_DEVICE_QUEUE_PROCESS_FLAGS_NONE,
+						       NULL,
+						       &error);
+			g_assert_no_error (error);
+			g_assert (ret);
+		}
+		elapsed = g_test_timer_elapsed ();
+		g_test_maximized_result (total / elapsed,
+					 "depth %3u: %.0f commands/sec",
+					 depth, total / elapsed);
+	}
+	g_object_unref (device_queue);
+out:
+	g_ptr_array_unref (devices);
+	g_object_unref (usb_ctx);
+	g_unsetenv ("COLORHUG_EMULATE_DELAY");
+	g_unsetenv ("COLORHUG_EMULATE");
+}
+
+static void
+ch_test_benchmark_math_convert_func (void)
+{
+	const guint sz = 4096;
+	const guint iterations = 1000;
+	guint i;
+	gdouble elapsed;
+	g_autofree gdouble *values_in = NULL;
+	g_autofree gdouble *values_out = NULL;
+	g_autofree ChPackedFloat *pf = NULL;
+
+	values_in = g_new0 (gdouble, sz);
+	values_out = g_new0 (gdouble, sz);
+	pf = g_new0 (ChPackedFloat, sz);
+	for (i = 0; i < sz; i++)
+		values_in[i] = (gdouble) i / 64.0f - 16.0f;
+
+	g_test_timer_start ();
+	for (i = 0; i < iterations; i++) {
+		ch_double_to_packed_float_array (values_in, pf, sz);
+		ch_packed_float_to_double_array (pf, values_out, sz);
+	}
+	elapsed = g_test_timer_elapsed ();
+	g_test_maximized_result ((gdouble) iterations * sz * 2 / elapsed,
+				 "%.0f conversions/sec",
+				 (gdouble) iterations * sz * 2 / elapsed);
+}
+
+static void
+ch_test_benchmark_inhx32_func (void)
+{
+	const guint iterations = 100;
+	const guint n_records = 1024;
+	gboolean ret;
+	guint i;
+	guint j;
+	gdouble elapsed;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GString) str = NULL;
+
+	/* build a 16k image of valid records */
+	str = g_string_sized_new (n_records * 44);
+	for (i = 0; i < n_records; i++) {
+		guint16 addr = 0xc000 + i * 16;
+		guint8 sum = 0x10 + (addr >> 8) + (addr & 0xff);
+		g_string_append_printf (str, ":10%04X00", addr);
+		for (j = 0; j < 16; j++) {
+			guint8 value = (i + j) & 0xff;
+			sum += value;
+			g_string_append_printf (str, "%02X", value);
+		}
+		g_string_append_printf (str, "%02X\n", (guint8) (0x100 - sum));
+	}
+	g_string_append (str, ":00000001FF\n");
+
+	g_test_timer_start ();
+	for (i = 0; i < iterations; i++) {
+		ret = ch_inhx32_to_bin_full (str->str, NULL, NULL,
+					     0xc000, &error);
+		g_assert_no_error (error);
+		g_assert (ret);
+	}
+	elapsed = g_test_timer_elapsed ();
+	g_test_maximized_result ((gdouble) iterations * str->len / elapsed,
+				 "%.0f bytes/sec",
+				 (gdouble) iterations * str->len / elapsed);
+}
+
 int
 main (int argc, char **argv)
 {
@@ -1268,13 +1483,25 @@ main (int argc, char **argv)
 	g_test_add_func ("/ColorHug/math-convert", ch_test_math_convert_func);
 	g_test_add_func ("/ColorHug/math-add", ch_test_math_add_func);
 	g_test_add_func ("/ColorHug/math-multiply", ch_test_math_multiply_func);
+	g_test_add_func ("/ColorHug/math-batch", ch_test_math_batch_func);
 	g_test_add_func ("/ColorHug/state", ch_test_state_func);
 	g_test_add_func ("/ColorHug/eeprom", ch_test_eeprom_func);
 	g_test_add_func ("/ColorHug/reading", ch_test_reading_func);
 	g_test_add_func ("/ColorHug/reading-xyz", ch_test_reading_xyz_func);
 	g_test_add_func ("/ColorHug/device-incomplete-request", ch_test_incomplete_request_func);
+	g_test_add_func ("/ColorHug/inhx32", ch_test_inhx32_func);
 	g_test_add_func ("/ColorHug/firmware", ch_test_firmware_func);
 
+	/* run with '-m perf' to get benchmark numbers */
+	if (g_test_perf ()) {
+		g_test_add_func ("/ColorHug/benchmark/device-queue",
+				 ch_test_benchmark_device_queue_func);
+		g_test_add_func ("/ColorHug/benchmark/math-convert",
+				 ch_test_benchmark_math_convert_func);
+		g_test_add_func ("/ColorHug/benchmark/inhx32",
+				 ch_test_benchmark_inhx32_func);
+	}
+
 	return g_test_run ();
 }
 
@@ -195,6 +195,26 @@ cd_main_sender_authenticated (GDBusConnection *connection,
 }
 
 
+/* returns a refcounted interned copy of @str; identical device ids,
+ * object paths and metadata keys all share one allocation and the table
+ * entry goes away when the last user releases it */
+gchar *
+cd_main_intern_string (const gchar *str)
+{
+	if (str == NULL)
+		return NULL;
+	return g_ref_string_new_intern (str);
+}
+
+/* NULL-safe release for strings from cd_main_intern_string(), also
+ * usable as a GDestroyNotify */
+void
+cd_main_intern_release (gchar *str)
+{
+	if (str != NULL)
+		g_ref_string_release (str);
+}
+
 gboolean
 cd_main_mkdir_with_parents (const gchar *filename, GError **error)
 {
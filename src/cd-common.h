@@ -55,6 +55,8 @@ guint		 cd_main_get_sender_pid		(GDBusConnection *connection,
 						 GError		**error)
 						 G_GNUC_WARN_UNUSED_RESULT;
 gchar		*cd_main_ensure_dbus_path	(const gchar	*object_path);
+gchar		*cd_main_intern_string		(const gchar	*str);
+void		 cd_main_intern_release		(gchar		*str);
 gboolean	 cd_main_mkdir_with_parents	(const gchar	*filename,
 						 GError		**error)
 						 G_GNUC_WARN_UNUSED_RESULT;
@@ -31,6 +31,23 @@
 
 static gboolean _verbose = FALSE;
 static gboolean _console = FALSE;
+static gboolean _trace = FALSE;
+static gint _enabled = -1;	/* tri-state; -1 until first evaluated */
+
+/* the last operations are always recorded here, whether or not tracing
+ * is printing them, so a latency spike can be examined after the fact
+ * without restarting the daemon with verbose logging */
+typedef struct {
+	gint64		 begin;		/* monotonic, us */
+	gint64		 duration;	/* us */
+	gchar		 name[48];
+} CdDebugEvent;
+
+#define CD_DEBUG_RING_SIZE	512
+static CdDebugEvent _ring[CD_DEBUG_RING_SIZE];
+static guint _ring_head = 0;
+static guint _ring_len = 0;
+G_LOCK_DEFINE_STATIC (_ring);
 
 gboolean
 cd_debug_is_verbose (void)
@@ -45,6 +62,90 @@ cd_debug_is_verbose (void)
 	return FALSE;
 }
 
+/* the predicate behind CD_DEBUG(); the getenv() lookup is done once and
+ * cached so the steady-state cost is a single predictable branch */
+gboolean
+cd_debug_is_enabled (void)
+{
+	if (G_UNLIKELY (_enabled == -1))
+		_enabled = cd_debug_is_verbose () ? 1 : 0;
+	return _enabled == 1;
+}
+
+gboolean
+cd_debug_is_tracing (void)
+{
+	/* local first */
+	if (_trace)
+		return TRUE;
+
+	/* fall back to env variable */
+	if (g_getenv ("COLORD_TRACE") != NULL)
+		return TRUE;
+	return FALSE;
+}
+
+gint64
+cd_debug_trace_begin (void)
+{
+	return g_get_monotonic_time ();
+}
+
+void
+cd_debug_trace_end (gint64 begin, const gchar *format, ...)
+{
+	CdDebugEvent *event;
+	va_list args;
+
+	if (begin == 0)
+		return;
+
+	/* record into the ring unconditionally; the name is formatted
+	 * straight into the fixed-size slot so the steady state does not
+	 * allocate */
+	G_LOCK (_ring);
+	event = &_ring[_ring_head];
+	_ring_head = (_ring_head + 1) % CD_DEBUG_RING_SIZE;
+	if (_ring_len < CD_DEBUG_RING_SIZE)
+		_ring_len++;
+	event->begin = begin;
+	event->duration = g_get_monotonic_time () - begin;
+	va_start (args, format);
+	g_vsnprintf (event->name, sizeof (event->name), format, args);
+	va_end (args);
+
+	/* one machine-parsable line per operation, written straight to
+	 * stdout so the act of tracing does not distort the timing the
+	 * way routing through the journal would */
+	if (cd_debug_is_tracing ()) {
+		g_print ("CdTrace: %" G_GINT64_FORMAT " +%" G_GINT64_FORMAT " %s\n",
+			 event->begin,
+			 event->duration,
+			 event->name);
+	}
+	G_UNLOCK (_ring);
+}
+
+void
+cd_debug_ring_dump (void)
+{
+	guint i;
+	guint idx;
+
+	/* oldest first, in the same format as live tracing */
+	G_LOCK (_ring);
+	g_print ("CdDebug: last %u operations:\n", _ring_len);
+	for (i = 0; i < _ring_len; i++) {
+		idx = (_ring_head + CD_DEBUG_RING_SIZE - _ring_len + i) %
+			CD_DEBUG_RING_SIZE;
+		g_print ("CdTrace: %" G_GINT64_FORMAT " +%" G_GINT64_FORMAT " %s\n",
+			 _ring[idx].begin,
+			 _ring[idx].duration,
+			 _ring[idx].name);
+	}
+	G_UNLOCK (_ring);
+}
+
 
 static void
 cd_debug_ignore_cb (const gchar *log_domain,
@@ -144,6 +245,9 @@ cd_debug_pre_parse_hook (GOptionContext *context,
 		{ "verbose", 'v', 0, G_OPTION_ARG_NONE, &_verbose,
 		  /* TRANSLATORS: turn on all debugging */
 		  N_("Show debugging information for all files"), NULL },
+		{ "trace", '\0', 0, G_OPTION_ARG_NONE, &_trace,
+		  /* TRANSLATORS: print timing for expensive operations */
+		  N_("Show timing traces for expensive operations"), NULL },
 		{ NULL}
 	};
 
@@ -163,6 +267,9 @@ cd_debug_destroy (void)
 void
 cd_debug_setup (gboolean enabled)
 {
+	/* keep the cached CD_DEBUG() predicate in step */
+	_enabled = (enabled || cd_debug_is_verbose ()) ? 1 : 0;
+
 	if (enabled) {
 		g_log_set_fatal_mask (NULL, G_LOG_LEVEL_ERROR |
 					    G_LOG_LEVEL_CRITICAL);
@@ -25,8 +25,30 @@
 #include <glib.h>
 
 gboolean	 cd_debug_is_verbose		(void);
+gboolean	 cd_debug_is_enabled		(void);
 GOptionGroup	*cd_debug_get_option_group	(void);
 void		 cd_debug_setup			(gboolean	 enabled);
 void		 cd_debug_destroy		(void);
+gboolean	 cd_debug_is_tracing		(void);
+gint64		 cd_debug_trace_begin		(void);
+void		 cd_debug_trace_end		(gint64		 begin,
+						 const gchar	*format,
+						 ...)
+						 G_GNUC_PRINTF (2, 3);
+void		 cd_debug_ring_dump		(void);
+
+/* guards per-item logging in hot loops; unlike a bare g_debug() the
+ * format arguments are never evaluated and no handler is dispatched
+ * unless verbose debugging is actually on, and the whole statement
+ * compiles away in G_DISABLE_DEBUG builds */
+#ifdef G_DISABLE_DEBUG
+#define CD_DEBUG(...)	do { } while (0)
+#else
+#define CD_DEBUG(...) \
+	do { \
+		if (G_UNLIKELY (cd_debug_is_enabled ())) \
+			g_debug (__VA_ARGS__); \
+	} while (0)
+#endif
 
 #endif /* __CD_DEBUG_H__ */
@@ -33,6 +33,9 @@ static void     cd_device_array_finalize	(GObject     *object);
 typedef struct
 {
 	GPtrArray			*array;
+	GHashTable			*hash_id;		/* of id:GPtrArray of CdDevice */
+	GHashTable			*hash_object_path;	/* of object path:CdDevice */
+	GHashTable			*cache_variant;		/* of uid:object path array */
 } CdDeviceArrayPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (CdDeviceArray, cd_device_array, G_TYPE_OBJECT)
@@ -43,22 +46,54 @@ void
 cd_device_array_add (CdDeviceArray *device_array, CdDevice *device)
 {
 	CdDeviceArrayPrivate *priv = GET_PRIVATE (device_array);
+	GPtrArray *bucket;
 
 	g_return_if_fail (CD_IS_DEVICE_ARRAY (device_array));
 	g_return_if_fail (CD_IS_DEVICE (device));
 
 	g_ptr_array_add (priv->array,
 			 g_object_ref (device));
+
+	/* the indexes hold no references; the array does that for us and
+	 * the entries are removed before the array drops its reference */
+	bucket = g_hash_table_lookup (priv->hash_id,
+				      cd_device_get_id (device));
+	if (bucket == NULL) {
+		bucket = g_ptr_array_new ();
+		g_hash_table_insert (priv->hash_id,
+				     g_strdup (cd_device_get_id (device)),
+				     bucket);
+	}
+	g_ptr_array_add (bucket, device);
+	g_hash_table_insert (priv->hash_object_path,
+			     g_strdup (cd_device_get_object_path (device)),
+			     device);
+	g_hash_table_remove_all (priv->cache_variant);
 }
 
 void
 cd_device_array_remove (CdDeviceArray *device_array, CdDevice *device)
 {
 	CdDeviceArrayPrivate *priv = GET_PRIVATE (device_array);
+	GPtrArray *bucket;
 
 	g_return_if_fail (CD_IS_DEVICE_ARRAY (device_array));
 	g_return_if_fail (CD_IS_DEVICE (device));
 
+	/* remove from the indexes first as the array may hold the last
+	 * reference to the device */
+	bucket = g_hash_table_lookup (priv->hash_id,
+				      cd_device_get_id (device));
+	if (bucket != NULL) {
+		g_ptr_array_remove (bucket, device);
+		if (bucket->len == 0) {
+			g_hash_table_remove (priv->hash_id,
+					     cd_device_get_id (device));
+		}
+	}
+	g_hash_table_remove (priv->hash_object_path,
+			     cd_device_get_object_path (device));
+	g_hash_table_remove_all (priv->cache_variant);
 	g_ptr_array_remove (priv->array,
 			    device);
 }
@@ -71,22 +106,21 @@ cd_device_array_get_by_id_owner (CdDeviceArray *device_array,
 {
 	CdDeviceArrayPrivate *priv = GET_PRIVATE (device_array);
 	CdDevice *device_tmp;
+	GPtrArray *bucket;
 	guint i;
 
-	/* find device */
-	for (i = 0; i < priv->array->len; i++) {
-		device_tmp = g_ptr_array_index (priv->array, i);
-		if (cd_device_get_owner (device_tmp) != owner)
-			continue;
-		if (g_strcmp0 (cd_device_get_id (device_tmp), id) == 0)
+	/* find all the devices with this ID */
+	bucket = g_hash_table_lookup (priv->hash_id, id);
+	if (bucket == NULL)
+		return NULL;
+	for (i = 0; i < bucket->len; i++) {
+		device_tmp = g_ptr_array_index (bucket, i);
+		if (cd_device_get_owner (device_tmp) == owner)
 			return g_object_ref (device_tmp);
 	}
 	if (flags & CD_DEVICE_ARRAY_FLAG_OWNER_OPTIONAL) {
-		for (i = 0; i < priv->array->len; i++) {
-			device_tmp = g_ptr_array_index (priv->array, i);
-			if (g_strcmp0 (cd_device_get_id (device_tmp), id) == 0)
-				return g_object_ref (device_tmp);
-		}
+		device_tmp = g_ptr_array_index (bucket, 0);
+		return g_object_ref (device_tmp);
 	}
 	return NULL;
 }
@@ -97,15 +131,12 @@ cd_device_array_get_by_object_path (CdDeviceArray *device_array,
 {
 	CdDeviceArrayPrivate *priv = GET_PRIVATE (device_array);
 	CdDevice *device_tmp;
-	guint i;
 
 	/* find device */
-	for (i = 0; i < priv->array->len; i++) {
-		device_tmp = g_ptr_array_index (priv->array, i);
-		if (g_strcmp0 (cd_device_get_object_path (device_tmp), object_path) == 0)
-			return g_object_ref (device_tmp);
-	}
-	return NULL;
+	device_tmp = g_hash_table_lookup (priv->hash_object_path, object_path);
+	if (device_tmp == NULL)
+		return NULL;
+	return g_object_ref (device_tmp);
 }
 
 CdDevice *
@@ -135,6 +166,52 @@ cd_device_array_get_array (CdDeviceArray *device_array)
 	return g_ptr_array_ref (priv->array);
 }
 
+GVariant *
+cd_device_array_get_variant (CdDeviceArray *device_array, guint uid)
+{
+	CdDeviceArrayPrivate *priv = GET_PRIVATE (device_array);
+	CdDevice *device;
+	GVariant *value;
+	guint i;
+	guint length = 0;
+	g_autofree GVariant **variant_array = NULL;
+
+	/* the array only changes when a device is added or removed, so
+	 * steady-state enumerations cost a refcount bump */
+	value = g_hash_table_lookup (priv->cache_variant,
+				     GUINT_TO_POINTER (uid));
+	if (value != NULL)
+		return g_variant_ref (value);
+
+	/* copy the object paths */
+	variant_array = g_new0 (GVariant *, priv->array->len + 1);
+	for (i = 0; i < priv->array->len; i++) {
+		device = g_ptr_array_index (priv->array, i);
+
+		/* only show devices created by root and the calling
+		 * user, but if called *by* root return all devices
+		 * from all users */
+		if (uid != 0) {
+			if (cd_device_get_owner (device) != 0 &&
+			    cd_device_get_owner (device) != uid)
+				continue;
+		}
+
+		variant_array[length] = g_variant_new_object_path (
+			cd_device_get_object_path (device));
+		length++;
+	}
+
+	/* format the value */
+	value = g_variant_ref_sink (g_variant_new_array (G_VARIANT_TYPE_OBJECT_PATH,
+							 variant_array,
+							 length));
+	g_hash_table_insert (priv->cache_variant,
+			     GUINT_TO_POINTER (uid),
+			     value);
+	return g_variant_ref (value);
+}
+
 GPtrArray *
 cd_device_array_get_by_kind (CdDeviceArray *device_array,
 			     CdDeviceKind kind)
@@ -169,6 +246,14 @@ cd_device_array_init (CdDeviceArray *device_array)
 {
 	CdDeviceArrayPrivate *priv = GET_PRIVATE (device_array);
 	priv->array = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
+	priv->hash_id = g_hash_table_new_full (g_str_hash, g_str_equal,
+					       g_free,
+					       (GDestroyNotify) g_ptr_array_unref);
+	priv->hash_object_path = g_hash_table_new_full (g_str_hash, g_str_equal,
+							g_free, NULL);
+	priv->cache_variant = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+						     NULL,
+						     (GDestroyNotify) g_variant_unref);
 }
 
 static void
@@ -177,6 +262,9 @@ cd_device_array_finalize (GObject *object)
 	CdDeviceArray *device_array = CD_DEVICE_ARRAY (object);
 	CdDeviceArrayPrivate *priv = GET_PRIVATE (device_array);
 
+	g_hash_table_unref (priv->hash_id);
+	g_hash_table_unref (priv->hash_object_path);
+	g_hash_table_unref (priv->cache_variant);
 	g_ptr_array_unref (priv->array);
 
 	G_OBJECT_CLASS (cd_device_array_parent_class)->finalize (object);
@@ -58,6 +58,8 @@ CdDevice	*cd_device_array_get_by_property	(CdDeviceArray	*device_array,
 							 const gchar	*key,
 							 const gchar	*value);
 GPtrArray	*cd_device_array_get_array		(CdDeviceArray	*device_array);
+GVariant	*cd_device_array_get_variant		(CdDeviceArray	*device_array,
+							 guint		 uid);
 GPtrArray	*cd_device_array_get_by_kind		(CdDeviceArray	*device_array,
 							 CdDeviceKind	 kind);
 
@@ -35,47 +35,59 @@ static void     cd_device_db_finalize	(GObject        *object);
 typedef struct
 {
 	sqlite3			*db;
+	gboolean		 db_owned;
+	sqlite3_stmt		*stmt_add;
+	sqlite3_stmt		*stmt_set_property;
+	sqlite3_stmt		*stmt_remove_device;
+	sqlite3_stmt		*stmt_remove_properties;
+	sqlite3_stmt		*stmt_get_property;
+	sqlite3_stmt		*stmt_get_devices;
+	sqlite3_stmt		*stmt_get_properties;
+	sqlite3_stmt		*stmt_get_all_properties;
+	GHashTable		*props_cache;	/* device_id -> { property -> value } */
 } CdDeviceDbPrivate;
 
 static gpointer cd_device_db_object = NULL;
 
 G_DEFINE_TYPE_WITH_PRIVATE (CdDeviceDb, cd_device_db, G_TYPE_OBJECT)
 
-gboolean  
-cd_device_db_load (CdDeviceDb *ddb,
-		    const gchar *filename,
-		    GError  **error)
+static gboolean
+cd_device_db_prepare (CdDeviceDb *ddb,
+		      const gchar *sql,
+		      sqlite3_stmt **stmt,
+		      GError **error)
 {
 	CdDeviceDbPrivate *priv = GET_PRIVATE (ddb);
-	const gchar *statement;
-	gchar *error_msg = NULL;
 	gint rc;
-	g_autofree gchar *path = NULL;
-
-	g_return_val_if_fail (CD_IS_DEVICE_DB (ddb), FALSE);
-	g_return_val_if_fail (priv->db == NULL, FALSE);
 
-	/* ensure the path exists */
-	path = g_path_get_dirname (filename);
-	if (!cd_main_mkdir_with_parents (path, error))
-		return FALSE;
-
-	g_debug ("CdDeviceDb: trying to open database '%s'", filename);
-	g_info ("Using device database file %s", filename);
-	rc = sqlite3_open (filename, &priv->db);
+	rc = sqlite3_prepare_v2 (priv->db, sql, -1, stmt, NULL);
 	if (rc != SQLITE_OK) {
 		g_set_error (error,
 			     CD_CLIENT_ERROR,
 			     CD_CLIENT_ERROR_INTERNAL,
-			     "Can't open database: %s\n",
+			     "Failed to prepare statement: SQL error: %s",
 			     sqlite3_errmsg (priv->db));
-		sqlite3_close (priv->db);
 		return FALSE;
 	}
+	return TRUE;
+}
 
-	/* we don't need to keep doing fsync */
-	sqlite3_exec (priv->db, "PRAGMA synchronous=OFF",
-		      NULL, NULL, NULL);
+gboolean
+cd_device_db_load_with_connection (CdDeviceDb *ddb,
+				   sqlite3 *db,
+				   GError  **error)
+{
+	CdDeviceDbPrivate *priv = GET_PRIVATE (ddb);
+	const gchar *statement;
+	gchar *error_msg = NULL;
+	gint rc;
+
+	g_return_val_if_fail (CD_IS_DEVICE_DB (ddb), FALSE);
+	g_return_val_if_fail (priv->db == NULL, FALSE);
+	g_return_val_if_fail (db != NULL, FALSE);
+
+	/* borrowed; whoever opened the connection closes it */
+	priv->db = db;
 
 	/* check devices */
 	rc = sqlite3_exec (priv->db, "SELECT * FROM devices LIMIT 1",
@@ -100,9 +112,149 @@ cd_device_db_load (CdDeviceDb *ddb,
 			    "PRIMARY KEY (device_id, property));";
 		sqlite3_exec (priv->db, statement, NULL, NULL, NULL);
 	}
+
+	/* prepare the statements we run for every device just once, so
+	 * a device-add storm at login does not re-parse the SQL */
+	if (!cd_device_db_prepare (ddb,
+				   "INSERT INTO devices (device_id) VALUES (?1);",
+				   &priv->stmt_add, error))
+		return FALSE;
+	if (!cd_device_db_prepare (ddb,
+				   "INSERT OR REPLACE INTO properties_v2 (device_id, property, value) "
+				   "VALUES (?1, ?2, ?3);",
+				   &priv->stmt_set_property, error))
+		return FALSE;
+	if (!cd_device_db_prepare (ddb,
+				   "DELETE FROM devices WHERE device_id = ?1;",
+				   &priv->stmt_remove_device, error))
+		return FALSE;
+	if (!cd_device_db_prepare (ddb,
+				   "DELETE FROM properties_v2 WHERE device_id = ?1;",
+				   &priv->stmt_remove_properties, error))
+		return FALSE;
+	if (!cd_device_db_prepare (ddb,
+				   "SELECT value FROM properties_v2 WHERE "
+				   "device_id = ?1 AND property = ?2 LIMIT 1;",
+				   &priv->stmt_get_property, error))
+		return FALSE;
+	if (!cd_device_db_prepare (ddb,
+				   "SELECT device_id FROM devices;",
+				   &priv->stmt_get_devices, error))
+		return FALSE;
+	if (!cd_device_db_prepare (ddb,
+				   "SELECT property FROM properties_v2 WHERE device_id = ?1;",
+				   &priv->stmt_get_properties, error))
+		return FALSE;
+	if (!cd_device_db_prepare (ddb,
+				   "SELECT device_id, property, value FROM properties_v2 "
+				   "ORDER BY device_id;",
+				   &priv->stmt_get_all_properties, error))
+		return FALSE;
+	return TRUE;
+}
+
+gboolean
+cd_device_db_preload (CdDeviceDb *ddb,
+		      GError  **error)
+{
+	CdDeviceDbPrivate *priv = GET_PRIVATE (ddb);
+	GHashTable *props = NULL;
+	const gchar *last_id = NULL;
+	gint rc;
+	g_autoptr(GHashTable) cache_tmp = NULL;
+
+	g_return_val_if_fail (CD_IS_DEVICE_DB (ddb), FALSE);
+	g_return_val_if_fail (priv->db != NULL, FALSE);
+
+	/* load every property for every device in one ordered query, so
+	 * restoring hundreds of disk devices at startup does not do one
+	 * round-trip to sqlite per property */
+	g_debug ("CdDeviceDb: preloading all device properties");
+	cache_tmp = g_hash_table_new_full (g_str_hash, g_str_equal,
+					   g_free,
+					   (GDestroyNotify) g_hash_table_unref);
+	sqlite3_reset (priv->stmt_get_all_properties);
+	while ((rc = sqlite3_step (priv->stmt_get_all_properties)) == SQLITE_ROW) {
+		const gchar *device_id = (const gchar *) sqlite3_column_text (priv->stmt_get_all_properties, 0);
+		const gchar *property = (const gchar *) sqlite3_column_text (priv->stmt_get_all_properties, 1);
+		const gchar *value = (const gchar *) sqlite3_column_text (priv->stmt_get_all_properties, 2);
+
+		/* the rows are sorted, so the lookup only happens when the
+		 * device changes; keep the key owned by the cache as it
+		 * outlives the sqlite row buffer */
+		if (last_id == NULL || g_strcmp0 (last_id, device_id) != 0) {
+			gpointer key_tmp = NULL;
+			gpointer props_tmp = NULL;
+			if (!g_hash_table_lookup_extended (cache_tmp, device_id,
+							   &key_tmp, &props_tmp)) {
+				key_tmp = g_strdup (device_id);
+				props_tmp = g_hash_table_new_full (g_str_hash, g_str_equal,
+								   g_free, g_free);
+				g_hash_table_insert (cache_tmp, key_tmp, props_tmp);
+			}
+			props = (GHashTable *) props_tmp;
+			last_id = (const gchar *) key_tmp;
+		}
+		g_hash_table_insert (props, g_strdup (property), g_strdup (value));
+	}
+	if (rc != SQLITE_DONE) {
+		g_set_error (error,
+			     CD_CLIENT_ERROR,
+			     CD_CLIENT_ERROR_INTERNAL,
+			     "SQL error: %s",
+			     sqlite3_errmsg (priv->db));
+		return FALSE;
+	}
+
+	/* all reads are now served from memory; writes keep it coherent */
+	if (priv->props_cache != NULL)
+		g_hash_table_unref (priv->props_cache);
+	priv->props_cache = g_steal_pointer (&cache_tmp);
 	return TRUE;
 }
 
+gboolean
+cd_device_db_load (CdDeviceDb *ddb,
+		    const gchar *filename,
+		    GError  **error)
+{
+	CdDeviceDbPrivate *priv = GET_PRIVATE (ddb);
+	gint rc;
+	sqlite3 *db = NULL;
+	g_autofree gchar *path = NULL;
+
+	g_return_val_if_fail (CD_IS_DEVICE_DB (ddb), FALSE);
+	g_return_val_if_fail (priv->db == NULL, FALSE);
+
+	/* ensure the path exists */
+	path = g_path_get_dirname (filename);
+	if (!cd_main_mkdir_with_parents (path, error))
+		return FALSE;
+
+	g_debug ("CdDeviceDb: trying to open database '%s'", filename);
+	g_info ("Using device database file %s", filename);
+	rc = sqlite3_open (filename, &db);
+	if (rc != SQLITE_OK) {
+		g_set_error (error,
+			     CD_CLIENT_ERROR,
+			     CD_CLIENT_ERROR_INTERNAL,
+			     "Can't open database: %s\n",
+			     sqlite3_errmsg (db));
+		sqlite3_close (db);
+		return FALSE;
+	}
+
+	/* use write-ahead logging so writers do not block readers, and
+	 * only fsync at checkpoint time rather than for every commit */
+	sqlite3_exec (db,
+		      "PRAGMA journal_mode=WAL;"
+		      "PRAGMA synchronous=NORMAL;",
+		      NULL, NULL, NULL);
+
+	priv->db_owned = TRUE;
+	return cd_device_db_load_with_connection (ddb, db, error);
+}
+
 gboolean  
 cd_device_db_empty (CdDeviceDb *ddb,
 		     GError  **error)
@@ -127,6 +279,10 @@ cd_device_db_empty (CdDeviceDb *ddb,
 		sqlite3_free (error_msg);
 		return FALSE;
 	}
+
+	/* keep the preloaded map coherent */
+	if (priv->props_cache != NULL)
+		g_hash_table_remove_all (priv->props_cache);
 	return TRUE;
 }
 
@@ -136,34 +292,26 @@ cd_device_db_add (CdDeviceDb *ddb,
 		  GError  **error)
 {
 	CdDeviceDbPrivate *priv = GET_PRIVATE (ddb);
-	gboolean ret = TRUE;
-	gchar *error_msg = NULL;
-	gchar *statement;
 	gint rc;
 
 	g_return_val_if_fail (CD_IS_DEVICE_DB (ddb), FALSE);
 	g_return_val_if_fail (priv->db != NULL, FALSE);
 
 	g_debug ("CdDeviceDb: add device %s", device_id);
-	statement = sqlite3_mprintf ("INSERT INTO devices (device_id) "
-				     "VALUES ('%q')",
-				     device_id);
 
 	/* insert the entry */
-	rc = sqlite3_exec (priv->db, statement, NULL, NULL, &error_msg);
-	if (rc != SQLITE_OK) {
+	sqlite3_reset (priv->stmt_add);
+	sqlite3_bind_text (priv->stmt_add, 1, device_id, -1, SQLITE_STATIC);
+	rc = sqlite3_step (priv->stmt_add);
+	if (rc != SQLITE_DONE) {
 		g_set_error (error,
 			     CD_CLIENT_ERROR,
 			     CD_CLIENT_ERROR_INTERNAL,
 			     "SQL error: %s",
-			     error_msg);
-		sqlite3_free (error_msg);
-		ret = FALSE;
-		goto out;
+			     sqlite3_errmsg (priv->db));
+		return FALSE;
 	}
-out:
-	sqlite3_free (statement);
-	return ret;
+	return TRUE;
 }
 
 gboolean  
@@ -174,9 +322,6 @@ cd_device_db_set_property (CdDeviceDb *ddb,
 			   GError  **error)
 {
 	CdDeviceDbPrivate *priv = GET_PRIVATE (ddb);
-	gboolean ret = TRUE;
-	gchar *error_msg = NULL;
-	gchar *statement;
 	gint rc;
 
 	g_return_val_if_fail (CD_IS_DEVICE_DB (ddb), FALSE);
@@ -184,25 +329,36 @@ cd_device_db_set_property (CdDeviceDb *ddb,
 
 	g_debug ("CdDeviceDb: add device property %s [%s=%s]",
 		 device_id, property, value);
-	statement = sqlite3_mprintf ("INSERT OR REPLACE INTO properties_v2 (device_id, property, value) "
-				     "VALUES ('%q', '%q', '%q');",
-				     device_id, property, value);
 
 	/* insert the entry */
-	rc = sqlite3_exec (priv->db, statement, NULL, NULL, &error_msg);
-	if (rc != SQLITE_OK) {
+	sqlite3_reset (priv->stmt_set_property);
+	sqlite3_bind_text (priv->stmt_set_property, 1, device_id, -1, SQLITE_STATIC);
+	sqlite3_bind_text (priv->stmt_set_property, 2, property, -1, SQLITE_STATIC);
+	sqlite3_bind_text (priv->stmt_set_property, 3, value, -1, SQLITE_STATIC);
+	rc = sqlite3_step (priv->stmt_set_property);
+	if (rc != SQLITE_DONE) {
 		g_set_error (error,
 			     CD_CLIENT_ERROR,
 			     CD_CLIENT_ERROR_INTERNAL,
 			     "SQL error: %s",
-			     error_msg);
-		sqlite3_free (error_msg);
-		ret = FALSE;
-		goto out;
+			     sqlite3_errmsg (priv->db));
+		return FALSE;
 	}
-out:
-	sqlite3_free (statement);
-	return ret;
+
+	/* keep the preloaded map coherent */
+	if (priv->props_cache != NULL) {
+		GHashTable *props;
+		props = g_hash_table_lookup (priv->props_cache, device_id);
+		if (props == NULL) {
+			props = g_hash_table_new_full (g_str_hash, g_str_equal,
+						       g_free, g_free);
+			g_hash_table_insert (priv->props_cache,
+					     g_strdup (device_id),
+					     props);
+		}
+		g_hash_table_insert (props, g_strdup (property), g_strdup (value));
+	}
+	return TRUE;
 }
 
 gboolean  
@@ -211,10 +367,6 @@ cd_device_db_remove (CdDeviceDb *ddb,
 		     GError  **error)
 {
 	CdDeviceDbPrivate *priv = GET_PRIVATE (ddb);
-	gboolean ret = TRUE;
-	gchar *error_msg = NULL;
-	gchar *statement1 = NULL;
-	gchar *statement2 = NULL;
 	gint rc;
 
 	g_return_val_if_fail (CD_IS_DEVICE_DB (ddb), FALSE);
@@ -222,52 +374,33 @@ cd_device_db_remove (CdDeviceDb *ddb,
 
 	/* remove the entry */
 	g_debug ("CdDeviceDb: remove device %s", device_id);
-	statement1 = sqlite3_mprintf ("DELETE FROM devices WHERE "
-				     "device_id = '%q';",
-				     device_id);
-	rc = sqlite3_exec (priv->db, statement1, NULL, NULL, &error_msg);
-	if (rc != SQLITE_OK) {
+	sqlite3_reset (priv->stmt_remove_device);
+	sqlite3_bind_text (priv->stmt_remove_device, 1, device_id, -1, SQLITE_STATIC);
+	rc = sqlite3_step (priv->stmt_remove_device);
+	if (rc != SQLITE_DONE) {
 		g_set_error (error,
 			     CD_CLIENT_ERROR,
 			     CD_CLIENT_ERROR_INTERNAL,
 			     "SQL error: %s",
-			     error_msg);
-		sqlite3_free (error_msg);
-		ret = FALSE;
-		goto out;
+			     sqlite3_errmsg (priv->db));
+		return FALSE;
 	}
-	statement2 = sqlite3_mprintf ("DELETE FROM properties_v2 WHERE "
-				     "device_id = '%q';",
-				     device_id);
-	rc = sqlite3_exec (priv->db, statement2, NULL, NULL, &error_msg);
-	if (rc != SQLITE_OK) {
+	sqlite3_reset (priv->stmt_remove_properties);
+	sqlite3_bind_text (priv->stmt_remove_properties, 1, device_id, -1, SQLITE_STATIC);
+	rc = sqlite3_step (priv->stmt_remove_properties);
+	if (rc != SQLITE_DONE) {
 		g_set_error (error,
 			     CD_CLIENT_ERROR,
 			     CD_CLIENT_ERROR_INTERNAL,
 			     "SQL error: %s",
-			     error_msg);
-		sqlite3_free (error_msg);
-		ret = FALSE;
-		goto out;
+			     sqlite3_errmsg (priv->db));
+		return FALSE;
 	}
-out:
-	sqlite3_free (statement1);
-	sqlite3_free (statement2);
-	return ret;
-}
-
-static gint
-cd_device_db_sqlite_cb (void *data,
-			gint argc,
-			gchar **argv,
-			gchar **col_name)
-{
-	GPtrArray *array = (GPtrArray *) data;
 
-	/* should only be one entry */
-	g_debug ("CdDeviceDb: got sql result %s", argv[0]);
-	g_ptr_array_add (array, g_strdup (argv[0]));
-	return 0;
+	/* keep the preloaded map coherent */
+	if (priv->props_cache != NULL)
+		g_hash_table_remove (priv->props_cache, device_id);
+	return TRUE;
 }
 
 gchar *
@@ -277,53 +410,56 @@ cd_device_db_get_property (CdDeviceDb *ddb,
 			   GError  **error)
 {
 	CdDeviceDbPrivate *priv = GET_PRIVATE (ddb);
-	gchar *error_msg = NULL;
-	gchar *statement;
 	gint rc;
-	gchar *value = NULL;
-	g_autoptr(GPtrArray) array_tmp = NULL;
 
 	g_return_val_if_fail (CD_IS_DEVICE_DB (ddb), NULL);
 	g_return_val_if_fail (priv->db != NULL, NULL);
 
 	g_debug ("CdDeviceDb: get property %s for %s", property, device_id);
-	statement = sqlite3_mprintf ("SELECT value FROM properties_v2 WHERE "
-				     "device_id = '%q' AND "
-				     "property = '%q' LIMIT 1;",
-				     device_id, property);
 
-	/* remove the entry */
-	array_tmp = g_ptr_array_new_with_free_func (g_free);
-	rc = sqlite3_exec (priv->db,
-			   statement,
-			   cd_device_db_sqlite_cb,
-			   array_tmp,
-			   &error_msg);
-	if (rc != SQLITE_OK) {
+	/* everything was preloaded, so avoid the round-trip to sqlite */
+	if (priv->props_cache != NULL) {
+		GHashTable *props;
+		const gchar *tmp = NULL;
+		props = g_hash_table_lookup (priv->props_cache, device_id);
+		if (props != NULL)
+			tmp = g_hash_table_lookup (props, property);
+		if (tmp != NULL)
+			return g_strdup (tmp);
 		g_set_error (error,
 			     CD_CLIENT_ERROR,
 			     CD_CLIENT_ERROR_INTERNAL,
-			     "SQL error: %s",
-			     error_msg);
-		sqlite3_free (error_msg);
-		goto out;
+			     "no such property %s for %s",
+			     property, device_id);
+		return NULL;
 	}
 
-	/* never set */
-	if (array_tmp->len == 0) {
+	/* retrieve the entry */
+	sqlite3_reset (priv->stmt_get_property);
+	sqlite3_bind_text (priv->stmt_get_property, 1, device_id, -1, SQLITE_STATIC);
+	sqlite3_bind_text (priv->stmt_get_property, 2, property, -1, SQLITE_STATIC);
+	rc = sqlite3_step (priv->stmt_get_property);
+	if (rc == SQLITE_ROW) {
+		const gchar *tmp = (const gchar *) sqlite3_column_text (priv->stmt_get_property, 0);
+		g_debug ("CdDeviceDb: got sql result %s", tmp);
+		return g_strdup (tmp);
+	}
+	if (rc != SQLITE_DONE) {
 		g_set_error (error,
 			     CD_CLIENT_ERROR,
 			     CD_CLIENT_ERROR_INTERNAL,
-			     "no such property %s for %s",
-			     property, device_id);
-		goto out;
+			     "SQL error: %s",
+			     sqlite3_errmsg (priv->db));
+		return NULL;
 	}
 
-	/* success */
-	value = g_strdup (g_ptr_array_index (array_tmp, 0));
-out:
-	sqlite3_free (statement);
-	return value;
+	/* never set */
+	g_set_error (error,
+		     CD_CLIENT_ERROR,
+		     CD_CLIENT_ERROR_INTERNAL,
+		     "no such property %s for %s",
+		     property, device_id);
+	return NULL;
 }
 
 GPtrArray *
@@ -331,10 +467,7 @@ cd_device_db_get_devices (CdDeviceDb *ddb,
 			  GError  **error)
 {
 	CdDeviceDbPrivate *priv = GET_PRIVATE (ddb);
-	gchar *error_msg = NULL;
-	gchar *statement;
 	gint rc;
-	GPtrArray *array = NULL;
 	g_autoptr(GPtrArray) array_tmp = NULL;
 
 	g_return_val_if_fail (CD_IS_DEVICE_DB (ddb), NULL);
@@ -342,28 +475,24 @@ cd_device_db_get_devices (CdDeviceDb *ddb,
 
 	/* get all the devices */
 	g_debug ("CdDeviceDb: get devices");
-	statement = sqlite3_mprintf ("SELECT device_id FROM devices;");
+	sqlite3_reset (priv->stmt_get_devices);
 	array_tmp = g_ptr_array_new_with_free_func (g_free);
-	rc = sqlite3_exec (priv->db,
-			   statement,
-			   cd_device_db_sqlite_cb,
-			   array_tmp,
-			   &error_msg);
-	if (rc != SQLITE_OK) {
+	while ((rc = sqlite3_step (priv->stmt_get_devices)) == SQLITE_ROW) {
+		const gchar *tmp = (const gchar *) sqlite3_column_text (priv->stmt_get_devices, 0);
+		g_debug ("CdDeviceDb: got sql result %s", tmp);
+		g_ptr_array_add (array_tmp, g_strdup (tmp));
+	}
+	if (rc != SQLITE_DONE) {
 		g_set_error (error,
 			     CD_CLIENT_ERROR,
 			     CD_CLIENT_ERROR_INTERNAL,
 			     "SQL error: %s",
-			     error_msg);
-		sqlite3_free (error_msg);
-		goto out;
+			     sqlite3_errmsg (priv->db));
+		return NULL;
 	}
 
 	/* success */
-	array = g_ptr_array_ref (array_tmp);
-out:
-	sqlite3_free (statement);
-	return array;
+	return g_ptr_array_ref (array_tmp);
 }
 
 GPtrArray *
@@ -372,10 +501,7 @@ cd_device_db_get_properties (CdDeviceDb *ddb,
 			     GError  **error)
 {
 	CdDeviceDbPrivate *priv = GET_PRIVATE (ddb);
-	gchar *error_msg = NULL;
-	gchar *statement;
 	gint rc;
-	GPtrArray *array = NULL;
 	g_autoptr(GPtrArray) array_tmp = NULL;
 
 	g_return_val_if_fail (CD_IS_DEVICE_DB (ddb), NULL);
@@ -383,30 +509,41 @@ cd_device_db_get_properties (CdDeviceDb *ddb,
 
 	/* get all the devices */
 	g_debug ("CdDeviceDb: get properties for device %s", device_id);
-	statement = sqlite3_mprintf ("SELECT property FROM properties_v2 "
-				     "WHERE device_id = '%q';",
-				     device_id);
+
+	/* everything was preloaded, so avoid the round-trip to sqlite */
+	if (priv->props_cache != NULL) {
+		GHashTable *props;
+		array_tmp = g_ptr_array_new_with_free_func (g_free);
+		props = g_hash_table_lookup (priv->props_cache, device_id);
+		if (props != NULL) {
+			GHashTableIter iter;
+			gpointer key;
+			g_hash_table_iter_init (&iter, props);
+			while (g_hash_table_iter_next (&iter, &key, NULL))
+				g_ptr_array_add (array_tmp, g_strdup (key));
+		}
+		return g_ptr_array_ref (array_tmp);
+	}
+
+	sqlite3_reset (priv->stmt_get_properties);
+	sqlite3_bind_text (priv->stmt_get_properties, 1, device_id, -1, SQLITE_STATIC);
 	array_tmp = g_ptr_array_new_with_free_func (g_free);
-	rc = sqlite3_exec (priv->db,
-			   statement,
-			   cd_device_db_sqlite_cb,
-			   array_tmp,
-			   &error_msg);
-	if (rc != SQLITE_OK) {
+	while ((rc = sqlite3_step (priv->stmt_get_properties)) == SQLITE_ROW) {
+		const gchar *tmp = (const gchar *) sqlite3_column_text (priv->stmt_get_properties, 0);
+		g_debug ("CdDeviceDb: got sql result %s", tmp);
+		g_ptr_array_add (array_tmp, g_strdup (tmp));
+	}
+	if (rc != SQLITE_DONE) {
 		g_set_error (error,
 			     CD_CLIENT_ERROR,
 			     CD_CLIENT_ERROR_INTERNAL,
 			     "SQL error: %s",
-			     error_msg);
-		sqlite3_free (error_msg);
-		goto out;
+			     sqlite3_errmsg (priv->db));
+		return NULL;
 	}
 
 	/* success */
-	array = g_ptr_array_ref (array_tmp);
-out:
-	sqlite3_free (statement);
-	return array;
+	return g_ptr_array_ref (array_tmp);
 }
 
 static void
@@ -428,7 +565,18 @@ cd_device_db_finalize (GObject *object)
 	CdDeviceDbPrivate *priv = GET_PRIVATE (ddb);
 
 	/* close the database */
-	sqlite3_close (priv->db);
+	sqlite3_finalize (priv->stmt_add);
+	sqlite3_finalize (priv->stmt_set_property);
+	sqlite3_finalize (priv->stmt_remove_device);
+	sqlite3_finalize (priv->stmt_remove_properties);
+	sqlite3_finalize (priv->stmt_get_property);
+	sqlite3_finalize (priv->stmt_get_devices);
+	sqlite3_finalize (priv->stmt_get_properties);
+	sqlite3_finalize (priv->stmt_get_all_properties);
+	if (priv->props_cache != NULL)
+		g_hash_table_unref (priv->props_cache);
+	if (priv->db_owned)
+		sqlite3_close (priv->db);
 
 	G_OBJECT_CLASS (cd_device_db_parent_class)->finalize (object);
 }
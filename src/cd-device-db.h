@@ -23,6 +23,7 @@
 #define __CD_DEVICE_DB_H
 
 #include <glib-object.h>
+#include <sqlite3.h>
 
 G_BEGIN_DECLS
 
@@ -40,6 +41,13 @@ gboolean	 cd_device_db_load		(CdDeviceDb	*ddb,
 						 const gchar	*filename,
 						 GError		**error)
 						 G_GNUC_WARN_UNUSED_RESULT;
+gboolean	 cd_device_db_load_with_connection (CdDeviceDb	*ddb,
+						 sqlite3	*db,
+						 GError		**error)
+						 G_GNUC_WARN_UNUSED_RESULT;
+gboolean	 cd_device_db_preload		(CdDeviceDb	*ddb,
+						 GError		**error)
+						 G_GNUC_WARN_UNUSED_RESULT;
 gboolean	 cd_device_db_empty		(CdDeviceDb	*ddb,
 						 GError		**error)
 						 G_GNUC_WARN_UNUSED_RESULT;
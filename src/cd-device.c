@@ -30,6 +30,7 @@
 #endif
 
 #include "cd-common.h"
+#include "cd-debug.h"
 #include "cd-device.h"
 #include "cd-mapping-db.h"
 #include "cd-device-db.h"
@@ -68,12 +69,17 @@ typedef struct
 	guint64				 created;
 	guint64				 modified;
 	gboolean			 require_modified_signal;
+	GHashTable			*pending_properties; /* of property name:GVariant */
+	guint				 pending_changed_id;
+	gboolean			 pending_signal_changed;
+	guint64				 generation;
 	gboolean			 is_virtual;
 	gboolean			 enabled;
 	gboolean			 embedded;
 	GHashTable			*metadata;
 	guint				 owner;
 	gchar				*seat;
+	GVariant			*props_snapshot; /* prebuilt GetAll dict, or NULL */
 } CdDevicePrivate;
 
 enum {
@@ -92,9 +98,20 @@ typedef struct {
 	CdProfile		*profile;
 	CdDeviceRelation	 relation;
 	guint64			 timestamp;
+	gchar			*qual_source;	/* qualifier the split was made from */
+	gchar			**qual_split;	/* pre-tokenized qualifier fields */
 } CdDeviceProfileItem;
 
 static guint signals[SIGNAL_LAST] = { 0 };
+
+/* the prebuilt property dictionary is only valid until something
+ * mutates; rebuilding lazily on the next GetAll is cheap enough */
+static void
+cd_device_invalidate_props_snapshot (CdDevice *device)
+{
+	CdDevicePrivate *priv = GET_PRIVATE (device);
+	g_clear_pointer (&priv->props_snapshot, g_variant_unref);
+}
 G_DEFINE_TYPE_WITH_PRIVATE (CdDevice, cd_device, G_TYPE_OBJECT)
 
 GQuark
@@ -127,6 +144,7 @@ cd_device_set_scope (CdDevice *device, CdObjectScope object_scope)
 	CdDevicePrivate *priv = GET_PRIVATE (device);
 	g_return_if_fail (CD_IS_DEVICE (device));
 	priv->object_scope = object_scope;
+	cd_device_invalidate_props_snapshot (device);
 }
 
 guint
@@ -143,6 +161,7 @@ cd_device_set_owner (CdDevice *device, guint owner)
 	CdDevicePrivate *priv = GET_PRIVATE (device);
 	g_return_if_fail (CD_IS_DEVICE (device));
 	priv->owner = owner;
+	cd_device_invalidate_props_snapshot (device);
 }
 
 const gchar *
@@ -159,6 +178,7 @@ cd_device_set_seat (CdDevice *device, const gchar *seat)
 	CdDevicePrivate *priv = GET_PRIVATE (device);
 	g_return_if_fail (CD_IS_DEVICE (device));
 	priv->seat = g_strdup (seat);
+	cd_device_invalidate_props_snapshot (device);
 }
 
 static const gchar *
@@ -188,6 +208,7 @@ cd_device_set_mode (CdDevice *device, CdDeviceMode mode)
 	g_return_if_fail (CD_IS_DEVICE (device));
 	g_free (priv->mode);
 	priv->mode = g_strdup (_cd_device_mode_to_string (mode));
+	cd_device_invalidate_props_snapshot (device);
 }
 
 CdDeviceMode
@@ -237,6 +258,7 @@ cd_device_set_kind (CdDevice *device, CdDeviceKind kind)
 	g_return_if_fail (CD_IS_DEVICE (device));
 	g_return_if_fail (kind != CD_DEVICE_KIND_UNKNOWN);
 	priv->kind = kind;
+	cd_device_invalidate_props_snapshot (device);
 }
 
 static void
@@ -246,6 +268,7 @@ cd_device_set_object_path (CdDevice *device)
 #ifdef HAVE_PWD_H
 	struct passwd *pw;
 #endif
+	g_autofree gchar *path_full = NULL;
 	g_autofree gchar *path_owner = NULL;
 	g_autofree gchar *path_tmp = NULL;
 
@@ -273,10 +296,11 @@ cd_device_set_object_path (CdDevice *device)
 
 	/* make sure object path is sane */
 	path_owner = cd_main_ensure_dbus_path (path_tmp);
-	priv->object_path = g_build_filename (COLORD_DBUS_PATH,
-						      "devices",
-						      path_owner,
-						      NULL);
+	path_full = g_build_filename (COLORD_DBUS_PATH,
+				      "devices",
+				      path_owner,
+				      NULL);
+	priv->object_path = cd_main_intern_string (path_full);
 }
 
 void
@@ -287,10 +311,13 @@ cd_device_set_id (CdDevice *device, const gchar *id)
 
 	g_return_if_fail (CD_IS_DEVICE (device));
 
-	g_free (priv->id);
-	priv->id = g_strdup (id);
+	cd_main_intern_release (priv->id);
+	priv->id = cd_main_intern_string (id);
+	cd_device_invalidate_props_snapshot (device);
 
 	/* now calculate this again */
+	cd_main_intern_release (priv->object_path);
+	priv->object_path = NULL;
 	cd_device_set_object_path (device);
 
 	/* find initial enabled state */
@@ -313,6 +340,91 @@ cd_device_reset_modified (CdDevice *device)
 	g_debug ("CdDevice: set device Modified");
 	priv->modified = g_get_real_time ();
 	priv->require_modified_signal = TRUE;
+	cd_device_invalidate_props_snapshot (device);
+}
+
+static gboolean
+cd_device_dbus_emit_pending_cb (gpointer user_data)
+{
+	CdDevice *device = CD_DEVICE (user_data);
+	CdDevicePrivate *priv = GET_PRIVATE (device);
+	GHashTableIter iter;
+	gpointer key;
+	gpointer value;
+	GVariantBuilder builder;
+	GVariantBuilder invalidated_builder;
+
+	priv->pending_changed_id = 0;
+
+	/* emit every property queued this dispatch cycle in one signal,
+	 * bumping the generation so clients can skip replayed state */
+	if (g_hash_table_size (priv->pending_properties) > 0) {
+		priv->generation++;
+		g_variant_builder_init (&invalidated_builder, G_VARIANT_TYPE ("as"));
+		g_variant_builder_init (&builder, G_VARIANT_TYPE_ARRAY);
+		g_hash_table_iter_init (&iter, priv->pending_properties);
+		while (g_hash_table_iter_next (&iter, &key, &value)) {
+			g_variant_builder_add (&builder,
+					       "{sv}",
+					       (const gchar *) key,
+					       (GVariant *) value);
+		}
+		g_variant_builder_add (&builder,
+				       "{sv}",
+				       CD_DEVICE_PROPERTY_GENERATION,
+				       g_variant_new_uint64 (priv->generation));
+		g_dbus_connection_emit_signal (priv->connection,
+					       NULL,
+					       priv->object_path,
+					       "org.freedesktop.DBus.Properties",
+					       "PropertiesChanged",
+					       g_variant_new ("(sa{sv}as)",
+					       COLORD_DBUS_INTERFACE_DEVICE,
+					       &builder,
+					       &invalidated_builder),
+					       NULL);
+		g_variant_builder_clear (&builder);
+		g_variant_builder_clear (&invalidated_builder);
+		g_hash_table_remove_all (priv->pending_properties);
+	}
+
+	/* emit the changed signals just once per cycle */
+	if (priv->pending_signal_changed) {
+		priv->pending_signal_changed = FALSE;
+
+		/* emit signal */
+		g_debug ("CdDevice: emit Changed on %s",
+			 cd_device_get_object_path (device));
+		g_dbus_connection_emit_signal (priv->connection,
+					       NULL,
+					       cd_device_get_object_path (device),
+					       COLORD_DBUS_INTERFACE_DEVICE,
+					       "Changed",
+					       NULL,
+					       NULL);
+
+		/* emit signal */
+		g_debug ("CdDevice: emit Changed");
+		g_dbus_connection_emit_signal (priv->connection,
+					       NULL,
+					       COLORD_DBUS_PATH,
+					       COLORD_DBUS_INTERFACE,
+					       "DeviceChanged",
+					       g_variant_new ("(o)",
+								    cd_device_get_object_path (device)),
+					       NULL);
+	}
+	return G_SOURCE_REMOVE;
+}
+
+static void
+cd_device_dbus_emit_schedule (CdDevice *device)
+{
+	CdDevicePrivate *priv = GET_PRIVATE (device);
+	if (priv->pending_changed_id != 0)
+		return;
+	priv->pending_changed_id = g_idle_add (cd_device_dbus_emit_pending_cb,
+					       device);
 }
 
 static void
@@ -321,39 +433,25 @@ cd_device_dbus_emit_property_changed (CdDevice *device,
 				      GVariant *property_value)
 {
 	CdDevicePrivate *priv = GET_PRIVATE (device);
-	GVariantBuilder builder;
-	GVariantBuilder invalidated_builder;
+
+	cd_device_invalidate_props_snapshot (device);
 
 	/* not yet connected */
 	if (priv->connection == NULL)
 		return;
 
-	/* build the dict */
-	g_variant_builder_init (&invalidated_builder, G_VARIANT_TYPE ("as"));
-	g_variant_builder_init (&builder, G_VARIANT_TYPE_ARRAY);
-	g_variant_builder_add (&builder,
-			       "{sv}",
-			       property_name,
-			       property_value);
+	/* queue the value, replacing any not-yet-dispatched value for
+	 * the same property */
+	g_hash_table_insert (priv->pending_properties,
+			     cd_main_intern_string (property_name),
+			     g_variant_ref_sink (property_value));
 	if (priv->require_modified_signal) {
-		g_variant_builder_add (&builder,
-				       "{sv}",
-				       CD_DEVICE_PROPERTY_MODIFIED,
-				       g_variant_new_uint64 (priv->modified));
+		g_hash_table_insert (priv->pending_properties,
+				     cd_main_intern_string (CD_DEVICE_PROPERTY_MODIFIED),
+				     g_variant_ref_sink (g_variant_new_uint64 (priv->modified)));
 		priv->require_modified_signal = FALSE;
 	}
-	g_dbus_connection_emit_signal (priv->connection,
-				       NULL,
-				       priv->object_path,
-				       "org.freedesktop.DBus.Properties",
-				       "PropertiesChanged",
-				       g_variant_new ("(sa{sv}as)",
-				       COLORD_DBUS_INTERFACE_DEVICE,
-				       &builder,
-				       &invalidated_builder),
-				       NULL);
-	g_variant_builder_clear (&builder);
-	g_variant_builder_clear (&invalidated_builder);
+	cd_device_dbus_emit_schedule (device);
 }
 
 static void
@@ -365,39 +463,15 @@ cd_device_dbus_emit_device_changed (CdDevice *device)
 	if (priv->connection == NULL)
 		return;
 
-	/* emit signal */
-	g_debug ("CdDevice: emit Changed on %s",
-		 cd_device_get_object_path (device));
-	g_dbus_connection_emit_signal (priv->connection,
-				       NULL,
-				       cd_device_get_object_path (device),
-				       COLORD_DBUS_INTERFACE_DEVICE,
-				       "Changed",
-				       NULL,
-				       NULL);
-
-	/* emit signal */
-	g_debug ("CdDevice: emit Changed");
-	g_dbus_connection_emit_signal (priv->connection,
-				       NULL,
-				       COLORD_DBUS_PATH,
-				       COLORD_DBUS_INTERFACE,
-				       "DeviceChanged",
-				       g_variant_new ("(o)",
-							    cd_device_get_object_path (device)),
-				       NULL);
+	/* coalesce with any queued property changes */
+	priv->pending_signal_changed = TRUE;
+	cd_device_dbus_emit_schedule (device);
 }
 
 static gboolean
-cd_device_match_qualifier (const gchar *qual1, const gchar *qual2)
+cd_device_match_qualifier_split (gchar **split1, gchar **split2)
 {
 	guint i;
-	g_auto(GStrv) split1 = NULL;
-	g_auto(GStrv) split2 = NULL;
-
-	/* split into substring */
-	split1 = g_strsplit (qual1, ".", 3);
-	split2 = g_strsplit (qual2, ".", 3);
 
 	/* ensure all substrings match */
 	for (i = 0; i < 3; i++) {
@@ -422,6 +496,21 @@ cd_device_match_qualifier (const gchar *qual1, const gchar *qual2)
 	return TRUE;
 }
 
+static gchar **
+cd_device_profile_item_get_qual_split (CdDeviceProfileItem *item,
+				       const gchar *qualifier)
+{
+	/* the profile qualifier can be set at any time, so retokenize
+	 * when it no longer matches what the split was made from */
+	if (g_strcmp0 (item->qual_source, qualifier) != 0) {
+		g_strfreev (item->qual_split);
+		g_free (item->qual_source);
+		item->qual_source = g_strdup (qualifier);
+		item->qual_split = g_strsplit (qualifier, ".", 3);
+	}
+	return item->qual_split;
+}
+
 static CdProfile *
 cd_device_find_by_qualifier (const gchar *regex,
 			     GPtrArray *array,
@@ -429,8 +518,15 @@ cd_device_find_by_qualifier (const gchar *regex,
 {
 	CdDeviceProfileItem *item;
 	const gchar *qualifier;
+	gboolean match_any;
 	gboolean ret;
 	guint i;
+	g_auto(GStrv) regex_split = NULL;
+
+	/* tokenize the query once, not once per profile */
+	match_any = g_strcmp0 (regex, "*") == 0;
+	if (!match_any)
+		regex_split = g_strsplit (regex, ".", 3);
 
 	/* find using a wildcard */
 	for (i = 0; i < array->len; i++) {
@@ -439,25 +535,25 @@ cd_device_find_by_qualifier (const gchar *regex,
 			continue;
 
 		/* '*' matches anything, including a blank qualifier */
-		if (g_strcmp0 (regex, "*") == 0) {
-			g_debug ("anything matches, returning %s",
-				 cd_profile_get_id (item->profile));
+		if (match_any) {
+			CD_DEBUG ("anything matches, returning %s",
+				  cd_profile_get_id (item->profile));
 			return item->profile;
 		}
 
-		/* match with a regex */
+		/* match against the pre-tokenized qualifier */
 		qualifier = cd_profile_get_qualifier (item->profile);
 		if (qualifier == NULL) {
-			g_debug ("no qualifier for %s, skipping",
-				 cd_profile_get_id (item->profile));
+			CD_DEBUG ("no qualifier for %s, skipping",
+				  cd_profile_get_id (item->profile));
 			continue;
 		}
-		ret = cd_device_match_qualifier (regex,
-						 qualifier);
-		g_debug ("%s regex '%s' for '%s'",
-			 ret ? "matched" : "unmatched",
-			 regex,
-			 qualifier);
+		ret = cd_device_match_qualifier_split (regex_split,
+						       cd_device_profile_item_get_qual_split (item, qualifier));
+		CD_DEBUG ("%s regex '%s' for '%s'",
+			  ret ? "matched" : "unmatched",
+			  regex,
+			  qualifier);
 		if (ret)
 			return item->profile;
 	}
@@ -686,6 +782,13 @@ cd_device_add_profile (CdDevice *device,
 		item->profile = g_object_ref (profile);
 		item->relation = relation;
 		item->timestamp = timestamp;
+
+		/* tokenize at assignment time; refreshed automatically
+		 * if the qualifier is set later */
+		if (cd_profile_get_qualifier (profile) != NULL) {
+			cd_device_profile_item_get_qual_split (item,
+							       cd_profile_get_qualifier (profile));
+		}
 		g_ptr_array_add (priv->profiles, item);
 		g_ptr_array_sort (priv->profiles,
 				  cd_device_profile_item_sort_cb);
@@ -873,7 +976,7 @@ cd_device_set_property_internal (CdDevice *device,
 		/* add to metadata */
 		is_metadata = TRUE;
 		g_hash_table_insert (priv->metadata,
-				     g_strdup (property),
+				     cd_main_intern_string (property),
 				     g_strdup (value));
 		cd_device_dbus_emit_property_changed (device,
 						      CD_DEVICE_PROPERTY_METADATA,
@@ -1342,6 +1445,47 @@ cd_device_dbus_method_call (GDBusConnection *connection, const gchar *sender,
 		return;
 	}
 
+	/* return '' */
+	if (g_strcmp0 (method_name, "SetProperties") == 0) {
+		GVariantIter *iter = NULL;
+
+		/* require auth */
+		ret = cd_main_sender_authenticated (connection,
+						    sender,
+						    "org.freedesktop.color-manager.modify-device",
+						    &error);
+		if (!ret) {
+			g_dbus_method_invocation_return_error (invocation,
+							       CD_DEVICE_ERROR,
+							       CD_DEVICE_ERROR_FAILED_TO_AUTHENTICATE,
+							       "%s", error->message);
+			return;
+		}
+
+		/* set each key; the property notifications all coalesce
+		 * into a single change signal */
+		g_variant_get (parameters, "(a{ss})", &iter);
+		g_debug ("CdDevice %s:SetProperties(%u properties)",
+			 sender, (guint) g_variant_iter_n_children (iter));
+		while (g_variant_iter_next (iter, "{&s&s}",
+					    &property_name,
+					    &property_value)) {
+			ret = cd_device_set_property_internal (device,
+							       property_name,
+							       property_value,
+							       (priv->object_scope == CD_OBJECT_SCOPE_DISK),
+							       &error);
+			if (!ret) {
+				g_variant_iter_free (iter);
+				g_dbus_method_invocation_return_gerror (invocation, error);
+				return;
+			}
+		}
+		g_variant_iter_free (iter);
+		g_dbus_method_invocation_return_value (invocation, NULL);
+		return;
+	}
+
 	/* return '' */
 	if (g_strcmp0 (method_name, "ProfilingInhibit") == 0) {
 
@@ -1425,6 +1569,16 @@ cd_device_dbus_get_property (GDBusConnection *connection_, const gchar *sender,
 	CdDevicePrivate *priv = GET_PRIVATE (device);
 	g_auto(GStrv) bus_names = NULL;
 
+	/* serve from the prebuilt snapshot; a GetAll storm at session
+	 * start then costs one dictionary lookup per property */
+	if (priv->props_snapshot != NULL) {
+		GVariant *value_tmp;
+		value_tmp = g_variant_lookup_value (priv->props_snapshot,
+						    property_name, NULL);
+		if (value_tmp != NULL)
+			return value_tmp;
+	}
+
 	if (g_strcmp0 (property_name, CD_DEVICE_PROPERTY_CREATED) == 0)
 		return g_variant_new_uint64 (priv->created);
 	if (g_strcmp0 (property_name, CD_DEVICE_PROPERTY_MODIFIED) == 0)
@@ -1459,6 +1613,8 @@ cd_device_dbus_get_property (GDBusConnection *connection_, const gchar *sender,
 		return cd_device_get_nullable_for_string (priv->seat);
 	if (g_strcmp0 (property_name, CD_DEVICE_PROPERTY_EMBEDDED) == 0)
 		return g_variant_new_boolean (priv->embedded);
+	if (g_strcmp0 (property_name, CD_DEVICE_PROPERTY_GENERATION) == 0)
+		return g_variant_new_uint64 (priv->generation);
 	if (g_strcmp0 (property_name, CD_DEVICE_PROPERTY_PROFILING_INHIBITORS) == 0) {
 		bus_names = cd_inhibit_get_bus_names (priv->inhibit);
 		return g_variant_new_strv ((const gchar * const *) bus_names, -1);
@@ -1473,6 +1629,54 @@ cd_device_dbus_get_property (GDBusConnection *connection_, const gchar *sender,
 	return NULL;
 }
 
+GVariant *
+cd_device_get_properties_as_variant (CdDevice *device)
+{
+	CdDevicePrivate *priv = GET_PRIVATE (device);
+	GVariant *value;
+	GVariantBuilder builder;
+	guint i;
+	const gchar *props[] = {
+		CD_DEVICE_PROPERTY_CREATED,
+		CD_DEVICE_PROPERTY_MODIFIED,
+		CD_DEVICE_PROPERTY_MODEL,
+		CD_DEVICE_PROPERTY_VENDOR,
+		CD_DEVICE_PROPERTY_SERIAL,
+		CD_DEVICE_PROPERTY_ENABLED,
+		CD_DEVICE_PROPERTY_COLORSPACE,
+		CD_DEVICE_PROPERTY_FORMAT,
+		CD_DEVICE_PROPERTY_MODE,
+		CD_DEVICE_PROPERTY_KIND,
+		CD_DEVICE_PROPERTY_ID,
+		CD_DEVICE_PROPERTY_PROFILES,
+		CD_DEVICE_PROPERTY_METADATA,
+		CD_DEVICE_PROPERTY_SCOPE,
+		CD_DEVICE_PROPERTY_OWNER,
+		CD_DEVICE_PROPERTY_SEAT,
+		CD_DEVICE_PROPERTY_EMBEDDED,
+		CD_DEVICE_PROPERTY_GENERATION,
+		CD_DEVICE_PROPERTY_PROFILING_INHIBITORS,
+		NULL };
+
+	g_return_val_if_fail (CD_IS_DEVICE (device), NULL);
+
+	/* hand out the prebuilt dictionary by reference */
+	if (priv->props_snapshot != NULL)
+		return g_variant_ref (priv->props_snapshot);
+
+	/* build the same dictionary o.fd.DBus.Properties.GetAll would */
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+	for (i = 0; props[i] != NULL; i++) {
+		value = cd_device_dbus_get_property (NULL, NULL, NULL, NULL,
+						     props[i], NULL, device);
+		if (value == NULL)
+			continue;
+		g_variant_builder_add (&builder, "{sv}", props[i], value);
+	}
+	priv->props_snapshot = g_variant_ref_sink (g_variant_builder_end (&builder));
+	return g_variant_ref (priv->props_snapshot);
+}
+
 gboolean
 cd_device_register_object (CdDevice *device,
 			   GDBusConnection *connection,
@@ -1563,17 +1767,18 @@ cd_device_set_property (GObject *object, guint prop_id, const GValue *value, GPa
 
 	switch (prop_id) {
 	case PROP_OBJECT_PATH:
-		g_free (priv->object_path);
-		priv->object_path = g_strdup (g_value_get_string (value));
+		cd_main_intern_release (priv->object_path);
+		priv->object_path = cd_main_intern_string (g_value_get_string (value));
 		break;
 	case PROP_ID:
-		g_free (priv->id);
-		priv->id = g_strdup (g_value_get_string (value));
+		cd_main_intern_release (priv->id);
+		priv->id = cd_main_intern_string (g_value_get_string (value));
 		break;
 	default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 		break;
 	}
+	cd_device_invalidate_props_snapshot (device);
 }
 
 static void
@@ -1616,6 +1821,8 @@ static void
 cd_device_profiles_item_free (CdDeviceProfileItem *item)
 {
 	g_object_unref (item->profile);
+	g_strfreev (item->qual_split);
+	g_free (item->qual_source);
 	g_free (item);
 }
 
@@ -1636,8 +1843,12 @@ cd_device_init (CdDevice *device)
 			  device);
 	priv->metadata = g_hash_table_new_full (g_str_hash,
 							 g_str_equal,
-							 g_free,
+							 (GDestroyNotify) cd_main_intern_release,
 							 g_free);
+	priv->pending_properties = g_hash_table_new_full (g_str_hash,
+							  g_str_equal,
+							  (GDestroyNotify) cd_main_intern_release,
+							  (GDestroyNotify) g_variant_unref);
 }
 
 static void
@@ -1648,6 +1859,8 @@ cd_device_finalize (GObject *object)
 
 	if (priv->watcher_id > 0)
 		g_bus_unwatch_name (priv->watcher_id);
+	if (priv->pending_changed_id > 0)
+		g_source_remove (priv->pending_changed_id);
 	if (priv->registration_id > 0) {
 		g_debug ("CdDevice: Unregister interface %u on %s",
 			  priv->registration_id,
@@ -1655,7 +1868,7 @@ cd_device_finalize (GObject *object)
 		g_dbus_connection_unregister_object (priv->connection,
 						     priv->registration_id);
 	}
-	g_free (priv->id);
+	cd_main_intern_release (priv->id);
 	g_free (priv->model);
 	g_free (priv->vendor);
 	g_free (priv->colorspace);
@@ -1663,13 +1876,16 @@ cd_device_finalize (GObject *object)
 	g_free (priv->mode);
 	g_free (priv->serial);
 	g_free (priv->seat);
-	g_free (priv->object_path);
+	cd_main_intern_release (priv->object_path);
 	g_ptr_array_unref (priv->profiles);
 	g_object_unref (priv->profile_array);
 	g_object_unref (priv->mapping_db);
 	g_object_unref (priv->device_db);
 	g_object_unref (priv->inhibit);
 	g_hash_table_unref (priv->metadata);
+	g_hash_table_unref (priv->pending_properties);
+	if (priv->props_snapshot != NULL)
+		g_variant_unref (priv->props_snapshot);
 
 	G_OBJECT_CLASS (cd_device_parent_class)->finalize (object);
 }
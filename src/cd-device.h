@@ -78,6 +78,7 @@ gboolean	 cd_device_make_default			(CdDevice	*device,
 							 GError		**error)
 							 G_GNUC_WARN_UNUSED_RESULT;
 const gchar	*cd_device_get_object_path		(CdDevice	*device);
+GVariant	*cd_device_get_properties_as_variant	(CdDevice	*device);
 gboolean	 cd_device_register_object		(CdDevice	*device,
 							 GDBusConnection *connection,
 							 GDBusInterfaceInfo *info,
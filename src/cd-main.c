@@ -23,6 +23,8 @@
 
 #include <stdlib.h>
 #include <gio/gio.h>
+#include <glib-unix.h>
+#include <glib/gstdio.h>
 #ifdef __unix__
 #include <gio/gunixfdlist.h>
 #endif
@@ -54,8 +56,14 @@ typedef struct {
 	GDBusNodeInfo		*introspection_device;
 	GDBusNodeInfo		*introspection_profile;
 	GDBusNodeInfo		*introspection_sensor;
+	GDBusNodeInfo		*introspection_objmgr;
 	CdDeviceArray		*devices_array;
 	CdProfileArray		*profiles_array;
+	GHashTable		*profiles_checksum;	/* of checksum:CdProfile */
+	GHashTable		*space_cache;		/* of standard-space:CdProfile */
+	GHashTable		*miss_cache;		/* of failed Find* query keys */
+	GHashTable		*sender_watches;	/* of sender:CdMainSenderWatch */
+	GHashTable		*sender_watch_by_object; /* of GObject:CdMainSenderWatch */
 	CdIccStore		*icc_store;
 	CdMappingDb		*mapping_db;
 	CdDeviceDb		*device_db;
@@ -64,12 +72,123 @@ typedef struct {
 	GPtrArray		*sensors;
 	GPtrArray		*plugins;
 	GMainLoop		*loop;
+	guint			 coldplug_id;
+	guint			 coldplug_phase;
 	gboolean		 create_dummy_sensor;
 	gboolean		 always_use_xrandr_name;
 	gchar			*system_vendor;
 	gchar			*system_model;
 } CdMainPrivate;
 
+#define COLORD_DBUS_INTERFACE_OBJECT_MANAGER	"org.freedesktop.DBus.ObjectManager"
+
+/* the legacy DeviceAdded/ProfileAdded/SensorAdded signals only carry
+ * the object path; these carry the full property dictionary so that
+ * ObjectManager clients never need a GetAll per object */
+static void
+cd_main_objmgr_emit_added (CdMainPrivate *priv,
+			   const gchar *object_path,
+			   const gchar *interface_name,
+			   GVariant *props)
+{
+	GVariantBuilder builder;
+
+	if (priv->connection == NULL)
+		return;
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sa{sv}}"));
+	g_variant_builder_add (&builder, "{s@a{sv}}",
+			       interface_name, props);
+	g_dbus_connection_emit_signal (priv->connection,
+				       NULL,
+				       COLORD_DBUS_PATH,
+				       COLORD_DBUS_INTERFACE_OBJECT_MANAGER,
+				       "InterfacesAdded",
+				       g_variant_new ("(oa{sa{sv}})",
+						      object_path,
+						      &builder),
+				       NULL);
+}
+
+static void
+cd_main_objmgr_emit_removed (CdMainPrivate *priv,
+			     const gchar *object_path,
+			     const gchar *interface_name)
+{
+	const gchar *interfaces[] = { interface_name, NULL };
+
+	if (priv->connection == NULL)
+		return;
+	g_dbus_connection_emit_signal (priv->connection,
+				       NULL,
+				       COLORD_DBUS_PATH,
+				       COLORD_DBUS_INTERFACE_OBJECT_MANAGER,
+				       "InterfacesRemoved",
+				       g_variant_new ("(o^as)",
+						      object_path,
+						      interfaces),
+				       NULL);
+}
+
+static void
+cd_main_query_caches_invalidate (CdMainPrivate *priv)
+{
+	/* any add or remove can change what the repeated session-start
+	 * queries would resolve to, so just start over; the caches
+	 * refill on the next query */
+	g_hash_table_remove_all (priv->space_cache);
+	g_hash_table_remove_all (priv->miss_cache);
+}
+
+/* one bus name watcher per unique sender, holding the temporary
+ * objects that sender owns; disconnect cleanup only ever touches the
+ * objects in the bucket */
+typedef struct {
+	CdMainPrivate		*priv;
+	gchar			*sender;
+	guint			 watcher_id;
+	GPtrArray		*objects;	/* of GObject, no ref held */
+} CdMainSenderWatch;
+
+static void
+cd_main_sender_watch_free (CdMainSenderWatch *watch)
+{
+	if (watch->watcher_id > 0)
+		g_bus_unwatch_name (watch->watcher_id);
+	g_ptr_array_unref (watch->objects);
+	g_free (watch->sender);
+	g_free (watch);
+}
+
+static void
+cd_main_sender_watch_remove_object (CdMainPrivate *priv, GObject *object)
+{
+	CdMainSenderWatch *watch;
+
+	watch = g_hash_table_lookup (priv->sender_watch_by_object, object);
+	if (watch == NULL)
+		return;
+	g_hash_table_remove (priv->sender_watch_by_object, object);
+	g_ptr_array_remove (watch->objects, object);
+
+	/* last owned object gone, stop watching the sender */
+	if (watch->objects->len == 0)
+		g_hash_table_remove (priv->sender_watches, watch->sender);
+}
+
+static void
+cd_main_profile_checksum_remove (CdMainPrivate *priv, CdProfile *profile)
+{
+	const gchar *checksum;
+
+	/* only remove the index entry if it points at this profile; another
+	 * profile with the same contents may have been registered since */
+	checksum = cd_profile_get_checksum (profile);
+	if (checksum == NULL)
+		return;
+	if (g_hash_table_lookup (priv->profiles_checksum, checksum) == profile)
+		g_hash_table_remove (priv->profiles_checksum, checksum);
+}
+
 static void
 cd_main_profile_removed (CdMainPrivate *priv, CdProfile *profile)
 {
@@ -81,6 +200,9 @@ cd_main_profile_removed (CdMainPrivate *priv, CdProfile *profile)
 
 	/* remove from the array before emitting */
 	object_path_tmp = g_strdup (cd_profile_get_object_path (profile));
+	cd_main_sender_watch_remove_object (priv, G_OBJECT (profile));
+	cd_main_profile_checksum_remove (priv, profile);
+	cd_main_query_caches_invalidate (priv);
 	cd_profile_array_remove (priv->profiles_array, profile);
 
 	/* try to remove this profile from all devices */
@@ -111,6 +233,9 @@ cd_main_profile_removed (CdMainPrivate *priv, CdProfile *profile)
 				       g_variant_new ("(o)",
 						      object_path_tmp),
 				       NULL);
+	cd_main_objmgr_emit_removed (priv,
+				     object_path_tmp,
+				     COLORD_DBUS_INTERFACE_PROFILE);
 }
 
 static void
@@ -134,6 +259,8 @@ cd_main_device_removed (CdMainPrivate *priv, CdDevice *device)
 	/* remove from the array before emitting */
 	object_path_tmp = g_strdup (cd_device_get_object_path (device));
 	g_debug ("CdMain: Removing device %s", object_path_tmp);
+	cd_main_sender_watch_remove_object (priv, G_OBJECT (device));
+	cd_main_query_caches_invalidate (priv);
 	cd_device_array_remove (priv->devices_array, device);
 
 	/* remove from the device database */
@@ -160,6 +287,9 @@ cd_main_device_removed (CdMainPrivate *priv, CdDevice *device)
 				       g_variant_new ("(o)",
 						      object_path_tmp),
 				       &error);
+	cd_main_objmgr_emit_removed (priv,
+				     object_path_tmp,
+				     COLORD_DBUS_INTERFACE_DEVICE);
 }
 
 static void
@@ -173,12 +303,71 @@ cd_main_device_invalidate_cb (CdDevice *device,
 	cd_main_device_removed (priv, device);
 }
 
+static void
+cd_main_sender_watch_vanished_cb (GDBusConnection *connection,
+				  const gchar *name,
+				  gpointer user_data)
+{
+	CdMainSenderWatch *watch = (CdMainSenderWatch *) user_data;
+	CdMainPrivate *priv = watch->priv;
+	GObject *object;
+	guint i;
+	g_autoptr(GPtrArray) objects = NULL;
+
+	g_debug ("CdMain: %s vanished, removing %u owned objects",
+		 name, watch->objects->len);
+
+	/* detach the bookkeeping first so the removals below see
+	 * nothing left to unindex */
+	objects = g_ptr_array_ref (watch->objects);
+	for (i = 0; i < objects->len; i++) {
+		g_hash_table_remove (priv->sender_watch_by_object,
+				     g_ptr_array_index (objects, i));
+	}
+	g_hash_table_remove (priv->sender_watches, watch->sender);
+
+	for (i = 0; i < objects->len; i++) {
+		object = g_ptr_array_index (objects, i);
+		if (CD_IS_DEVICE (object))
+			cd_main_device_removed (priv, CD_DEVICE (object));
+		else if (CD_IS_PROFILE (object))
+			cd_main_profile_removed (priv, CD_PROFILE (object));
+	}
+}
+
+static void
+cd_main_sender_watch_add_object (CdMainPrivate *priv,
+				 const gchar *sender,
+				 GObject *object)
+{
+	CdMainSenderWatch *watch;
+
+	watch = g_hash_table_lookup (priv->sender_watches, sender);
+	if (watch == NULL) {
+		watch = g_new0 (CdMainSenderWatch, 1);
+		watch->priv = priv;
+		watch->sender = g_strdup (sender);
+		watch->objects = g_ptr_array_new ();
+		watch->watcher_id = g_bus_watch_name_on_connection (priv->connection,
+								    sender,
+								    G_BUS_NAME_WATCHER_FLAGS_NONE,
+								    NULL,
+								    cd_main_sender_watch_vanished_cb,
+								    watch,
+								    NULL);
+		g_hash_table_insert (priv->sender_watches, watch->sender, watch);
+	}
+	g_ptr_array_add (watch->objects, object);
+	g_hash_table_insert (priv->sender_watch_by_object, object, watch);
+}
+
 static gboolean
 cd_main_add_profile (CdMainPrivate *priv,
 		     CdProfile *profile,
 		     GError **error)
 {
 	/* add */
+	cd_main_query_caches_invalidate (priv);
 	cd_profile_array_add (priv->profiles_array, profile);
 	g_debug ("CdMain: Adding profile %s", cd_profile_get_object_path (profile));
 
@@ -219,7 +408,8 @@ cd_main_create_profile (CdMainPrivate *priv,
 	case CD_OBJECT_SCOPE_TEMP:
 		g_debug ("CdMain: temporary profile");
 		/* setup DBus watcher */
-		cd_profile_watch_sender (profile_tmp, sender);
+		cd_main_sender_watch_add_object (priv, sender,
+						 G_OBJECT (profile_tmp));
 		break;
 	case CD_OBJECT_SCOPE_DISK:
 		g_debug ("CdMain: persistent profile");
@@ -417,6 +607,8 @@ cd_main_device_register_on_bus (CdMainPrivate *priv,
 				CdDevice *device,
 				GError **error)
 {
+	g_autoptr(GVariant) props = NULL;
+
 	/* register object */
 	if (!cd_device_register_object (device,
 					priv->connection,
@@ -436,6 +628,11 @@ cd_main_device_register_on_bus (CdMainPrivate *priv,
 				       g_variant_new ("(o)",
 						      cd_device_get_object_path (device)),
 				       NULL);
+	props = cd_device_get_properties_as_variant (device);
+	cd_main_objmgr_emit_added (priv,
+				   cd_device_get_object_path (device),
+				   COLORD_DBUS_INTERFACE_DEVICE,
+				   props);
 	return TRUE;
 }
 
@@ -472,6 +669,7 @@ cd_main_device_add (CdMainPrivate *priv,
 	}
 
 	/* add to array */
+	cd_main_query_caches_invalidate (priv);
 	cd_device_array_add (priv->devices_array, device);
 
 	/* auto add profiles from the database and metadata */
@@ -543,7 +741,8 @@ cd_main_create_device (CdMainPrivate *priv,
 	/* setup DBus watcher */
 	if (sender != NULL && scope == CD_OBJECT_SCOPE_TEMP) {
 		g_debug ("temporary device");
-		cd_device_watch_sender (device_tmp, sender);
+		cd_main_sender_watch_add_object (priv, sender,
+						 G_OBJECT (device_tmp));
 	}
 
 	/* success */
@@ -629,6 +828,78 @@ cd_main_sensor_array_to_variant (GPtrArray *array)
 				    length);
 }
 
+typedef struct {
+	GDBusMethodInvocation	*invocation;
+	GPtrArray		*sensors;	/* of CdSensor, in call order */
+	CdColorXYZ		*samples;	/* one slot per sensor */
+	gchar			*error_message;
+	guint			 pending;
+} CdMainGetSamplesHelper;
+
+static void
+cd_main_get_samples_helper_free (CdMainGetSamplesHelper *helper)
+{
+	g_ptr_array_unref (helper->sensors);
+	g_free (helper->samples);
+	g_free (helper->error_message);
+	g_free (helper);
+}
+
+static void
+cd_main_get_samples_cb (GObject *source_object,
+			GAsyncResult *res,
+			gpointer user_data)
+{
+	CdMainGetSamplesHelper *helper = (CdMainGetSamplesHelper *) user_data;
+	CdSensor *sensor = CD_SENSOR (source_object);
+	GVariantBuilder builder;
+	guint i;
+	g_autoptr(CdColorXYZ) sample = NULL;
+	g_autoptr(GError) error = NULL;
+
+	/* save in the slot of whichever sensor this was */
+	sample = cd_sensor_measure_finish (sensor, res, &error);
+	if (sample == NULL) {
+		if (helper->error_message == NULL) {
+			helper->error_message = g_strdup_printf ("%s: %s",
+								 cd_sensor_get_id (sensor),
+								 error->message);
+		}
+	} else {
+		for (i = 0; i < helper->sensors->len; i++) {
+			if (g_ptr_array_index (helper->sensors, i) == sensor) {
+				helper->samples[i] = *sample;
+				break;
+			}
+		}
+	}
+
+	/* other sensors are still measuring */
+	if (--helper->pending > 0)
+		return;
+
+	/* all the samples have landed */
+	if (helper->error_message != NULL) {
+		g_dbus_method_invocation_return_error (helper->invocation,
+						       CD_CLIENT_ERROR,
+						       CD_CLIENT_ERROR_INTERNAL,
+						       "failed to get sample: %s",
+						       helper->error_message);
+	} else {
+		g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(ddd)"));
+		for (i = 0; i < helper->sensors->len; i++) {
+			g_variant_builder_add (&builder, "(ddd)",
+					       helper->samples[i].X,
+					       helper->samples[i].Y,
+					       helper->samples[i].Z);
+		}
+		g_dbus_method_invocation_return_value (helper->invocation,
+						       g_variant_new ("(a(ddd))",
+								      &builder));
+	}
+	cd_main_get_samples_helper_free (helper);
+}
+
 static void
 cd_main_profile_auto_add_from_db (CdMainPrivate *priv,
 				  CdProfile *profile)
@@ -705,6 +976,9 @@ cd_main_profile_register_on_bus (CdMainPrivate *priv,
 				 CdLoggingFlags logging,
 				 GError **error)
 {
+	const gchar *checksum;
+	g_autoptr(GVariant) props = NULL;
+
 	/* register object */
 	if (!cd_profile_register_object (profile,
 					 priv->connection,
@@ -712,6 +986,17 @@ cd_main_profile_register_on_bus (CdMainPrivate *priv,
 					 error))
 		return FALSE;
 
+	/* index by content checksum so a profile with the same bytes can be
+	 * found in constant time; the hash holds no reference, the entry is
+	 * dropped when the profile is removed */
+	checksum = cd_profile_get_checksum (profile);
+	if (checksum != NULL &&
+	    g_hash_table_lookup (priv->profiles_checksum, checksum) == NULL) {
+		g_hash_table_insert (priv->profiles_checksum,
+				     g_strdup (checksum),
+				     profile);
+	}
+
 	/* emit signal */
 	g_debug ("CdMain: Emitting ProfileAdded(%s)",
 		 cd_profile_get_object_path (profile));
@@ -725,9 +1010,98 @@ cd_main_profile_register_on_bus (CdMainPrivate *priv,
 				       g_variant_new ("(o)",
 						      cd_profile_get_object_path (profile)),
 				       NULL);
+	props = cd_profile_get_properties_as_variant (profile);
+	cd_main_objmgr_emit_added (priv,
+				   cd_profile_get_object_path (profile),
+				   COLORD_DBUS_INTERFACE_PROFILE,
+				   props);
 	return TRUE;
 }
 
+/* the map, hash and lcms parse of a large profile must not block the
+ * main loop, so CreateProfile finishes on a worker thread and the
+ * invocation is completed from this callback */
+typedef struct {
+	CdMainPrivate		*priv;
+	CdProfile		*profile;
+	GDBusMethodInvocation	*invocation;
+	gchar			*filename;
+	gint			 fd;
+} CdMainProfileLoadHelper;
+
+static void
+cd_main_profile_load_helper_free (CdMainProfileLoadHelper *helper)
+{
+	g_object_unref (helper->profile);
+	g_free (helper->filename);
+	g_free (helper);
+}
+
+static void
+cd_main_profile_load_thread_cb (GTask *task,
+				gpointer source_object,
+				gpointer task_data,
+				GCancellable *cancellable)
+{
+	CdMainProfileLoadHelper *helper = (CdMainProfileLoadHelper *) task_data;
+	GError *error = NULL;
+	gboolean ret;
+
+	if (helper->fd >= 0) {
+		ret = cd_profile_load_from_fd (helper->profile,
+					       helper->fd,
+					       &error);
+	} else {
+		ret = cd_profile_load_from_filename (helper->profile,
+						     helper->filename,
+						     &error);
+	}
+	if (!ret) {
+		g_task_return_error (task, error);
+		return;
+	}
+	g_task_return_boolean (task, TRUE);
+}
+
+static void
+cd_main_profile_load_cb (GObject *source_object,
+			 GAsyncResult *res,
+			 gpointer user_data)
+{
+	CdMainProfileLoadHelper *helper = g_task_get_task_data (G_TASK (res));
+	CdMainPrivate *priv = helper->priv;
+	GVariant *tuple = NULL;
+	GVariant *value = NULL;
+	g_autoptr(GError) error = NULL;
+
+	if (!g_task_propagate_boolean (G_TASK (res), &error)) {
+		g_warning ("CdMain: failed to load profile: %s",
+			   error->message);
+		g_dbus_method_invocation_return_gerror (helper->invocation,
+							error);
+		return;
+	}
+
+	/* auto add profiles from the database and metadata */
+	cd_main_profile_auto_add_from_db (priv, helper->profile);
+	cd_main_profile_auto_add_from_md (priv, helper->profile);
+
+	/* register on bus */
+	if (!cd_main_profile_register_on_bus (priv,
+					      helper->profile,
+					      CD_LOGGING_FLAG_SYSLOG,
+					      &error)) {
+		g_dbus_method_invocation_return_gerror (helper->invocation,
+							error);
+		return;
+	}
+
+	/* format the value */
+	value = g_variant_new_object_path (cd_profile_get_object_path (helper->profile));
+	tuple = g_variant_new_tuple (&value, 1);
+	g_dbus_method_invocation_return_value (helper->invocation, tuple);
+}
+
 static CdProfile *
 cd_main_get_standard_space_metadata (CdMainPrivate *priv,
 				     const gchar *standard_space)
@@ -814,11 +1188,268 @@ cd_main_get_cmdline_for_pid (guint pid)
 	return cmdline;
 }
 
+/* everything CreateDevice does after authorization, so batched creates
+ * can share one polkit check and one pid lookup */
+static CdDevice *
+cd_main_device_create_one (CdMainPrivate *priv,
+			   const gchar *sender,
+			   guint uid,
+			   guint pid,
+			   const gchar *device_id,
+			   const gchar *scope_tmp,
+			   GVariant *dict,
+			   GError **error)
+{
+	CdDeviceKind device_kind;
+	CdObjectScope scope;
+	const gchar *prop_key;
+	const gchar *prop_value;
+	gboolean register_on_bus = TRUE;
+	g_autofree gchar *cmdline = NULL;
+	g_autofree gchar *device_id_fallback = NULL;
+	g_autoptr(CdDevice) device = NULL;
+	g_autoptr(GVariantIter) iter = NULL;
+
+	/* check ID is valid */
+	if (g_strcmp0 (device_id, "") == 0) {
+		g_set_error_literal (error,
+				     CD_CLIENT_ERROR,
+				     CD_CLIENT_ERROR_INPUT_INVALID,
+				     "device id cannot be blank");
+		return NULL;
+	}
+
+	/* check kind is supplied and recognised */
+	if (!g_variant_lookup (dict,
+			       CD_DEVICE_PROPERTY_KIND,
+			       "&s", &prop_value)) {
+		g_set_error_literal (error,
+				     CD_CLIENT_ERROR,
+				     CD_CLIENT_ERROR_INPUT_INVALID,
+				     "required device type not specified");
+		return NULL;
+	}
+	device_kind = cd_device_kind_from_string (prop_value);
+	if (device_kind == CD_DEVICE_KIND_UNKNOWN) {
+		g_set_error (error,
+			     CD_CLIENT_ERROR,
+			     CD_CLIENT_ERROR_INPUT_INVALID,
+			     "device type %s not recognised",
+			     prop_value);
+		return NULL;
+	}
+
+	/* are we using the XRANDR_name property rather than the
+	 * sent device-id? */
+	if (priv->always_use_xrandr_name &&
+	    device_kind == CD_DEVICE_KIND_DISPLAY) {
+		device_id_fallback = cd_main_get_display_fallback_id (dict);
+		if (device_id_fallback == NULL) {
+			g_set_error (error,
+				     CD_CLIENT_ERROR,
+				     CD_CLIENT_ERROR_INPUT_INVALID,
+				     "AlwaysUseXrandrName mode enabled and %s unset",
+				     CD_DEVICE_METADATA_XRANDR_NAME);
+			return NULL;
+		}
+		device_id = device_id_fallback;
+	}
+
+	/* check it does not already exist */
+	scope = cd_object_scope_from_string (scope_tmp);
+	if (scope == CD_OBJECT_SCOPE_UNKNOWN) {
+		g_set_error (error,
+			     CD_CLIENT_ERROR,
+			     CD_CLIENT_ERROR_INPUT_INVALID,
+			     "scope non-valid: %s",
+			     scope_tmp);
+		return NULL;
+	}
+	device = cd_device_array_get_by_id_owner (priv->devices_array,
+						  device_id,
+						  uid,
+						  CD_DEVICE_ARRAY_FLAG_NONE);
+	if (device != NULL) {
+		/* where we try to manually add an existing
+		 * virtual device, which means promoting it to
+		 * an actual physical device */
+		if (cd_device_get_mode (device) == CD_DEVICE_MODE_VIRTUAL) {
+			cd_device_set_mode (device,
+					    CD_DEVICE_MODE_PHYSICAL);
+			register_on_bus = FALSE;
+		} else {
+			g_set_error (error,
+				     CD_CLIENT_ERROR,
+				     CD_CLIENT_ERROR_ALREADY_EXISTS,
+				     "device id '%s' already exists",
+				     device_id);
+			return NULL;
+		}
+	}
+
+	/* create device */
+	g_clear_object (&device);
+	device = cd_main_create_device (priv,
+					sender,
+					device_id,
+					uid,
+					pid,
+					scope,
+					CD_DEVICE_MODE_UNKNOWN,
+					error);
+	if (device == NULL)
+		return NULL;
+
+	/* set the properties */
+	cd_device_set_kind (device, device_kind);
+	iter = g_variant_iter_new (dict);
+	while (g_variant_iter_next (iter, "{&s&s}",
+				    &prop_key, &prop_value)) {
+		if (g_strcmp0 (prop_key, CD_DEVICE_PROPERTY_KIND) == 0)
+			continue;
+		if (!cd_device_set_property_internal (device,
+						      prop_key,
+						      prop_value,
+						      (scope == CD_OBJECT_SCOPE_DISK),
+						      error))
+			return NULL;
+	}
+
+	/* add any extra metadata */
+	cmdline = cd_main_get_cmdline_for_pid (pid);
+	if (cmdline != NULL) {
+		if (!cd_device_set_property_internal (device,
+						      CD_DEVICE_METADATA_OWNER_CMDLINE,
+						      cmdline,
+						      (scope == CD_OBJECT_SCOPE_DISK),
+						      error))
+			return NULL;
+	}
+
+	/* register on bus */
+	if (register_on_bus) {
+		if (!cd_main_device_register_on_bus (priv, device, error))
+			return NULL;
+	}
+	return g_steal_pointer (&device);
+}
+
+typedef struct {
+	CdMainPrivate		*priv;
+	GDBusMethodInvocation	*invocation;
+	GPtrArray		*profiles;	/* of CdProfile */
+	guint			 pending;
+	GError			*error;		/* first failure wins */
+} CdMainProfileBatchHelper;
+
+typedef struct {
+	CdMainProfileBatchHelper *helper;
+	CdProfile		*profile;
+	gchar			*filename;
+	gint			 fd;
+} CdMainProfileBatchItem;
+
 static void
-cd_main_daemon_method_call (GDBusConnection *connection, const gchar *sender,
-			    const gchar *object_path, const gchar *interface_name,
-			    const gchar *method_name, GVariant *parameters,
-			    GDBusMethodInvocation *invocation, gpointer user_data)
+cd_main_profile_batch_item_free (CdMainProfileBatchItem *item)
+{
+	g_object_unref (item->profile);
+	g_free (item->filename);
+	g_free (item);
+}
+
+/* called once every profile in the batch has loaded; either all of the
+ * object paths are returned, or the whole batch is unwound and the
+ * first error is reported */
+static void
+cd_main_profile_batch_finish (CdMainProfileBatchHelper *helper)
+{
+	guint i;
+
+	if (helper->error != NULL) {
+		for (i = 0; i < helper->profiles->len; i++) {
+			cd_main_profile_removed (helper->priv,
+						 g_ptr_array_index (helper->profiles, i));
+		}
+		g_dbus_method_invocation_return_gerror (helper->invocation,
+							helper->error);
+	} else {
+		GVariantBuilder builder;
+		g_variant_builder_init (&builder, G_VARIANT_TYPE ("ao"));
+		for (i = 0; i < helper->profiles->len; i++) {
+			CdProfile *profile_tmp = g_ptr_array_index (helper->profiles, i);
+			g_variant_builder_add (&builder, "o",
+					       cd_profile_get_object_path (profile_tmp));
+		}
+		g_dbus_method_invocation_return_value (helper->invocation,
+						       g_variant_new ("(ao)",
+								      &builder));
+	}
+	g_ptr_array_unref (helper->profiles);
+	g_clear_error (&helper->error);
+	g_free (helper);
+}
+
+static void
+cd_main_profile_batch_load_thread_cb (GTask *task,
+				      gpointer source_object,
+				      gpointer task_data,
+				      GCancellable *cancellable)
+{
+	CdMainProfileBatchItem *item = (CdMainProfileBatchItem *) task_data;
+	GError *error = NULL;
+	gboolean ret;
+
+	if (item->fd >= 0) {
+		ret = cd_profile_load_from_fd (item->profile,
+					       item->fd,
+					       &error);
+	} else {
+		ret = cd_profile_load_from_filename (item->profile,
+						     item->filename,
+						     &error);
+	}
+	if (!ret) {
+		g_task_return_error (task, error);
+		return;
+	}
+	g_task_return_boolean (task, TRUE);
+}
+
+static void
+cd_main_profile_batch_load_cb (GObject *source_object,
+			       GAsyncResult *res,
+			       gpointer user_data)
+{
+	CdMainProfileBatchItem *item = g_task_get_task_data (G_TASK (res));
+	CdMainProfileBatchHelper *helper = item->helper;
+	g_autoptr(GError) error = NULL;
+
+	if (!g_task_propagate_boolean (G_TASK (res), &error)) {
+		if (helper->error == NULL) {
+			g_propagate_prefixed_error (&helper->error,
+						    g_steal_pointer (&error),
+						    "failed to load '%s': ",
+						    cd_profile_get_id (item->profile));
+		}
+	} else if (helper->error == NULL) {
+		/* auto add profiles from the database and metadata */
+		cd_main_profile_auto_add_from_db (helper->priv, item->profile);
+		cd_main_profile_auto_add_from_md (helper->priv, item->profile);
+		if (!cd_main_profile_register_on_bus (helper->priv,
+						      item->profile,
+						      CD_LOGGING_FLAG_SYSLOG,
+						      &error))
+			helper->error = g_steal_pointer (&error);
+	}
+	if (--helper->pending == 0)
+		cd_main_profile_batch_finish (helper);
+}
+
+static void
+cd_main_daemon_method_call_internal (GDBusConnection *connection, const gchar *sender,
+				     const gchar *object_path, const gchar *interface_name,
+				     const gchar *method_name, GVariant *parameters,
+				     GDBusMethodInvocation *invocation, gpointer user_data)
 {
 	CdDeviceKind device_kind;
 	CdMainPrivate *priv = (CdMainPrivate *) user_data;
@@ -831,14 +1462,11 @@ cd_main_daemon_method_call (GDBusConnection *connection, const gchar *sender,
 	const gchar *prop_key;
 	const gchar *prop_value;
 	const gchar *scope_tmp = NULL;
-	gboolean register_on_bus = TRUE;
 	gboolean ret;
 	guint i;
 	guint pid;
 	guint uid;
 	g_autoptr(GError) error = NULL;
-	g_autofree gchar *cmdline = NULL;
-	g_autofree gchar *device_id_fallback = NULL;
 	g_autofree gchar *filename = NULL;
 	g_autoptr(CdDevice) device = NULL;
 	g_autoptr(CdProfile) profile = NULL;
@@ -862,14 +1490,51 @@ cd_main_daemon_method_call (GDBusConnection *connection, const gchar *sender,
 
 		g_debug ("CdMain: %s:GetDevices()", sender);
 
-		/* format the value */
-		array = cd_device_array_get_array (priv->devices_array);
-		value = cd_main_device_array_to_variant (array, uid);
+		/* format the value, cached per-uid in the device array */
+		value = cd_device_array_get_variant (priv->devices_array, uid);
 		tuple = g_variant_new_tuple (&value, 1);
+		g_variant_unref (value);
 		g_dbus_method_invocation_return_value (invocation, tuple);
 		return;
 	}
 
+	/* return 'a{oa{sv}}' */
+	if (g_strcmp0 (method_name, "GetDevicesWithProperties") == 0) {
+		CdDevice *device_tmp;
+		GVariantBuilder builder;
+		guint i;
+
+		g_debug ("CdMain: %s:GetDevicesWithProperties()", sender);
+
+		/* return every device with its full property set so that
+		 * clients can hydrate proxies without a GetAll each */
+		array = cd_device_array_get_array (priv->devices_array);
+		g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{oa{sv}}"));
+		for (i = 0; i < array->len; i++) {
+			g_autoptr(GVariant) props_tmp = NULL;
+			device_tmp = g_ptr_array_index (array, i);
+
+			/* only show devices created by root and the calling
+			 * user, but if called *by* root return all devices
+			 * from all users */
+			if (uid != 0) {
+				if (cd_device_get_owner (device_tmp) != 0 &&
+				    cd_device_get_owner (device_tmp) != uid)
+					continue;
+			}
+
+			/* the snapshot is shared, not rebuilt per caller */
+			props_tmp = cd_device_get_properties_as_variant (device_tmp);
+			g_variant_builder_add (&builder, "{o@a{sv}}",
+					       cd_device_get_object_path (device_tmp),
+					       props_tmp);
+		}
+		g_dbus_method_invocation_return_value (invocation,
+						       g_variant_new ("(a{oa{sv}})",
+								      &builder));
+		return;
+	}
+
 	/* return 'as' */
 	if (g_strcmp0 (method_name, "GetSensors") == 0) {
 
@@ -882,6 +1547,86 @@ cd_main_daemon_method_call (GDBusConnection *connection, const gchar *sender,
 		return;
 	}
 
+	/* return 'a(ddd)' */
+	if (g_strcmp0 (method_name, "GetSamples") == 0) {
+		CdMainGetSamplesHelper *helper;
+		CdSensorCap cap;
+		g_autofree const gchar **sensor_ids = NULL;
+		g_autoptr(GPtrArray) sensors_tmp = NULL;
+
+		g_variant_get (parameters, "(^a&s&s)",
+			       &sensor_ids, &scope_tmp);
+		g_debug ("CdMain: %s:GetSamples(%s)", sender, scope_tmp);
+
+		/* check the capability is sane */
+		cap = cd_sensor_cap_from_string (scope_tmp);
+		if (cap == CD_SENSOR_CAP_UNKNOWN ||
+		    cap == CD_SENSOR_CAP_SPECTRAL) {
+			g_dbus_method_invocation_return_error (invocation,
+							       CD_CLIENT_ERROR,
+							       CD_CLIENT_ERROR_INPUT_INVALID,
+							       "capability %s not recognised",
+							       scope_tmp);
+			return;
+		}
+		if (sensor_ids[0] == NULL) {
+			g_dbus_method_invocation_return_error (invocation,
+							       CD_CLIENT_ERROR,
+							       CD_CLIENT_ERROR_INPUT_INVALID,
+							       "no sensor ids specified");
+			return;
+		}
+
+		/* resolve every sensor before triggering any of them */
+		sensors_tmp = g_ptr_array_new ();
+		for (i = 0; sensor_ids[i] != NULL; i++) {
+			CdSensor *sensor_tmp = NULL;
+			guint j;
+			for (j = 0; j < priv->sensors->len; j++) {
+				CdSensor *sensor_iter;
+				sensor_iter = g_ptr_array_index (priv->sensors, j);
+				if (g_strcmp0 (cd_sensor_get_id (sensor_iter),
+					       sensor_ids[i]) == 0) {
+					sensor_tmp = sensor_iter;
+					break;
+				}
+			}
+			if (sensor_tmp == NULL) {
+				g_dbus_method_invocation_return_error (invocation,
+								       CD_CLIENT_ERROR,
+								       CD_CLIENT_ERROR_NOT_FOUND,
+								       "sensor id '%s' does not exist",
+								       sensor_ids[i]);
+				return;
+			}
+			if (!cd_sensor_can_get_sample (sensor_tmp, &error)) {
+				g_dbus_method_invocation_return_error (invocation,
+								       CD_CLIENT_ERROR,
+								       CD_CLIENT_ERROR_INTERNAL,
+								       "cannot sample %s: %s",
+								       sensor_ids[i],
+								       error->message);
+				return;
+			}
+			g_ptr_array_add (sensors_tmp, sensor_tmp);
+		}
+
+		/* trigger all the sensors at the same time */
+		helper = g_new0 (CdMainGetSamplesHelper, 1);
+		helper->invocation = invocation;
+		helper->sensors = g_steal_pointer (&sensors_tmp);
+		helper->samples = g_new0 (CdColorXYZ, helper->sensors->len);
+		helper->pending = helper->sensors->len;
+		for (i = 0; i < helper->sensors->len; i++) {
+			cd_sensor_measure_async (g_ptr_array_index (helper->sensors, i),
+						 cap,
+						 NULL,
+						 cd_main_get_samples_cb,
+						 helper);
+		}
+		return;
+	}
+
 	/* return 'as' */
 	if (g_strcmp0 (method_name, "GetDevicesByKind") == 0) {
 
@@ -927,15 +1672,29 @@ cd_main_daemon_method_call (GDBusConnection *connection, const gchar *sender,
 
 	/* return 'o' */
 	if (g_strcmp0 (method_name, "FindDeviceById") == 0) {
+		g_autofree gchar *cache_key = NULL;
 
 		g_variant_get (parameters, "(&s)", &device_id);
 		g_debug ("CdMain: %s:FindDeviceById(%s)",
 			 sender, device_id);
+
+		/* asked and answered; misses are flushed on any change */
+		cache_key = g_strdup_printf ("d:%u:%s", uid, device_id);
+		if (g_hash_table_contains (priv->miss_cache, cache_key)) {
+			g_dbus_method_invocation_return_error (invocation,
+							       CD_CLIENT_ERROR,
+							       CD_CLIENT_ERROR_NOT_FOUND,
+							       "device id '%s' does not exist",
+							       device_id);
+			return;
+		}
 		device = cd_device_array_get_by_id_owner (priv->devices_array,
 							  device_id,
 							  uid,
 							  CD_DEVICE_ARRAY_FLAG_OWNER_OPTIONAL);
 		if (device == NULL) {
+			g_hash_table_add (priv->miss_cache,
+					  g_steal_pointer (&cache_key));
 			g_dbus_method_invocation_return_error (invocation,
 							       CD_CLIENT_ERROR,
 							       CD_CLIENT_ERROR_NOT_FOUND,
@@ -1031,14 +1790,28 @@ cd_main_daemon_method_call (GDBusConnection *connection, const gchar *sender,
 
 	/* return 'o' */
 	if (g_strcmp0 (method_name, "FindProfileById") == 0) {
+		g_autofree gchar *cache_key = NULL;
 
 		g_variant_get (parameters, "(&s)", &device_id);
 		g_debug ("CdMain: %s:FindProfileById(%s)",
 			 sender, device_id);
+
+		/* asked and answered; misses are flushed on any change */
+		cache_key = g_strdup_printf ("p:%u:%s", uid, device_id);
+		if (g_hash_table_contains (priv->miss_cache, cache_key)) {
+			g_dbus_method_invocation_return_error (invocation,
+							       CD_CLIENT_ERROR,
+							       CD_CLIENT_ERROR_NOT_FOUND,
+							       "profile id '%s' does not exist",
+							       device_id);
+			return;
+		}
 		profile = cd_profile_array_get_by_id_owner (priv->profiles_array,
 							    device_id,
 							    uid);
 		if (profile == NULL) {
+			g_hash_table_add (priv->miss_cache,
+					  g_steal_pointer (&cache_key));
 			g_dbus_method_invocation_return_error (invocation,
 							       CD_CLIENT_ERROR,
 							       CD_CLIENT_ERROR_NOT_FOUND,
@@ -1055,20 +1828,42 @@ cd_main_daemon_method_call (GDBusConnection *connection, const gchar *sender,
 
 	/* return 'o' */
 	if (g_strcmp0 (method_name, "GetStandardSpace") == 0) {
+		CdProfile *profile_cached;
+		g_autofree gchar *cache_key = NULL;
 
 		g_variant_get (parameters, "(&s)", &device_id);
 		g_debug ("CdMain: %s:GetStandardSpace(%s)",
 			 sender, device_id);
 
-		/* will also return overrides */
-		profile = cd_main_get_standard_space_metadata (priv, device_id);
-		if (profile == NULL) {
+		/* desktop components ask for srgb constantly, so serve
+		 * the resolution from the cache where possible */
+		cache_key = g_strdup_printf ("s:%s", device_id);
+		profile_cached = g_hash_table_lookup (priv->space_cache, device_id);
+		if (profile_cached != NULL) {
+			profile = g_object_ref (profile_cached);
+		} else if (g_hash_table_contains (priv->miss_cache, cache_key)) {
 			g_dbus_method_invocation_return_error (invocation,
 							       CD_CLIENT_ERROR,
 							       CD_CLIENT_ERROR_NOT_FOUND,
 							       "profile space '%s' does not exist",
 							       device_id);
 			return;
+		} else {
+			/* will also return overrides */
+			profile = cd_main_get_standard_space_metadata (priv, device_id);
+			if (profile == NULL) {
+				g_hash_table_add (priv->miss_cache,
+						  g_steal_pointer (&cache_key));
+				g_dbus_method_invocation_return_error (invocation,
+								       CD_CLIENT_ERROR,
+								       CD_CLIENT_ERROR_NOT_FOUND,
+								       "profile space '%s' does not exist",
+								       device_id);
+				return;
+			}
+			g_hash_table_insert (priv->space_cache,
+					     g_strdup (device_id),
+					     g_object_ref (profile));
 		}
 
 		/* format the value */
@@ -1107,6 +1902,7 @@ cd_main_daemon_method_call (GDBusConnection *connection, const gchar *sender,
 		g_debug ("CdMain: %s:GetProfiles()", sender);
 		value = cd_profile_array_get_variant (priv->profiles_array);
 		tuple = g_variant_new_tuple (&value, 1);
+		g_variant_unref (value);
 		g_dbus_method_invocation_return_value (invocation, tuple);
 		return;
 	}
@@ -1131,83 +1927,56 @@ cd_main_daemon_method_call (GDBusConnection *connection, const gchar *sender,
 			       &dict);
 		g_debug ("CdMain: %s:CreateDevice(%s)", sender, device_id);
 
-		/* check ID is valid */
-		if (g_strcmp0 (device_id, "") == 0) {
+		/* get the process that sent the message */
+		pid = cd_main_get_sender_pid (connection, sender, &error);
+		if (pid == G_MAXUINT) {
 			g_dbus_method_invocation_return_error (invocation,
 							       CD_CLIENT_ERROR,
-							       CD_CLIENT_ERROR_INPUT_INVALID,
-							       "device id cannot be blank");
+							       CD_CLIENT_ERROR_INTERNAL,
+							       "failed to get process ID: %s",
+							       error->message);
 			return;
 		}
 
-		/* check kind is supplied and recognised */
-		ret = g_variant_lookup (dict,
-					CD_DEVICE_PROPERTY_KIND,
-					"&s", &prop_value);
-		if (!ret) {
-			g_dbus_method_invocation_return_error (invocation,
-							       CD_CLIENT_ERROR,
-							       CD_CLIENT_ERROR_INPUT_INVALID,
-							       "required device type not specified");
-			return;
-		}
-		device_kind = cd_device_kind_from_string (prop_value);
-		if (device_kind == CD_DEVICE_KIND_UNKNOWN) {
-			g_dbus_method_invocation_return_error (invocation,
-							       CD_CLIENT_ERROR,
-							       CD_CLIENT_ERROR_INPUT_INVALID,
-							       "device type %s not recognised",
-							       prop_value);
+		/* create device */
+		device = cd_main_device_create_one (priv,
+						    sender,
+						    uid,
+						    pid,
+						    device_id,
+						    scope_tmp,
+						    dict,
+						    &error);
+		if (device == NULL) {
+			g_warning ("CdMain: failed to create device: %s",
+				   error->message);
+			g_dbus_method_invocation_return_gerror (invocation, error);
 			return;
 		}
 
-		/* are we using the XRANDR_name property rather than the
-		 * sent device-id? */
-		if (priv->always_use_xrandr_name &&
-		    device_kind == CD_DEVICE_KIND_DISPLAY) {
-			device_id_fallback = cd_main_get_display_fallback_id (dict);
-			if (device_id_fallback == NULL) {
-				g_dbus_method_invocation_return_error (invocation,
-								       CD_CLIENT_ERROR,
-								       CD_CLIENT_ERROR_INPUT_INVALID,
-								       "AlwaysUseXrandrName mode enabled and %s unset",
-								       CD_DEVICE_METADATA_XRANDR_NAME);
-				return;
-			}
-			device_id = device_id_fallback;
-		}
+		/* format the value */
+		value = g_variant_new_object_path (cd_device_get_object_path (device));
+		tuple = g_variant_new_tuple (&value, 1);
+		g_dbus_method_invocation_return_value (invocation, tuple);
+		return;
+	}
 
-		/* check it does not already exist */
-		scope = cd_object_scope_from_string (scope_tmp);
-		if (scope == CD_OBJECT_SCOPE_UNKNOWN) {
-			g_dbus_method_invocation_return_error (invocation,
-							       CD_CLIENT_ERROR,
-							       CD_CLIENT_ERROR_INPUT_INVALID,
-							       "scope non-valid: %s",
-							       scope_tmp);
+	/* return 'ao' */
+	if (g_strcmp0 (method_name, "CreateDevices") == 0) {
+		GVariantBuilder builder;
+		g_autoptr(GPtrArray) devices_created = NULL;
+
+		g_debug ("CdMain: %s:CreateDevices()", sender);
+
+		/* require auth, once for the whole batch */
+		ret = cd_main_sender_authenticated (connection,
+						    sender,
+						    "org.freedesktop.color-manager.create-device",
+						    &error);
+		if (!ret) {
+			g_dbus_method_invocation_return_gerror (invocation, error);
 			return;
 		}
-		device = cd_device_array_get_by_id_owner (priv->devices_array,
-							  device_id,
-							  uid,
-							  CD_DEVICE_ARRAY_FLAG_NONE);
-		if (device != NULL) {
-			/* where we try to manually add an existing
-			 * virtual device, which means promoting it to
-			 * an actual physical device */
-			if (cd_device_get_mode (device) == CD_DEVICE_MODE_VIRTUAL) {
-				cd_device_set_mode (device,
-						    CD_DEVICE_MODE_PHYSICAL);
-				register_on_bus = FALSE;
-			} else {
-				g_dbus_method_invocation_return_error (invocation,
-								       CD_CLIENT_ERROR,
-								       CD_CLIENT_ERROR_ALREADY_EXISTS,
-								       "device id '%s' already exists",
-								       device_id);
-				return;
-			}
-		}
 
 		/* get the process that sent the message */
 		pid = cd_main_get_sender_pid (connection, sender, &error);
@@ -1220,74 +1989,56 @@ cd_main_daemon_method_call (GDBusConnection *connection, const gchar *sender,
 			return;
 		}
 
-		/* create device */
-		device = cd_main_create_device (priv,
-						sender,
-						device_id,
-						uid,
-						pid,
-						scope,
-						CD_DEVICE_MODE_UNKNOWN,
-						&error);
-		if (device == NULL) {
-			g_warning ("CdMain: failed to create device: %s",
-				   error->message);
-			g_dbus_method_invocation_return_gerror (invocation, error);
-			return;
-		}
-
-		/* set the properties */
-		cd_device_set_kind (device, device_kind);
-		iter = g_variant_iter_new (dict);
-		while (g_variant_iter_next (iter, "{&s&s}",
-					    &prop_key, &prop_value)) {
-			if (g_strcmp0 (prop_key, CD_DEVICE_PROPERTY_KIND) == 0)
-				continue;
-			ret = cd_device_set_property_internal (device,
-							       prop_key,
-							       prop_value,
-							       (scope == CD_OBJECT_SCOPE_DISK),
-							       &error);
-			if (!ret) {
-				g_warning ("CdMain: failed to set property on device: %s",
-					   error->message);
-				g_dbus_method_invocation_return_gerror (invocation,
-									error);
-				return;
-			}
-		}
-
-		/* add any extra metadata */
-		cmdline = cd_main_get_cmdline_for_pid (pid);
-		if (cmdline != NULL) {
-			ret = cd_device_set_property_internal (device,
-							       CD_DEVICE_METADATA_OWNER_CMDLINE,
-							       cmdline,
-							       (scope == CD_OBJECT_SCOPE_DISK),
-							       &error);
-			if (!ret) {
-				g_warning ("CdMain: failed to set property on device: %s",
-					   error->message);
-				g_dbus_method_invocation_return_gerror (invocation,
-									error);
-				return;
+		/* all the items have to succeed; any failure unwinds the
+		 * devices already created in this batch */
+		devices_created = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
+		g_variant_get (parameters, "(a(ssa{ss}))", &iter);
+		while (TRUE) {
+			g_autoptr(CdDevice) device_tmp = NULL;
+			g_autoptr(GVariant) dict_tmp = NULL;
+			if (!g_variant_iter_next (iter, "(&s&s@a{ss})",
+						  &device_id,
+						  &scope_tmp,
+						  &dict_tmp))
+				break;
+			device_tmp = cd_main_device_create_one (priv,
+								sender,
+								uid,
+								pid,
+								device_id,
+								scope_tmp,
+								dict_tmp,
+								&error);
+			if (device_tmp == NULL) {
+				g_prefix_error (&error,
+						"failed to create '%s': ",
+						device_id);
+				break;
 			}
+			g_ptr_array_add (devices_created,
+					 g_object_ref (device_tmp));
 		}
-
-		/* register on bus */
-		if (register_on_bus) {
-			ret = cd_main_device_register_on_bus (priv, device, &error);
-			if (!ret) {
-				g_dbus_method_invocation_return_gerror (invocation,
-									error);
-				return;
+		if (error != NULL) {
+			for (i = 0; i < devices_created->len; i++) {
+				cd_main_device_removed (priv,
+							g_ptr_array_index (devices_created, i));
 			}
+			g_warning ("CdMain: failed to create devices: %s",
+				   error->message);
+			g_dbus_method_invocation_return_gerror (invocation, error);
+			return;
 		}
 
 		/* format the value */
-		value = g_variant_new_object_path (cd_device_get_object_path (device));
-		tuple = g_variant_new_tuple (&value, 1);
-		g_dbus_method_invocation_return_value (invocation, tuple);
+		g_variant_builder_init (&builder, G_VARIANT_TYPE ("ao"));
+		for (i = 0; i < devices_created->len; i++) {
+			CdDevice *device_tmp = g_ptr_array_index (devices_created, i);
+			g_variant_builder_add (&builder, "o",
+					       cd_device_get_object_path (device_tmp));
+		}
+		g_dbus_method_invocation_return_value (invocation,
+						       g_variant_new ("(ao)",
+								      &builder));
 		return;
 	}
 
@@ -1382,6 +2133,7 @@ cd_main_daemon_method_call (GDBusConnection *connection, const gchar *sender,
 		GDBusMessage *message;
 		GUnixFDList *fd_list;
 #endif
+		gint fd = -1;
 		gint32 fd_handle = 0;
 
 		/* require auth */
@@ -1477,7 +2229,6 @@ cd_main_daemon_method_call (GDBusConnection *connection, const gchar *sender,
 		message = g_dbus_method_invocation_get_message (invocation);
 		fd_list = g_dbus_message_get_unix_fd_list (message);
 		if (fd_list != NULL && g_unix_fd_list_get_length (fd_list) == 1) {
-			gint fd;
 			fd = g_unix_fd_list_get (fd_list, fd_handle, &error);
 			if (fd < 0) {
 				g_warning ("CdMain: failed to get fd from message: %s",
@@ -1486,66 +2237,239 @@ cd_main_daemon_method_call (GDBusConnection *connection, const gchar *sender,
 									error);
 				return;
 			}
+		}
+#else
+		if (filename == NULL) {
+			g_dbus_method_invocation_return_error (invocation,
+							       CD_CLIENT_ERROR,
+							       CD_CLIENT_ERROR_NOT_SUPPORTED,
+							       "no FD support");
+			return;
+		}
+#endif
 
-			/* read from a fd, avoiding open() */
-			ret = cd_profile_load_from_fd (profile, fd, &error);
-			if (!ret) {
-				g_warning ("CdMain: failed to profile from fd: %s",
-					   error->message);
-				g_dbus_method_invocation_return_gerror (invocation,
-									error);
-				return;
+		/* map, hash and parse on a worker thread so a large
+		 * profile does not stall other callers; the reply is
+		 * completed from cd_main_profile_load_cb */
+		if (fd >= 0 || filename != NULL) {
+			CdMainProfileLoadHelper *helper;
+			g_autoptr(GTask) task = NULL;
+
+			helper = g_new0 (CdMainProfileLoadHelper, 1);
+			helper->priv = priv;
+			helper->profile = g_object_ref (profile);
+			helper->invocation = invocation;
+			helper->filename = g_strdup (filename);
+			helper->fd = fd;
+			task = g_task_new (NULL, NULL,
+					   cd_main_profile_load_cb, NULL);
+			g_task_set_task_data (task, helper,
+					      (GDestroyNotify) cd_main_profile_load_helper_free);
+			g_task_run_in_thread (task, cd_main_profile_load_thread_cb);
+			return;
+		}
+
+		/* virtual profile with nothing to parse */
+		cd_main_profile_auto_add_from_db (priv, profile);
+		cd_main_profile_auto_add_from_md (priv, profile);
+
+		/* register on bus */
+		ret = cd_main_profile_register_on_bus (priv,
+						       profile,
+						       CD_LOGGING_FLAG_SYSLOG,
+						       &error);
+		if (!ret) {
+			g_dbus_method_invocation_return_gerror (invocation, error);
+			return;
+		}
+
+		/* format the value */
+		value = g_variant_new_object_path (cd_profile_get_object_path (profile));
+		tuple = g_variant_new_tuple (&value, 1);
+		g_dbus_method_invocation_return_value (invocation, tuple);
+		return;
+	}
+
+	/* return 'ao' */
+	if (g_strcmp0 (method_name, "CreateProfilesWithFd") == 0) {
+
+#ifdef __unix__
+		GDBusMessage *message;
+		GUnixFDList *fd_list;
+#endif
+		CdMainProfileBatchHelper *helper;
+		g_autoptr(GPtrArray) items = NULL;
+
+		g_debug ("CdMain: %s:CreateProfilesWithFd()", sender);
+
+		/* require auth, once for the whole batch */
+		ret = cd_main_sender_authenticated (connection,
+						    sender,
+						    "org.freedesktop.color-manager.create-profile",
+						    &error);
+		if (!ret) {
+			g_dbus_method_invocation_return_gerror (invocation, error);
+			return;
+		}
+
+#ifdef __unix__
+		message = g_dbus_method_invocation_get_message (invocation);
+		fd_list = g_dbus_message_get_unix_fd_list (message);
+#endif
+
+		helper = g_new0 (CdMainProfileBatchHelper, 1);
+		helper->priv = priv;
+		helper->invocation = invocation;
+		helper->profiles = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
+		items = g_ptr_array_new ();
+
+		/* do all the synchronous setup before parsing anything so
+		 * that a bad entry unwinds the whole batch */
+		g_variant_get (parameters, "(a(ssha{ss}))", &iter);
+		while (TRUE) {
+			CdMainProfileBatchItem *item;
+			gint32 fd_handle = 0;
+			g_autofree gchar *filename_tmp = NULL;
+			g_autoptr(CdProfile) profile_tmp = NULL;
+			g_autoptr(GVariantIter) props = NULL;
+
+			if (!g_variant_iter_next (iter, "(&s&sha{ss})",
+						  &device_id,
+						  &scope_tmp,
+						  &fd_handle,
+						  &props))
+				break;
+
+			/* check ID is valid */
+			if (g_strcmp0 (device_id, "") == 0) {
+				g_set_error_literal (&error,
+						     CD_CLIENT_ERROR,
+						     CD_CLIENT_ERROR_INPUT_INVALID,
+						     "profile id cannot be blank");
+				break;
 			}
 
-		/* clients like CUPS do not use FD passing */
-		} else if (filename != NULL) {
-			ret = cd_profile_load_from_filename (profile,
-							     filename,
-							     &error);
-			if (!ret) {
-				g_warning ("CdMain: failed to profile from filename: %s",
-					   error->message);
-				g_dbus_method_invocation_return_gerror (invocation, error);
-				return;
+			/* check it does not already exist */
+			profile_tmp = cd_profile_array_get_by_id_owner (priv->profiles_array,
+									device_id,
+									uid);
+			if (profile_tmp != NULL) {
+				g_set_error (&error,
+					     CD_CLIENT_ERROR,
+					     CD_CLIENT_ERROR_ALREADY_EXISTS,
+					     "profile id '%s' already exists",
+					     device_id);
+				break;
 			}
-		}
-#else
-		if (filename != NULL) {
-			ret = cd_profile_load_from_filename (profile,
-							     filename,
-							     &error);
-			if (!ret) {
-				g_warning ("CdMain: failed to profile from filename: %s",
-					   error->message);
-				g_dbus_method_invocation_return_gerror (invocation, error);
-				return;
+
+			/* create profile */
+			scope = cd_object_scope_from_string (scope_tmp);
+			if (scope == CD_OBJECT_SCOPE_UNKNOWN) {
+				g_set_error (&error,
+					     CD_CLIENT_ERROR,
+					     CD_CLIENT_ERROR_INPUT_INVALID,
+					     "scope non-valid: %s",
+					     scope_tmp);
+				break;
+			}
+			profile_tmp = cd_main_create_profile (priv,
+							      sender,
+							      device_id,
+							      uid,
+							      scope,
+							      &error);
+			if (profile_tmp == NULL)
+				break;
+			g_ptr_array_add (helper->profiles,
+					 g_object_ref (profile_tmp));
+
+			/* set the properties */
+			while (g_variant_iter_next (props, "{&s&s}",
+						    &prop_key, &prop_value)) {
+				if (g_strcmp0 (prop_key, CD_PROFILE_PROPERTY_FILENAME) == 0) {
+					g_free (filename_tmp);
+					filename_tmp = g_strdup (prop_value);
+				}
+				if (!cd_profile_set_property_internal (profile_tmp,
+								       prop_key,
+								       prop_value,
+								       uid,
+								       &error))
+					break;
+			}
+			if (error != NULL)
+				break;
+
+			item = g_new0 (CdMainProfileBatchItem, 1);
+			item->helper = helper;
+			item->profile = g_object_ref (profile_tmp);
+			item->fd = -1;
+
+			/* a negative handle means there is no fd for this
+			 * entry and the Filename property is used instead */
+#ifdef __unix__
+			if (fd_list != NULL && fd_handle >= 0 &&
+			    fd_handle < g_unix_fd_list_get_length (fd_list)) {
+				item->fd = g_unix_fd_list_get (fd_list,
+							       fd_handle,
+							       &error);
+				if (item->fd < 0) {
+					cd_main_profile_batch_item_free (item);
+					break;
+				}
 			}
-		} else {
-			g_dbus_method_invocation_return_error (invocation,
-							       CD_CLIENT_ERROR,
-							       CD_CLIENT_ERROR_NOT_SUPPORTED,
-							       "no FD support");
-			return;
-		}
 #endif
-		/* auto add profiles from the database and metadata */
-		cd_main_profile_auto_add_from_db (priv, profile);
-		cd_main_profile_auto_add_from_md (priv, profile);
-
-		/* register on bus */
-		ret = cd_main_profile_register_on_bus (priv,
-						       profile,
-						       CD_LOGGING_FLAG_SYSLOG,
-						       &error);
-		if (!ret) {
+			if (item->fd < 0)
+				item->filename = g_steal_pointer (&filename_tmp);
+			g_ptr_array_add (items, item);
+		}
+		if (error != NULL) {
+			for (i = 0; i < items->len; i++)
+				cd_main_profile_batch_item_free (g_ptr_array_index (items, i));
+			for (i = 0; i < helper->profiles->len; i++) {
+				cd_main_profile_removed (priv,
+							 g_ptr_array_index (helper->profiles, i));
+			}
+			g_prefix_error (&error,
+					"failed to create '%s': ",
+					device_id);
+			g_warning ("CdMain: failed to create profiles: %s",
+				   error->message);
 			g_dbus_method_invocation_return_gerror (invocation, error);
+			g_ptr_array_unref (helper->profiles);
+			g_free (helper);
 			return;
 		}
 
-		/* format the value */
-		value = g_variant_new_object_path (cd_profile_get_object_path (profile));
-		tuple = g_variant_new_tuple (&value, 1);
-		g_dbus_method_invocation_return_value (invocation, tuple);
+		/* parse everything with a file to read on worker threads;
+		 * virtual profiles can register straight away */
+		for (i = 0; i < items->len; i++) {
+			CdMainProfileBatchItem *item = g_ptr_array_index (items, i);
+			if (item->fd >= 0 || item->filename != NULL) {
+				g_autoptr(GTask) task = NULL;
+				helper->pending++;
+				task = g_task_new (NULL, NULL,
+						   cd_main_profile_batch_load_cb, NULL);
+				g_task_set_task_data (task, item,
+						      (GDestroyNotify) cd_main_profile_batch_item_free);
+				g_task_run_in_thread (task, cd_main_profile_batch_load_thread_cb);
+				continue;
+			}
+			if (helper->error == NULL) {
+				cd_main_profile_auto_add_from_db (priv, item->profile);
+				cd_main_profile_auto_add_from_md (priv, item->profile);
+				ret = cd_main_profile_register_on_bus (priv,
+								       item->profile,
+								       CD_LOGGING_FLAG_SYSLOG,
+								       &helper->error);
+			}
+			cd_main_profile_batch_item_free (item);
+		}
+
+		/* nothing being parsed, so the reply can go now; otherwise
+		 * the last worker completion sends it */
+		if (helper->pending == 0)
+			cd_main_profile_batch_finish (helper);
 		return;
 	}
 
@@ -1553,6 +2477,25 @@ cd_main_daemon_method_call (GDBusConnection *connection, const gchar *sender,
 	g_critical ("failed to process method %s", method_name);
 }
 
+static void
+cd_main_daemon_method_call (GDBusConnection *connection, const gchar *sender,
+			    const gchar *object_path, const gchar *interface_name,
+			    const gchar *method_name, GVariant *parameters,
+			    GDBusMethodInvocation *invocation, gpointer user_data)
+{
+	gint64 begin;
+
+	/* time how long we spent servicing each method; anything returned
+	 * asynchronously only counts the dispatch, which is what blocks
+	 * the main loop for other callers */
+	begin = cd_debug_trace_begin ();
+	cd_main_daemon_method_call_internal (connection, sender,
+					     object_path, interface_name,
+					     method_name, parameters,
+					     invocation, user_data);
+	cd_debug_trace_end (begin, "method %s from %s", method_name, sender);
+}
+
 static GVariant *
 cd_main_daemon_get_property (GDBusConnection *connection_, const gchar *sender,
 			     const gchar *object_path, const gchar *interface_name,
@@ -1577,6 +2520,78 @@ cd_main_daemon_get_property (GDBusConnection *connection_, const gchar *sender,
 	return NULL;
 }
 
+static void
+cd_main_objmgr_method_call (GDBusConnection *connection, const gchar *sender,
+			    const gchar *object_path, const gchar *interface_name,
+			    const gchar *method_name, GVariant *parameters,
+			    GDBusMethodInvocation *invocation, gpointer user_data)
+{
+	CdMainPrivate *priv = (CdMainPrivate *) user_data;
+	GVariantBuilder builder;
+	guint i;
+	g_autoptr(GPtrArray) devices = NULL;
+	g_autoptr(GPtrArray) profiles = NULL;
+
+	/* return 'a{oa{sa{sv}}}' */
+	if (g_strcmp0 (method_name, "GetManagedObjects") == 0) {
+
+		g_debug ("CdMain: %s:GetManagedObjects()", sender);
+
+		/* every object with every property in one message, so a
+		 * client can mirror the complete daemon state without a
+		 * GetAll round-trip per object */
+		g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{oa{sa{sv}}}"));
+		devices = cd_device_array_get_array (priv->devices_array);
+		for (i = 0; i < devices->len; i++) {
+			CdDevice *device_tmp = g_ptr_array_index (devices, i);
+			GVariantBuilder ifaces;
+			g_autoptr(GVariant) props_tmp = NULL;
+			props_tmp = cd_device_get_properties_as_variant (device_tmp);
+			g_variant_builder_init (&ifaces, G_VARIANT_TYPE ("a{sa{sv}}"));
+			g_variant_builder_add (&ifaces, "{s@a{sv}}",
+					       COLORD_DBUS_INTERFACE_DEVICE,
+					       props_tmp);
+			g_variant_builder_add (&builder, "{oa{sa{sv}}}",
+					       cd_device_get_object_path (device_tmp),
+					       &ifaces);
+		}
+		profiles = cd_profile_array_get_array (priv->profiles_array);
+		for (i = 0; i < profiles->len; i++) {
+			CdProfile *profile_tmp = g_ptr_array_index (profiles, i);
+			GVariantBuilder ifaces;
+			g_autoptr(GVariant) props_tmp = NULL;
+			props_tmp = cd_profile_get_properties_as_variant (profile_tmp);
+			g_variant_builder_init (&ifaces, G_VARIANT_TYPE ("a{sa{sv}}"));
+			g_variant_builder_add (&ifaces, "{s@a{sv}}",
+					       COLORD_DBUS_INTERFACE_PROFILE,
+					       props_tmp);
+			g_variant_builder_add (&builder, "{oa{sa{sv}}}",
+					       cd_profile_get_object_path (profile_tmp),
+					       &ifaces);
+		}
+		for (i = 0; i < priv->sensors->len; i++) {
+			CdSensor *sensor_tmp = g_ptr_array_index (priv->sensors, i);
+			GVariantBuilder ifaces;
+			g_autoptr(GVariant) props_tmp = NULL;
+			props_tmp = cd_sensor_get_properties_as_variant (sensor_tmp);
+			g_variant_builder_init (&ifaces, G_VARIANT_TYPE ("a{sa{sv}}"));
+			g_variant_builder_add (&ifaces, "{s@a{sv}}",
+					       COLORD_DBUS_INTERFACE_SENSOR,
+					       props_tmp);
+			g_variant_builder_add (&builder, "{oa{sa{sv}}}",
+					       cd_sensor_get_object_path (sensor_tmp),
+					       &ifaces);
+		}
+		g_dbus_method_invocation_return_value (invocation,
+						       g_variant_new ("(a{oa{sa{sv}}})",
+								      &builder));
+		return;
+	}
+
+	/* we suck */
+	g_critical ("failed to process method %s", method_name);
+}
+
 static void
 cd_main_on_bus_acquired_cb (GDBusConnection *connection,
 			    const gchar *name,
@@ -1589,6 +2604,11 @@ cd_main_on_bus_acquired_cb (GDBusConnection *connection,
 		cd_main_daemon_get_property,
 		NULL
 	};
+	static const GDBusInterfaceVTable objmgr_vtable = {
+		cd_main_objmgr_method_call,
+		NULL,
+		NULL
+	};
 
 	priv->connection = g_object_ref (connection);
 	registration_id = g_dbus_connection_register_object (connection,
@@ -1599,6 +2619,16 @@ cd_main_on_bus_acquired_cb (GDBusConnection *connection,
 							     NULL,  /* user_data_free_func */
 							     NULL); /* GError** */
 	g_assert (registration_id > 0);
+
+	/* the standard ObjectManager interface lives on the same path */
+	registration_id = g_dbus_connection_register_object (connection,
+							     COLORD_DBUS_PATH,
+							     priv->introspection_objmgr->interfaces[0],
+							     &objmgr_vtable,
+							     priv,  /* user_data */
+							     NULL,  /* user_data_free_func */
+							     NULL); /* GError** */
+	g_assert (registration_id > 0);
 }
 
 static void
@@ -1607,6 +2637,7 @@ cd_main_icc_store_added_cb (CdIccStore *icc_store,
 			    gpointer user_data)
 {
 	CdMainPrivate *priv = (CdMainPrivate *) user_data;
+	CdProfile *profile_exists;
 	const gchar *checksum;
 	const gchar *filename;
 	gboolean ret;
@@ -1614,6 +2645,19 @@ cd_main_icc_store_added_cb (CdIccStore *icc_store,
 	g_autofree gchar *profile_id = NULL;
 	g_autoptr(CdProfile) profile = NULL;
 
+	/* the same bytes may exist in more than one search location, e.g.
+	 * when a second seat installs an identical file; reuse the profile
+	 * already on the bus rather than announcing a duplicate */
+	checksum = cd_icc_get_checksum (icc);
+	profile_exists = checksum != NULL ?
+		g_hash_table_lookup (priv->profiles_checksum, checksum) : NULL;
+	if (profile_exists != NULL) {
+		g_debug ("CdMain: %s already registered as %s",
+			 cd_icc_get_filename (icc),
+			 cd_profile_get_object_path (profile_exists));
+		return;
+	}
+
 	/* create profile */
 	profile = cd_profile_new ();
 	filename = cd_icc_get_filename (icc);
@@ -1673,6 +2717,7 @@ cd_main_icc_store_removed_cb (CdIccStore *icc_store,
 	if (profile == NULL)
 		return;
 	g_debug ("%s removed, so invalidating", cd_icc_get_filename (icc));
+	cd_main_profile_checksum_remove (priv, profile);
 	cd_profile_array_remove (priv->profiles_array, profile);
 }
 
@@ -1752,6 +2797,8 @@ cd_main_sensor_register_on_bus (CdMainPrivate *priv,
 				CdSensor *sensor,
 				GError **error)
 {
+	g_autoptr(GVariant) props = NULL;
+
 	/* register object */
 	if (!cd_sensor_register_object (sensor,
 					priv->connection,
@@ -1771,6 +2818,11 @@ cd_main_sensor_register_on_bus (CdMainPrivate *priv,
 				       g_variant_new ("(o)",
 						      cd_sensor_get_object_path (sensor)),
 				       NULL);
+	props = cd_sensor_get_properties_as_variant (sensor);
+	cd_main_objmgr_emit_added (priv,
+				   cd_sensor_get_object_path (sensor),
+				   COLORD_DBUS_INTERFACE_SENSOR,
+				   props);
 	return TRUE;
 }
 
@@ -1844,6 +2896,112 @@ cd_main_plugin_phase (CdMainPrivate *priv, CdPluginPhase phase)
 	}
 }
 
+static void
+cd_main_plugin_coldplug_thread_cb (GTask *task,
+				   gpointer source_object,
+				   gpointer task_data,
+				   GCancellable *cancellable)
+{
+	CdPlugin *plugin = (CdPlugin *) task_data;
+	CdPluginFunc plugin_func = NULL;
+
+	if (g_module_symbol (plugin->module,
+			     "cd_plugin_coldplug",
+			     (gpointer *) &plugin_func)) {
+		g_debug ("run cd_plugin_coldplug on %s",
+			 g_module_name (plugin->module));
+		plugin_func (plugin);
+		g_debug ("finished cd_plugin_coldplug on %s",
+			 g_module_name (plugin->module));
+	}
+	g_task_return_boolean (task, TRUE);
+}
+
+static gboolean
+cd_main_coldplug_cb (gpointer user_data)
+{
+	CdMainPrivate *priv = (CdMainPrivate *) user_data;
+	gboolean ret;
+	gint64 begin;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(CdSensor) sensor = NULL;
+
+	/* one expensive phase per main loop iteration, so D-Bus calls that
+	 * arrived in the meantime are answered in between; profiles are
+	 * announced incrementally from the ::added signal as each search
+	 * finds them */
+	switch (priv->coldplug_phase++) {
+	case 0:
+		/* search system locations for ICC profiles */
+		begin = cd_debug_trace_begin ();
+		ret = cd_icc_store_search_kind (priv->icc_store,
+						CD_ICC_STORE_SEARCH_KIND_SYSTEM,
+						CD_ICC_STORE_SEARCH_FLAGS_NONE,
+						NULL,
+						&error);
+		cd_debug_trace_end (begin, "icc-store scan system");
+		if (!ret) {
+			g_warning ("CdMain: failed to search system directories: %s",
+				    error->message);
+		}
+		break;
+	case 1:
+		/* search machine locations for ICC profiles */
+		begin = cd_debug_trace_begin ();
+		ret = cd_icc_store_search_kind (priv->icc_store,
+						CD_ICC_STORE_SEARCH_KIND_MACHINE,
+						CD_ICC_STORE_SEARCH_FLAGS_NONE,
+						NULL,
+						&error);
+		cd_debug_trace_end (begin, "icc-store scan machine");
+		if (!ret) {
+			g_warning ("CdMain: failed to search machine directories: %s",
+				    error->message);
+		}
+		break;
+	case 2:
+		/* add sensor devices */
+		cd_sensor_client_coldplug (priv->sensor_client);
+
+		/* add dummy sensor */
+		if (priv->create_dummy_sensor) {
+			sensor = cd_sensor_new ();
+			cd_sensor_set_kind (sensor, CD_SENSOR_KIND_DUMMY);
+			ret = cd_sensor_load (sensor, &error);
+			if (!ret) {
+				g_warning ("CdMain: failed to load dummy sensor: %s",
+					    error->message);
+				g_clear_error (&error);
+			} else {
+				cd_main_add_sensor (priv, sensor);
+			}
+		}
+		break;
+	case 3: {
+		CdPlugin *plugin;
+		guint i;
+
+		/* coldplug each plugin on its own worker thread so one
+		 * slow enumeration cannot hold back the others or the
+		 * main loop; devices are announced back through an
+		 * idle handler in the main context */
+		for (i = 0; i < priv->plugins->len; i++) {
+			g_autoptr(GTask) task = NULL;
+			plugin = g_ptr_array_index (priv->plugins, i);
+			task = g_task_new (NULL, NULL, NULL, NULL);
+			g_task_set_task_data (task, plugin, NULL);
+			g_task_run_in_thread (task,
+					      cd_main_plugin_coldplug_thread_cb);
+		}
+		break;
+	}
+	default:
+		priv->coldplug_id = 0;
+		return G_SOURCE_REMOVE;
+	}
+	return G_SOURCE_CONTINUE;
+}
+
 static void
 cd_main_on_name_acquired_cb (GDBusConnection *connection,
 			     const gchar *name,
@@ -1851,10 +3009,8 @@ cd_main_on_name_acquired_cb (GDBusConnection *connection,
 {
 	CdMainPrivate *priv = (CdMainPrivate *) user_data;
 	const gchar *device_id;
-	gboolean ret;
 	guint i;
 	g_autoptr(GError) error = NULL;
-	g_autoptr(CdSensor) sensor = NULL;
 	g_autoptr(GPtrArray) array_devices = NULL;
 
 	g_debug ("CdMain: acquired name: %s", name);
@@ -1863,6 +3019,8 @@ cd_main_on_name_acquired_cb (GDBusConnection *connection,
 	priv->icc_store = cd_icc_store_new ();
 	cd_icc_store_set_load_flags (priv->icc_store, CD_ICC_LOAD_FLAGS_FALLBACK_MD5);
 	cd_icc_store_set_cache (priv->icc_store, cd_get_resource ());
+	cd_icc_store_set_index_location (priv->icc_store,
+					 LOCALSTATEDIR "/lib/colord/icc-store");
 	g_signal_connect (priv->icc_store, "added",
 			  G_CALLBACK (cd_main_icc_store_added_cb),
 			  user_data);
@@ -1870,29 +3028,8 @@ cd_main_on_name_acquired_cb (GDBusConnection *connection,
 			  G_CALLBACK (cd_main_icc_store_removed_cb),
 			  user_data);
 
-	/* search locations for ICC profiles */
-	ret = cd_icc_store_search_kind (priv->icc_store,
-					CD_ICC_STORE_SEARCH_KIND_SYSTEM,
-					CD_ICC_STORE_SEARCH_FLAGS_NONE,
-					NULL,
-					&error);
-	if (!ret) {
-		g_warning ("CdMain: failed to search system directories: %s",
-			    error->message);
-		return;
-	}
-	ret = cd_icc_store_search_kind (priv->icc_store,
-					CD_ICC_STORE_SEARCH_KIND_MACHINE,
-					CD_ICC_STORE_SEARCH_FLAGS_NONE,
-					NULL,
-					&error);
-	if (!ret) {
-		g_warning ("CdMain: failed to search machine directories: %s",
-			    error->message);
-		return;
-	}
-
-	/* add disk devices */
+	/* add disk devices from the persistent index, so cheap queries can
+	 * be answered straight away */
 	array_devices = cd_device_db_get_devices (priv->device_db, &error);
 	if (array_devices == NULL) {
 		g_warning ("CdMain: failed to get the disk devices: %s",
@@ -1904,25 +3041,9 @@ cd_main_on_name_acquired_cb (GDBusConnection *connection,
 		cd_main_add_disk_device (priv, device_id);
 	}
 
-	/* add sensor devices */
-	cd_sensor_client_coldplug (priv->sensor_client);
-
-	/* coldplug plugin devices */
-	cd_main_plugin_phase (priv, CD_PLUGIN_PHASE_COLDPLUG);
-
-	/* add dummy sensor */
-	if (priv->create_dummy_sensor) {
-		sensor = cd_sensor_new ();
-		cd_sensor_set_kind (sensor, CD_SENSOR_KIND_DUMMY);
-		ret = cd_sensor_load (sensor, &error);
-		if (!ret) {
-			g_warning ("CdMain: failed to load dummy sensor: %s",
-				    error->message);
-			g_clear_error (&error);
-		} else {
-			cd_main_add_sensor (priv, sensor);
-		}
-	}
+	/* defer the expensive profile scanning and coldplug until after we
+	 * have started answering D-Bus calls */
+	priv->coldplug_id = g_idle_add (cd_main_coldplug_cb, priv);
 }
 
 static void
@@ -1964,9 +3085,208 @@ cd_main_client_sensor_removed_cb (CdSensorClient *sensor_client_,
 				       g_variant_new ("(o)",
 						      cd_sensor_get_object_path (sensor)),
 				       NULL);
+	cd_main_objmgr_emit_removed (priv,
+				     cd_sensor_get_object_path (sensor),
+				     COLORD_DBUS_INTERFACE_SENSOR);
 	g_ptr_array_remove (priv->sensors, sensor);
 }
 
+#define CD_MAIN_SNAPSHOT_VERSION	1
+
+static gchar *
+cd_main_get_snapshot_path (void)
+{
+	return g_build_filename (LOCALSTATEDIR, "lib", "colord",
+				 "snapshot.bin", NULL);
+}
+
+/* written on clean shutdown; each entry is re-validated against the
+ * file mtime and size before the checksum is trusted, so a stale
+ * snapshot costs nothing but the hash it failed to save */
+static void
+cd_main_snapshot_save (CdMainPrivate *priv)
+{
+	CdProfile *profile_tmp;
+	GStatBuf st;
+	GVariantBuilder builder;
+	const gchar *checksum;
+	const gchar *filename;
+	guint cnt = 0;
+	guint i;
+	g_autofree gchar *path = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) profiles = NULL;
+	g_autoptr(GVariant) value = NULL;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(stts)"));
+	profiles = cd_profile_array_get_array (priv->profiles_array);
+	for (i = 0; i < profiles->len; i++) {
+		profile_tmp = g_ptr_array_index (profiles, i);
+		filename = cd_profile_get_filename (profile_tmp);
+		checksum = cd_profile_get_checksum (profile_tmp);
+		if (filename == NULL || checksum == NULL)
+			continue;
+		if (g_stat (filename, &st) != 0)
+			continue;
+		g_variant_builder_add (&builder, "(stts)",
+				       filename,
+				       (guint64) st.st_mtime,
+				       (guint64) st.st_size,
+				       checksum);
+		cnt++;
+	}
+	value = g_variant_ref_sink (g_variant_new ("(ua(stts))",
+						   (guint32) CD_MAIN_SNAPSHOT_VERSION,
+						   &builder));
+	path = cd_main_get_snapshot_path ();
+	if (!g_file_set_contents (path,
+				  g_variant_get_data (value),
+				  g_variant_get_size (value),
+				  &error)) {
+		g_warning ("CdMain: failed to save snapshot: %s",
+			   error->message);
+		return;
+	}
+	g_debug ("CdMain: saved %u profile checksums to %s", cnt, path);
+}
+
+/* returns a map of "icc-<checksum>" profile id to filename for every
+ * profile in the snapshot, or %NULL when there was nothing to restore */
+static GHashTable *
+cd_main_snapshot_restore (void)
+{
+	const gchar *checksum;
+	const gchar *filename;
+	guint cnt = 0;
+	guint32 version = 0;
+	guint64 mtime;
+	guint64 size;
+	gsize len = 0;
+	g_autofree gchar *data = NULL;
+	g_autofree gchar *path = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GHashTable) map = NULL;
+	g_autoptr(GVariant) value = NULL;
+	g_autoptr(GVariantIter) iter = NULL;
+
+	path = cd_main_get_snapshot_path ();
+	if (!g_file_get_contents (path, &data, &len, &error)) {
+		g_debug ("CdMain: no snapshot to restore: %s",
+			 error->message);
+		return NULL;
+	}
+	value = g_variant_ref_sink (g_variant_new_from_data (G_VARIANT_TYPE ("(ua(stts))"),
+							     data, len,
+							     FALSE, NULL, NULL));
+	if (!g_variant_is_normal_form (value)) {
+		g_warning ("CdMain: ignoring corrupt snapshot %s", path);
+		return NULL;
+	}
+	g_variant_get (value, "(ua(stts))", &version, &iter);
+	if (version != CD_MAIN_SNAPSHOT_VERSION) {
+		g_debug ("CdMain: ignoring snapshot version %u", version);
+		return NULL;
+	}
+	map = g_hash_table_new_full (g_str_hash, g_str_equal,
+				     g_free, g_free);
+	while (g_variant_iter_next (iter, "(&stt&s)",
+				    &filename, &mtime, &size, &checksum)) {
+		cd_profile_add_checksum_hint (filename, mtime, size, checksum);
+		g_hash_table_insert (map,
+				     g_strdup_printf ("icc-%s", checksum),
+				     g_strdup (filename));
+		cnt++;
+	}
+	g_debug ("CdMain: restored %u profile checksums from %s", cnt, path);
+	return g_steal_pointer (&map);
+}
+
+static void
+cd_main_profile_prefetch_thread_cb (GTask *task,
+				    gpointer source_object,
+				    gpointer task_data,
+				    GCancellable *cancellable)
+{
+	GPtrArray *filenames = (GPtrArray *) task_data;
+	guint i;
+
+	for (i = 0; i < filenames->len; i++) {
+		const gchar *filename = g_ptr_array_index (filenames, i);
+		g_autoptr(GError) error = NULL;
+		if (!cd_profile_prewarm_filename (filename, &error)) {
+			g_debug ("CdMain: failed to prefetch %s: %s",
+				 filename, error->message);
+			continue;
+		}
+		g_debug ("CdMain: prefetched %s", filename);
+	}
+	g_task_return_boolean (task, TRUE);
+}
+
+/* warm the profiles most recently mapped to devices we have seen
+ * before, so the common login path -- same monitors as yesterday --
+ * finds every needed profile already parsed when the session registers
+ * it; @snapshot maps profile id to the filename from the last run */
+static void
+cd_main_profile_prefetch (CdMainPrivate *priv, GHashTable *snapshot)
+{
+	guint i, j;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GHashTable) seen = NULL;
+	g_autoptr(GPtrArray) array_devices = NULL;
+	g_autoptr(GPtrArray) filenames = NULL;
+	g_autoptr(GTask) task = NULL;
+
+	array_devices = cd_device_db_get_devices (priv->device_db, &error);
+	if (array_devices == NULL) {
+		g_warning ("CdMain: failed to get disk devices for prefetch: %s",
+			   error->message);
+		return;
+	}
+	seen = g_hash_table_new (g_str_hash, g_str_equal);
+	filenames = g_ptr_array_new_with_free_func (g_free);
+	for (i = 0; i < array_devices->len; i++) {
+		const gchar *device_id = g_ptr_array_index (array_devices, i);
+		g_autoptr(GError) error_local = NULL;
+		g_autoptr(GPtrArray) array_profiles = NULL;
+
+		array_profiles = cd_mapping_db_get_profiles (priv->mapping_db,
+							     device_id,
+							     &error_local);
+		if (array_profiles == NULL) {
+			g_debug ("CdMain: no mappings for %s: %s",
+				 device_id, error_local->message);
+			continue;
+		}
+		for (j = 0; j < array_profiles->len; j++) {
+			const gchar *profile_id = g_ptr_array_index (array_profiles, j);
+			const gchar *filename;
+
+			/* zero means the mapping was manually removed */
+			if (cd_mapping_db_get_timestamp (priv->mapping_db,
+							 device_id,
+							 profile_id,
+							 NULL) == 0)
+				continue;
+			filename = g_hash_table_lookup (snapshot, profile_id);
+			if (filename == NULL)
+				continue;
+			if (!g_hash_table_add (seen, (gpointer) filename))
+				continue;
+			g_ptr_array_add (filenames, g_strdup (filename));
+		}
+	}
+	if (filenames->len == 0)
+		return;
+	g_debug ("CdMain: prefetching %u profiles from mapping history",
+		 filenames->len);
+	task = g_task_new (NULL, NULL, NULL, NULL);
+	g_task_set_task_data (task,
+			      g_steal_pointer (&filenames),
+			      (GDestroyNotify) g_ptr_array_unref);
+	g_task_run_in_thread (task, cd_main_profile_prefetch_thread_cb);
+}
+
 static gboolean
 cd_main_timed_exit_cb (gpointer user_data)
 {
@@ -2003,29 +3323,62 @@ cd_main_plugin_free (CdPlugin *plugin)
 }
 
 static void
-cd_main_plugin_device_added_cb (CdPlugin *plugin,
-				CdDevice *device,
-				gpointer user_data)
+/* plugin callbacks can fire from coldplug worker threads, so the
+ * daemon state is only ever touched from an idle in the main context */
+typedef struct {
+	CdMainPrivate		*priv;
+	CdDevice		*device;
+	gboolean		 added;
+} CdMainPluginDeviceHelper;
+
+static gboolean
+cd_main_plugin_device_idle_cb (gpointer user_data)
 {
-	CdMainPrivate *priv = (CdMainPrivate *) user_data;
+	CdMainPluginDeviceHelper *helper = (CdMainPluginDeviceHelper *) user_data;
+	CdMainPrivate *priv = helper->priv;
 	gboolean ret;
 	g_autoptr(GError) error = NULL;
 
-	cd_device_set_mode (device, CD_DEVICE_MODE_PHYSICAL);
-	ret = cd_main_device_add (priv, device, NULL, &error);
-	if (!ret) {
-		g_warning ("CdMain: failed to add device: %s",
-			   error->message);
-		return;
-	}
+	if (helper->added) {
+		cd_device_set_mode (helper->device, CD_DEVICE_MODE_PHYSICAL);
+		ret = cd_main_device_add (priv, helper->device, NULL, &error);
+		if (!ret) {
+			g_warning ("CdMain: failed to add device: %s",
+				   error->message);
+			goto out;
+		}
 
-	/* register on bus */
-	ret = cd_main_device_register_on_bus (priv, device, &error);
-	if (!ret) {
-		g_warning ("CdMain: failed to emit DeviceAdded: %s",
-			   error->message);
-		return;
+		/* register on bus */
+		ret = cd_main_device_register_on_bus (priv, helper->device,
+						      &error);
+		if (!ret) {
+			g_warning ("CdMain: failed to emit DeviceAdded: %s",
+				   error->message);
+			goto out;
+		}
+	} else {
+		g_debug ("CdMain: remove device: %s",
+			 cd_device_get_id (helper->device));
+		cd_main_device_removed (priv, helper->device);
 	}
+out:
+	g_object_unref (helper->device);
+	g_free (helper);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+cd_main_plugin_device_added_cb (CdPlugin *plugin,
+				CdDevice *device,
+				gpointer user_data)
+{
+	CdMainPluginDeviceHelper *helper;
+
+	helper = g_new0 (CdMainPluginDeviceHelper, 1);
+	helper->priv = (CdMainPrivate *) user_data;
+	helper->device = g_object_ref (device);
+	helper->added = TRUE;
+	g_idle_add (cd_main_plugin_device_idle_cb, helper);
 }
 
 static void
@@ -2033,9 +3386,13 @@ cd_main_plugin_device_removed_cb (CdPlugin *plugin,
 				  CdDevice *device,
 				  gpointer user_data)
 {
-	CdMainPrivate *priv = (CdMainPrivate *) user_data;
-	g_debug ("CdMain: remove device: %s", cd_device_get_id (device));
-	cd_main_device_removed (priv, device);
+	CdMainPluginDeviceHelper *helper;
+
+	helper = g_new0 (CdMainPluginDeviceHelper, 1);
+	helper->priv = (CdMainPrivate *) user_data;
+	helper->device = g_object_ref (device);
+	helper->added = FALSE;
+	g_idle_add (cd_main_plugin_device_idle_cb, helper);
 }
 
 static gboolean
@@ -2338,6 +3695,14 @@ cd_main_dmi_setup (CdMainPrivate *priv)
 	priv->system_model = cd_main_dmi_get_model ();
 }
 
+static gboolean
+cd_main_sigusr2_cb (gpointer user_data)
+{
+	/* dump the recent operation history for post-mortem debugging */
+	cd_debug_ring_dump ();
+	return G_SOURCE_CONTINUE;
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -2362,6 +3727,7 @@ main (int argc, char *argv[])
 		{ NULL}
 	};
 	g_autoptr(GError) error = NULL;
+	g_autoptr(GHashTable) snapshot = NULL;
 
 	setlocale (LC_ALL, "");
 
@@ -2386,8 +3752,30 @@ main (int argc, char *argv[])
 	priv = g_new0 (CdMainPrivate, 1);
 	priv->create_dummy_sensor = create_dummy_sensor;
 	priv->loop = g_main_loop_new (NULL, FALSE);
+
+	/* dump the recent operation history on demand */
+	g_unix_signal_add (SIGUSR2, cd_main_sigusr2_cb, NULL);
 	priv->devices_array = cd_device_array_new ();
 	priv->profiles_array = cd_profile_array_new ();
+	priv->profiles_checksum = g_hash_table_new_full (g_str_hash,
+							 g_str_equal,
+							 g_free,
+							 NULL);
+	priv->space_cache = g_hash_table_new_full (g_str_hash,
+						   g_str_equal,
+						   g_free,
+						   (GDestroyNotify) g_object_unref);
+	priv->miss_cache = g_hash_table_new_full (g_str_hash,
+						  g_str_equal,
+						  g_free,
+						  NULL);
+	/* the watch owns its key string */
+	priv->sender_watches = g_hash_table_new_full (g_str_hash,
+						      g_str_equal,
+						      NULL,
+						      (GDestroyNotify) cd_main_sender_watch_free);
+	priv->sender_watch_by_object = g_hash_table_new (g_direct_hash,
+							 g_direct_equal);
 	priv->sensors = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
 	priv->sensor_client = cd_sensor_client_new ();
 	g_signal_connect (priv->sensor_client, "sensor-added",
@@ -2397,10 +3785,11 @@ main (int argc, char *argv[])
 			  G_CALLBACK (cd_main_client_sensor_removed_cb),
 			  priv);
 
-	/* connect to the mapping db */
+	/* connect to the mapping db; this opens the single shared
+	 * connection and migrates any legacy mapping.db data */
 	priv->mapping_db = cd_mapping_db_new ();
 	ret = cd_mapping_db_load (priv->mapping_db,
-				  LOCALSTATEDIR "/lib/colord/mapping.db",
+				  LOCALSTATEDIR "/lib/colord/storage.db",
 				  &error);
 	if (!ret) {
 		g_warning ("CdMain: failed to load mapping database: %s",
@@ -2408,22 +3797,31 @@ main (int argc, char *argv[])
 		goto out;
 	}
 
-	/* connect to the device db */
+	/* connect to the device db, sharing the connection and page cache */
 	priv->device_db = cd_device_db_new ();
-	ret = cd_device_db_load (priv->device_db,
-				 LOCALSTATEDIR "/lib/colord/storage.db",
-				 &error);
+	ret = cd_device_db_load_with_connection (priv->device_db,
+						 cd_mapping_db_get_connection (priv->mapping_db),
+						 &error);
 	if (!ret) {
 		g_warning ("CdMain: failed to load device database: %s",
 			   error->message);
 		goto out;
 	}
 
-	/* connect to the profile db */
+	/* hydrate every device's properties in one query, so restoring the
+	 * disk devices at coldplug does not run one query per property */
+	ret = cd_device_db_preload (priv->device_db, &error);
+	if (!ret) {
+		g_warning ("CdMain: failed to preload device properties: %s",
+			   error->message);
+		g_clear_error (&error);
+	}
+
+	/* connect to the profile db, sharing the connection and page cache */
 	priv->profile_db = cd_profile_db_new ();
-	ret = cd_profile_db_load (priv->profile_db,
-				  LOCALSTATEDIR "/lib/colord/storage.db",
-				  &error);
+	ret = cd_profile_db_load_with_connection (priv->profile_db,
+						  cd_mapping_db_get_connection (priv->mapping_db),
+						  &error);
 	if (!ret) {
 		g_warning ("CdMain: failed to load profile database: %s",
 			   error->message);
@@ -2459,6 +3857,13 @@ main (int argc, char *argv[])
 			   error->message);
 		goto out;
 	}
+	priv->introspection_objmgr = cd_main_load_introspection (COLORD_DBUS_INTERFACE_OBJECT_MANAGER ".xml",
+								 &error);
+	if (priv->introspection_objmgr == NULL) {
+		g_warning ("CdMain: failed to load object manager introspection: %s",
+			   error->message);
+		goto out;
+	}
 
 	/* own the object */
 	owner_id = g_bus_own_name (G_BUS_TYPE_SYSTEM,
@@ -2497,10 +3902,19 @@ main (int argc, char *argv[])
 	g_debug ("System vendor: '%s', System model: '%s'",
 		 priv->system_vendor, priv->system_model);
 
+	/* reuse checksums persisted by the last clean shutdown, and warm
+	 * the profiles most recently mapped to already-known devices */
+	snapshot = cd_main_snapshot_restore ();
+	if (snapshot != NULL)
+		cd_main_profile_prefetch (priv, snapshot);
+
 	/* wait */
 	g_info ("Daemon ready for requests");
 	g_main_loop_run (priv->loop);
 
+	/* persist checksums for a fast next start */
+	cd_main_snapshot_save (priv);
+
 	/* run the plugins */
 	cd_main_plugin_phase (priv, CD_PLUGIN_PHASE_DESTROY);
 
@@ -2512,6 +3926,8 @@ out:
 	if (owner_id > 0)
 		g_bus_unown_name (owner_id);
 	if (priv != NULL) {
+		if (priv->coldplug_id != 0)
+			g_source_remove (priv->coldplug_id);
 		if (priv->loop != NULL)
 			g_main_loop_unref (priv->loop);
 		if (priv->sensors != NULL)
@@ -2532,6 +3948,16 @@ out:
 			g_object_unref (priv->devices_array);
 		if (priv->profiles_array != NULL)
 			g_object_unref (priv->profiles_array);
+		if (priv->profiles_checksum != NULL)
+			g_hash_table_unref (priv->profiles_checksum);
+		if (priv->space_cache != NULL)
+			g_hash_table_unref (priv->space_cache);
+		if (priv->miss_cache != NULL)
+			g_hash_table_unref (priv->miss_cache);
+		if (priv->sender_watches != NULL)
+			g_hash_table_unref (priv->sender_watches);
+		if (priv->sender_watch_by_object != NULL)
+			g_hash_table_unref (priv->sender_watch_by_object);
 		if (priv->connection != NULL)
 			g_object_unref (priv->connection);
 		if (priv->introspection_daemon != NULL)
@@ -2542,6 +3968,8 @@ out:
 			g_dbus_node_info_unref (priv->introspection_profile);
 		if (priv->introspection_sensor != NULL)
 			g_dbus_node_info_unref (priv->introspection_sensor);
+		if (priv->introspection_objmgr != NULL)
+			g_dbus_node_info_unref (priv->introspection_objmgr);
 		g_free (priv->system_vendor);
 		g_free (priv->system_model);
 		g_free (priv);
@@ -28,21 +28,273 @@
 #include <sqlite3.h>
 
 #include "cd-common.h"
+#include "cd-debug.h"
 #include "cd-mapping-db.h"
 
 static void     cd_mapping_db_finalize	(GObject        *object);
 
 #define GET_PRIVATE(o) (cd_mapping_db_get_instance_private (o))
 
+typedef enum {
+	CD_MAPPING_DB_OP_UPSERT,
+	CD_MAPPING_DB_OP_DELETE,
+	CD_MAPPING_DB_OP_EMPTY,
+	CD_MAPPING_DB_OP_QUIT
+} CdMappingDbOp;
+
+typedef struct
+{
+	CdMappingDbOp		 op;
+	gchar			*device;
+	gchar			*profile;
+	gint64			 timestamp;
+	guint64			 seq;
+} CdMappingDbItem;
+
 typedef struct
 {
 	sqlite3			*db;
+	sqlite3			*db_flush;	/* owned by the flush thread */
+	sqlite3_stmt		*stmt_add;
+	sqlite3_stmt		*stmt_remove;
+	GPtrArray		*items;		/* of CdMappingDbItem */
+	GHashTable		*index_by_device; /* device -> GPtrArray of borrowed items */
+	GHashTable		*index_by_profile; /* profile -> GPtrArray of borrowed items */
+	GMutex			 mutex;		/* protects items and the indexes */
+	GThread			*flush_thread;
+	GAsyncQueue		*flush_queue;	/* of CdMappingDbItem */
+	guint64			 seq;
 } CdMappingDbPrivate;
 
 static gpointer cd_mapping_db_object = NULL;
 
 G_DEFINE_TYPE_WITH_PRIVATE (CdMappingDb, cd_mapping_db, G_TYPE_OBJECT)
 
+static void
+cd_mapping_db_item_free (CdMappingDbItem *item)
+{
+	g_free (item->device);
+	g_free (item->profile);
+	g_free (item);
+}
+
+/* oldest assigned profile first, insertion order for identical timestamps */
+static gint
+cd_mapping_db_item_sort_cb (gconstpointer a, gconstpointer b)
+{
+	CdMappingDbItem *item_a = *((CdMappingDbItem **) a);
+	CdMappingDbItem *item_b = *((CdMappingDbItem **) b);
+
+	if (item_a->timestamp < item_b->timestamp)
+		return -1;
+	if (item_a->timestamp > item_b->timestamp)
+		return 1;
+	if (item_a->seq < item_b->seq)
+		return -1;
+	if (item_a->seq > item_b->seq)
+		return 1;
+	return 0;
+}
+
+/* the index helpers all borrow the items owned by priv->items and must
+ * be called with the mutex held */
+static void
+cd_mapping_db_index_insert (GHashTable *index,
+			    const gchar *key,
+			    CdMappingDbItem *item)
+{
+	GPtrArray *array;
+
+	array = g_hash_table_lookup (index, key);
+	if (array == NULL) {
+		array = g_ptr_array_new ();
+		g_hash_table_insert (index, g_strdup (key), array);
+	}
+	g_ptr_array_add (array, item);
+}
+
+static void
+cd_mapping_db_index_delete (GHashTable *index,
+			    const gchar *key,
+			    CdMappingDbItem *item)
+{
+	GPtrArray *array;
+
+	array = g_hash_table_lookup (index, key);
+	if (array == NULL)
+		return;
+	g_ptr_array_remove_fast (array, item);
+	if (array->len == 0)
+		g_hash_table_remove (index, key);
+}
+
+static void
+cd_mapping_db_index_item (CdMappingDb *mdb, CdMappingDbItem *item)
+{
+	CdMappingDbPrivate *priv = GET_PRIVATE (mdb);
+	cd_mapping_db_index_insert (priv->index_by_device, item->device, item);
+	cd_mapping_db_index_insert (priv->index_by_profile, item->profile, item);
+}
+
+static void
+cd_mapping_db_unindex_item (CdMappingDb *mdb, CdMappingDbItem *item)
+{
+	CdMappingDbPrivate *priv = GET_PRIVATE (mdb);
+	cd_mapping_db_index_delete (priv->index_by_device, item->device, item);
+	cd_mapping_db_index_delete (priv->index_by_profile, item->profile, item);
+}
+
+/* finds an entry in the authoritative cache; the caller must hold the mutex */
+static CdMappingDbItem *
+cd_mapping_db_cache_find (CdMappingDb *mdb,
+			  const gchar *device_id,
+			  const gchar *profile_id)
+{
+	CdMappingDbPrivate *priv = GET_PRIVATE (mdb);
+	CdMappingDbItem *item;
+	GPtrArray *array;
+	guint i;
+
+	/* only the few profiles assigned to this device, not every
+	 * mapping ever seen */
+	array = g_hash_table_lookup (priv->index_by_device, device_id);
+	if (array == NULL)
+		return NULL;
+	for (i = 0; i < array->len; i++) {
+		item = g_ptr_array_index (array, i);
+		if (g_strcmp0 (item->profile, profile_id) == 0)
+			return item;
+	}
+	return NULL;
+}
+
+/* hands a mutation to the write-behind thread */
+static void
+cd_mapping_db_queue_item (CdMappingDb *mdb,
+			  CdMappingDbOp op,
+			  const gchar *device_id,
+			  const gchar *profile_id,
+			  gint64 timestamp)
+{
+	CdMappingDbPrivate *priv = GET_PRIVATE (mdb);
+	CdMappingDbItem *item;
+
+	item = g_new0 (CdMappingDbItem, 1);
+	item->op = op;
+	item->device = g_strdup (device_id);
+	item->profile = g_strdup (profile_id);
+	item->timestamp = timestamp;
+	g_async_queue_push (priv->flush_queue, item);
+}
+
+static void
+cd_mapping_db_flush_item (CdMappingDb *mdb, CdMappingDbItem *item)
+{
+	CdMappingDbPrivate *priv = GET_PRIVATE (mdb);
+	gint rc = SQLITE_DONE;
+
+	switch (item->op) {
+	case CD_MAPPING_DB_OP_UPSERT:
+		sqlite3_reset (priv->stmt_add);
+		sqlite3_bind_text (priv->stmt_add, 1, item->device, -1, SQLITE_STATIC);
+		sqlite3_bind_text (priv->stmt_add, 2, item->profile, -1, SQLITE_STATIC);
+		sqlite3_bind_int64 (priv->stmt_add, 3, item->timestamp);
+		rc = sqlite3_step (priv->stmt_add);
+		break;
+	case CD_MAPPING_DB_OP_DELETE:
+		sqlite3_reset (priv->stmt_remove);
+		sqlite3_bind_text (priv->stmt_remove, 1, item->device, -1, SQLITE_STATIC);
+		sqlite3_bind_text (priv->stmt_remove, 2, item->profile, -1, SQLITE_STATIC);
+		rc = sqlite3_step (priv->stmt_remove);
+		break;
+	case CD_MAPPING_DB_OP_EMPTY:
+		if (sqlite3_exec (priv->db_flush, "DELETE FROM mappings_v2;",
+				  NULL, NULL, NULL) != SQLITE_OK)
+			rc = SQLITE_ERROR;
+		break;
+	default:
+		break;
+	}
+	if (rc != SQLITE_DONE) {
+		g_warning ("CdMappingDb: failed to flush mapping %s<=>%s: %s",
+			   item->device, item->profile,
+			   sqlite3_errmsg (priv->db_flush));
+	}
+}
+
+static gpointer
+cd_mapping_db_flush_thread_cb (gpointer user_data)
+{
+	CdMappingDb *mdb = CD_MAPPING_DB (user_data);
+	CdMappingDbPrivate *priv = GET_PRIVATE (mdb);
+	CdMappingDbItem *item;
+	gboolean exiting = FALSE;
+	gint64 begin;
+	guint cnt;
+
+	while (!exiting) {
+
+		/* wait until there is something to do */
+		item = g_async_queue_pop (priv->flush_queue);
+
+		/* batch all the queued mutations into one transaction,
+		 * waiting a little for more to arrive before we commit */
+		begin = cd_debug_trace_begin ();
+		cnt = 0;
+		if (sqlite3_exec (priv->db_flush, "BEGIN;",
+				  NULL, NULL, NULL) != SQLITE_OK) {
+			/* not fatal, the items just autocommit one by one */
+			g_warning ("CdMappingDb: failed to begin transaction: %s",
+				   sqlite3_errmsg (priv->db_flush));
+		}
+		while (item != NULL) {
+			if (item->op == CD_MAPPING_DB_OP_QUIT) {
+				exiting = TRUE;
+				cd_mapping_db_item_free (item);
+				break;
+			}
+			cd_mapping_db_flush_item (mdb, item);
+			cd_mapping_db_item_free (item);
+			cnt++;
+			item = g_async_queue_timeout_pop (priv->flush_queue,
+							  10 * G_TIME_SPAN_MILLISECOND);
+		}
+		if (sqlite3_exec (priv->db_flush, "COMMIT;",
+				  NULL, NULL, NULL) != SQLITE_OK) {
+			/* the in-memory cache stays authoritative, only
+			 * durability of this batch was lost; roll back so
+			 * the next batch does not pile into a transaction
+			 * that may never commit */
+			g_warning ("CdMappingDb: failed to commit %u items: %s",
+				   cnt, sqlite3_errmsg (priv->db_flush));
+			sqlite3_exec (priv->db_flush, "ROLLBACK;",
+				      NULL, NULL, NULL);
+		}
+		cd_debug_trace_end (begin, "mapping-db commit of %u items", cnt);
+	}
+	return NULL;
+}
+
+static gboolean
+cd_mapping_db_prepare (sqlite3 *db,
+		       const gchar *sql,
+		       sqlite3_stmt **stmt,
+		       GError **error)
+{
+	gint rc;
+
+	rc = sqlite3_prepare_v2 (db, sql, -1, stmt, NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error (error,
+			     CD_CLIENT_ERROR,
+			     CD_CLIENT_ERROR_INTERNAL,
+			     "Failed to prepare statement: SQL error: %s",
+			     sqlite3_errmsg (db));
+		return FALSE;
+	}
+	return TRUE;
+}
+
 static gint
 cd_mapping_db_convert_cb (void *data, gint argc, gchar **argv, gchar **col_name)
 {
@@ -121,9 +373,92 @@ cd_mapping_db_open (CdMappingDb *mdb,
 		}
 	}
 
+	/* use write-ahead logging so writers do not block readers, and
+	 * only fsync at checkpoint time rather than for every commit */
+	rc = sqlite3_exec (priv->db,
+			   "PRAGMA journal_mode=WAL;"
+			   "PRAGMA synchronous=NORMAL;",
+			   NULL, NULL, &error_msg);
+	if (rc != SQLITE_OK) {
+		g_set_error (error,
+			     CD_CLIENT_ERROR,
+			     CD_CLIENT_ERROR_INTERNAL,
+			     "Failed to enable WAL mode: SQL error: %s",
+			     error_msg);
+		sqlite3_free (error_msg);
+		return FALSE;
+	}
+
+	/* the write-behind thread gets its own connection so its batched
+	 * transactions never enclose the synchronous writes the device
+	 * and profile databases make on the shared handle */
+	rc = sqlite3_open (filename, &priv->db_flush);
+	if (rc != SQLITE_OK) {
+		g_set_error (error,
+			     CD_CLIENT_ERROR,
+			     CD_CLIENT_ERROR_INTERNAL,
+			     "Can't open flush connection: %s\n",
+			     sqlite3_errmsg (priv->db_flush));
+		sqlite3_close (priv->db_flush);
+		priv->db_flush = NULL;
+		sqlite3_close (priv->db);
+		priv->db = NULL;
+		return FALSE;
+	}
+	rc = sqlite3_exec (priv->db_flush,
+			   "PRAGMA journal_mode=WAL;"
+			   "PRAGMA synchronous=NORMAL;",
+			   NULL, NULL, &error_msg);
+	if (rc != SQLITE_OK) {
+		g_set_error (error,
+			     CD_CLIENT_ERROR,
+			     CD_CLIENT_ERROR_INTERNAL,
+			     "Failed to enable WAL mode: SQL error: %s",
+			     error_msg);
+		sqlite3_free (error_msg);
+		sqlite3_close (priv->db_flush);
+		priv->db_flush = NULL;
+		sqlite3_close (priv->db);
+		priv->db = NULL;
+		return FALSE;
+	}
+
+	/* WAL still serializes writers across connections; wait for the
+	 * other side rather than failing with SQLITE_BUSY */
+	sqlite3_busy_timeout (priv->db, 5000);
+	sqlite3_busy_timeout (priv->db_flush, 5000);
+
 	return TRUE;
 }
 
+/* returns the connection so the other daemon databases can share it
+ * and its page cache; this handle always stays in autocommit as the
+ * write-behind thread batches its transactions on a connection of its
+ * own, so a synchronous write here commits (or fails) on its own */
+sqlite3 *
+cd_mapping_db_get_connection (CdMappingDb *mdb)
+{
+	CdMappingDbPrivate *priv = GET_PRIVATE (mdb);
+	g_return_val_if_fail (CD_IS_MAPPING_DB (mdb), NULL);
+	return priv->db;
+}
+
+static gboolean
+cd_mapping_db_is_empty (CdMappingDb *mdb)
+{
+	CdMappingDbPrivate *priv = GET_PRIVATE (mdb);
+	gboolean ret;
+	sqlite3_stmt *stmt = NULL;
+
+	if (sqlite3_prepare_v2 (priv->db,
+				"SELECT device FROM mappings_v2 LIMIT 1;",
+				-1, &stmt, NULL) != SQLITE_OK)
+		return TRUE;
+	ret = sqlite3_step (stmt) != SQLITE_ROW;
+	sqlite3_finalize (stmt);
+	return ret;
+}
+
 gboolean
 cd_mapping_db_load (CdMappingDb *mdb,
 		    const gchar *filename,
@@ -132,7 +467,10 @@ cd_mapping_db_load (CdMappingDb *mdb,
 	CdMappingDbPrivate *priv = GET_PRIVATE (mdb);
 	const gchar *statement;
 	gchar *error_msg = NULL;
+	gchar *statement_tmp = NULL;
 	gint rc;
+	sqlite3_stmt *stmt = NULL;
+	g_autofree gchar *legacy_filename = NULL;
 	g_autofree gchar *path = NULL;
 
 	g_return_val_if_fail (CD_IS_MAPPING_DB (mdb), FALSE);
@@ -141,18 +479,6 @@ cd_mapping_db_load (CdMappingDb *mdb,
 	if (!cd_mapping_db_open (mdb, filename, TRUE, error))
 		return FALSE;
 
-	/* we don't need to keep doing fsync */
-	rc = sqlite3_exec (priv->db, "PRAGMA synchronous=OFF",
-			   NULL, NULL, &error_msg);
-	if (rc != SQLITE_OK) {
-		g_set_error (error,
-			     CD_CLIENT_ERROR,
-			     CD_CLIENT_ERROR_INTERNAL,
-			     "Failed to turn off synchronous operations: SQL error: %s",
-			     error_msg);
-		sqlite3_free (error_msg);
-		return FALSE;
-	}
 	/* check mappings */
 	rc = sqlite3_exec (priv->db, "SELECT * FROM mappings LIMIT 1",
 			   NULL, NULL, &error_msg);
@@ -221,6 +547,84 @@ cd_mapping_db_load (CdMappingDb *mdb,
 			return FALSE;
 		}
 	}
+
+	/* migrate the legacy standalone mapping.db into this database the
+	 * first time we are pointed at a shared file (since 1.4.6) */
+	path = g_path_get_dirname (filename);
+	legacy_filename = g_build_filename (path, "mapping.db", NULL);
+	if (g_strcmp0 (filename, legacy_filename) != 0 &&
+	    g_file_test (legacy_filename, G_FILE_TEST_EXISTS) &&
+	    cd_mapping_db_is_empty (mdb)) {
+		g_debug ("CdMappingDb: migrating mappings from %s",
+			 legacy_filename);
+		statement_tmp = sqlite3_mprintf ("ATTACH DATABASE '%q' AS legacy;",
+						 legacy_filename);
+		rc = sqlite3_exec (priv->db, statement_tmp, NULL, NULL, &error_msg);
+		sqlite3_free (statement_tmp);
+		if (rc != SQLITE_OK) {
+			g_warning ("CdMappingDb: failed to attach %s: %s",
+				   legacy_filename, error_msg);
+			sqlite3_free (error_msg);
+		} else {
+			/* old file may predate the v2 table */
+			rc = sqlite3_exec (priv->db,
+					   "INSERT INTO mappings_v2 (device, profile, timestamp) "
+					   "SELECT device, profile, timestamp FROM legacy.mappings_v2;",
+					   NULL, NULL, NULL);
+			if (rc != SQLITE_OK) {
+				sqlite3_exec (priv->db,
+					      "INSERT INTO mappings_v2 (device, profile, timestamp) "
+					      "SELECT device, profile, timestamp FROM legacy.mappings;",
+					      NULL, NULL, NULL);
+			}
+			sqlite3_exec (priv->db, "DETACH DATABASE legacy;",
+				      NULL, NULL, NULL);
+		}
+	}
+
+	/* prepare the statements we run for every mapping just once, so
+	 * a device-add storm at login does not re-parse the SQL */
+	if (!cd_mapping_db_prepare (priv->db_flush,
+				    "INSERT OR REPLACE INTO mappings_v2 (device, profile, timestamp) "
+				    "VALUES (?1, ?2, ?3);",
+				    &priv->stmt_add, error))
+		return FALSE;
+	if (!cd_mapping_db_prepare (priv->db_flush,
+				    "DELETE FROM mappings_v2 WHERE "
+				    "device = ?1 AND profile = ?2;",
+				    &priv->stmt_remove, error))
+		return FALSE;
+
+	/* load the authoritative cache we answer all queries from */
+	if (!cd_mapping_db_prepare (priv->db,
+				    "SELECT device, profile, timestamp "
+				    "FROM mappings_v2;",
+				    &stmt, error))
+		return FALSE;
+	while ((rc = sqlite3_step (stmt)) == SQLITE_ROW) {
+		CdMappingDbItem *item = g_new0 (CdMappingDbItem, 1);
+		item->device = g_strdup ((const gchar *) sqlite3_column_text (stmt, 0));
+		item->profile = g_strdup ((const gchar *) sqlite3_column_text (stmt, 1));
+		item->timestamp = sqlite3_column_int64 (stmt, 2);
+		item->seq = priv->seq++;
+		g_ptr_array_add (priv->items, item);
+		cd_mapping_db_index_item (mdb, item);
+	}
+	sqlite3_finalize (stmt);
+	if (rc != SQLITE_DONE) {
+		g_set_error (error,
+			     CD_CLIENT_ERROR,
+			     CD_CLIENT_ERROR_INTERNAL,
+			     "SQL error: %s",
+			     sqlite3_errmsg (priv->db));
+		return FALSE;
+	}
+
+	/* durability is handled off the main loop, with mutations written
+	 * back in batched transactions */
+	priv->flush_thread = g_thread_new ("CdMappingDb",
+					   cd_mapping_db_flush_thread_cb,
+					   mdb);
 	return TRUE;
 }
 
@@ -229,28 +633,47 @@ cd_mapping_db_empty (CdMappingDb *mdb,
 		     GError  **error)
 {
 	CdMappingDbPrivate *priv = GET_PRIVATE (mdb);
-	const gchar *statement;
-	gchar *error_msg = NULL;
-	gint rc;
 
 	g_return_val_if_fail (CD_IS_MAPPING_DB (mdb), FALSE);
 	g_return_val_if_fail (priv->db != NULL, FALSE);
 
-	statement = "DELETE FROM mappings_v2;";
-	rc = sqlite3_exec (priv->db, statement,
-			   NULL, NULL, &error_msg);
-	if (rc != SQLITE_OK) {
-		g_set_error (error,
-			     CD_CLIENT_ERROR,
-			     CD_CLIENT_ERROR_INTERNAL,
-			     "SQL error: %s",
-			     error_msg);
-		sqlite3_free (error_msg);
-		return FALSE;
-	}
+	g_mutex_lock (&priv->mutex);
+	g_hash_table_remove_all (priv->index_by_device);
+	g_hash_table_remove_all (priv->index_by_profile);
+	g_ptr_array_set_size (priv->items, 0);
+	g_mutex_unlock (&priv->mutex);
+	cd_mapping_db_queue_item (mdb, CD_MAPPING_DB_OP_EMPTY, NULL, NULL, 0);
 	return TRUE;
 }
 
+/* updates the authoritative cache so D-Bus callers see the new mapping
+ * without waiting for the disk, then queues the write-behind */
+static void
+cd_mapping_db_upsert (CdMappingDb *mdb,
+		      const gchar *device_id,
+		      const gchar *profile_id,
+		      gint64 timestamp)
+{
+	CdMappingDbPrivate *priv = GET_PRIVATE (mdb);
+	CdMappingDbItem *item;
+
+	g_mutex_lock (&priv->mutex);
+	item = cd_mapping_db_cache_find (mdb, device_id, profile_id);
+	if (item == NULL) {
+		item = g_new0 (CdMappingDbItem, 1);
+		item->device = g_strdup (device_id);
+		item->profile = g_strdup (profile_id);
+		g_ptr_array_add (priv->items, item);
+		cd_mapping_db_index_item (mdb, item);
+	}
+	item->timestamp = timestamp;
+	item->seq = priv->seq++;
+	g_mutex_unlock (&priv->mutex);
+
+	cd_mapping_db_queue_item (mdb, CD_MAPPING_DB_OP_UPSERT,
+				  device_id, profile_id, timestamp);
+}
+
 gboolean
 cd_mapping_db_add (CdMappingDb *mdb,
 		   const gchar *device_id,
@@ -258,37 +681,14 @@ cd_mapping_db_add (CdMappingDb *mdb,
 		   GError  **error)
 {
 	CdMappingDbPrivate *priv = GET_PRIVATE (mdb);
-	gboolean ret = TRUE;
-	gchar *error_msg = NULL;
-	gchar *statement;
-	gint rc;
-	gint64 timestamp;
 
 	g_return_val_if_fail (CD_IS_MAPPING_DB (mdb), FALSE);
 	g_return_val_if_fail (priv->db != NULL, FALSE);
 
 	g_debug ("CdMappingDb: add %s<=>%s",
 		 device_id, profile_id);
-	timestamp = g_get_real_time ();
-	statement = sqlite3_mprintf ("INSERT OR REPLACE INTO mappings_v2 (device, profile, timestamp) "
-				     "VALUES ('%q', '%q', %"G_GINT64_FORMAT")",
-				     device_id, profile_id, timestamp);
-
-	/* insert the entry */
-	rc = sqlite3_exec (priv->db, statement, NULL, NULL, &error_msg);
-	if (rc != SQLITE_OK) {
-		g_set_error (error,
-			     CD_CLIENT_ERROR,
-			     CD_CLIENT_ERROR_INTERNAL,
-			     "SQL error: %s",
-			     error_msg);
-		sqlite3_free (error_msg);
-		ret = FALSE;
-		goto out;
-	}
-out:
-	sqlite3_free (statement);
-	return ret;
+	cd_mapping_db_upsert (mdb, device_id, profile_id, g_get_real_time ());
+	return TRUE;
 }
 
 /**
@@ -306,35 +706,14 @@ cd_mapping_db_clear_timestamp (CdMappingDb *mdb,
 			       GError  **error)
 {
 	CdMappingDbPrivate *priv = GET_PRIVATE (mdb);
-	gboolean ret = TRUE;
-	gchar *error_msg = NULL;
-	gchar *statement;
-	gint rc;
 
 	g_return_val_if_fail (CD_IS_MAPPING_DB (mdb), FALSE);
 	g_return_val_if_fail (priv->db != NULL, FALSE);
 
 	g_debug ("CdMappingDb: clearing timestamp %s<=>%s",
 		 device_id, profile_id);
-	statement = sqlite3_mprintf ("INSERT OR REPLACE INTO mappings_v2 (device, profile, timestamp) "
-				     "VALUES ('%q', '%q', 0);",
-				     device_id, profile_id);
-
-	/* update the entry */
-	rc = sqlite3_exec (priv->db, statement, NULL, NULL, &error_msg);
-	if (rc != SQLITE_OK) {
-		g_set_error (error,
-			     CD_CLIENT_ERROR,
-			     CD_CLIENT_ERROR_INTERNAL,
-			     "SQL error: %s",
-			     error_msg);
-		sqlite3_free (error_msg);
-		ret = FALSE;
-		goto out;
-	}
-out:
-	sqlite3_free (statement);
-	return ret;
+	cd_mapping_db_upsert (mdb, device_id, profile_id, 0);
+	return TRUE;
 }
 
 /**
@@ -350,48 +729,24 @@ cd_mapping_db_remove (CdMappingDb *mdb,
 		      GError  **error)
 {
 	CdMappingDbPrivate *priv = GET_PRIVATE (mdb);
-	gboolean ret = TRUE;
-	gchar *error_msg = NULL;
-	gchar *statement;
-	gint rc;
+	CdMappingDbItem *item;
 
 	g_return_val_if_fail (CD_IS_MAPPING_DB (mdb), FALSE);
 	g_return_val_if_fail (priv->db != NULL, FALSE);
 
 	g_debug ("CdMappingDb: remove %s<=>%s", device_id, profile_id);
-	statement = sqlite3_mprintf ("DELETE FROM mappings_v2 WHERE "
-				     "device = '%q' AND profile = '%q';",
-				     device_id, profile_id);
 
 	/* remove the entry */
-	rc = sqlite3_exec (priv->db, statement, NULL, NULL, &error_msg);
-	if (rc != SQLITE_OK) {
-		g_set_error (error,
-			     CD_CLIENT_ERROR,
-			     CD_CLIENT_ERROR_INTERNAL,
-			     "SQL error: %s",
-			     error_msg);
-		sqlite3_free (error_msg);
-		ret = FALSE;
-		goto out;
+	g_mutex_lock (&priv->mutex);
+	item = cd_mapping_db_cache_find (mdb, device_id, profile_id);
+	if (item != NULL) {
+		cd_mapping_db_unindex_item (mdb, item);
+		g_ptr_array_remove (priv->items, item);
 	}
-out:
-	sqlite3_free (statement);
-	return ret;
-}
-
-static gint
-cd_mapping_db_sqlite_cb (void *data,
-			 gint argc,
-			 gchar **argv,
-			 gchar **col_name)
-{
-	GPtrArray *array = (GPtrArray *) data;
-
-	/* should only be one entry */
-	g_debug ("CdMappingDb: got sql entry %s", argv[0]);
-	g_ptr_array_add (array, g_strdup (argv[0]));
-	return 0;
+	g_mutex_unlock (&priv->mutex);
+	cd_mapping_db_queue_item (mdb, CD_MAPPING_DB_OP_DELETE,
+				  device_id, profile_id, 0);
+	return TRUE;
 }
 
 /**
@@ -406,41 +761,35 @@ cd_mapping_db_get_profiles (CdMappingDb *mdb,
 			    GError  **error)
 {
 	CdMappingDbPrivate *priv = GET_PRIVATE (mdb);
-	gchar *error_msg = NULL;
-	gchar *statement;
-	gint rc;
-	GPtrArray *array = NULL;
-	g_autoptr(GPtrArray) array_tmp = NULL;
+	CdMappingDbItem *item;
+	GPtrArray *array;
+	GPtrArray *indexed;
+	guint i;
+	g_autoptr(GPtrArray) items_tmp = NULL;
 
 	g_return_val_if_fail (CD_IS_MAPPING_DB (mdb), NULL);
 	g_return_val_if_fail (priv->db != NULL, NULL);
 
 	g_debug ("CdMappingDb: get profiles for %s", device_id);
-	statement = sqlite3_mprintf ("SELECT profile FROM mappings_v2 WHERE "
-				     "device = '%q' AND timestamp > 0 "
-				     "ORDER BY timestamp ASC;", device_id);
 
-	/* remove the entry */
-	array_tmp = g_ptr_array_new_with_free_func (g_free);
-	rc = sqlite3_exec (priv->db,
-			   statement,
-			   cd_mapping_db_sqlite_cb,
-			   array_tmp,
-			   &error_msg);
-	if (rc != SQLITE_OK) {
-		g_set_error (error,
-			     CD_CLIENT_ERROR,
-			     CD_CLIENT_ERROR_INTERNAL,
-			     "SQL error: %s",
-			     error_msg);
-		sqlite3_free (error_msg);
-		goto out;
+	/* find the entries in the per-device index */
+	array = g_ptr_array_new_with_free_func (g_free);
+	items_tmp = g_ptr_array_new ();
+	g_mutex_lock (&priv->mutex);
+	indexed = g_hash_table_lookup (priv->index_by_device, device_id);
+	for (i = 0; indexed != NULL && i < indexed->len; i++) {
+		item = g_ptr_array_index (indexed, i);
+		if (item->timestamp > 0)
+			g_ptr_array_add (items_tmp, item);
+	}
+	g_ptr_array_sort (items_tmp, cd_mapping_db_item_sort_cb);
+	for (i = 0; i < items_tmp->len; i++) {
+		item = g_ptr_array_index (items_tmp, i);
+		g_ptr_array_add (array, g_strdup (item->profile));
 	}
+	g_mutex_unlock (&priv->mutex);
 
 	/* success */
-	array = g_ptr_array_ref (array_tmp);
-out:
-	sqlite3_free (statement);
 	return array;
 }
 
@@ -456,58 +805,38 @@ cd_mapping_db_get_devices (CdMappingDb *mdb,
 			   GError  **error)
 {
 	CdMappingDbPrivate *priv = GET_PRIVATE (mdb);
-	gchar *error_msg = NULL;
-	gchar *statement;
-	gint rc;
-	GPtrArray *array = NULL;
-	g_autoptr(GPtrArray) array_tmp = NULL;
+	CdMappingDbItem *item;
+	GPtrArray *array;
+	GPtrArray *indexed;
+	guint i;
+	g_autoptr(GPtrArray) items_tmp = NULL;
 
 	g_return_val_if_fail (CD_IS_MAPPING_DB (mdb), NULL);
 	g_return_val_if_fail (priv->db != NULL, NULL);
 
 	g_debug ("CdMappingDb: get devices for %s", profile_id);
-	statement = sqlite3_mprintf ("SELECT device FROM mappings_v2 WHERE "
-				     "profile = '%q' AND timestamp > 0 "
-				     "ORDER BY timestamp ASC;", profile_id);
 
-	/* remove the entry */
-	array_tmp = g_ptr_array_new_with_free_func (g_free);
-	rc = sqlite3_exec (priv->db,
-			   statement,
-			   cd_mapping_db_sqlite_cb,
-			   array_tmp,
-			   &error_msg);
-	if (rc != SQLITE_OK) {
-		g_set_error (error,
-			     CD_CLIENT_ERROR,
-			     CD_CLIENT_ERROR_INTERNAL,
-			     "SQL error: %s",
-			     error_msg);
-		sqlite3_free (error_msg);
-		goto out;
+	/* find the entries in the per-profile index */
+	array = g_ptr_array_new_with_free_func (g_free);
+	items_tmp = g_ptr_array_new ();
+	g_mutex_lock (&priv->mutex);
+	indexed = g_hash_table_lookup (priv->index_by_profile, profile_id);
+	for (i = 0; indexed != NULL && i < indexed->len; i++) {
+		item = g_ptr_array_index (indexed, i);
+		if (item->timestamp > 0)
+			g_ptr_array_add (items_tmp, item);
 	}
+	g_ptr_array_sort (items_tmp, cd_mapping_db_item_sort_cb);
+	for (i = 0; i < items_tmp->len; i++) {
+		item = g_ptr_array_index (items_tmp, i);
+		g_ptr_array_add (array, g_strdup (item->device));
+	}
+	g_mutex_unlock (&priv->mutex);
 
 	/* success */
-	array = g_ptr_array_ref (array_tmp);
-out:
-	sqlite3_free (statement);
 	return array;
 }
 
-static gint
-cd_mapping_db_sqlite_timestamp_cb (void *data,
-				   gint argc,
-				   gchar **argv,
-				   gchar **col_name)
-{
-	guint64 *timestamp = (guint64 *) data;
-
-	/* should only be one entry */
-	g_debug ("CdMappingDb: got sql entry %s", argv[0]);
-	*timestamp = g_ascii_strtoull (argv[0], NULL, 10);
-	return 0;
-}
-
 /**
  * cd_mapping_db_get_timestamp:
  *
@@ -522,9 +851,7 @@ cd_mapping_db_get_timestamp (CdMappingDb *mdb,
 			     GError  **error)
 {
 	CdMappingDbPrivate *priv = GET_PRIVATE (mdb);
-	gchar *error_msg = NULL;
-	gchar *statement;
-	gint rc;
+	CdMappingDbItem *item;
 	guint64 timestamp = G_MAXUINT64;
 
 	g_return_val_if_fail (CD_IS_MAPPING_DB (mdb), G_MAXUINT64);
@@ -532,25 +859,13 @@ cd_mapping_db_get_timestamp (CdMappingDb *mdb,
 
 	g_debug ("CdMappingDb: get checksum for %s<->%s",
 		 device_id, profile_id);
-	statement = sqlite3_mprintf ("SELECT timestamp FROM mappings_v2 WHERE "
-				     "device = '%q' AND profile = '%q' "
-				     "LIMIT 1;", device_id, profile_id);
 
-	/* query the checksum */
-	rc = sqlite3_exec (priv->db,
-			   statement,
-			   cd_mapping_db_sqlite_timestamp_cb,
-			   &timestamp,
-			   &error_msg);
-	if (rc != SQLITE_OK) {
-		g_set_error (error,
-			     CD_CLIENT_ERROR,
-			     CD_CLIENT_ERROR_INTERNAL,
-			     "SQL error: %s",
-			     error_msg);
-		sqlite3_free (error_msg);
-		goto out;
-	}
+	/* query the cache */
+	g_mutex_lock (&priv->mutex);
+	item = cd_mapping_db_cache_find (mdb, device_id, profile_id);
+	if (item != NULL)
+		timestamp = (guint64) item->timestamp;
+	g_mutex_unlock (&priv->mutex);
 
 	/* nothing found */
 	if (timestamp == G_MAXUINT64) {
@@ -559,10 +874,7 @@ cd_mapping_db_get_timestamp (CdMappingDb *mdb,
 			     CD_CLIENT_ERROR_INTERNAL,
 			     "device and profile %s<>%s not found",
 			     device_id, profile_id);
-		goto out;
 	}
-out:
-	sqlite3_free (statement);
 	return timestamp;
 }
 
@@ -576,6 +888,16 @@ cd_mapping_db_class_init (CdMappingDbClass *klass)
 static void
 cd_mapping_db_init (CdMappingDb *mdb)
 {
+	CdMappingDbPrivate *priv = GET_PRIVATE (mdb);
+	g_mutex_init (&priv->mutex);
+	priv->items = g_ptr_array_new_with_free_func ((GDestroyNotify) cd_mapping_db_item_free);
+	priv->index_by_device = g_hash_table_new_full (g_str_hash, g_str_equal,
+						       g_free,
+						       (GDestroyNotify) g_ptr_array_unref);
+	priv->index_by_profile = g_hash_table_new_full (g_str_hash, g_str_equal,
+							g_free,
+							(GDestroyNotify) g_ptr_array_unref);
+	priv->flush_queue = g_async_queue_new_full ((GDestroyNotify) cd_mapping_db_item_free);
 }
 
 static void
@@ -584,8 +906,25 @@ cd_mapping_db_finalize (GObject *object)
 	CdMappingDb *mdb = CD_MAPPING_DB (object);
 	CdMappingDbPrivate *priv = GET_PRIVATE (mdb);
 
-	/* close the database */
-	sqlite3_close (priv->db);
+	/* flush any pending mutations and stop the write-behind thread */
+	if (priv->flush_thread != NULL) {
+		cd_mapping_db_queue_item (mdb, CD_MAPPING_DB_OP_QUIT,
+					  NULL, NULL, 0);
+		g_thread_join (priv->flush_thread);
+	}
+
+	/* close the database; deferred until the other daemon databases
+	 * sharing this connection have finalized their statements */
+	sqlite3_finalize (priv->stmt_add);
+	sqlite3_finalize (priv->stmt_remove);
+	sqlite3_close (priv->db_flush);
+	sqlite3_close_v2 (priv->db);
+
+	g_async_queue_unref (priv->flush_queue);
+	g_hash_table_unref (priv->index_by_device);
+	g_hash_table_unref (priv->index_by_profile);
+	g_ptr_array_unref (priv->items);
+	g_mutex_clear (&priv->mutex);
 
 	G_OBJECT_CLASS (cd_mapping_db_parent_class)->finalize (object);
 }
@@ -23,6 +23,7 @@
 #define __CD_MAPPING_DB_H
 
 #include <glib-object.h>
+#include <sqlite3.h>
 
 G_BEGIN_DECLS
 
@@ -71,6 +72,7 @@ guint64		 cd_mapping_db_get_timestamp	(CdMappingDb	*mdb,
 						 const gchar	*profile_id,
 						 GError		**error)
 						 G_GNUC_WARN_UNUSED_RESULT;
+sqlite3		*cd_mapping_db_get_connection	(CdMappingDb	*mdb);
 
 G_END_DECLS
 
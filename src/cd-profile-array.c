@@ -33,6 +33,11 @@ static void     cd_profile_array_finalize	(GObject     *object);
 typedef struct
 {
 	GPtrArray			*array;
+	GHashTable			*hash_id;		/* of id:GPtrArray of CdProfile */
+	GHashTable			*hash_object_path;	/* of object path:CdProfile */
+	GHashTable			*cache_filename;	/* of filename:CdProfile */
+	GHashTable			*cache_metadata;	/* of key\tvalue:GPtrArray of CdProfile */
+	GVariant			*cache_variant;		/* object path array */
 } CdProfileArrayPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (CdProfileArray, cd_profile_array, G_TYPE_OBJECT)
@@ -43,17 +48,56 @@ void
 cd_profile_array_add (CdProfileArray *profile_array, CdProfile *profile)
 {
 	CdProfileArrayPrivate *priv = GET_PRIVATE (profile_array);
+	GPtrArray *bucket;
+
 	g_return_if_fail (CD_IS_PROFILE_ARRAY (profile_array));
 	g_return_if_fail (CD_IS_PROFILE (profile));
 	g_ptr_array_add (priv->array, g_object_ref (profile));
+
+	/* the indexes hold no references; the array does that for us and
+	 * the entries are removed before the array drops its reference */
+	bucket = g_hash_table_lookup (priv->hash_id,
+				      cd_profile_get_id (profile));
+	if (bucket == NULL) {
+		bucket = g_ptr_array_new ();
+		g_hash_table_insert (priv->hash_id,
+				     g_strdup (cd_profile_get_id (profile)),
+				     bucket);
+	}
+	g_ptr_array_add (bucket, profile);
+	g_hash_table_insert (priv->hash_object_path,
+			     g_strdup (cd_profile_get_object_path (profile)),
+			     profile);
+	g_clear_pointer (&priv->cache_filename, g_hash_table_unref);
+	g_clear_pointer (&priv->cache_metadata, g_hash_table_unref);
+	g_clear_pointer (&priv->cache_variant, g_variant_unref);
 }
 
 void
 cd_profile_array_remove (CdProfileArray *profile_array, CdProfile *profile)
 {
 	CdProfileArrayPrivate *priv = GET_PRIVATE (profile_array);
+	GPtrArray *bucket;
+
 	g_return_if_fail (CD_IS_PROFILE_ARRAY (profile_array));
 	g_return_if_fail (CD_IS_PROFILE (profile));
+
+	/* remove from the indexes first as the array may hold the last
+	 * reference to the profile */
+	bucket = g_hash_table_lookup (priv->hash_id,
+				      cd_profile_get_id (profile));
+	if (bucket != NULL) {
+		g_ptr_array_remove (bucket, profile);
+		if (bucket->len == 0) {
+			g_hash_table_remove (priv->hash_id,
+					     cd_profile_get_id (profile));
+		}
+	}
+	g_hash_table_remove (priv->hash_object_path,
+			     cd_profile_get_object_path (profile));
+	g_clear_pointer (&priv->cache_filename, g_hash_table_unref);
+	g_clear_pointer (&priv->cache_metadata, g_hash_table_unref);
+	g_clear_pointer (&priv->cache_variant, g_variant_unref);
 	g_ptr_array_remove (priv->array, profile);
 }
 
@@ -64,22 +108,20 @@ cd_profile_array_get_by_id_owner (CdProfileArray *profile_array,
 {
 	CdProfileArrayPrivate *priv = GET_PRIVATE (profile_array);
 	CdProfile *profile_tmp;
+	GPtrArray *bucket;
 	guint i;
 
-	/* find profile */
-	for (i = 0; i < priv->array->len; i++) {
-		profile_tmp = g_ptr_array_index (priv->array, i);
-		if (cd_profile_get_owner (profile_tmp) != owner)
-			continue;
-		if (g_strcmp0 (cd_profile_get_id (profile_tmp), id) == 0)
-			return g_object_ref (profile_tmp);
-	}
-	for (i = 0; i < priv->array->len; i++) {
-		profile_tmp = g_ptr_array_index (priv->array, i);
-		if (g_strcmp0 (cd_profile_get_id (profile_tmp), id) == 0)
+	/* find all the profiles with this ID */
+	bucket = g_hash_table_lookup (priv->hash_id, id);
+	if (bucket == NULL)
+		return NULL;
+	for (i = 0; i < bucket->len; i++) {
+		profile_tmp = g_ptr_array_index (bucket, i);
+		if (cd_profile_get_owner (profile_tmp) == owner)
 			return g_object_ref (profile_tmp);
 	}
-	return NULL;
+	profile_tmp = g_ptr_array_index (bucket, 0);
+	return g_object_ref (profile_tmp);
 }
 
 static CdProfile *
@@ -107,13 +149,40 @@ cd_profile_array_get_by_basename (CdProfileArray *profile_array,
 	return profile;
 }
 
+static GHashTable *
+cd_profile_array_get_filename_cache (CdProfileArray *profile_array)
+{
+	CdProfileArrayPrivate *priv = GET_PRIVATE (profile_array);
+	CdProfile *profile_tmp;
+	const gchar *tmp;
+	guint i;
+
+	/* still valid */
+	if (priv->cache_filename != NULL)
+		return priv->cache_filename;
+
+	/* rebuild from the array */
+	priv->cache_filename = g_hash_table_new_full (g_str_hash, g_str_equal,
+						      g_free, NULL);
+	for (i = 0; i < priv->array->len; i++) {
+		profile_tmp = g_ptr_array_index (priv->array, i);
+		tmp = cd_profile_get_filename (profile_tmp);
+		if (tmp == NULL)
+			continue;
+		g_hash_table_insert (priv->cache_filename,
+				     g_strdup (tmp),
+				     profile_tmp);
+	}
+	return priv->cache_filename;
+}
+
 CdProfile *
 cd_profile_array_get_by_filename (CdProfileArray *profile_array,
 				  const gchar *filename)
 {
 	CdProfileArrayPrivate *priv = GET_PRIVATE (profile_array);
 	CdProfile *profile_tmp;
-	guint i;
+	GHashTable *cache;
 
 	g_return_val_if_fail (filename != NULL, NULL);
 
@@ -122,12 +191,84 @@ cd_profile_array_get_by_filename (CdProfileArray *profile_array,
 		return cd_profile_array_get_by_basename (profile_array, filename);
 
 	/* find profile */
+	cache = cd_profile_array_get_filename_cache (profile_array);
+	profile_tmp = g_hash_table_lookup (cache, filename);
+	if (profile_tmp != NULL)
+		return g_object_ref (profile_tmp);
+
+	/* the filename is set after the profile has been added when using
+	 * CreateProfile, so rebuild the cache before giving up */
+	g_clear_pointer (&priv->cache_filename, g_hash_table_unref);
+	cache = cd_profile_array_get_filename_cache (profile_array);
+	profile_tmp = g_hash_table_lookup (cache, filename);
+	if (profile_tmp != NULL)
+		return g_object_ref (profile_tmp);
+	return NULL;
+}
+
+static GHashTable *
+cd_profile_array_get_metadata_cache (CdProfileArray *profile_array)
+{
+	CdProfileArrayPrivate *priv = GET_PRIVATE (profile_array);
+	CdProfile *profile_tmp;
+	GHashTable *hash_tmp;
+	GHashTableIter iter;
+	GPtrArray *bucket;
+	gpointer key;
+	gpointer value;
+	guint i;
+
+	/* still valid */
+	if (priv->cache_metadata != NULL)
+		return priv->cache_metadata;
+
+	/* invert key=value pairs to a list of profiles for each */
+	priv->cache_metadata = g_hash_table_new_full (g_str_hash, g_str_equal,
+						      g_free,
+						      (GDestroyNotify) g_ptr_array_unref);
 	for (i = 0; i < priv->array->len; i++) {
 		profile_tmp = g_ptr_array_index (priv->array, i);
-		if (g_strcmp0 (cd_profile_get_filename (profile_tmp), filename) == 0)
-			return g_object_ref (profile_tmp);
+		hash_tmp = cd_profile_get_metadata (profile_tmp);
+		g_hash_table_iter_init (&iter, hash_tmp);
+		while (g_hash_table_iter_next (&iter, &key, &value)) {
+			g_autofree gchar *idx = NULL;
+			idx = g_strdup_printf ("%s\t%s",
+					       (const gchar *) key,
+					       (const gchar *) value);
+			bucket = g_hash_table_lookup (priv->cache_metadata, idx);
+			if (bucket == NULL) {
+				bucket = g_ptr_array_new ();
+				g_hash_table_insert (priv->cache_metadata,
+						     g_strdup (idx),
+						     bucket);
+			}
+			g_ptr_array_add (bucket, profile_tmp);
+		}
 	}
-	return NULL;
+	return priv->cache_metadata;
+}
+
+static GPtrArray *
+cd_profile_array_get_metadata_bucket (CdProfileArray *profile_array,
+				      const gchar *key,
+				      const gchar *value)
+{
+	CdProfileArrayPrivate *priv = GET_PRIVATE (profile_array);
+	GHashTable *cache;
+	GPtrArray *bucket;
+	g_autofree gchar *idx = NULL;
+
+	cache = cd_profile_array_get_metadata_cache (profile_array);
+	idx = g_strdup_printf ("%s\t%s", key, value);
+	bucket = g_hash_table_lookup (cache, idx);
+	if (bucket != NULL)
+		return bucket;
+
+	/* metadata is set after the profile has been added when using
+	 * CreateProfile, so rebuild the index before giving up */
+	g_clear_pointer (&priv->cache_metadata, g_hash_table_unref);
+	cache = cd_profile_array_get_metadata_cache (profile_array);
+	return g_hash_table_lookup (cache, idx);
 }
 
 CdProfile *
@@ -135,21 +276,19 @@ cd_profile_array_get_by_property (CdProfileArray *profile_array,
 				  const gchar *key,
 				  const gchar *value)
 {
-	CdProfileArrayPrivate *priv = GET_PRIVATE (profile_array);
 	CdProfile *profile_tmp;
-	guint i;
+	GPtrArray *bucket;
 
 	/* special case */
 	if (g_strcmp0 (key, CD_PROFILE_PROPERTY_FILENAME) == 0)
 		return cd_profile_array_get_by_filename (profile_array, value);
 
 	/* find profile */
-	for (i = 0; i < priv->array->len; i++) {
-		profile_tmp = g_ptr_array_index (priv->array, i);
-		if (g_strcmp0 (cd_profile_get_metadata_item (profile_tmp, key), value) == 0)
-			return g_object_ref (profile_tmp);
-	}
-	return NULL;
+	bucket = cd_profile_array_get_metadata_bucket (profile_array, key, value);
+	if (bucket == NULL)
+		return NULL;
+	profile_tmp = g_ptr_array_index (bucket, 0);
+	return g_object_ref (profile_tmp);
 }
 
 GPtrArray *
@@ -176,21 +315,19 @@ cd_profile_array_get_by_metadata (CdProfileArray *profile_array,
 				  const gchar *key,
 				  const gchar *value)
 {
-	CdProfileArrayPrivate *priv = GET_PRIVATE (profile_array);
 	CdProfile *profile_tmp;
 	GPtrArray *array;
-	GHashTable *hash_tmp;
+	GPtrArray *bucket;
 	guint i;
-	const gchar *value_tmp;
 
 	/* find profile */
 	array = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
-	for (i = 0; i < priv->array->len; i++) {
-		profile_tmp = g_ptr_array_index (priv->array, i);
-		hash_tmp = cd_profile_get_metadata (profile_tmp);
-		value_tmp = g_hash_table_lookup (hash_tmp, key);
-		if (g_strcmp0 (value_tmp, value) == 0)
-			g_ptr_array_add (array, g_object_ref (profile_tmp));
+	bucket = cd_profile_array_get_metadata_bucket (profile_array, key, value);
+	if (bucket == NULL)
+		return array;
+	for (i = 0; i < bucket->len; i++) {
+		profile_tmp = g_ptr_array_index (bucket, i);
+		g_ptr_array_add (array, g_object_ref (profile_tmp));
 	}
 	return array;
 }
@@ -200,17 +337,13 @@ cd_profile_array_get_by_object_path (CdProfileArray *profile_array,
 				     const gchar *object_path)
 {
 	CdProfileArrayPrivate *priv = GET_PRIVATE (profile_array);
-	CdProfile *profile = NULL;
 	CdProfile *profile_tmp;
-	guint i;
 
 	/* find profile */
-	for (i = 0; i < priv->array->len; i++) {
-		profile_tmp = g_ptr_array_index (priv->array, i);
-		if (g_strcmp0 (cd_profile_get_object_path (profile_tmp), object_path) == 0)
-			return g_object_ref (profile_tmp);
-	}
-	return profile;
+	profile_tmp = g_hash_table_lookup (priv->hash_object_path, object_path);
+	if (profile_tmp == NULL)
+		return NULL;
+	return g_object_ref (profile_tmp);
 }
 
 GVariant *
@@ -221,6 +354,11 @@ cd_profile_array_get_variant (CdProfileArray *profile_array)
 	GVariant **variant_array = NULL;
 	guint i;
 
+	/* the array only changes when a profile is added or removed, so
+	 * steady-state enumerations cost a refcount bump */
+	if (priv->cache_variant != NULL)
+		return g_variant_ref (priv->cache_variant);
+
 	/* copy the object paths */
 	variant_array = g_new0 (GVariant *, priv->array->len + 1);
 	for (i = 0; i < priv->array->len; i++) {
@@ -229,9 +367,10 @@ cd_profile_array_get_variant (CdProfileArray *profile_array)
 	}
 
 	/* format the value */
-	return g_variant_new_array (G_VARIANT_TYPE_OBJECT_PATH,
-				    variant_array,
-				    priv->array->len);
+	priv->cache_variant = g_variant_ref_sink (g_variant_new_array (G_VARIANT_TYPE_OBJECT_PATH,
+								       variant_array,
+								       priv->array->len));
+	return g_variant_ref (priv->cache_variant);
 }
 
 static void
@@ -246,6 +385,11 @@ cd_profile_array_init (CdProfileArray *profile_array)
 {
 	CdProfileArrayPrivate *priv = GET_PRIVATE (profile_array);
 	priv->array = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
+	priv->hash_id = g_hash_table_new_full (g_str_hash, g_str_equal,
+					       g_free,
+					       (GDestroyNotify) g_ptr_array_unref);
+	priv->hash_object_path = g_hash_table_new_full (g_str_hash, g_str_equal,
+							g_free, NULL);
 }
 
 static void
@@ -254,6 +398,14 @@ cd_profile_array_finalize (GObject *object)
 	CdProfileArray *profile_array = CD_PROFILE_ARRAY (object);
 	CdProfileArrayPrivate *priv = GET_PRIVATE (profile_array);
 
+	g_hash_table_unref (priv->hash_id);
+	g_hash_table_unref (priv->hash_object_path);
+	if (priv->cache_filename != NULL)
+		g_hash_table_unref (priv->cache_filename);
+	if (priv->cache_metadata != NULL)
+		g_hash_table_unref (priv->cache_metadata);
+	if (priv->cache_variant != NULL)
+		g_variant_unref (priv->cache_variant);
 	g_ptr_array_unref (priv->array);
 
 	G_OBJECT_CLASS (cd_profile_array_parent_class)->finalize (object);
@@ -35,21 +35,96 @@ static void cd_profile_db_finalize	(GObject *object);
 typedef struct
 {
 	sqlite3			*db;
+	gboolean		 db_owned;
+	sqlite3_stmt		*stmt_set_property;
+	sqlite3_stmt		*stmt_remove;
+	sqlite3_stmt		*stmt_get_property;
 } CdProfileDbPrivate;
 
 static gpointer cd_profile_db_object = NULL;
 
 G_DEFINE_TYPE_WITH_PRIVATE (CdProfileDb, cd_profile_db, G_TYPE_OBJECT)
 
+static gboolean
+cd_profile_db_prepare (CdProfileDb *pdb,
+		       const gchar *sql,
+		       sqlite3_stmt **stmt,
+		       GError **error)
+{
+	CdProfileDbPrivate *priv = GET_PRIVATE (pdb);
+	gint rc;
+
+	rc = sqlite3_prepare_v2 (priv->db, sql, -1, stmt, NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error (error,
+			     CD_CLIENT_ERROR,
+			     CD_CLIENT_ERROR_INTERNAL,
+			     "Failed to prepare statement: SQL error: %s",
+			     sqlite3_errmsg (priv->db));
+		return FALSE;
+	}
+	return TRUE;
+}
+
+gboolean
+cd_profile_db_load_with_connection (CdProfileDb *pdb,
+				    sqlite3 *db,
+				    GError  **error)
+{
+	CdProfileDbPrivate *priv = GET_PRIVATE (pdb);
+	const gchar *statement;
+	gchar *error_msg = NULL;
+	gint rc;
+
+	g_return_val_if_fail (CD_IS_PROFILE_DB (pdb), FALSE);
+	g_return_val_if_fail (priv->db == NULL, FALSE);
+	g_return_val_if_fail (db != NULL, FALSE);
+
+	/* borrowed; whoever opened the connection closes it */
+	priv->db = db;
+
+	/* check schema */
+	rc = sqlite3_exec (priv->db, "SELECT * FROM properties_pu LIMIT 1",
+			   NULL, NULL, &error_msg);
+	if (rc != SQLITE_OK) {
+		statement = "CREATE TABLE properties_pu ("
+			    "profile_id TEXT,"
+			    "property TEXT,"
+			    "uid INTEGER,"
+			    "value TEXT,"
+			    "PRIMARY KEY (profile_id, property, uid));";
+		sqlite3_exec (priv->db, statement, NULL, NULL, NULL);
+	}
+
+	/* prepare the statements we run for every profile just once, so
+	 * repeated property lookups do not re-parse the SQL */
+	if (!cd_profile_db_prepare (pdb,
+				    "INSERT OR REPLACE INTO properties_pu (profile_id, "
+				    "property, uid, value) "
+				    "VALUES (?1, ?2, ?3, ?4);",
+				    &priv->stmt_set_property, error))
+		return FALSE;
+	if (!cd_profile_db_prepare (pdb,
+				    "DELETE FROM properties_pu WHERE "
+				    "profile_id = ?1 AND uid = ?2 AND property = ?3;",
+				    &priv->stmt_remove, error))
+		return FALSE;
+	if (!cd_profile_db_prepare (pdb,
+				    "SELECT value FROM properties_pu WHERE "
+				    "profile_id = ?1 AND uid = ?2 AND property = ?3 LIMIT 1;",
+				    &priv->stmt_get_property, error))
+		return FALSE;
+	return TRUE;
+}
+
 gboolean
 cd_profile_db_load (CdProfileDb *pdb,
 		    const gchar *filename,
 		    GError  **error)
 {
 	CdProfileDbPrivate *priv = GET_PRIVATE (pdb);
-	const gchar *statement;
-	gchar *error_msg = NULL;
 	gint rc;
+	sqlite3 *db = NULL;
 	g_autofree gchar *path = NULL;
 
 	g_return_val_if_fail (CD_IS_PROFILE_DB (pdb), FALSE);
@@ -62,34 +137,26 @@ cd_profile_db_load (CdProfileDb *pdb,
 
 	g_debug ("CdProfileDb: trying to open database '%s'", filename);
 	g_info ("Using profile database file %s", filename);
-	rc = sqlite3_open (filename, &priv->db);
+	rc = sqlite3_open (filename, &db);
 	if (rc != SQLITE_OK) {
 		g_set_error (error,
 			     CD_CLIENT_ERROR,
 			     CD_CLIENT_ERROR_INTERNAL,
 			     "Can't open database: %s\n",
-			     sqlite3_errmsg (priv->db));
-		sqlite3_close (priv->db);
+			     sqlite3_errmsg (db));
+		sqlite3_close (db);
 		return FALSE;
 	}
 
-	/* we don't need to keep doing fsync */
-	sqlite3_exec (priv->db, "PRAGMA synchronous=OFF",
+	/* use write-ahead logging so writers do not block readers, and
+	 * only fsync at checkpoint time rather than for every commit */
+	sqlite3_exec (db,
+		      "PRAGMA journal_mode=WAL;"
+		      "PRAGMA synchronous=NORMAL;",
 		      NULL, NULL, NULL);
 
-	/* check schema */
-	rc = sqlite3_exec (priv->db, "SELECT * FROM properties_pu LIMIT 1",
-			   NULL, NULL, &error_msg);
-	if (rc != SQLITE_OK) {
-		statement = "CREATE TABLE properties_pu ("
-			    "profile_id TEXT,"
-			    "property TEXT,"
-			    "uid INTEGER,"
-			    "value TEXT,"
-			    "PRIMARY KEY (profile_id, property, uid));";
-		sqlite3_exec (priv->db, statement, NULL, NULL, NULL);
-	}
-	return TRUE;
+	priv->db_owned = TRUE;
+	return cd_profile_db_load_with_connection (pdb, db, error);
 }
 
 gboolean
@@ -127,9 +194,6 @@ cd_profile_db_set_property (CdProfileDb *pdb,
 			    GError  **error)
 {
 	CdProfileDbPrivate *priv = GET_PRIVATE (pdb);
-	gboolean ret = TRUE;
-	gchar *error_msg = NULL;
-	gchar *statement;
 	gint rc;
 
 	g_return_val_if_fail (CD_IS_PROFILE_DB (pdb), FALSE);
@@ -137,26 +201,23 @@ cd_profile_db_set_property (CdProfileDb *pdb,
 
 	g_debug ("CdProfileDb: add profile property %s [%s=%s]",
 		 profile_id, property, value);
-	statement = sqlite3_mprintf ("INSERT OR REPLACE INTO properties_pu (profile_id, "
-				     "property, uid, value) "
-				     "VALUES ('%q', '%q', '%u', '%q');",
-				     profile_id, property, uid, value);
 
 	/* insert the entry */
-	rc = sqlite3_exec (priv->db, statement, NULL, NULL, &error_msg);
-	if (rc != SQLITE_OK) {
+	sqlite3_reset (priv->stmt_set_property);
+	sqlite3_bind_text (priv->stmt_set_property, 1, profile_id, -1, SQLITE_STATIC);
+	sqlite3_bind_text (priv->stmt_set_property, 2, property, -1, SQLITE_STATIC);
+	sqlite3_bind_int (priv->stmt_set_property, 3, uid);
+	sqlite3_bind_text (priv->stmt_set_property, 4, value, -1, SQLITE_STATIC);
+	rc = sqlite3_step (priv->stmt_set_property);
+	if (rc != SQLITE_DONE) {
 		g_set_error (error,
 			     CD_CLIENT_ERROR,
 			     CD_CLIENT_ERROR_INTERNAL,
 			     "SQL error: %s",
-			     error_msg);
-		sqlite3_free (error_msg);
-		ret = FALSE;
-		goto out;
+			     sqlite3_errmsg (priv->db));
+		return FALSE;
 	}
-out:
-	sqlite3_free (statement);
-	return ret;
+	return TRUE;
 }
 
 gboolean
@@ -167,9 +228,6 @@ cd_profile_db_remove (CdProfileDb *pdb,
 		      GError  **error)
 {
 	CdProfileDbPrivate *priv = GET_PRIVATE (pdb);
-	gboolean ret = TRUE;
-	gchar *error_msg = NULL;
-	gchar *statement = NULL;
 	gint rc;
 
 	g_return_val_if_fail (CD_IS_PROFILE_DB (pdb), FALSE);
@@ -177,39 +235,20 @@ cd_profile_db_remove (CdProfileDb *pdb,
 
 	/* remove the entry */
 	g_debug ("CdProfileDb: remove profile %s", profile_id);
-	statement = sqlite3_mprintf ("DELETE FROM properties_pu WHERE "
-				     "profile_id = '%q' AND "
-				     "uid = '%i' AND "
-				     "property = '%q' LIMIT 1;",
-				     profile_id, uid, property);
-	rc = sqlite3_exec (priv->db, statement, NULL, NULL, &error_msg);
-	if (rc != SQLITE_OK) {
+	sqlite3_reset (priv->stmt_remove);
+	sqlite3_bind_text (priv->stmt_remove, 1, profile_id, -1, SQLITE_STATIC);
+	sqlite3_bind_int (priv->stmt_remove, 2, uid);
+	sqlite3_bind_text (priv->stmt_remove, 3, property, -1, SQLITE_STATIC);
+	rc = sqlite3_step (priv->stmt_remove);
+	if (rc != SQLITE_DONE) {
 		g_set_error (error,
 			     CD_CLIENT_ERROR,
 			     CD_CLIENT_ERROR_INTERNAL,
 			     "SQL error: %s",
-			     error_msg);
-		sqlite3_free (error_msg);
-		ret = FALSE;
-		goto out;
+			     sqlite3_errmsg (priv->db));
+		return FALSE;
 	}
-out:
-	sqlite3_free (statement);
-	return ret;
-}
-
-static gint
-cd_profile_db_sqlite_cb (void *data,
-			gint argc,
-			gchar **argv,
-			gchar **col_name)
-{
-	gchar **value = (gchar **) data;
-
-	/* should only be one entry */
-	g_debug ("CdProfileDb: got sql result %s", argv[0]);
-	*value = g_strdup (argv[0]);
-	return 0;
+	return TRUE;
 }
 
 gboolean
@@ -221,40 +260,32 @@ cd_profile_db_get_property (CdProfileDb *pdb,
 			   GError  **error)
 {
 	CdProfileDbPrivate *priv = GET_PRIVATE (pdb);
-	gboolean ret = TRUE;
-	gchar *error_msg = NULL;
-	gchar *statement;
 	gint rc;
 
 	g_return_val_if_fail (CD_IS_PROFILE_DB (pdb), FALSE);
 	g_return_val_if_fail (priv->db != NULL, FALSE);
 
 	g_debug ("CdProfileDb: get property %s for %s", property, profile_id);
-	statement = sqlite3_mprintf ("SELECT value FROM properties_pu WHERE "
-				     "profile_id = '%q' AND "
-				     "uid = '%i' AND "
-				     "property = '%q' LIMIT 1;",
-				     profile_id, uid, property);
 
 	/* retrieve the entry */
-	rc = sqlite3_exec (priv->db,
-			   statement,
-			   cd_profile_db_sqlite_cb,
-			   value,
-			   &error_msg);
-	if (rc != SQLITE_OK) {
-		ret = FALSE;
+	sqlite3_reset (priv->stmt_get_property);
+	sqlite3_bind_text (priv->stmt_get_property, 1, profile_id, -1, SQLITE_STATIC);
+	sqlite3_bind_int (priv->stmt_get_property, 2, uid);
+	sqlite3_bind_text (priv->stmt_get_property, 3, property, -1, SQLITE_STATIC);
+	rc = sqlite3_step (priv->stmt_get_property);
+	if (rc == SQLITE_ROW) {
+		const gchar *tmp = (const gchar *) sqlite3_column_text (priv->stmt_get_property, 0);
+		g_debug ("CdProfileDb: got sql result %s", tmp);
+		*value = g_strdup (tmp);
+	} else if (rc != SQLITE_DONE) {
 		g_set_error (error,
 			     CD_CLIENT_ERROR,
 			     CD_CLIENT_ERROR_INTERNAL,
 			     "SQL error: %s",
-			     error_msg);
-		sqlite3_free (error_msg);
-		goto out;
+			     sqlite3_errmsg (priv->db));
+		return FALSE;
 	}
-out:
-	sqlite3_free (statement);
-	return ret;
+	return TRUE;
 }
 
 static void
@@ -276,7 +307,11 @@ cd_profile_db_finalize (GObject *object)
 	CdProfileDbPrivate *priv = GET_PRIVATE (pdb);
 
 	/* close the database */
-	sqlite3_close (priv->db);
+	sqlite3_finalize (priv->stmt_set_property);
+	sqlite3_finalize (priv->stmt_remove);
+	sqlite3_finalize (priv->stmt_get_property);
+	if (priv->db_owned)
+		sqlite3_close (priv->db);
 
 	G_OBJECT_CLASS (cd_profile_db_parent_class)->finalize (object);
 }
@@ -23,6 +23,7 @@
 #define __CD_PROFILE_DB_H
 
 #include <glib-object.h>
+#include <sqlite3.h>
 
 G_BEGIN_DECLS
 
@@ -41,6 +42,10 @@ gboolean	 cd_profile_db_load		(CdProfileDb	*pdb,
 						 const gchar	*filename,
 						 GError		**error)
 						 G_GNUC_WARN_UNUSED_RESULT;
+gboolean	 cd_profile_db_load_with_connection (CdProfileDb *pdb,
+						 sqlite3	*db,
+						 GError		**error)
+						 G_GNUC_WARN_UNUSED_RESULT;
 gboolean	 cd_profile_db_empty		(CdProfileDb	*pdb,
 						 GError		**error)
 						 G_GNUC_WARN_UNUSED_RESULT;
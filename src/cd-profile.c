@@ -19,19 +19,30 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* for memfd_create() and F_ADD_SEALS */
+#endif
+
 #include "config.h"
 
 #include <gio/gio.h>
+#include <gio/gunixfdlist.h>
 #include <glib-object.h>
+#include <glib/gstdio.h>
 #include <lcms2.h>
 #include <string.h>
 #include <stdlib.h>
 #ifdef HAVE_PWD_H
 #include <pwd.h>
 #endif
+#include <errno.h>
+#include <fcntl.h>
 #include <math.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 #include "cd-common.h"
+#include "cd-debug.h"
 #include "cd-profile.h"
 #include "cd-profile-db.h"
 
@@ -65,10 +76,35 @@ typedef struct
 	guint				 owner;
 	gchar				**warnings;
 	GMappedFile			*mapped_file;
+	gchar				*icc_cache_key;
+	gint				 data_fd;
 	guint				 score;
 	CdProfileDb			*db;
 } CdProfilePrivate;
 
+typedef struct {
+	CdIcc				*icc;
+	GMappedFile			*mapped_file;
+	guint				 refcount;
+} CdProfileIccCacheItem;
+
+/* of checksum:CdProfileIccCacheItem, so identical bytes registered by
+ * every seat share one parsed representation and one mapping */
+static GHashTable *cd_profile_icc_cache = NULL;
+G_LOCK_DEFINE_STATIC (cd_profile_icc_cache);
+
+/* checksums remembered from the previous daemon run, keyed by filename;
+ * an entry is only trusted while the mtime and size still match the
+ * file on disk */
+typedef struct {
+	guint64		 mtime;
+	guint64		 size;
+	gchar		*checksum;
+} CdProfileChecksumHint;
+
+static GHashTable *cd_profile_checksum_hints = NULL;
+G_LOCK_DEFINE_STATIC (cd_profile_checksum_hints);
+
 enum {
 	SIGNAL_INVALIDATE,
 	SIGNAL_LAST
@@ -177,6 +213,7 @@ cd_profile_set_object_path (CdProfile *profile)
 #ifdef HAVE_PWD_H
 	struct passwd *pw;
 #endif
+	g_autofree gchar *path_full = NULL;
 	g_autofree gchar *path_tmp = NULL;
 	g_autofree gchar *path_owner = NULL;
 
@@ -204,10 +241,11 @@ cd_profile_set_object_path (CdProfile *profile)
 	/* make sure object path is sane */
 	path_owner = cd_main_ensure_dbus_path (path_tmp);
 
-	priv->object_path = g_build_filename (COLORD_DBUS_PATH,
-						       "profiles",
-						       path_owner,
-						       NULL);
+	path_full = g_build_filename (COLORD_DBUS_PATH,
+				      "profiles",
+				      path_owner,
+				      NULL);
+	priv->object_path = cd_main_intern_string (path_full);
 }
 
 static void
@@ -220,7 +258,7 @@ cd_profile_set_metadata (CdProfile *profile,
 	if (g_strcmp0 (property, "CreatorApp") == 0)
 		property = CD_PROFILE_METADATA_CMF_PRODUCT;
 	g_hash_table_insert (priv->metadata,
-			     g_strdup (property),
+			     cd_main_intern_string (property),
 			     g_strdup (value));
 }
 
@@ -233,8 +271,8 @@ cd_profile_set_id (CdProfile *profile, const gchar *id)
 
 	g_return_if_fail (CD_IS_PROFILE (profile));
 
-	g_free (priv->id);
-	priv->id = g_strdup (id);
+	cd_main_intern_release (priv->id);
+	priv->id = cd_main_intern_string (id);
 
 	/* all profiles have a score initially */
 	priv->score = 1;
@@ -287,6 +325,8 @@ cd_profile_set_id (CdProfile *profile, const gchar *id)
 	}
 
 	/* now calculate this again */
+	cd_main_intern_release (priv->object_path);
+	priv->object_path = NULL;
 	cd_profile_set_object_path (profile);
 }
 
@@ -571,6 +611,71 @@ cd_profile_set_property_internal (CdProfile *profile,
 	return TRUE;
 }
 
+static gboolean
+cd_profile_ensure_data_fd (CdProfile *profile, GError **error)
+{
+	CdProfilePrivate *priv = GET_PRIVATE (profile);
+	const gchar *data;
+	gsize len;
+	gint fd;
+
+	/* already created; all callers share the same sealed pages */
+	if (priv->data_fd >= 0)
+		return TRUE;
+
+	/* the mapped file is only set when loaded from a file or fd, so
+	 * map the filename for profiles restored from the database */
+	if (priv->mapped_file == NULL && priv->filename != NULL) {
+		priv->mapped_file = g_mapped_file_new (priv->filename,
+						       FALSE,
+						       error);
+		if (priv->mapped_file == NULL)
+			return FALSE;
+	}
+	if (priv->mapped_file == NULL) {
+		g_set_error (error,
+			     CD_PROFILE_ERROR,
+			     CD_PROFILE_ERROR_FAILED_TO_READ,
+			     "no data available for profile %s",
+			     priv->id);
+		return FALSE;
+	}
+
+	/* copy the validated bytes into a sealed memfd once */
+	data = g_mapped_file_get_contents (priv->mapped_file);
+	len = g_mapped_file_get_length (priv->mapped_file);
+	fd = memfd_create ("colord-profile", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+	if (fd < 0) {
+		g_set_error (error,
+			     CD_PROFILE_ERROR,
+			     CD_PROFILE_ERROR_INTERNAL,
+			     "failed to create memfd: %s",
+			     g_strerror (errno));
+		return FALSE;
+	}
+	if (write (fd, data, len) != (gssize) len) {
+		g_set_error (error,
+			     CD_PROFILE_ERROR,
+			     CD_PROFILE_ERROR_INTERNAL,
+			     "failed to write memfd: %s",
+			     g_strerror (errno));
+		close (fd);
+		return FALSE;
+	}
+	if (fcntl (fd, F_ADD_SEALS,
+		   F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) < 0) {
+		g_set_error (error,
+			     CD_PROFILE_ERROR,
+			     CD_PROFILE_ERROR_INTERNAL,
+			     "failed to seal memfd: %s",
+			     g_strerror (errno));
+		close (fd);
+		return FALSE;
+	}
+	priv->data_fd = fd;
+	return TRUE;
+}
+
 static void
 cd_profile_dbus_method_call (GDBusConnection *connection, const gchar *sender,
 			    const gchar *object_path, const gchar *interface_name,
@@ -668,6 +773,37 @@ cd_profile_dbus_method_call (GDBusConnection *connection, const gchar *sender,
 		return;
 	}
 
+	/* return 'ht' */
+	if (g_strcmp0 (method_name, "GetDataFd") == 0) {
+		gint fd_index;
+		g_autoptr(GUnixFDList) fd_list = NULL;
+
+		g_debug ("CdProfile %s:GetDataFd() on %s",
+			 sender, priv->object_path);
+
+		/* create the sealed fd once, then dup it per caller */
+		if (!cd_profile_ensure_data_fd (profile, &error)) {
+			g_dbus_method_invocation_return_gerror (invocation, error);
+			return;
+		}
+		fd_list = g_unix_fd_list_new ();
+		fd_index = g_unix_fd_list_append (fd_list, priv->data_fd, &error);
+		if (fd_index < 0) {
+			g_dbus_method_invocation_return_error (invocation,
+							       CD_PROFILE_ERROR,
+							       CD_PROFILE_ERROR_INTERNAL,
+							       "failed to append fd: %s",
+							       error->message);
+			return;
+		}
+		g_dbus_method_invocation_return_value_with_unix_fd_list (
+			invocation,
+			g_variant_new ("(ht)",
+				       fd_index,
+				       (guint64) g_mapped_file_get_length (priv->mapped_file)),
+			fd_list);
+		return;
+	}
 
 	/* we suck */
 	g_critical ("failed to process method %s", method_name);
@@ -740,6 +876,48 @@ cd_profile_dbus_get_property (GDBusConnection *connection, const gchar *sender,
 	return NULL;
 }
 
+GVariant *
+cd_profile_get_properties_as_variant (CdProfile *profile)
+{
+	CdProfilePrivate *priv = GET_PRIVATE (profile);
+	GVariant *value;
+	GVariantBuilder builder;
+	guint i;
+	const gchar *props[] = {
+		CD_PROFILE_PROPERTY_ID,
+		CD_PROFILE_PROPERTY_QUALIFIER,
+		CD_PROFILE_PROPERTY_FORMAT,
+		CD_PROFILE_PROPERTY_FILENAME,
+		CD_PROFILE_PROPERTY_KIND,
+		CD_PROFILE_PROPERTY_COLORSPACE,
+		CD_PROFILE_PROPERTY_HAS_VCGT,
+		CD_PROFILE_PROPERTY_IS_SYSTEM_WIDE,
+		CD_PROFILE_PROPERTY_METADATA,
+		CD_PROFILE_PROPERTY_CREATED,
+		CD_PROFILE_PROPERTY_SCOPE,
+		CD_PROFILE_PROPERTY_OWNER,
+		CD_PROFILE_PROPERTY_WARNINGS,
+		NULL };
+
+	g_return_val_if_fail (CD_IS_PROFILE (profile), NULL);
+
+	/* build the same dictionary o.fd.DBus.Properties.GetAll would;
+	 * Title is the shared value as there is no sender to look up a
+	 * per-user database override for */
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+	g_variant_builder_add (&builder, "{sv}",
+			       CD_PROFILE_PROPERTY_TITLE,
+			       cd_profile_get_nullable_for_string (priv->title));
+	for (i = 0; props[i] != NULL; i++) {
+		value = cd_profile_dbus_get_property (NULL, NULL, NULL, NULL,
+						      props[i], NULL, profile);
+		if (value == NULL)
+			continue;
+		g_variant_builder_add (&builder, "{sv}", props[i], value);
+	}
+	return g_variant_ref_sink (g_variant_builder_end (&builder));
+}
+
 gboolean
 cd_profile_register_object (CdProfile *profile,
 			    GDBusConnection *connection,
@@ -817,15 +995,14 @@ cd_profile_set_from_profile (CdProfile *profile, CdIcc *icc, GError **error)
 	CdProfilePrivate *priv = GET_PRIVATE (profile);
 	CdProfileWarning warning;
 	GList *l;
-	cmsHPROFILE lcms_profile;
 	const gchar *key;
 	const gchar *value;
-	gboolean ret = FALSE;
 	guint i;
-	struct tm created;
 	g_autoptr(GArray) flags = NULL;
+	g_autoptr(GDateTime) created = NULL;
 	g_autoptr(GHashTable) metadata = NULL;
 	g_autoptr(GList) keys = NULL;
+	g_autoptr(GPtrArray) vcgt = NULL;
 
 	/* get the description as the title */
 	value = cd_icc_get_description (icc, NULL, error);
@@ -845,7 +1022,7 @@ cd_profile_set_from_profile (CdProfile *profile, CdIcc *icc, GError **error)
 		value = g_hash_table_lookup (metadata, key);
 		g_debug ("Adding metadata %s=%s", key, value);
 		g_hash_table_insert (priv->metadata,
-				     g_strdup (key),
+				     cd_main_intern_string (key),
 				     g_strdup (value));
 	}
 
@@ -868,19 +1045,19 @@ cd_profile_set_from_profile (CdProfile *profile, CdIcc *icc, GError **error)
 		cd_profile_set_qualifier (profile, "RGB..");
 	}
 
-	/* get the profile created time and date */
-	lcms_profile = cd_icc_get_handle (icc);
-	ret = cmsGetHeaderCreationDateTime (lcms_profile, &created);
-	if (ret) {
-		created.tm_isdst = -1;
-		priv->created = mktime (&created);
+	/* get the profile created time and date; this comes from the sidecar
+	 * cache when the profile was hydrated without lcms2 */
+	created = cd_icc_get_created (icc);
+	if (created != NULL) {
+		priv->created = g_date_time_to_unix (created);
 	} else {
 		g_warning ("failed to get created time");
 		priv->created = 0;
 	}
 
 	/* do we have vcgt */
-	priv->has_vcgt = cmsIsTag (lcms_profile, cmsSigVcgtTag);
+	vcgt = cd_icc_get_vcgt (icc, 256, NULL);
+	priv->has_vcgt = vcgt != NULL;
 
 	/* get the checksum for the profile if we can */
 	priv->checksum = g_strdup (cd_icc_get_checksum (icc));
@@ -955,13 +1132,161 @@ cd_profile_load_from_icc (CdProfile *profile, CdIcc *icc, GError **error)
 	return TRUE;
 }
 
-gboolean
-cd_profile_load_from_fd (CdProfile *profile,
-			 gint fd,
-			 GError **error)
+static void
+cd_profile_checksum_hint_free (CdProfileChecksumHint *hint)
+{
+	g_free (hint->checksum);
+	g_free (hint);
+}
+
+void
+cd_profile_add_checksum_hint (const gchar *filename,
+			      guint64 mtime,
+			      guint64 size,
+			      const gchar *checksum)
+{
+	CdProfileChecksumHint *hint;
+
+	g_return_if_fail (filename != NULL);
+	g_return_if_fail (checksum != NULL);
+
+	hint = g_new0 (CdProfileChecksumHint, 1);
+	hint->mtime = mtime;
+	hint->size = size;
+	hint->checksum = g_strdup (checksum);
+	G_LOCK (cd_profile_checksum_hints);
+	if (cd_profile_checksum_hints == NULL) {
+		cd_profile_checksum_hints = g_hash_table_new_full (g_str_hash,
+								   g_str_equal,
+								   g_free,
+								   (GDestroyNotify) cd_profile_checksum_hint_free);
+	}
+	g_hash_table_insert (cd_profile_checksum_hints,
+			     g_strdup (filename),
+			     hint);
+	G_UNLOCK (cd_profile_checksum_hints);
+}
+
+static gchar *
+cd_profile_checksum_hint_lookup (const gchar *filename,
+				 GMappedFile *mapped_file)
+{
+	CdProfileChecksumHint *hint;
+	GStatBuf st;
+	gchar *checksum = NULL;
+
+	G_LOCK (cd_profile_checksum_hints);
+	if (cd_profile_checksum_hints != NULL) {
+		hint = g_hash_table_lookup (cd_profile_checksum_hints,
+					    filename);
+		if (hint != NULL &&
+		    g_stat (filename, &st) == 0 &&
+		    (guint64) st.st_mtime == hint->mtime &&
+		    (guint64) st.st_size == hint->size &&
+		    (guint64) g_mapped_file_get_length (mapped_file) == hint->size)
+			checksum = g_strdup (hint->checksum);
+	}
+	G_UNLOCK (cd_profile_checksum_hints);
+	return checksum;
+}
+
+/* the lock must be held; loads now run on worker threads */
+static CdProfileIccCacheItem *
+cd_profile_icc_cache_get (const gchar *checksum)
+{
+	if (cd_profile_icc_cache == NULL)
+		return NULL;
+	return g_hash_table_lookup (cd_profile_icc_cache, checksum);
+}
+
+static void
+cd_profile_icc_cache_add (const gchar *checksum,
+			  CdIcc *icc,
+			  GMappedFile *mapped_file)
 {
+	CdProfileIccCacheItem *item;
+
+	G_LOCK (cd_profile_icc_cache);
+	if (cd_profile_icc_cache == NULL) {
+		cd_profile_icc_cache = g_hash_table_new_full (g_str_hash,
+							      g_str_equal,
+							      g_free,
+							      g_free);
+	}
+
+	/* another worker may have parsed and inserted the same bytes since
+	 * our lookup missed; take a reference on its entry and discard our
+	 * copy, as replacing the item would orphan the references other
+	 * profiles resolve through this checksum */
+	item = cd_profile_icc_cache_get (checksum);
+	if (item != NULL) {
+		item->refcount++;
+		G_UNLOCK (cd_profile_icc_cache);
+		return;
+	}
+	item = g_new0 (CdProfileIccCacheItem, 1);
+	item->icc = g_object_ref (icc);
+	item->mapped_file = g_mapped_file_ref (mapped_file);
+	item->refcount = 1;
+	g_hash_table_insert (cd_profile_icc_cache,
+			     g_strdup (checksum),
+			     item);
+	G_UNLOCK (cd_profile_icc_cache);
+}
+
+static void
+cd_profile_icc_cache_release (const gchar *checksum)
+{
+	CdProfileIccCacheItem *item;
+
+	G_LOCK (cd_profile_icc_cache);
+	item = cd_profile_icc_cache_get (checksum);
+	if (item != NULL && --item->refcount == 0) {
+		g_object_unref (item->icc);
+		g_mapped_file_unref (item->mapped_file);
+		g_hash_table_remove (cd_profile_icc_cache, checksum);
+	}
+	G_UNLOCK (cd_profile_icc_cache);
+}
+
+/* share the CdIcc and the mapping of an already-registered profile with
+ * the same bytes; @found is set when the bytes have been seen before */
+static gboolean
+cd_profile_load_from_icc_cache (CdProfile *profile,
+				const gchar *checksum,
+				gboolean *found,
+				GError **error)
+{
+	CdProfileIccCacheItem *item;
 	CdProfilePrivate *priv = GET_PRIVATE (profile);
+
+	G_LOCK (cd_profile_icc_cache);
+	item = cd_profile_icc_cache_get (checksum);
+	*found = item != NULL;
+	if (item == NULL) {
+		G_UNLOCK (cd_profile_icc_cache);
+		return TRUE;
+	}
+	item->refcount++;
+	priv->icc_cache_key = g_strdup (checksum);
+	g_mapped_file_unref (priv->mapped_file);
+	priv->mapped_file = g_mapped_file_ref (item->mapped_file);
+	G_UNLOCK (cd_profile_icc_cache);
+	if (!cd_profile_set_from_profile (profile, item->icc, error))
+		return FALSE;
+	cd_profile_emit_parsed_property_changed (profile);
+	return TRUE;
+}
+
+static gboolean
+cd_profile_load_from_fd_internal (CdProfile *profile,
+				  gint fd,
+				  GError **error)
+{
+	CdProfilePrivate *priv = GET_PRIVATE (profile);
+	gboolean found = FALSE;
 	gboolean ret;
+	g_autofree gchar *icc_checksum = NULL;
 	g_autoptr(GError) error_local = NULL;
 	g_autoptr(CdIcc) icc = NULL;
 
@@ -977,6 +1302,26 @@ cd_profile_load_from_fd (CdProfile *profile,
 		return FALSE;
 	}
 
+	/* create a mapped file */
+	priv->mapped_file = g_mapped_file_new_from_fd (fd, FALSE, error);
+	if (priv->mapped_file == NULL) {
+		g_set_error (error,
+			     CD_PROFILE_ERROR,
+			     CD_PROFILE_ERROR_FAILED_TO_READ,
+			     "failed to create mapped file from fd %i",
+			     fd);
+		return FALSE;
+	}
+
+	/* identical bytes may already be registered by another seat */
+	icc_checksum = g_compute_checksum_for_data (G_CHECKSUM_MD5,
+						    (const guchar *) g_mapped_file_get_contents (priv->mapped_file),
+						    g_mapped_file_get_length (priv->mapped_file));
+	if (!cd_profile_load_from_icc_cache (profile, icc_checksum, &found, error))
+		return FALSE;
+	if (found)
+		return TRUE;
+
 	/* open fd and parse the file */
 	icc = cd_icc_new ();
 	ret = cd_icc_load_fd (icc, fd,
@@ -990,33 +1335,78 @@ cd_profile_load_from_fd (CdProfile *profile,
 		return FALSE;
 	}
 
-	/* create a mapped file */
-	priv->mapped_file = g_mapped_file_new_from_fd (fd, FALSE, error);
-	if (priv->mapped_file == NULL) {
-		g_set_error (error,
-			     CD_PROFILE_ERROR,
-			     CD_PROFILE_ERROR_FAILED_TO_READ,
-			     "failed to create mapped file from fd %i",
-			     fd);
-		return FALSE;
-	}
-
 	/* set the virtual profile from the lcms profile */
 	if (!cd_profile_set_from_profile (profile, icc, error))
 		return FALSE;
 
+	/* save for the next seat that registers these bytes */
+	cd_profile_icc_cache_add (icc_checksum, icc, priv->mapped_file);
+	priv->icc_cache_key = g_strdup (icc_checksum);
+
 	/* emit all the things that could have changed */
 	cd_profile_emit_parsed_property_changed (profile);
 	return TRUE;
 }
 
+gboolean
+cd_profile_load_from_fd (CdProfile *profile,
+			 gint fd,
+			 GError **error)
+{
+	gboolean ret;
+	gint64 begin;
+
+	/* the map, hash and parse is the expensive part of CreateProfile */
+	begin = cd_debug_trace_begin ();
+	ret = cd_profile_load_from_fd_internal (profile, fd, error);
+	cd_debug_trace_end (begin, "profile load fd %i", fd);
+	return ret;
+}
+
+static GFile *
+cd_profile_get_cache_file (const gchar *filename)
+{
+	g_autofree gchar *basename = NULL;
+	g_autofree gchar *path = NULL;
+
+	/* one blob per profile, named after the hash of the source path */
+	basename = g_strdup_printf ("%016" G_GINT64_MODIFIER "x.bin",
+				    cd_buffer_hash ((const guint8 *) filename,
+						    strlen (filename), 0));
+	path = g_build_filename (LOCALSTATEDIR, "lib", "colord", "cache",
+				 basename, NULL);
+	return g_file_new_for_path (path);
+}
+
+static void
+cd_profile_save_cache (CdIcc *icc, GFile *cache_file)
+{
+	g_autofree gchar *cache_path = NULL;
+	g_autofree gchar *cache_dir = NULL;
+	g_autoptr(GError) error_local = NULL;
+
+	/* failing to write the cache is never fatal */
+	cache_path = g_file_get_path (cache_file);
+	cache_dir = g_path_get_dirname (cache_path);
+	if (g_mkdir_with_parents (cache_dir, 0755) != 0) {
+		g_debug ("failed to create %s", cache_dir);
+		return;
+	}
+	if (!cd_icc_save_cache (icc, cache_file, &error_local))
+		g_debug ("failed to save %s: %s", cache_path, error_local->message);
+}
+
 gboolean
 cd_profile_load_from_filename (CdProfile *profile, const gchar *filename, GError **error)
 {
 	CdProfilePrivate *priv = GET_PRIVATE (profile);
+	gboolean found = FALSE;
 	gboolean ret = FALSE;
+	g_autofree gchar *icc_checksum = NULL;
 	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GError) error_cache = NULL;
 	g_autoptr(CdIcc) icc = NULL;
+	g_autoptr(GFile) cache_file = NULL;
 	g_autoptr(GFile) file = NULL;
 
 	g_return_val_if_fail (CD_IS_PROFILE (profile), FALSE);
@@ -1031,21 +1421,6 @@ cd_profile_load_from_filename (CdProfile *profile, const gchar *filename, GError
 		return FALSE;
 	}
 
-	/* open fd and parse the file */
-	icc = cd_icc_new ();
-	file = g_file_new_for_path (filename);
-	ret = cd_icc_load_file (icc, file,
-				CD_ICC_LOAD_FLAGS_METADATA,
-				NULL,
-				&error_local);
-	if (!ret) {
-		g_set_error_literal (error,
-				     CD_PROFILE_ERROR,
-				     CD_PROFILE_ERROR_FAILED_TO_READ,
-				     error_local->message);
-		return FALSE;
-	}
-
 	/* create a mapped file */
 	priv->mapped_file = g_mapped_file_new (filename, FALSE, error);
 	if (priv->mapped_file == NULL) {
@@ -1057,15 +1432,124 @@ cd_profile_load_from_filename (CdProfile *profile, const gchar *filename, GError
 		return FALSE;
 	}
 
+	/* reuse the checksum from the last run when the file has not
+	 * been touched, which skips hashing the mapped bytes */
+	icc_checksum = cd_profile_checksum_hint_lookup (filename,
+							priv->mapped_file);
+
+	/* identical bytes may already be registered, e.g. the same profile
+	 * installed in more than one search location */
+	if (icc_checksum == NULL) {
+		icc_checksum = g_compute_checksum_for_data (G_CHECKSUM_MD5,
+							    (const guchar *) g_mapped_file_get_contents (priv->mapped_file),
+							    g_mapped_file_get_length (priv->mapped_file));
+	}
+	if (!cd_profile_load_from_icc_cache (profile, icc_checksum, &found, error))
+		return FALSE;
+	if (found)
+		return TRUE;
+
+	/* hydrate from the binary sidecar cache when the profile on disk
+	 * has not changed, which skips parsing with lcms2 entirely */
+	icc = cd_icc_new ();
+	file = g_file_new_for_path (filename);
+	cache_file = cd_profile_get_cache_file (filename);
+	ret = cd_icc_load_cache (icc, cache_file, &error_cache);
+	if (!ret) {
+		g_debug ("not using sidecar cache for %s: %s",
+			 filename, error_cache->message);
+
+		/* open fd and parse the file */
+		ret = cd_icc_load_file (icc, file,
+					CD_ICC_LOAD_FLAGS_METADATA,
+					NULL,
+					&error_local);
+		if (!ret) {
+			g_set_error_literal (error,
+					     CD_PROFILE_ERROR,
+					     CD_PROFILE_ERROR_FAILED_TO_READ,
+					     error_local->message);
+			return FALSE;
+		}
+
+		/* write the cache so the next daemon start is cheap */
+		cd_profile_save_cache (icc, cache_file);
+	}
+
 	/* set the virtual profile from the lcms profile */
 	if (!cd_profile_set_from_profile (profile, icc, error))
 		return FALSE;
 
+	/* save for the next registration of these bytes */
+	cd_profile_icc_cache_add (icc_checksum, icc, priv->mapped_file);
+	priv->icc_cache_key = g_strdup (icc_checksum);
+
 	/* emit all the things that could have changed */
 	cd_profile_emit_parsed_property_changed (profile);
 	return TRUE;
 }
 
+/* map, hash and parse @filename into the shared icc cache before any
+ * client has registered it, so a later CreateProfile with the same
+ * bytes is served from memory; the cache entry stays pinned for the
+ * daemon lifetime which is the point of prefetching */
+gboolean
+cd_profile_prewarm_filename (const gchar *filename, GError **error)
+{
+	CdProfileIccCacheItem *item;
+	GStatBuf st;
+	g_autofree gchar *icc_checksum = NULL;
+	g_autoptr(CdIcc) icc = NULL;
+	g_autoptr(GError) error_cache = NULL;
+	g_autoptr(GFile) cache_file = NULL;
+	g_autoptr(GFile) file = NULL;
+	g_autoptr(GMappedFile) mapped_file = NULL;
+
+	g_return_val_if_fail (filename != NULL, FALSE);
+
+	/* create a mapped file */
+	mapped_file = g_mapped_file_new (filename, FALSE, error);
+	if (mapped_file == NULL)
+		return FALSE;
+
+	/* reuse the persisted checksum when the file has not changed */
+	icc_checksum = cd_profile_checksum_hint_lookup (filename, mapped_file);
+	if (icc_checksum == NULL) {
+		icc_checksum = g_compute_checksum_for_data (G_CHECKSUM_MD5,
+							    (const guchar *) g_mapped_file_get_contents (mapped_file),
+							    g_mapped_file_get_length (mapped_file));
+		if (g_stat (filename, &st) == 0) {
+			cd_profile_add_checksum_hint (filename,
+						      (guint64) st.st_mtime,
+						      (guint64) st.st_size,
+						      icc_checksum);
+		}
+	}
+
+	/* these bytes are already warm */
+	G_LOCK (cd_profile_icc_cache);
+	item = cd_profile_icc_cache_get (icc_checksum);
+	G_UNLOCK (cd_profile_icc_cache);
+	if (item != NULL)
+		return TRUE;
+
+	/* hydrate from the binary sidecar cache, or parse with lcms2 */
+	icc = cd_icc_new ();
+	cache_file = cd_profile_get_cache_file (filename);
+	if (!cd_icc_load_cache (icc, cache_file, &error_cache)) {
+		g_debug ("not using sidecar cache for %s: %s",
+			 filename, error_cache->message);
+		file = g_file_new_for_path (filename);
+		if (!cd_icc_load_file (icc, file,
+				       CD_ICC_LOAD_FLAGS_METADATA,
+				       NULL, error))
+			return FALSE;
+		cd_profile_save_cache (icc, cache_file);
+	}
+	cd_profile_icc_cache_add (icc_checksum, icc, mapped_file);
+	return TRUE;
+}
+
 const gchar *
 cd_profile_get_qualifier (CdProfile *profile)
 {
@@ -1225,12 +1709,12 @@ cd_profile_set_property (GObject *object, guint prop_id, const GValue *value, GP
 
 	switch (prop_id) {
 	case PROP_OBJECT_PATH:
-		g_free (priv->object_path);
-		priv->object_path = g_strdup (g_value_get_string (value));
+		cd_main_intern_release (priv->object_path);
+		priv->object_path = cd_main_intern_string (g_value_get_string (value));
 		break;
 	case PROP_ID:
-		g_free (priv->id);
-		priv->id = g_strdup (g_value_get_string (value));
+		cd_main_intern_release (priv->id);
+		priv->id = cd_main_intern_string (g_value_get_string (value));
 		break;
 	default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -1279,9 +1763,10 @@ cd_profile_init (CdProfile *profile)
 {
 	CdProfilePrivate *priv = GET_PRIVATE (profile);
 	priv->db = cd_profile_db_new ();
+	priv->data_fd = -1;
 	priv->metadata = g_hash_table_new_full (g_str_hash,
 							 g_str_equal,
-							 g_free,
+							 (GDestroyNotify) cd_main_intern_release,
 							 g_free);
 }
 
@@ -1299,13 +1784,19 @@ cd_profile_finalize (GObject *object)
 	}
 	if (priv->mapped_file != NULL)
 		g_mapped_file_unref (priv->mapped_file);
+	if (priv->icc_cache_key != NULL) {
+		cd_profile_icc_cache_release (priv->icc_cache_key);
+		g_free (priv->icc_cache_key);
+	}
+	if (priv->data_fd >= 0)
+		close (priv->data_fd);
 	g_free (priv->filename);
 	g_free (priv->qualifier);
 	g_free (priv->format);
 	g_free (priv->title);
-	g_free (priv->id);
+	cd_main_intern_release (priv->id);
 	g_free (priv->checksum);
-	g_free (priv->object_path);
+	cd_main_intern_release (priv->object_path);
 	g_object_unref (priv->db);
 	g_strfreev (priv->warnings);
 	g_hash_table_unref (priv->metadata);
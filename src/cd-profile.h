@@ -68,6 +68,14 @@ gboolean	 cd_profile_load_from_filename		(CdProfile	*profile,
 							 const gchar	*filename,
 							 GError		**error)
 							 G_GNUC_WARN_UNUSED_RESULT;
+void		 cd_profile_add_checksum_hint		(const gchar	*filename,
+							 guint64	 mtime,
+							 guint64	 size,
+							 const gchar	*checksum);
+gboolean	 cd_profile_prewarm_filename		(const gchar	*filename,
+							 GError		**error)
+							 G_GNUC_WARN_UNUSED_RESULT;
+GVariant	*cd_profile_get_properties_as_variant	(CdProfile	*profile);
 gboolean	 cd_profile_register_object		(CdProfile	*profile,
 							 GDBusConnection *connection,
 							 GDBusInterfaceInfo *info,
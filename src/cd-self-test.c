@@ -193,7 +193,15 @@ colord_device_array_func (void)
 						     "/org/freedesktop/ColorManager/devices/dave");
 	g_assert (device != NULL);
 	g_assert_cmpstr (cd_device_get_id (device), ==, "dave");
+
+	/* removed devices can no longer be found */
+	cd_device_array_remove (device_array, device);
 	g_object_unref (device);
+	device = cd_device_array_get_by_id_owner (device_array, "dave", 0, CD_DEVICE_ARRAY_FLAG_OWNER_OPTIONAL);
+	g_assert (device == NULL);
+	device = cd_device_array_get_by_object_path (device_array,
+						     "/org/freedesktop/ColorManager/devices/dave");
+	g_assert (device == NULL);
 
 	g_object_unref (device_array);
 	g_object_unref (ddb);
@@ -380,6 +388,12 @@ cd_device_db_func (void)
 	g_assert_no_error (error);
 	g_assert (ret);
 
+	/* preload the properties, like the daemon does at startup; the
+	 * rest of the test then runs against the in-memory map */
+	ret = cd_device_db_preload (ddb, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+
 	/* ensure empty */
 	ret = cd_device_db_empty (ddb, &error);
 	g_assert_no_error (error);
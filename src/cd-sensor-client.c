@@ -207,6 +207,82 @@ out:
 	return;
 }
 
+typedef struct {
+	CdSensorClient		*sensor_client;
+	GUdevDevice		*device;
+	CdSensor		*sensor;
+} CdSensorClientColdplugHelper;
+
+static void
+cd_sensor_client_coldplug_helper_free (CdSensorClientColdplugHelper *helper)
+{
+	g_object_unref (helper->sensor_client);
+	g_object_unref (helper->device);
+	g_object_unref (helper->sensor);
+	g_free (helper);
+}
+
+static void
+cd_sensor_client_coldplug_thread_cb (GTask *task,
+				     gpointer source_object,
+				     gpointer task_data,
+				     GCancellable *cancellable)
+{
+	CdSensorClientColdplugHelper *helper = (CdSensorClientColdplugHelper *) task_data;
+	gboolean ret;
+	g_autoptr(GError) error = NULL;
+
+	/* the sensor is private to this thread until it is announced */
+	ret = cd_sensor_set_from_device (helper->sensor, helper->device, &error);
+	if (!ret) {
+		g_task_return_new_error (task,
+					 G_IO_ERROR,
+					 G_IO_ERROR_FAILED,
+					 "failed to set CM sensor: %s",
+					 error->message);
+		return;
+	}
+
+	/* load the sensor, which for argyll spawns a probe */
+	ret = cd_sensor_load (helper->sensor, &error);
+	if (!ret) {
+		/* not fatal, non-native devices are still usable */
+		g_debug ("CdSensorClient: failed to load native sensor: %s",
+			 error->message);
+	}
+	g_task_return_boolean (task, TRUE);
+}
+
+static void
+cd_sensor_client_coldplug_cb (GObject *source_object,
+			      GAsyncResult *res,
+			      gpointer user_data)
+{
+	CdSensorClientColdplugHelper *helper;
+	CdSensorClientPrivate *priv;
+	g_autoptr(GError) error = NULL;
+
+	helper = g_task_get_task_data (G_TASK (res));
+	priv = GET_PRIVATE (helper->sensor_client);
+	if (!g_task_propagate_boolean (G_TASK (res), &error)) {
+		g_warning ("CdSensorClient: %s", error->message);
+		return;
+	}
+
+	/* set the index */
+	cd_sensor_set_index (helper->sensor, priv->idx);
+
+	/* signal the addition */
+	g_debug ("emit: added");
+	g_signal_emit (helper->sensor_client,
+		       signals[SIGNAL_SENSOR_ADDED], 0,
+		       helper->sensor);
+	priv->idx++;
+
+	/* keep track so we can remove with the same device */
+	g_ptr_array_add (priv->array_sensors, g_object_ref (helper->sensor));
+}
+
 void
 cd_sensor_client_coldplug (CdSensorClient *sensor_client)
 {
@@ -219,8 +295,35 @@ cd_sensor_client_coldplug (CdSensorClient *sensor_client)
 	devices = g_udev_client_query_by_subsystem (priv->gudev_client,
 						    "usb");
 	for (l = devices; l != NULL; l = l->next) {
+		CdSensorClientColdplugHelper *helper;
+		g_autoptr(GTask) task = NULL;
 		udev_device = l->data;
-		cd_sensor_client_add (sensor_client, udev_device);
+
+		/* interesting device? */
+		if (g_udev_device_get_property (udev_device, "COLORD_SENSOR_KIND") == NULL)
+			continue;
+		if (g_udev_device_get_property (udev_device, "COLORD_IGNORE") != NULL)
+			continue;
+
+		/* actual device? */
+		if (g_udev_device_get_device_file (udev_device) == NULL)
+			continue;
+
+		/* probe each device concurrently so daemon readiness is
+		 * not held up by the slowest instrument; sensors are
+		 * announced from the main context as they become ready */
+		g_debug ("adding color management device: %s [%s]",
+			 g_udev_device_get_sysfs_path (udev_device),
+			 g_udev_device_get_device_file (udev_device));
+		helper = g_new0 (CdSensorClientColdplugHelper, 1);
+		helper->sensor_client = g_object_ref (sensor_client);
+		helper->device = g_object_ref (udev_device);
+		helper->sensor = cd_sensor_new ();
+		task = g_task_new (NULL, NULL,
+				   cd_sensor_client_coldplug_cb, NULL);
+		g_task_set_task_data (task, helper,
+				      (GDestroyNotify) cd_sensor_client_coldplug_helper_free);
+		g_task_run_in_thread (task, cd_sensor_client_coldplug_thread_cb);
 	}
 	g_list_foreach (devices, (GFunc) g_object_unref, NULL);
 	g_list_free (devices);
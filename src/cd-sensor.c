@@ -28,6 +28,7 @@
 #include <colord-private.h>
 
 #include "cd-common.h"
+#include "cd-debug.h"
 #include "cd-sensor.h"
 
 static void cd_sensor_finalize			 (GObject *object);
@@ -78,6 +79,14 @@ typedef struct {
 	gboolean	 (*set_options_finish)	(CdSensor		*sensor,
 						 GAsyncResult		*res,
 						 GError			**error);
+	/* optional hooks so a backend can switch the hardware in and
+	 * out of a continuous measurement mode; samples are still
+	 * pulled with get_sample_async */
+	gboolean	 (*stream_start)	(CdSensor		*sensor,
+						 CdSensorCap		 cap,
+						 GError			**error);
+	gboolean	 (*stream_stop)		(CdSensor		*sensor,
+						 GError			**error);
 } CdSensorIface;
 
 typedef struct
@@ -104,6 +113,16 @@ typedef struct
 	GHashTable			*options;
 	GHashTable			*metadata;
 	GUsbContext			*usb_ctx;
+	guint				 stream_id;
+	CdSensorCap			 stream_cap;
+	guint				 stream_batch_size;
+	gboolean			 stream_in_flight;
+	GArray				*stream_samples;	/* of CdColorXYZ */
+	guint				 sample_ttl_ms;
+	gint64				 sample_cache_ts[CD_SENSOR_CAP_LAST]; /* monotonic µs, 0 = empty */
+	CdColorXYZ			 sample_cache_xyz[CD_SENSOR_CAP_LAST];
+	GPtrArray			*sample_waiters;	/* of GDBusMethodInvocation */
+	CdSensorCap			 sample_waiters_cap;
 } CdSensorPrivate;
 
 enum {
@@ -352,6 +371,8 @@ cd_sensor_load (CdSensor *sensor, GError **error)
 	g_module_symbol (handle, "cd_sensor_lock_finish", (gpointer *)&desc->lock_finish);
 	g_module_symbol (handle, "cd_sensor_unlock_async", (gpointer *)&desc->unlock_async);
 	g_module_symbol (handle, "cd_sensor_unlock_finish", (gpointer *)&desc->unlock_finish);
+	g_module_symbol (handle, "cd_sensor_stream_start", (gpointer *)&desc->stream_start);
+	g_module_symbol (handle, "cd_sensor_stream_stop", (gpointer *)&desc->stream_stop);
 
 	/* coldplug with data */
 	if (desc->coldplug != NULL)
@@ -554,12 +575,17 @@ cd_sensor_get_sample_cb (GObject *source_object,
 			 GAsyncResult *res,
 			 gpointer user_data)
 {
-	GVariant *result = NULL;
 	g_autoptr(CdColorXYZ) sample = NULL;
 	CdSensor *sensor = CD_SENSOR (source_object);
 	CdSensorPrivate *priv = GET_PRIVATE (sensor);
-	GDBusMethodInvocation *invocation = (GDBusMethodInvocation *) user_data;
+	guint i;
 	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) waiters = NULL;
+
+	/* take the waiters before completing any of them, so a request
+	 * arriving from a completion handler starts a new measurement */
+	waiters = priv->sample_waiters;
+	priv->sample_waiters = NULL;
 
 	/* set here to avoid every sensor doing this */
 	cd_sensor_set_state (sensor, CD_SENSOR_STATE_IDLE);
@@ -567,14 +593,90 @@ cd_sensor_get_sample_cb (GObject *source_object,
 	/* get the result */
 	sample = priv->desc->get_sample_finish (sensor, res, &error);
 	if (sample == NULL) {
-		g_dbus_method_invocation_return_gerror (invocation, error);
+		for (i = 0; i < waiters->len; i++) {
+			g_dbus_method_invocation_return_gerror (g_ptr_array_index (waiters, i),
+								error);
+		}
 		return;
 	}
 
-	/* return value */
-	g_debug ("returning value %f, %f, %f", sample->X, sample->Y, sample->Z);
-	result = g_variant_new ("(ddd)", sample->X, sample->Y, sample->Z);
-	g_dbus_method_invocation_return_value (invocation, result);
+	/* save for requests inside the freshness window */
+	priv->sample_cache_xyz[priv->sample_waiters_cap] = *sample;
+	priv->sample_cache_ts[priv->sample_waiters_cap] = g_get_monotonic_time ();
+
+	/* complete all the waiters from the same result */
+	CD_DEBUG ("returning value %f, %f, %f to %u waiters",
+		  sample->X, sample->Y, sample->Z, waiters->len);
+	for (i = 0; i < waiters->len; i++) {
+		g_dbus_method_invocation_return_value (g_ptr_array_index (waiters, i),
+						       g_variant_new ("(ddd)",
+								      sample->X,
+								      sample->Y,
+								      sample->Z));
+	}
+}
+
+/* tracks a GetSamples request across the chained readings */
+typedef struct {
+	CdSensor		*sensor;
+	GDBusMethodInvocation	*invocation;
+	GArray			*caps;
+	guint			 idx;
+	GVariantBuilder		 samples;
+} CdSensorBatchHelper;
+
+static void
+cd_sensor_batch_helper_free (CdSensorBatchHelper *helper)
+{
+	g_array_unref (helper->caps);
+	g_object_unref (helper->sensor);
+	g_free (helper);
+}
+
+static void
+cd_sensor_get_samples_cb (GObject *source_object,
+			  GAsyncResult *res,
+			  gpointer user_data)
+{
+	CdSensor *sensor = CD_SENSOR (source_object);
+	CdSensorPrivate *priv = GET_PRIVATE (sensor);
+	CdSensorBatchHelper *helper = (CdSensorBatchHelper *) user_data;
+	GVariant *result = NULL;
+	g_autoptr(CdColorXYZ) sample = NULL;
+	g_autoptr(GError) error = NULL;
+
+	/* get the result */
+	sample = priv->desc->get_sample_finish (sensor, res, &error);
+	if (sample == NULL) {
+		cd_sensor_set_state (sensor, CD_SENSOR_STATE_IDLE);
+		g_variant_builder_clear (&helper->samples);
+		g_dbus_method_invocation_return_gerror (helper->invocation, error);
+		cd_sensor_batch_helper_free (helper);
+		return;
+	}
+
+	/* save value */
+	CD_DEBUG ("got value %f, %f, %f", sample->X, sample->Y, sample->Z);
+	g_variant_builder_add (&helper->samples, "(ddd)",
+			       sample->X, sample->Y, sample->Z);
+
+	/* more to do? the instrument stays set up for the next reading */
+	if (++helper->idx < helper->caps->len) {
+		priv->desc->get_sample_async (sensor,
+					      g_array_index (helper->caps,
+							     CdSensorCap,
+							     helper->idx),
+					      NULL,
+					      cd_sensor_get_samples_cb,
+					      helper);
+		return;
+	}
+
+	/* return batch */
+	cd_sensor_set_state (sensor, CD_SENSOR_STATE_IDLE);
+	result = g_variant_new ("(a(ddd))", &helper->samples);
+	g_dbus_method_invocation_return_value (helper->invocation, result);
+	cd_sensor_batch_helper_free (helper);
 }
 
 static void
@@ -609,10 +711,10 @@ cd_sensor_get_spectrum_cb (GObject *source_object,
 	}
 
 	/* return value */
-	g_debug ("returning value %f, %f, [%u]",
-		 cd_spectrum_get_start (sp),
-		 cd_spectrum_get_end (sp),
-		 cd_spectrum_get_size (sp));
+	CD_DEBUG ("returning value %f, %f, [%u]",
+		  cd_spectrum_get_start (sp),
+		  cd_spectrum_get_end (sp),
+		  cd_spectrum_get_size (sp));
 	result = g_variant_new ("(ddad)",
 				cd_spectrum_get_start (sp),
 				cd_spectrum_get_end (sp),
@@ -739,6 +841,203 @@ cd_sensor_unlock_quietly_cb (GObject *source_object,
 	cd_sensor_set_locked (sensor, FALSE);
 }
 
+static void
+cd_sensor_stream_flush (CdSensor *sensor)
+{
+	CdSensorPrivate *priv = GET_PRIVATE (sensor);
+	CdColorXYZ *sample;
+	GVariantBuilder builder;
+	guint i;
+
+	/* nothing batched up, or not yet connected */
+	if (priv->stream_samples == NULL ||
+	    priv->stream_samples->len == 0 ||
+	    priv->connection == NULL)
+		return;
+
+	/* emit one signal for the whole batch */
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(ddd)"));
+	for (i = 0; i < priv->stream_samples->len; i++) {
+		sample = &g_array_index (priv->stream_samples, CdColorXYZ, i);
+		g_variant_builder_add (&builder, "(ddd)",
+				       sample->X, sample->Y, sample->Z);
+	}
+	CD_DEBUG ("CdSensor: emit StreamSamples [%u] on %s",
+		  priv->stream_samples->len, priv->object_path);
+	g_dbus_connection_emit_signal (priv->connection,
+				       NULL,
+				       priv->object_path,
+				       COLORD_DBUS_INTERFACE_SENSOR,
+				       "StreamSamples",
+				       g_variant_new ("(a(ddd))", &builder),
+				       NULL);
+	g_array_set_size (priv->stream_samples, 0);
+}
+
+static void
+cd_sensor_stream_stop (CdSensor *sensor)
+{
+	CdSensorPrivate *priv = GET_PRIVATE (sensor);
+	g_autoptr(GError) error = NULL;
+
+	/* not streaming */
+	if (priv->stream_id == 0)
+		return;
+
+	/* deliver anything not yet batched up to the full size */
+	cd_sensor_stream_flush (sensor);
+	g_source_remove (priv->stream_id);
+	priv->stream_id = 0;
+	g_array_unref (priv->stream_samples);
+	priv->stream_samples = NULL;
+
+	/* let the backend take the hardware out of continuous mode */
+	if (priv->desc != NULL &&
+	    priv->desc->stream_stop != NULL) {
+		if (!priv->desc->stream_stop (sensor, &error))
+			g_warning ("failed to stop stream: %s", error->message);
+	}
+}
+
+static void
+cd_sensor_stream_sample_cb (GObject *source_object,
+			    GAsyncResult *res,
+			    gpointer user_data)
+{
+	CdSensor *sensor = CD_SENSOR (source_object);
+	CdSensorPrivate *priv = GET_PRIVATE (sensor);
+	g_autoptr(CdColorXYZ) sample = NULL;
+	g_autoptr(GError) error = NULL;
+
+	/* set here to avoid every sensor doing this */
+	cd_sensor_set_state (sensor, CD_SENSOR_STATE_IDLE);
+	priv->stream_in_flight = FALSE;
+
+	/* stop streaming rather than wedging the mainloop with a
+	 * sensor that has started to fail */
+	sample = priv->desc->get_sample_finish (sensor, res, &error);
+	if (sample == NULL) {
+		g_warning ("failed to get streamed sample: %s",
+			   error->message);
+		cd_sensor_stream_stop (sensor);
+		return;
+	}
+
+	/* stopped while the reading was in flight */
+	if (priv->stream_samples == NULL)
+		return;
+
+	/* batch up, and deliver when full */
+	g_array_append_val (priv->stream_samples, *sample);
+	if (priv->stream_samples->len >= priv->stream_batch_size)
+		cd_sensor_stream_flush (sensor);
+}
+
+static gboolean
+cd_sensor_stream_tick_cb (gpointer user_data)
+{
+	CdSensor *sensor = CD_SENSOR (user_data);
+	CdSensorPrivate *priv = GET_PRIVATE (sensor);
+
+	/* the last reading has not come back yet, or something else is
+	 * using the sensor; just skip this tick */
+	if (priv->stream_in_flight ||
+	    priv->state != CD_SENSOR_STATE_IDLE)
+		return G_SOURCE_CONTINUE;
+
+	priv->stream_in_flight = TRUE;
+	priv->desc->get_sample_async (sensor,
+				      priv->stream_cap,
+				      NULL,
+				      cd_sensor_stream_sample_cb,
+				      NULL);
+	return G_SOURCE_CONTINUE;
+}
+
+/**
+ * cd_sensor_can_get_sample:
+ *
+ * Checks the sensor is locked, idle and has sample support, so a
+ * caller fanning out to several sensors can fail fast before any of
+ * them have been triggered.
+ **/
+gboolean
+cd_sensor_can_get_sample (CdSensor *sensor, GError **error)
+{
+	CdSensorPrivate *priv = GET_PRIVATE (sensor);
+
+	g_return_val_if_fail (CD_IS_SENSOR (sensor), FALSE);
+
+	/* check locked */
+	if (!priv->locked) {
+		g_set_error (error,
+			     CD_SENSOR_ERROR,
+			     CD_SENSOR_ERROR_NOT_LOCKED,
+			     "sensor %s is not yet locked",
+			     priv->id);
+		return FALSE;
+	}
+
+	/* check idle */
+	if (priv->state != CD_SENSOR_STATE_IDLE) {
+		g_set_error (error,
+			     CD_SENSOR_ERROR,
+			     CD_SENSOR_ERROR_IN_USE,
+			     "sensor %s not idle: %s",
+			     priv->id,
+			     cd_sensor_state_to_string (priv->state));
+		return FALSE;
+	}
+
+	/* no support */
+	if (priv->desc == NULL ||
+	    priv->desc->get_sample_async == NULL) {
+		g_set_error (error,
+			     CD_SENSOR_ERROR,
+			     CD_SENSOR_ERROR_NO_SUPPORT,
+			     "no sensor->get_sample for %s",
+			     priv->id);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/**
+ * cd_sensor_measure_async:
+ *
+ * Proxies to the backend get_sample vfunc; each sensor has its own
+ * async state machine so distinct sensors can measure concurrently.
+ * cd_sensor_can_get_sample() has to be checked first.
+ **/
+void
+cd_sensor_measure_async (CdSensor *sensor,
+			 CdSensorCap cap,
+			 GCancellable *cancellable,
+			 GAsyncReadyCallback callback,
+			 gpointer user_data)
+{
+	CdSensorPrivate *priv = GET_PRIVATE (sensor);
+	g_return_if_fail (CD_IS_SENSOR (sensor));
+	priv->desc->get_sample_async (sensor,
+				      cap,
+				      cancellable,
+				      callback,
+				      user_data);
+}
+
+CdColorXYZ *
+cd_sensor_measure_finish (CdSensor *sensor,
+			  GAsyncResult *res,
+			  GError **error)
+{
+	CdSensorPrivate *priv = GET_PRIVATE (sensor);
+	g_return_val_if_fail (CD_IS_SENSOR (sensor), NULL);
+
+	/* set here to avoid every sensor doing this */
+	cd_sensor_set_state (sensor, CD_SENSOR_STATE_IDLE);
+	return priv->desc->get_sample_finish (sensor, res, error);
+}
+
 static void
 cd_sensor_name_vanished_cb (GDBusConnection *connection,
 			     const gchar *name,
@@ -749,6 +1048,7 @@ cd_sensor_name_vanished_cb (GDBusConnection *connection,
 
 	/* dummy */
 	g_debug ("locked sender has vanished without doing Unlock()!");
+	cd_sensor_stream_stop (sensor);
 	if (priv->desc == NULL ||
 	    priv->desc->unlock_async == NULL) {
 		cd_sensor_set_locked (sensor, FALSE);
@@ -858,6 +1158,9 @@ cd_sensor_dbus_method_call (GDBusConnection *connection, const gchar *sender,
 			return;
 		}
 
+		/* stop any sample stream the sender had running */
+		cd_sensor_stream_stop (sensor);
+
 		/* un-watch this bus name */
 		if (priv->watcher_id != 0) {
 			g_bus_unwatch_name (priv->watcher_id);
@@ -894,16 +1197,6 @@ cd_sensor_dbus_method_call (GDBusConnection *connection, const gchar *sender,
 			return;
 		}
 
-		/*  check idle */
-		if (priv->state != CD_SENSOR_STATE_IDLE) {
-			g_dbus_method_invocation_return_error (invocation,
-							       CD_SENSOR_ERROR,
-							       CD_SENSOR_ERROR_IN_USE,
-							       "sensor not idle: %s",
-							       cd_sensor_state_to_string (priv->state));
-			return;
-		}
-
 		/* no support */
 		if (priv->desc == NULL ||
 		    priv->desc->get_sample_async == NULL) {
@@ -935,12 +1228,136 @@ cd_sensor_dbus_method_call (GDBusConnection *connection, const gchar *sender,
 			return;
 		}
 
+		/* fresh enough? serve the last reading without touching
+		 * the hardware, several desktop components poll this */
+		if (priv->sample_ttl_ms > 0 &&
+		    priv->sample_cache_ts[cap] > 0 &&
+		    g_get_monotonic_time () - priv->sample_cache_ts[cap] <
+			(gint64) priv->sample_ttl_ms * 1000) {
+			g_debug ("returning cached value %f, %f, %f",
+				 priv->sample_cache_xyz[cap].X,
+				 priv->sample_cache_xyz[cap].Y,
+				 priv->sample_cache_xyz[cap].Z);
+			g_dbus_method_invocation_return_value (invocation,
+							       g_variant_new ("(ddd)",
+									      priv->sample_cache_xyz[cap].X,
+									      priv->sample_cache_xyz[cap].Y,
+									      priv->sample_cache_xyz[cap].Z));
+			return;
+		}
+
+		/* measurement already in flight for this cap? complete
+		 * this caller from the same result */
+		if (priv->sample_waiters != NULL &&
+		    priv->sample_waiters_cap == cap) {
+			g_ptr_array_add (priv->sample_waiters, invocation);
+			return;
+		}
+
+		/*  check idle */
+		if (priv->state != CD_SENSOR_STATE_IDLE) {
+			g_dbus_method_invocation_return_error (invocation,
+							       CD_SENSOR_ERROR,
+							       CD_SENSOR_ERROR_IN_USE,
+							       "sensor not idle: %s",
+							       cd_sensor_state_to_string (priv->state));
+			return;
+		}
+
 		/* proxy */
+		priv->sample_waiters = g_ptr_array_new ();
+		priv->sample_waiters_cap = cap;
+		g_ptr_array_add (priv->sample_waiters, invocation);
 		priv->desc->get_sample_async (sensor,
 					      cap,
 					      NULL,
 					      cd_sensor_get_sample_cb,
-					      invocation);
+					      NULL);
+		return;
+	}
+
+	/* return 'a(ddd)' */
+	if (g_strcmp0 (method_name, "GetSamples") == 0) {
+
+		CdSensorBatchHelper *helper;
+		g_autofree const gchar **caps_tmp = NULL;
+		g_autoptr(GArray) caps = NULL;
+		guint i;
+
+		g_debug ("CdSensor %s:GetSamples()", sender);
+
+		/* check locked */
+		if (!priv->locked) {
+			g_dbus_method_invocation_return_error (invocation,
+							       CD_SENSOR_ERROR,
+							       CD_SENSOR_ERROR_NOT_LOCKED,
+							       "sensor is not yet locked");
+			return;
+		}
+
+		/*  check idle */
+		if (priv->state != CD_SENSOR_STATE_IDLE) {
+			g_dbus_method_invocation_return_error (invocation,
+							       CD_SENSOR_ERROR,
+							       CD_SENSOR_ERROR_IN_USE,
+							       "sensor not idle: %s",
+							       cd_sensor_state_to_string (priv->state));
+			return;
+		}
+
+		/* no support */
+		if (priv->desc == NULL ||
+		    priv->desc->get_sample_async == NULL) {
+			g_dbus_method_invocation_return_error (invocation,
+							       CD_SENSOR_ERROR,
+							       CD_SENSOR_ERROR_NO_SUPPORT,
+							       "no sensor->get_sample");
+			return;
+		}
+
+		/* get the types */
+		g_variant_get (parameters, "(^a&s)", &caps_tmp);
+		caps = g_array_new (FALSE, FALSE, sizeof (CdSensorCap));
+		for (i = 0; caps_tmp[i] != NULL; i++) {
+			cap = cd_sensor_cap_from_string (caps_tmp[i]);
+			if (cap == CD_SENSOR_CAP_UNKNOWN) {
+				g_dbus_method_invocation_return_error (invocation,
+								       CD_SENSOR_ERROR,
+								       CD_SENSOR_ERROR_INTERNAL,
+								       "cap '%s' unknown",
+								       caps_tmp[i]);
+				return;
+			}
+			if (cap == CD_SENSOR_CAP_SPECTRAL) {
+				g_dbus_method_invocation_return_error (invocation,
+								       CD_SENSOR_ERROR,
+								       CD_SENSOR_ERROR_INTERNAL,
+								       "cannot return spectral");
+				return;
+			}
+			g_array_append_val (caps, cap);
+		}
+		if (caps->len == 0) {
+			g_dbus_method_invocation_return_error (invocation,
+							       CD_SENSOR_ERROR,
+							       CD_SENSOR_ERROR_INTERNAL,
+							       "no capabilities given");
+			return;
+		}
+
+		/* proxy the first reading; the callback chains the rest
+		 * without going back to idle in between */
+		helper = g_new0 (CdSensorBatchHelper, 1);
+		helper->sensor = g_object_ref (sensor);
+		helper->invocation = invocation;
+		helper->caps = g_array_ref (caps);
+		g_variant_builder_init (&helper->samples,
+					G_VARIANT_TYPE ("a(ddd)"));
+		priv->desc->get_sample_async (sensor,
+					      g_array_index (caps, CdSensorCap, 0),
+					      NULL,
+					      cd_sensor_get_samples_cb,
+					      helper);
 		return;
 	}
 
@@ -1011,6 +1428,120 @@ cd_sensor_dbus_method_call (GDBusConnection *connection, const gchar *sender,
 		return;
 	}
 
+	/* return '' */
+	if (g_strcmp0 (method_name, "StartStream") == 0) {
+
+		guint batch_size;
+		guint interval_ms;
+
+		g_debug ("CdSensor %s:StartStream()", sender);
+
+		/* check locked */
+		if (!priv->locked) {
+			g_dbus_method_invocation_return_error (invocation,
+							       CD_SENSOR_ERROR,
+							       CD_SENSOR_ERROR_NOT_LOCKED,
+							       "sensor is not yet locked");
+			return;
+		}
+
+		/* check not already streaming */
+		if (priv->stream_id != 0) {
+			g_dbus_method_invocation_return_error (invocation,
+							       CD_SENSOR_ERROR,
+							       CD_SENSOR_ERROR_IN_USE,
+							       "sensor is already streaming");
+			return;
+		}
+
+		/* no support */
+		if (priv->desc == NULL ||
+		    priv->desc->get_sample_async == NULL) {
+			g_dbus_method_invocation_return_error (invocation,
+							       CD_SENSOR_ERROR,
+							       CD_SENSOR_ERROR_NO_SUPPORT,
+							       "no sensor->get_sample");
+			return;
+		}
+
+		/* get the type */
+		g_variant_get (parameters, "(&suu)",
+			       &cap_tmp, &interval_ms, &batch_size);
+		cap = cd_sensor_cap_from_string (cap_tmp);
+		if (cap == CD_SENSOR_CAP_UNKNOWN) {
+			g_dbus_method_invocation_return_error (invocation,
+							       CD_SENSOR_ERROR,
+							       CD_SENSOR_ERROR_INTERNAL,
+							       "cap '%s' unknown",
+							       cap_tmp);
+			return;
+		}
+
+		/* check type */
+		if (cap == CD_SENSOR_CAP_SPECTRAL) {
+			g_dbus_method_invocation_return_error (invocation,
+							       CD_SENSOR_ERROR,
+							       CD_SENSOR_ERROR_INTERNAL,
+							       "cannot stream spectral");
+			return;
+		}
+
+		/* don't allow the bus to be flooded */
+		if (interval_ms < 100) {
+			g_dbus_method_invocation_return_error (invocation,
+							       CD_SENSOR_ERROR,
+							       CD_SENSOR_ERROR_INTERNAL,
+							       "interval of %ums is too small",
+							       interval_ms);
+			return;
+		}
+
+		/* let the backend put the hardware in continuous mode */
+		if (priv->desc->stream_start != NULL) {
+			if (!priv->desc->stream_start (sensor, cap, &error)) {
+				g_dbus_method_invocation_return_error (invocation,
+								       CD_SENSOR_ERROR,
+								       CD_SENSOR_ERROR_NO_SUPPORT,
+								       "failed to start stream: %s",
+								       error->message);
+				return;
+			}
+		}
+
+		/* all state is set up before the first tick, so readings
+		 * cost no allocations and no method traffic */
+		priv->stream_cap = cap;
+		priv->stream_batch_size = MAX (batch_size, 1);
+		priv->stream_samples = g_array_sized_new (FALSE, FALSE,
+							  sizeof (CdColorXYZ),
+							  priv->stream_batch_size);
+		priv->stream_id = g_timeout_add (interval_ms,
+						 cd_sensor_stream_tick_cb,
+						 sensor);
+		g_dbus_method_invocation_return_value (invocation, NULL);
+		return;
+	}
+
+	/* return '' */
+	if (g_strcmp0 (method_name, "StopStream") == 0) {
+
+		g_debug ("CdSensor %s:StopStream()", sender);
+
+		/* check streaming */
+		if (priv->stream_id == 0) {
+			g_dbus_method_invocation_return_error (invocation,
+							       CD_SENSOR_ERROR,
+							       CD_SENSOR_ERROR_INTERNAL,
+							       "sensor is not streaming");
+			return;
+		}
+
+		/* also delivers any partial batch */
+		cd_sensor_stream_stop (sensor);
+		g_dbus_method_invocation_return_value (invocation, NULL);
+		return;
+	}
+
 	/* return '' */
 	if (g_strcmp0 (method_name, "SetOptions") == 0) {
 
@@ -1038,6 +1569,38 @@ cd_sensor_dbus_method_call (GDBusConnection *connection, const gchar *sender,
 			return;
 		}
 
+		/* unwrap the parameters into a hash table */
+		options = g_hash_table_new_full (g_str_hash, g_str_equal,
+						 g_free, (GDestroyNotify) g_variant_unref);
+		result = g_variant_get_child_value (parameters, 0);
+		g_variant_iter_init (&iter, result);
+		while (g_variant_iter_next (&iter, "{sv}", &key, &value))
+			g_hash_table_insert (options, key, value);
+
+		/* the freshness window is handled entirely in the daemon */
+		value = g_hash_table_lookup (options, "sample-cache-ttl");
+		if (value != NULL) {
+			if (!g_variant_is_of_type (value, G_VARIANT_TYPE_UINT32)) {
+				g_dbus_method_invocation_return_error (invocation,
+								       CD_SENSOR_ERROR,
+								       CD_SENSOR_ERROR_INTERNAL,
+								       "sample-cache-ttl requires a uint32 value");
+				return;
+			}
+			priv->sample_ttl_ms = g_variant_get_uint32 (value);
+			g_debug ("sample cache TTL now %ums", priv->sample_ttl_ms);
+			cd_sensor_add_option (sensor, "sample-cache-ttl", value);
+			g_hash_table_remove (options, "sample-cache-ttl");
+
+			/* nothing left for the backend; an empty option
+			 * set means 'commit' for some backends so do not
+			 * pass one through */
+			if (g_hash_table_size (options) == 0) {
+				g_dbus_method_invocation_return_value (invocation, NULL);
+				return;
+			}
+		}
+
 		/* no support */
 		if (priv->desc == NULL ||
 		    priv->desc->set_options_async == NULL) {
@@ -1048,14 +1611,6 @@ cd_sensor_dbus_method_call (GDBusConnection *connection, const gchar *sender,
 			return;
 		}
 
-		/* unwrap the parameters into a hash table */
-		options = g_hash_table_new_full (g_str_hash, g_str_equal,
-						 g_free, (GDestroyNotify) g_variant_unref);
-		result = g_variant_get_child_value (parameters, 0);
-		g_variant_iter_init (&iter, result);
-		while (g_variant_iter_next (&iter, "{sv}", &key, &value))
-			g_hash_table_insert (options, key, value);
-
 		/* proxy */
 		priv->desc->set_options_async (sensor,
 						       options,
@@ -1188,6 +1743,42 @@ cd_sensor_dbus_get_property (GDBusConnection *connection_, const gchar *sender,
 	return NULL;
 }
 
+GVariant *
+cd_sensor_get_properties_as_variant (CdSensor *sensor)
+{
+	GVariant *value;
+	GVariantBuilder builder;
+	guint i;
+	const gchar *props[] = {
+		CD_SENSOR_PROPERTY_ID,
+		CD_SENSOR_PROPERTY_KIND,
+		CD_SENSOR_PROPERTY_STATE,
+		CD_SENSOR_PROPERTY_MODE,
+		CD_SENSOR_PROPERTY_SERIAL,
+		CD_SENSOR_PROPERTY_MODEL,
+		CD_SENSOR_PROPERTY_VENDOR,
+		CD_SENSOR_PROPERTY_NATIVE,
+		CD_SENSOR_PROPERTY_LOCKED,
+		CD_SENSOR_PROPERTY_EMBEDDED,
+		CD_SENSOR_PROPERTY_CAPABILITIES,
+		CD_SENSOR_PROPERTY_OPTIONS,
+		CD_SENSOR_PROPERTY_METADATA,
+		NULL };
+
+	g_return_val_if_fail (CD_IS_SENSOR (sensor), NULL);
+
+	/* build the same dictionary o.fd.DBus.Properties.GetAll would */
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+	for (i = 0; props[i] != NULL; i++) {
+		value = cd_sensor_dbus_get_property (NULL, NULL, NULL, NULL,
+						     props[i], NULL, sensor);
+		if (value == NULL)
+			continue;
+		g_variant_builder_add (&builder, "{sv}", props[i], value);
+	}
+	return g_variant_ref_sink (g_variant_builder_end (&builder));
+}
+
 gboolean
 cd_sensor_register_object (CdSensor *sensor,
 			   GDBusConnection *connection,
@@ -1647,6 +2238,12 @@ cd_sensor_finalize (GObject *object)
 		g_bus_unwatch_name (priv->watcher_id);
 	if (priv->set_state_id > 0)
 		g_source_remove (priv->set_state_id);
+	if (priv->stream_id > 0)
+		g_source_remove (priv->stream_id);
+	if (priv->stream_samples != NULL)
+		g_array_unref (priv->stream_samples);
+	if (priv->sample_waiters != NULL)
+		g_ptr_array_unref (priv->sample_waiters);
 	g_free (priv->model);
 	g_free (priv->vendor);
 	g_free (priv->serial);
@@ -62,6 +62,7 @@ const gchar	*cd_sensor_get_id		(CdSensor		*sensor);
 const gchar	*cd_sensor_get_object_path	(CdSensor		*sensor);
 const gchar	*cd_sensor_get_device_path	(CdSensor		*sensor);
 const gchar	*cd_sensor_get_usb_path		(CdSensor		*sensor);
+GVariant	*cd_sensor_get_properties_as_variant (CdSensor		*sensor);
 gboolean	 cd_sensor_register_object	(CdSensor		*sensor,
 						 GDBusConnection	*connection,
 						 GDBusInterfaceInfo	*info,
@@ -100,6 +101,16 @@ void		 cd_sensor_add_option		(CdSensor		*sensor,
 						 GVariant		*value);
 void		 cd_sensor_add_cap		(CdSensor		*sensor,
 						 CdSensorCap		 cap);
+gboolean	 cd_sensor_can_get_sample	(CdSensor		*sensor,
+						 GError			**error);
+void		 cd_sensor_measure_async	(CdSensor		*sensor,
+						 CdSensorCap		 cap,
+						 GCancellable		*cancellable,
+						 GAsyncReadyCallback	 callback,
+						 gpointer		 user_data);
+CdColorXYZ	*cd_sensor_measure_finish	(CdSensor		*sensor,
+						 GAsyncResult		*res,
+						 GError			**error);
 
 /* GModule */
 void		 cd_sensor_get_sample_async	(CdSensor		*sensor,
@@ -29,6 +29,7 @@
 #include "cd-spawn.h"
 
 #define CD_SENSOR_ARGYLL_MAX_SAMPLE_TIME	60000 /* ms */
+#define CD_SENSOR_ARGYLL_WARM_TIMEOUT		60 /* s */
 
 typedef enum {
 	CD_SENSOR_ARGYLL_POS_UNKNOWN,
@@ -39,7 +40,9 @@ typedef enum {
 typedef struct {
 	gboolean			 done_startup;
 	CdSpawn				*spawn;
+	CdSensorCap			 spawn_cap;
 	guint				 communication_port;
+	guint				 warm_id;
 	CdSensorArgyllPos		 pos_required;
 } CdSensorArgyllPrivate;
 
@@ -54,6 +57,7 @@ typedef struct {
 	gboolean		 ret;
 	CdColorXYZ		*sample;
 	CdSensor		*sensor;
+	CdSensorCap		 cap;
 	guint			 exit_id;
 	guint			 stdout_id;
 	guint			 timeout_id;
@@ -211,33 +215,16 @@ cd_sensor_get_y_arg_for_cap (CdSensorCap cap)
 	return arg;
 }
 
-void
-cd_sensor_get_sample_async (CdSensor *sensor,
-			    CdSensorCap cap,
-			    GCancellable *cancellable,
-			    GAsyncReadyCallback callback,
-			    gpointer user_data)
+static void
+cd_sensor_get_sample_start (GTask *task)
 {
-	CdSensorArgyllPrivate *priv = cd_sensor_argyll_get_private (sensor);
-	CdSensorTaskData *data;
-	GTask *task = NULL;
+	CdSensorTaskData *data = g_task_get_task_data (task);
+	CdSensorArgyllPrivate *priv = cd_sensor_argyll_get_private (data->sensor);
 	const gchar *envp[] = { "ARGYLL_NOT_INTERACTIVE=1", NULL };
 	gboolean ret;
 	g_autoptr(GError) error = NULL;
 	g_autoptr(GPtrArray) argv = NULL;
 
-	g_return_if_fail (CD_IS_SENSOR (sensor));
-
-	task = g_task_new (sensor, cancellable, callback, user_data);
-
-	/* set state */
-	data = g_new0 (CdSensorTaskData, 1);
-	data->sensor = g_object_ref (sensor);
-	g_task_set_task_data (task, data, (GDestroyNotify) cd_sensor_task_data_free);
-
-	/* set state */
-	cd_sensor_set_state (sensor, CD_SENSOR_STATE_MEASURING);
-
 	/* connect before spotread produces values */
 	data->exit_id = g_signal_connect (priv->spawn,
 					  "exit",
@@ -255,8 +242,9 @@ cd_sensor_get_sample_async (CdSensor *sensor,
 		g_ptr_array_add (argv, g_strdup ("-d"));
 		g_ptr_array_add (argv, g_strdup_printf ("-c%u", priv->communication_port));
 		g_ptr_array_add (argv, g_strdup ("-N")); //no autocal
-		g_ptr_array_add (argv, g_strdup (cd_sensor_get_y_arg_for_cap (cap)));
+		g_ptr_array_add (argv, g_strdup (cd_sensor_get_y_arg_for_cap (data->cap)));
 		g_ptr_array_add (argv, NULL);
+		priv->spawn_cap = data->cap;
 		ret = cd_spawn_argv (priv->spawn,
 				     (gchar **) argv->pdata,
 				     (gchar **) envp,
@@ -271,11 +259,68 @@ cd_sensor_get_sample_async (CdSensor *sensor,
 	} else {
 		cd_spawn_send_stdin (priv->spawn, "");
 	}
+}
+
+static void
+cd_sensor_get_sample_restart_cb (CdSpawn *spawn,
+				 CdSpawnExitType exit_type,
+				 GTask *task)
+{
+	/* the stale spotread has gone, start a fresh one */
+	g_signal_handlers_disconnect_by_func (spawn,
+					      cd_sensor_get_sample_restart_cb,
+					      task);
+	cd_sensor_get_sample_start (task);
+}
+
+void
+cd_sensor_get_sample_async (CdSensor *sensor,
+			    CdSensorCap cap,
+			    GCancellable *cancellable,
+			    GAsyncReadyCallback callback,
+			    gpointer user_data)
+{
+	CdSensorArgyllPrivate *priv = cd_sensor_argyll_get_private (sensor);
+	CdSensorTaskData *data;
+	GTask *task = NULL;
+
+	g_return_if_fail (CD_IS_SENSOR (sensor));
+
+	task = g_task_new (sensor, cancellable, callback, user_data);
+
+	/* set state */
+	data = g_new0 (CdSensorTaskData, 1);
+	data->sensor = g_object_ref (sensor);
+	data->cap = cap;
+	g_task_set_task_data (task, data, (GDestroyNotify) cd_sensor_task_data_free);
+
+	/* set state */
+	cd_sensor_set_state (sensor, CD_SENSOR_STATE_MEASURING);
+
+	/* a warm spotread is attached; stop the idle reaper */
+	if (priv->warm_id != 0) {
+		g_source_remove (priv->warm_id);
+		priv->warm_id = 0;
+	}
 
 	/* cover the case where spotread crashes */
 	data->timeout_id = g_timeout_add (CD_SENSOR_ARGYLL_MAX_SAMPLE_TIME,
 					  (GSourceFunc) cd_sensor_get_sample_timeout_cb,
 					  task);
+
+	/* a warm spotread started for another capability has the wrong
+	 * -y argument; kill it and respawn when it has exited */
+	if (cd_spawn_is_running (priv->spawn) && priv->spawn_cap != cap) {
+		g_debug ("restarting spotread for %s",
+			 cd_sensor_cap_to_string (cap));
+		g_signal_connect (priv->spawn,
+				  "exit",
+				  G_CALLBACK (cd_sensor_get_sample_restart_cb),
+				  task);
+		cd_spawn_kill (priv->spawn);
+		return;
+	}
+	cd_sensor_get_sample_start (task);
 }
 
 CdColorXYZ *
@@ -288,6 +333,8 @@ cd_sensor_get_sample_finish (CdSensor *sensor, GAsyncResult *res, GError **error
 static void
 cd_sensor_unref_private (CdSensorArgyllPrivate *priv)
 {
+	if (priv->warm_id != 0)
+		g_source_remove (priv->warm_id);
 	g_object_unref (priv->spawn);
 	g_free (priv);
 }
@@ -413,23 +460,19 @@ cd_sensor_find_device_details (CdSensor *sensor, GError **error)
 	return TRUE;
 }
 
-static void
-cd_sensor_unlock_exit_cb (CdSpawn *spawn,
-			  CdSpawnExitType exit_type,
-			  GTask *task)
+static gboolean
+cd_sensor_argyll_warm_timeout_cb (gpointer user_data)
 {
-	if (exit_type != CD_SPAWN_EXIT_TYPE_SIGQUIT) {
-		g_task_return_new_error (task,
-					 CD_SENSOR_ERROR,
-					 CD_SENSOR_ERROR_INTERNAL,
-					 "exited without sigquit");
-		g_object_unref (task);
-		return;
-	}
+	CdSensor *sensor = CD_SENSOR (user_data);
+	CdSensorArgyllPrivate *priv = cd_sensor_argyll_get_private (sensor);
 
-	/* success */
-	g_task_return_boolean (task, TRUE);
-	g_object_unref (task);
+	/* nobody wanted the instrument for a while, let it go */
+	priv->warm_id = 0;
+	if (cd_spawn_is_running (priv->spawn)) {
+		g_debug ("killing idle spotread");
+		cd_spawn_kill (priv->spawn);
+	}
+	return G_SOURCE_REMOVE;
 }
 
 void
@@ -439,32 +482,26 @@ cd_sensor_unlock_async (CdSensor *sensor,
 			gpointer user_data)
 {
 	CdSensorArgyllPrivate *priv = cd_sensor_argyll_get_private (sensor);
-	CdSensorTaskData *data;
 	GTask *task = NULL;
 
 	g_return_if_fail (CD_IS_SENSOR (sensor));
 
 	task = g_task_new (sensor, cancellable, callback, user_data);
 
-	/* set state */
-	data = g_new0 (CdSensorTaskData, 1);
-	data->sensor = g_object_ref (sensor);
-	g_task_set_task_data (task, data, (GDestroyNotify) cd_sensor_task_data_free);
-
-	/* wait for exit */
-	data->exit_id = g_signal_connect (priv->spawn,
-					  "exit",
-					  G_CALLBACK (cd_sensor_unlock_exit_cb),
-					  task);
-	/* kill spotread */
-	if (!cd_spawn_kill (priv->spawn)) {
-		g_task_return_new_error (task,
-					 CD_SENSOR_ERROR,
-					 CD_SENSOR_ERROR_INTERNAL,
-					 "failed to kill spotread");
-		g_object_unref (task);
-		return;
+	/* keep the initialized spotread attached so the next session
+	 * skips the multi-second instrument startup dialogue, but reap
+	 * it if nothing uses the sensor for a while */
+	if (cd_spawn_is_running (priv->spawn) && priv->warm_id == 0) {
+		priv->warm_id = g_timeout_add_seconds (CD_SENSOR_ARGYLL_WARM_TIMEOUT,
+						       cd_sensor_argyll_warm_timeout_cb,
+						       sensor);
+		g_source_set_name_by_id (priv->warm_id,
+					 "[CdSensorArgyll] warm timeout");
 	}
+
+	/* success */
+	g_task_return_boolean (task, TRUE);
+	g_object_unref (task);
 }
 
 gboolean
@@ -478,6 +515,9 @@ cd_sensor_coldplug (CdSensor *sensor, GError **error)
 	/* create private data */
 	priv = g_new0 (CdSensorArgyllPrivate, 1);
 	priv->spawn = cd_spawn_new ();
+
+	/* spotread is very chatty in continuous-read mode */
+	cd_spawn_set_read_buf_size (priv->spawn, 0x10000);
 	g_object_set_data_full (G_OBJECT (sensor), "priv", priv,
 				(GDestroyNotify) cd_sensor_unref_private);
 
@@ -39,6 +39,7 @@
 #include <fcntl.h>
 
 #include <glib/gi18n.h>
+#include <glib-unix.h>
 
 #include "cd-spawn.h"
 
@@ -56,11 +57,15 @@ struct CdSpawnPrivate
 	gint			 stderr_fd;
 	guint			 poll_id;
 	guint			 kill_id;
+	guint			 stdout_id;
+	guint			 stderr_id;
 	gboolean		 finished;
 	gboolean		 allow_sigkill;
 	CdSpawnExitType		 exit;
 	GString			*stdout_buf;
 	GString			*stderr_buf;
+	gchar			*read_buf;
+	gsize			 read_buf_len;
 };
 
 enum {
@@ -75,15 +80,15 @@ static guint signals [SIGNAL_LAST] = { 0 };
 G_DEFINE_TYPE (CdSpawn, cd_spawn, G_TYPE_OBJECT)
 
 static gboolean
-cd_spawn_read_fd_into_buffer (gint fd, GString *string)
+cd_spawn_read_fd_into_buffer (CdSpawn *spawn, gint fd, GString *string)
 {
 	gint bytes_read;
-	gchar buffer[BUFSIZ];
+	gchar *buffer = spawn->priv->read_buf;
 
 	/* ITS4: ignore, we manually NULL terminate and GString cannot overflow */
-	while ((bytes_read = read (fd, buffer, BUFSIZ-1)) > 0) {
+	while ((bytes_read = read (fd, buffer, spawn->priv->read_buf_len - 1)) > 0) {
 		buffer[bytes_read] = '\0';
-		g_string_append (string, buffer);
+		g_string_append_len (string, buffer, bytes_read);
 	}
 
 	return TRUE;
@@ -92,34 +97,84 @@ cd_spawn_read_fd_into_buffer (gint fd, GString *string)
 static gboolean
 cd_spawn_emit_whole_lines (CdSpawn *spawn, GString *string)
 {
-	guint i;
-	guint size;
-	guint bytes_processed;
-	g_auto(GStrv) lines = NULL;
+	gchar *newline;
+	gsize offset = 0;
 
 	/* if nothing then don't emit */
 	if (string->len == 0)
 		return FALSE;
 
-	/* split into lines - the last line may be incomplete */
-	lines = g_strsplit (string->str, "\n", 0);
-	if (lines == NULL)
+	/* emit each complete line in place; terminating at the newline
+	 * means no per-line copy is required */
+	while ((newline = memchr (string->str + offset, '\n',
+				  string->len - offset)) != NULL) {
+		*newline = '\0';
+		g_signal_emit (spawn, signals [SIGNAL_STDOUT], 0,
+			       string->str + offset);
+		offset = (newline - string->str) + 1;
+	}
+	if (offset == 0)
 		return FALSE;
 
-	/* find size */
-	size = g_strv_length (lines);
+	/* usually the read ends on a line boundary and the buffer can
+	 * just be reset; an incomplete line costs one compaction per
+	 * read batch rather than one per line */
+	if (offset == string->len)
+		g_string_set_size (string, 0);
+	else
+		g_string_erase (string, 0, offset);
+	return TRUE;
+}
+
+static gboolean
+cd_spawn_stdout_cb (gint fd, GIOCondition condition, gpointer user_data)
+{
+	CdSpawn *spawn = CD_SPAWN (user_data);
+
+	cd_spawn_read_fd_into_buffer (spawn, fd, spawn->priv->stdout_buf);
+	cd_spawn_emit_whole_lines (spawn, spawn->priv->stdout_buf);
 
-	bytes_processed = 0;
-	/* we only emit n-1 strings */
-	for (i = 0; i < (size-1); i++) {
-		g_signal_emit (spawn, signals [SIGNAL_STDOUT], 0, lines[i]);
-		/* ITS4: ignore, g_strsplit always NULL terminates */
-		bytes_processed += strlen (lines[i]) + 1;
+	/* EOF, let the child poll reap the process and close the fd */
+	if (condition & (G_IO_HUP | G_IO_ERR)) {
+		spawn->priv->stdout_id = 0;
+		return G_SOURCE_REMOVE;
 	}
+	return G_SOURCE_CONTINUE;
+}
 
-	/* remove the text we've processed */
-	g_string_erase (string, 0, bytes_processed);
-	return TRUE;
+static gboolean
+cd_spawn_stderr_cb (gint fd, GIOCondition condition, gpointer user_data)
+{
+	CdSpawn *spawn = CD_SPAWN (user_data);
+
+	cd_spawn_read_fd_into_buffer (spawn, fd, spawn->priv->stderr_buf);
+	if (spawn->priv->stderr_buf->len != 0) {
+		g_signal_emit (spawn, signals [SIGNAL_STDERR], 0,
+			       spawn->priv->stderr_buf->str);
+		g_string_set_size (spawn->priv->stderr_buf, 0);
+	}
+	if (condition & (G_IO_HUP | G_IO_ERR)) {
+		spawn->priv->stderr_id = 0;
+		return G_SOURCE_REMOVE;
+	}
+	return G_SOURCE_CONTINUE;
+}
+
+/**
+ * cd_spawn_set_read_buf_size:
+ *
+ * Sets the size of the kernel read chunk, which backends producing a
+ * lot of output can raise to drain the pipe in fewer syscalls.
+ **/
+void
+cd_spawn_set_read_buf_size (CdSpawn *spawn, gsize len)
+{
+	g_return_if_fail (CD_IS_SPAWN (spawn));
+	g_return_if_fail (len > 1);
+
+	g_free (spawn->priv->read_buf);
+	spawn->priv->read_buf = g_malloc (len);
+	spawn->priv->read_buf_len = len;
 }
 
 static const gchar *
@@ -150,8 +205,8 @@ cd_spawn_check_child (CdSpawn *spawn)
 		return G_SOURCE_REMOVE;
 	}
 
-	cd_spawn_read_fd_into_buffer (spawn->priv->stdout_fd, spawn->priv->stdout_buf);
-	cd_spawn_read_fd_into_buffer (spawn->priv->stderr_fd, spawn->priv->stderr_buf);
+	cd_spawn_read_fd_into_buffer (spawn, spawn->priv->stdout_fd, spawn->priv->stdout_buf);
+	cd_spawn_read_fd_into_buffer (spawn, spawn->priv->stderr_fd, spawn->priv->stderr_buf);
 
 	/* emit all lines on standard out in one callback, as it's all probably
 	* related to the error that just happened */
@@ -189,6 +244,16 @@ cd_spawn_check_child (CdSpawn *spawn)
 		spawn->priv->poll_id = 0;
 	}
 
+	/* disconnect the fd watches before the fds are closed */
+	if (spawn->priv->stdout_id > 0) {
+		g_source_remove (spawn->priv->stdout_id);
+		spawn->priv->stdout_id = 0;
+	}
+	if (spawn->priv->stderr_id > 0) {
+		g_source_remove (spawn->priv->stderr_id);
+		spawn->priv->stderr_id = 0;
+	}
+
 	/* child exited, close resources */
 	close (spawn->priv->stdin_fd);
 	close (spawn->priv->stdout_fd);
@@ -437,7 +502,16 @@ cd_spawn_argv (CdSpawn *spawn, gchar **argv, gchar **envp, GError **error)
 		g_source_remove (spawn->priv->poll_id);
 	}
 
-	/* poll quickly */
+	/* dispatch reads when data actually arrives, rather than
+	 * waiting for the next poll interval */
+	spawn->priv->stdout_id = g_unix_fd_add (spawn->priv->stdout_fd,
+						G_IO_IN | G_IO_HUP | G_IO_ERR,
+						cd_spawn_stdout_cb, spawn);
+	spawn->priv->stderr_id = g_unix_fd_add (spawn->priv->stderr_fd,
+						G_IO_IN | G_IO_HUP | G_IO_ERR,
+						cd_spawn_stderr_cb, spawn);
+
+	/* poll quickly, just for the child exit status */
 	spawn->priv->poll_id = g_timeout_add (CD_SPAWN_POLL_DELAY, (GSourceFunc) cd_spawn_check_child, spawn);
 	g_source_set_name_by_id (spawn->priv->poll_id, "[CdSpawn] main poll");
 	return TRUE;
@@ -483,6 +557,8 @@ cd_spawn_init (CdSpawn *spawn)
 
 	spawn->priv->stdout_buf = g_string_new ("");
 	spawn->priv->stderr_buf = g_string_new ("");
+	spawn->priv->read_buf = g_malloc (BUFSIZ);
+	spawn->priv->read_buf_len = BUFSIZ;
 }
 
 static void
@@ -509,6 +585,16 @@ cd_spawn_finalize (GObject *object)
 		spawn->priv->kill_id = 0;
 	}
 
+	/* disconnect the fd watches */
+	if (spawn->priv->stdout_id != 0) {
+		g_source_remove (spawn->priv->stdout_id);
+		spawn->priv->stdout_id = 0;
+	}
+	if (spawn->priv->stderr_id != 0) {
+		g_source_remove (spawn->priv->stderr_id);
+		spawn->priv->stderr_id = 0;
+	}
+
 	/* still running? */
 	if (spawn->priv->stdin_fd != -1) {
 		g_debug ("killing as still running in finalize");
@@ -521,6 +607,7 @@ cd_spawn_finalize (GObject *object)
 	/* free the buffers */
 	g_string_free (spawn->priv->stdout_buf, TRUE);
 	g_string_free (spawn->priv->stderr_buf, TRUE);
+	g_free (spawn->priv->read_buf);
 
 	G_OBJECT_CLASS (cd_spawn_parent_class)->finalize (object);
 }
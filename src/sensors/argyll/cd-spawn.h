@@ -73,6 +73,8 @@ gboolean	 cd_spawn_is_running			(CdSpawn	*spawn);
 gboolean	 cd_spawn_kill				(CdSpawn	*spawn);
 gboolean	 cd_spawn_send_stdin			(CdSpawn	*spawn,
 							 const gchar	*command);
+void		 cd_spawn_set_read_buf_size		(CdSpawn	*spawn,
+							 gsize		 len);
 
 G_END_DECLS
 
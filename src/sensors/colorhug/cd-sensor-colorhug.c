@@ -29,16 +29,22 @@
 
 #include "cd-sensor.h"
 
+/* queueing more readings than this in one batch would take longer than
+ * the D-Bus method timeout at the maximum integral time */
+#define CD_SENSOR_COLORHUG_SAMPLES_MAX		16
+
 typedef struct
 {
 	GUsbDevice			*device;
 	ChDeviceQueue			*device_queue;
+	guint				 sample_count;
 } CdSensorColorhugPrivate;
 
 /* async task for the sensor readings */
 typedef struct {
 	CdSensor			*sensor;
-	CdColorXYZ			 xyz;
+	CdColorXYZ			 xyz[CD_SENSOR_COLORHUG_SAMPLES_MAX];
+	guint				 num_samples;
 	guint32				 serial_number;
 	ChSha1				 sha1;
 } CdSensorTaskData;
@@ -68,6 +74,9 @@ cd_sensor_colorhug_get_sample_cb (GObject *object,
 	CdSensorTaskData *data = g_task_get_task_data (task);
 	g_autoptr(GError) error = NULL;
 
+	CdColorXYZ xyz;
+	guint i;
+
 	/* get data */
 	if (!ch_device_queue_process_finish (device_queue, res, &error)) {
 		g_task_return_new_error (task,
@@ -76,12 +85,23 @@ cd_sensor_colorhug_get_sample_cb (GObject *object,
 					 "%s", error->message);
 		return;
 	}
-	g_debug ("finished values: red=%0.6lf, green=%0.6lf, blue=%0.6lf",
-		 data->xyz.X, data->xyz.Y, data->xyz.Z);
+
+	/* average the batch of readings */
+	cd_color_xyz_clear (&xyz);
+	for (i = 0; i < data->num_samples; i++) {
+		xyz.X += data->xyz[i].X;
+		xyz.Y += data->xyz[i].Y;
+		xyz.Z += data->xyz[i].Z;
+	}
+	xyz.X /= (gdouble) data->num_samples;
+	xyz.Y /= (gdouble) data->num_samples;
+	xyz.Z /= (gdouble) data->num_samples;
+	g_debug ("finished %u values: red=%0.6lf, green=%0.6lf, blue=%0.6lf",
+		 data->num_samples, xyz.X, xyz.Y, xyz.Z);
 
 	/* save result */
 	g_task_return_pointer (task,
-			       cd_color_xyz_dup (&data->xyz),
+			       cd_color_xyz_dup (&xyz),
 			       (GDestroyNotify) cd_color_xyz_free);
 }
 
@@ -96,6 +116,7 @@ cd_sensor_get_sample_async (CdSensor *sensor,
 	CdSensorColorhugPrivate *priv = cd_sensor_colorhug_get_private (sensor);
 	CdSensorTaskData *data;
 	guint16 calibration_index;
+	guint i;
 	g_autoptr(GError) error = NULL;
 	g_autoptr(GTask) task = NULL;
 
@@ -131,14 +152,18 @@ cd_sensor_get_sample_async (CdSensor *sensor,
 	/* set state */
 	data = g_new0 (CdSensorTaskData, 1);
 	data->sensor = g_object_ref (sensor);
+	data->num_samples = MAX (priv->sample_count, 1);
 	g_task_set_task_data (task, data, (GDestroyNotify) cd_sensor_task_data_free);
 
-	/* request */
+	/* queue all the readings in one batch; the queue round trip is
+	 * paid once however many samples are averaged */
 	cd_sensor_set_state (sensor, CD_SENSOR_STATE_STARTING);
-	ch_device_queue_take_readings_xyz (priv->device_queue,
-					   priv->device,
-					   calibration_index,
-					   &data->xyz);
+	for (i = 0; i < data->num_samples; i++) {
+		ch_device_queue_take_readings_xyz (priv->device_queue,
+						   priv->device,
+						   calibration_index,
+						   &data->xyz[i]);
+	}
 	ch_device_queue_process_async (priv->device_queue,
 				       CH_DEVICE_QUEUE_PROCESS_FLAGS_NONE,
 				       g_task_get_cancellable (task),
@@ -420,7 +445,37 @@ cd_sensor_set_next_option (GTask *task)
 	key = (const gchar *) keys->data;
 	g_debug ("trying to set key %s", key);
 	value = g_hash_table_lookup (options, key);
-	if (g_strcmp0 (key, "remote-profile-hash") == 0) {
+	if (g_strcmp0 (key, "sample-count") == 0) {
+
+		guint32 sample_count;
+
+		/* handled entirely in the daemon, no device commands */
+		if (!g_variant_is_of_type (value, G_VARIANT_TYPE_UINT32)) {
+			g_task_return_new_error (task,
+						 CD_SENSOR_ERROR,
+						 CD_SENSOR_ERROR_INTERNAL,
+						 "sample-count requires a uint32 value");
+			g_hash_table_remove (options, key);
+			return;
+		}
+		sample_count = g_variant_get_uint32 (value);
+		if (sample_count == 0 ||
+		    sample_count > CD_SENSOR_COLORHUG_SAMPLES_MAX) {
+			g_task_return_new_error (task,
+						 CD_SENSOR_ERROR,
+						 CD_SENSOR_ERROR_INTERNAL,
+						 "sample-count %u not in range 1..%i",
+						 sample_count,
+						 CD_SENSOR_COLORHUG_SAMPLES_MAX);
+			g_hash_table_remove (options, key);
+			return;
+		}
+		g_debug ("averaging %u readings per sample", sample_count);
+		priv->sample_count = sample_count;
+		cd_sensor_add_option (sensor, key, value);
+		g_hash_table_remove (options, key);
+		cd_sensor_set_next_option (task);
+	} else if (g_strcmp0 (key, "remote-profile-hash") == 0) {
 
 		/* parse the hash */
 		ret = ch_sha1_parse (g_variant_get_string (value, NULL),
@@ -504,6 +559,7 @@ cd_sensor_coldplug (CdSensor *sensor, GError **error)
 	/* create private data */
 	priv = g_new0 (CdSensorColorhugPrivate, 1);
 	priv->device_queue = ch_device_queue_new ();
+	priv->sample_count = 1;
 	g_object_set_data_full (G_OBJECT (sensor), "priv", priv,
 				(GDestroyNotify) cd_sensor_unref_private);
 	return TRUE;
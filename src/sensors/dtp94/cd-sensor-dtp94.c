@@ -34,6 +34,9 @@
 typedef struct
 {
 	GUsbDevice			*device;
+	gchar				*serial_cache;
+	guint8				 setup_bus;
+	guint8				 setup_address;
 } CdSensorDtp94Private;
 
 #define DTP94_CONTROL_MESSAGE_TIMEOUT	50000 /* ms */
@@ -117,6 +120,18 @@ cd_sensor_dtp94_lock_thread_cb (GTask *task,
 	/* set state */
 	cd_sensor_set_state_in_idle (sensor, CD_SENSOR_STATE_STARTING);
 
+	/* if the device has not re-enumerated since it was last set up
+	 * then the integration and calibration state is still valid,
+	 * so skip the startup sequence */
+	if (priv->serial_cache != NULL &&
+	    g_usb_device_get_bus (priv->device) == priv->setup_bus &&
+	    g_usb_device_get_address (priv->device) == priv->setup_address) {
+		g_debug ("reusing setup for serial %s", priv->serial_cache);
+		cd_sensor_set_serial (sensor, priv->serial_cache);
+		g_task_return_boolean (task, TRUE);
+		return;
+	}
+
 	/* do startup sequence */
 	if (!dtp94_device_setup (priv->device, &error)) {
 		g_task_return_new_error (task,
@@ -137,6 +152,12 @@ cd_sensor_dtp94_lock_thread_cb (GTask *task,
 	}
 	cd_sensor_set_serial (sensor, serial);
 
+	/* remember what we set up so a relock can skip it */
+	g_free (priv->serial_cache);
+	priv->serial_cache = g_strdup (serial);
+	priv->setup_bus = g_usb_device_get_bus (priv->device);
+	priv->setup_address = g_usb_device_get_address (priv->device);
+
 	/* success */
 	g_task_return_boolean (task, TRUE);
 }
@@ -217,6 +238,7 @@ cd_sensor_unref_private (CdSensorDtp94Private *priv)
 {
 	if (priv->device != NULL)
 		g_object_unref (priv->device);
+	g_free (priv->serial_cache);
 	g_free (priv);
 }
 
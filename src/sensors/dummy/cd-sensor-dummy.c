@@ -24,6 +24,7 @@
 
 #include <glib-object.h>
 #include <lcms2.h>
+#include <stdlib.h>
 
 #include "cd-sensor.h"
 
@@ -32,8 +33,14 @@ typedef struct
 	gboolean			 done_startup;
 	CdColorRGB			 sample_fake;
 	cmsHTRANSFORM			 transform_fake;
+	guint				 integration_ms;
 } CdSensorDummyPrivate;
 
+/* the simulated integration period; benchmarks drive this down with
+ * COLORD_SENSOR_DUMMY_INTEGRATION_MS or the integration[ms] option so a
+ * whole calibration run takes seconds rather than minutes */
+#define CD_SENSOR_DUMMY_INTEGRATION_DEFAULT_MS	2000
+
 static CdSensorDummyPrivate *
 cd_sensor_dummy_get_private (CdSensor *sensor)
 {
@@ -92,6 +99,7 @@ cd_sensor_get_sample_async (CdSensor *sensor,
 			    GAsyncReadyCallback callback,
 			    gpointer user_data)
 {
+	CdSensorDummyPrivate *priv = cd_sensor_dummy_get_private (sensor);
 	g_autoptr(GTask) task = NULL;
 
 	g_return_if_fail (CD_IS_SENSOR (sensor));
@@ -101,11 +109,11 @@ cd_sensor_get_sample_async (CdSensor *sensor,
 	/* set state */
 	cd_sensor_set_state (sensor, CD_SENSOR_STATE_MEASURING);
 
-	/* just complete in idle */
+	/* wait out the simulated integration period */
 	if (cap != CD_SENSOR_CAP_AMBIENT)
-		g_timeout_add_seconds (2, (GSourceFunc) cd_sensor_get_sample_wait_cb, g_steal_pointer(&task));
+		g_timeout_add (priv->integration_ms, (GSourceFunc) cd_sensor_get_sample_wait_cb, g_steal_pointer(&task));
 	else
-		g_timeout_add_seconds (2, (GSourceFunc) cd_sensor_get_ambient_wait_cb, g_steal_pointer(&task));
+		g_timeout_add (priv->integration_ms, (GSourceFunc) cd_sensor_get_ambient_wait_cb, g_steal_pointer(&task));
 }
 
 CdColorXYZ *
@@ -159,6 +167,8 @@ cd_sensor_set_options_async (CdSensor *sensor,
 			priv->sample_fake.G = g_variant_get_double (value);
 		} else if (g_strcmp0 (key_name, "sample[blue]") == 0) {
 			priv->sample_fake.B = g_variant_get_double (value);
+		} else if (g_strcmp0 (key_name, "integration[ms]") == 0) {
+			priv->integration_ms = g_variant_get_double (value);
 		} else {
 			g_task_return_new_error (task,
 						 CD_SENSOR_ERROR,
@@ -231,6 +241,9 @@ cd_sensor_coldplug (CdSensor *sensor, GError **error)
 	priv = g_new0 (CdSensorDummyPrivate, 1);
 	priv->transform_fake = cd_sensor_get_fake_transform (priv);
 	cd_color_rgb_set (&priv->sample_fake, 0.1, 0.2, 0.3);
+	priv->integration_ms = CD_SENSOR_DUMMY_INTEGRATION_DEFAULT_MS;
+	if (g_getenv ("COLORD_SENSOR_DUMMY_INTEGRATION_MS") != NULL)
+		priv->integration_ms = atoi (g_getenv ("COLORD_SENSOR_DUMMY_INTEGRATION_MS"));
 	g_object_set_data_full (G_OBJECT (sensor), "priv", priv,
 				(GDestroyNotify) cd_sensor_unref_private);
 	return TRUE;
@@ -36,6 +36,9 @@ typedef struct
 {
 	GUsbDevice			*device;
 	HueyCtx				*ctx;
+	gchar				*serial_cache;
+	guint8				 setup_bus;
+	guint8				 setup_address;
 } CdSensorHueyPrivate;
 
 static CdSensorHueyPrivate *
@@ -157,6 +160,18 @@ cd_sensor_huey_lock_thread_cb (GTask *task,
 	/* set state */
 	cd_sensor_set_state_in_idle (sensor, CD_SENSOR_STATE_STARTING);
 
+	/* if the device has not re-enumerated since it was last set up
+	 * then the unlock state and the EEPROM calibration constants in
+	 * the context are still valid, so skip the whole dialogue */
+	if (priv->serial_cache != NULL &&
+	    g_usb_device_get_bus (priv->device) == priv->setup_bus &&
+	    g_usb_device_get_address (priv->device) == priv->setup_address) {
+		g_debug ("reusing setup for serial %s", priv->serial_cache);
+		cd_sensor_set_serial (sensor, priv->serial_cache);
+		g_task_return_boolean (task, TRUE);
+		goto out;
+	}
+
 	/* unlock */
 	if (!huey_device_unlock (priv->device, &error)) {
 		g_task_return_new_error (task,
@@ -201,6 +216,12 @@ cd_sensor_huey_lock_thread_cb (GTask *task,
 		}
 	}
 
+	/* remember what we set up so a relock can skip it */
+	g_free (priv->serial_cache);
+	priv->serial_cache = g_strdup (serial_number_tmp);
+	priv->setup_bus = g_usb_device_get_bus (priv->device);
+	priv->setup_address = g_usb_device_get_address (priv->device);
+
 	/* success */
 	g_task_return_boolean (task, TRUE);
 out:
@@ -324,6 +345,7 @@ cd_sensor_unref_private (CdSensorHueyPrivate *priv)
 	if (priv->device != NULL)
 		g_object_unref (priv->device);
 	g_object_unref (priv->ctx);
+	g_free (priv->serial_cache);
 	g_free (priv);
 }
 
@@ -38,6 +38,11 @@
 #define HUEY_RC_SUCCESS				0x00
 #define HUEY_RC_ERROR				0x80
 
+/* the device queues commands internally and replies in order, so
+ * independent reads can be issued back-to-back; more than this and the
+ * internal queue overflows */
+#define HUEY_DEVICE_BURST_MAX			8
+
 static gboolean
 huey_device_send_data (GUsbDevice *device,
 		       const guint8 *request,
@@ -107,6 +112,79 @@ huey_device_send_data (GUsbDevice *device,
 	return TRUE;
 }
 
+static gboolean
+huey_device_send_burst (GUsbDevice *device,
+			const guint8 *requests,
+			guint n_requests,
+			guint8 *replies,
+			GError **error)
+{
+	gboolean ret;
+	gsize reply_read;
+
+	/* issue all the control transfers without waiting for the
+	 * replies; each serialized round trip otherwise costs a full
+	 * USB frame of latency */
+	for (guint i = 0; i < n_requests; i++) {
+		const guint8 *request = requests + (i * 8);
+		cd_buffer_debug (CD_BUFFER_KIND_REQUEST,
+				 request, 8);
+		ret = g_usb_device_control_transfer (device,
+						     G_USB_DEVICE_DIRECTION_HOST_TO_DEVICE,
+						     G_USB_DEVICE_REQUEST_TYPE_CLASS,
+						     G_USB_DEVICE_RECIPIENT_INTERFACE,
+						     0x09,
+						     0x0200,
+						     0,
+						     (guint8 *) request,
+						     8,
+						     NULL,
+						     HUEY_DEVICE_TIMEOUT,
+						     NULL,
+						     error);
+		if (!ret)
+			return FALSE;
+	}
+
+	/* the replies come back in submission order */
+	for (guint i = 0; i < n_requests; i++) {
+		const guint8 *request = requests + (i * 8);
+		guint8 *reply = replies + (i * 8);
+		ret = g_usb_device_interrupt_transfer (device,
+						       0x81,
+						       reply,
+						       8,
+						       &reply_read,
+						       HUEY_DEVICE_TIMEOUT,
+						       NULL,
+						       error);
+		if (!ret)
+			return FALSE;
+		cd_buffer_debug (CD_BUFFER_KIND_RESPONSE,
+				 reply, reply_read);
+		if (reply[1] != request[0]) {
+			g_set_error (error,
+				     G_IO_ERROR,
+				     G_IO_ERROR_FAILED,
+				     "wrong command reply, got 0x%02x, "
+				     "expected 0x%02x",
+				     reply[1],
+				     request[0]);
+			return FALSE;
+		}
+		if (reply[0] != HUEY_RC_SUCCESS) {
+			g_set_error (error,
+				     G_IO_ERROR,
+				     G_IO_ERROR_FAILED,
+				     "failed to issue command: %s", &reply[2]);
+			return FALSE;
+		}
+	}
+
+	/* success */
+	return TRUE;
+}
+
 gchar *
 huey_device_get_status (GUsbDevice *device, GError **error)
 {
@@ -137,28 +215,36 @@ huey_device_get_status (GUsbDevice *device, GError **error)
 GBytes *
 huey_device_read_eeprom (GUsbDevice *device, GError **error)
 {
-	guint8 request[8] = { '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0' };
-	guint8 reply[8] = { '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0' };
+	guint8 requests[HUEY_DEVICE_BURST_MAX * 8];
+	guint8 replies[HUEY_DEVICE_BURST_MAX * 8];
 	gboolean ret;
-	gsize reply_read;
 	g_autofree guint8 *eeprom = NULL;
 
-	/* get entire memory space */
+	/* get entire memory space, coalescing the independent register
+	 * reads into bursts */
 	eeprom = g_malloc0 (HUEY_EEPROM_SIZE);
-	request[0] = HUEY_CMD_REGISTER_READ;
-	for (guint i = 0; i < HUEY_EEPROM_SIZE; i += 0x4) {
-		guint16 addr_be = GUINT16_TO_BE (i);
-		memcpy (&request[1], &addr_be, 0x2);
-		ret = huey_device_send_data (device,
-					     request, 8,
-					     reply, 8,
-					     &reply_read,
-					     error);
+	for (guint i = 0; i < HUEY_EEPROM_SIZE; i += HUEY_DEVICE_BURST_MAX * 0x4) {
+		guint n_requests = 0;
+		memset (requests, '\0', sizeof (requests));
+		for (guint j = i; j < i + HUEY_DEVICE_BURST_MAX * 0x4 &&
+				  j < HUEY_EEPROM_SIZE; j += 0x4) {
+			guint16 addr_be = GUINT16_TO_BE (j);
+			guint8 *request = requests + (n_requests * 8);
+			request[0] = HUEY_CMD_REGISTER_READ;
+			memcpy (&request[1], &addr_be, 0x2);
+			n_requests++;
+		}
+		ret = huey_device_send_burst (device,
+					      requests,
+					      n_requests,
+					      replies,
+					      error);
 		if (!ret) {
 			g_prefix_error (error, "failed to read eeprom @0x%04x: ", i);
 			return NULL;
 		}
-		memcpy (eeprom + i, reply + 0x4, 0x4);
+		for (guint j = 0; j < n_requests; j++)
+			memcpy (eeprom + i + (j * 0x4), replies + (j * 8) + 0x4, 0x4);
 	}
 	return g_bytes_new (eeprom, HUEY_EEPROM_SIZE);
 }
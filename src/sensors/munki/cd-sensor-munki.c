@@ -37,6 +37,8 @@ typedef struct
 	GUsbDevice			*device;
 	struct libusb_transfer		*transfer_interrupt;
 	struct libusb_transfer		*transfer_state;
+	guint8				*buffer_interrupt;	/* reused for each poll */
+	guint8				*buffer_state;		/* setup packet plus reply */
 	gchar				*version_string;
 	gchar				*chip_id;
 	gchar				*firmware_revision;
@@ -49,6 +51,8 @@ typedef struct
 #define CD_SENSOR_MUNKI_VENDOR_ID				0x0971
 #define CD_SENSOR_MUNKI_PRODUCT_ID				0x2007
 
+#define CD_SENSOR_MUNKI_EEPROM_CACHE_VERSION			1
+
 static void
 cd_sensor_munki_submit_transfer (CdSensor *sensor);
 
@@ -98,7 +102,8 @@ cd_sensor_munki_refresh_state_transfer_cb (struct libusb_transfer *transfer)
 			      transfer->buffer + LIBUSB_CONTROL_SETUP_SIZE,
 			      transfer->actual_length);
 out:
-	g_free (transfer->buffer);
+	/* the buffer is owned by the private data and reused */
+	return;
 }
 
 static gboolean
@@ -106,15 +111,16 @@ cd_sensor_munki_refresh_state (CdSensor *sensor, GError **error)
 {
 	gint retval;
 	gboolean ret = FALSE;
-	static guint8 *request;
+	guint8 *request;
 	libusb_device_handle *handle;
 	CdSensorMunkiPrivate *priv = cd_sensor_munki_get_private (sensor);
 
 	/* do sync request */
 	handle = cd_usb_get_device_handle (priv->usb);
 
-	/* request new button task */
-	request = g_new0 (guint8, LIBUSB_CONTROL_SETUP_SIZE + 2);
+	/* request new button task, reusing the persistent buffer so the
+	 * high-frequency poll does not churn allocations */
+	request = priv->buffer_state;
 	libusb_fill_control_setup (request,
 				   LIBUSB_ENDPOINT_IN | LIBUSB_REQUEST_TYPE_VENDOR | LIBUSB_RECIPIENT_DEVICE,
 				   MUNKI_REQUEST_GET_STATUS,
@@ -171,8 +177,8 @@ cd_sensor_munki_transfer_cb (struct libusb_transfer *transfer)
 	cd_sensor_munki_refresh_state (sensor, NULL);
 
 out:
-	/* get the next bit of data */
-	g_free (transfer->buffer);
+	/* resubmit the same transfer straight away so no events are
+	 * missed between submissions */
 	cd_sensor_munki_submit_transfer (sensor);
 }
 
@@ -180,15 +186,13 @@ static void
 cd_sensor_munki_submit_transfer (CdSensor *sensor)
 {
 	gint retval;
-	guint8 *reply;
 	libusb_device_handle *handle;
 	CdSensorMunkiPrivate *priv = cd_sensor_munki_get_private (sensor);
 
-	reply = g_new0 (guint8, 8);
 	handle = cd_usb_get_device_handle (priv->usb);
 	libusb_fill_interrupt_transfer (priv->transfer_interrupt, handle,
 					MUNKI_REQUEST_INTERRUPT,
-					reply, 8,
+					priv->buffer_interrupt, 8,
 					cd_sensor_munki_transfer_cb,
 					sensor, -1);
 
@@ -256,6 +260,149 @@ out:
 	return ret;
 }
 
+static gchar *
+cd_sensor_munki_get_eeprom_cache_path (CdSensor *sensor)
+{
+	g_autofree gchar *serial = NULL;
+
+	/* the cache is per-instrument */
+	g_object_get (sensor, "serial", &serial, NULL);
+	if (serial == NULL || serial[0] == '\0')
+		return NULL;
+	return g_strdup_printf (LOCALSTATEDIR "/lib/colord/munki-eeprom-%s.bin",
+				serial);
+}
+
+static guint8 *
+cd_sensor_munki_eeprom_cache_load (CdSensor *sensor)
+{
+	CdSensorMunkiPrivate *priv = cd_sensor_munki_get_private (sensor);
+	const gchar *chip_id_tmp;
+	const gchar *firmware_tmp;
+	gchar *data = NULL;
+	gsize len = 0;
+	guint32 blocks;
+	guint32 blocksize;
+	guint32 version;
+	gsize eeprom_len;
+	gconstpointer eeprom_tmp;
+	g_autofree gchar *path = NULL;
+	g_autoptr(GVariant) eeprom = NULL;
+	g_autoptr(GVariant) value = NULL;
+
+	path = cd_sensor_munki_get_eeprom_cache_path (sensor);
+	if (path == NULL)
+		return NULL;
+	if (!g_file_get_contents (path, &data, &len, NULL))
+		return NULL;
+	value = g_variant_new_from_data (G_VARIANT_TYPE ("(ussuuay)"),
+					 data, len, FALSE,
+					 g_free, data);
+	g_variant_ref_sink (value);
+	if (!g_variant_is_normal_form (value)) {
+		g_debug ("ignoring corrupt EEPROM cache %s", path);
+		return NULL;
+	}
+	g_variant_get (value, "(u&s&suu@ay)",
+		       &version,
+		       &chip_id_tmp,
+		       &firmware_tmp,
+		       &blocks,
+		       &blocksize,
+		       &eeprom);
+	if (version != CD_SENSOR_MUNKI_EEPROM_CACHE_VERSION) {
+		g_debug ("ignoring EEPROM cache version %u", version);
+		return NULL;
+	}
+
+	/* the chip ID and firmware revision were just read from the
+	 * device, so comparing them is the cheap validation step;
+	 * a firmware update or factory recalibration changes these */
+	if (g_strcmp0 (chip_id_tmp, priv->chip_id) != 0 ||
+	    g_strcmp0 (firmware_tmp, priv->firmware_revision) != 0 ||
+	    blocks != priv->eeprom_blocks ||
+	    blocksize != priv->eeprom_blocksize) {
+		g_debug ("EEPROM cache %s is for different device state", path);
+		return NULL;
+	}
+	eeprom_tmp = g_variant_get_fixed_array (eeprom, &eeprom_len,
+						sizeof (guint8));
+	if (eeprom_len != (gsize) blocks * blocksize) {
+		g_debug ("EEPROM cache %s has wrong payload size", path);
+		return NULL;
+	}
+	g_debug ("using cached EEPROM data from %s", path);
+	return g_memdup (eeprom_tmp, (guint) eeprom_len);
+}
+
+static void
+cd_sensor_munki_eeprom_cache_save (CdSensor *sensor,
+				   const guint8 *data,
+				   gsize len)
+{
+	CdSensorMunkiPrivate *priv = cd_sensor_munki_get_private (sensor);
+	g_autofree gchar *path = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GVariant) value = NULL;
+
+	path = cd_sensor_munki_get_eeprom_cache_path (sensor);
+	if (path == NULL)
+		return;
+	value = g_variant_new ("(ussuu@ay)",
+			       CD_SENSOR_MUNKI_EEPROM_CACHE_VERSION,
+			       priv->chip_id,
+			       priv->firmware_revision,
+			       priv->eeprom_blocks,
+			       priv->eeprom_blocksize,
+			       g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE,
+							  data, len,
+							  sizeof (guint8)));
+	g_variant_ref_sink (value);
+
+	/* not fatal if this fails, the next lock just re-reads the device */
+	if (!g_file_set_contents (path,
+				  g_variant_get_data (value),
+				  g_variant_get_size (value),
+				  &error)) {
+		g_debug ("failed to save EEPROM cache: %s", error->message);
+		return;
+	}
+	g_debug ("saved EEPROM cache to %s", path);
+}
+
+static guint8 *
+cd_sensor_munki_get_eeprom_blob (CdSensor *sensor, GError **error)
+{
+	CdSensorMunkiPrivate *priv = cd_sensor_munki_get_private (sensor);
+	guint i;
+	guint8 *buffer;
+
+	/* reading every block over USB takes several seconds, so try
+	 * the on-disk copy first */
+	buffer = cd_sensor_munki_eeprom_cache_load (sensor);
+	if (buffer != NULL)
+		return buffer;
+
+	/* get all banks of EEPROM from the device */
+	buffer = g_new0 (guint8, priv->eeprom_blocks * priv->eeprom_blocksize);
+	for (i = 0; i < priv->eeprom_blocks; i++) {
+		if (!cd_sensor_munki_get_eeprom_data (sensor,
+						      i * priv->eeprom_blocksize,
+						      buffer + i * priv->eeprom_blocksize,
+						      priv->eeprom_blocksize,
+						      error)) {
+			g_free (buffer);
+			return NULL;
+		}
+	}
+
+	/* save for the next session */
+	cd_sensor_munki_eeprom_cache_save (sensor, buffer,
+					   (gsize) priv->eeprom_blocks *
+						priv->eeprom_blocksize);
+	return buffer;
+}
+
 static gboolean
 cd_sensor_munki_random (CdSensor *sensor, GError **error)
 {
@@ -638,21 +785,17 @@ cd_sensor_dump_device (CdSensor *sensor, GString *data, GError **error)
 	g_string_append_printf (data, "eeprom-blocks:%i\n", priv->eeprom_blocks);
 	g_string_append_printf (data, "eeprom-blocksize:%i\n", priv->eeprom_blocksize);
 
-	/* allocate a big chunk o' memory */
-	buffer = g_new0 (guint8, priv->eeprom_blocksize);
+	/* get all banks of EEPROM, using the on-disk cache if valid */
+	buffer = cd_sensor_munki_get_eeprom_blob (sensor, error);
+	if (buffer == NULL) {
+		ret = FALSE;
+		goto out;
+	}
 
-	/* get all banks of EEPROM */
+	/* write details */
 	for (i = 0; i < priv->eeprom_blocks; i++) {
-		ret = cd_sensor_munki_get_eeprom_data (sensor,
-						       i*priv->eeprom_blocksize,
-						       buffer, priv->eeprom_blocksize,
-						       error);
-		if (!ret)
-			goto out;
-
-		/* write details */
 		for (j = 0; j < priv->eeprom_blocksize; j++)
-			g_string_append_printf (data, "eeprom[0x%04x]:0x%02x\n", (i*priv->eeprom_blocksize) + j, buffer[j]);
+			g_string_append_printf (data, "eeprom[0x%04x]:0x%02x\n", (i*priv->eeprom_blocksize) + j, buffer[(i*priv->eeprom_blocksize) + j]);
 	}
 out:
 	g_free (buffer);
@@ -671,6 +814,8 @@ cd_sensor_unref_private (CdSensorMunkiPrivate *priv)
 	/* free transfers */
 	libusb_free_transfer (priv->transfer_interrupt);
 	libusb_free_transfer (priv->transfer_state);
+	g_free (priv->buffer_interrupt);
+	g_free (priv->buffer_state);
 	g_free (priv->version_string);
 	g_free (priv->chip_id);
 	g_free (priv->firmware_revision);
@@ -696,6 +841,11 @@ cd_sensor_coldplug (CdSensor *sensor, GError **error)
 				(GDestroyNotify) cd_sensor_unref_private);
 	priv->transfer_interrupt = libusb_alloc_transfer (0);
 	priv->transfer_state = libusb_alloc_transfer (0);
+
+	/* the transfer buffers live as long as the transfers and are
+	 * reused for every submission */
+	priv->buffer_interrupt = g_new0 (guint8, 8);
+	priv->buffer_state = g_new0 (guint8, LIBUSB_CONTROL_SETUP_SIZE + 2);
 	return TRUE;
 }
 